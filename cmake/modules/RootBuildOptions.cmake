@@ -77,6 +77,7 @@ ROOT_BUILD_OPTION(libcxx11 OFF "Build using libc++, requires cxx11 option (MacOS
 ROOT_BUILD_OPTION(castor ON "CASTOR support, requires libshift from CASTOR >= 1.5.2")
 ROOT_BUILD_OPTION(chirp ON "Chirp support (Condor remote I/O), requires libchirp_client")
 ROOT_BUILD_OPTION(cintex ON "Build the libCintex Reflex interface library")
+ROOT_BUILD_OPTION(cblas OFF "Use an external CBLAS library for the dense matrix operations of libMatrix")
 ROOT_BUILD_OPTION(clarens ON "Clarens RPC support, optionally used by PROOF")
 ROOT_BUILD_OPTION(cling ON "Enable new CLING C++ interpreter")
 ROOT_BUILD_OPTION(cocoa OFF "Use native Cocoa/Quartz graphics backend (MacOS X only)")
@@ -502,6 +502,21 @@ if(fftw3)
   endif()
 endif()
 
+#---Check for CBLAS-------------------------------------------------------------------
+if(cblas)
+  message(STATUS "Looking for CBLAS")
+  find_path(CBLAS_INCLUDE_DIR cblas.h)
+  find_library(CBLAS_LIBRARY NAMES openblas cblas blas)
+  if(NOT CBLAS_INCLUDE_DIR OR NOT CBLAS_LIBRARY)
+    if(fail-on-missing)
+      message(FATAL_ERROR "CBLAS library not found and it is required (cblas option enabled)")
+    else()
+      message(STATUS "CBLAS not found. Switching off cblas option")
+      set(cblas OFF CACHE BOOL "" FORCE)
+    endif()
+  endif()
+endif()
+
 #---Check for fitsio-------------------------------------------------------------------
 if(fitsio)
   if(builtin_cfitsio)
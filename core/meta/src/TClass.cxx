@@ -5457,8 +5457,11 @@ TVirtualStreamerInfo *TClass::GetConversionStreamerInfo( const TClass* cl, Int_t
       return GetStreamerInfo( version );
 
    //----------------------------------------------------------------------------
-   // Check if we already have it
+   // Check if we already have it.  The conversion StreamerInfos are shared by
+   // all the files and threads, so the lookup must be protected too.
    //----------------------------------------------------------------------------
+   R__LOCKGUARD(gClingMutex);
+
    TObjArray* arr = 0;
    if (fConversionStreamerInfo) {
       std::map<std::string, TObjArray*>::iterator it;
@@ -5473,8 +5476,6 @@ TVirtualStreamerInfo *TClass::GetConversionStreamerInfo( const TClass* cl, Int_t
          return (TVirtualStreamerInfo*) arr->At( version );
    }
 
-   R__LOCKGUARD(gClingMutex);
-
    //----------------------------------------------------------------------------
    // We don't have the streamer info so find it in other class
    //----------------------------------------------------------------------------
@@ -5551,8 +5552,10 @@ TVirtualStreamerInfo *TClass::FindConversionStreamerInfo( const TClass* cl, UInt
       return FindStreamerInfo( checksum );
 
    //----------------------------------------------------------------------------
-   // Check if we already have it
+   // Check if we already have it (see GetConversionStreamerInfo for the locking)
    //----------------------------------------------------------------------------
+   R__LOCKGUARD(gClingMutex);
+
    TObjArray* arr = 0;
    TVirtualStreamerInfo* info = 0;
    if (fConversionStreamerInfo) {
@@ -5571,8 +5574,6 @@ TVirtualStreamerInfo *TClass::FindConversionStreamerInfo( const TClass* cl, UInt
    if( info )
       return info;
 
-   R__LOCKGUARD(gClingMutex);
-
    //----------------------------------------------------------------------------
    // Get it from the foreign class
    //----------------------------------------------------------------------------
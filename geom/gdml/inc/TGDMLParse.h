@@ -99,7 +99,11 @@ public:
    }
 };
 
+class TGDMLStreamHandler;
+
 class TGDMLParse : public TObject {
+   friend class TGDMLStreamHandler;
+
 public:
 
    const char* fWorldName; //top volume of geometry name
@@ -137,6 +141,7 @@ public:
 private:
 
    const char*       ParseGDML(TXMLEngine* gdml, XMLNodePointer_t node) ;
+   Bool_t            ParseGDMLFile(TXMLEngine* gdml, const char* filename);
    TString           GetScale(const char* unit);
    double            Evaluate(const char* evalline);
    const char*       NameShort(const char* name);
@@ -217,6 +222,7 @@ private:
    ReflVolMap freflvolmap;        //!Map containing reflected volume names and the solid ref for it
    FileMap ffilemap;              //!Map containing files parsed during entire parsing, with their world volume name
    FormVec fformvec;              //!Vector containing constant functions for GDML constant definitions
+   TString fWorldNameBuf;         //!Storage of fWorldName, the node trees are released while parsing
 
    ClassDef(TGDMLParse, 0)    //imports GDML using DOM and binds it to ROOT
 };
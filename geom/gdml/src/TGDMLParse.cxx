@@ -120,37 +120,98 @@ ClassImp(TGDMLParse)
 TGeoVolume* TGDMLParse::GDMLReadFile(const char* filename)
 {
    //creates the new instance of the XMLEngine called 'gdml', using the filename >>
-   //then parses the file and creates the DOM tree. Then passes the DOM to the
-   //next function to translate it.
+   //then parses the file incrementally (see ParseGDMLFile), translating each
+   //definition as soon as it is read.
 
    // First create engine
    TXMLEngine* gdml = new TXMLEngine;
    gdml->SetSkipComments(kTRUE);
 
-   // Now try to parse xml file
-   XMLDocPointer_t gdmldoc = gdml->ParseFile(filename);
-   if (gdmldoc == 0) {
-      delete gdml;
-      return 0;
-   } else {
+   fFileEngine[fFILENO] = gdml;
+   fStartFile = filename;
+   fCurrentFile = filename;
 
-      // take access to main node
-      XMLNodePointer_t mainnode = gdml->DocGetRootElement(gdmldoc);
+   // Now parse and translate the xml file
+   Bool_t ok = ParseGDMLFile(gdml, filename);
 
-      fFileEngine[fFILENO] = gdml;
-      fStartFile = filename;
-      fCurrentFile = filename;
+   // Release memory before exit
+   delete gdml;
 
-      // display recursively all nodes and subnodes
-      ParseGDML(gdml, mainnode);
+   return ok ? fWorld : 0;
 
-      // Release memory before exit
-      gdml->FreeDoc(gdmldoc);
-      delete gdml;
+}
 
+//________________________________________________________________
+class TGDMLStreamHandler : public TXMLSAXHandler {
+   // Receives the GDML file from the streaming parser of TXMLEngine and
+   // builds the DOM tree of one definition at a time: the children of the
+   // define, materials, solids and structure sections, and the setup
+   // section. Each definition is given to TGDMLParse::ParseGDML as soon as
+   // it is complete and then released, so that only the definition being
+   // interpreted and its ancestors are kept in memory.
+
+   TGDMLParse*       fParser;    // parser interpreting the definitions
+   TXMLEngine*       fEngine;    // engine used for parsing and for the DOM
+   XMLNodePointer_t  fCurrent;   // node of the last opened element
+   Int_t             fUnitDepth; // depth inside the current definition, 0 outside
+
+   Bool_t IsSection(const char* name) const
+   {
+      return (strcmp(name, "gdml") == 0) || (strcmp(name, "define") == 0) ||
+             (strcmp(name, "materials") == 0) || (strcmp(name, "solids") == 0) ||
+             (strcmp(name, "structure") == 0);
+   }
+
+public:
+   TGDMLStreamHandler(TGDMLParse* parser, TXMLEngine* engine) :
+      fParser(parser), fEngine(engine), fCurrent(0), fUnitDepth(0) {}
+
+   virtual ~TGDMLStreamHandler()
+   {
+      // release what remains of the tree if parsing was not completed
+      XMLNodePointer_t top = fCurrent;
+      while ((top != 0) && (fEngine->GetParent(top) != 0))
+         top = fEngine->GetParent(top);
+      if (top != 0) fEngine->FreeNode(top);
+   }
+
+   virtual Bool_t OnStartElement(const char* name, const char** attrs)
+   {
+      XMLNodePointer_t node = fEngine->NewChild(fCurrent, 0, name);
+      for (; *attrs != 0; attrs += 2)
+         fEngine->NewAttr(node, 0, attrs[0], attrs[1]);
+      fCurrent = node;
+      if (fUnitDepth > 0 || !IsSection(name)) {
+         fUnitDepth++;
+      } else {
+         // sections are interpreted without their children
+         fParser->ParseGDML(fEngine, node);
+      }
+      return kTRUE;
    }
-   return fWorld;
 
+   virtual Bool_t OnEndElement(const char*)
+   {
+      XMLNodePointer_t node = fCurrent;
+      fCurrent = fEngine->GetParent(node);
+      if (fUnitDepth > 0) {
+         if (--fUnitDepth > 0) return kTRUE;
+         fParser->ParseGDML(fEngine, node);
+      }
+      fEngine->UnlinkFreeNode(node);
+      return kTRUE;
+   }
+};
+
+//________________________________________________________________
+Bool_t TGDMLParse::ParseGDMLFile(TXMLEngine* gdml, const char* filename)
+{
+   //parses the GDML file with the streaming interface of the engine:
+   //the DOM tree of each definition is translated by ParseGDML as soon as
+   //it is read, then released. Returns kFALSE if the file can not be parsed.
+
+   TGDMLStreamHandler handler(this, gdml);
+   return gdml->ParseFileSAX(filename, &handler);
 }
 
 //________________________________________________________________
@@ -1104,12 +1165,6 @@ XMLNodePointer_t TGDMLParse::VolProcess(TXMLEngine* gdml, XMLNodePointer_t node)
                TXMLEngine* gdml2 = new TXMLEngine;
                gdml2->SetSkipComments(kTRUE);
 
-               XMLDocPointer_t filedoc1 = gdml2->ParseFile(fCurrentFile);
-               if (filedoc1 == 0) {
-                  Fatal("VolProcess", "Bad filename given %s", fCurrentFile);
-               }
-               // take access to main node
-               XMLNodePointer_t mainnode2 = gdml2->DocGetRootElement(filedoc1);
                //increase depth counter + add DOM pointer
                fFILENO = fFILENO + 1;
                fFileEngine[fFILENO] = gdml2;
@@ -1117,7 +1172,10 @@ XMLNodePointer_t TGDMLParse::VolProcess(TXMLEngine* gdml, XMLNodePointer_t node)
                if (ffilemap.find(fCurrentFile) != ffilemap.end()) {
                   volref = ffilemap[fCurrentFile];
                } else {
-                  volref = ParseGDML(gdml2, mainnode2);
+                  if (!ParseGDMLFile(gdml2, fCurrentFile)) {
+                     Fatal("VolProcess", "Bad filename given %s", fCurrentFile);
+                  }
+                  volref = fWorldName;
                   ffilemap[fCurrentFile] = volref;
                }
 
@@ -1132,8 +1190,7 @@ XMLNodePointer_t TGDMLParse::VolProcess(TXMLEngine* gdml, XMLNodePointer_t node)
                gdml = fFileEngine[fFILENO];
                fCurrentFile = prevfile;
                lv = fvolmap[volref.Data()];
-               //File tree complete - Release memory before exit
-               gdml->FreeDoc(filedoc1);
+               //File complete - Release memory before exit
                delete gdml2;
             } else if (tempattr == "position") {
                attr = gdml->GetFirstAttr(subchild);
@@ -1595,7 +1652,8 @@ XMLNodePointer_t   TGDMLParse::TopProcess(TXMLEngine* gdml, XMLNodePointer_t nod
             reftemp = TString::Format("%s_%s", reftemp, fCurrentFile);
          }
          fWorld = fvolmap[reftemp];
-         fWorldName = reftemp;
+         fWorldNameBuf = reftemp;
+         fWorldName = fWorldNameBuf.Data();
       }
       child = gdml->GetNext(child);
    }
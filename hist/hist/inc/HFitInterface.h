@@ -129,6 +129,16 @@ namespace ROOT {
           needed in case to exclude points rejected by the function
       */ 
       void FillData ( BinData  & dv, const TGraph * gr, TF1 * func = 0 ); 
+
+      /** 
+          make the data vector refer to the point arrays of a TGraph or TGraphErrors without 
+          copying them. The options of dv are used and adjusted as in FillData. 
+          Return false, leaving dv unchanged, if dv is not empty or if FillData would 
+          not use all the graph points as they are (points outside the range or rejected by 
+          the function, asymmetric errors, points with zero errors). In that case 
+          FillData must be used. The graph must not be modified or deleted while dv is used. 
+      */ 
+      bool WrapData ( BinData  & dv, const TGraph * gr, TF1 * func = 0 ); 
       /** 
           fill the data vector from a TMultiGraph. Pass also the TF1 function which is 
           needed in case to exclude points rejected by the function
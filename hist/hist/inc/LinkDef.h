@@ -128,6 +128,7 @@
 #pragma link C++ class THStack+;
 #pragma link C++ class TLimit+;
 #pragma link C++ class TLimitDataSource+;
+#pragma link C++ class TConcurrentHistFiller+;
 #pragma link C++ class TConfidenceLevel+;
 #pragma link C++ class TMultiGraph+;
 #pragma link C++ class TMultiDimFit+;
@@ -307,6 +308,7 @@
 #pragma link C++ namespace ROOT::Fit; 
 #pragma link C++ function ROOT::Fit::FillData(ROOT::Fit::BinData &, const TGraph *,  TF1 * );
 #pragma link C++ function ROOT::Fit::FillData(ROOT::Fit::BinData &, const TMultiGraph *,  TF1 * );
+#pragma link C++ function ROOT::Fit::WrapData(ROOT::Fit::BinData &, const TGraph *,  TF1 * );
 
 #pragma link C++ function ROOT::Fit::FitResult::GetCovarianceMatrix<TMatrixDSym>( TMatrixDSym & );
 #pragma link C++ function ROOT::Fit::FitResult::GetCorrelationMatrix<TMatrixDSym>( TMatrixDSym & );
@@ -32,7 +32,10 @@ namespace ROOT {
    of multi-dimensions to be used in the ROOT::Math numerical algorithm
    The parameter are stored in this wrapper class, so the TF1 parameter values are not used for evaluating the function. 
    This allows for the copy of the wrapper function without the need to copy the TF1. 
+   The TF1 is not modified when evaluating the function or its parameter derivatives. 
    This wrapper class does not own the TF1 pointer, so it assumes it exists during the wrapper lifetime. 
+   The derivatives with respect to the parameters are computed analytically for the TF1 defined by a formula
+   which can be differentiated (see TFormula::EvalParGradient), otherwise numerically with TF1::GradientPar.
 
    @ingroup CppFunctions
 */ 
@@ -124,12 +127,19 @@ private:
       return fFunc->EvalPar(x,p); 
    }
 
+   /// evaluate function on n points passing the coordinates by coordinate (x[icoord][ipoint])
+   void DoEvalParVec (unsigned int n, const double * const * x, const double * p, double * y) const; 
+
    /// evaluate the partial derivative with respect to the parameter
    double DoParameterDerivative(const double * x, const double * p, unsigned int ipar) const; 
 
+   /// evaluate numerically the partial derivative with respect to the parameter, varying it in p
+   double DoNumParameterDerivative(const double * x, double * p, unsigned int ipar) const; 
+
 
    bool fLinear;                 // flag for linear functions 
    bool fPolynomial;             // flag for polynomial functions
+   bool fParGradient;            // flag for functions with analytic parameter derivatives
    TF1 * fFunc;                   // pointer to ROOT function
    unsigned int fDim;             // cached value of dimension
    std::vector<double> fParams;   // cached vector with parameter values
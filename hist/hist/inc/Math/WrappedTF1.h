@@ -145,6 +145,7 @@ private:
 
    bool fLinear;                 // flag for linear functions 
    bool fPolynomial;             // flag for polynomial functions 
+   bool fParGradient;            // flag for functions with analytic parameter derivatives
    TF1 * fFunc;                  // pointer to ROOT function
    mutable double fX[1];         //! cached vector for x value (needed for TF1::EvalPar signature) 
    std::vector<double> fParams;  //  cached vector with parameter values
@@ -0,0 +1,80 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TConcurrentHistFiller
+#define ROOT_TConcurrentHistFiller
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TConcurrentHistFiller                                                //
+//                                                                      //
+// Fill one histogram (TH1, TH2, TH3, TProfile*, THnBase) from several  //
+// threads. Each thread fills its own partial copy of the histogram     //
+// (a shard), created the first time the thread fills. The shards are   //
+// merged into the histogram on demand.                                 //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_Rtypes
+#include "Rtypes.h"
+#endif
+
+class TObject;
+class TH1;
+class THnBase;
+class TVirtualMutex;
+
+class TConcurrentHistFiller {
+
+public:
+   TConcurrentHistFiller(TH1 *hist);
+   TConcurrentHistFiller(THnBase *hist);
+   virtual ~TConcurrentHistFiller();
+
+   Int_t            Fill(Double_t x);
+   Int_t            Fill(Double_t x, Double_t y);
+   Int_t            Fill(Double_t x, Double_t y, Double_t z);
+   Int_t            Fill(Double_t x, Double_t y, Double_t z, Double_t t);
+   Int_t            Fill(Double_t x, Double_t y, Double_t z, Double_t t, Double_t w);
+   Long64_t         Fill(const Double_t *x, Double_t w = 1.);
+   void             FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride=1);
+
+   TH1             *GetHistogram();
+   THnBase         *GetHn();
+   Int_t            GetNShards() const { return fNShards; }
+   void             Merge();
+
+private:
+   enum EKind { kH1, kH2, kH3, kProfile, kProfile2D, kProfile3D, kHn };
+   enum { kPageSize = 64, kNPages = 64 };
+
+   struct TShard {
+      TObject       *fHist;   // histogram filled by a single thread
+      TVirtualMutex *fMutex;  // serializes the filling thread and Merge
+   };
+
+   TObject         *fHist;            //! histogram receiving the merged shards (not owned)
+   EKind            fKind;            //! type of fHist, selects the Fill signature
+   TShard         **fPages[kNPages];  //! shards indexed by thread number, allocated by page
+   TShard           fOverflow;        //! fills fHist directly, for threads beyond the page table
+   Int_t            fNShards;         //! number of shards created so far
+   TVirtualMutex   *fMutex;           //! protects fHist and the shard creation
+
+   void             Init();
+   TShard          *GetShard();
+   TShard          *CreateShard(ULong_t thread);
+
+   TConcurrentHistFiller(const TConcurrentHistFiller&);            // Not implemented
+   TConcurrentHistFiller &operator=(const TConcurrentHistFiller&); // Not implemented
+
+   ClassDef(TConcurrentHistFiller,0)  //Fill a histogram from several threads via per-thread shards
+};
+
+#endif
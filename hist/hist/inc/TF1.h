@@ -202,6 +202,7 @@ public:
    virtual void     DrawF1(const char *formula, Double_t xmin, Double_t xmax, Option_t *option="");
    virtual Double_t Eval(Double_t x, Double_t y=0, Double_t z=0, Double_t t=0) const;
    virtual Double_t EvalPar(const Double_t *x, const Double_t *params=0);
+   virtual void     EvalParVec(Int_t n, const Double_t *x, const Double_t *params, Double_t *y);
    // for using TF1 as a callable object (functor)
    virtual Double_t operator()(Double_t x, Double_t y=0, Double_t z = 0, Double_t t = 0) const; 
    virtual Double_t operator()(const Double_t *x, const Double_t *params=0);  
@@ -239,6 +240,7 @@ public:
    TAxis           *GetZaxis() const ;
    virtual Double_t GradientPar(Int_t ipar, const Double_t *x, Double_t eps=0.01);
    virtual void     GradientPar(const Double_t *x, Double_t *grad, Double_t eps=0.01);
+   virtual Bool_t   HasParGradient() const {return fType == 0 && TFormula::HasParGradient();}
    virtual void     InitArgs(const Double_t *x, const Double_t *params);
    static  void     InitStandardFunctions();
    virtual Double_t Integral(Double_t a, Double_t b, Double_t epsrel=1.e-12);
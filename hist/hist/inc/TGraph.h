@@ -111,6 +111,7 @@ public:
    virtual void          DrawGraph(Int_t n, const Double_t *x=0, const Double_t *y=0, Option_t *option="");
    virtual void          DrawPanel(); // *MENU*
    virtual Double_t      Eval(Double_t x, TSpline *spline=0, Option_t *option="") const;
+   virtual void          Eval(Int_t n, const Double_t *x, Double_t *y, TSpline *spline=0, Option_t *option="") const;
    virtual void          ExecuteEvent(Int_t event, Int_t px, Int_t py);
    virtual void          Expand(Int_t newsize);
    virtual void          Expand(Int_t newsize, Int_t step);
@@ -40,7 +40,6 @@ protected:
 
    Int_t       fNdt;         //!Number of Delaunay triangles found
    Int_t       fNpoints;     //!Number of data points in fGraph2D
-   Int_t       fNhull;       //!Number of points in the hull
    Double_t   *fX;           //!Pointer to fGraph2D->fX
    Double_t   *fY;           //!Pointer to fGraph2D->fY
    Double_t   *fZ;           //!Pointer to fGraph2D->fZ
@@ -55,23 +54,22 @@ protected:
    Double_t    fXScaleFactor; //!
    Double_t    fYScaleFactor; //!
    Double_t    fZout;        //!Histogram bin height for points lying outside the convex hull
-   Double_t   *fDist;        //!Array used to order mass points by distance
-   Int_t       fMaxIter;     //!Maximum number of iterations to find Delaunay triangles
-   Int_t       fTriedSize;   //!Real size of the fxTried arrays
+   Int_t       fMaxIter;     //!Maximum number of iterations to find Delaunay triangles (not used)
    Int_t      *fPTried;      //!
    Int_t      *fNTried;      //!Delaunay triangles storage of size fNdt
    Int_t      *fMTried;      //!
-   Int_t      *fHullPoints;  //!Hull points of size fNhull
-   Int_t      *fOrder;       //!Array used to order mass points by distance
+   Int_t      *fTriangles;   //!Vertices of the triangles, counter-clockwise, of size 3*fNdt
+   Int_t      *fNeighbours;  //!Triangle opposite to each vertex, -1 on the hull, of size 3*fNdt
+   Int_t       fNCellX;      //!
+   Int_t       fNCellY;      //!Number of cells of the point location grid
+   Int_t      *fCells;       //!Triangle close to each cell of the point location grid
    Bool_t      fAllTri;      //!True if FindAllTriangles() has been performed on fGraph2D
-   Bool_t      fInit;        //!True if CreateTrianglesDataStructure() and FindHull() have been performed
+   Bool_t      fInit;        //!True if CreateTrianglesDataStructure() has been performed
    TGraph2D   *fGraph2D;     //!2D graph containing the user data
 
+   void     CreateCells();
    void     CreateTrianglesDataStructure();
-   Bool_t   Enclose(Int_t T1, Int_t T2, Int_t T3, Int_t Ex) const;
-   void     FileIt(Int_t P, Int_t N, Int_t M);
-   void     FindHull();
-   Bool_t   InHull(Int_t E, Int_t X) const;
+   Int_t    FindTriangle(Double_t x, Double_t y, Int_t start, Int_t *last = 0) const;
    Double_t InterpolateOnPlane(Int_t TI1, Int_t TI2, Int_t TI3, Int_t E) const;
 
 public:
@@ -146,6 +146,8 @@ protected:
    TH1(const char *name,const char *title,Int_t nbinsx,const Double_t *xbins);
    virtual void     Copy(TObject &hnew) const;
    virtual Int_t    BufferFill(Double_t x, Double_t w);
+   enum { kNFillBatch = 256 };      // number of entries processed at once by FillN
+   void             FillNContents(Int_t n, const Int_t *bins, const Double_t *w);
    virtual Bool_t   FindNewAxisLimits(const TAxis* axis, const Double_t point, Double_t& newMin, Double_t &newMax);
    virtual void     SavePrimitiveHelp(std::ostream &out, const char *hname, Option_t *option = "");
    static Bool_t    RecomputeAxisLimits(TAxis& destAxis, const TAxis& anAxis);
@@ -191,6 +193,7 @@ public:
    virtual Bool_t   Add(const TH1 *h, const TH1 *h2, Double_t c1=1, Double_t c2=1); // *MENU*
    virtual void     AddBinContent(Int_t bin);
    virtual void     AddBinContent(Int_t bin, Double_t w);
+   virtual void     AddBinContentN(Int_t n, const Int_t *bins, const Double_t *w=0);
    static  void     AddDirectory(Bool_t add=kTRUE);
    static  Bool_t   AddDirectoryStatus();
    virtual void     Browse(TBrowser *b);
@@ -567,6 +570,9 @@ public:
    virtual void     AddBinContent(Int_t bin) {++fArray[bin];}
    virtual void     AddBinContent(Int_t bin, Double_t w)
                                  {fArray[bin] += Float_t (w);}
+   virtual void     AddBinContentN(Int_t n, const Int_t *bins, const Double_t *w=0)
+                                 {if (w) for (Int_t i=0;i<n;i++) fArray[bins[i]] += Float_t (w[i]);
+                                  else   for (Int_t i=0;i<n;i++) ++fArray[bins[i]];}
    virtual void     Copy(TObject &hnew) const;
    virtual void     Reset(Option_t *option="");
    virtual void     SetBinsLength(Int_t n=-1);
@@ -610,6 +616,9 @@ public:
    virtual void     AddBinContent(Int_t bin) {++fArray[bin];}
    virtual void     AddBinContent(Int_t bin, Double_t w)
                                  {fArray[bin] += Double_t (w);}
+   virtual void     AddBinContentN(Int_t n, const Int_t *bins, const Double_t *w=0)
+                                 {if (w) for (Int_t i=0;i<n;i++) fArray[bins[i]] += Double_t (w[i]);
+                                  else   for (Int_t i=0;i<n;i++) ++fArray[bins[i]];}
    virtual void     Copy(TObject &hnew) const;
    virtual void     Reset(Option_t *option="");
    virtual void     SetBinsLength(Int_t n=-1);
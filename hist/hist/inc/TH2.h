@@ -273,6 +273,9 @@ public:
    virtual void     AddBinContent(Int_t bin) {++fArray[bin];}
    virtual void     AddBinContent(Int_t bin, Double_t w)
                                  {fArray[bin] += Float_t (w);}
+   virtual void     AddBinContentN(Int_t n, const Int_t *bins, const Double_t *w=0)
+                                 {if (w) for (Int_t i=0;i<n;i++) fArray[bins[i]] += Float_t (w[i]);
+                                  else   for (Int_t i=0;i<n;i++) ++fArray[bins[i]];}
    virtual void     Copy(TObject &hnew) const;
    virtual void     Reset(Option_t *option="");
    virtual void     SetBinsLength(Int_t n=-1);
@@ -314,6 +317,9 @@ public:
    virtual void     AddBinContent(Int_t bin) {++fArray[bin];}
    virtual void     AddBinContent(Int_t bin, Double_t w)
                                  {fArray[bin] += Double_t (w);}
+   virtual void     AddBinContentN(Int_t n, const Int_t *bins, const Double_t *w=0)
+                                 {if (w) for (Int_t i=0;i<n;i++) fArray[bins[i]] += Double_t (w[i]);
+                                  else   for (Int_t i=0;i<n;i++) ++fArray[bins[i]];}
    virtual void     Copy(TObject &hnew) const;
    virtual void     Reset(Option_t *option="");
    virtual void     SetBinsLength(Int_t n=-1);
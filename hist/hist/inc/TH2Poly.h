@@ -63,6 +63,7 @@ protected:
 };
 
 class TList;
+class TH2PolyIndex;
 class TGraph;
 class TMultiGraph;
 class TPad;
@@ -110,6 +111,7 @@ public:
    Double_t     GetMinimum(Double_t minval) const;
    Bool_t       GetNewBinAdded() const{return fNewBinAdded;}
    Int_t        GetNumberOfBins() const{return fNcells;}
+   Bool_t       GetSpatialIndex() const{return fIndex != 0;}
    void         Honeycomb(Double_t xstart, Double_t ystart, Double_t a, Int_t k, Int_t s);   // Bins the histogram using a honeycomb structure
    Double_t     Integral(Option_t* option = "") const;
    Double_t     Integral(Int_t, Int_t, const Option_t*) const{return 0;}                             //MayNotUse
@@ -124,6 +126,7 @@ public:
    void         SetBinContentChanged(Bool_t flag){fBinContentChanged = flag;}
    void         SetFloat(Bool_t flag = true);
    void         SetNewBinAdded(Bool_t flag){fNewBinAdded = flag;}
+   void         SetSpatialIndex(Bool_t flag = kTRUE);
 
 protected:
    TList   *fBins;              //List of bins.
@@ -138,8 +141,11 @@ protected:
    Bool_t   fFloat;             //When set to kTRUE, allows the histogram to expand if a bin outside the limits is added.
    Bool_t   fNewBinAdded;       //!For the 3D Painter
    Bool_t   fBinContentChanged; //!For the 3D Painter
+   TH2PolyIndex *fIndex;        //!Spatial index of the bins used by FindBin and Fill, 0 if disabled
 
    void   AddBinToPartition(TH2PolyBin *bin);  // Adds the input bin into the partition matrix
+   void   FillBin(TH2PolyBin *bin, Double_t x, Double_t y, Double_t w);  // Fills bin and the statistics
+   TH2PolyIndex *GetIndex();                   // Returns the spatial index, built if needed
    void   Initialize(Double_t xlow, Double_t xup, Double_t ylow, Double_t yup, Int_t n, Int_t m);
    Bool_t IsIntersecting(TH2PolyBin *bin, Double_t xclipl, Double_t xclipr, Double_t yclipb, Double_t yclipt);
    Bool_t IsIntersectingPolygon(Int_t bn, Double_t *x, Double_t *y, Double_t xclipl, Double_t xclipr, Double_t yclipb, Double_t yclipt);
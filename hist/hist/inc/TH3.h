@@ -65,6 +65,8 @@ protected:
    Int_t    Fill(Double_t,const char*,Double_t) {return Fill(0);} //MayNotUse
    Int_t    Fill(const char*,Double_t,Double_t) {return Fill(0);} //MayNotUse
    Int_t    Fill(const char*,const char*,Double_t) {return Fill(0);} //MayNotUse
+   virtual void FillN(Int_t, const Double_t *, const Double_t *, Int_t) {;} //MayNotUse
+   virtual void FillN(Int_t, const Double_t *, const Double_t *, const Double_t *, Int_t) {;} //MayNotUse
 
 private: 
 
@@ -84,6 +86,7 @@ public:
    virtual Int_t    Fill(Double_t x, const char *namey, const char *namez, Double_t w);
    virtual Int_t    Fill(Double_t x, const char *namey, Double_t z, Double_t w);
    virtual Int_t    Fill(Double_t x, Double_t y, const char *namez, Double_t w);
+   virtual void     FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride=1);
 
    virtual void     FillRandom(const char *fname, Int_t ntimes=5000);
    virtual void     FillRandom(TH1 *h, Int_t ntimes=5000);
@@ -274,6 +277,9 @@ public:
    virtual void      AddBinContent(Int_t bin) {++fArray[bin];}
    virtual void      AddBinContent(Int_t bin, Double_t w)
                                  {fArray[bin] += Float_t (w);}
+   virtual void      AddBinContentN(Int_t n, const Int_t *bins, const Double_t *w=0)
+                                 {if (w) for (Int_t i=0;i<n;i++) fArray[bins[i]] += Float_t (w[i]);
+                                  else   for (Int_t i=0;i<n;i++) ++fArray[bins[i]];}
    virtual void      Copy(TObject &hnew) const;
    virtual void      Reset(Option_t *option="");
    virtual void      SetBinsLength(Int_t n=-1);
@@ -311,6 +317,9 @@ public:
    virtual void      AddBinContent(Int_t bin) {++fArray[bin];}
    virtual void      AddBinContent(Int_t bin, Double_t w)
                                  {fArray[bin] += Double_t (w);}
+   virtual void      AddBinContentN(Int_t n, const Int_t *bins, const Double_t *w=0)
+                                 {if (w) for (Int_t i=0;i<n;i++) fArray[bins[i]] += Double_t (w[i]);
+                                  else   for (Int_t i=0;i<n;i++) ++fArray[bins[i]];}
    virtual void      Copy(TObject &hnew) const;
    virtual void      Reset(Option_t *option="");
    virtual void      SetBinsLength(Int_t n=-1);
@@ -153,6 +153,8 @@ public:
    Double_t GetBinError2(Long64_t linidx) const {
       return GetCalculateErrors() ? fSumw2.At(linidx) : GetBinContent(linidx);
    }
+   void GetBinContents(Long64_t first, Int_t n, Double_t* content,
+                       Double_t* err2 = 0, Int_t* coord = 0) const;
 
    virtual const TNDArray& GetArray() const = 0;
    virtual TNDArray& GetArray() = 0;
@@ -106,6 +106,7 @@ private:
    THnBase* CloneEmpty(const char* name, const char* title,
                        const TObjArray* axes, Bool_t keepTargetAxis) const;
    virtual void Reserve(Long64_t /*nbins*/) {}
+   virtual void GetBins(Int_t n, const Double_t* x, Long64_t* bins);
    virtual void SetFilledBins(Long64_t /*nbins*/) {};
 
    Bool_t CheckConsistency(const THnBase *h, const char *tag) const;
@@ -160,6 +161,7 @@ private:
       FillBin(bin, w);
       return bin;
    }
+   void FillN(Int_t nentries, const Double_t* x, const Double_t* w = 0);
    void SetBinEdges(Int_t idim, const Double_t* bins);
    Bool_t IsInRange(Int_t *coord) const;
    Double_t GetBinError(const Int_t *idx) const { return GetBinError(GetBin(idx)); }
@@ -172,6 +174,8 @@ private:
 
    Double_t GetBinContent(const Int_t *idx) const { return GetBinContent(GetBin(idx)); } // intentionally non-virtual
    virtual Double_t GetBinContent(Long64_t bin, Int_t* idx = 0) const = 0;
+   virtual void GetBinContents(Long64_t first, Int_t n, Double_t* content,
+                               Double_t* err2 = 0, Int_t* coord = 0) const;
    virtual Double_t GetBinError2(Long64_t linidx) const = 0;
    virtual Long64_t GetBin(const Int_t* idx) const = 0;
    virtual Long64_t GetBin(const Double_t* x) const = 0;
@@ -23,9 +23,6 @@
 #ifndef ROOT_THnBase
 #include "THnBase.h"
 #endif
-#ifndef ROOT_TExMap
-#include "TExMap.h"
-#endif
 #ifndef ROOT_THnSparse_Internal
 #include "THnSparse_Internal.h"
 #endif
@@ -48,14 +45,14 @@
 #endif
 
 class THnSparseCompactBinCoord;
+class THnSparseBinIndex;
 
 class THnSparse: public THnBase {
  private:
    Int_t      fChunkSize;    // number of entries for each chunk
    Long64_t   fFilledBins;   // number of filled bins
    TObjArray  fBinContent;   // array of THnSparseArrayChunk
-   TExMap     fBins;         //! filled bins
-   TExMap     fBinsContinued;//! filled bins for non-unique hashes, containing pairs of (bin index 0, bin index 1)
+   THnSparseBinIndex *fBinIndex; //! hash of the compact coordinates -> index of the filled bin
    THnSparseCompactBinCoord *fCompactCoord; //! compact coordinate
 
    THnSparse(const THnSparse&); // Not implemented
@@ -73,7 +70,7 @@ class THnSparse: public THnBase {
 
    THnSparseArrayChunk* AddChunk();
    void Reserve(Long64_t nbins);
-   void FillExMap();
+   void FillBinIndex();
    virtual TArray* GenerateArray() const = 0;
    Long64_t GetBinIndexForCurrentBin(Bool_t allocate);
    void FillBin(Long64_t bin, Double_t w) {
@@ -135,6 +132,8 @@ class THnSparse: public THnBase {
       return THnBase::GetBinContent(idx);
    }
    Double_t GetBinContent(Long64_t bin, Int_t* idx = 0) const;
+   void GetBinContents(Long64_t first, Int_t n, Double_t* content,
+                       Double_t* err2 = 0, Int_t* coord = 0) const;
    Double_t GetBinError2(Long64_t linidx) const;
 
    Double_t GetSparseFractionBins() const;
@@ -69,6 +69,12 @@ public:
       kForcedBinning
    };
 
+   enum EEvaluation { // Evaluation method option
+      kDirect,  // Sum over all the data (or bins) for each point
+      kFastSum, // Sum over the data within the kernel support only, found with a tree (built-in kernels)
+      kFFT      // Estimate on a regular grid computed with FFT, interpolated linearly
+   };
+
    explicit TKDE(UInt_t events = 0, const Double_t* data = 0, Double_t xMin = 0.0, Double_t xMax = 0.0, const Option_t* option = "KernelType:Gaussian;Iteration:Adaptive;Mirror:noMirror;Binning:RelaxedBinning", Double_t rho = 1.0);
 
    template<class KernelFunction>
@@ -85,6 +91,8 @@ public:
    void SetBinning(EBinning);
    void SetNBins(UInt_t nbins);
    void SetUseBinsNEvents(UInt_t nEvents);
+   void SetEvaluation(EEvaluation eval);
+   void SetFFTNPoints(UInt_t npoints);
    void SetTuneFactor(Double_t rho);
    void SetRange(Double_t xMin, Double_t xMax); // By default computed from the data
 
@@ -94,6 +102,7 @@ public:
    Double_t operator()(const Double_t* x, const Double_t* p=0) const;  // Needed for creating TF1
 
    Double_t GetValue(Double_t x) const { return (*this)(x); }
+   void     GetValues(UInt_t n, const Double_t* x, Double_t* values) const;
    Double_t GetError(Double_t x) const;
 
    Double_t GetBias(Double_t x) const;
@@ -145,6 +154,7 @@ private:
    EIteration fIteration;
    EMirror fMirror;
    EBinning fBinning;
+   EEvaluation fEvaluation;
 
    Bool_t fUseMirroring, fMirrorLeft, fMirrorRight, fAsymLeft, fAsymRight;
    Bool_t fUseBins;
@@ -154,6 +164,7 @@ private:
    UInt_t fNBins;          // Number of bins for binned data option
    UInt_t fNEvents;        // Data's number of events
    UInt_t fUseBinsNEvents; // If the algorithm is allowed to use binning this is the minimum number of events to do so
+   UInt_t fFFTNPoints;     // Number of grid points for the FFT evaluation (0: automatic)
 
    Double_t fMean;  // Data mean
    Double_t fSigma; // Data std deviation
@@ -202,6 +213,7 @@ private:
    Double_t ComputeKernelMu() const;
    Double_t ComputeKernelIntegral() const;
    Double_t ComputeMidspread() ;
+   Double_t GetKernelSupport() const;
 
    UInt_t Index(Double_t x) const;
 
@@ -236,7 +248,7 @@ private:
    TF1* GetPDFUpperConfidenceInterval(Double_t confidenceLevel = 0.95, UInt_t npx = 100, Double_t xMin = 1.0, Double_t xMax = 0.0);
    TF1* GetPDFLowerConfidenceInterval(Double_t confidenceLevel = 0.95, UInt_t npx = 100, Double_t xMin = 1.0, Double_t xMax = 0.0);
 
-   ClassDef(TKDE, 1) // One dimensional semi-parametric Kernel Density Estimation
+   ClassDef(TKDE, 2) // One dimensional semi-parametric Kernel Density Estimation
 
 };
 
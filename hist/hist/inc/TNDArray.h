@@ -86,6 +86,11 @@ public:
    }
 
    virtual Double_t AtAsDouble(ULong64_t linidx) const = 0;
+   virtual void CopyAsDouble(ULong64_t first, Int_t n, Double_t* values) const {
+      // Copy the n elements starting at linear index first into values.
+      for (Int_t i = 0; i < n; ++i)
+         values[i] = AtAsDouble(first + i);
+   }
    virtual void SetAsDouble(ULong64_t linidx, Double_t value) = 0;
    virtual void AddAt(ULong64_t linidx, Double_t value) = 0;
 
@@ -179,6 +184,14 @@ public:
       if (!fData) return 0.;
       return fData[linidx];
    }
+   void CopyAsDouble(ULong64_t first, Int_t n, Double_t* values) const {
+      if (!fData) {
+         for (Int_t i = 0; i < n; ++i) values[i] = 0.;
+         return;
+      }
+      const T* data = fData + first;
+      for (Int_t i = 0; i < n; ++i) values[i] = data[i];
+   }
    void SetAsDouble(ULong64_t linidx, Double_t value) {
       if (!fData) fData = new T[fNumData]();
       fData[linidx] = (T) value;
@@ -193,18 +193,29 @@ inline TSplinePoly5::TSplinePoly5(TSplinePoly5 const &other)
 class TSpline3 : public TSpline
 {
 protected:
-   TSplinePoly3  *fPoly;       //[fNp] Array of polynomial terms
+   TSplinePoly3  *fPoly;       //[fNp] Array of polynomial terms (only used for I/O)
    Double_t       fValBeg;     // Initial value of first or second derivative
    Double_t       fValEnd;     // End value of first or second derivative
    Int_t          fBegCond;    // 0=no beg cond, 1=first derivative, 2=second derivative
    Int_t          fEndCond;    // 0=no end cond, 1=first derivative, 2=second derivative
-
+   Double_t      *fKnotX;      //! Abscissas of the knots, followed in the same block by fKnotY, fB, fC, fD
+   Double_t      *fKnotY;      //! Values at the knots
+   Double_t      *fB;          //! First order expansion coefficients
+   Double_t      *fC;          //! Second order expansion coefficients
+   Double_t      *fD;          //! Third order expansion coefficients
+   Double_t       fInvStep;    //! Inverse of the distance between equidistant knots, 0 otherwise
+
+   void   AllocateCoeff();
+   void   ArraysToPoly(TSplinePoly3 *poly) const;
    void   BuildCoeff();
+   void   CheckStep();
+   void   PolyToArrays();
    void   SetCond(const char *opt);
 
 public:
    TSpline3() : TSpline() , fPoly(0), fValBeg(0), fValEnd(0),
-      fBegCond(-1), fEndCond(-1) {}
+      fBegCond(-1), fEndCond(-1), fKnotX(0), fKnotY(0), fB(0), fC(0), fD(0),
+      fInvStep(0) {}
    TSpline3(const char *title,
             Double_t x[], Double_t y[], Int_t n, const char *opt=0,
             Double_t valbeg=0, Double_t valend=0);
@@ -228,13 +239,14 @@ public:
    TSpline3& operator=(const TSpline3&);
    Int_t    FindX(Double_t x) const;
    Double_t Eval(Double_t x) const;
+   void     Eval(Int_t n, const Double_t *x, Double_t *y) const;
    Double_t Derivative(Double_t x) const;
-   virtual ~TSpline3() {if (fPoly) delete [] fPoly;}
+   virtual ~TSpline3() {if (fPoly) delete [] fPoly; if (fKnotX) delete [] fKnotX;}
    void GetCoeff(Int_t i, Double_t &x, Double_t &y, Double_t &b,
-                 Double_t &c, Double_t &d) {x=fPoly[i].X();y=fPoly[i].Y();
-                  b=fPoly[i].B();c=fPoly[i].C();d=fPoly[i].D();}
+                 Double_t &c, Double_t &d) {x=fKnotX[i];y=fKnotY[i];
+                  b=fB[i];c=fC[i];d=fD[i];}
    void GetKnot(Int_t i, Double_t &x, Double_t &y) const
-      {x=fPoly[i].X(); y=fPoly[i].Y();}
+      {x=fKnotX[i]; y=fKnotY[i];}
    virtual  void     SaveAs(const char *filename,Option_t *option="") const;
    virtual  void     SavePrimitive(std::ostream &out, Option_t *option = "");
    virtual  void     SetPoint(Int_t i, Double_t x, Double_t y);
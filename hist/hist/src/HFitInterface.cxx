@@ -830,6 +830,73 @@ void FillData ( BinData  & dv, const TGraph * gr,  TF1 * func ) {
 
 }
 
+bool WrapData ( BinData  & dv, const TGraph * gr,  TF1 * func ) {  
+   //  make the data vector refer to the arrays of the TGraph instead of copying them. 
+   // Return false if this is not possible, i.e. if FillData would skip or modify some 
+   // of the points, leaving the data vector unchanged 
+   assert(gr != 0); 
+
+   if (dv.Size() > 0) return false; 
+
+   // work on a copy of the options, which are set in dv only in case of success
+   DataOptions fitOpt = dv.Opt();
+   BinData::ErrorType type = GetDataType(gr,fitOpt); 
+   fitOpt.fErrors1 = (type == BinData::kNoError);
+   fitOpt.fCoordErrors &= (type ==  BinData::kCoordError) ||  (type ==  BinData::kAsymError) ;
+   fitOpt.fAsymErrors &= (type ==  BinData::kAsymError);
+
+   // the wrapper does not support asymmetric errors
+   if (type == BinData::kAsymError) return false; 
+
+   int  nPoints = gr->GetN();
+   const double *gx = gr->GetX();
+   const double *gy = gr->GetY();
+   const double *ex = 0; 
+   const double *ey = 0; 
+   if (type == BinData::kValueError) { 
+      ey = gr->GetEY(); 
+      if (ey == 0) return false; 
+   }
+   else if (type == BinData::kCoordError) { 
+      ex = gr->GetEX(); 
+      ey = gr->GetEY(); 
+      if (ex == 0 || ey == 0 || !fitOpt.fCoordErrors) return false; 
+   }
+
+   const DataRange & range = dv.Range(); 
+   bool useRange = ( range.Size(0) > 0);
+   double xmin = 0; 
+   double xmax = 0; 
+   range.GetRange(xmin,xmax); 
+
+   double x[1]; 
+   for ( int i = 0; i < nPoints; ++i) { 
+      x[0] = gx[i];
+      if (useRange && (  x[0] < xmin || x[0] > xmax) ) return false;   
+      if (func) { 
+         func->RejectPoint(false);
+         (*func)( x ); 
+         if (func->RejectedPoint() ) return false; 
+      }
+      // points which would be skipped or get error 1 in FillData
+      if (type == BinData::kValueError && !(ey[i] > 0) ) return false; 
+      if (type == BinData::kCoordError) { 
+         if (ex[i] < 0 || ey[i] < 0 || ( ex[i] <= 0 && ey[i] <= 0) ) return false;
+         if (ey[i] <= 0 && fitOpt.fUseEmpty) return false; 
+      }
+   }
+
+   BinData wrapper(nPoints, gx, gy, ex, ey); 
+   wrapper.Opt() = fitOpt; 
+   dv = wrapper; 
+
+#ifdef DEBUG
+   std::cout << "TGraphFitInterface::WrapData Graph FitData size is " << dv.Size() << std::endl;
+#endif
+
+   return true; 
+}
+
 void FillData ( BinData  & dv, const TMultiGraph * mg, TF1 * func ) {  
    //  fill the data vector from a TMultiGraph. Pass also the TF1 function which is 
    // needed in case to exclude points rejected by the function
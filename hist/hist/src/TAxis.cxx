@@ -371,6 +371,55 @@ Int_t TAxis::FindFixBin(Double_t x) const
    return bin;
 }
 
+//______________________________________________________________________________
+void TAxis::FindFixBins(Int_t n, const Double_t *x, Int_t *bins, Int_t stride) const
+{
+   // Find the bin numbers of the n abscissas x[0], x[stride], ... x[(n-1)*stride]
+   // and store them in bins[0] ... bins[n-1].
+   //
+   // The result is identical to calling FindFixBin for each abscissa, but the
+   // loops contain no data dependent branches: for fix bins the compiler can
+   // vectorize them, for variable bins the binary search in the bin edges
+   // has a fixed number of steps.
+
+   if (n <= 0) return;
+   const Double_t xmin = fXmin;
+   const Double_t xmax = fXmax;
+   const Int_t nbins = fNbins;
+
+   if (!fXbins.fN) {
+      const Double_t width = xmax - xmin;
+      const Double_t under = -1;
+      const Double_t over = nbins;
+      for (Int_t i = 0; i < n; ++i) {
+         const Double_t xi = x[i*stride];
+         // the out of range values must not reach the conversion to int (NaN are overflows)
+         Double_t pos = (xi < xmin) ? under : nbins*(xi-xmin)/width;
+         pos = (xi < xmax) ? pos : over;
+         bins[i] = 1 + Int_t(pos);
+      }
+      return;
+   }
+
+   const Double_t *edges = fXbins.fArray;
+   const Int_t nedges = fXbins.fN;
+   for (Int_t i = 0; i < n; ++i) {
+      const Double_t xi = x[i*stride];
+      // search the last edge lower or equal to xi, as TMath::BinarySearch
+      const Double_t *base = edges;
+      Int_t len = nedges;
+      while (len > 1) {
+         const Int_t half = len / 2;
+         base = (base[half] <= xi) ? base + half : base;
+         len -= half;
+      }
+      Int_t bin = 1 + Int_t(base - edges);
+      bin = (xi < xmin) ? 0 : bin;
+      bin = (xi < xmax) ? bin : nbins + 1;
+      bins[i] = bin;
+   }
+}
+
 //______________________________________________________________________________
 const char *TAxis::GetBinLabel(Int_t bin) const
 {
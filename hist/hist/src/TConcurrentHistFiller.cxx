@@ -0,0 +1,393 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "TConcurrentHistFiller.h"
+#include "TH1.h"
+#include "TH2.h"
+#include "TH3.h"
+#include "TProfile.h"
+#include "TProfile2D.h"
+#include "TProfile3D.h"
+#include "THnBase.h"
+#include "TList.h"
+#include "TROOT.h"
+#include "TVirtualMutex.h"
+#include "TError.h"
+#include "ThreadLocalStorage.h"
+
+#include <string.h>
+#ifndef R__WIN32
+#include <pthread.h>
+#include <vector>
+#endif
+
+ClassImp(TConcurrentHistFiller)
+
+//______________________________________________________________________________
+//
+// TConcurrentHistFiller fills a histogram from several threads.
+//
+// Filling the same histogram from two threads corrupts its bin contents
+// and statistics. Instead of giving each thread its own clone and adding
+// them by hand, wrap the histogram in a TConcurrentHistFiller and call its
+// Fill methods from any thread:
+//
+//    TH1D *h = new TH1D("h", "h", 100, -5, 5);
+//    TConcurrentHistFiller filler(h);
+//    ... in each thread:
+//    filler.Fill(x, w);
+//    ... when the result is needed:
+//    filler.GetHistogram()->Draw();
+//
+// The first Fill from a thread creates an empty clone of the histogram
+// (a shard) which is then filled by that thread only, without contention.
+// Merge (also called by GetHistogram, GetHn and the destructor) adds the
+// shards to the histogram with its usual Merge method and resets them. It
+// can be called while other threads keep filling: each shard is locked
+// while it is merged, its filling thread waits for that duration only.
+// The shards are merged in the order of the thread numbers.
+//
+// The number of entries and the bin contents are those of a serial fill.
+// The sums of weights entering the statistics (mean, RMS) are the same
+// up to the rounding of the summation order.
+//
+// The Fill signatures are those of the wrapped histogram:
+//   TH1      Fill(x), Fill(x,w), FillN(n,x,w,stride)
+//   TH2      Fill(x,y), Fill(x,y,w)
+//   TH3      Fill(x,y,z), Fill(x,y,z,w)
+//   TProfile Fill(x,y), Fill(x,y,w)
+//   TProfile2D Fill(x,y,z), Fill(x,y,z,w)
+//   TProfile3D Fill(x,y,z,t), Fill(x,y,z,t,w)
+//   THnBase  Fill(x,w) with x an array of dimension GetNdimensions()
+//
+// As for any use of ROOT from several threads, TThread::Initialize()
+// must have been called before the threads start filling.
+// The shards are indexed by a thread number. When a thread exits, its
+// number (and thus its shard) is given to the next new thread, except on
+// Windows. If more than 4096 threads fill at the same time, the others
+// fill the histogram directly, under a lock.
+
+namespace {
+   TVirtualMutex *gThreadNumberMutex = 0;
+   ULong_t        gThreadCount = 0;
+
+#ifndef R__WIN32
+   std::vector<ULong_t> gFreeThreadNumbers;
+   pthread_key_t        gThreadNumberKey;
+   pthread_once_t       gThreadNumberOnce = PTHREAD_ONCE_INIT;
+
+   //______________________________________________________________________________
+   extern "C" void ReleaseThreadNumber(void *value)
+   {
+      // Called at the exit of a thread: its number can be given to the next
+      // new thread, which takes over its shards.
+
+      R__LOCKGUARD2(gThreadNumberMutex);
+      gFreeThreadNumbers.push_back((ULong_t)value);
+   }
+
+   //______________________________________________________________________________
+   extern "C" void CreateThreadNumberKey()
+   {
+      pthread_key_create(&gThreadNumberKey, ReleaseThreadNumber);
+   }
+
+   //______________________________________________________________________________
+   ULong_t GetThreadNumber()
+   {
+      // Return the number of the calling thread. The numbers of the threads
+      // which exited are reused, so that the numbers stay below the maximum
+      // number of threads alive at the same time.
+
+      pthread_once(&gThreadNumberOnce, CreateThreadNumberKey);
+      ULong_t number = (ULong_t)pthread_getspecific(gThreadNumberKey);
+      if (!number) {
+         R__LOCKGUARD2(gThreadNumberMutex);
+         if (gFreeThreadNumbers.empty()) {
+            number = ++gThreadCount;
+         } else {
+            number = gFreeThreadNumbers.back();
+            gFreeThreadNumbers.pop_back();
+         }
+         pthread_setspecific(gThreadNumberKey, (void*)number);
+      }
+      return number - 1;
+   }
+#else
+   TTHREAD_TLS_DECLARE(ULong_t, gThreadNumber);
+
+   //______________________________________________________________________________
+   ULong_t GetThreadNumber()
+   {
+      // Return the number of the calling thread, in order of first call.
+
+      TTHREAD_TLS_INIT(ULong_t, gThreadNumber, 0);
+      ULong_t number = TTHREAD_TLS_GET(ULong_t, gThreadNumber);
+      if (!number) {
+         R__LOCKGUARD2(gThreadNumberMutex);
+         number = ++gThreadCount;
+         TTHREAD_TLS_SET(ULong_t, gThreadNumber, number);
+      }
+      return number - 1;
+   }
+#endif
+}
+
+//______________________________________________________________________________
+TConcurrentHistFiller::TConcurrentHistFiller(TH1 *hist) :
+   fHist(hist), fKind(kH1), fNShards(0), fMutex(0)
+{
+   // Constructor for the histogram hist, which is not owned.
+
+   if      (hist->InheritsFrom(TProfile3D::Class())) fKind = kProfile3D;
+   else if (hist->InheritsFrom(TProfile2D::Class())) fKind = kProfile2D;
+   else if (hist->InheritsFrom(TProfile::Class()))   fKind = kProfile;
+   else if (hist->GetDimension() == 3)               fKind = kH3;
+   else if (hist->GetDimension() == 2)               fKind = kH2;
+   Init();
+}
+
+//______________________________________________________________________________
+TConcurrentHistFiller::TConcurrentHistFiller(THnBase *hist) :
+   fHist(hist), fKind(kHn), fNShards(0), fMutex(0)
+{
+   // Constructor for the n-dimensional histogram hist, which is not owned.
+
+   Init();
+}
+
+//______________________________________________________________________________
+TConcurrentHistFiller::~TConcurrentHistFiller()
+{
+   // Destructor, merge the shards into the histogram and delete them.
+
+   Merge();
+   for (Int_t p = 0; p < kNPages; ++p) {
+      if (!fPages[p]) continue;
+      for (Int_t i = 0; i < kPageSize; ++i) {
+         TShard *shard = fPages[p][i];
+         if (!shard) continue;
+         delete shard->fHist;
+         delete shard->fMutex;
+         delete shard;
+      }
+      delete [] fPages[p];
+   }
+   delete fMutex;
+}
+
+//______________________________________________________________________________
+void TConcurrentHistFiller::Init()
+{
+   // Initialize the page table and the locks.
+
+   memset(fPages, 0, sizeof(fPages));
+   if (gGlobalMutex) fMutex = gGlobalMutex->Factory(kTRUE);
+   fOverflow.fHist = fHist;
+   fOverflow.fMutex = fMutex;
+}
+
+//______________________________________________________________________________
+TConcurrentHistFiller::TShard *TConcurrentHistFiller::GetShard()
+{
+   // Return the shard of the calling thread, create it if needed.
+
+   ULong_t thread = GetThreadNumber();
+   if (thread >= ULong_t(kNPages*kPageSize)) return &fOverflow;
+   TShard **page = fPages[thread / kPageSize];
+   TShard *shard = page ? page[thread % kPageSize] : 0;
+   if (!shard) shard = CreateShard(thread);
+   return shard;
+}
+
+//______________________________________________________________________________
+TConcurrentHistFiller::TShard *TConcurrentHistFiller::CreateShard(ULong_t thread)
+{
+   // Create the shard of the given thread: an empty clone of the histogram.
+
+   R__LOCKGUARD(fMutex);
+   TShard **&page = fPages[thread / kPageSize];
+   if (!page) {
+      TShard **newpage = new TShard*[kPageSize];
+      memset(newpage, 0, kPageSize*sizeof(TShard*));
+      page = newpage;
+   }
+   TShard *shard = new TShard;
+   {
+      // Clone goes through gDirectory
+      R__LOCKGUARD2(gROOTMutex);
+      shard->fHist = fHist->Clone();
+      if (fKind == kHn) {
+         ((THnBase*)shard->fHist)->Reset();
+      } else {
+         TH1 *h = (TH1*)shard->fHist;
+         h->SetDirectory(0);
+         h->Reset();
+      }
+   }
+   shard->fMutex = gGlobalMutex ? gGlobalMutex->Factory(kFALSE) : 0;
+   page[thread % kPageSize] = shard;
+   ++fNShards;
+   return shard;
+}
+
+//______________________________________________________________________________
+Int_t TConcurrentHistFiller::Fill(Double_t x)
+{
+   // Fill a TH1 with x.
+
+   TShard *shard = GetShard();
+   TLockGuard guard(shard->fMutex);
+   switch (fKind) {
+      case kH1: return ((TH1*)shard->fHist)->Fill(x);
+      default:  Error("Fill", "Fill(x) not supported for %s", fHist->ClassName());
+   }
+   return -1;
+}
+
+//______________________________________________________________________________
+Int_t TConcurrentHistFiller::Fill(Double_t x, Double_t y)
+{
+   // Fill a TH1 with x and weight y, a TH2 or a TProfile with x,y.
+
+   TShard *shard = GetShard();
+   TLockGuard guard(shard->fMutex);
+   switch (fKind) {
+      case kH1:
+      case kH2:
+      case kProfile: return ((TH1*)shard->fHist)->Fill(x, y);
+      default:       Error("Fill", "Fill(x,y) not supported for %s", fHist->ClassName());
+   }
+   return -1;
+}
+
+//______________________________________________________________________________
+Int_t TConcurrentHistFiller::Fill(Double_t x, Double_t y, Double_t z)
+{
+   // Fill a TH2 or a TProfile with x,y and weight z, a TH3 or a TProfile2D with x,y,z.
+
+   TShard *shard = GetShard();
+   TLockGuard guard(shard->fMutex);
+   switch (fKind) {
+      case kH2:        return ((TH2*)shard->fHist)->Fill(x, y, z);
+      case kH3:        return ((TH3*)shard->fHist)->Fill(x, y, z);
+      case kProfile:   return ((TProfile*)shard->fHist)->Fill(x, y, z);
+      case kProfile2D: return ((TProfile2D*)shard->fHist)->Fill(x, y, z);
+      default:         Error("Fill", "Fill(x,y,z) not supported for %s", fHist->ClassName());
+   }
+   return -1;
+}
+
+//______________________________________________________________________________
+Int_t TConcurrentHistFiller::Fill(Double_t x, Double_t y, Double_t z, Double_t t)
+{
+   // Fill a TH3 or a TProfile2D with x,y,z and weight t, a TProfile3D with x,y,z,t.
+
+   TShard *shard = GetShard();
+   TLockGuard guard(shard->fMutex);
+   switch (fKind) {
+      case kH3:        return ((TH3*)shard->fHist)->Fill(x, y, z, t);
+      case kProfile2D: return ((TProfile2D*)shard->fHist)->Fill(x, y, z, t);
+      case kProfile3D: return ((TProfile3D*)shard->fHist)->Fill(x, y, z, t);
+      default:         Error("Fill", "Fill(x,y,z,t) not supported for %s", fHist->ClassName());
+   }
+   return -1;
+}
+
+//______________________________________________________________________________
+Int_t TConcurrentHistFiller::Fill(Double_t x, Double_t y, Double_t z, Double_t t, Double_t w)
+{
+   // Fill a TProfile3D with x,y,z,t and weight w.
+
+   TShard *shard = GetShard();
+   TLockGuard guard(shard->fMutex);
+   switch (fKind) {
+      case kProfile3D: return ((TProfile3D*)shard->fHist)->Fill(x, y, z, t, w);
+      default:         Error("Fill", "Fill(x,y,z,t,w) not supported for %s", fHist->ClassName());
+   }
+   return -1;
+}
+
+//______________________________________________________________________________
+Long64_t TConcurrentHistFiller::Fill(const Double_t *x, Double_t w /* = 1. */)
+{
+   // Fill a THnBase with the coordinates x and weight w.
+
+   TShard *shard = GetShard();
+   TLockGuard guard(shard->fMutex);
+   if (fKind != kHn) {
+      Error("Fill", "Fill(const Double_t*,w) not supported for %s", fHist->ClassName());
+      return -1;
+   }
+   return ((THnBase*)shard->fHist)->Fill(x, w);
+}
+
+//______________________________________________________________________________
+void TConcurrentHistFiller::FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride)
+{
+   // Fill a TH1 with an array of values and weights, see TH1::FillN.
+
+   TShard *shard = GetShard();
+   TLockGuard guard(shard->fMutex);
+   if (fKind != kH1) {
+      Error("FillN", "FillN not supported for %s", fHist->ClassName());
+      return;
+   }
+   ((TH1*)shard->fHist)->FillN(ntimes, x, w, stride);
+}
+
+//______________________________________________________________________________
+TH1 *TConcurrentHistFiller::GetHistogram()
+{
+   // Merge the shards and return the histogram, or 0 if it is a THnBase.
+
+   Merge();
+   return fKind == kHn ? 0 : (TH1*)fHist;
+}
+
+//______________________________________________________________________________
+THnBase *TConcurrentHistFiller::GetHn()
+{
+   // Merge the shards and return the histogram, or 0 if it is not a THnBase.
+
+   Merge();
+   return fKind == kHn ? (THnBase*)fHist : 0;
+}
+
+//______________________________________________________________________________
+void TConcurrentHistFiller::Merge()
+{
+   // Add the contents of the shards to the histogram and reset them.
+   // Can be called while other threads are filling.
+
+   R__LOCKGUARD(fMutex);
+   TList list;
+   for (Int_t p = 0; p < kNPages; ++p) {
+      if (!fPages[p]) continue;
+      for (Int_t i = 0; i < kPageSize; ++i) {
+         TShard *shard = fPages[p][i];
+         if (!shard) continue;
+         TLockGuard guard(shard->fMutex);
+         list.Add(shard->fHist);
+         if (fKind == kHn) {
+            THnBase *h = (THnBase*)shard->fHist;
+            if (h->GetEntries() == 0) { list.Clear(); continue; }
+            ((THnBase*)fHist)->Merge(&list);
+            h->Reset();
+         } else {
+            TH1 *h = (TH1*)shard->fHist;
+            if (h->GetEntries() == 0) { list.Clear(); continue; }
+            ((TH1*)fHist)->Merge(&list);
+            h->Reset();
+         }
+         list.Clear();
+      }
+   }
+}
@@ -1333,6 +1333,79 @@ Double_t TF1::EvalPar(const Double_t *x, const Double_t *params)
 }
 
 
+//______________________________________________________________________________
+void TF1::EvalParVec(Int_t n, const Double_t *x, const Double_t *params, Double_t *y)
+{
+   // Evaluate this one-dimensional function on the n points of the array x,
+   // with the parameters in the array params, and write the n values in y.
+   // If params is 0 the internal values of the parameters (fParams) are used.
+   //
+   // For the functions defined by the simple formulas "gaus", "expo", "polN"
+   // and "landau" (see TFormula::Analyze) the values are computed in a loop
+   // on the points which does not depend on the point (and is vectorized by
+   // the compiler, except for "landau"), with the same operations as EvalPar.
+   // For all the other functions EvalPar is called for each point; the
+   // arguments of an interpreted function are initialized here.
+
+   if (n <= 0) return;
+   if (!params) params = fParams;
+   fgCurrent = this;
+
+   Int_t number = (fType == 0 && GetNdim() == 1) ? GetNumber() : 0;
+   Int_t i;
+   if (number == 100) {
+      // gaus: p0*TMath::Gaus(x,p1,p2,norm)
+      const Double_t c = params[0], mean = params[1], sigma = params[2];
+      if (sigma == 0) {
+         for (i = 0; i < n; i++) y[i] = c*1.e30;
+         return;
+      }
+      const Double_t s = IsNormalized() ? 2.50662827463100024*sigma : 1.;
+      for (i = 0; i < n; i++) {
+         Double_t arg = (x[i]-mean)/sigma;
+         y[i] = c*(TMath::Exp(-0.5*arg*arg)/s);
+      }
+      return;
+   }
+   if (number == 200) {
+      // expo: exp(p0+p1*x)
+      const Double_t p0 = params[0], p1 = params[1];
+      for (i = 0; i < n; i++) y[i] = TMath::Exp(p0+p1*x[i]);
+      return;
+   }
+   if (number >= 300 && number < 400) {
+      // polN: the powers are accumulated in increasing order as in EvalPar
+      // with the loop on the points inside the loop on the coefficients
+      const Int_t degree = number - 300;
+      std::vector<Double_t> xpow(n, 1.);
+      for (i = 0; i < n; i++) y[i] = 0;
+      for (Int_t j = 0; j <= degree; j++) {
+         const Double_t pj = params[j];
+         for (i = 0; i < n; i++) {
+            y[i] += xpow[i]*pj;
+            xpow[i] *= x[i];
+         }
+      }
+      return;
+   }
+   if (number == 400) {
+      // landau or landaun: p0*TMath::Landau(x,p1,p2,norm)
+      const Double_t c = params[0], mpv = params[1], sigma = params[2];
+      const Bool_t norm = IsNormalized();
+      for (i = 0; i < n; i++) y[i] = c*TMath::Landau(x[i],mpv,sigma,norm);
+      return;
+   }
+
+   // general case
+   Double_t xx[4] = {0,0,0,0};
+   if (fMethodCall) InitArgs(xx,params);
+   for (i = 0; i < n; i++) {
+      xx[0] = x[i];
+      y[i] = EvalPar(xx,params);
+   }
+}
+
+
 //______________________________________________________________________________
 void TF1::ExecuteEvent(Int_t event, Int_t px, Int_t py)
 {
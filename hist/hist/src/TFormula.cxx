@@ -10,6 +10,9 @@
  *************************************************************************/
 
 #include <math.h>
+#include <map>
+#include <string>
+#include <vector>
 
 #include "Riostream.h"
 #include "TROOT.h"
@@ -22,6 +25,8 @@
 #include "TObjString.h"
 #include "TError.h"
 #include "TFormulaPrimitive.h"
+#include "TInterpreter.h"
+#include "TVirtualMutex.h"
 
 #ifdef WIN32
 #pragma optimize("",off)
@@ -31,6 +36,41 @@ static Int_t gMAXOP=1000,gMAXPAR=1000,gMAXCONST=1000;
 const Int_t  gMAXSTRINGFOUND = 10;
 const UInt_t kOptimizationError = BIT(19);
 
+static Bool_t gCompileNative = kFALSE;
+const Int_t  gMAXCOMPILED = 1000;
+
+// functions used by the code generated by TFormula::GenerateCode, with the
+// conventions of TFormula::EvalParOld
+static const char *gCompiledHelpers =
+"namespace ROOT { namespace TFormulaCompiled {\n"
+"inline double Div(double a, double b) { return (b == 0) ? 0 : a/b; }\n"
+"inline double Mod(double a, double b) { return double(Long64_t(a)%Long64_t(b)); }\n"
+"inline double Tan(double a) { return (TMath::Cos(a) == 0) ? 0 : TMath::Tan(a); }\n"
+"inline double ACos(double a) { return (TMath::Abs(a) > 1) ? 0 : TMath::ACos(a); }\n"
+"inline double ASin(double a) { return (TMath::Abs(a) > 1) ? 0 : TMath::ASin(a); }\n"
+"inline double TanH(double a) { return (TMath::CosH(a) == 0) ? 0 : TMath::TanH(a); }\n"
+"inline double ACosH(double a) { return (a < 1) ? 0 : TMath::ACosH(a); }\n"
+"inline double ATanH(double a) { return (TMath::Abs(a) > 1) ? 0 : TMath::ATanH(a); }\n"
+"inline double Sq(double a) { return a*a; }\n"
+"inline double Sqrt(double a) { return TMath::Sqrt(TMath::Abs(a)); }\n"
+"inline double Log(double a) { return (a > 0) ? TMath::Log(a) : 0; }\n"
+"inline double Log10(double a) { return (a > 0) ? TMath::Log10(a) : 0; }\n"
+"inline double Exp(double a) { if (a < -700) return 0; if (a > 700) return TMath::Exp(700); return TMath::Exp(a); }\n"
+"inline double Sign(double a) { return (a < 0) ? -1 : 1; }\n"
+"inline double Int(double a) { return double(Int_t(a)); }\n"
+"inline double Not(double a) { return (a != 0) ? 0 : 1; }\n"
+"inline double BitAnd(double a, double b) { return ((Int_t) a) & ((Int_t) b); }\n"
+"inline double BitOr(double a, double b) { return ((Int_t) a) | ((Int_t) b); }\n"
+"inline double LeftShift(double a, double b) { return ((Int_t) a) << ((Int_t) b); }\n"
+"inline double RightShift(double a, double b) { return ((Int_t) a) >> ((Int_t) b); }\n"
+"inline double Pol(double x, const double *p, int n) {\n"
+"   double r = 0, t = 1; for (int j = 0; j <= n; j++) { r += t*p[j]; t *= x; } return r; }\n"
+"inline double XYGaus(const double *x, const double *p) {\n"
+"   double u1 = (p[2] == 0) ? 1e10 : (x[0]-p[1])/p[2];\n"
+"   double u2 = (p[4] == 0) ? 1e10 : (x[1]-p[3])/p[4];\n"
+"   return p[0]*TMath::Exp(-0.5*(u1*u1+u2*u2)); }\n"
+"} }";
+
 ClassImp(TFormula)
 
 //______________________________________________________________________________
@@ -149,6 +189,7 @@ TFormula::TFormula(): TNamed()
    fOperOffset     = 0;
    fPredefined     = 0;
    fOptimal        = (TFormulaPrimitive::TFuncG)&TFormula::EvalParOld;
+   fCompiled       = 0;
 }
 
 //______________________________________________________________________________
@@ -178,6 +219,7 @@ TFormula::TFormula(const char *name,const char *expression) :
    fOperOffset     = 0;
    fPredefined     = 0;
    fOptimal        = (TFormulaPrimitive::TFuncG)&TFormula::EvalParOld;
+   fCompiled       = 0;
 
    if (!expression || !*expression) {
       Error("TFormula", "expression may not be 0 or have 0 length");
@@ -2227,6 +2269,8 @@ void TFormula::ClearFormula(Option_t * /*option*/ )
    if (fOperOffset)    { delete [] fOperOffset;    fOperOffset    = 0;}
    if (fExprOptimized) { delete [] fExprOptimized; fExprOptimized = 0;}
    if (fOperOptimized) { delete [] fOperOptimized; fOperOptimized = 0;}
+   fCompiled = 0;
+   fOptimal  = (TFormulaPrimitive::TFuncG)&TFormula::EvalParOld;
    // should we also remove the object from the list?
    // gROOT->GetListOfFunctions()->Remove(this);
    // if we don't, what happens if it fails the new compilation?
@@ -2483,6 +2527,7 @@ void TFormula::Copy(TObject &obj) const
    }
    ((TFormula&)obj).fNOperOptimized = fNOperOptimized;
    ((TFormula&)obj).fOptimal = fOptimal;
+   ((TFormula&)obj).fCompiled = fCompiled;
 
 }
 
@@ -2954,6 +2999,544 @@ Double_t TFormula::EvalParOld(const Double_t *x, const Double_t *uparams)
 
 }
 
+//______________________________________________________________________________
+Bool_t TFormula::HasParGradient() const
+{
+   // Return kTRUE if the derivatives of this formula with respect to the
+   // parameters can be computed analytically with EvalParGradient, i.e. if
+   // the expression does not call external functions, landau functions or
+   // random numbers and does not use strings.
+
+   if (fNoper <= 0 || !fOper) return kFALSE;
+   for (Int_t i=0; i<fNoper; ++i) {
+      switch(fOper[i] >> kTFOperShift) {
+         case kFunctionCall:
+         case kDefinedVariable:
+         case kDefinedString:
+         case kStringConst:
+         case kstrstr:
+         case kStringEqual:
+         case kStringNotEqual:
+         case krndm:
+         case kxlandau:
+         case kylandau:
+         case kzlandau:
+         case kxylandau:
+            return kFALSE;
+      }
+   }
+   return kTRUE;
+}
+
+//______________________________________________________________________________
+Bool_t TFormula::EvalParGradient(const Double_t *x, const Double_t *uparams, Double_t *grad)
+{
+   // Compute the derivatives of this formula with respect to the parameters
+   // at the point x and store them in grad (of size fNpar).
+   // The parameters used will be the ones in the array params if params is given
+   // otherwise parameters will be taken from the stored data members fParams.
+   //
+   // The derivatives are exact: the operators of the formula are evaluated as
+   // in EvalPar, each value of the evaluation stack carrying its gradient with
+   // respect to the parameters (forward mode automatic differentiation).
+   // Discontinuous operators (comparisons, abs, int, min, ...) are differentiated
+   // piecewise and the derivative is 0 where EvalPar returns a conventional value
+   // (e.g. division by 0, log of a negative number).
+   // Returns kFALSE, leaving grad unchanged, if the formula cannot be
+   // differentiated (see HasParGradient).
+
+   if (!HasParGradient()) return kFALSE;
+
+   Int_t i,j,k;
+   Double_t tab[kMAXFOUND];
+   const Double_t *params = (uparams) ? uparams : fParams;
+   const Int_t np = fNpar;
+   // gradients of the values of the stack: the stack has at most fNoper values
+   std::vector<Double_t> dtab(fNoper*np + 1);
+   Double_t *d = &dtab.front();
+   UInt_t pos = 0;
+
+   for (i=0; i<fNoper; ++i) {
+
+      const int oper = fOper[i];
+      const int opcode = oper >> kTFOperShift;
+
+      // gradients of the topmost value of the stack (da) and of the one below
+      // it (db), which receives the result of the binary operators
+      Double_t *da = (pos > 0) ? d + (pos-1)*np : d;
+      Double_t *db = (pos > 1) ? d + (pos-2)*np : d;
+
+      switch(opcode) {
+
+         case kParameter  : { pos++; tab[pos-1] = params[ oper & kTFOperMask ];
+                              da = d + (pos-1)*np;
+                              for (k=0; k<np; k++) da[k] = 0;
+                              da[ oper & kTFOperMask ] = 1;
+                              continue; }
+         case kConstant   :
+         case kVariable   :
+         case kpi         : { pos++;
+                              if (opcode == kConstant) tab[pos-1] = fConst[ oper & kTFOperMask ];
+                              else if (opcode == kVariable) tab[pos-1] = x[ oper & kTFOperMask ];
+                              else tab[pos-1] = TMath::ACos(-1);
+                              da = d + (pos-1)*np;
+                              for (k=0; k<np; k++) da[k] = 0;
+                              continue; }
+
+         // binary operators: u = tab[pos-1] and v = tab[pos] after pos--
+         case kAdd        : pos--; tab[pos-1] += tab[pos];
+                            for (k=0; k<np; k++) db[k] += da[k];
+                            continue;
+         case kSubstract  : pos--; tab[pos-1] -= tab[pos];
+                            for (k=0; k<np; k++) db[k] -= da[k];
+                            continue;
+         case kMultiply   : { pos--; Double_t u = tab[pos-1], v = tab[pos];
+                              tab[pos-1] = u*v;
+                              for (k=0; k<np; k++) db[k] = v*db[k] + u*da[k];
+                              continue; }
+         case kDivide     : { pos--; Double_t u = tab[pos-1], v = tab[pos];
+                              if (v == 0) { //  division by 0
+                                 tab[pos-1] = 0;
+                                 for (k=0; k<np; k++) db[k] = 0;
+                              } else {
+                                 tab[pos-1] = u/v;
+                                 for (k=0; k<np; k++) db[k] = (db[k] - tab[pos-1]*da[k])/v;
+                              }
+                              continue; }
+         case katan2      : { pos--; Double_t u = tab[pos-1], v = tab[pos];
+                              tab[pos-1] = TMath::ATan2(u,v);
+                              Double_t r = u*u + v*v;
+                              for (k=0; k<np; k++) db[k] = (r > 0) ? (v*db[k] - u*da[k])/r : 0;
+                              continue; }
+         case kfmod       : { pos--; Double_t u = tab[pos-1], v = tab[pos];
+                              tab[pos-1] = fmod(u,v);
+                              Double_t q = (v != 0) ? Double_t(Long64_t(u/v)) : 0;
+                              for (k=0; k<np; k++) db[k] = (v != 0) ? db[k] - q*da[k] : 0;
+                              continue; }
+         case kpow        : { pos--; Double_t u = tab[pos-1], v = tab[pos];
+                              tab[pos-1] = TMath::Power(u,v);
+                              // d(u^v) = v u^(v-1) du + u^v log(u) dv
+                              Double_t cu = (u != 0) ? v*tab[pos-1]/u : ((v == 1) ? 1 : 0);
+                              Double_t cv = (u > 0) ? tab[pos-1]*TMath::Log(u) : 0;
+                              for (k=0; k<np; k++) db[k] = cu*db[k] + cv*da[k];
+                              continue; }
+         case kmin        : pos--;
+                            if (tab[pos] < tab[pos-1]) {
+                               tab[pos-1] = tab[pos];
+                               for (k=0; k<np; k++) db[k] = da[k];
+                            }
+                            continue;
+         case kmax        : pos--;
+                            if (tab[pos] > tab[pos-1]) {
+                               tab[pos-1] = tab[pos];
+                               for (k=0; k<np; k++) db[k] = da[k];
+                            }
+                            continue;
+
+         // binary operators with a piecewise constant result
+         case kModulo     :
+         case kAnd        :
+         case kOr         :
+         case kEqual      :
+         case kNotEqual   :
+         case kLess       :
+         case kGreater    :
+         case kLessThan   :
+         case kGreaterThan:
+         case kBitAnd     :
+         case kBitOr      :
+         case kLeftShift  :
+         case kRightShift : { pos--; Double_t u = tab[pos-1], v = tab[pos];
+                              switch(opcode) {
+                                 case kModulo     : tab[pos-1] = Double_t(Long64_t(u)%Long64_t(v)); break;
+                                 case kAnd        : tab[pos-1] = (u!=0 && v!=0) ? 1 : 0; break;
+                                 case kOr         : tab[pos-1] = (u!=0 || v!=0) ? 1 : 0; break;
+                                 case kEqual      : tab[pos-1] = (u == v) ? 1 : 0; break;
+                                 case kNotEqual   : tab[pos-1] = (u != v) ? 1 : 0; break;
+                                 case kLess       : tab[pos-1] = (u < v) ? 1 : 0; break;
+                                 case kGreater    : tab[pos-1] = (u > v) ? 1 : 0; break;
+                                 case kLessThan   : tab[pos-1] = (u <= v) ? 1 : 0; break;
+                                 case kGreaterThan: tab[pos-1] = (u >= v) ? 1 : 0; break;
+                                 case kBitAnd     : tab[pos-1] = ((Int_t) u) & ((Int_t) v); break;
+                                 case kBitOr      : tab[pos-1] = ((Int_t) u) | ((Int_t) v); break;
+                                 case kLeftShift  : tab[pos-1] = ((Int_t) u) << ((Int_t) v); break;
+                                 case kRightShift : tab[pos-1] = ((Int_t) u) >> ((Int_t) v); break;
+                              }
+                              for (k=0; k<np; k++) db[k] = 0;
+                              continue; }
+
+         // unary operators: tab[pos-1] = f(u), da *= f'(u)
+         case kcos  :
+         case ksin  :
+         case ktan  :
+         case kacos :
+         case kasin :
+         case katan :
+         case kcosh :
+         case ksinh :
+         case ktanh :
+         case kacosh:
+         case kasinh:
+         case katanh:
+         case ksq   :
+         case ksqrt :
+         case klog  :
+         case kexp  :
+         case klog10:
+         case kabs  :
+         case ksign :
+         case kint  :
+         case kSignInv:
+         case kNot  : { Double_t u = tab[pos-1], f = 0, df = 0;
+                        switch(opcode) {
+                           case kcos  : f = TMath::Cos(u); df = -TMath::Sin(u); break;
+                           case ksin  : f = TMath::Sin(u); df = TMath::Cos(u); break;
+                           case ktan  : { Double_t c = TMath::Cos(u);
+                                          if (c != 0) { f = TMath::Tan(u); df = 1./(c*c); }
+                                          break; }
+                           case kacos : if (TMath::Abs(u) <= 1) f = TMath::ACos(u);
+                                        if (TMath::Abs(u) < 1) df = -1./TMath::Sqrt(1-u*u);
+                                        break;
+                           case kasin : if (TMath::Abs(u) <= 1) f = TMath::ASin(u);
+                                        if (TMath::Abs(u) < 1) df = 1./TMath::Sqrt(1-u*u);
+                                        break;
+                           case katan : f = TMath::ATan(u); df = 1./(1+u*u); break;
+                           case kcosh : f = TMath::CosH(u); df = TMath::SinH(u); break;
+                           case ksinh : f = TMath::SinH(u); df = TMath::CosH(u); break;
+                           case ktanh : { Double_t c = TMath::CosH(u);
+                                          if (c != 0) { f = TMath::TanH(u); df = 1./(c*c); }
+                                          break; }
+                           case kacosh: if (u >= 1) f = TMath::ACosH(u);
+                                        if (u > 1) df = 1./TMath::Sqrt(u*u-1);
+                                        break;
+                           case kasinh: f = TMath::ASinH(u); df = 1./TMath::Sqrt(u*u+1); break;
+                           case katanh: if (TMath::Abs(u) <= 1) f = TMath::ATanH(u);
+                                        if (TMath::Abs(u) < 1) df = 1./(1-u*u);
+                                        break;
+                           case ksq   : f = u*u; df = 2*u; break;
+                           case ksqrt : f = TMath::Sqrt(TMath::Abs(u));
+                                        if (f > 0) df = (u > 0) ? 0.5/f : -0.5/f;
+                                        break;
+                           case klog  : if (u > 0) { f = TMath::Log(u); df = 1./u; }
+                                        break;
+                           case kexp  : if (u > 700) f = TMath::Exp(700);
+                                        else if (u >= -700) { f = TMath::Exp(u); df = f; }
+                                        break;
+                           case klog10: if (u > 0) { f = TMath::Log10(u); df = 1./(u*TMath::Ln10()); }
+                                        break;
+                           case kabs  : f = TMath::Abs(u); df = (u < 0) ? -1 : 1; break;
+                           case ksign : f = (u < 0) ? -1 : 1; break;
+                           case kint  : f = Double_t(Int_t(u)); break;
+                           case kSignInv: f = -u; df = -1; break;
+                           case kNot  : f = (u != 0) ? 0 : 1; break;
+                        }
+                        tab[pos-1] = f;
+                        for (k=0; k<np; k++) da[k] *= df;
+                        continue; }
+
+         case kJump   : i = (oper & kTFOperMask); continue;
+         case kJumpIf : pos--; if (!tab[pos]) i = (oper & kTFOperMask); continue;
+
+         case kBoolOptimize: {
+            // boolean operation optimizer (see EvalParOld)
+            int param = (oper & kTFOperMask);
+            int op = param % 10; // 1 is && , 2 is ||
+            Bool_t skip = kFALSE;
+            if (op == 1 && (!tab[pos-1]) ) {
+               skip = kTRUE;
+               tab[pos-1] = 0;
+            } else if (op == 2 && tab[pos-1] ) {
+               skip = kTRUE;
+               tab[pos-1] = 1;
+            }
+            if (skip) {
+               for (k=0; k<np; k++) da[k] = 0;
+               i += param / 10;
+            }
+            continue;
+         }
+      }
+
+      // predefined functions: the gradient has non zero components only
+      // for the parameters of the function
+      pos++;
+      da = d + (pos-1)*np;
+      for (k=0; k<np; k++) da[k] = 0;
+      const int param = (oper & kTFOperMask);
+
+      switch(opcode) {
+
+         case kxexpo:
+         case kyexpo:
+         case kzexpo: { Double_t xv = x[opcode - kxexpo];
+                        tab[pos-1] = TMath::Exp(params[param]+params[param+1]*xv);
+                        da[param]   = tab[pos-1];
+                        da[param+1] = tab[pos-1]*xv;
+                        continue; }
+         case kxyexpo:{ tab[pos-1] = TMath::Exp(params[param]+params[param+1]*x[0]+params[param+2]*x[1]);
+                        da[param]   = tab[pos-1];
+                        da[param+1] = tab[pos-1]*x[0];
+                        da[param+2] = tab[pos-1]*x[1];
+                        continue; }
+
+         case kxgaus:
+         case kygaus:
+         case kzgaus: { Double_t xv = x[opcode - kxgaus];
+                        Double_t sigma = params[param+2];
+                        Double_t g = TMath::Gaus(xv,params[param+1],sigma,IsNormalized());
+                        tab[pos-1] = params[param]*g;
+                        da[param] = g;
+                        if (sigma != 0) {
+                           Double_t u = (xv-params[param+1])/sigma;
+                           da[param+1] = tab[pos-1]*u/sigma;
+                           da[param+2] = tab[pos-1]*(u*u - (IsNormalized() ? 1 : 0))/sigma;
+                        }
+                        continue; }
+         case kxygaus: { Double_t u1 = (params[param+2] == 0) ? 1e10 : (x[0]-params[param+1])/params[param+2];
+                         Double_t u2 = (params[param+4] == 0) ? 1e10 : (x[1]-params[param+3])/params[param+4];
+                         Double_t g = TMath::Exp(-0.5*(u1*u1+u2*u2));
+                         tab[pos-1] = params[param]*g;
+                         da[param] = g;
+                         if (params[param+2] != 0) {
+                            da[param+1] = tab[pos-1]*u1/params[param+2];
+                            da[param+2] = tab[pos-1]*u1*u1/params[param+2];
+                         }
+                         if (params[param+4] != 0) {
+                            da[param+3] = tab[pos-1]*u2/params[param+4];
+                            da[param+4] = tab[pos-1]*u2*u2/params[param+4];
+                         }
+                         continue; }
+
+         case kxpol:
+         case kypol:
+         case kzpol: { Double_t xv = x[opcode - kxpol];
+                       Int_t inter = param/100; // degree
+                       Int_t int1 = param-inter*100-1; // first parameter
+                       Double_t intermede = 1;
+                       tab[pos-1] = 0;
+                       for (j=0; j<inter+1; j++) {
+                          tab[pos-1] += intermede*params[j+int1];
+                          da[j+int1] = intermede;
+                          intermede *= xv;
+                       }
+                       continue; }
+      }
+      // not reached for the formulas accepted by HasParGradient
+      Error("EvalParGradient","Found an unsupported opcode (%d)",opcode);
+      return kFALSE;
+   }
+   for (k=0; k<np; k++) grad[k] = d[k];
+   return kTRUE;
+}
+
+//______________________________________________________________________________
+Bool_t TFormula::GenerateCode(TString &code) const
+{
+   // Generate the C++ expression computing this formula from the arrays x
+   // (variables), p (parameters) and c (constants, i.e. fConst), with the
+   // same conventions as EvalParOld
+   // (e.g. division by 0 returns 0), using the functions declared in
+   // gCompiledHelpers. Returns kFALSE if the formula contains operators which
+   // cannot be translated (external function calls, strings, jumps, rndm).
+
+   if (fNoper <= 0 || !fOper) return kFALSE;
+   const char *norm = TestBit(kNormalized) ? "true" : "false";
+   std::vector<TString> stack;
+   stack.reserve(fNoper);
+   TString a, b;
+
+   for (Int_t i=0; i<fNoper; ++i) {
+
+      const int oper = fOper[i];
+      const int opcode = oper >> kTFOperShift;
+      const int param = (oper & kTFOperMask);
+
+      switch(opcode) {
+         case kParameter  : stack.push_back(TString::Format("p[%d]",param)); continue;
+         case kVariable   : stack.push_back(TString::Format("x[%d]",param)); continue;
+         case kConstant   : stack.push_back(TString::Format("c[%d]",param)); continue;
+         case kpi         : stack.push_back(TString::Format("(%.17g)",TMath::ACos(-1))); continue;
+         case kBoolOptimize: continue; // && and || do not evaluate their right operand if not needed
+      }
+
+      switch(opcode) {
+         case kxexpo: case kyexpo: case kzexpo:
+            stack.push_back(TString::Format("TMath::Exp(p[%d]+p[%d]*x[%d])",param,param+1,opcode-kxexpo));
+            continue;
+         case kxyexpo:
+            stack.push_back(TString::Format("TMath::Exp(p[%d]+p[%d]*x[0]+p[%d]*x[1])",param,param+1,param+2));
+            continue;
+         case kxgaus: case kygaus: case kzgaus:
+            stack.push_back(TString::Format("p[%d]*TMath::Gaus(x[%d],p[%d],p[%d],%s)",
+                                            param,opcode-kxgaus,param+1,param+2,norm));
+            continue;
+         case kxygaus:
+            stack.push_back(TString::Format("ROOT::TFormulaCompiled::XYGaus(x,p+%d)",param));
+            continue;
+         case kxlandau: case kylandau: case kzlandau:
+            stack.push_back(TString::Format("p[%d]*TMath::Landau(x[%d],p[%d],p[%d],%s)",
+                                            param,opcode-kxlandau,param+1,param+2,norm));
+            continue;
+         case kxylandau:
+            stack.push_back(TString::Format("p[%d]*TMath::Landau(x[0],p[%d],p[%d],%s)*TMath::Landau(x[1],p[%d],p[%d],%s)",
+                                            param,param+1,param+2,norm,param+3,param+4,norm));
+            continue;
+         case kxpol: case kypol: case kzpol:
+            // param = 100*degree + index of the first parameter + 1
+            stack.push_back(TString::Format("ROOT::TFormulaCompiled::Pol(x[%d],p+%d,%d)",
+                                            opcode-kxpol,param-(param/100)*100-1,param/100));
+            continue;
+      }
+
+      const char *unary = 0;
+      switch(opcode) {
+         case kcos    : unary = "TMath::Cos"; break;
+         case ksin    : unary = "TMath::Sin"; break;
+         case ktan    : unary = "ROOT::TFormulaCompiled::Tan"; break;
+         case kacos   : unary = "ROOT::TFormulaCompiled::ACos"; break;
+         case kasin   : unary = "ROOT::TFormulaCompiled::ASin"; break;
+         case katan   : unary = "TMath::ATan"; break;
+         case kcosh   : unary = "TMath::CosH"; break;
+         case ksinh   : unary = "TMath::SinH"; break;
+         case ktanh   : unary = "ROOT::TFormulaCompiled::TanH"; break;
+         case kacosh  : unary = "ROOT::TFormulaCompiled::ACosH"; break;
+         case kasinh  : unary = "TMath::ASinH"; break;
+         case katanh  : unary = "ROOT::TFormulaCompiled::ATanH"; break;
+         case ksq     : unary = "ROOT::TFormulaCompiled::Sq"; break;
+         case ksqrt   : unary = "ROOT::TFormulaCompiled::Sqrt"; break;
+         case klog    : unary = "ROOT::TFormulaCompiled::Log"; break;
+         case kexp    : unary = "ROOT::TFormulaCompiled::Exp"; break;
+         case klog10  : unary = "ROOT::TFormulaCompiled::Log10"; break;
+         case kabs    : unary = "TMath::Abs"; break;
+         case ksign   : unary = "ROOT::TFormulaCompiled::Sign"; break;
+         case kint    : unary = "ROOT::TFormulaCompiled::Int"; break;
+         case kSignInv: unary = "-"; break;
+         case kNot    : unary = "ROOT::TFormulaCompiled::Not"; break;
+      }
+      if (unary) {
+         if (stack.empty()) return kFALSE;
+         stack.back() = TString::Format("%s(%s)",unary,stack.back().Data());
+         continue;
+      }
+
+      const char *binary = 0;
+      const char *binop = 0;
+      switch(opcode) {
+         case kAdd        : binop = "+"; break;
+         case kSubstract  : binop = "-"; break;
+         case kMultiply   : binop = "*"; break;
+         case kDivide     : binary = "ROOT::TFormulaCompiled::Div"; break;
+         case kModulo     : binary = "ROOT::TFormulaCompiled::Mod"; break;
+         case katan2      : binary = "TMath::ATan2"; break;
+         case kfmod       : binary = "fmod"; break;
+         case kpow        : binary = "TMath::Power"; break;
+         case kmin        : binary = "TMath::Min"; break;
+         case kmax        : binary = "TMath::Max"; break;
+         case kAnd        : binop = "!=0 && 0!="; break;
+         case kOr         : binop = "!=0 || 0!="; break;
+         case kEqual      : binop = "=="; break;
+         case kNotEqual   : binop = "!="; break;
+         case kLess       : binop = "<"; break;
+         case kGreater    : binop = ">"; break;
+         case kLessThan   : binop = "<="; break;
+         case kGreaterThan: binop = ">="; break;
+         case kBitAnd     : binary = "ROOT::TFormulaCompiled::BitAnd"; break;
+         case kBitOr      : binary = "ROOT::TFormulaCompiled::BitOr"; break;
+         case kLeftShift  : binary = "ROOT::TFormulaCompiled::LeftShift"; break;
+         case kRightShift : binary = "ROOT::TFormulaCompiled::RightShift"; break;
+      }
+      if (!binary && !binop) return kFALSE;
+      if (stack.size() < 2) return kFALSE;
+      b = stack.back();
+      stack.pop_back();
+      a = stack.back();
+      if (binary) {
+         stack.back() = TString::Format("%s(%s,%s)",binary,a.Data(),b.Data());
+      } else if (opcode == kAdd || opcode == kSubstract || opcode == kMultiply) {
+         stack.back() = TString::Format("(%s%s%s)",a.Data(),binop,b.Data());
+      } else {
+         // logical operators give 0 or 1
+         stack.back() = TString::Format("double((%s)%s(%s))",a.Data(),binop,b.Data());
+      }
+   }
+   if (stack.size() != 1) return kFALSE;
+   code = stack.front();
+   return kTRUE;
+}
+
+//______________________________________________________________________________
+Bool_t TFormula::CompileNative()
+{
+   // Compile this formula to native code with the interpreter and use it in
+   // EvalPar instead of interpreting the operators (EvalParFast).
+   // The C++ expression of the formula is generated by GenerateCode; the
+   // constants are passed to the compiled function, which is thus shared by
+   // all the formulas with the same operators, whatever their constants.
+   // At most gMAXCOMPILED different expressions are compiled.
+   // Returns kFALSE, keeping the interpreted evaluation, if the formula
+   // cannot be translated or compiled.
+   // When enabled with TFormula::SetCompileNative, CompileNative is called
+   // by Optimize, i.e. when the formula is created or read, before it can be
+   // evaluated from several threads. Calling it explicitly while the formula
+   // is evaluated by other threads is not thread safe.
+
+   TString expr;
+   if (!GenerateCode(expr)) return kFALSE;
+   if (!gInterpreter) return kFALSE;
+
+   R__LOCKGUARD(gClingMutex);
+
+   // native code of the formulas, by expression (0 if the compilation failed)
+   static std::map<std::string, TFuncCompiled> compiled;
+   std::map<std::string, TFuncCompiled>::iterator it = compiled.find(expr.Data());
+   if (it == compiled.end()) {
+      if ((Int_t)compiled.size() >= gMAXCOMPILED) return kFALSE;
+      TInterpreter::EErrorCode err = TInterpreter::kNoError;
+      if (compiled.empty()) {
+         gInterpreter->ProcessLine("#include \"TMath.h\"", &err);
+         if (err == TInterpreter::kNoError) gInterpreter->ProcessLine(gCompiledHelpers, &err);
+      }
+      TFuncCompiled func = 0;
+      TString name = TString::Format("ROOT::TFormulaCompiled::Formula%d", (Int_t)compiled.size());
+      if (err == TInterpreter::kNoError) {
+         gInterpreter->ProcessLine(TString::Format(
+            "namespace ROOT { namespace TFormulaCompiled { double Formula%d(const double *x, const double *p, const double *c) { return %s; } } }",
+            (Int_t)compiled.size(), expr.Data()), &err);
+      }
+      if (err == TInterpreter::kNoError) {
+         func = (TFuncCompiled)gInterpreter->Calc(TString::Format("(long)&%s", name.Data()), &err);
+         if (err != TInterpreter::kNoError) func = 0;
+      }
+      if (!func) Warning("CompileNative", "cannot compile %s, the formula is interpreted", GetTitle());
+      it = compiled.insert(std::make_pair(std::string(expr.Data()), func)).first;
+   }
+   if (!it->second) return kFALSE;
+   // fCompiled is set before fOptimal (EvalParCompiled falls back to
+   // EvalParFast while it is not set)
+   fCompiled = it->second;
+   fOptimal = (TFormulaPrimitive::TFuncG)&TFormula::EvalParCompiled;
+   return kTRUE;
+}
+
+//______________________________________________________________________________
+Double_t TFormula::EvalParCompiled(const Double_t *x, const Double_t *params)
+{
+   // Evaluate this formula with the native code generated by CompileNative.
+
+   if (!fCompiled) return EvalParFast(x, params);
+   return fCompiled(x, (params) ? params : fParams, fConst);
+}
+
+//______________________________________________________________________________
+void TFormula::SetCompileNative(Bool_t compile)
+{
+   // Enable or disable (default) the compilation to native code of the
+   // formulas (see CompileNative). The formulas created or read while it is
+   // enabled are compiled by Optimize.
+
+   gCompileNative = compile;
+}
+
 //------------------------------------------------------------------------------
 TString TFormula::GetExpFormula(Option_t *option) const
 {
@@ -4031,6 +4614,12 @@ void TFormula::Optimize()
          case kFDM    : {fOptimal= (TFormulaPrimitive::TFuncG)&TFormula::EvalPrimitive4; break;}
       }
    }
+   // 3.) Compile the formulas which are not primitives to native code, now
+   //     rather than at their first evaluation, which may run concurrently
+   fCompiled = 0;
+   if (gCompileNative && fOptimal == (TFormulaPrimitive::TFuncG)&TFormula::EvalParFast) {
+      CompileNative();
+   }
 
    delete [] map1;
    delete [] map0;
@@ -36,6 +36,7 @@
 #include <stdlib.h>
 #include <string>
 #include <cassert>
+#include <algorithm>
 
 #include "HFitInterface.h"
 #include "Fit/DataRange.h"
@@ -45,6 +46,70 @@ extern void H1LeastSquareSeqnd(Int_t n, Double_t *a, Int_t idim, Int_t &ifail, I
 
 ClassImp(TGraph)
 
+namespace {
+
+   // order point indices by increasing x
+   struct CompareIndexX {
+      const Double_t *fX;
+      CompareIndexX(const Double_t *x) : fX(x) {}
+      bool operator()(Int_t i, Int_t j) const { return fX[i] < fX[j]; }
+   };
+
+   //______________________________________________________________________________
+   void SortPoints(Int_t n, const Double_t *x, const Double_t *y,
+                   std::vector<Double_t> &xsort, std::vector<Double_t> &ysort)
+   {
+      // Copy the n points (x,y) sorted by increasing x; points with the same
+      // x keep their order.
+
+      std::vector<Int_t> index(n);
+      for (Int_t i = 0; i < n; ++i) index[i] = i;
+      std::stable_sort(index.begin(), index.end(), CompareIndexX(x));
+      xsort.resize(n);
+      ysort.resize(n);
+      for (Int_t i = 0; i < n; ++i) {
+         xsort[i] = x[index[i]];
+         ysort[i] = y[index[i]];
+      }
+   }
+
+   //______________________________________________________________________________
+   Bool_t IsSortedX(Int_t n, const Double_t *x)
+   {
+      // Return true if the n values x are in increasing order.
+
+      for (Int_t i = 1; i < n; ++i)
+         if (x[i] < x[i-1]) return kFALSE;
+      return kTRUE;
+   }
+
+   //______________________________________________________________________________
+   Double_t InterpolateSorted(Int_t n, const Double_t *x, const Double_t *y, Double_t xx)
+   {
+      // Linear interpolation at xx of the n >= 2 points (x,y) sorted by
+      // increasing x. Outside the range the points with the two lowest
+      // (highest) x values are used. Among points with the same x the first
+      // one is taken, as in the linear scan of TGraph::Eval.
+
+      // first point with x >= xx
+      Int_t up = std::lower_bound(x, x + n, xx) - x;
+      if (up < n && x[up] == xx) return y[up];
+      Int_t low;
+      if (up == 0) {
+         low = 0;
+         up = std::upper_bound(x, x + n, x[0]) - x;
+         if (up == n) return y[0];
+      } else {
+         if (up == n) up = std::lower_bound(x, x + n, x[n - 1]) - x;
+         if (up == 0) return y[0];
+         low = up - 1;
+         while (low > 0 && x[low - 1] == x[low]) --low;
+      }
+      return y[up] + (xx - x[up]) * (y[low] - y[up]) / (x[low] - x[up]);
+   }
+
+}
+
 
 //______________________________________________________________________________
 /* Begin_Html
@@ -898,6 +963,10 @@ Double_t TGraph::Eval(Double_t x, TSpline *spline, Option_t *option) const
    //   and the interpolated value from the spline is returned.
    //   the internally created spline is deleted on return.
    //  -if spline is specified, it is used to return the interpolated value.
+   //
+   // All the points are scanned to find the two points around x. To
+   // interpolate at many abscissas use Eval(n, x, y, spline, option), which
+   // sorts the points only once.
 
 
    if (!spline) {
@@ -911,14 +980,9 @@ Double_t TGraph::Eval(Double_t x, TSpline *spline, Option_t *option) const
       if (opt.Contains("s")) {
 
          // points must be sorted before using a TSpline
-         std::vector<Double_t> xsort(fNpoints);
-         std::vector<Double_t> ysort(fNpoints);
-         std::vector<Int_t> indxsort(fNpoints);
-         TMath::Sort(fNpoints, fX, &indxsort[0], false);
-         for (Int_t i = 0; i < fNpoints; ++i) {
-            xsort[i] = fX[ indxsort[i] ];
-            ysort[i] = fY[ indxsort[i] ];
-         }
+         std::vector<Double_t> xsort;
+         std::vector<Double_t> ysort;
+         SortPoints(fNpoints, fX, fY, xsort, ysort);
 
          // spline interpolation creating a new spline
          TSpline3 *s = new TSpline3("", &xsort[0], &ysort[0], fNpoints);
@@ -977,6 +1041,55 @@ Double_t TGraph::Eval(Double_t x, TSpline *spline, Option_t *option) const
 }
 
 
+//______________________________________________________________________________
+void TGraph::Eval(Int_t n, const Double_t *x, Double_t *y, TSpline *spline, Option_t *option) const
+{
+   // Interpolate points in this graph at the n abscissas x[i] and store the
+   // results in y[i]. The spline and option arguments have the same meaning as
+   // in Eval(Double_t x, TSpline *spline, Option_t *option).
+   //
+   // The points of the graph are sorted along x once for all the abscissas
+   // (not needed if they are found to be in increasing order already) and the
+   // linear interpolation uses a binary search, so the cost is O((n + N) log N)
+   // for a graph of N points instead of O(n N). With option "S" the TSpline3
+   // is built once.
+   // Points with the same x are ordered as in the graph; for a graph not
+   // sorted along x, values outside the graph range are extrapolated using the
+   // two points with the lowest (highest) x.
+
+   if (n <= 0) return;
+   Int_t i;
+   if (spline) {
+      for (i = 0; i < n; ++i) y[i] = spline->Eval(x[i]);
+      return;
+   }
+   if (fNpoints <= 1) {
+      Double_t y0 = (fNpoints == 0) ? 0 : fY[0];
+      for (i = 0; i < n; ++i) y[i] = y0;
+      return;
+   }
+
+   std::vector<Double_t> xsort;
+   std::vector<Double_t> ysort;
+   const Double_t *gx = fX;
+   const Double_t *gy = fY;
+   TString opt = option;
+   opt.ToLower();
+   if (opt.Contains("s") || !IsSortedX(fNpoints, fX)) {
+      SortPoints(fNpoints, fX, fY, xsort, ysort);
+      gx = &xsort[0];
+      gy = &ysort[0];
+   }
+
+   if (opt.Contains("s")) {
+      TSpline3 s("", &xsort[0], &ysort[0], fNpoints);
+      s.Eval(n, x, y);
+      return;
+   }
+   for (i = 0; i < n; ++i) y[i] = InterpolateSorted(fNpoints, gx, gy, x[i]);
+}
+
+
 //______________________________________________________________________________
 void TGraph::ExecuteEvent(Int_t event, Int_t px, Int_t py)
 {
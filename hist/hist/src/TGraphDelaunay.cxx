@@ -13,6 +13,10 @@
 #include "TGraph2D.h"
 #include "TGraphDelaunay.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 ClassImp(TGraphDelaunay)
 
 
@@ -22,9 +26,12 @@ ClassImp(TGraphDelaunay)
 // triangulation code derives from an implementation done by Luke Jones
 // (Royal Holloway, University of London) in April 2002 in the PAW context.
 //
-// This software cannot be guaranteed to work under all circumstances. They
-// were originally written to work with a few hundred points in an XY space
-// with similar X and Y ranges.
+// The triangulation is built by inserting the points one at a time
+// (Bowyer-Watson algorithm), in the order of a Hilbert curve so that each
+// point is located by a short walk from the previous one. This takes
+// O(n log n) for n points. The triangles are then located with a grid of
+// starting triangles followed by a walk, so that Interpolate() does not
+// depend on the number of points for regularly distributed data.
 //
 // Definition of Delaunay triangulation (After B. Delaunay):
 // For a set S of points in the Euclidean plane, the unique triangulation DT(S)
@@ -45,6 +52,413 @@ gives a nice practical view of Delaunay triangulation and Voronoi diagram.
 //End_Html
 
 
+namespace {
+
+   //______________________________________________________________________________
+   Double_t Orientation(Double_t ax, Double_t ay, Double_t bx, Double_t by,
+                        Double_t cx, Double_t cy)
+   {
+      // Twice the signed area of the triangle a-b-c: positive if a, b and c
+      // are counter-clockwise, negative if clockwise; 0 if the sign cannot be
+      // determined reliably with double precision.
+
+      const Double_t left  = (bx - ax) * (cy - ay);
+      const Double_t right = (by - ay) * (cx - ax);
+      const Double_t det   = left - right;
+      const Double_t err   = 3.3306690738754716e-16 * (TMath::Abs(left) + TMath::Abs(right));
+      return (det > err || -det > err) ? det : 0.;
+   }
+
+   //______________________________________________________________________________
+   Double_t InCircle(Double_t ax, Double_t ay, Double_t bx, Double_t by,
+                     Double_t cx, Double_t cy, Double_t px, Double_t py)
+   {
+      // Positive if p lies inside the circle through the counter-clockwise
+      // triangle a-b-c, negative if it is outside; 0 if it is on the circle
+      // or the sign cannot be determined reliably with double precision.
+
+      const Double_t adx = ax - px, ady = ay - py;
+      const Double_t bdx = bx - px, bdy = by - py;
+      const Double_t cdx = cx - px, cdy = cy - py;
+      const Double_t bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+      const Double_t cdxady = cdx * ady, adxcdy = adx * cdy;
+      const Double_t adxbdy = adx * bdy, bdxady = bdx * ady;
+      const Double_t alift = adx * adx + ady * ady;
+      const Double_t blift = bdx * bdx + bdy * bdy;
+      const Double_t clift = cdx * cdx + cdy * cdy;
+      const Double_t det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy)
+                         + clift * (adxbdy - bdxady);
+      const Double_t permanent = (TMath::Abs(bdxcdy) + TMath::Abs(cdxbdy)) * alift
+                               + (TMath::Abs(cdxady) + TMath::Abs(adxcdy)) * blift
+                               + (TMath::Abs(adxbdy) + TMath::Abs(bdxady)) * clift;
+      const Double_t err = 1.1102230246251577e-15 * permanent;
+      return (det > err || -det > err) ? det : 0.;
+   }
+
+   //______________________________________________________________________________
+   ULong64_t HilbertIndex(UInt_t x, UInt_t y)
+   {
+      // Position of the cell (x,y) of a 65536 x 65536 grid along a Hilbert curve.
+
+      const UInt_t n = 1 << 16;
+      ULong64_t d = 0;
+      for (UInt_t s = n / 2; s > 0; s /= 2) {
+         const UInt_t rx = (x & s) > 0;
+         const UInt_t ry = (y & s) > 0;
+         d += (ULong64_t) s * s * ((3 * rx) ^ ry);
+         if (ry == 0) {
+            if (rx == 1) {
+               x = n - 1 - x;
+               y = n - 1 - y;
+            }
+            std::swap(x, y);
+         }
+      }
+      return d;
+   }
+
+//______________________________________________________________________________
+//
+// TDelaunayTriangulation computes the Delaunay triangulation of the points
+// 1 ... n of the arrays x and y with the Bowyer-Watson algorithm: each new
+// point p is located in the current triangulation, the triangles whose
+// circumcircle contains p (the cavity) are removed, and the boundary of the
+// cavity is connected to p.
+// The outside of the convex hull is covered by "ghost" triangles made of a
+// hull edge and a vertex at infinity, so that points outside the hull are
+// inserted the same way as points inside.
+//______________________________________________________________________________
+
+class TDelaunayTriangulation {
+public:
+   TDelaunayTriangulation(Int_t n, const Double_t *x, const Double_t *y):
+      fN(n), fX(x), fY(y), fLast(-1), fStamp(0) {}
+
+   void Build(Double_t xmin, Double_t xmax, Double_t ymin, Double_t ymax);
+   void GetTriangles(std::vector<Int_t> &vertices, std::vector<Int_t> &neighbours) const;
+
+private:
+   enum { kGhost = -1 };
+
+   struct TTriangle {
+      Int_t  fV[3];    // vertices, counter-clockwise; one may be kGhost
+      Int_t  fN[3];    // neighbour opposite to each vertex
+      Int_t  fMark;    // cavity marker
+      Bool_t fAlive;   // whether the triangle is part of the triangulation
+   };
+
+   struct TEdge {
+      Int_t fA, fB;       // vertices, counter-clockwise as seen from the cavity
+      Int_t fOutside;     // triangle on the other side
+      Int_t fCavity;      // cavity triangle
+   };
+
+   Bool_t   Hides(Int_t a, Int_t b, Int_t p) const;
+   Bool_t   InConflict(Int_t t, Int_t p) const;
+   Bool_t   IsGhost(Int_t t) const;
+   void     Link(Int_t t1, Int_t t2);
+   Int_t    Locate(Int_t p) const;
+   Bool_t   Insert(Int_t p);
+   Int_t    NewTriangle(Int_t a, Int_t b, Int_t c);
+   Double_t Orient(Int_t a, Int_t b, Int_t p) const {
+      return Orientation(fX[a], fY[a], fX[b], fY[b], fX[p], fY[p]);
+   }
+
+   Int_t                  fN;      // number of points
+   const Double_t        *fX;      // x of the points, 1 ... fN
+   const Double_t        *fY;      // y of the points, 1 ... fN
+   std::vector<TTriangle> fTri;    // triangles, alive or not
+   std::vector<Int_t>     fFree;   // dead triangles that can be reused
+   std::vector<Int_t>     fCavity; // triangles of the current cavity
+   std::vector<TEdge>     fEdges;  // boundary of the current cavity
+   Int_t                  fLast;   // finite triangle where the walks start
+   Int_t                  fStamp;  // cavity marker of the current insertion
+};
+
+//______________________________________________________________________________
+Bool_t TDelaunayTriangulation::IsGhost(Int_t t) const
+{
+   // Whether t has a vertex at infinity.
+
+   const Int_t *v = fTri[t].fV;
+   return v[0] == kGhost || v[1] == kGhost || v[2] == kGhost;
+}
+
+//______________________________________________________________________________
+Int_t TDelaunayTriangulation::NewTriangle(Int_t a, Int_t b, Int_t c)
+{
+   // Create the triangle a-b-c, without neighbours.
+
+   Int_t t;
+   if (!fFree.empty()) {
+      t = fFree.back();
+      fFree.pop_back();
+   } else {
+      t = fTri.size();
+      fTri.push_back(TTriangle());
+   }
+   TTriangle &tri = fTri[t];
+   tri.fV[0] = a;
+   tri.fV[1] = b;
+   tri.fV[2] = c;
+   tri.fN[0] = tri.fN[1] = tri.fN[2] = -1;
+   tri.fMark = 0;
+   tri.fAlive = kTRUE;
+   return t;
+}
+
+//______________________________________________________________________________
+void TDelaunayTriangulation::Link(Int_t t1, Int_t t2)
+{
+   // Make t1 and t2 neighbours if they share an edge.
+
+   for (Int_t i = 0; i < 3; ++i) {
+      const Int_t a = fTri[t1].fV[(i + 1) % 3], b = fTri[t1].fV[(i + 2) % 3];
+      for (Int_t j = 0; j < 3; ++j) {
+         if (fTri[t2].fV[(j + 1) % 3] == b && fTri[t2].fV[(j + 2) % 3] == a) {
+            fTri[t1].fN[i] = t2;
+            fTri[t2].fN[j] = t1;
+         }
+      }
+   }
+}
+
+//______________________________________________________________________________
+Bool_t TDelaunayTriangulation::InConflict(Int_t t, Int_t p) const
+{
+   // Whether the new point p is in conflict with t, i.e. whether t must be
+   // removed when inserting p. For a finite triangle, p must be inside its
+   // circumcircle. A ghost triangle is the half plane beyond its hull edge;
+   // p must be in that half plane, or on the hull edge itself.
+
+   const Int_t *v = fTri[t].fV;
+   for (Int_t i = 0; i < 3; ++i) {
+      if (v[i] != kGhost) continue;
+      const Int_t a = v[(i + 1) % 3], b = v[(i + 2) % 3];
+      const Double_t o = Orient(a, b, p);
+      if (o > 0) return kTRUE;
+      if (o < 0) return kFALSE;
+      return (fX[p] - fX[a]) * (fX[p] - fX[b]) + (fY[p] - fY[a]) * (fY[p] - fY[b]) < 0;
+   }
+   return InCircle(fX[v[0]], fY[v[0]], fX[v[1]], fY[v[1]], fX[v[2]], fY[v[2]],
+                   fX[p], fY[p]) > 0;
+}
+
+//______________________________________________________________________________
+Bool_t TDelaunayTriangulation::Hides(Int_t a, Int_t b, Int_t p) const
+{
+   // Whether the edge a-b of a cavity triangle cannot be connected to the new
+   // point p: p is on the cavity side of the edge, or inside the edge itself.
+
+   const Double_t o = Orient(a, b, p);
+   if (o != 0) return o < 0;
+   return (fX[p] - fX[a]) * (fX[p] - fX[b]) + (fY[p] - fY[a]) * (fY[p] - fY[b]) < 0;
+}
+
+//______________________________________________________________________________
+Int_t TDelaunayTriangulation::Locate(Int_t p) const
+{
+   // Return the finite triangle containing p, or a ghost triangle in conflict
+   // with p if p is outside the convex hull. Walks from fLast towards p.
+
+   Int_t t = fLast;
+   Int_t from = -1;
+   const Int_t maxSteps = fTri.size() + 3;
+   for (Int_t step = 0; step < maxSteps; ++step) {
+      if (IsGhost(t)) return t;
+      const TTriangle &tri = fTri[t];
+      Int_t next = -1;
+      for (Int_t k = 0; k < 3; ++k) {
+         // vary the first edge tested, against cycles in degenerate cases
+         const Int_t i = (k + step) % 3;
+         if (tri.fN[i] == from) continue;
+         if (Orient(tri.fV[(i + 1) % 3], tri.fV[(i + 2) % 3], p) < 0) {
+            next = tri.fN[i];
+            break;
+         }
+      }
+      if (next < 0) return t;
+      from = t;
+      t = next;
+   }
+
+   // the walk did not converge: check all triangles
+   Int_t ghost = -1;
+   for (t = 0; t < (Int_t) fTri.size(); ++t) {
+      if (!fTri[t].fAlive) continue;
+      if (IsGhost(t)) {
+         if (ghost < 0 && InConflict(t, p)) ghost = t;
+         continue;
+      }
+      const Int_t *v = fTri[t].fV;
+      if (Orient(v[0], v[1], p) >= 0 && Orient(v[1], v[2], p) >= 0
+          && Orient(v[2], v[0], p) >= 0)
+         return t;
+   }
+   return ghost;
+}
+
+//______________________________________________________________________________
+Bool_t TDelaunayTriangulation::Insert(Int_t p)
+{
+   // Insert point p. Return false if p is a duplicate of an existing vertex.
+
+   const Int_t start = Locate(p);
+   if (start < 0) return kFALSE;
+   if (!IsGhost(start)) {
+      const Int_t *v = fTri[start].fV;
+      for (Int_t i = 0; i < 3; ++i)
+         if (fX[v[i]] == fX[p] && fY[v[i]] == fY[p]) return kFALSE;
+   }
+
+   // collect the cavity: the triangles in conflict connected to start
+   ++fStamp;
+   fCavity.clear();
+   fCavity.push_back(start);
+   fTri[start].fMark = fStamp;
+   for (size_t k = 0; k < fCavity.size(); ++k) {
+      for (Int_t i = 0; i < 3; ++i) {
+         const Int_t n = fTri[fCavity[k]].fN[i];
+         if (fTri[n].fMark == fStamp || !InConflict(n, p)) continue;
+         fTri[n].fMark = fStamp;
+         fCavity.push_back(n);
+      }
+   }
+
+   // collect the boundary of the cavity; with rounding errors a finite
+   // boundary edge may hide p from the cavity, extend the cavity across it
+   Bool_t extended = kTRUE;
+   while (extended) {
+      extended = kFALSE;
+      fEdges.clear();
+      for (size_t k = 0; k < fCavity.size() && !extended; ++k) {
+         const TTriangle &tri = fTri[fCavity[k]];
+         for (Int_t i = 0; i < 3; ++i) {
+            const Int_t n = tri.fN[i];
+            if (fTri[n].fMark == fStamp) continue;
+            TEdge e;
+            e.fA = tri.fV[(i + 1) % 3];
+            e.fB = tri.fV[(i + 2) % 3];
+            e.fOutside = n;
+            e.fCavity = fCavity[k];
+            if (e.fA != kGhost && e.fB != kGhost && Hides(e.fA, e.fB, p)) {
+               fTri[n].fMark = fStamp;
+               fCavity.push_back(n);
+               extended = kTRUE;
+               break;
+            }
+            fEdges.push_back(e);
+         }
+      }
+   }
+
+   // connect the boundary to p; the new triangles are a-b-p
+   std::vector<std::pair<Int_t, Int_t> > byA(fEdges.size());
+   for (size_t k = 0; k < fEdges.size(); ++k) {
+      const TEdge &e = fEdges[k];
+      const Int_t t = NewTriangle(e.fA, e.fB, p);
+      fTri[t].fN[2] = e.fOutside;
+      Int_t *n = fTri[e.fOutside].fN;
+      for (Int_t i = 0; i < 3; ++i)
+         if (n[i] == e.fCavity) n[i] = t;
+      byA[k] = std::make_pair(e.fA, t);
+      if (e.fA != kGhost && e.fB != kGhost) fLast = t;
+   }
+   std::sort(byA.begin(), byA.end());
+   for (size_t k = 0; k < byA.size(); ++k) {
+      // the edge b-p of a-b-p is shared with the new triangle starting at b
+      const Int_t t = byA[k].second;
+      const Int_t b = fTri[t].fV[1];
+      std::vector<std::pair<Int_t, Int_t> >::const_iterator it =
+         std::lower_bound(byA.begin(), byA.end(), std::make_pair(b, -1));
+      if (it == byA.end() || it->first != b) continue;
+      fTri[t].fN[0] = it->second;
+      fTri[it->second].fN[1] = t;
+   }
+
+   for (size_t k = 0; k < fCavity.size(); ++k) {
+      fTri[fCavity[k]].fAlive = kFALSE;
+      fFree.push_back(fCavity[k]);
+   }
+   return kTRUE;
+}
+
+//______________________________________________________________________________
+void TDelaunayTriangulation::Build(Double_t xmin, Double_t xmax,
+                                   Double_t ymin, Double_t ymax)
+{
+   // Triangulate the points, which are within [xmin,xmax] x [ymin,ymax].
+
+   if (fN < 3) return;
+
+   // insertion order along a Hilbert curve
+   std::vector<std::pair<ULong64_t, Int_t> > order(fN);
+   const Double_t sx = (xmax > xmin) ? 65535. / (xmax - xmin) : 0.;
+   const Double_t sy = (ymax > ymin) ? 65535. / (ymax - ymin) : 0.;
+   for (Int_t i = 1; i <= fN; ++i) {
+      const UInt_t hx = (UInt_t) TMath::Max(0., TMath::Min(65535., (fX[i] - xmin) * sx));
+      const UInt_t hy = (UInt_t) TMath::Max(0., TMath::Min(65535., (fY[i] - ymin) * sy));
+      order[i - 1] = std::make_pair(HilbertIndex(hx, hy), i);
+   }
+   std::sort(order.begin(), order.end());
+
+   // the first triangle: the first two distinct points and the first point
+   // not aligned with them
+   const Int_t a = order[0].second;
+   Int_t ib = 1;
+   while (ib < fN && fX[order[ib].second] == fX[a] && fY[order[ib].second] == fY[a]) ++ib;
+   if (ib == fN) return;
+   Int_t b = order[ib].second;
+   Int_t ic = ib + 1;
+   while (ic < fN && Orient(a, b, order[ic].second) == 0) ++ic;
+   if (ic == fN) return;
+   Int_t c = order[ic].second;
+   if (Orient(a, b, c) < 0) std::swap(b, c);
+
+   fTri.reserve(2 * fN + 8);
+   const Int_t t0 = NewTriangle(a, b, c);
+   const Int_t g0 = NewTriangle(c, b, kGhost);
+   const Int_t g1 = NewTriangle(a, c, kGhost);
+   const Int_t g2 = NewTriangle(b, a, kGhost);
+   Link(t0, g0);
+   Link(t0, g1);
+   Link(t0, g2);
+   Link(g0, g1);
+   Link(g1, g2);
+   Link(g2, g0);
+   fLast = t0;
+
+   for (Int_t k = 1; k < fN; ++k) {
+      if (k == ib || k == ic) continue;
+      Insert(order[k].second);
+   }
+}
+
+//______________________________________________________________________________
+void TDelaunayTriangulation::GetTriangles(std::vector<Int_t> &vertices,
+                                          std::vector<Int_t> &neighbours) const
+{
+   // Get the finite triangles: three vertices per triangle, counter-clockwise,
+   // and the neighbour opposite to each vertex, -1 on the convex hull.
+
+   std::vector<Int_t> index(fTri.size(), -1);
+   Int_t ntri = 0;
+   for (size_t t = 0; t < fTri.size(); ++t)
+      if (fTri[t].fAlive && !IsGhost(t)) index[t] = ntri++;
+   vertices.resize(3 * ntri);
+   neighbours.resize(3 * ntri);
+   for (size_t t = 0; t < fTri.size(); ++t) {
+      if (index[t] < 0) continue;
+      for (Int_t i = 0; i < 3; ++i) {
+         vertices[3 * index[t] + i] = fTri[t].fV[i];
+         neighbours[3 * index[t] + i] = index[fTri[t].fN[i]];
+      }
+   }
+}
+
+} // unnamed namespace
+
+
 //______________________________________________________________________________
 TGraphDelaunay::TGraphDelaunay()
             : TNamed("TGraphDelaunay","TGraphDelaunay")
@@ -56,18 +470,18 @@ TGraphDelaunay::TGraphDelaunay()
    fY            = 0;
    fZ            = 0;
    fNpoints      = 0;
-   fTriedSize    = 0;
    fZout         = 0.;
    fNdt          = 0;
-   fNhull        = 0;
-   fHullPoints   = 0;
    fXN           = 0;
    fYN           = 0;
-   fOrder        = 0;
-   fDist         = 0;
    fPTried       = 0;
    fNTried       = 0;
    fMTried       = 0;
+   fTriangles    = 0;
+   fNeighbours   = 0;
+   fNCellX       = 0;
+   fNCellY       = 0;
+   fCells        = 0;
    fInit         = kFALSE;
    fXNmin        = 0.;
    fXNmax        = 0.;
@@ -93,18 +507,18 @@ TGraphDelaunay::TGraphDelaunay(TGraph2D *g)
    fY            = fGraph2D->GetY();
    fZ            = fGraph2D->GetZ();
    fNpoints      = fGraph2D->GetN();
-   fTriedSize    = 0;
    fZout         = 0.;
    fNdt          = 0;
-   fNhull        = 0;
-   fHullPoints   = 0;
    fXN           = 0;
    fYN           = 0;
-   fOrder        = 0;
-   fDist         = 0;
    fPTried       = 0;
    fNTried       = 0;
    fMTried       = 0;
+   fTriangles    = 0;
+   fNeighbours   = 0;
+   fNCellX       = 0;
+   fNCellY       = 0;
+   fCells        = 0;
    fInit         = kFALSE;
    fXNmin        = 0.;
    fXNmax        = 0.;
@@ -124,21 +538,21 @@ TGraphDelaunay::~TGraphDelaunay()
 {
    // TGraphDelaunay destructor.
 
-   if (fPTried)     delete [] fPTried;
-   if (fNTried)     delete [] fNTried;
-   if (fMTried)     delete [] fMTried;
-   if (fHullPoints) delete [] fHullPoints;
-   if (fOrder)      delete [] fOrder;
-   if (fDist)       delete [] fDist;
-   if (fXN)         delete [] fXN;
-   if (fYN)         delete [] fYN;
+   delete [] fPTried;
+   delete [] fNTried;
+   delete [] fMTried;
+   delete [] fTriangles;
+   delete [] fNeighbours;
+   delete [] fCells;
+   delete [] fXN;
+   delete [] fYN;
 
    fPTried     = 0;
    fNTried     = 0;
    fMTried     = 0;
-   fHullPoints = 0;
-   fOrder      = 0;
-   fDist       = 0;
+   fTriangles  = 0;
+   fNeighbours = 0;
+   fCells      = 0;
    fXN         = 0;
    fYN         = 0;
 }
@@ -155,7 +569,6 @@ Double_t TGraphDelaunay::ComputeZ(Double_t x, Double_t y)
    // needed in this function.
    if (!fInit) {
       CreateTrianglesDataStructure();
-      FindHull();
       fInit = kTRUE;
    }
 
@@ -176,6 +589,37 @@ Double_t TGraphDelaunay::ComputeZ(Double_t x, Double_t y)
 }
 
 
+//______________________________________________________________________________
+void TGraphDelaunay::CreateCells()
+{
+   // Function used internally only. It creates the point location grid: for
+   // each cell, a triangle containing the centre of the cell, or the triangle
+   // closest to it if the centre is outside the hull. The searches of
+   // FindTriangle() start from these triangles.
+
+   delete [] fCells;
+   fCells  = 0;
+   fNCellX = 0;
+   fNCellY = 0;
+   if (fNdt == 0) return;
+
+   fNCellX = TMath::Max(1, (Int_t)TMath::Sqrt(0.5*fNdt));
+   fNCellY = fNCellX;
+   fCells  = new Int_t[fNCellX*fNCellY];
+   Double_t dx = (fXNmax-fXNmin)/fNCellX;
+   Double_t dy = (fYNmax-fYNmin)/fNCellY;
+   Int_t last = 0;
+   for (Int_t j=0; j<fNCellY; j++) {
+      for (Int_t k=0; k<fNCellX; k++) {
+         // go back and forth along the rows, so that each walk is short
+         Int_t i = (j%2) ? fNCellX-1-k : k;
+         FindTriangle(fXNmin+(i+0.5)*dx, fYNmin+(j+0.5)*dy, last, &last);
+         fCells[i+j*fNCellX] = last;
+      }
+   }
+}
+
+
 //______________________________________________________________________________
 void TGraphDelaunay::CreateTrianglesDataStructure()
 {
@@ -203,354 +647,122 @@ void TGraphDelaunay::CreateTrianglesDataStructure()
       fXN[n+1] = (fX[n]+fXoffset)*fXScaleFactor;
       fYN[n+1] = (fY[n]+fYoffset)*fYScaleFactor;
    }
-
-   // If needed, creates the arrays to hold the Delaunay triangles.
-   // A maximum number of 2*fNpoints is guessed. If more triangles will be
-   // find, FillIt will automatically enlarge these arrays.
-   fTriedSize = 2*fNpoints;
-   fPTried    = new Int_t[fTriedSize];
-   fNTried    = new Int_t[fTriedSize];
-   fMTried    = new Int_t[fTriedSize];
-}
-
-
-//______________________________________________________________________________
-Bool_t TGraphDelaunay::Enclose(Int_t t1, Int_t t2, Int_t t3, Int_t e) const
-{
-   // Is point e inside the triangle t1-t2-t3 ?
-
-   Double_t x[4],y[4],xp, yp;
-   x[0] = fXN[t1];
-   x[1] = fXN[t2];
-   x[2] = fXN[t3];
-   x[3] = x[0];
-   y[0] = fYN[t1];
-   y[1] = fYN[t2];
-   y[2] = fYN[t3];
-   y[3] = y[0];
-   xp   = fXN[e];
-   yp   = fYN[e];
-   return TMath::IsInside(xp, yp, 4, x, y);
-}
-
-
-//______________________________________________________________________________
-void TGraphDelaunay::FileIt(Int_t p, Int_t n, Int_t m)
-{
-   // Files the triangle defined by the 3 vertices p, n and m into the
-   // fxTried arrays. If these arrays are to small they are automatically
-   // expanded.
-
-   Bool_t swap;
-   Int_t tmp, ps = p, ns = n, ms = m;
-
-   // order the vertices before storing them
-L1:
-   swap = kFALSE;
-   if (ns > ps) { tmp = ps; ps = ns; ns = tmp; swap = kTRUE;}
-   if (ms > ns) { tmp = ns; ns = ms; ms = tmp; swap = kTRUE;}
-   if (swap) goto L1;
-
-   // expand the triangles storage if needed
-   if (fNdt> fTriedSize) {
-      Int_t newN   = 2*fTriedSize;
-      Int_t *savep = new Int_t [newN];
-      Int_t *saven = new Int_t [newN];
-      Int_t *savem = new Int_t [newN];
-      memcpy(savep,fPTried,fTriedSize*sizeof(Int_t));
-      memset(&savep[fTriedSize],0,(newN-fTriedSize)*sizeof(Int_t));
-      delete [] fPTried;
-      memcpy(saven,fNTried,fTriedSize*sizeof(Int_t));
-      memset(&saven[fTriedSize],0,(newN-fTriedSize)*sizeof(Int_t));
-      delete [] fNTried;
-      memcpy(savem,fMTried,fTriedSize*sizeof(Int_t));
-      memset(&savem[fTriedSize],0,(newN-fTriedSize)*sizeof(Int_t));
-      delete [] fMTried;
-      fPTried    = savep;
-      fNTried    = saven;
-      fMTried    = savem;
-      fTriedSize = newN;
-   }
-
-   // store a new Delaunay triangle
-   fNdt++;
-   fPTried[fNdt-1] = ps;
-   fNTried[fNdt-1] = ns;
-   fMTried[fNdt-1] = ms;
 }
 
 
 //______________________________________________________________________________
 void TGraphDelaunay::FindAllTriangles()
 {
-   // Attempt to find all the Delaunay triangles of the point set. It is not
-   // guaranteed that it will fully succeed, and no check is made that it has
-   // fully succeeded (such a check would be possible by referencing the points
-   // that make up the convex hull). The method is to check if each triangle
-   // shares all three of its sides with other triangles. If not, a point is
-   // generated just outside the triangle on the side(s) not shared, and a new
-   // triangle is found for that point. If this method is not working properly
-   // (many triangles are not being found) it's probably because the new points
-   // are too far beyond or too close to the non-shared sides. Fiddling with
-   // the size of the `alittlebit' parameter may help.
+   // Find all the Delaunay triangles of the point set.
+   //
+   // The points are inserted one at a time in the triangulation of the
+   // previous ones (Bowyer-Watson algorithm): the triangles whose
+   // circumcircle contains the new point are removed, and the new point is
+   // connected to the boundary of the hole. The outside of the convex hull
+   // is covered by triangles with a vertex at infinity, so that points
+   // outside the hull are handled in the same way. The points are inserted
+   // in the order of a Hilbert curve, so that each point is found by
+   // walking a few triangles from the previous one; the triangulation of n
+   // points takes O(n log n) time.
+   //
+   // Duplicated points are ignored. When four or more points lie on a
+   // common circle (as on regular grids), the split of their polygon into
+   // triangles is arbitrary.
 
    if (fAllTri) return; else fAllTri = kTRUE;
 
-   Double_t xcntr,ycntr,xm,ym,xx,yy;
-   Double_t sx,sy,nx,ny,mx,my,mdotn,nn,a;
-   Int_t t1,t2,pa,na,ma,pb,nb,mb,p1=0,p2=0,m,n,p3=0;
-   Bool_t s[3];
-   Double_t alittlebit = 0.0001;
-
-   // start with a point that is guaranteed to be inside the hull (the
-   // centre of the hull). The starting point is shifted "a little bit"
-   // otherwise, in case of triangles aligned on a regular grid, we may
-   // found none of them.
-   xcntr = 0;
-   ycntr = 0;
-   for (n=1; n<=fNhull; n++) {
-      xcntr = xcntr+fXN[fHullPoints[n-1]];
-      ycntr = ycntr+fYN[fHullPoints[n-1]];
-   }
-   xcntr = xcntr/fNhull+alittlebit;
-   ycntr = ycntr/fNhull+alittlebit;
-   // and calculate it's triangle
-   Interpolate(xcntr,ycntr);
-
-   // loop over all Delaunay triangles (including those constantly being
-   // produced within the loop) and check to see if their 3 sides also
-   // correspond to the sides of other Delaunay triangles, i.e. that they
-   // have all their neighbours.
-   t1 = 1;
-   while (t1 <= fNdt) {
-      // get the three points that make up this triangle
-      pa = fPTried[t1-1];
-      na = fNTried[t1-1];
-      ma = fMTried[t1-1];
-
-      // produce three integers which will represent the three sides
-      s[0]  = kFALSE;
-      s[1]  = kFALSE;
-      s[2]  = kFALSE;
-      // loop over all other Delaunay triangles
-      for (t2=1; t2<=fNdt; t2++) {
-         if (t2 != t1) {
-            // get the points that make up this triangle
-            pb = fPTried[t2-1];
-            nb = fNTried[t2-1];
-            mb = fMTried[t2-1];
-            // do triangles t1 and t2 share a side?
-            if ((pa==pb && na==nb) || (pa==pb && na==mb) || (pa==nb && na==mb)) {
-               // they share side 1
-               s[0] = kTRUE;
-            } else if ((pa==pb && ma==nb) || (pa==pb && ma==mb) || (pa==nb && ma==mb)) {
-               // they share side 2
-               s[1] = kTRUE;
-            } else if ((na==pb && ma==nb) || (na==pb && ma==mb) || (na==nb && ma==mb)) {
-               // they share side 3
-               s[2] = kTRUE;
-            }
-         }
-         // if t1 shares all its sides with other Delaunay triangles then
-         // forget about it
-         if (s[0] && s[1] && s[2]) continue;
-      }
-      // Looks like t1 is missing a neighbour on at least one side.
-      // For each side, take a point a little bit beyond it and calculate
-      // the Delaunay triangle for that point, this should be the triangle
-      // which shares the side.
-      for (m=1; m<=3; m++) {
-         if (!s[m-1]) {
-            // get the two points that make up this side
-            if (m == 1) {
-               p1 = pa;
-               p2 = na;
-               p3 = ma;
-            } else if (m == 2) {
-               p1 = pa;
-               p2 = ma;
-               p3 = na;
-            } else if (m == 3) {
-               p1 = na;
-               p2 = ma;
-               p3 = pa;
-            }
-            // get the coordinates of the centre of this side
-            xm = (fXN[p1]+fXN[p2])/2.;
-            ym = (fYN[p1]+fYN[p2])/2.;
-            // we want to add a little to these coordinates to get a point just
-            // outside the triangle; (sx,sy) will be the vector that represents
-            // the side
-            sx = fXN[p1]-fXN[p2];
-            sy = fYN[p1]-fYN[p2];
-            // (nx,ny) will be the normal to the side, but don't know if it's
-            // pointing in or out yet
-            nx    = sy;
-            ny    = -sx;
-            nn    = TMath::Sqrt(nx*nx+ny*ny);
-            nx    = nx/nn;
-            ny    = ny/nn;
-            mx    = fXN[p3]-xm;
-            my    = fYN[p3]-ym;
-            mdotn = mx*nx+my*ny;
-            if (mdotn > 0) {
-               // (nx,ny) is pointing in, we want it pointing out
-               nx = -nx;
-               ny = -ny;
-            }
-            // increase/decrease xm and ym a little to produce a point
-            // just outside the triangle (ensuring that the amount added will
-            // be large enough such that it won't be lost in rounding errors)
-            a  = TMath::Abs(TMath::Max(alittlebit*xm,alittlebit*ym));
-            xx = xm+nx*a;
-            yy = ym+ny*a;
-            // try and find a new Delaunay triangle for this point
-            Interpolate(xx,yy);
-
-            // this side of t1 should now, hopefully, if it's not part of the
-            // hull, be shared with a new Delaunay triangle just calculated by Interpolate
-         }
-      }
-      t1++;
+   if (!fInit) {
+      CreateTrianglesDataStructure();
+      fInit = kTRUE;
    }
-}
 
+   delete [] fPTried;
+   delete [] fNTried;
+   delete [] fMTried;
+   delete [] fTriangles;
+   delete [] fNeighbours;
+   fPTried     = 0;
+   fNTried     = 0;
+   fMTried     = 0;
+   fTriangles  = 0;
+   fNeighbours = 0;
+   fNdt        = 0;
+
+   std::vector<Int_t> vertices, neighbours;
+   {
+      TDelaunayTriangulation dt(fNpoints, fXN, fYN);
+      dt.Build(fXNmin, fXNmax, fYNmin, fYNmax);
+      dt.GetTriangles(vertices, neighbours);
+   }
 
-//______________________________________________________________________________
-void TGraphDelaunay::FindHull()
-{
-   // Finds those points which make up the convex hull of the set. If the xy
-   // plane were a sheet of wood, and the points were nails hammered into it
-   // at the respective coordinates, then if an elastic band were stretched
-   // over all the nails it would form the shape of the convex hull. Those
-   // nails in contact with it are the points that make up the hull.
-
-   Int_t n,nhull_tmp;
-   Bool_t in;
-
-   if (!fHullPoints) fHullPoints = new Int_t[fNpoints];
-
-   nhull_tmp = 0;
-   for(n=1; n<=fNpoints; n++) {
-      // if the point is not inside the hull of the set of all points
-      // bar it, then it is part of the hull of the set of all points
-      // including it
-      in = InHull(n,n);
-      if (!in) {
-         // cannot increment fNhull directly - InHull needs to know that
-         // the hull has not yet been completely found
-         nhull_tmp++;
-         fHullPoints[nhull_tmp-1] = n;
+   fNdt        = vertices.size()/3;
+   fTriangles  = new Int_t[3*fNdt+1];
+   fNeighbours = new Int_t[3*fNdt+1];
+   fPTried     = new Int_t[fNdt+1];
+   fNTried     = new Int_t[fNdt+1];
+   fMTried     = new Int_t[fNdt+1];
+   for (Int_t t=0; t<fNdt; t++) {
+      Int_t v[3];
+      for (Int_t i=0; i<3; i++) {
+         v[i] = fTriangles[3*t+i] = vertices[3*t+i];
+         fNeighbours[3*t+i] = neighbours[3*t+i];
       }
+      // the vertices are stored in decreasing order in the fxTried arrays
+      std::sort(v, v+3);
+      fPTried[t] = v[2];
+      fNTried[t] = v[1];
+      fMTried[t] = v[0];
    }
-   fNhull = nhull_tmp;
+
+   CreateCells();
 }
 
 
 //______________________________________________________________________________
-Bool_t TGraphDelaunay::InHull(Int_t e, Int_t x) const
+Int_t TGraphDelaunay::FindTriangle(Double_t x, Double_t y, Int_t start, Int_t *last) const
 {
-   // Is point e inside the hull defined by all points apart from x ?
-
-   Int_t n1,n2,n,m,ntry;
-   Double_t lastdphi,dd1,dd2,dx1,dx2,dx3,dy1,dy2,dy3;
-   Double_t u,v,vNv1,vNv2,phi1,phi2,dphi,xx,yy;
-
-   Bool_t deTinhull = kFALSE;
-
-   xx = fXN[e];
-   yy = fYN[e];
-
-   if (fNhull > 0) {
-      //  The hull has been found - no need to use any points other than
-      //  those that make up the hull
-      ntry = fNhull;
-   } else {
-      //  The hull has not yet been found, will have to try every point
-      ntry = fNpoints;
-   }
-
-   //  n1 and n2 will represent the two points most separated by angle
-   //  from point e. Initially the angle between them will be <180 degs.
-   //  But subsequent points will increase the n1-e-n2 angle. If it
-   //  increases above 180 degrees then point e must be surrounded by
-   //  points - it is not part of the hull.
-   n1 = 1;
-   n2 = 2;
-   if (n1 == x) {
-      n1 = n2;
-      n2++;
-   } else if (n2 == x) {
-      n2++;
+   // Return the Delaunay triangle containing the normalized point (x,y), -1
+   // if it is outside the convex hull. The triangle is searched by walking
+   // from the triangle start towards (x,y), crossing the edges that separate
+   // the current triangle from (x,y). If last is not null, it is set to the
+   // last triangle visited.
+
+   Int_t t    = start;
+   Int_t from = -1;
+   for (Int_t step=0; step<=fNdt; step++) {
+      if (last) *last = t;
+      const Int_t *v = fTriangles+3*t;
+      Int_t next = -2;
+      for (Int_t k=0; k<3; k++) {
+         // vary the first edge tested, against cycles in degenerate cases
+         Int_t i = (k+step)%3;
+         Int_t n = fNeighbours[3*t+i];
+         if (n >= 0 && n == from) continue;
+         Int_t a = v[(i+1)%3];
+         Int_t b = v[(i+2)%3];
+         if (Orientation(fXN[a], fYN[a], fXN[b], fYN[b], x, y) < 0) {
+            next = n;
+            break;
+         }
+      }
+      if (next == -2) return t;
+      // (x,y) is beyond a hull edge
+      if (next == -1) return -1;
+      from = t;
+      t    = next;
    }
 
-   //  Get the angle n1-e-n2 and set it to lastdphi
-   dx1  = xx-fXN[n1];
-   dy1  = yy-fYN[n1];
-   dx2  = xx-fXN[n2];
-   dy2  = yy-fYN[n2];
-   phi1 = TMath::ATan2(dy1,dx1);
-   phi2 = TMath::ATan2(dy2,dx2);
-   dphi = (phi1-phi2)-((Int_t)((phi1-phi2)/TMath::TwoPi())*TMath::TwoPi());
-   if (dphi < 0) dphi = dphi+TMath::TwoPi();
-   lastdphi = dphi;
-   for (n=1; n<=ntry; n++) {
-      if (fNhull > 0) {
-         // Try hull point n
-         m = fHullPoints[n-1];
-      } else {
-         m = n;
-      }
-      if ((m!=n1) && (m!=n2) && (m!=x)) {
-         // Can the vector e->m be represented as a sum with positive
-         // coefficients of vectors e->n1 and e->n2?
-         dx1 = xx-fXN[n1];
-         dy1 = yy-fYN[n1];
-         dx2 = xx-fXN[n2];
-         dy2 = yy-fYN[n2];
-         dx3 = xx-fXN[m];
-         dy3 = yy-fYN[m];
-
-         dd1 = (dx2*dy1-dx1*dy2);
-         dd2 = (dx1*dy2-dx2*dy1);
-
-         if (dd1*dd2!=0) {
-            u = (dx2*dy3-dx3*dy2)/dd1;
-            v = (dx1*dy3-dx3*dy1)/dd2;
-            if ((u<0) || (v<0)) {
-               // No, it cannot - point m does not lie inbetween n1 and n2 as
-               // viewed from e. Replace either n1 or n2 to increase the
-               // n1-e-n2 angle. The one to replace is the one which makes the
-               // smallest angle with e->m
-               vNv1 = (dx1*dx3+dy1*dy3)/TMath::Sqrt(dx1*dx1+dy1*dy1);
-               vNv2 = (dx2*dx3+dy2*dy3)/TMath::Sqrt(dx2*dx2+dy2*dy2);
-               if (vNv1 > vNv2) {
-                  n1   = m;
-                  phi1 = TMath::ATan2(dy3,dx3);
-                  phi2 = TMath::ATan2(dy2,dx2);
-               } else {
-                  n2   = m;
-                  phi1 = TMath::ATan2(dy1,dx1);
-                  phi2 = TMath::ATan2(dy3,dx3);
-               }
-               dphi = (phi1-phi2)-((Int_t)((phi1-phi2)/TMath::TwoPi())*TMath::TwoPi());
-               if (dphi < 0) dphi = dphi+TMath::TwoPi();
-               if (((dphi-TMath::Pi())*(lastdphi-TMath::Pi())) < 0) {
-                  // The addition of point m means the angle n1-e-n2 has risen
-                  // above 180 degs, the point is in the hull.
-                  goto L10;
-               }
-               lastdphi = dphi;
-            }
-         }
+   // the walk did not converge: check all triangles
+   for (t=0; t<fNdt; t++) {
+      const Int_t *v = fTriangles+3*t;
+      if (Orientation(fXN[v[0]], fYN[v[0]], fXN[v[1]], fYN[v[1]], x, y) >= 0 &&
+          Orientation(fXN[v[1]], fYN[v[1]], fXN[v[2]], fYN[v[2]], x, y) >= 0 &&
+          Orientation(fXN[v[2]], fYN[v[2]], fXN[v[0]], fYN[v[0]], x, y) >= 0) {
+         if (last) *last = t;
+         return t;
       }
    }
-   // Point e is not surrounded by points - it is not in the hull.
-   goto L999;
-L10:
-   deTinhull = kTRUE;
-L999:
-   return deTinhull;
+   return -1;
 }
 
 
@@ -598,331 +810,34 @@ Double_t TGraphDelaunay::Interpolate(Double_t xx, Double_t yy)
    // Finds the Delaunay triangle that the point (xi,yi) sits in (if any) and
    // calculate a z-value for it by linearly interpolating the z-values that
    // make up that triangle.
-
-   Double_t thevalue;
-
-   Int_t it, ntris_tried, p, n, m;
-   Int_t i,j,k,l,z,f,d,o1,o2,a,b,t1,t2,t3;
-   Int_t ndegen=0,degen=0,fdegen=0,o1degen=0,o2degen=0;
-   Double_t vxN,vyN;
-   Double_t d1,d2,d3,c1,c2,dko1,dko2,dfo1;
-   Double_t dfo2,sin_sum,cfo1k,co2o1k,co2o1f;
-
-   Bool_t shouldbein;
-   Double_t dx1,dx2,dx3,dy1,dy2,dy3,u,v,dxz[3],dyz[3];
+   // The triangle is found by starting from the triangle stored for the
+   // cell of the point location grid containing the point, and walking
+   // towards the point.
 
    // initialise the Delaunay algorithm if needed
    if (!fInit) {
       CreateTrianglesDataStructure();
-      FindHull();
       fInit = kTRUE;
    }
+   if (!fAllTri) FindAllTriangles();
 
-   // create vectors needed for sorting
-   if (!fOrder) {
-      fOrder = new Int_t[fNpoints];
-      fDist  = new Double_t[fNpoints];
-   }
+   // no point in proceeding if xx or yy are silly
+   if ((xx>fXNmax) || (xx<fXNmin) || (yy>fYNmax) || (yy<fYNmin)) return fZout;
+   if (fNdt == 0) return fZout;
 
    // the input point will be point zero.
    fXN[0] = xx;
    fYN[0] = yy;
 
-   // set the output value to the default value for now
-   thevalue = fZout;
-
-   // some counting
-   ntris_tried = 0;
-
-   // no point in proceeding if xx or yy are silly
-   if ((xx>fXNmax) || (xx<fXNmin) || (yy>fYNmax) || (yy<fYNmin)) return thevalue;
-
-   // check existing Delaunay triangles for a good one
-   for (it=1; it<=fNdt; it++) {
-      p = fPTried[it-1];
-      n = fNTried[it-1];
-      m = fMTried[it-1];
-      // p, n and m form a previously found Delaunay triangle, does it
-      // enclose the point?
-      if (Enclose(p,n,m,0)) {
-         // yes, we have the triangle
-         thevalue = InterpolateOnPlane(p,n,m,0);
-         return thevalue;
-      }
-   }
-
-   // is this point inside the convex hull?
-   shouldbein = InHull(0,-1);
-   if (!shouldbein) return thevalue;
+   Int_t i = (Int_t)((xx-fXNmin)/(fXNmax-fXNmin)*fNCellX);
+   Int_t j = (Int_t)((yy-fYNmin)/(fYNmax-fYNmin)*fNCellY);
+   i = TMath::Max(0, TMath::Min(fNCellX-1, i));
+   j = TMath::Max(0, TMath::Min(fNCellY-1, j));
 
-   // it must be in a Delaunay triangle - find it...
+   Int_t t = FindTriangle(xx, yy, fCells[i+j*fNCellX]);
+   if (t < 0) return fZout;
 
-   // order mass points by distance in mass plane from desired point
-   for (it=1; it<=fNpoints; it++) {
-      vxN = fXN[it];
-      vyN = fYN[it];
-      fDist[it-1] = TMath::Sqrt((xx-vxN)*(xx-vxN)+(yy-vyN)*(yy-vyN));
-   }
-
-   // sort array 'fDist' to find closest points
-   TMath::Sort(fNpoints, fDist, fOrder, kFALSE);
-   for (it=0; it<fNpoints; it++) fOrder[it]++;
-
-   // loop over triplets of close points to try to find a triangle that
-   // encloses the point.
-   for (k=3; k<=fNpoints; k++) {
-      m = fOrder[k-1];
-      for (j=2; j<=k-1; j++) {
-         n = fOrder[j-1];
-         for (i=1; i<=j-1; i++) {
-            p = fOrder[i-1];
-            if (ntris_tried > fMaxIter) {
-               // perhaps this point isn't in the hull after all
-///            Warning("Interpolate",
-///                    "Abandoning the effort to find a Delaunay triangle (and thus interpolated z-value) for point %g %g"
-///                    ,xx,yy);
-               return thevalue;
-            }
-            ntris_tried++;
-            // check the points aren't colinear
-            d1 = TMath::Sqrt((fXN[p]-fXN[n])*(fXN[p]-fXN[n])+(fYN[p]-fYN[n])*(fYN[p]-fYN[n]));
-            d2 = TMath::Sqrt((fXN[p]-fXN[m])*(fXN[p]-fXN[m])+(fYN[p]-fYN[m])*(fYN[p]-fYN[m]));
-            d3 = TMath::Sqrt((fXN[n]-fXN[m])*(fXN[n]-fXN[m])+(fYN[n]-fYN[m])*(fYN[n]-fYN[m]));
-            if ((d1+d2<=d3) || (d1+d3<=d2) || (d2+d3<=d1)) goto L90;
-
-            // does the triangle enclose the point?
-            if (!Enclose(p,n,m,0)) goto L90;
-
-            // is it a Delaunay triangle? (ie. are there any other points
-            // inside the circle that is defined by its vertices?)
-
-            // test the triangle for Delaunay'ness
-
-            // loop over all other points testing each to see if it's
-            // inside the triangle's circle
-            ndegen = 0;
-            for ( z=1; z<=fNpoints; z++) {
-               if ((z==p) || (z==n) || (z==m)) goto L50;
-               // An easy first check is to see if point z is inside the triangle
-               // (if it's in the triangle it's also in the circle)
-
-               // point z cannot be inside the triangle if it's further from (xx,yy)
-               // than the furthest pointing making up the triangle - test this
-               for (l=1; l<=fNpoints; l++) {
-                  if (fOrder[l-1] == z) {
-                     if ((l<i) || (l<j) || (l<k)) {
-                        // point z is nearer to (xx,yy) than m, n or p - it could be in the
-                        // triangle so call enclose to find out
-
-                        // if it is inside the triangle this can't be a Delaunay triangle
-                        if (Enclose(p,n,m,z)) goto L90;
-                     } else {
-                        // there's no way it could be in the triangle so there's no point
-                        // calling enclose
-                        goto L1;
-                     }
-                  }
-               }
-               // is point z colinear with any pair of the triangle points?
-L1:
-               if (((fXN[p]-fXN[z])*(fYN[p]-fYN[n])) == ((fYN[p]-fYN[z])*(fXN[p]-fXN[n]))) {
-                  // z is colinear with p and n
-                  a = p;
-                  b = n;
-               } else if (((fXN[p]-fXN[z])*(fYN[p]-fYN[m])) == ((fYN[p]-fYN[z])*(fXN[p]-fXN[m]))) {
-                  // z is colinear with p and m
-                  a = p;
-                  b = m;
-               } else if (((fXN[n]-fXN[z])*(fYN[n]-fYN[m])) == ((fYN[n]-fYN[z])*(fXN[n]-fXN[m]))) {
-                  // z is colinear with n and m
-                  a = n;
-                  b = m;
-               } else {
-                  a = 0;
-                  b = 0;
-               }
-               if (a != 0) {
-                  // point z is colinear with 2 of the triangle points, if it lies
-                  // between them it's in the circle otherwise it's outside
-                  if (fXN[a] != fXN[b]) {
-                     if (((fXN[z]-fXN[a])*(fXN[z]-fXN[b])) < 0) {
-                        goto L90;
-                     } else if (((fXN[z]-fXN[a])*(fXN[z]-fXN[b])) == 0) {
-                        // At least two points are sitting on top of each other, we will
-                        // treat these as one and not consider this a 'multiple points lying
-                        // on a common circle' situation. It is a sign something could be
-                        // wrong though, especially if the two coincident points have
-                        // different fZ's. If they don't then this is harmless.
-                        Warning("Interpolate", "Two of these three points are coincident %d %d %d",a,b,z);
-                     }
-                  } else {
-                     if (((fYN[z]-fYN[a])*(fYN[z]-fYN[b])) < 0) {
-                        goto L90;
-                     } else if (((fYN[z]-fYN[a])*(fYN[z]-fYN[b])) == 0) {
-                        // At least two points are sitting on top of each other - see above.
-                        Warning("Interpolate", "Two of these three points are coincident %d %d %d",a,b,z);
-                     }
-                  }
-                  // point is outside the circle, move to next point
-                  goto L50;
-               }
-
-               // if point z were to look at the triangle, which point would it see
-               // lying between the other two? (we're going to form a quadrilateral
-               // from the points, and then demand certain properties of that
-               // quadrilateral)
-               dxz[0] = fXN[p]-fXN[z];
-               dyz[0] = fYN[p]-fYN[z];
-               dxz[1] = fXN[n]-fXN[z];
-               dyz[1] = fYN[n]-fYN[z];
-               dxz[2] = fXN[m]-fXN[z];
-               dyz[2] = fYN[m]-fYN[z];
-               for(l=1; l<=3; l++) {
-                  dx1 = dxz[l-1];
-                  dx2 = dxz[l%3];
-                  dx3 = dxz[(l+1)%3];
-                  dy1 = dyz[l-1];
-                  dy2 = dyz[l%3];
-                  dy3 = dyz[(l+1)%3];
-
-                  u = (dy3*dx2-dx3*dy2)/(dy1*dx2-dx1*dy2);
-                  v = (dy3*dx1-dx3*dy1)/(dy2*dx1-dx2*dy1);
-
-                  if ((u>=0) && (v>=0)) {
-                     // vector (dx3,dy3) is expressible as a sum of the other two vectors
-                     // with positive coefficents -> i.e. it lies between the other two vectors
-                     if (l == 1) {
-                        f  = m;
-                        o1 = p;
-                        o2 = n;
-                     } else if (l == 2) {
-                        f  = p;
-                        o1 = n;
-                        o2 = m;
-                     } else {
-                        f  = n;
-                        o1 = m;
-                        o2 = p;
-                     }
-                     goto L2;
-                  }
-               }
-///            Error("Interpolate", "Should not get to here");
-               // may as well soldier on
-               f  = m;
-               o1 = p;
-               o2 = n;
-L2:
-               // this is not a valid quadrilateral if the diagonals don't cross,
-               // check that points f and z lie on opposite side of the line o1-o2,
-               // this is true if the angle f-o1-z is greater than o2-o1-z and o2-o1-f
-               cfo1k  = ((fXN[f]-fXN[o1])*(fXN[z]-fXN[o1])+(fYN[f]-fYN[o1])*(fYN[z]-fYN[o1]))/
-                        TMath::Sqrt(((fXN[f]-fXN[o1])*(fXN[f]-fXN[o1])+(fYN[f]-fYN[o1])*(fYN[f]-fYN[o1]))*
-                        ((fXN[z]-fXN[o1])*(fXN[z]-fXN[o1])+(fYN[z]-fYN[o1])*(fYN[z]-fYN[o1])));
-               co2o1k = ((fXN[o2]-fXN[o1])*(fXN[z]-fXN[o1])+(fYN[o2]-fYN[o1])*(fYN[z]-fYN[o1]))/
-                        TMath::Sqrt(((fXN[o2]-fXN[o1])*(fXN[o2]-fXN[o1])+(fYN[o2]-fYN[o1])*(fYN[o2]-fYN[o1]))*
-                        ((fXN[z]-fXN[o1])*(fXN[z]-fXN[o1])  + (fYN[z]-fYN[o1])*(fYN[z]-fYN[o1])));
-               co2o1f = ((fXN[o2]-fXN[o1])*(fXN[f]-fXN[o1])+(fYN[o2]-fYN[o1])*(fYN[f]-fYN[o1]))/
-                        TMath::Sqrt(((fXN[o2]-fXN[o1])*(fXN[o2]-fXN[o1])+(fYN[o2]-fYN[o1])*(fYN[o2]-fYN[o1]))*
-                        ((fXN[f]-fXN[o1])*(fXN[f]-fXN[o1]) + (fYN[f]-fYN[o1])*(fYN[f]-fYN[o1]) ));
-               if ((cfo1k>co2o1k) || (cfo1k>co2o1f)) {
-                  // not a valid quadrilateral - point z is definitely outside the circle
-                  goto L50;
-               }
-               // calculate the 2 internal angles of the quadrangle formed by joining
-               // points z and f to points o1 and o2, at z and f. If they sum to less
-               // than 180 degrees then z lies outside the circle
-               dko1    = TMath::Sqrt((fXN[z]-fXN[o1])*(fXN[z]-fXN[o1])+(fYN[z]-fYN[o1])*(fYN[z]-fYN[o1]));
-               dko2    = TMath::Sqrt((fXN[z]-fXN[o2])*(fXN[z]-fXN[o2])+(fYN[z]-fYN[o2])*(fYN[z]-fYN[o2]));
-               dfo1    = TMath::Sqrt((fXN[f]-fXN[o1])*(fXN[f]-fXN[o1])+(fYN[f]-fYN[o1])*(fYN[f]-fYN[o1]));
-               dfo2    = TMath::Sqrt((fXN[f]-fXN[o2])*(fXN[f]-fXN[o2])+(fYN[f]-fYN[o2])*(fYN[f]-fYN[o2]));
-               c1      = ((fXN[z]-fXN[o1])*(fXN[z]-fXN[o2])+(fYN[z]-fYN[o1])*(fYN[z]-fYN[o2]))/dko1/dko2;
-               c2      = ((fXN[f]-fXN[o1])*(fXN[f]-fXN[o2])+(fYN[f]-fYN[o1])*(fYN[f]-fYN[o2]))/dfo1/dfo2;
-               sin_sum = c1*TMath::Sqrt(1-c2*c2)+c2*TMath::Sqrt(1-c1*c1);
-
-               // sin_sum doesn't always come out as zero when it should do.
-               if (sin_sum < -1.E-6) {
-                  // z is inside the circle, this is not a Delaunay triangle
-                  goto L90;
-               } else if (TMath::Abs(sin_sum) <= 1.E-6) {
-                  // point z lies on the circumference of the circle (within rounding errors)
-                  // defined by the triangle, so there is potential for degeneracy in the
-                  // triangle set (Delaunay triangulation does not give a unique way to split
-                  // a polygon whose points lie on a circle into constituent triangles). Make
-                  // a note of the additional point number.
-                  ndegen++;
-                  degen   = z;
-                  fdegen  = f;
-                  o1degen = o1;
-                  o2degen = o2;
-               }
-L50:
-            continue;
-            }
-            // This is a good triangle
-            if (ndegen > 0) {
-               // but is degenerate with at least one other,
-               // haven't figured out what to do if more than 4 points are involved
-///            if (ndegen > 1) {
-///               Error("Interpolate",
-///                     "More than 4 points lying on a circle. No decision making process formulated for triangulating this region in a non-arbitrary way %d %d %d %d",
-///                     p,n,m,degen);
-///               return thevalue;
-///            }
-
-               // we have a quadrilateral which can be split down either diagonal
-               // (d<->f or o1<->o2) to form valid Delaunay triangles. Choose diagonal
-               // with highest average z-value. Whichever we choose we will have
-               // verified two triangles as good and two as bad, only note the good ones
-               d  = degen;
-               f  = fdegen;
-               o1 = o1degen;
-               o2 = o2degen;
-               if ((fZ[o1-1]+fZ[o2-1]) > (fZ[d-1]+fZ[f-1])) {
-                  // best diagonalisation of quadrilateral is current one, we have
-                  // the triangle
-                  t1 = p;
-                  t2 = n;
-                  t3 = m;
-                  // file the good triangles
-                  FileIt(p, n, m);
-                  FileIt(d, o1, o2);
-               } else {
-                  // use other diagonal to split quadrilateral, use triangle formed by
-                  // point f, the degnerate point d and whichever of o1 and o2 create
-                  // an enclosing triangle
-                  t1 = f;
-                  t2 = d;
-                  if (Enclose(f,d,o1,0)) {
-                     t3 = o1;
-                  } else {
-                     t3 = o2;
-                  }
-                  // file the good triangles
-                  FileIt(f, d, o1);
-                  FileIt(f, d, o2);
-               }
-            } else {
-               // this is a Delaunay triangle, file it
-               FileIt(p, n, m);
-               t1 = p;
-               t2 = n;
-               t3 = m;
-            }
-            // do the interpolation
-            thevalue = InterpolateOnPlane(t1,t2,t3,0);
-            return thevalue;
-L90:
-            continue;
-         }
-      }
-   }
-   if (shouldbein) {
-      Error("Interpolate",
-            "Point outside hull when expected inside: this point could be dodgy %g %g %d",
-             xx, yy, ntris_tried);
-   }
-   return thevalue;
+   return InterpolateOnPlane(fTriangles[3*t], fTriangles[3*t+1], fTriangles[3*t+2], 0);
 }
 
 
@@ -930,7 +845,8 @@ L90:
 void TGraphDelaunay::SetMaxIter(Int_t n)
 {
    // Defines the number of triangles tested for a Delaunay triangle
-   // (number of iterations) before abandoning the search
+   // (number of iterations) before abandoning the search. Not used anymore:
+   // all the triangles are always found.
 
    fAllTri  = kFALSE;
    fMaxIter = n;
@@ -1159,6 +1159,24 @@ void TH1::AddBinContent(Int_t, Double_t)
    AbstractMethod("AddBinContent");
 }
 
+//______________________________________________________________________________
+void TH1::AddBinContentN(Int_t n, const Int_t *bins, const Double_t *w)
+{
+//   -*-*-*-*-*-*-*-*Increment the content of n bins*-*-*-*-*-*-*-*-*-*-*-*-*
+//                   ===============================
+//
+//    The content of bins[i] is incremented by w[i], or by 1 if w is null.
+//    The same bin may appear several times. The histogram classes with a
+//    floating point content redefine this function with a loop free of
+//    virtual calls.
+
+   if (w) {
+      for (Int_t i=0;i<n;i++) AddBinContent(bins[i], w[i]);
+   } else {
+      for (Int_t i=0;i<n;i++) AddBinContent(bins[i]);
+   }
+}
+
 //______________________________________________________________________________
 void TH1::AddDirectory(Bool_t add)
 {
@@ -3070,6 +3088,11 @@ void TH1::FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride
 //    by w^2 in the bin corresponding to x. 
 //    if w is NULL each entry is assumed a weight=1
 //
+//    Unless the axis can be extended, the entries are processed by batches:
+//    the bins of a batch are computed at once with TAxis::FindFixBins, then
+//    the contents and the statistics are accumulated in one pass.
+//    The result is identical to calling Fill for each entry.
+//
 //   -*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
 
    Int_t bin,i;
@@ -3085,6 +3108,38 @@ void TH1::FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride
    fEntries += ntimes;
    Double_t ww = 1;
    Int_t nbins   = fXaxis.GetNbins();
+
+   if (!fBuffer && !fXaxis.CanExtend()) {
+      Int_t bins[kNFillBatch];
+      Double_t weights[kNFillBatch];
+      Double_t tsumw = fTsumw, tsumw2 = fTsumw2, tsumwx = fTsumwx, tsumwx2 = fTsumwx2;
+      for (Int_t first=0;first<ntimes;first+=kNFillBatch) {
+         Int_t n = TMath::Min(Int_t(kNFillBatch), ntimes-first);
+         const Double_t *xx = x + first*stride;
+         const Double_t *wn = 0;
+         fXaxis.FindFixBins(n, xx, bins, stride);
+         if (w) {
+            for (i=0;i<n;i++) weights[i] = w[(first+i)*stride];
+            wn = weights;
+         }
+         FillNContents(n, bins, wn);
+         for (i=0;i<n;i++) {
+            if (!fgStatOverflows && (bins[i] == 0 || bins[i] > nbins)) continue;
+            Double_t z = wn ? wn[i] : 1.;
+            Double_t xi = xx[i*stride];
+            tsumw   += z;
+            tsumw2  += z*z;
+            tsumwx  += z*xi;
+            tsumwx2 += z*xi*xi;
+         }
+      }
+      fTsumw   = tsumw;
+      fTsumw2  = tsumw2;
+      fTsumwx  = tsumwx;
+      fTsumwx2 = tsumwx2;
+      return;
+   }
+
    ntimes *= stride;
    for (i=0;i<ntimes;i+=stride) {
       bin =fXaxis.FindBin(x[i]);
@@ -3104,6 +3159,30 @@ void TH1::FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride
    }
 }
 
+//______________________________________________________________________________
+void TH1::FillNContents(Int_t n, const Int_t *bins, const Double_t *w)
+{
+// Add the n weights w (1 if w is null) to the content and to the sum of
+// squares of weights of the given bins, used by FillN.
+// As in Fill, the storage of the sum of squares of weights is triggered
+// by the first weight not equal to 1.
+
+   if (w && !fSumw2.fN) {
+      for (Int_t i=0;i<n;i++) {
+         if (w[i] != 1.0) { Sumw2(); break; }
+      }
+   }
+   if (fSumw2.fN) {
+      Double_t *sumw2 = fSumw2.fArray;
+      if (w) {
+         for (Int_t i=0;i<n;i++) sumw2[bins[i]] += w[i]*w[i];
+      } else {
+         for (Int_t i=0;i<n;i++) sumw2[bins[i]] += 1.;
+      }
+   }
+   AddBinContentN(n, bins, w);
+}
+
 //______________________________________________________________________________
 void TH1::FillRandom(const char *fname, Int_t ntimes)
 {
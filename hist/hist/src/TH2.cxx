@@ -497,10 +497,58 @@ void TH2::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double
    //*-*
    //*-* NB: function only valid for a TH2x object
    //*-*
+   //*-* Unless an axis can be extended, the entries are processed by batches
+   //*-* as in TH1::FillN. The result is identical to calling Fill for each entry.
+   //*-*
    //*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
    Int_t binx, biny, bin, i;
    fEntries += ntimes;
    Double_t ww = 1;
+
+   if (!fBuffer && !fXaxis.CanExtend() && !fYaxis.CanExtend()) {
+      Int_t nx = fXaxis.GetNbins();
+      Int_t ny = fYaxis.GetNbins();
+      Int_t binsx[kNFillBatch], binsy[kNFillBatch], bins[kNFillBatch];
+      Double_t weights[kNFillBatch];
+      Double_t tsumw = fTsumw, tsumw2 = fTsumw2, tsumwx = fTsumwx, tsumwx2 = fTsumwx2;
+      Double_t tsumwy = fTsumwy, tsumwy2 = fTsumwy2, tsumwxy = fTsumwxy;
+      for (Int_t first=0;first<ntimes;first+=kNFillBatch) {
+         Int_t n = TMath::Min(Int_t(kNFillBatch), ntimes-first);
+         const Double_t *xx = x + first*stride;
+         const Double_t *yy = y + first*stride;
+         const Double_t *wn = 0;
+         fXaxis.FindFixBins(n, xx, binsx, stride);
+         fYaxis.FindFixBins(n, yy, binsy, stride);
+         for (i=0;i<n;i++) bins[i] = binsy[i]*(nx+2) + binsx[i];
+         if (w) {
+            for (i=0;i<n;i++) weights[i] = w[(first+i)*stride];
+            wn = weights;
+         }
+         FillNContents(n, bins, wn);
+         for (i=0;i<n;i++) {
+            if (!fgStatOverflows && (binsx[i] == 0 || binsx[i] > nx || binsy[i] == 0 || binsy[i] > ny)) continue;
+            Double_t z = wn ? wn[i] : 1.;
+            Double_t xi = xx[i*stride];
+            Double_t yi = yy[i*stride];
+            tsumw   += z;
+            tsumw2  += z*z;
+            tsumwx  += z*xi;
+            tsumwx2 += z*xi*xi;
+            tsumwy  += z*yi;
+            tsumwy2 += z*yi*yi;
+            tsumwxy += z*xi*yi;
+         }
+      }
+      fTsumw   = tsumw;
+      fTsumw2  = tsumw2;
+      fTsumwx  = tsumwx;
+      fTsumwx2 = tsumwx2;
+      fTsumwy  = tsumwy;
+      fTsumwy2 = tsumwy2;
+      fTsumwxy = tsumwxy;
+      return;
+   }
+
    ntimes *= stride;
    for (i=0;i<ntimes;i+=stride) {
       binx = fXaxis.FindBin(x[i]);
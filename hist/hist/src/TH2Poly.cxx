@@ -25,9 +25,233 @@
 #include <stdio.h>
 #include <ctype.h>
 #include "Riostream.h"
+#include <vector>
 
 ClassImp(TH2Poly)
 
+//______________________________________________________________________________
+//
+// TH2PolyIndex is the spatial index used by TH2Poly::FindBin() and
+// TH2Poly::Fill(). It is a quadtree over the bounding boxes of the bins: each
+// leaf holds the bins whose bounding box intersects it, in the order in which
+// they were added to the histogram. The polygon edges of all bins are copied
+// into contiguous arrays, so that the point-in-polygon test of a bin is a
+// tight loop without branches, giving the same result as TMath::IsInside().
+// The index is built on demand and invalidated when bins are added.
+//______________________________________________________________________________
+
+class TH2PolyIndex {
+public:
+   TH2PolyIndex(): fBuilt(kFALSE) {}
+
+   void        Build(TList *bins, Double_t xmin, Double_t xmax, Double_t ymin, Double_t ymax);
+   TH2PolyBin *FindBin(Double_t x, Double_t y) const;
+   void        FindBins(Int_t n, const Double_t *x, const Double_t *y, Int_t stride, TH2PolyBin **bins) const;
+   void        Invalidate() { fBuilt = kFALSE; }
+   Bool_t      IsBuilt() const { return fBuilt; }
+
+private:
+   enum { kMaxLeafBins = 8, kMaxDepth = 16 };
+
+   struct TNode {
+      Double_t fXmid;   // x of the boundary between the children
+      Double_t fYmid;   // y of the boundary between the children
+      Int_t    fChild;  // index of the first of the four children, -1 for a leaf
+      Int_t    fFirst;  // first bin of a leaf in fLeafBins
+      Int_t    fN;      // number of bins of a leaf
+   };
+
+   void   AddRings(TObject *poly);
+   void   BuildNode(Int_t node, Double_t xmin, Double_t xmax, Double_t ymin, Double_t ymax,
+                    const std::vector<Int_t> &bins, Int_t depth);
+   Bool_t IsInside(Int_t bin, Double_t x, Double_t y) const;
+
+   Bool_t                   fBuilt;     // whether the index reflects the bins of the histogram
+   std::vector<TH2PolyBin*> fBins;      // the bins
+   std::vector<Double_t>    fXmin;      // bounding box of each bin
+   std::vector<Double_t>    fXmax;
+   std::vector<Double_t>    fYmin;
+   std::vector<Double_t>    fYmax;
+   std::vector<Int_t>       fBinRing;   // first ring of each bin, and the end of the last one
+   std::vector<Int_t>       fRingEdge;  // first edge of each ring, and the end of the last one
+   std::vector<Double_t>    fEdgeX;     // x of the edge end point i
+   std::vector<Double_t>    fEdgeY;     // y of the edge end point i
+   std::vector<Double_t>    fEdgeY2;    // y of the edge end point j (the preceding vertex)
+   std::vector<Double_t>    fEdgeDX;    // x(j) - x(i)
+   std::vector<Double_t>    fEdgeDY;    // y(j) - y(i)
+   std::vector<TNode>       fNodes;     // the quadtree; fNodes[0] is the root
+   std::vector<Int_t>       fLeafBins;  // bins of the leaves
+};
+
+//______________________________________________________________________________
+void TH2PolyIndex::AddRings(TObject *poly)
+{
+   // Add the edges of the polygon(s) of a bin, except the horizontal ones. A
+   // TMultiGraph gives one ring per graph; a point is inside the bin if it is
+   // inside any of the rings.
+
+   if (poly->IsA() == TMultiGraph::Class()) {
+      TList *gl = ((TMultiGraph*)poly)->GetListOfGraphs();
+      if (!gl) return;
+      TIter next(gl);
+      TObject *g;
+      while ((g = next())) AddRings(g);
+      return;
+   }
+   if (poly->IsA() != TGraph::Class()) return;
+
+   TGraph *g = (TGraph*)poly;
+   const Int_t np = g->GetN();
+   const Double_t *x = g->GetX();
+   const Double_t *y = g->GetY();
+   for (Int_t i = 0, j = np - 1; i < np; j = i++) {
+      // a horizontal edge never crosses the horizontal line through the point
+      // and would make IsInside() divide by zero
+      if (y[j] == y[i]) continue;
+      fEdgeX.push_back(x[i]);
+      fEdgeY.push_back(y[i]);
+      fEdgeY2.push_back(y[j]);
+      fEdgeDX.push_back(x[j] - x[i]);
+      fEdgeDY.push_back(y[j] - y[i]);
+   }
+   fRingEdge.push_back(fEdgeX.size());
+}
+
+//______________________________________________________________________________
+void TH2PolyIndex::Build(TList *bins, Double_t xmin, Double_t xmax,
+                         Double_t ymin, Double_t ymax)
+{
+   // Build the index for the bins, within the histogram limits.
+
+   fBins.clear();
+   fXmin.clear();
+   fXmax.clear();
+   fYmin.clear();
+   fYmax.clear();
+   fBinRing.assign(1, 0);
+   fRingEdge.assign(1, 0);
+   fEdgeX.clear();
+   fEdgeY.clear();
+   fEdgeY2.clear();
+   fEdgeDX.clear();
+   fEdgeDY.clear();
+   fNodes.clear();
+   fLeafBins.clear();
+
+   std::vector<Int_t> all;
+   TIter next(bins);
+   TH2PolyBin *bin;
+   while ((bin = (TH2PolyBin*) next())) {
+      all.push_back(fBins.size());
+      fBins.push_back(bin);
+      fXmin.push_back(bin->GetXMin());
+      fXmax.push_back(bin->GetXMax());
+      fYmin.push_back(bin->GetYMin());
+      fYmax.push_back(bin->GetYMax());
+      AddRings(bin->GetPolygon());
+      fBinRing.push_back(fRingEdge.size() - 1);
+   }
+
+   fNodes.resize(1);
+   BuildNode(0, xmin, xmax, ymin, ymax, all, 0);
+   fBuilt = kTRUE;
+}
+
+//______________________________________________________________________________
+void TH2PolyIndex::BuildNode(Int_t node, Double_t xmin, Double_t xmax,
+                             Double_t ymin, Double_t ymax,
+                             const std::vector<Int_t> &bins, Int_t depth)
+{
+   // Fill the quadtree node covering [xmin, xmax] x [ymin, ymax], holding the
+   // bins, and its children. A node is split in four while it holds more than
+   // kMaxLeafBins bins and splitting reduces the number of bins per node.
+
+   const Double_t xmid = 0.5 * (xmin + xmax);
+   const Double_t ymid = 0.5 * (ymin + ymax);
+   fNodes[node].fXmid = xmid;
+   fNodes[node].fYmid = ymid;
+   fNodes[node].fChild = -1;
+   fNodes[node].fFirst = fLeafBins.size();
+   fNodes[node].fN = bins.size();
+
+   if (bins.size() > kMaxLeafBins && depth < kMaxDepth) {
+      // children in the order (low x, low y), (high x, low y), (low x, high y), (high x, high y)
+      std::vector<Int_t> sub[4];
+      for (size_t k = 0; k < bins.size(); ++k) {
+         const Int_t b = bins[k];
+         const Bool_t lowX = fXmin[b] <= xmid, highX = fXmax[b] >= xmid;
+         const Bool_t lowY = fYmin[b] <= ymid, highY = fYmax[b] >= ymid;
+         if (lowX && lowY) sub[0].push_back(b);
+         if (highX && lowY) sub[1].push_back(b);
+         if (lowX && highY) sub[2].push_back(b);
+         if (highX && highY) sub[3].push_back(b);
+      }
+      if (sub[0].size() < bins.size() || sub[1].size() < bins.size()
+          || sub[2].size() < bins.size() || sub[3].size() < bins.size()) {
+         const Int_t child = fNodes.size();
+         fNodes[node].fChild = child;
+         fNodes.resize(child + 4);
+         BuildNode(child,     xmin, xmid, ymin, ymid, sub[0], depth + 1);
+         BuildNode(child + 1, xmid, xmax, ymin, ymid, sub[1], depth + 1);
+         BuildNode(child + 2, xmin, xmid, ymid, ymax, sub[2], depth + 1);
+         BuildNode(child + 3, xmid, xmax, ymid, ymax, sub[3], depth + 1);
+         return;
+      }
+   }
+   fLeafBins.insert(fLeafBins.end(), bins.begin(), bins.end());
+}
+
+//______________________________________________________________________________
+Bool_t TH2PolyIndex::IsInside(Int_t bin, Double_t x, Double_t y) const
+{
+   // Return true if (x,y) is inside one of the rings of bin; same test as
+   // TMath::IsInside(), evaluated for all edges of a ring without branching.
+
+   if (x < fXmin[bin] || x > fXmax[bin] || y < fYmin[bin] || y > fYmax[bin])
+      return kFALSE;
+   for (Int_t r = fBinRing[bin]; r < fBinRing[bin + 1]; ++r) {
+      const Int_t last = fRingEdge[r + 1];
+      Int_t odd = 0;
+      for (Int_t e = fRingEdge[r]; e < last; ++e) {
+         // the intersection is only used if the edge crosses the horizontal line
+         const Int_t cross = (fEdgeY[e] < y) != (fEdgeY2[e] < y);
+         const Double_t xint = fEdgeX[e] + (y - fEdgeY[e]) / fEdgeDY[e] * fEdgeDX[e];
+         odd ^= cross & (xint < x);
+      }
+      if (odd) return kTRUE;
+   }
+   return kFALSE;
+}
+
+//______________________________________________________________________________
+TH2PolyBin *TH2PolyIndex::FindBin(Double_t x, Double_t y) const
+{
+   // Return the first bin containing (x,y), 0 if there is none.
+
+   Int_t node = 0;
+   while (fNodes[node].fChild >= 0) {
+      const TNode &n = fNodes[node];
+      node = n.fChild + (x >= n.fXmid) + 2 * (y >= n.fYmid);
+   }
+   const Int_t nbins = fNodes[node].fN;
+   if (!nbins) return 0;
+   const Int_t *b = &fLeafBins[fNodes[node].fFirst];
+   for (Int_t k = 0; k < nbins; ++k)
+      if (IsInside(b[k], x, y)) return fBins[b[k]];
+   return 0;
+}
+
+//______________________________________________________________________________
+void TH2PolyIndex::FindBins(Int_t n, const Double_t *x, const Double_t *y,
+                            Int_t stride, TH2PolyBin **bins) const
+{
+   // Set bins[i] to the first bin containing (x[i*stride], y[i*stride]),
+   // 0 if there is none.
+
+   for (Int_t i = 0; i < n; ++i)
+      bins[i] = FindBin(x[i * stride], y[i * stride]);
+}
+
 //______________________________________________________________________________
 /* Begin_Html
 <center><h2>TH2Poly: 2D Histogram with Polygonal Bins</h2></center>
@@ -194,6 +418,7 @@ TH2Poly::~TH2Poly()
    delete[] fCells;
    delete[] fIsEmpty;
    delete[] fCompletelyInside;
+   delete fIndex;
 }
 
 
@@ -242,6 +467,7 @@ Int_t TH2Poly::AddBin(TObject *poly)
 
    fBins->Add((TObject*) bin);
    SetNewBinAdded(kTRUE);
+   if (fIndex) fIndex->Invalidate();
 
    // Adds the bin to the partition matrix
    AddBinToPartition(bin);
@@ -426,6 +652,7 @@ void TH2Poly::ChangePartition(Int_t n, Int_t m)
 
    fCellX = n;                          // Set the number of cells
    fCellY = m;                          // Set the number of cells
+   if (fIndex) fIndex->Invalidate();    // The limits may have changed
 
    delete [] fCells;                    // Deletes the old partition
 
@@ -541,6 +768,11 @@ Int_t TH2Poly::FindBin(Double_t x, Double_t y, Double_t)
 
    TH2PolyBin *bin;
 
+   if (fIndex) {
+      bin = GetIndex()->FindBin(x, y);
+      return bin ? bin->GetBinNumber() : -5;
+   }
+
    TIter next(&fCells[n+fCellX*m]);
    TObject *obj;
 
@@ -596,28 +828,24 @@ Int_t TH2Poly::Fill(Double_t x, Double_t y, Double_t w)
    if (fIsEmpty[n+fCellX*m]) return 0;
 
    TH2PolyBin *bin;
-   Int_t bi;
+
+   if (fIndex) {
+      bin = GetIndex()->FindBin(x, y);
+      if (!bin) {
+         fOverflow[4]++;
+         return 0;
+      }
+      FillBin(bin, x, y, w);
+      return bin->GetBinNumber();
+   }
 
    TIter next(&fCells[n+fCellX*m]);
    TObject *obj;
 
    while ((obj=next())) {
       bin  = (TH2PolyBin*)obj;
-      bi = bin->GetBinNumber()-1;
       if (bin->IsInside(x,y)) {
-         bin->Fill(w);
-
-         // Statistics
-         fTsumw   = fTsumw + w;
-         fTsumwx  = fTsumwx + w*x;
-         fTsumwx2 = fTsumwx2 + w*x*x;
-         fTsumwy  = fTsumwy + w*y;
-         fTsumwy2 = fTsumwy2 + w*y*y;
-         if (fSumw2.fN) fSumw2.fArray[bi] += w*w;
-         fEntries++;
-
-         SetBinContentChanged(kTRUE);
-
+         FillBin(bin, x, y, w);
          return bin->GetBinNumber();
       }
    }
@@ -627,6 +855,26 @@ Int_t TH2Poly::Fill(Double_t x, Double_t y, Double_t w)
 }
 
 
+//______________________________________________________________________________
+void TH2Poly::FillBin(TH2PolyBin *bin, Double_t x, Double_t y, Double_t w)
+{
+   // Increment bin, which contains (x,y), by w and update the statistics.
+
+   bin->Fill(w);
+
+   // Statistics
+   fTsumw   = fTsumw + w;
+   fTsumwx  = fTsumwx + w*x;
+   fTsumwx2 = fTsumwx2 + w*x*x;
+   fTsumwy  = fTsumwy + w*y;
+   fTsumwy2 = fTsumwy2 + w*y*y;
+   if (fSumw2.fN) fSumw2.fArray[bin->GetBinNumber()-1] += w*w;
+   fEntries++;
+
+   SetBinContentChanged(kTRUE);
+}
+
+
 //______________________________________________________________________________
 Int_t TH2Poly::Fill(const char* name, Double_t w)
 {
@@ -664,13 +912,53 @@ void TH2Poly::FillN(Int_t ntimes, const Double_t* x, const Double_t* y,
    // y:       array of y values to be histogrammed
    // w:       array of weights
    // stride:  step size through arrays x, y and w
+   //
+   // If w is null, all weights are 1. With the spatial index (see
+   // SetSpatialIndex()) the bins of the entries are searched by batches.
 
-   for (int i = 0; i < ntimes; i += stride) {
-      Fill(x[i], y[i], w[i]);
+   if (!fIndex || !fNcells) {
+      for (int i = 0; i < ntimes; i += stride) {
+         Fill(x[i], y[i], w ? w[i] : 1.);
+      }
+      return;
+   }
+
+   const Int_t kBatchSize = 256;
+   TH2PolyBin *bins[kBatchSize];
+   const TH2PolyIndex *index = GetIndex();
+   const Double_t xmin = fXaxis.GetXmin(), xmax = fXaxis.GetXmax();
+   const Double_t ymin = fYaxis.GetXmin(), ymax = fYaxis.GetXmax();
+
+   for (Int_t first = 0; first < ntimes; first += kBatchSize * stride) {
+      const Int_t n = TMath::Min(kBatchSize, (ntimes - first + stride - 1) / stride);
+      index->FindBins(n, x + first, y + first, stride, bins);
+      for (Int_t k = 0; k < n; ++k) {
+         const Int_t i = first + k * stride;
+         const Double_t wi = w ? w[i] : 1.;
+         if (bins[k] && x[i] > xmin && x[i] <= xmax && y[i] > ymin && y[i] <= ymax) {
+            FillBin(bins[k], x[i], y[i], wi);
+         } else {
+            // overflow or sea: let Fill() do the bookkeeping
+            Fill(x[i], y[i], wi);
+         }
+      }
    }
 }
 
 
+//______________________________________________________________________________
+TH2PolyIndex *TH2Poly::GetIndex()
+{
+   // Return the spatial index, built for the current bins; 0 if the spatial
+   // index is disabled.
+
+   if (fIndex && !fIndex->IsBuilt())
+      fIndex->Build(fBins, fXaxis.GetXmin(), fXaxis.GetXmax(),
+                    fYaxis.GetXmin(), fYaxis.GetXmax());
+   return fIndex;
+}
+
+
 //______________________________________________________________________________
 Double_t TH2Poly::Integral(Option_t* option) const
 {
@@ -924,6 +1212,7 @@ void TH2Poly::Initialize(Double_t xlow, Double_t xup,
 
    fBins   = 0;
    fNcells = 0;
+   fIndex  = new TH2PolyIndex;
 
    // Sets the boundaries of the histogram
    fXaxis.Set(100, xlow, xup);
@@ -1207,6 +1496,26 @@ void TH2Poly::SetFloat(Bool_t flag)
 }
 
 
+//______________________________________________________________________________
+void TH2Poly::SetSpatialIndex(Bool_t flag)
+{
+   // Enable (the default) or disable the spatial index used by FindBin(),
+   // Fill() and FillN(). The index is a quadtree over the bounding boxes of
+   // the bins, with a copy of the polygon edges; it is built at the first
+   // search after bins were added. It finds the same bins as the partition
+   // cells (see ChangePartition()), which are used when it is disabled.
+   // If the polygons of existing bins are modified through GetBins(), call
+   // SetSpatialIndex(kFALSE) then SetSpatialIndex() to rebuild the index.
+
+   if (flag && !fIndex) {
+      fIndex = new TH2PolyIndex;
+   } else if (!flag) {
+      delete fIndex;
+      fIndex = 0;
+   }
+}
+
+
 //______________________________________________________________________________
 TH2PolyBin::TH2PolyBin()
 {
@@ -352,6 +352,96 @@ Int_t TH3::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
    return bin;
 }
 
+//______________________________________________________________________________
+void TH3::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride)
+{
+   //*-*-*-*-*-*-*Fill a 3-D histogram with an array of values and weights*-*-*-*
+   //*-*          ========================================================
+   //*-*
+   //*-* ntimes:  number of entries in arrays x, y, z and w (array size must be ntimes*stride)
+   //*-* x:       array of x values to be histogrammed
+   //*-* y:       array of y values to be histogrammed
+   //*-* z:       array of z values to be histogrammed
+   //*-* w:       array of weights
+   //*-* stride:  step size through arrays x, y, z and w
+   //*-*
+   //*-*  If the weight is not equal to 1, the storage of the sum of squares of 
+   //*-*   weights is automatically triggered and the sum of the squares of weights is incremented
+   //*-*   by w[i]^2 in the cell corresponding to x[i],y[i],z[i].
+   //*-*  If w is NULL each entry is assumed a weight=1
+   //*-*
+   //*-* Unless an axis can be extended, the entries are processed by batches
+   //*-* as in TH1::FillN. The result is identical to calling Fill for each entry.
+   //*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+
+   Int_t i;
+   if (fBuffer || fXaxis.CanExtend() || fYaxis.CanExtend() || fZaxis.CanExtend()) {
+      for (i=0;i<ntimes;i++) {
+         Int_t k = i*stride;
+         if (w) Fill(x[k], y[k], z[k], w[k]);
+         else   Fill(x[k], y[k], z[k]);
+      }
+      return;
+   }
+
+   fEntries += ntimes;
+   Int_t nx = fXaxis.GetNbins();
+   Int_t ny = fYaxis.GetNbins();
+   Int_t nz = fZaxis.GetNbins();
+   Int_t binsx[kNFillBatch], binsy[kNFillBatch], binsz[kNFillBatch], bins[kNFillBatch];
+   Double_t weights[kNFillBatch];
+   Double_t tsumw = fTsumw, tsumw2 = fTsumw2;
+   Double_t tsumwx = fTsumwx, tsumwx2 = fTsumwx2, tsumwy = fTsumwy, tsumwy2 = fTsumwy2;
+   Double_t tsumwxy = fTsumwxy, tsumwz = fTsumwz, tsumwz2 = fTsumwz2;
+   Double_t tsumwxz = fTsumwxz, tsumwyz = fTsumwyz;
+   for (Int_t first=0;first<ntimes;first+=kNFillBatch) {
+      Int_t n = TMath::Min(Int_t(kNFillBatch), ntimes-first);
+      const Double_t *xx = x + first*stride;
+      const Double_t *yy = y + first*stride;
+      const Double_t *zz = z + first*stride;
+      const Double_t *wn = 0;
+      fXaxis.FindFixBins(n, xx, binsx, stride);
+      fYaxis.FindFixBins(n, yy, binsy, stride);
+      fZaxis.FindFixBins(n, zz, binsz, stride);
+      for (i=0;i<n;i++) bins[i] = binsx[i] + (nx+2)*(binsy[i] + (ny+2)*binsz[i]);
+      if (w) {
+         for (i=0;i<n;i++) weights[i] = w[(first+i)*stride];
+         wn = weights;
+      }
+      FillNContents(n, bins, wn);
+      for (i=0;i<n;i++) {
+         if (!fgStatOverflows && (binsx[i] == 0 || binsx[i] > nx || binsy[i] == 0 || binsy[i] > ny ||
+                                  binsz[i] == 0 || binsz[i] > nz)) continue;
+         Double_t ww = wn ? wn[i] : 1.;
+         Double_t xi = xx[i*stride];
+         Double_t yi = yy[i*stride];
+         Double_t zi = zz[i*stride];
+         tsumw   += ww;
+         tsumw2  += ww*ww;
+         tsumwx  += ww*xi;
+         tsumwx2 += ww*xi*xi;
+         tsumwy  += ww*yi;
+         tsumwy2 += ww*yi*yi;
+         tsumwxy += ww*xi*yi;
+         tsumwz  += ww*zi;
+         tsumwz2 += ww*zi*zi;
+         tsumwxz += ww*xi*zi;
+         tsumwyz += ww*yi*zi;
+      }
+   }
+   fTsumw   = tsumw;
+   fTsumw2  = tsumw2;
+   fTsumwx  = tsumwx;
+   fTsumwx2 = tsumwx2;
+   fTsumwy  = tsumwy;
+   fTsumwy2 = tsumwy2;
+   fTsumwxy = tsumwxy;
+   fTsumwz  = tsumwz;
+   fTsumwz2 = tsumwz2;
+   fTsumwxz = tsumwxz;
+   fTsumwyz = tsumwyz;
+}
+
 //______________________________________________________________________________
 Int_t TH3::Fill(const char *namex, const char *namey, const char *namez, Double_t w)
 {
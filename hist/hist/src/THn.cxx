@@ -196,6 +196,36 @@ ROOT::THnBaseBinIter* THn::CreateIter(Bool_t respectAxisRange) const
                          respectAxisRange);
 }
 
+//______________________________________________________________________________
+void THn::GetBinContents(Long64_t first, Int_t n, Double_t* content,
+                         Double_t* err2 /*= 0*/, Int_t* coord /*= 0*/) const
+{
+   // Get the content of the n bins starting at linear index first, see
+   // THnBase::GetBinContents(). The coordinates are incremented from bin
+   // to bin instead of being computed from the linear index.
+
+   const TNDArray& arr = GetArray();
+   arr.CopyAsDouble(first, n, content);
+   if (err2) {
+      if (GetCalculateErrors())
+         fSumw2.CopyAsDouble(first, n, err2);
+      else
+         memcpy(err2, content, n * sizeof(Double_t));
+   }
+   if (coord && n > 0) {
+      GetBinContent(first, coord);
+      const Int_t ndim = GetNdimensions();
+      for (Int_t i = 1; i < n; ++i) {
+         Int_t* c = coord + i * ndim;
+         memcpy(c, c - ndim, ndim * sizeof(Int_t));
+         for (Int_t d = ndim - 1; d >= 0; --d) {
+            if (++c[d] < GetAxis(d)->GetNbins() + 2) break;
+            c[d] = 0;
+         }
+      }
+   }
+}
+
 //______________________________________________________________________________
 void THn::Sumw2() {
    // Enable calculation of errors
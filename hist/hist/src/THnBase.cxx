@@ -28,8 +28,11 @@
 #include "HFitInterface.h"
 #include "Fit/SparseData.h"
 #include "Math/MinimizerOptions.h"
+#include "Math/ThreadPool.h"
 #include "Math/WrappedMultiTF1.h"
 
+#include <vector>
+
 
 //______________________________________________________________________________
 //
@@ -411,6 +414,75 @@ void THnBase::GetRandom(Double_t *rand, Bool_t subBinRandom /* = kTRUE */)
    return;
 }
 
+//______________________________________________________________________________
+void THnBase::FillN(Int_t nentries, const Double_t* x, const Double_t* w /* = 0 */)
+{
+   // Fill nentries entries at once. The coordinates of entry i are
+   // x[i * GetNdimensions() + d], its weight w[i], or 1 if w is null.
+   // The result is the same as calling Fill() for each entry; the bins of
+   // the entries are determined by batches, see GetBins().
+
+   const Int_t nbatch = 256;
+   Long64_t bins[nbatch];
+   for (Int_t first = 0; first < nentries; first += nbatch) {
+      const Int_t n = TMath::Min(nbatch, nentries - first);
+      const Double_t* xfirst = x + (Long64_t)first * fNdimensions;
+      GetBins(n, xfirst, bins);
+      for (Int_t i = 0; i < n; ++i) {
+         const Double_t wi = w ? w[first + i] : 1.;
+         UpdateXStat(xfirst + (Long64_t)i * fNdimensions, wi);
+         FillBin(bins[i], wi);
+      }
+   }
+}
+
+//______________________________________________________________________________
+void THnBase::GetBins(Int_t n, const Double_t* x, Long64_t* bins)
+{
+   // Set bins[i] to the bin of the n entries with coordinates
+   // x[i * GetNdimensions() + d], allocating the bins if needed.
+   // Unless an axis can be extended the axis bins are found for all
+   // entries at once, see TAxis::FindFixBins().
+
+   for (Int_t d = 0; d < fNdimensions; ++d) {
+      if (GetAxis(d)->CanExtend()) {
+         for (Int_t i = 0; i < n; ++i)
+            bins[i] = GetBin(x + (Long64_t)i * fNdimensions, kTRUE /*alloc*/);
+         return;
+      }
+   }
+
+   Int_t* axisbins = new Int_t[n * fNdimensions];
+   for (Int_t d = 0; d < fNdimensions; ++d)
+      GetAxis(d)->FindFixBins(n, x + d, axisbins + d * n, fNdimensions);
+   Int_t* coord = new Int_t[fNdimensions];
+   for (Int_t i = 0; i < n; ++i) {
+      for (Int_t d = 0; d < fNdimensions; ++d)
+         coord[d] = axisbins[d * n + i];
+      bins[i] = GetBin(coord, kTRUE /*alloc*/);
+   }
+   delete [] coord;
+   delete [] axisbins;
+}
+
+//______________________________________________________________________________
+void THnBase::GetBinContents(Long64_t first, Int_t n, Double_t* content,
+                             Double_t* err2 /*= 0*/, Int_t* coord /*= 0*/) const
+{
+   // Get the content of the n bins with linear indexes first ... first + n - 1,
+   // for a THnSparse the filled bins, as used by THnIter. If err2 is not null,
+   // it is set to the squared bin errors, or to the contents if errors are not
+   // enabled (see GetBinError2()). If coord is not null, it is set to the bin
+   // coordinates, GetNdimensions() per bin: those of bin first + i start at
+   // coord[i * GetNdimensions()].
+   // THn and THnSparse read the bins without per-bin virtual calls.
+
+   for (Int_t i = 0; i < n; ++i) {
+      content[i] = GetBinContent(first + i, coord ? coord + i * fNdimensions : 0);
+      if (err2) err2[i] = GetBinError2(first + i);
+   }
+}
+
 //______________________________________________________________________________
 Bool_t THnBase::IsInRange(Int_t *coord) const
 {
@@ -429,6 +501,304 @@ Bool_t THnBase::IsInRange(Int_t *coord) const
    return kTRUE;
 }
 
+namespace {
+//______________________________________________________________________________
+//
+// THnBaseBinTask adds the bins of a THnBase to a target histogram, mapping
+// the source bin coordinates to target bins. The source bins are split into
+// contiguous slices, one per task, that are executed by the
+// ROOT::Math::ThreadPool. The bins are read by batches through
+// THnBase::GetBinContents().
+// Each task adds to its own copy of the target: per-task content arrays for
+// a TH1, a partial THnBase given by AddPartial() otherwise. These are merged
+// into the target in task order, so the result does not depend on the thread
+// that executed a task. If the mapping is one to one and the target is a THn
+// the tasks add directly to the target.
+//______________________________________________________________________________
+
+class THnBaseBinTask: public ROOT::Math::ThreadPool::ITask {
+public:
+   enum { kBatchSize = 1024 };
+
+   THnBaseBinTask(const THnBase* src, Int_t ntasks, Int_t ndim, const Int_t* dim,
+                  Bool_t respectAxisRange, Bool_t wantErrors, Double_t scale = 1.);
+   ~THnBaseBinTask();
+
+   static Int_t GetNTasks(Long64_t nbins, Long64_t targetCells);
+
+   void SetOffset(Int_t d, Int_t offset) { fOffset[d] = offset; }
+   void SetGroup(Int_t d, Int_t group) { fGroup[d] = group; }
+   void SetTarget(TH1* hist);
+   void SetTarget(THnBase* hn) { fHn = hn; }
+   void AddPartial(THnBase* partial) { fPartial.push_back(partial); }
+
+   void Execute(unsigned int itask);
+   void Run();
+   Bool_t HaveSkippedBin() const;
+
+private:
+   Bool_t MapBin(const Int_t* coord, Int_t* bins) const;
+   Long64_t GetHistBin(const Int_t* bins) const;
+   void Merge();
+
+   const THnBase* fSource; // histogram to read the bins from
+   Int_t fNTasks; // number of tasks
+   Int_t fNdim; // number of target dimensions
+   std::vector<Int_t> fDim; // source dimension for each target dimension
+   std::vector<Int_t> fOffset; // offset subtracted from the coordinates
+   std::vector<Int_t> fGroup; // number of source bins grouped into a target bin
+   std::vector<Int_t> fFirst; // first source bin in range, per source dimension
+   std::vector<Int_t> fLast; // last source bin in range, per source dimension
+   Bool_t fRespectAxisRange; // whether to skip bins outside the axis ranges
+   Bool_t fRangeSet; // whether any source axis has a range
+   Bool_t fWantErrors; // whether to add the errors
+   Double_t fScale; // factor applied to the contents
+   TH1* fHist; // TH1 target, or null
+   Int_t fHistNcells[3]; // number of cells per axis of fHist, including under/overflow
+   THnBase* fHn; // THnBase target, or null
+   std::vector<THnBase*> fPartial; // per-task target copies; direct add if empty
+   std::vector<Double_t> fContent; // per-task content of the TH1 target
+   std::vector<Double_t> fErr2; // per-task squared errors of the TH1 target
+   std::vector<Char_t> fSkipped; // whether a task skipped a bin outside the range
+};
+
+//______________________________________________________________________________
+THnBaseBinTask::THnBaseBinTask(const THnBase* src, Int_t ntasks, Int_t ndim,
+                               const Int_t* dim, Bool_t respectAxisRange,
+                               Bool_t wantErrors, Double_t scale /*= 1.*/):
+   fSource(src), fNTasks(ntasks), fNdim(ndim), fDim(ndim),
+   fOffset(ndim, 0), fGroup(ndim, 1), fFirst(src->GetNdimensions()),
+   fLast(src->GetNdimensions()), fRespectAxisRange(respectAxisRange),
+   fRangeSet(kFALSE), fWantErrors(wantErrors), fScale(scale), fHist(0), fHn(0),
+   fSkipped(ntasks, 0)
+{
+   // Construct a task reading the bins of src; target dimension d is the source
+   // dimension dim[d], or d if dim is null. If respectAxisRange, bins outside
+   // the source axis ranges are skipped, the same way as THnIter does.
+
+   for (Int_t d = 0; d < ndim; ++d)
+      fDim[d] = dim ? dim[d] : d;
+
+   const Bool_t isDense = src->InheritsFrom(THn::Class());
+   for (Int_t d = 0; d < src->GetNdimensions(); ++d) {
+      TAxis* axis = src->GetAxis(d);
+      fFirst[d] = 0;
+      fLast[d] = axis->GetNbins() + 1;
+      if (!respectAxisRange || !axis->TestBit(TAxis::kAxisRange)) continue;
+      fRangeSet = kTRUE;
+      fFirst[d] = axis->GetFirst();
+      fLast[d] = axis->GetLast();
+      if (isDense && fFirst[d] == 0 && fLast[d] == 0) {
+         // as THnBinIter: under- and overflow bins are de-selected
+         fFirst[d] = 1;
+         fLast[d] = axis->GetNbins();
+      }
+   }
+}
+
+//______________________________________________________________________________
+THnBaseBinTask::~THnBaseBinTask()
+{
+   // Delete the partial targets.
+   for (size_t i = 0; i < fPartial.size(); ++i)
+      delete fPartial[i];
+}
+
+//______________________________________________________________________________
+Int_t THnBaseBinTask::GetNTasks(Long64_t nbins, Long64_t targetCells)
+{
+   // Number of tasks for reading nbins bins into a target with targetCells
+   // cells per task copy; 1 means that the bins should be read sequentially.
+   // The loop is split only if the default number of threads of
+   // ROOT::Math::ThreadPool is larger than one, and if the per-task copies of
+   // the target are not larger than the source.
+
+   const Long64_t kMinParallelBins = 65536;
+   const Int_t nthreads = ROOT::Math::ThreadPool::DefaultNThreads();
+   if (nthreads < 2 || nbins < kMinParallelBins) return 1;
+   if (targetCells * nthreads > nbins) return 1;
+   return nthreads;
+}
+
+//______________________________________________________________________________
+void THnBaseBinTask::SetTarget(TH1* hist)
+{
+   // Add the bins to the TH1 hist, through per-task content arrays.
+
+   fHist = hist;
+   fHistNcells[0] = hist->GetNbinsX() + 2;
+   fHistNcells[1] = hist->GetNbinsY() + 2;
+   fHistNcells[2] = hist->GetNbinsZ() + 2;
+   fContent.assign(fNTasks * (size_t)hist->GetNcells(), 0.);
+   if (fWantErrors)
+      fErr2.assign(fContent.size(), 0.);
+}
+
+//______________________________________________________________________________
+Bool_t THnBaseBinTask::MapBin(const Int_t* coord, Int_t* bins) const
+{
+   // Determine the target bin coordinates of the source bin coord.
+   // Return false if the bin is outside the range.
+
+   if (fRangeSet) {
+      for (size_t d = 0; d < fFirst.size(); ++d)
+         if (coord[d] < fFirst[d] || coord[d] > fLast[d])
+            return kFALSE;
+   }
+   for (Int_t d = 0; d < fNdim; ++d) {
+      Int_t c = coord[fDim[d]];
+      if (fGroup[d] > 1)
+         c = TMath::CeilNint((double) c / fGroup[d]);
+      bins[d] = c - fOffset[d];
+   }
+   return kTRUE;
+}
+
+//______________________________________________________________________________
+Long64_t THnBaseBinTask::GetHistBin(const Int_t* bins) const
+{
+   // Global bin of the TH1 target for bin coordinates bins, see TH1::GetBin().
+
+   Long64_t bin = 0;
+   for (Int_t d = fNdim - 1; d >= 0; --d) {
+      Int_t b = bins[d];
+      if (b < 0) b = 0;
+      if (b >= fHistNcells[d]) b = fHistNcells[d] - 1;
+      bin = bin * fHistNcells[d] + b;
+   }
+   return bin;
+}
+
+//______________________________________________________________________________
+void THnBaseBinTask::Execute(unsigned int itask)
+{
+   // Read the slice of source bins of task itask and add them to the
+   // task's copy of the target.
+
+   const Long64_t nbins = fSource->GetNbins();
+   const Long64_t begin = nbins * itask / fNTasks;
+   const Long64_t end = nbins * (itask + 1) / fNTasks;
+   const Int_t nsrc = fSource->GetNdimensions();
+
+   Double_t content[kBatchSize];
+   Double_t err2[kBatchSize];
+   Int_t* coord = new Int_t[kBatchSize * nsrc];
+   Int_t* bins = new Int_t[fNdim];
+
+   Double_t* histContent = 0;
+   Double_t* histErr2 = 0;
+   if (fHist) {
+      histContent = &fContent[itask * (fContent.size() / fNTasks)];
+      if (fWantErrors)
+         histErr2 = &fErr2[itask * (fErr2.size() / fNTasks)];
+   }
+   THnBase* hn = fPartial.empty() ? fHn : fPartial[itask];
+   const Double_t scale2 = fScale * fScale;
+
+   for (Long64_t first = begin; first < end; first += kBatchSize) {
+      const Int_t n = (Int_t) TMath::Min((Long64_t) kBatchSize, end - first);
+      fSource->GetBinContents(first, n, content, fWantErrors ? err2 : 0, coord);
+      for (Int_t i = 0; i < n; ++i) {
+         if (!MapBin(coord + i * nsrc, bins)) {
+            fSkipped[itask] = 1;
+            continue;
+         }
+         const Double_t v = fScale * content[i];
+         if (histContent) {
+            const Long64_t bin = GetHistBin(bins);
+            histContent[bin] += v;
+            if (histErr2) histErr2[bin] += scale2 * err2[i];
+         } else {
+            const Long64_t bin = hn->GetBin(bins, kTRUE /*allocate*/);
+            if (fWantErrors) hn->AddBinError2(bin, scale2 * err2[i]);
+            hn->AddBinContent(bin, v);
+         }
+      }
+   }
+
+   delete [] bins;
+   delete [] coord;
+}
+
+//______________________________________________________________________________
+void THnBaseBinTask::Run()
+{
+   // Execute the tasks and merge their results into the target.
+
+   // Create the lazily allocated members of source and target on this thread.
+   if (fSource->GetNbins()) {
+      Double_t v = 0.;
+      Double_t e2 = 0.;
+      Int_t* coord = new Int_t[fSource->GetNdimensions()];
+      fSource->GetBinContents(0, 1, &v, &e2, coord);
+      delete [] coord;
+   }
+   if (fHn && fPartial.empty()) {
+      // direct add, only for a dense target: allocates its arrays
+      fHn->AddBinContent((Long64_t) 0, 0.);
+      if (fWantErrors) fHn->AddBinError2((Long64_t) 0, 0.);
+   }
+
+   ROOT::Math::ThreadPool::Run(*this, fNTasks);
+   Merge();
+}
+
+//______________________________________________________________________________
+void THnBaseBinTask::Merge()
+{
+   // Add the per-task target copies to the target, in task order.
+
+   if (fHist) {
+      const Int_t ncells = fHist->GetNcells();
+      if (fWantErrors && !fHist->GetSumw2N())
+         fHist->Sumw2();
+      Double_t* sumw2 = fWantErrors ? fHist->GetSumw2()->GetArray() : 0;
+      for (Int_t bin = 0; bin < ncells; ++bin) {
+         Double_t v = 0.;
+         Double_t e2 = 0.;
+         for (Int_t k = 0; k < fNTasks; ++k) {
+            v += fContent[(size_t)k * ncells + bin];
+            if (sumw2) e2 += fErr2[(size_t)k * ncells + bin];
+         }
+         if (sumw2) sumw2[bin] += e2;
+         if (v) fHist->AddBinContent(bin, v);
+      }
+      return;
+   }
+
+   const Int_t ndim = fHn->GetNdimensions();
+   Double_t content[kBatchSize];
+   Double_t err2[kBatchSize];
+   Int_t* coord = new Int_t[kBatchSize * ndim];
+   for (size_t k = 0; k < fPartial.size(); ++k) {
+      const THnBase* partial = fPartial[k];
+      const Long64_t nbins = partial->GetNbins();
+      for (Long64_t first = 0; first < nbins; first += kBatchSize) {
+         const Int_t n = (Int_t) TMath::Min((Long64_t) kBatchSize, nbins - first);
+         partial->GetBinContents(first, n, content, fWantErrors ? err2 : 0, coord);
+         for (Int_t i = 0; i < n; ++i) {
+            const Long64_t bin = fHn->GetBin(coord + i * ndim, kTRUE /*allocate*/);
+            if (fWantErrors) fHn->AddBinError2(bin, err2[i]);
+            fHn->AddBinContent(bin, content[i]);
+         }
+      }
+   }
+   delete [] coord;
+}
+
+//______________________________________________________________________________
+Bool_t THnBaseBinTask::HaveSkippedBin() const
+{
+   // Whether bins were skipped because of the axis ranges; as for THnIter,
+   // always true for a THn source with an axis range.
+
+   if (fRangeSet && fSource->InheritsFrom(THn::Class())) return kTRUE;
+   for (Int_t k = 0; k < fNTasks; ++k)
+      if (fSkipped[k]) return kTRUE;
+   return kFALSE;
+}
+}
+
 //______________________________________________________________________________
 TObject* THnBase::ProjectionAny(Int_t ndim, const Int_t* dim,
                                 Bool_t wantNDim,
@@ -508,58 +878,80 @@ TObject* THnBase::ProjectionAny(Int_t ndim, const Int_t* dim,
    Bool_t haveErrors = GetCalculateErrors();
    Bool_t wantErrors = haveErrors || (option && (strchr(option, 'E') || strchr(option, 'e')));
 
-   Int_t* bins  = new Int_t[ndim];
-   Long64_t myLinBin = 0;
-
-   THnIter iter(this, kTRUE /*use axis range*/);
-
-   while ((myLinBin = iter.Next()) >= 0) {
-      Double_t v = GetBinContent(myLinBin);
-
+   // For large histograms, read the bins in parallel if ROOT::Math::ThreadPool
+   // is configured to use several threads.
+   Bool_t haveSkippedBin = kFALSE;
+   Int_t ntasks = THnBaseBinTask::GetNTasks(GetNbins(), wantNDim ? hn->GetNbins() : hist->GetNcells());
+   if (ntasks > 1) {
+      THnBaseBinTask task(this, ntasks, ndim, dim, kTRUE /*use axis range*/, wantErrors);
       for (Int_t d = 0; d < ndim; ++d) {
-         bins[d] = iter.GetCoord(dim[d]);
-         if (!keepTargetAxis && GetAxis(dim[d])->TestBit(TAxis::kAxisRange)) {
-            bins[d] -= GetAxis(dim[d])->GetFirst() - 1;
-         }
+         if (!keepTargetAxis && GetAxis(dim[d])->TestBit(TAxis::kAxisRange))
+            task.SetOffset(d, GetAxis(dim[d])->GetFirst() - 1);
       }
-
-      Long64_t targetLinBin = -1;
-      if (!wantNDim) {
-         if (ndim == 1) targetLinBin = bins[0];
-         else if (ndim == 2) targetLinBin = hist->GetBin(bins[0], bins[1]);
-         else if (ndim == 3) targetLinBin = hist->GetBin(bins[0], bins[1], bins[2]);
+      if (wantNDim) {
+         task.SetTarget(hn);
+         for (Int_t k = 0; k < ntasks; ++k)
+            task.AddPartial(hn->CloneEmpty(name, title, hn->GetListOfAxes(), kTRUE));
       } else {
-         targetLinBin = hn->GetBin(bins, kTRUE /*allocate*/);
+         task.SetTarget(hist);
       }
+      task.Run();
+      haveSkippedBin = task.HaveSkippedBin();
+   } else {
+      Int_t* bins  = new Int_t[ndim];
+      Long64_t myLinBin = 0;
 
-      if (wantErrors) {
-         Double_t err2 = 0.;
-         if (haveErrors) {
-            err2 = GetBinError2(myLinBin);
-         } else {
-            err2 = v;
+      THnIter iter(this, kTRUE /*use axis range*/);
+
+      while ((myLinBin = iter.Next()) >= 0) {
+         Double_t v = GetBinContent(myLinBin);
+
+         for (Int_t d = 0; d < ndim; ++d) {
+            bins[d] = iter.GetCoord(dim[d]);
+            if (!keepTargetAxis && GetAxis(dim[d])->TestBit(TAxis::kAxisRange)) {
+               bins[d] -= GetAxis(dim[d])->GetFirst() - 1;
+            }
          }
-         if (wantNDim) {
-            hn->AddBinError2(targetLinBin, err2);
+
+         Long64_t targetLinBin = -1;
+         if (!wantNDim) {
+            if (ndim == 1) targetLinBin = bins[0];
+            else if (ndim == 2) targetLinBin = hist->GetBin(bins[0], bins[1]);
+            else if (ndim == 3) targetLinBin = hist->GetBin(bins[0], bins[1], bins[2]);
          } else {
-            Double_t preverr = hist->GetBinError(targetLinBin);
-            hist->SetBinError(targetLinBin, TMath::Sqrt(preverr * preverr + err2));
+            targetLinBin = hn->GetBin(bins, kTRUE /*allocate*/);
          }
+
+         if (wantErrors) {
+            Double_t err2 = 0.;
+            if (haveErrors) {
+               err2 = GetBinError2(myLinBin);
+            } else {
+               err2 = v;
+            }
+            if (wantNDim) {
+               hn->AddBinError2(targetLinBin, err2);
+            } else {
+               Double_t preverr = hist->GetBinError(targetLinBin);
+               hist->SetBinError(targetLinBin, TMath::Sqrt(preverr * preverr + err2));
+            }
+         }
+
+         // only _after_ error calculation, or sqrt(v) is taken into account!
+         if (wantNDim)
+            hn->AddBinContent(targetLinBin, v);
+         else
+            hist->AddBinContent(targetLinBin, v);
       }
 
-      // only _after_ error calculation, or sqrt(v) is taken into account!
-      if (wantNDim)
-         hn->AddBinContent(targetLinBin, v);
-      else
-         hist->AddBinContent(targetLinBin, v);
+      delete [] bins;
+      haveSkippedBin = iter.HaveSkippedBin();
    }
 
-   delete [] bins;
-
    if (wantNDim) {
       hn->SetEntries(fEntries);
    } else {
-      if (!iter.HaveSkippedBin()) {
+      if (!haveSkippedBin) {
          hist->SetEntries(fEntries);
       } else {
          // re-compute the entries
@@ -638,30 +1030,43 @@ void THnBase::AddInternal(const THnBase* h, Double_t c, Bool_t rebinned)
    Long64_t numTargetBins = GetNbins() + h->GetNbins();
    Reserve(numTargetBins);
 
-   Long64_t i = 0;
-   THnIter iter(h);
-   // Add to this whatever is found inside the other histogram
-   while ((i = iter.Next(coord)) >= 0) {
-      // Get the content of the bin from the second histogram
-      Double_t v = h->GetBinContent(i);
-
-      Long64_t mybinidx = -1;
-      if (rebinned) {
-         // Get the bin center given a coord
-         for (Int_t j = 0; j < fNdimensions; ++j)
-            x[j] = h->GetAxis(j)->GetBinCenter(coord[j]);
-
-         mybinidx = GetBin(x, kTRUE /* allocate*/);
-      } else {
-         mybinidx = GetBin(coord, kTRUE /*allocate*/);
-      }
+   // For a THn target with identical binning every bin of h is added to a
+   // different bin of this: for large histograms the bins are added in
+   // parallel if ROOT::Math::ThreadPool is configured to use several threads.
+   Int_t ntasks = 1;
+   if (!rebinned && InheritsFrom(THn::Class()))
+      ntasks = THnBaseBinTask::GetNTasks(h->GetNbins(), 0);
+   if (ntasks > 1) {
+      THnBaseBinTask task(h, ntasks, fNdimensions, 0 /*dim*/, kFALSE /*use axis range*/,
+                          haveErrors, c);
+      task.SetTarget(this);
+      task.Run();
+   } else {
+      Long64_t i = 0;
+      THnIter iter(h);
+      // Add to this whatever is found inside the other histogram
+      while ((i = iter.Next(coord)) >= 0) {
+         // Get the content of the bin from the second histogram
+         Double_t v = h->GetBinContent(i);
+
+         Long64_t mybinidx = -1;
+         if (rebinned) {
+            // Get the bin center given a coord
+            for (Int_t j = 0; j < fNdimensions; ++j)
+               x[j] = h->GetAxis(j)->GetBinCenter(coord[j]);
+
+            mybinidx = GetBin(x, kTRUE /* allocate*/);
+         } else {
+            mybinidx = GetBin(coord, kTRUE /*allocate*/);
+         }
 
-      if (haveErrors) {
-         Double_t err2 = h->GetBinError2(i) * c * c;
-         AddBinError2(mybinidx, err2);
+         if (haveErrors) {
+            Double_t err2 = h->GetBinError2(i) * c * c;
+            AddBinError2(mybinidx, err2);
+         }
+         // only _after_ error calculation, or sqrt(v) is taken into account!
+         AddBinContent(mybinidx, c * v);
       }
-      // only _after_ error calculation, or sqrt(v) is taken into account!
-      AddBinContent(mybinidx, c * v);
    }
 
    delete [] coord;
@@ -1100,33 +1505,44 @@ THnBase* THnBase::RebinBase(const Int_t* group) const
    Bool_t haveErrors = GetCalculateErrors();
    Bool_t wantErrors = haveErrors;
 
-   Int_t* bins  = new Int_t[ndim];
-   Int_t* coord = new Int_t[fNdimensions];
+   Int_t ntasks = THnBaseBinTask::GetNTasks(GetNbins(), h->GetNbins());
+   if (ntasks > 1) {
+      THnBaseBinTask task(this, ntasks, ndim, 0 /*dim*/, kFALSE /*use axis range*/, wantErrors);
+      for (Int_t d = 0; d < ndim; ++d)
+         task.SetGroup(d, group[d]);
+      task.SetTarget(h);
+      for (Int_t k = 0; k < ntasks; ++k)
+         task.AddPartial(h->CloneEmpty(name.Data(), title.Data(), h->GetListOfAxes(), kTRUE));
+      task.Run();
+   } else {
+      Int_t* bins  = new Int_t[ndim];
+      Int_t* coord = new Int_t[fNdimensions];
 
-   Long64_t i = 0;
-   THnIter iter(this);
-   while ((i = iter.Next(coord)) >= 0) {
-      Double_t v = GetBinContent(i);
-      for (Int_t d = 0; d < ndim; ++d) {
-         bins[d] = TMath::CeilNint( (double) coord[d]/group[d] );
-      }
-      Long64_t idxh = h->GetBin(bins, kTRUE /*allocate*/);
+      Long64_t i = 0;
+      THnIter iter(this);
+      while ((i = iter.Next(coord)) >= 0) {
+         Double_t v = GetBinContent(i);
+         for (Int_t d = 0; d < ndim; ++d) {
+            bins[d] = TMath::CeilNint( (double) coord[d]/group[d] );
+         }
+         Long64_t idxh = h->GetBin(bins, kTRUE /*allocate*/);
+
+         if (wantErrors) {
+            Double_t err2 = 0.;
+            if (haveErrors) {
+               err2 = GetBinError2(i);
+            } else err2 = v;
+            h->AddBinError2(idxh, err2);
+         }
 
-      if (wantErrors) {
-         Double_t err2 = 0.;
-         if (haveErrors) {
-            err2 = GetBinError2(i);
-         } else err2 = v;
-         h->AddBinError2(idxh, err2);
+         // only _after_ error calculation, or sqrt(v) is taken into account!
+         h->AddBinContent(idxh, v);
       }
 
-      // only _after_ error calculation, or sqrt(v) is taken into account!
-      h->AddBinContent(idxh, v);
+      delete [] bins;
+      delete [] coord;
    }
 
-   delete [] bins;
-   delete [] coord;
-
    h->SetEntries(fEntries);
 
    return h;
@@ -17,6 +17,19 @@
 #include "TDataType.h"
 
 namespace {
+   //______________________________________________________________________________
+   template <class ARRAY>
+   Bool_t CopyContentAsDouble(const TArray* cont, Int_t first, Int_t n, Double_t* out)
+   {
+      // Copy n elements of cont starting at first into out if cont is an ARRAY,
+      // return false otherwise.
+      if (cont->IsA() != ARRAY::Class()) return kFALSE;
+      const ARRAY* arr = (const ARRAY*) cont;
+      for (Int_t i = 0; i < n; ++i)
+         out[i] = arr->fArray[first + i];
+      return kTRUE;
+   }
+
 //______________________________________________________________________________
 //
 // THnSparseBinIter iterates over all filled bins of a THnSparse.
@@ -268,9 +281,9 @@ ULong64_t THnSparseCoordCompression::GetHashFromCoords(const Int_t* coord) const
 
    // Bins are addressed in two different modes, depending
    // on whether the compact bin index fits into a Long64_t or not.
-   // If it does, we can use it as a "perfect hash" for the TExMap.
+   // If it does, we can use it as a "perfect hash" for the bin index.
    // If not we build a hash from the compact bin index, and use that
-   // as the TExMap's hash.
+   // as the bin index's hash.
 
    if (fCoordBufferSize <= 8) {
       // fits into a Long64_t
@@ -316,9 +329,9 @@ ULong64_t THnSparseCoordCompression::GetHashFromBuffer(const Char_t* buf) const
 
    // Bins are addressed in two different modes, depending
    // on whether the compact bin index fits into a Long64_t or not.
-   // If it does, we can use it as a "perfect hash" for the TExMap.
+   // If it does, we can use it as a "perfect hash" for the bin index.
    // If not we build a hash from the compact bin index, and use that
-   // as the TExMap's hash.
+   // as the bin index's hash.
 
    if (fCoordBufferSize <= 8) {
       // fits into a Long64_t
@@ -408,6 +421,82 @@ THnSparseCompactBinCoord::~THnSparseCompactBinCoord()
    delete [] fCurrentBin;
 }
 
+//______________________________________________________________________________
+//
+// THnSparseBinIndex is used by THnSparse internally. It maps the hash of the
+// compact bin coordinates (see THnSparseCoordCompression::GetHashFromBuffer())
+// to the linear index of the filled bin. It is an open addressing hash table
+// with linear probing: the (hash, index + 1) pairs are stored in one array,
+// so a lookup usually reads a single cache line, and bins with the same hash
+// simply occupy consecutive slots. The number of slots is a power of two,
+// and the table grows when it is more than 3/4 full.
+//______________________________________________________________________________
+
+class THnSparseBinIndex {
+public:
+   struct TSlot {
+      ULong64_t fHash;   // hash of the compact bin coordinate
+      Long64_t  fIndex;  // linear bin index + 1; 0 for an empty slot
+   };
+
+   THnSparseBinIndex(): fSlots(0), fBits(0), fSize(0) {}
+   ~THnSparseBinIndex() { delete [] fSlots; }
+
+   Long64_t  GetSize() const { return fSize; }
+   Long64_t  GetCapacity() const { return fSlots ? (1LL << fBits) : 0; }
+   ULong64_t GetFirst(ULong64_t hash) const {
+      // Return the first slot to probe for hash.
+      // Spread the bits: the compact coordinates are a bad hash by themselves.
+      return (hash * 0x9E3779B97F4A7C15ULL) >> (64 - fBits);
+   }
+   ULong64_t GetNext(ULong64_t slot) const {
+      // Return the slot to probe after slot.
+      return (slot + 1) & ((1ULL << fBits) - 1);
+   }
+   const TSlot& GetSlot(ULong64_t slot) const { return fSlots[slot]; }
+   void Add(ULong64_t slot, ULong64_t hash, Long64_t index) {
+      // Store index for hash in the empty slot, as returned by the probing.
+      fSlots[slot].fHash = hash;
+      fSlots[slot].fIndex = index + 1;
+      if (++fSize * 4 > GetCapacity() * 3) Expand(2 * GetCapacity());
+   }
+   void Clear() { delete [] fSlots; fSlots = 0; fBits = 0; fSize = 0; }
+   void Expand(Long64_t nslots);
+
+private:
+   THnSparseBinIndex(const THnSparseBinIndex&); // Not implemented
+   THnSparseBinIndex& operator=(const THnSparseBinIndex&); // Not implemented
+
+   TSlot    *fSlots; // hash table, 1 << fBits slots
+   Int_t     fBits;  // log2 of the number of slots
+   Long64_t  fSize;  // number of used slots
+};
+
+//______________________________________________________________________________
+void THnSparseBinIndex::Expand(Long64_t nslots)
+{
+   // Resize the table to at least nslots slots, keeping its content.
+
+   if (nslots < 16) nslots = 16;
+   Int_t bits = 4;
+   while ((1LL << bits) < nslots) ++bits;
+   if (fSlots && bits <= fBits) return;
+
+   TSlot *oldslots = fSlots;
+   Long64_t oldcapacity = GetCapacity();
+   fBits = bits;
+   fSlots = new TSlot[1LL << fBits];
+   memset(fSlots, 0, sizeof(TSlot) * (1LL << fBits));
+   for (Long64_t i = 0; i < oldcapacity; ++i) {
+      if (!oldslots[i].fIndex) continue;
+      ULong64_t slot = GetFirst(oldslots[i].fHash);
+      while (fSlots[slot].fIndex)
+         slot = GetNext(slot);
+      fSlots[slot] = oldslots[i];
+   }
+   delete [] oldslots;
+}
+
 //______________________________________________________________________________
 //
 // THnSparseArrayChunk is used internally by THnSparse.
@@ -567,21 +656,23 @@ void THnSparseArrayChunk::Sumw2()
 // the chunks is done by GetBin(). It creates a hash from the compacted bin
 // coordinates (the hash of a bin coordinate is the compacted coordinate itself
 // if it takes less than 8 bytes, the size of a Long64_t.
-// This hash is used to lookup the linear index in the TExMap member fBins;
-// the coordinates of the entry fBins points to is compared to the coordinates
-// passed to GetBin(). If they do not match, these two coordinates have the same
-// hash - which is extremely unlikely but (for the case where the compact bin
-// coordinates are larger than 4 bytes) possible. In this case, fBinsContinued
-// contains a chain of linear indexes with the same hash. Iterating through this
-// chain and comparing each bin coordinates with the one passed to GetBin() will
-// retrieve the matching bin.
+// This hash is used to lookup the linear index in the open addressing hash
+// table fBinIndex (see THnSparseBinIndex). When the compact coordinates fit
+// into 8 bytes the hash identifies the bin; otherwise the coordinates of the
+// bin a matching hash points to are compared to the coordinates passed to
+// GetBin(). If they do not match, these two coordinates have the same hash -
+// which is extremely unlikely but possible - and the probing continues to
+// the next slots.
+//
+// Many entries can be filled at once with FillN(); the bin coordinates of a
+// whole batch are then computed axis by axis.
 
 
 ClassImp(THnSparse);
 
 //______________________________________________________________________________
 THnSparse::THnSparse():
-   fChunkSize(1024), fFilledBins(0), fCompactCoord(0)
+   fChunkSize(1024), fFilledBins(0), fBinIndex(new THnSparseBinIndex), fCompactCoord(0)
 {
    // Construct an empty THnSparse.
    fBinContent.SetOwner();
@@ -592,7 +683,8 @@ THnSparse::THnSparse(const char* name, const char* title, Int_t dim,
                      const Int_t* nbins, const Double_t* xmin, const Double_t* xmax,
                      Int_t chunksize):
    THnBase(name, title, dim, nbins, xmin, xmax),
-   fChunkSize(chunksize), fFilledBins(0), fCompactCoord(0)
+   fChunkSize(chunksize), fFilledBins(0), fBinIndex(new THnSparseBinIndex),
+   fCompactCoord(0)
 {
    // Construct a THnSparse with "dim" dimensions,
    // with chunksize as the size of the chunks.
@@ -610,6 +702,7 @@ THnSparse::~THnSparse() {
    // Destruct a THnSparse
 
    delete fCompactCoord;
+   delete fBinIndex;
 }
 
 //______________________________________________________________________________
@@ -643,34 +736,26 @@ void THnSparse::InitStorage(Int_t* nbins, Int_t chunkSize)
 }
 
 //______________________________________________________________________________
-void THnSparse::FillExMap()
+void THnSparse::FillBinIndex()
 {
-   //We have been streamed; set up fBins
+   //We have been streamed; set up fBinIndex
    TIter iChunk(&fBinContent);
    THnSparseArrayChunk* chunk = 0;
    THnSparseCoordCompression compactCoord(*GetCompactCoord());
    Long64_t idx = 0;
-   if (2 * GetNbins() > fBins.Capacity())
-      fBins.Expand(3 * GetNbins());
+   fBinIndex->Expand(2 * GetNbins());
    while ((chunk = (THnSparseArrayChunk*) iChunk())) {
       const Int_t chunkSize = chunk->GetEntries();
       Char_t* buf = chunk->fCoordinates;
       const Int_t singleCoordSize = chunk->fSingleCoordinateSize;
       const Char_t* endbuf = buf + singleCoordSize * chunkSize;
       for (; buf < endbuf; buf += singleCoordSize, ++idx) {
-         Long64_t hash = compactCoord.GetHashFromBuffer(buf);
-         Long64_t linidx = fBins.GetValue(hash);
-         if (linidx) {
-            Long64_t nextidx = linidx;
-            while (nextidx) {
-               // must be a collision, so go to fBinsContinued.
-               linidx = nextidx;
-               nextidx = fBinsContinued.GetValue(linidx);
-            }
-            fBinsContinued.Add(linidx, idx + 1);
-         } else {
-            fBins.Add(hash, idx + 1);
-         }
+         ULong64_t hash = compactCoord.GetHashFromBuffer(buf);
+         // all bins are different: just find the first free slot
+         ULong64_t slot = fBinIndex->GetFirst(hash);
+         while (fBinIndex->GetSlot(slot).fIndex)
+            slot = fBinIndex->GetNext(slot);
+         fBinIndex->Add(slot, hash, idx);
       }
    }
 }
@@ -678,12 +763,10 @@ void THnSparse::FillExMap()
 //______________________________________________________________________________
 void THnSparse::Reserve(Long64_t nbins) {
    // Initialize storage for nbins
-   if (!fBins.GetSize() && fBinContent.GetSize()) {
-      FillExMap();
-   }
-   if (2 * nbins > fBins.Capacity()) {
-      fBins.Expand(3 * nbins);
+   if (!fBinIndex->GetSize() && GetNbins()) {
+      FillBinIndex();
    }
+   fBinIndex->Expand(2 * nbins);
 }
 
 //______________________________________________________________________________
@@ -752,6 +835,51 @@ Double_t THnSparse::GetBinContent(Long64_t idx, Int_t* coord /* = 0 */) const
    return 0.;
 }
 
+//______________________________________________________________________________
+void THnSparse::GetBinContents(Long64_t first, Int_t n, Double_t* content,
+                               Double_t* err2 /*= 0*/, Int_t* coord /*= 0*/) const
+{
+   // Get the content of the n filled bins starting at index first, see
+   // THnBase::GetBinContents(). The bins are read chunk by chunk, directly
+   // from the content arrays.
+
+   THnSparseCompactBinCoord* cc = GetCompactCoord();
+   const Int_t sizeCompact = cc->GetBufferSize();
+   const Bool_t haveErrors = GetCalculateErrors();
+   Int_t i = 0;
+   while (i < n) {
+      const Long64_t bin = first + i;
+      const THnSparseArrayChunk* chunk = GetChunk(bin / fChunkSize);
+      const Int_t idx = bin % fChunkSize;
+      const Int_t nchunk = TMath::Min(n - i, chunk->GetEntries() - idx);
+      if (nchunk <= 0) break;
+
+      const TArray* cont = chunk->fContent;
+      Double_t* out = content + i;
+      if (!CopyContentAsDouble<TArrayD>(cont, idx, nchunk, out)
+          && !CopyContentAsDouble<TArrayF>(cont, idx, nchunk, out)
+          && !CopyContentAsDouble<TArrayL>(cont, idx, nchunk, out)
+          && !CopyContentAsDouble<TArrayI>(cont, idx, nchunk, out)
+          && !CopyContentAsDouble<TArrayS>(cont, idx, nchunk, out)
+          && !CopyContentAsDouble<TArrayC>(cont, idx, nchunk, out)) {
+         for (Int_t k = 0; k < nchunk; ++k)
+            out[k] = cont->GetAt(idx + k);
+      }
+      if (err2) {
+         if (haveErrors)
+            memcpy(err2 + i, chunk->fSumw2->GetArray() + idx, nchunk * sizeof(Double_t));
+         else
+            memcpy(err2 + i, out, nchunk * sizeof(Double_t));
+      }
+      if (coord) {
+         const Char_t* buf = chunk->fCoordinates + idx * sizeCompact;
+         for (Int_t k = 0; k < nchunk; ++k, buf += sizeCompact)
+            cc->SetCoordFromBuffer(buf, coord + (i + k) * fNdimensions);
+      }
+      i += nchunk;
+   }
+}
+
 //______________________________________________________________________________
 Double_t THnSparse::GetBinError2(Long64_t linidx) const {
    // Get square of the error of bin addressed by linidx as
@@ -781,19 +909,24 @@ Long64_t THnSparse::GetBinIndexForCurrentBin(Bool_t allocate)
 
    THnSparseCompactBinCoord* cc = GetCompactCoord();
    ULong64_t hash = cc->GetHash();
-   if (fBinContent.GetSize() && !fBins.GetSize())
-      FillExMap();
-   Long64_t linidx = (Long64_t) fBins.GetValue(hash);
-   while (linidx) {
-      // fBins stores index + 1!
-      THnSparseArrayChunk* chunk = GetChunk((linidx - 1)/ fChunkSize);
-      if (chunk->Matches((linidx - 1) % fChunkSize, cc->GetBuffer()))
-         return linidx - 1; // we store idx+1, 0 is "TExMap: not found"
-
-      Long64_t nextlinidx = fBinsContinued.GetValue(linidx);
-      if (!nextlinidx) break;
-
-      linidx = nextlinidx;
+   if (GetNbins() && !fBinIndex->GetSize())
+      FillBinIndex();
+   if (!fBinIndex->GetCapacity()) {
+      if (!allocate) return -1;
+      fBinIndex->Expand(16);
+   }
+   // For compact coordinates up to 8 bytes the hash is the coordinate.
+   const Bool_t perfectHash = cc->GetBufferSize() <= 8;
+   ULong64_t slot = fBinIndex->GetFirst(hash);
+   while (Long64_t linidx = fBinIndex->GetSlot(slot).fIndex) {
+      // fBinIndex stores index + 1!
+      if (fBinIndex->GetSlot(slot).fHash == hash) {
+         if (perfectHash) return linidx - 1;
+         THnSparseArrayChunk* chunk = GetChunk((linidx - 1)/ fChunkSize);
+         if (chunk->Matches((linidx - 1) % fChunkSize, cc->GetBuffer()))
+            return linidx - 1;
+      }
+      slot = fBinIndex->GetNext(slot);
    }
    if (!allocate) return -1;
 
@@ -808,18 +941,9 @@ Long64_t THnSparse::GetBinIndexForCurrentBin(Bool_t allocate)
    }
    chunk->AddBin(newidx, cc->GetBuffer());
 
-   // store translation between hash and bin
+   // store translation between hash and bin in the free slot
    newidx += (fBinContent.GetEntriesFast() - 1) * fChunkSize;
-   if (!linidx) {
-      // fBins didn't find it
-      if (2 * GetNbins() > fBins.Capacity())
-         fBins.Expand(3 * GetNbins());
-      fBins.Add(hash, newidx + 1);
-   } else {
-      // fBins contains one, but it's the wrong one;
-      // add entry to fBinsContinued.
-      fBinsContinued.Add(linidx, newidx + 1);
-   }
+   fBinIndex->Add(slot, hash, newidx);
    return newidx;
 }
 
@@ -871,7 +995,7 @@ Double_t THnSparse::GetSparseFractionMem() const {
 
    Double_t size = 0.;
    size += fBinContent.GetEntries() * (GetChunkSize() * sizePerChunkElement + sizeof(THnSparseArrayChunk));
-   size += + 3 * sizeof(Long64_t) * fBins.GetSize() /* TExMap */;
+   size += sizeof(THnSparseBinIndex::TSlot) * fBinIndex->GetCapacity();
 
    Double_t nbinsTotal = 1.;
    for (Int_t d = 0; d < fNdimensions; ++d)
@@ -951,8 +1075,7 @@ void THnSparse::Reset(Option_t *option /*= ""*/)
 {
    // Clear the histogram
    fFilledBins = 0;
-   fBins.Delete();
-   fBinsContinued.Clear();
+   fBinIndex->Clear();
    fBinContent.Delete();
    ResetBase(option);
 }
@@ -18,6 +18,26 @@
    The algorithm is briefly described in (4) "Cranmer KS, Kernel Estimation in High-Energy
    Physics. Computer Physics Communications 136:198-207,2001" - e-Print Archive: hep ex/0011057.
    A binned version is also implemented to address the performance issue due to its data size dependance.
+
+   The way the estimate is evaluated is chosen with the option "Evaluation" (or SetEvaluation):
+    - "Direct" (default): the kernels of all the data (or bins) are summed for each point.
+    - "FastSum": only the data whose kernel is not zero at the point are summed. They are found
+      with a binary tree over the sorted data, which stores the range covered by the kernels
+      below each node. The result is the one of the direct sum, up to rounding errors. This is
+      available for the built-in kernels only (the Gaussian kernel is truncated at 9 bandwidths).
+    - "FFT": the data are binned linearly on a regular grid covering the support of all the
+      kernels, the estimate on the grid is the convolution of the binned data with the kernel,
+      computed with the FFT through TVirtualFFT (or directly if no FFT plugin is available), and
+      the estimate at any point is interpolated linearly between the grid points. The accuracy is
+      controlled by the number of grid points (SetFFTNPoints): by default the grid spacing is
+      about 1/32 of the bandwidth, for which the relative error is of the order of 1e-5 with
+      the Gaussian kernel and 1e-3 with the kernels of bounded support, which are not smooth at
+      their ends; it decreases as the square of the grid spacing. The FFT
+      requires a single bandwidth: with the adaptive iteration it is used for the pilot
+      estimate giving the adaptive bandwidths, and the final estimate is evaluated with
+      the fast summation (the direct sum for a user defined kernel).
+   GetValues evaluates the estimate at many points, using the threads of ROOT::Math::ThreadPool
+   (see ROOT::Math::ThreadPool::SetDefaultNThreads).
 */
 
 
@@ -32,27 +52,75 @@
 #include "Math/Integrator.h"
 #include "Math/QuantFuncMathCore.h"
 #include "Math/RichardsonDerivator.h"
+#include "Math/ThreadPool.h"
 #include "TGraphErrors.h"
 #include "TF1.h"
 #include "TCanvas.h"
+#include "TPluginManager.h"
+#include "TROOT.h"
+#include "TVirtualFFT.h"
 #include "TKDE.h"
 
 
 ClassImp(TKDE)
 
 class TKDE::TKernel {
+   enum { kLeafSize = 16 }; // Number of points per leaf of the fast summation tree
    TKDE* fKDE;
    UInt_t fNWeights; // Number of kernel weights (bandwidth as vectorized for binning)
    std::vector<Double_t> fWeights; // Kernel weights (bandwidth)
+   EEvaluation fEvaluation; // Evaluation method in use
+   std::vector<Double_t> fGrid; // Estimate on the grid for the FFT evaluation (not normalized)
+   Double_t fGridMin;  // Position of the first grid point
+   Double_t fGridStep; // Distance between the grid points
+   std::vector<Double_t> fPointX; // Points sorted by position for the fast summation
+   std::vector<Double_t> fPointW; // Weights of the points (negative for the asymmetric mirror images)
+   std::vector<Double_t> fPointH; // Bandwidths of the points
+   std::vector<Double_t> fNodeMin; // Lowest position covered by the kernels of the points below each tree node
+   std::vector<Double_t> fNodeMax; // Highest position covered by the kernels of the points below each tree node
+   UInt_t fNLeaves; // Number of leaves of the tree, a power of 2
+   void GetPoints(std::vector<Double_t>& x, std::vector<Double_t>& w, std::vector<Double_t>& h) const;
+   void ComputeGrid(Double_t support);
+   Bool_t ConvolveFFT(const std::vector<Double_t>& counts, const std::vector<Double_t>& kernelPos,
+                      const std::vector<Double_t>& kernelNeg, std::vector<Double_t>& result) const;
+   void BuildTree(Double_t support);
+   Double_t DirectSum(Double_t x) const;
+   Double_t GridSum(Double_t x) const;
+   Double_t TreeSum(Double_t x) const;
 public:
    TKernel(Double_t weight, TKDE* kde);
    void ComputeAdaptiveWeights();
+   void SetEvaluation(EEvaluation eval);
    Double_t operator()(Double_t x) const;
    Double_t GetWeight(Double_t x) const;
    Double_t GetFixedWeight() const;
    const std::vector<Double_t> & GetAdaptiveWeights() const;
 };
 
+namespace {
+
+class TKDEValuesTask : public ROOT::Math::ThreadPool::ITask {
+   // Evaluates a TKDE at a set of points, in chunks of kChunkSize points
+public:
+   enum { kChunkSize = 512 };
+   TKDEValuesTask(const TKDE& kde, UInt_t n, const Double_t* x, Double_t* values) :
+      fKDE(kde), fN(n), fX(x), fValues(values) {}
+   static UInt_t GetNTasks(UInt_t n) { return (n + kChunkSize - 1) / kChunkSize; }
+   virtual void Execute(unsigned int itask) {
+      const UInt_t first = itask * kChunkSize;
+      const UInt_t last = std::min(first + kChunkSize, fN);
+      for (UInt_t i = first; i < last; ++i)
+         fValues[i] = fKDE(fX[i]);
+   }
+private:
+   const TKDE& fKDE;
+   UInt_t fN;
+   const Double_t* fX;
+   Double_t* fValues;
+};
+
+}
+
 struct TKDE::KernelIntegrand {
    enum EIntegralResult{kNorm, kMu, kSigma2, kUnitIntegration};
    KernelIntegrand(const TKDE* kde, EIntegralResult intRes);
@@ -63,6 +131,8 @@ private:
 };
 
 TKDE::TKDE(UInt_t events, const Double_t* data, Double_t xMin, Double_t xMax, const Option_t* option, Double_t rho) :
+   fKernelFunction(0),
+   fKernel(0),
    fData(events, 0.0),
    fEvents(events, 0.0),
    fPDF(0),
@@ -75,6 +145,7 @@ TKDE::TKDE(UInt_t events, const Double_t* data, Double_t xMin, Double_t xMax, co
    fNBins(events < 10000 ? 100: events / 10),
    fNEvents(events),
    fUseBinsNEvents(10000),
+   fFFTNPoints(0),
    fMean(0.0),
    fSigma(0.0),
    fXMin(xMin),
@@ -82,7 +153,7 @@ TKDE::TKDE(UInt_t events, const Double_t* data, Double_t xMin, Double_t xMax, co
    fAdaptiveBandwidthFactor(1.0),
    fCanonicalBandwidths(std::vector<Double_t>(kTotalKernels, 0.0)),
    fKernelSigmas2(std::vector<Double_t>(kTotalKernels, -1.0)),
-   fSettedOptions(std::vector<Bool_t>(4, kFALSE))
+   fSettedOptions(std::vector<Bool_t>(5, kFALSE))
 {
    //Class constructor
    SetOptions(option, rho);
@@ -111,6 +182,8 @@ void TKDE::Instantiate(KernelFunction_Ptr kernfunc, UInt_t events, const Double_
    // Template's constructor surrogate
    fData = std::vector<Double_t>(events, 0.0);
    fEvents = std::vector<Double_t>(events, 0.0);
+   fKernelFunction = 0;
+   fKernel = 0;
    fPDF = 0;
    fUpperPDF = 0;
    fLowerPDF = 0;
@@ -118,6 +191,7 @@ void TKDE::Instantiate(KernelFunction_Ptr kernfunc, UInt_t events, const Double_
    fNBins = events < 10000 ? 100 : events / 10;
    fNEvents = events;
    fUseBinsNEvents = 10000;
+   fFFTNPoints = 0;
    fMean = 0.0;
    fSigma = 0.0;
    fXMin = xMin;
@@ -126,7 +200,7 @@ void TKDE::Instantiate(KernelFunction_Ptr kernfunc, UInt_t events, const Double_
    fAdaptiveBandwidthFactor = 1.;
    fCanonicalBandwidths = std::vector<Double_t>(kTotalKernels, 0.0);
    fKernelSigmas2 = std::vector<Double_t>(kTotalKernels, -1.0);
-   fSettedOptions = std::vector<Bool_t>(4, kFALSE);
+   fSettedOptions = std::vector<Bool_t>(5, kFALSE);
    SetOptions(option, rho);
    CheckOptions(kTRUE);
    SetMirror();
@@ -143,7 +217,7 @@ void TKDE::SetOptions(const Option_t* option, Double_t rho) {
    TString opt = option;
    opt.ToLower();
    std::string options = opt.Data();
-   size_t numOpt = 4;
+   size_t numOpt = 5;
    std::vector<std::string> voption(numOpt, "");
    for (std::vector<std::string>::iterator it = voption.begin(); it != voption.end() && !options.empty(); ++it) {
       size_t pos = options.find_last_of(';');
@@ -272,6 +346,18 @@ void TKDE::GetOptions(std::string optionType, std::string option) {
          this->Warning("GetOptions", "Unknown binning option: setting to RelaxedBinning");
          fBinning = kRelaxedBinning;
       }
+   } else if (optionType.compare("evaluation") == 0) {
+      fSettedOptions[4] = kTRUE;
+      if (option.compare("direct") == 0) {
+         fEvaluation = kDirect;
+      } else if (option.compare("fastsum") == 0) {
+         fEvaluation = kFastSum;
+      } else if (option.compare("fft") == 0) {
+         fEvaluation = kFFT;
+      } else {
+         this->Warning("GetOptions", "Unknown evaluation option: setting to Direct");
+         fEvaluation = kDirect;
+      }
    }
 }
 
@@ -289,6 +375,9 @@ void TKDE::AssureOptions() {
    if (!fSettedOptions[3]) {
       fBinning = kRelaxedBinning;
    }
+   if (!fSettedOptions[4]) {
+      fEvaluation = kDirect;
+   }
 }
 
 void TKDE::CheckOptions(Bool_t isUserDefinedKernel) {
@@ -308,6 +397,14 @@ void TKDE::CheckOptions(Bool_t isUserDefinedKernel) {
       Warning("CheckOptions", "Illegal user binning type input - use default value !");
       fBinning = kRelaxedBinning;
    }
+   if (!(fEvaluation >= kDirect && fEvaluation <= kFFT)) {
+      Warning("CheckOptions", "Illegal user evaluation type input - use default value !");
+      fEvaluation = kDirect;
+   }
+   if (fEvaluation == kFastSum && fKernelType == kUserDefined) {
+      Warning("CheckOptions", "Fast summation is not available for a user defined kernel - use direct evaluation !");
+      fEvaluation = kDirect;
+   }
    if (fRho <= 0.0) {
       Warning("CheckOptions", "Tuning factor rho cannot be non-positive - use default value !");
       fRho = 1.0;
@@ -375,6 +472,22 @@ void TKDE::SetUseBinsNEvents(UInt_t nEvents) {
    SetKernel();
 }
 
+void TKDE::SetEvaluation(EEvaluation eval) {
+   // Sets User option for the evaluation method of the estimate
+   fEvaluation = eval;
+   CheckOptions(fKernelType == kUserDefined);
+   SetKernel();
+}
+
+void TKDE::SetFFTNPoints(UInt_t npoints) {
+   // Sets User option for the number of grid points of the FFT evaluation.
+   // The error of the estimate decreases as the square of the grid spacing;
+   // 0 (default) chooses a spacing of about 1/32 of the bandwidth.
+   // The number of points is rounded up to a power of 2.
+   fFFTNPoints = npoints;
+   SetKernel();
+}
+
 void TKDE::SetTuneFactor(Double_t rho) {
    // Factor which can be used to tune the smoothing.
    // It is used as multiplicative factor for the fixed and adaptive bandwidth.
@@ -520,9 +633,13 @@ void TKDE::SetKernel() {
    // Optimal bandwidth (Silverman's rule of thumb with assumed Gaussian density)
    Double_t weight(fCanonicalBandwidths[kGaussian] * fSigmaRob * std::pow(3. / (8. * std::sqrt(M_PI)) * n, -0.2));
    weight *= fRho * fCanonicalBandwidths[fKernelType] / fCanonicalBandwidths[kGaussian];
+   delete fKernel;
    fKernel = new TKernel(weight, this);
+   fKernel->SetEvaluation(fEvaluation);
    if (fIteration == kAdaptive) {
       fKernel->ComputeAdaptiveWeights();
+      // the bandwidths differ now: the FFT cannot be used for the final estimate
+      fKernel->SetEvaluation(fEvaluation);
    }
 }
 
@@ -619,6 +736,16 @@ Double_t TKDE::operator()(Double_t x) const {
    return (*fKernel)(x);
 }
 
+void TKDE::GetValues(UInt_t n, const Double_t* x, Double_t* values) const {
+   // Evaluates the kernel density estimate at the n points x and stores the
+   // results in values. The points are distributed to the threads of
+   // ROOT::Math::ThreadPool (see ROOT::Math::ThreadPool::SetDefaultNThreads);
+   // a user defined kernel must then support concurrent calls.
+   if (fNewData) (const_cast<TKDE*>(this))->InitFromNewData();
+   TKDEValuesTask task(*this, n, x, values);
+   ROOT::Math::ThreadPool::Run(task, TKDEValuesTask::GetNTasks(n));
+}
+
 Double_t TKDE::GetMean() const {
    // return the mean of the data
    if (fNewData) (const_cast<TKDE*>(this))->InitFromNewData();
@@ -641,7 +768,11 @@ TKDE::TKernel::TKernel(Double_t weight, TKDE* kde) :
    // Internal class constructor
    fKDE(kde),
    fNWeights(kde->fData.size()),
-   fWeights(fNWeights, weight)
+   fWeights(fNWeights, weight),
+   fEvaluation(kDirect),
+   fGridMin(0.0),
+   fGridStep(0.0),
+   fNLeaves(0)
 {}
 
 void TKDE::TKernel::ComputeAdaptiveWeights() {
@@ -752,7 +883,9 @@ TGraphErrors* TKDE::GetGraphWithErrors(UInt_t npx, double xmin, double xmax) {
    Double_t* ey = new Double_t[n + 1];
    for (UInt_t i = 0; i <= n; ++i) {
       x[i] = xmin + i * (xmax - xmin) / n;
-      y[i] = (*this)(x[i]);
+   }
+   GetValues(n + 1, x, y);
+   for (UInt_t i = 0; i <= n; ++i) {
       ex[i] = 0;
       ey[i] = this->GetError(x[i]);
    }
@@ -814,6 +947,22 @@ const std::vector<Double_t> & TKDE::TKernel::GetAdaptiveWeights() const {
 
 Double_t TKDE::TKernel::operator()(Double_t x) const {
    // The internal class's unary function: returns the kernel density estimate
+   Double_t result;
+   switch (fEvaluation) {
+      case kFFT:
+         result = GridSum(x);
+         break;
+      case kFastSum:
+         result = TreeSum(x);
+         break;
+      default:
+         result = DirectSum(x);
+   }
+   return result / fKDE->fNEvents;
+}
+
+Double_t TKDE::TKernel::DirectSum(Double_t x) const {
+   // Returns the sum of the kernels of all the data at x
    Double_t result(0.0);
    UInt_t n = fKDE->fData.size();
    Bool_t useBins = (fKDE->fBinCount.size() == n);
@@ -827,7 +976,229 @@ Double_t TKDE::TKernel::operator()(Double_t x) const {
          result -= binCount / fWeights[i] * (*fKDE->fKernelFunction)((x - (2. * fKDE->fXMax - fKDE->fData[i])) / fWeights[i]);
       }
    }
-   return result / fKDE->fNEvents;
+   return result;
+}
+
+void TKDE::TKernel::SetEvaluation(EEvaluation eval) {
+   // Prepares the evaluation of the estimate with the method eval. The FFT
+   // needs the same bandwidth for all the data, the fast summation a kernel
+   // of known support: the fast summation, respectively the direct sum, is
+   // used otherwise.
+   std::vector<Double_t>().swap(fGrid);
+   std::vector<Double_t>().swap(fPointX);
+   std::vector<Double_t>().swap(fPointW);
+   std::vector<Double_t>().swap(fPointH);
+   std::vector<Double_t>().swap(fNodeMin);
+   std::vector<Double_t>().swap(fNodeMax);
+   fNLeaves = 0;
+   fEvaluation = kDirect;
+   if (fWeights.empty() || eval == kDirect) return;
+   Double_t support = fKDE->GetKernelSupport();
+   if (eval == kFFT && *std::min_element(fWeights.begin(), fWeights.end()) == *std::max_element(fWeights.begin(), fWeights.end())) {
+      ComputeGrid(support);
+      fEvaluation = kFFT;
+   } else if (support > 0.0) {
+      BuildTree(support);
+      fEvaluation = kFastSum;
+   }
+}
+
+void TKDE::TKernel::GetPoints(std::vector<Double_t>& x, std::vector<Double_t>& w, std::vector<Double_t>& h) const {
+   // Gets the position, weight and bandwidth of the kernels summed in the
+   // estimate: the data (or bins) and their asymmetric mirror images, which
+   // are subtracted
+   UInt_t n = fKDE->fData.size();
+   Bool_t useBins = (fKDE->fBinCount.size() == n);
+   UInt_t nCopies = 1 + fKDE->fAsymLeft + fKDE->fAsymRight;
+   x.reserve(nCopies * n);
+   w.reserve(nCopies * n);
+   h.reserve(nCopies * n);
+   for (UInt_t i = 0; i < n; ++i) {
+      Double_t binCount = (useBins) ? fKDE->fBinCount[i] : 1.0;
+      x.push_back(fKDE->fData[i]);
+      w.push_back(binCount);
+      h.push_back(fWeights[i]);
+      if (fKDE->fAsymLeft) {
+         x.push_back(2. * fKDE->fXMin - fKDE->fData[i]);
+         w.push_back(-binCount);
+         h.push_back(fWeights[i]);
+      }
+      if (fKDE->fAsymRight) {
+         x.push_back(2. * fKDE->fXMax - fKDE->fData[i]);
+         w.push_back(-binCount);
+         h.push_back(fWeights[i]);
+      }
+   }
+}
+
+void TKDE::TKernel::ComputeGrid(Double_t support) {
+   // Computes the estimate on a regular grid covering the kernels of all the
+   // data: the data are binned linearly on the grid and convolved with the
+   // kernel sampled at the grid spacing. For a kernel of unknown support the
+   // grid extends 5 bandwidths beyond the data; the estimate is computed
+   // directly outside.
+   std::vector<Double_t> x, w, h;
+   GetPoints(x, w, h);
+   const Double_t bandwidth = fWeights[0];
+   const Double_t reach = (support > 0.0 ? support : 5.) * bandwidth;
+   const Double_t xmin = *std::min_element(x.begin(), x.end()) - reach;
+   const Double_t xmax = *std::max_element(x.begin(), x.end()) + reach;
+   const UInt_t kMaxNPoints = 1 << 22;
+   Double_t npointsWanted = fKDE->fFFTNPoints;
+   if (npointsWanted < 2.) npointsWanted = 32. * (xmax - xmin) / bandwidth + 1.;
+   UInt_t npoints = 256;
+   while (npoints < npointsWanted && npoints < kMaxNPoints) npoints *= 2;
+   fGridMin = xmin;
+   fGridStep = (xmax - xmin) / (npoints - 1);
+
+   std::vector<Double_t> counts(npoints, 0.0);
+   for (UInt_t i = 0; i < x.size(); ++i) {
+      Double_t t = (x[i] - xmin) / fGridStep;
+      UInt_t j = std::min(UInt_t(t), npoints - 2);
+      Double_t f = t - j;
+      counts[j] += w[i] * (1. - f);
+      counts[j + 1] += w[i] * f;
+   }
+
+   // kernel at positive and negative multiples of the grid spacing
+   UInt_t nlags = npoints - 1;
+   if (support > 0.0) nlags = std::min(nlags, UInt_t(support * bandwidth / fGridStep) + 1);
+   std::vector<Double_t> kernelPos(nlags + 1), kernelNeg(nlags + 1);
+   for (UInt_t l = 0; l <= nlags; ++l) {
+      kernelPos[l] = (*fKDE->fKernelFunction)(l * fGridStep / bandwidth) / bandwidth;
+      kernelNeg[l] = (*fKDE->fKernelFunction)(-(l * fGridStep) / bandwidth) / bandwidth;
+   }
+
+   fGrid.assign(npoints, 0.0);
+   if (ConvolveFFT(counts, kernelPos, kernelNeg, fGrid)) return;
+   for (UInt_t j = 0; j < npoints; ++j) {
+      if (counts[j] == 0.0) continue;
+      UInt_t lmax = std::min(nlags, npoints - 1 - j);
+      for (UInt_t l = 0; l <= lmax; ++l)
+         fGrid[j + l] += counts[j] * kernelPos[l];
+      lmax = std::min(nlags, j);
+      for (UInt_t l = 1; l <= lmax; ++l)
+         fGrid[j - l] += counts[j] * kernelNeg[l];
+   }
+}
+
+Bool_t TKDE::TKernel::ConvolveFFT(const std::vector<Double_t>& counts, const std::vector<Double_t>& kernelPos,
+                                  const std::vector<Double_t>& kernelNeg, std::vector<Double_t>& result) const {
+   // Computes the linear convolution of counts with the kernel through
+   // TVirtualFFT, on twice as many points to avoid the circular wrap around.
+   // Returns false if no FFT implementation is available.
+   TPluginHandler* h = gROOT->GetPluginManager()->FindHandler("TVirtualFFT", "fftwr2c");
+   if (!h || h->CheckPlugin() == -1) return kFALSE;
+   Int_t n = 2 * counts.size();
+   TVirtualFFT* r2c = TVirtualFFT::FFT(1, &n, "R2C ES K");
+   TVirtualFFT* c2r = TVirtualFFT::FFT(1, &n, "C2R ES K");
+   if (!r2c || !c2r) {
+      delete r2c;
+      delete c2r;
+      return kFALSE;
+   }
+   UInt_t nc = n / 2 + 1;
+   std::vector<Double_t> in(n, 0.0);
+   std::vector<Double_t> countsRe(nc), countsIm(nc), kernelRe(nc), kernelIm(nc);
+   std::copy(counts.begin(), counts.end(), in.begin());
+   r2c->SetPoints(&in[0]);
+   r2c->Transform();
+   r2c->GetPointsComplex(&countsRe[0], &countsIm[0]);
+   in.assign(n, 0.0);
+   in[0] = kernelPos[0];
+   for (UInt_t l = 1; l < kernelPos.size(); ++l) {
+      in[l] = kernelPos[l];
+      in[n - l] = kernelNeg[l];
+   }
+   r2c->SetPoints(&in[0]);
+   r2c->Transform();
+   r2c->GetPointsComplex(&kernelRe[0], &kernelIm[0]);
+   for (UInt_t k = 0; k < nc; ++k) {
+      // the backward transform is not normalized
+      Double_t re = (countsRe[k] * kernelRe[k] - countsIm[k] * kernelIm[k]) / n;
+      Double_t im = (countsRe[k] * kernelIm[k] + countsIm[k] * kernelRe[k]) / n;
+      countsRe[k] = re;
+      countsIm[k] = im;
+   }
+   c2r->SetPointsComplex(&countsRe[0], &countsIm[0]);
+   c2r->Transform();
+   c2r->GetPoints(&in[0]);
+   std::copy(in.begin(), in.begin() + result.size(), result.begin());
+   delete r2c;
+   delete c2r;
+   return kTRUE;
+}
+
+Double_t TKDE::TKernel::GridSum(Double_t x) const {
+   // Returns the sum of the kernels at x, interpolated linearly between the
+   // grid points
+   Double_t t = (x - fGridMin) / fGridStep;
+   UInt_t npoints = fGrid.size();
+   if (!(t >= 0. && t <= npoints - 1.)) {
+      return fKDE->GetKernelSupport() > 0.0 ? 0.0 : DirectSum(x);
+   }
+   UInt_t j = std::min(UInt_t(t), npoints - 2);
+   Double_t f = t - j;
+   return fGrid[j] + f * (fGrid[j + 1] - fGrid[j]);
+}
+
+void TKDE::TKernel::BuildTree(Double_t support) {
+   // Sorts the kernels by position, and builds a complete binary tree over
+   // leaves of kLeafSize kernels. Each node stores the range covered by the
+   // kernels below it, of half width support times their bandwidth.
+   std::vector<Double_t> x, w, h;
+   GetPoints(x, w, h);
+   UInt_t n = x.size();
+   std::vector<std::pair<Double_t, UInt_t> > order(n);
+   for (UInt_t i = 0; i < n; ++i) order[i] = std::make_pair(x[i], i);
+   std::sort(order.begin(), order.end());
+   fPointX.resize(n);
+   fPointW.resize(n);
+   fPointH.resize(n);
+   for (UInt_t i = 0; i < n; ++i) {
+      fPointX[i] = x[order[i].second];
+      fPointW[i] = w[order[i].second];
+      fPointH[i] = h[order[i].second];
+   }
+
+   UInt_t nleaves = (n + kLeafSize - 1) / kLeafSize;
+   fNLeaves = 1;
+   while (fNLeaves < nleaves) fNLeaves *= 2;
+   fNodeMin.assign(2 * fNLeaves, std::numeric_limits<Double_t>::infinity());
+   fNodeMax.assign(2 * fNLeaves, -std::numeric_limits<Double_t>::infinity());
+   for (UInt_t i = 0; i < n; ++i) {
+      UInt_t leaf = fNLeaves + i / kLeafSize;
+      fNodeMin[leaf] = std::min(fNodeMin[leaf], fPointX[i] - support * fPointH[i]);
+      fNodeMax[leaf] = std::max(fNodeMax[leaf], fPointX[i] + support * fPointH[i]);
+   }
+   for (UInt_t node = fNLeaves - 1; node > 0; --node) {
+      fNodeMin[node] = std::min(fNodeMin[2 * node], fNodeMin[2 * node + 1]);
+      fNodeMax[node] = std::max(fNodeMax[2 * node], fNodeMax[2 * node + 1]);
+   }
+}
+
+Double_t TKDE::TKernel::TreeSum(Double_t x) const {
+   // Returns the sum of the kernels at x, visiting only the tree nodes whose
+   // kernels cover x
+   Double_t result(0.0);
+   UInt_t n = fPointX.size();
+   UInt_t stack[2 * 32 + 1];
+   Int_t nstack = 0;
+   stack[nstack++] = 1;
+   while (nstack > 0) {
+      UInt_t node = stack[--nstack];
+      if (x < fNodeMin[node] || x > fNodeMax[node]) continue;
+      if (node < fNLeaves) {
+         stack[nstack++] = 2 * node + 1;
+         stack[nstack++] = 2 * node;
+         continue;
+      }
+      UInt_t first = (node - fNLeaves) * kLeafSize;
+      UInt_t last = std::min(first + kLeafSize, n);
+      for (UInt_t i = first; i < last; ++i)
+         result += fPointW[i] / fPointH[i] * (*fKDE->fKernelFunction)((x - fPointX[i]) / fPointH[i]);
+   }
+   return result;
 }
 
 UInt_t TKDE::Index(Double_t x) const {
@@ -942,6 +1313,20 @@ Double_t TKDE::ComputeKernelIntegral() const {
    return result;
 }
 
+Double_t TKDE::GetKernelSupport() const {
+   // Returns the half width of the kernel support, 0 if not known (user defined kernel)
+   switch (fKernelType) {
+      case kGaussian :
+         return 9.; // see GaussianKernel
+      case kEpanechnikov :
+      case kBiweight :
+      case kCosineArch :
+         return 1.;
+      default :
+         return 0.;
+   }
+}
+
 Double_t TKDE::ComputeMidspread () {
    // Computes the inter-quartile range from the data
    std::sort(fEvents.begin(), fEvents.end());
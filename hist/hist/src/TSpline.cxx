@@ -28,6 +28,8 @@
 #include "TClass.h"
 #include "TMath.h"
 
+#include <vector>
+
 ClassImp(TSplinePoly)
 ClassImp(TSplinePoly3)
 ClassImp(TSplinePoly5)
@@ -365,6 +367,11 @@ void TSplinePoly5::CopyPoly(TSplinePoly5 const &other)
 // Arbitrary conditions can be introduced for first and second          //
 // derivatives at beginning and ending points                           //
 //                                                                      //
+// The knots and the polynomial coefficients are stored in contiguous   //
+// arrays. Eval(n,x,y) evaluates the spline at many abscissas, reusing  //
+// the interval of the previous one. For equidistant knots the interval //
+// is computed instead of searched.                                     //
+//                                                                      //
 //////////////////////////////////////////////////////////////////////////
 
 
@@ -373,7 +380,8 @@ TSpline3::TSpline3(const char *title,
                    Double_t x[], Double_t y[], Int_t n, const char *opt,
                    Double_t valbeg, Double_t valend) :
   TSpline(title,-1,x[0],x[n-1],n,kFALSE),
-  fValBeg(valbeg), fValEnd(valend), fBegCond(0), fEndCond(0)
+  fPoly(0), fValBeg(valbeg), fValEnd(valend), fBegCond(0), fEndCond(0),
+  fKnotX(0), fKnotY(0), fB(0), fC(0), fD(0), fInvStep(0)
 {
    // Third spline creator given an array of
    // arbitrary knots in increasing abscissa order and
@@ -386,10 +394,10 @@ TSpline3::TSpline3(const char *title,
 
    // Create the plynomial terms and fill
    // them with node information
-   fPoly = new TSplinePoly3[n];
+   AllocateCoeff();
    for (Int_t i=0; i<n; ++i) {
-      fPoly[i].X() = x[i];
-      fPoly[i].Y() = y[i];
+      fKnotX[i] = x[i];
+      fKnotY[i] = y[i];
    }
 
    // Build the spline coefficients
@@ -402,8 +410,9 @@ TSpline3::TSpline3(const char *title,
                    Double_t y[], Int_t n, const char *opt,
                    Double_t valbeg, Double_t valend) :
   TSpline(title,(xmax-xmin)/(n-1), xmin, xmax, n, kTRUE),
-  fValBeg(valbeg), fValEnd(valend),
-  fBegCond(0), fEndCond(0)
+  fPoly(0), fValBeg(valbeg), fValEnd(valend),
+  fBegCond(0), fEndCond(0), fKnotX(0), fKnotY(0), fB(0), fC(0), fD(0),
+  fInvStep(0)
 {
    // Third spline creator given an array of
    // arbitrary function values on equidistant n abscissa
@@ -416,10 +425,10 @@ TSpline3::TSpline3(const char *title,
 
    // Create the plynomial terms and fill
    // them with node information
-   fPoly = new TSplinePoly3[n];
+   AllocateCoeff();
    for (Int_t i=0; i<n; ++i) {
-      fPoly[i].X() = fXmin+i*fDelta;
-      fPoly[i].Y() = y[i];
+      fKnotX[i] = fXmin+i*fDelta;
+      fKnotY[i] = y[i];
    }
 
    // Build the spline coefficients
@@ -432,8 +441,9 @@ TSpline3::TSpline3(const char *title,
                    Double_t x[], const TF1 *func, Int_t n, const char *opt,
                    Double_t valbeg, Double_t valend) :
   TSpline(title,-1, x[0], x[n-1], n, kFALSE),
-  fValBeg(valbeg), fValEnd(valend),
-  fBegCond(0), fEndCond(0)
+  fPoly(0), fValBeg(valbeg), fValEnd(valend),
+  fBegCond(0), fEndCond(0), fKnotX(0), fKnotY(0), fB(0), fC(0), fD(0),
+  fInvStep(0)
 {
    // Third spline creator given an array of
    // arbitrary abscissas in increasing order and a function
@@ -446,10 +456,10 @@ TSpline3::TSpline3(const char *title,
 
    // Create the plynomial terms and fill
    // them with node information
-   fPoly = new TSplinePoly3[n];
+   AllocateCoeff();
    for (Int_t i=0; i<n; ++i) {
-      fPoly[i].X() = x[i];
-      fPoly[i].Y() = ((TF1*)func)->Eval(x[i]);
+      fKnotX[i] = x[i];
+      fKnotY[i] = ((TF1*)func)->Eval(x[i]);
    }
 
    // Build the spline coefficients
@@ -463,8 +473,9 @@ TSpline3::TSpline3(const char *title,
                    const TF1 *func, Int_t n, const char *opt,
                    Double_t valbeg, Double_t valend) :
   TSpline(title,(xmax-xmin)/(n-1), xmin, xmax, n, kTRUE),
-  fValBeg(valbeg), fValEnd(valend),
-  fBegCond(0), fEndCond(0)
+  fPoly(0), fValBeg(valbeg), fValEnd(valend),
+  fBegCond(0), fEndCond(0), fKnotX(0), fKnotY(0), fB(0), fC(0), fD(0),
+  fInvStep(0)
 {
    // Third spline creator given a function to be
    // evaluated on n equidistand abscissa points between xmin
@@ -477,14 +488,14 @@ TSpline3::TSpline3(const char *title,
 
    // Create the plynomial terms and fill
    // them with node information
-   fPoly = new TSplinePoly3[n];
+   AllocateCoeff();
    //when func is null we return. In this case it is assumed that the spline
    //points will be given later via SetPoint and SetPointCoeff
    if (!func) {fKstep = kFALSE; fDelta = -1; return;}
    for (Int_t i=0; i<n; ++i) {
       Double_t x=fXmin+i*fDelta;
-      fPoly[i].X() = x;
-      fPoly[i].Y() = ((TF1*)func)->Eval(x);
+      fKnotX[i] = x;
+      fKnotY[i] = ((TF1*)func)->Eval(x);
    }
 
    // Build the spline coefficients
@@ -497,8 +508,9 @@ TSpline3::TSpline3(const char *title,
                    const TGraph *g, const char *opt,
                    Double_t valbeg, Double_t valend) :
   TSpline(title,-1,0,0,g->GetN(),kFALSE),
-  fValBeg(valbeg), fValEnd(valend),
-  fBegCond(0), fEndCond(0)
+  fPoly(0), fValBeg(valbeg), fValEnd(valend),
+  fBegCond(0), fEndCond(0), fKnotX(0), fKnotY(0), fB(0), fC(0), fD(0),
+  fInvStep(0)
 {
    // Third spline creator given a TGraph with
    // abscissa in increasing order and possibly end
@@ -511,15 +523,15 @@ TSpline3::TSpline3(const char *title,
 
    // Create the plynomial terms and fill
    // them with node information
-   fPoly = new TSplinePoly3[fNp];
+   AllocateCoeff();
    for (Int_t i=0; i<fNp; ++i) {
       Double_t xx, yy;
       g->GetPoint(i,xx,yy);
-      fPoly[i].X()=xx;
-      fPoly[i].Y()=yy;
+      fKnotX[i]=xx;
+      fKnotY[i]=yy;
    }
-   fXmin = fPoly[0].X();
-   fXmax = fPoly[fNp-1].X();
+   fXmin = fKnotX[0];
+   fXmax = fKnotX[fNp-1];
 
    // Build the spline coefficients
    BuildCoeff();
@@ -530,8 +542,9 @@ TSpline3::TSpline3(const char *title,
 TSpline3::TSpline3(const TH1 *h, const char *opt,
                    Double_t valbeg, Double_t valend) :
   TSpline(h->GetTitle(),-1,0,0,h->GetNbinsX(),kFALSE),
-  fValBeg(valbeg), fValEnd(valend),
-  fBegCond(0), fEndCond(0)
+  fPoly(0), fValBeg(valbeg), fValEnd(valend),
+  fBegCond(0), fEndCond(0), fKnotX(0), fKnotY(0), fB(0), fC(0), fD(0),
+  fInvStep(0)
 {
    // Third spline creator given a TH1 
 
@@ -542,13 +555,13 @@ TSpline3::TSpline3(const TH1 *h, const char *opt,
 
    // Create the plynomial terms and fill
    // them with node information
-   fPoly = new TSplinePoly3[fNp];
+   AllocateCoeff();
    for (Int_t i=0; i<fNp; ++i) {
-      fPoly[i].X()=h->GetXaxis()->GetBinCenter(i+1);
-      fPoly[i].Y()=h->GetBinContent(i+1);
+      fKnotX[i]=h->GetXaxis()->GetBinCenter(i+1);
+      fKnotY[i]=h->GetBinContent(i+1);
    }
-   fXmin = fPoly[0].X();
-   fXmax = fPoly[fNp-1].X();
+   fXmin = fKnotX[0];
+   fXmax = fKnotX[fNp-1];
 
    // Build the spline coefficients
    BuildCoeff();
@@ -562,12 +575,15 @@ TSpline3::TSpline3(const TSpline3& sp3) :
   fValBeg(sp3.fValBeg),
   fValEnd(sp3.fValEnd),
   fBegCond(sp3.fBegCond),
-  fEndCond(sp3.fEndCond)
+  fEndCond(sp3.fEndCond),
+  fKnotX(0), fKnotY(0), fB(0), fC(0), fD(0),
+  fInvStep(sp3.fInvStep)
 {
    //copy constructor
-   if (fNp > 0) fPoly = new TSplinePoly3[fNp];
-   for (Int_t i=0; i<fNp; ++i) 
-      fPoly[i] = sp3.fPoly[i];
+   if (fNp > 0) {
+      AllocateCoeff();
+      memcpy(fKnotX, sp3.fKnotX, 5*fNp*sizeof(Double_t));
+   }
 }
 
 
@@ -577,10 +593,15 @@ TSpline3& TSpline3::operator=(const TSpline3& sp3)
    //assignment operator
    if(this!=&sp3) {
       TSpline::operator=(sp3);
+      if (fPoly) delete [] fPoly;
       fPoly= 0;
-      if (fNp > 0) fPoly = new TSplinePoly3[fNp];
-      for (Int_t i=0; i<fNp; ++i) 
-         fPoly[i] = sp3.fPoly[i];
+      if (fKnotX) delete [] fKnotX;
+      fKnotX = fKnotY = fB = fC = fD = 0;
+      if (fNp > 0) {
+         AllocateCoeff();
+         memcpy(fKnotX, sp3.fKnotX, 5*fNp*sizeof(Double_t));
+      }
+      fInvStep=sp3.fInvStep;
       
       fValBeg=sp3.fValBeg;
       fValEnd=sp3.fValEnd;
@@ -774,31 +795,28 @@ Int_t TSpline3::FindX(Double_t x) const
    if(x<=fXmin) klow=0;
    else if(x>=fXmax) klow=khig;
    else {
-      if(fKstep) {
+      if(fInvStep > 0) {
          //
          // Equidistant knots, use histogramming
-         klow = TMath::FloorNint((x-fXmin)/fDelta);
+         klow = TMath::Min(TMath::Max(Int_t((x-fKnotX[0])*fInvStep),0),khig);
          // Correction for rounding errors
-         if (x < fPoly[klow].X())
-            klow = TMath::Max(klow-1,0);
-         else if (klow < khig) {
-            if (x > fPoly[klow+1].X()) ++klow;
-         }
+         while (klow > 0 && x < fKnotX[klow]) --klow;
+         while (klow < khig && x > fKnotX[klow+1]) ++klow;
       } else {
          Int_t khalf;
          //
          // Non equidistant knots, binary search
          while(khig-klow>1)
-            if(x>fPoly[khalf=(klow+khig)/2].X())
+            if(x>fKnotX[khalf=(klow+khig)/2])
                klow=khalf;
             else
                khig=khalf;
          //
          // This could be removed, sanity check
-         if(!(fPoly[klow].X()<=x && x<=fPoly[klow+1].X()))
+         if(!(fKnotX[klow]<=x && x<=fKnotX[klow+1]))
             Error("Eval",
                   "Binary search failed x(%d) = %f < x= %f < x(%d) = %f\n",
-                  klow,fPoly[klow].X(),x,klow+1,fPoly[klow+1].X());
+                  klow,fKnotX[klow],x,klow+1,fKnotX[klow+1]);
       }
    }
    return klow;
@@ -812,7 +830,31 @@ Double_t TSpline3::Eval(Double_t x) const
 
    Int_t klow=FindX(x);
    if (klow >= fNp-1) klow = fNp-2; //see: https://savannah.cern.ch/bugs/?71651
-   return fPoly[klow].Eval(x);
+   Double_t dx=x-fKnotX[klow];
+   return (fKnotY[klow]+dx*(fB[klow]+dx*(fC[klow]+dx*fD[klow])));
+}
+
+
+//______________________________________________________________________________
+void TSpline3::Eval(Int_t n, const Double_t *x, Double_t *y) const
+{
+   // Eval this spline at the n abscissas x and store the values in y.
+   // Same as y[i] = Eval(x[i]), but for non equidistant knots the interval
+   // of the previous abscissa is tried before searching, which avoids the
+   // binary search when the abscissas are sorted or close to each other.
+
+   Int_t klow = -1;
+   for (Int_t i=0; i<n; ++i) {
+      Double_t xx = x[i];
+      // the interval found by FindX for fXmin < xx < fXmax
+      if (klow < 0 || fInvStep > 0 || !(xx > fXmin && xx < fXmax &&
+          xx > fKnotX[klow] && xx <= fKnotX[klow+1])) {
+         klow=FindX(xx);
+         if (klow >= fNp-1) klow = fNp-2;
+      }
+      Double_t dx=xx-fKnotX[klow];
+      y[i] = fKnotY[klow]+dx*(fB[klow]+dx*(fC[klow]+dx*fD[klow]));
+   }
 }
 
 
@@ -823,7 +865,8 @@ Double_t TSpline3::Derivative(Double_t x) const
 
    Int_t klow=FindX(x);
    if (klow >= fNp-1) klow = fNp-2; //see: https://savannah.cern.ch/bugs/?71651
-   return fPoly[klow].Derivative(x);
+   Double_t dx=x-fKnotX[klow];
+   return (fB[klow]+2*fC[klow]*dx+3*fD[klow]*dx*dx);
 }
 
 
@@ -861,7 +904,7 @@ void TSpline3::SaveAs(const char *filename, Option_t * /*option*/) const
    Int_t i;
    char numb[20];
    for (i=0;i<fNp;i++) {
-      snprintf(numb,20," %g,",fPoly[i].X());
+      snprintf(numb,20," %g,",fKnotX[i]);
       nch = strlen(numb);
       if (i == fNp-1) numb[nch-1]=0;
       strlcat(buffer,numb,512);
@@ -877,7 +920,7 @@ void TSpline3::SaveAs(const char *filename, Option_t * /*option*/) const
    nch = strlen(buffer); f->write(buffer,nch);
    buffer[0] = 0;
    for (i=0;i<fNp;i++) {
-      snprintf(numb,20," %g,",fPoly[i].Y());
+      snprintf(numb,20," %g,",fKnotY[i]);
       nch = strlen(numb);
       if (i == fNp-1) numb[nch-1]=0;
       strlcat(buffer,numb,512);
@@ -893,7 +936,7 @@ void TSpline3::SaveAs(const char *filename, Option_t * /*option*/) const
    nch = strlen(buffer); f->write(buffer,nch);
    buffer[0] = 0;
    for (i=0;i<fNp;i++) {
-      snprintf(numb,20," %g,",fPoly[i].B());
+      snprintf(numb,20," %g,",fB[i]);
       nch = strlen(numb);
       if (i == fNp-1) numb[nch-1]=0;
       strlcat(buffer,numb,512);
@@ -909,7 +952,7 @@ void TSpline3::SaveAs(const char *filename, Option_t * /*option*/) const
    nch = strlen(buffer); f->write(buffer,nch);
    buffer[0] = 0;
    for (i=0;i<fNp;i++) {
-      snprintf(numb,20," %g,",fPoly[i].C());
+      snprintf(numb,20," %g,",fC[i]);
       nch = strlen(numb);
       if (i == fNp-1) numb[nch-1]=0;
       strlcat(buffer,numb,512);
@@ -925,7 +968,7 @@ void TSpline3::SaveAs(const char *filename, Option_t * /*option*/) const
    nch = strlen(buffer); f->write(buffer,nch);
    buffer[0] = 0;
    for (i=0;i<fNp;i++) {
-      snprintf(numb,20," %g,",fPoly[i].D());
+      snprintf(numb,20," %g,",fD[i]);
       nch = strlen(numb);
       if (i == fNp-1) numb[nch-1]=0;
       strlcat(buffer,numb,512);
@@ -1011,8 +1054,8 @@ void TSpline3::SavePrimitive(std::ostream &out, Option_t *option /*= ""*/)
    if (fNpx != 100) out<<"   spline3->SetNpx("<<fNpx<<");"<<std::endl;
 
    for (Int_t i=0;i<fNp;i++) {
-      out<<"   spline3->SetPoint("<<i<<","<<fPoly[i].X()<<","<<fPoly[i].Y()<<");"<<std::endl;
-      out<<"   spline3->SetPointCoeff("<<i<<","<<fPoly[i].B()<<","<<fPoly[i].C()<<","<<fPoly[i].D()<<");"<<std::endl;
+      out<<"   spline3->SetPoint("<<i<<","<<fKnotX[i]<<","<<fKnotY[i]<<");"<<std::endl;
+      out<<"   spline3->SetPointCoeff("<<i<<","<<fB[i]<<","<<fC[i]<<","<<fD[i]<<");"<<std::endl;
    }
    out<<"   spline3->Draw("<<quote<<option<<quote<<");"<<std::endl;
 }
@@ -1024,8 +1067,10 @@ void TSpline3::SetPoint(Int_t i, Double_t x, Double_t y)
    //set point number i.
    
    if (i < 0 || i >= fNp) return;
-   fPoly[i].X()= x;
-   fPoly[i].Y()= y;
+   fKnotX[i]= x;
+   fKnotY[i]= y;
+   // the knots may not be equidistant any more
+   fInvStep = 0;
 }
 
 //______________________________________________________________________________
@@ -1034,9 +1079,9 @@ void TSpline3::SetPointCoeff(Int_t i, Double_t b, Double_t c, Double_t d)
    // set point coefficient number i
  
    if (i < 0 || i >= fNp) return;
-   fPoly[i].B()= b;
-   fPoly[i].C()= c;
-   fPoly[i].D()= d;
+   fB[i]= b;
+   fC[i]= c;
+   fD[i]= d;
 }
 
 //______________________________________________________________________________
@@ -1082,42 +1127,42 @@ void TSpline3::BuildCoeff()
    // compute first differences of x sequence and store in C also,
    // compute first divided difference of data and store in D.
    for (m=1; m<fNp ; ++m) {
-      fPoly[m].C() = fPoly[m].X() - fPoly[m-1].X();
-      fPoly[m].D() = (fPoly[m].Y() - fPoly[m-1].Y())/fPoly[m].C();
+      fC[m] = fKnotX[m] - fKnotX[m-1];
+      fD[m] = (fKnotY[m] - fKnotY[m-1])/fC[m];
    }
    // construct first equation from the boundary condition, of the form
    //             D[0]*s[0] + C[0]*s[1] = B[0]
    if(fBegCond==0) {
       if(fNp == 2) {
          //     no condition at left end and n = 2.
-         fPoly[0].D() = 1.;
-         fPoly[0].C() = 1.;
-         fPoly[0].B() = 2.*fPoly[1].D();
+         fD[0] = 1.;
+         fC[0] = 1.;
+         fB[0] = 2.*fD[1];
       } else {
          //     not-a-knot condition at left end and n .gt. 2.
-         fPoly[0].D() = fPoly[2].C();
-         fPoly[0].C() = fPoly[1].C() + fPoly[2].C();
-         fPoly[0].B() =((fPoly[1].C()+2.*fPoly[0].C())*fPoly[1].D()*fPoly[2].C()+fPoly[1].C()*fPoly[1].C()*fPoly[2].D())/fPoly[0].C();
+         fD[0] = fC[2];
+         fC[0] = fC[1] + fC[2];
+         fB[0] =((fC[1]+2.*fC[0])*fD[1]*fC[2]+fC[1]*fC[1]*fD[2])/fC[0];
       }
    } else if (fBegCond==1) {
       //     slope prescribed at left end.
-      fPoly[0].B() = fValBeg;
-      fPoly[0].D() = 1.;
-      fPoly[0].C() = 0.;
+      fB[0] = fValBeg;
+      fD[0] = 1.;
+      fC[0] = 0.;
    } else if (fBegCond==2) {
       //     second derivative prescribed at left end.
-      fPoly[0].D() = 2.;
-      fPoly[0].C() = 1.;
-      fPoly[0].B() = 3.*fPoly[1].D() - fPoly[1].C()/2.*fValBeg;
+      fD[0] = 2.;
+      fC[0] = 1.;
+      fB[0] = 3.*fD[1] - fC[1]/2.*fValBeg;
    }
    if(fNp > 2) {
       //  if there are interior knots, generate the corresp. equations and car-
       //  ry out the forward pass of gauss elimination, after which the m-th
       //  equation reads    D[m]*s[m] + C[m]*s[m+1] = B[m].
       for (m=1; m<l; ++m) {
-         g = -fPoly[m+1].C()/fPoly[m-1].D();
-         fPoly[m].B() = g*fPoly[m-1].B() + 3.*(fPoly[m].C()*fPoly[m+1].D()+fPoly[m+1].C()*fPoly[m].D());
-         fPoly[m].D() = g*fPoly[m-1].C() + 2.*(fPoly[m].C() + fPoly[m+1].C());
+         g = -fC[m+1]/fD[m-1];
+         fB[m] = g*fB[m-1] + 3.*(fC[m]*fD[m+1]+fC[m+1]*fD[m]);
+         fD[m] = g*fC[m-1] + 2.*(fC[m] + fC[m+1]);
       }
       // construct last equation from the second boundary condition, of the form
       //           (-g*D[n-2])*s[n-2] + D[n-1]*s[n-1] = B[n-1]
@@ -1128,68 +1173,85 @@ void TSpline3::BuildCoeff()
          if (fNp > 3 || fBegCond != 0) {
             //     not-a-knot and n .ge. 3, and either n.gt.3 or  also not-a-knot at
             //     left end point.
-            g = fPoly[fNp-2].C() + fPoly[fNp-1].C();
-            fPoly[fNp-1].B() = ((fPoly[fNp-1].C()+2.*g)*fPoly[fNp-1].D()*fPoly[fNp-2].C()
-                         + fPoly[fNp-1].C()*fPoly[fNp-1].C()*(fPoly[fNp-2].Y()-fPoly[fNp-3].Y())/fPoly[fNp-2].C())/g;
-            g = -g/fPoly[fNp-2].D();
-            fPoly[fNp-1].D() = fPoly[fNp-2].C();
+            g = fC[fNp-2] + fC[fNp-1];
+            fB[fNp-1] = ((fC[fNp-1]+2.*g)*fD[fNp-1]*fC[fNp-2]
+                         + fC[fNp-1]*fC[fNp-1]*(fKnotY[fNp-2]-fKnotY[fNp-3])/fC[fNp-2])/g;
+            g = -g/fD[fNp-2];
+            fD[fNp-1] = fC[fNp-2];
          } else {
             //     either (n=3 and not-a-knot also at left) or (n=2 and not not-a-
             //     knot at left end point).
-            fPoly[fNp-1].B() = 2.*fPoly[fNp-1].D();
-            fPoly[fNp-1].D() = 1.;
-            g = -1./fPoly[fNp-2].D();
+            fB[fNp-1] = 2.*fD[fNp-1];
+            fD[fNp-1] = 1.;
+            g = -1./fD[fNp-2];
          }
       } else if (fEndCond == 1) {
-         fPoly[fNp-1].B() = fValEnd;
+         fB[fNp-1] = fValEnd;
          goto L30;
       } else if (fEndCond == 2) {
          //     second derivative prescribed at right endpoint.
-         fPoly[fNp-1].B() = 3.*fPoly[fNp-1].D() + fPoly[fNp-1].C()/2.*fValEnd;
-         fPoly[fNp-1].D() = 2.;
-         g = -1./fPoly[fNp-2].D();
+         fB[fNp-1] = 3.*fD[fNp-1] + fC[fNp-1]/2.*fValEnd;
+         fD[fNp-1] = 2.;
+         g = -1./fD[fNp-2];
       }
    } else {
       if(fEndCond == 0) {
          if (fBegCond > 0) {
             //     either (n=3 and not-a-knot also at left) or (n=2 and not not-a-
             //     knot at left end point).
-            fPoly[fNp-1].B() = 2.*fPoly[fNp-1].D();
-            fPoly[fNp-1].D() = 1.;
-            g = -1./fPoly[fNp-2].D();
+            fB[fNp-1] = 2.*fD[fNp-1];
+            fD[fNp-1] = 1.;
+            g = -1./fD[fNp-2];
          } else {
             //     not-a-knot at right endpoint and at left endpoint and n = 2.
-            fPoly[fNp-1].B() = fPoly[fNp-1].D();
+            fB[fNp-1] = fD[fNp-1];
             goto L30;
          }
       } else if(fEndCond == 1) {
-         fPoly[fNp-1].B() = fValEnd;
+         fB[fNp-1] = fValEnd;
          goto L30;
       } else if(fEndCond == 2) {
          //     second derivative prescribed at right endpoint.
-         fPoly[fNp-1].B() = 3.*fPoly[fNp-1].D() + fPoly[fNp-1].C()/2.*fValEnd;
-         fPoly[fNp-1].D() = 2.;
-         g = -1./fPoly[fNp-2].D();
+         fB[fNp-1] = 3.*fD[fNp-1] + fC[fNp-1]/2.*fValEnd;
+         fD[fNp-1] = 2.;
+         g = -1./fD[fNp-2];
       }
    }
    // complete forward pass of gauss elimination.
-   fPoly[fNp-1].D() = g*fPoly[fNp-2].C() + fPoly[fNp-1].D();
-   fPoly[fNp-1].B() = (g*fPoly[fNp-2].B() + fPoly[fNp-1].B())/fPoly[fNp-1].D();
+   fD[fNp-1] = g*fC[fNp-2] + fD[fNp-1];
+   fB[fNp-1] = (g*fB[fNp-2] + fB[fNp-1])/fD[fNp-1];
    // carry out back substitution
 L30: j = l-1;
    do {
-      fPoly[j].B() = (fPoly[j].B() - fPoly[j].C()*fPoly[j+1].B())/fPoly[j].D();
+      fB[j] = (fB[j] - fC[j]*fB[j+1])/fD[j];
       --j;
    }  while (j>=0);
    //****** generate cubic coefficients in each interval, i.e., the deriv.s
    //  at its left endpoint, from value and slope at its endpoints.
    for (i=1; i<fNp; ++i) {
-      dtau = fPoly[i].C();
-      divdf1 = (fPoly[i].Y() - fPoly[i-1].Y())/dtau;
-      divdf3 = fPoly[i-1].B() + fPoly[i].B() - 2.*divdf1;
-      fPoly[i-1].C() = (divdf1 - fPoly[i-1].B() - divdf3)/dtau;
-      fPoly[i-1].D() = (divdf3/dtau)/dtau;
+      dtau = fC[i];
+      divdf1 = (fKnotY[i] - fKnotY[i-1])/dtau;
+      divdf3 = fB[i-1] + fB[i] - 2.*divdf1;
+      fC[i-1] = (divdf1 - fB[i-1] - divdf3)/dtau;
+      fD[i-1] = (divdf3/dtau)/dtau;
    }
+   CheckStep();
+}
+
+
+//______________________________________________________________________________
+void TSpline3::CheckStep()
+{
+   // Set fInvStep if the knots are equidistant up to rounding errors, so that
+   // FindX computes the interval instead of searching it.
+
+   fInvStep = 0;
+   if (fNp < 2) return;
+   Double_t step = (fKnotX[fNp-1]-fKnotX[0])/(fNp-1);
+   if (!(step > 0)) return;
+   for (Int_t i=1; i<fNp-1; ++i)
+      if (TMath::Abs(fKnotX[i]-(fKnotX[0]+i*step)) > 1e-6*step) return;
+   fInvStep = 1./step;
 }
 
 
@@ -1203,6 +1265,7 @@ void TSpline3::Streamer(TBuffer &R__b)
       Version_t R__v = R__b.ReadVersion(&R__s, &R__c);
       if (R__v > 1) {
          R__b.ReadClassBuffer(TSpline3::Class(), this, R__v, R__s, R__c);
+         PolyToArrays();
          return;
       }
       //====process old versions before automatic schema evolution
@@ -1218,9 +1281,71 @@ void TSpline3::Streamer(TBuffer &R__b)
       R__b >> fValEnd;
       R__b >> fBegCond;
       R__b >> fEndCond;
+      PolyToArrays();
    } else {
+      // the polynomial terms are written as an array of TSplinePoly3: fPoly
+      // refers to a temporary copy of the arrays while writing
+      std::vector<TSplinePoly3> poly(fNp > 0 ? fNp : 0);
+      if (!poly.empty()) ArraysToPoly(&poly[0]);
+      fPoly = poly.empty() ? 0 : &poly[0];
       R__b.WriteClassBuffer(TSpline3::Class(),this);
+      fPoly = 0;
+   }
+}
+
+
+//______________________________________________________________________________
+void TSpline3::AllocateCoeff()
+{
+   // Allocate the arrays of knots and coefficients as a single block of
+   // 5*fNp values initialized to 0.
+
+   fKnotX = new Double_t[5*fNp];
+   memset(fKnotX, 0, 5*fNp*sizeof(Double_t));
+   fKnotY = fKnotX + fNp;
+   fB = fKnotY + fNp;
+   fC = fB + fNp;
+   fD = fC + fNp;
+}
+
+
+//______________________________________________________________________________
+void TSpline3::ArraysToPoly(TSplinePoly3 *poly) const
+{
+   // Fill the fNp polynomial terms poly from the arrays of knots and
+   // coefficients, for writing.
+
+   for (Int_t i=0; i<fNp; ++i) {
+      poly[i].X() = fKnotX[i];
+      poly[i].Y() = fKnotY[i];
+      poly[i].B() = fB[i];
+      poly[i].C() = fC[i];
+      poly[i].D() = fD[i];
+   }
+}
+
+
+//______________________________________________________________________________
+void TSpline3::PolyToArrays()
+{
+   // Move the polynomial terms read in fPoly to the arrays of knots and
+   // coefficients and delete fPoly.
+
+   if (fKnotX) delete [] fKnotX;
+   fKnotX = fKnotY = fB = fC = fD = 0;
+   fInvStep = 0;
+   if (fNp > 0 && fPoly) {
+      AllocateCoeff();
+      for (Int_t i=0; i<fNp; ++i) {
+         fPoly[i].GetKnot(fKnotX[i], fKnotY[i]);
+         fB[i] = fPoly[i].B();
+         fC[i] = fPoly[i].C();
+         fD[i] = fPoly[i].D();
+      }
+      CheckStep();
    }
+   if (fPoly) delete [] fPoly;
+   fPoly = 0;
 }
 
 
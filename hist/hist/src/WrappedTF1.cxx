@@ -14,6 +14,7 @@
 #include "Math/WrappedMultiTF1.h"
 
 #include <cmath>
+#include <vector>
 
 
 namespace ROOT { 
@@ -28,6 +29,7 @@ double WrappedMultiTF1::fgEps = 0.001;
 WrappedTF1::WrappedTF1 ( TF1 & f  )  : 
    fLinear(false), 
    fPolynomial(false),
+   fParGradient(false),
    fFunc(&f), 
    fX (), 
    fParams(f.GetParameters(),f.GetParameters()+f.GetNpar())
@@ -50,6 +52,8 @@ WrappedTF1::WrappedTF1 ( TF1 & f  )  :
          ip++;
       }
    }      
+   // use the analytic derivatives of the formula functions
+   fParGradient = !fLinear && fFunc->HasParGradient();
 }
 
 WrappedTF1::WrappedTF1(const WrappedTF1 & rhs) :
@@ -58,6 +62,7 @@ WrappedTF1::WrappedTF1(const WrappedTF1 & rhs) :
    IGrad(), 
    fLinear(rhs.fLinear), 
    fPolynomial(rhs.fPolynomial),
+   fParGradient(rhs.fParGradient),
    fFunc(rhs.fFunc), 
    fX(),
    fParams(rhs.fParams)
@@ -71,6 +76,7 @@ WrappedTF1 & WrappedTF1::operator = (const WrappedTF1 & rhs) {
    if (this == &rhs) return *this;  // time saving self-test
    fLinear = rhs.fLinear;  
    fPolynomial = rhs.fPolynomial; 
+   fParGradient = rhs.fParGradient; 
    fFunc = rhs.fFunc; 
    fFunc->InitArgs(fX, &fParams.front() );
    fParams = rhs.fParams;
@@ -80,6 +86,11 @@ WrappedTF1 & WrappedTF1::operator = (const WrappedTF1 & rhs) {
 void  WrappedTF1::ParameterGradient(double x, const double * par, double * grad ) const {
    // evaluate the derivative of the function with respect to the parameters 
    if (!fLinear) { 
+      if (fParGradient) { 
+         // analytic derivatives of the formula
+         fX[0] = x; 
+         if (fFunc->EvalParGradient(fX, par, grad) ) return; 
+      }
       // need to set parameter values
       fFunc->SetParameters( par );
       // no need to call InitArgs (it is called in TF1::GradientPar)
@@ -107,6 +118,11 @@ double WrappedTF1::DoParameterDerivative(double x, const double * p, unsigned in
    //  so in case of fLinear (or fPolynomial) a non-zero value will be returned for fixed parameters
 
    if (! fLinear ) {  
+      if (fParGradient) { 
+         std::vector<double> grad(NPar()); 
+         fX[0] = x; 
+         if (fFunc->EvalParGradient(fX, p, &grad.front()) ) return grad[ipar]; 
+      }
       fFunc->SetParameters( p );
       return fFunc->GradientPar(ipar, &x,fgEps);
    }
@@ -136,6 +152,7 @@ double WrappedTF1::GetDerivPrecision( ) { return fgEps; }
 WrappedMultiTF1::WrappedMultiTF1 (TF1 & f, unsigned int dim  )  : 
    fLinear(false), 
    fPolynomial(false), 
+   fParGradient(false),
    fFunc(&f),
    fDim(dim),
    fParams(f.GetParameters(),f.GetParameters()+f.GetNpar())
@@ -161,6 +178,8 @@ WrappedMultiTF1::WrappedMultiTF1 (TF1 & f, unsigned int dim  )  :
       fLinear = true; 
       fPolynomial = true; 
    }
+   // use the analytic derivatives of the formula functions
+   fParGradient = !fLinear && fFunc->HasParGradient();
 }
 
 
@@ -169,6 +188,7 @@ WrappedMultiTF1::WrappedMultiTF1(const WrappedMultiTF1 & rhs) :
    BaseParamFunc(),
    fLinear(rhs.fLinear), 
    fPolynomial(rhs.fPolynomial), 
+   fParGradient(rhs.fParGradient),
    fFunc(rhs.fFunc),
    fDim(rhs.fDim),
    fParams(rhs.fParams) 
@@ -182,6 +202,7 @@ WrappedMultiTF1 & WrappedMultiTF1::operator= (const WrappedMultiTF1 & rhs) {
    if (this == &rhs) return *this;  // time saving self-test
    fLinear = rhs.fLinear;  
    fPolynomial = rhs.fPolynomial;  
+   fParGradient = rhs.fParGradient;  
    fFunc = rhs.fFunc; 
    fDim = rhs.fDim;
    fParams = rhs.fParams;
@@ -196,10 +217,12 @@ void  WrappedMultiTF1::ParameterGradient(const double * x, const double * par, d
    //  so in case of fLinear (or fPolynomial) a non-zero value will be returned for fixed parameters
 
    if (!fLinear) { 
-      // need to set parameter values
-      fFunc->SetParameters( par );
-      // no need to call InitArgs (it is called in TF1::GradientPar)
-      fFunc->GradientPar(x,grad,fgEps);
+      // analytic derivatives of the formula
+      if (fParGradient && fFunc->EvalParGradient(x, par, grad) ) return; 
+      // numerical derivatives, without modifying the TF1
+      std::vector<double> p(par, par + NPar() ); 
+      for (unsigned int i = 0; i < p.size(); ++i) 
+         grad[i] = DoNumParameterDerivative(x, &p.front(), i);
    }
    else {  // case of linear functions
       unsigned int np = NPar();
@@ -208,12 +231,32 @@ void  WrappedMultiTF1::ParameterGradient(const double * x, const double * par, d
    }
 }
 
+void WrappedMultiTF1::DoEvalParVec(unsigned int n, const double * const * x, const double * p, double * y) const { 
+   // evaluate the function on n points. 
+   // For one-dimensional functions use TF1::EvalParVec, otherwise evaluate the TF1 point by point 
+   // initializing only once the arguments of interpreted functions
+   if (fDim == 1) { 
+      fFunc->EvalParVec(n, x[0], p, y); 
+      return; 
+   }
+   std::vector<double> point(fDim); 
+   if (fFunc->GetMethodCall() )  fFunc->InitArgs(&point.front(),p);  
+   for (unsigned int i = 0; i < n; ++i) { 
+      for (unsigned int j = 0; j < fDim; ++j) point[j] = x[j][i]; 
+      y[i] = fFunc->EvalPar(&point.front(),p); 
+   }
+}
+
 double WrappedMultiTF1::DoParameterDerivative(const double * x, const double * p, unsigned int ipar ) const { 
    // evaluate the derivative of the function with respect to parameter ipar
    // see note above concerning the fixed parameters
    if (! fLinear ) {  
-      fFunc->SetParameters( p );
-      return fFunc->GradientPar(ipar, x,fgEps);
+      if (fParGradient) { 
+         std::vector<double> grad(NPar()); 
+         if (fFunc->EvalParGradient(x, p, &grad.front()) ) return grad[ipar]; 
+      }
+      std::vector<double> par(p, p + NPar() ); 
+      return DoNumParameterDerivative(x, &par.front(), ipar);
    }
    if (fPolynomial) { 
       // case of polynomial function (no parameter dependency)  (case for dim = 1)
@@ -230,6 +273,33 @@ double WrappedMultiTF1::DoParameterDerivative(const double * x, const double * p
    }
 }
 
+double WrappedMultiTF1::DoNumParameterDerivative(const double * x, double * p, unsigned int ipar ) const { 
+   // evaluate numerically the derivative with respect to parameter ipar with the same 
+   // method as TF1::GradientPar, but varying the parameter in the array p (restored at 
+   // the end) instead of the parameters of the TF1, which is then not modified. 
+   // The derivative is zero for fixed parameters
+   double al, bl; 
+   fFunc->GetParLimits(ipar, al, bl); 
+   if (al*bl != 0 && al >= bl) return 0;
+
+   double eps = (fgEps < 1e-10 || fgEps > 1) ? 0.01 : fgEps; 
+   double h = (fFunc->GetParError(ipar) != 0) ? eps * fFunc->GetParError(ipar) : eps; 
+
+   double par0 = p[ipar]; 
+   if (fFunc->GetMethodCall() )  fFunc->InitArgs(x,p);  // needed for interpreted functions 
+   p[ipar] = par0 + h;     double f1 = fFunc->EvalPar(x,p);
+   p[ipar] = par0 - h;     double f2 = fFunc->EvalPar(x,p);
+   p[ipar] = par0 + h/2;   double g1 = fFunc->EvalPar(x,p);
+   p[ipar] = par0 - h/2;   double g2 = fFunc->EvalPar(x,p);
+   p[ipar] = par0; 
+
+   // Richardson extrapolation of the central differences
+   double h2 = 1/(2.*h);
+   double d0 = f1 - f2;
+   double d2 = 2*(g1 - g2);
+   return h2*(4*d2 - d0)/3.;
+}
+
 void WrappedMultiTF1::SetDerivPrecision(double eps) { fgEps = eps; }
 
 double WrappedMultiTF1::GetDerivPrecision( ) { return fgEps; }
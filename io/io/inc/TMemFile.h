@@ -19,6 +19,10 @@
 // A TMemFile is like a normal TFile except that it reads and writes    //
 // its data via in memory.                                              //
 //                                                                      //
+// The amount of memory used by a TMemFile can be bounded with          //
+// SetMaxMemory; the least recently used blocks are then spilled to a   //
+// local temporary file and transparently reloaded when accessed.       //
+//                                                                      //
 //////////////////////////////////////////////////////////////////////////
 
 #ifndef ROOT_TFile
@@ -38,21 +42,35 @@ private:
       ~TMemBlock();
 
       void CreateNext(Long64_t size);
-      
+      Bool_t IsSpilled() const { return fBuffer == 0 && fSpillOffset >= 0; }
+
       TMemBlock *fPrevious;
       TMemBlock *fNext;
       UChar_t   *fBuffer;
       Long64_t   fSize;
+      Long64_t   fSpillOffset; // Offset of the block in the spill file, -1 if never spilled
+      ULong64_t  fLastUsed;    // Value of the file access counter at the last use of the block
+      Bool_t     fDirty;       // True if the content differs from the spilled copy
    };
    TMemBlock    fBlockList;   // Colletion of memory blocks of size fBlockSize
    Long64_t     fSize;        // Total file size (sum of the size of the chunks)
    Long64_t     fSysOffset;   // Seek offset in file
    TMemBlock   *fBlockSeek;   // Pointer to the block we seeked to.
    Long64_t     fBlockOffset; // Seek offset within the block
+   Long64_t     fMaxMemory;   // Maximum size of the blocks kept in memory, 0 means no limit
+   Long64_t     fInMemory;    // Size of the blocks currently kept in memory
+   ULong64_t    fAccessCounter; // Number of block accesses, used to find the least recently used block
+   TString      fSpillDir;    // Directory where to create the spill file, empty for the system default
+   TString      fSpillName;   // Name of the temporary file receiving the spilled blocks
+   Int_t        fSpillFD;     // Descriptor of the spill file, -1 if not yet created
+   Long64_t     fSpillSize;   // Current size of the spill file
 
    static Long64_t fgDefaultBlockSize;
 
    Long64_t MemRead(Int_t fd, void *buf, Long64_t len) const;
+   UChar_t *LoadBlock(TMemBlock *block);
+   void     MakeRoom(Long64_t size, const TMemBlock *keep);
+   Bool_t   SpillBlock(TMemBlock *block);
 
    // Overload TFile interfaces.
    Int_t    SysOpen(const char *pathname, Int_t flags, UInt_t mode);
@@ -77,6 +95,12 @@ public:
    virtual void     CopyTo(TBuffer &tobuf) const;
    virtual Long64_t GetSize() const;
 
+   Int_t            GetNBlocks() const;
+   const UChar_t   *GetBlock(Int_t index, Long64_t &size) const;
+   Long64_t         GetMaxMemory() const { return fMaxMemory; }
+   Long64_t         GetMemoryUsage() const { return fInMemory; }
+   void             SetMaxMemory(Long64_t maxbytes, const char *spilldir = 0);
+
    void ResetAfterMerge(TFileMergeInfo *);
    void ResetErrno() const;
 
@@ -110,6 +110,7 @@ private:
    TStreamerInfoActions::TActionSequence *fWriteMemberWise;     //! List of write action resulting from the compilation for use in member wise streaming.
 
    static  Int_t     fgCount;            //Number of TStreamerInfo instances
+   static  Bool_t    fgGenerateCode;     //True if the streaming actions are to be replaced by generated code
    static TStreamerElement *fgElement;   //Pointer to current TStreamerElement
    static Double_t   GetValueAux(Int_t type, void *ladd, int k, Int_t len);
    static void       PrintValueAux(char *ladd, Int_t atype, TStreamerElement * aElement, Int_t aleng, Int_t *count);
@@ -190,8 +191,10 @@ public:
    Bool_t              CompareContent(TClass *cl,TVirtualStreamerInfo *info, Bool_t warn, Bool_t complete);
    void                Compile();
    void                ComputeSize();
+   Bool_t              CompileStreamerCode();
    void                ForceWriteInfo(TFile *file, Bool_t force=kFALSE);
    Int_t               GenerateHeaderFile(const char *dirname, const TList *subClasses = 0, const TList *extrainfos = 0);
+   Int_t               GenerateStreamerCode(TString &code) const;
    TClass             *GetActualClass(const void *obj) const;
    TClass             *GetClass() const {return fClass;}
    UInt_t              GetCheckSum() const {return fCheckSum;}
@@ -275,6 +278,8 @@ public:
    virtual TClassStreamer *GenExplicitClassStreamer( const ::ROOT::TCollectionProxyInfo &info, TClass *cl );
 
    static TStreamerElement   *GetCurrentElement();
+   static Bool_t       GetGenerateStreamerCode();
+   static Bool_t       SetGenerateStreamerCode(Bool_t enable = kTRUE);
 
 
 #ifdef R__BROKEN_FUNCTION_TEMPLATES
@@ -120,6 +120,11 @@ namespace TStreamerInfoActions {
       ClassDef(TConfiguredAction,0); // A configured action
    };
    
+   // Registry of the streaming functions generated by TStreamerInfo::GenerateStreamerCode
+   // (either compiled into a library or just-in-time compiled by the interpreter).
+   void                  RegisterGeneratedAction(const char *name, TStreamerInfoAction_t action);
+   TStreamerInfoAction_t GetGeneratedAction(const char *name);
+
    typedef std::vector<TConfiguredAction> ActionContainer_t;
    class TActionSequence : public TObject {
       TActionSequence() {};
@@ -146,6 +151,8 @@ namespace TStreamerInfoActions {
       TActionSequence *CreateCopy();      
       static TActionSequence *CreateReadMemberWiseActions(TVirtualStreamerInfo *info, TVirtualCollectionProxy &proxy);
       static TActionSequence *CreateWriteMemberWiseActions(TVirtualStreamerInfo *info, TVirtualCollectionProxy &proxy);
+      static TActionSequence *GetSharedReadMemberWiseActions(TVirtualStreamerInfo *info, TVirtualCollectionProxy &proxy);
+      static void             RemoveSharedActions(const TVirtualStreamerInfo *info);
       TActionSequence *CreateSubSequence(const std::vector<Int_t> &element_ids, size_t offset);      
       
       void Print(Option_t * = "") const;
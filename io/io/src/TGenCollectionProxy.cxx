@@ -1578,7 +1578,7 @@ TStreamerInfoActions::TActionSequence *TGenCollectionProxy::GetConversionReadMem
    if (info == 0) {
       return 0;
    }
-   result = TStreamerInfoActions::TActionSequence::CreateReadMemberWiseActions(info,*this);
+   result = TStreamerInfoActions::TActionSequence::GetSharedReadMemberWiseActions(info,*this);
 
    if (!arr) {
       arr = new TObjArray(version+10, -1);
@@ -1609,7 +1609,7 @@ TStreamerInfoActions::TActionSequence *TGenCollectionProxy::GetReadMemberWiseAct
       if (valueClass) {
          info = valueClass->GetStreamerInfo(version);
       }
-      result = TStreamerInfoActions::TActionSequence::CreateReadMemberWiseActions(info,*this);
+      result = TStreamerInfoActions::TActionSequence::GetSharedReadMemberWiseActions(info,*this);
       fReadMemberWise->AddAtAndExpand(result,version);
    }
    return result;
@@ -16,6 +16,14 @@
 // A TMemFile is like a normal TFile except that it reads and writes    //
 // only from memory.                                                    //
 //                                                                      //
+// The content is stored in a list of blocks.  By default all the       //
+// blocks stay in memory; after a call to SetMaxMemory, the least       //
+// recently used blocks are written to a local temporary file whenever //
+// the memory used would exceed the limit and are transparently read    //
+// back when accessed.  GetNBlocks and GetBlock give direct access to   //
+// the blocks (for example to upload the file content without making a  //
+// contiguous copy of it).                                              //
+//                                                                      //
 //////////////////////////////////////////////////////////////////////////
 
 #include "TMemFile.h"
@@ -44,14 +52,16 @@ ClassImp(TMemFile)
 Long64_t TMemFile::fgDefaultBlockSize = 2*1024*1024;
 
 //______________________________________________________________________________
-TMemFile::TMemBlock::TMemBlock() : fPrevious(0), fNext(0), fBuffer(0), fSize(0)
+TMemFile::TMemBlock::TMemBlock() : fPrevious(0), fNext(0), fBuffer(0), fSize(0),
+   fSpillOffset(-1), fLastUsed(0), fDirty(kFALSE)
 {
    // Default constructor
 }
 
 //______________________________________________________________________________
 TMemFile::TMemBlock::TMemBlock(Long64_t size, TMemBlock *previous) : 
-   fPrevious(previous), fNext(0), fBuffer(0), fSize(0)
+   fPrevious(previous), fNext(0), fBuffer(0), fSize(0),
+   fSpillOffset(-1), fLastUsed(0), fDirty(kFALSE)
 {
    // Constructor allocating the memory buffer.
    
@@ -79,7 +89,8 @@ void TMemFile::TMemBlock::CreateNext(Long64_t size)
 TMemFile::TMemFile(const char *path, Option_t *option,
                    const char *ftitle, Int_t compress) :
    TFile(path, "WEB", ftitle, compress),
-   fSize(-1), fSysOffset(0), fBlockSeek(&fBlockList), fBlockOffset(0)
+   fSize(-1), fSysOffset(0), fBlockSeek(&fBlockList), fBlockOffset(0),
+   fMaxMemory(0), fInMemory(0), fAccessCounter(0), fSpillFD(-1), fSpillSize(0)
 {
    // Usual Constructor.  See the TFile constructor for details.
 
@@ -132,7 +143,8 @@ zombie:
 TMemFile::TMemFile(const char *path, char *buffer, Long64_t size, Option_t *option,
                    const char *ftitle, Int_t compress):
    TFile(path, "WEB", ftitle, compress), fBlockList(size),  
-   fSize(size), fSysOffset(0), fBlockSeek(&(fBlockList)), fBlockOffset(0)
+   fSize(size), fSysOffset(0), fBlockSeek(&(fBlockList)), fBlockOffset(0),
+   fMaxMemory(0), fInMemory(0), fAccessCounter(0), fSpillFD(-1), fSpillSize(0)
 {
    // Usual Constructor.  See the TFile constructor for details.
 
@@ -182,7 +194,8 @@ zombie:
 TMemFile::TMemFile(const TMemFile &orig) :
    TFile(orig.GetEndpointUrl()->GetUrl(), "WEB", orig.GetTitle(), 
          orig.GetCompressionSettings() ), fBlockList(orig.GetEND()),  
-   fSize(orig.GetEND()), fSysOffset(0), fBlockSeek(&(fBlockList)), fBlockOffset(0)
+   fSize(orig.GetEND()), fSysOffset(0), fBlockSeek(&(fBlockList)), fBlockOffset(0),
+   fMaxMemory(0), fInMemory(orig.GetEND()), fAccessCounter(0), fSpillFD(-1), fSpillSize(0)
 {
    // Copying the content of the TMemFile into another TMemFile.
    
@@ -215,6 +228,12 @@ TMemFile::~TMemFile()
    // Need to call close, now as it will need both our virtual table
    // and the content of the list of blocks
    Close();
+
+   // Only now the spilled blocks are not needed anymore.
+   if (fSpillFD != -1) {
+      TFile::SysClose(fSpillFD);
+      gSystem->Unlink(fSpillName);
+   }
    TRACE("destroy")
 }
 
@@ -248,10 +267,15 @@ void TMemFile::CopyTo(TBuffer &tobuf) const
    // Copy the binary representation of the TMemFile into
    // the TBuffer tobuf
 
-   const TMemBlock *current = &fBlockList;
-   while(current) {
-      tobuf.WriteFastArray(current->fBuffer,current->fSize);
-      current = current->fNext;
+   Int_t nblocks = GetNBlocks();
+   for(Int_t i = 0; i < nblocks; ++i) {
+      Long64_t size;
+      const UChar_t *buffer = GetBlock(i,size);
+      if (!buffer) {
+         Error("CopyTo","Block %d of %s could not be reloaded from %s",i,GetName(),fSpillName.Data());
+         return;
+      }
+      tobuf.WriteFastArray(buffer,size);
    }
 }
 
@@ -264,17 +288,194 @@ Long64_t TMemFile::GetSize() const
    return fSize;
 }
 
+//______________________________________________________________________________
+Int_t TMemFile::GetNBlocks() const
+{
+   // Return the number of blocks holding the content of the memory file.
+
+   Int_t counter = 0;
+   for(const TMemBlock *current = &fBlockList; current; current = current->fNext) {
+      ++counter;
+   }
+   return counter;
+}
+
+//______________________________________________________________________________
+const UChar_t *TMemFile::GetBlock(Int_t index, Long64_t &size) const
+{
+   // Return the address of the memory of the block 'index' and set 'size'
+   // to its length, without copying the data.  The concatenation of the
+   // blocks is the binary representation of the file (as written by
+   // CopyTo(TBuffer&)).
+   // If the block had been spilled to disk it is first reloaded, which may
+   // in turn spill another block.  Hence, when a memory limit is set (see
+   // SetMaxMemory), the returned address is only valid until the next
+   // access to the file content.
+   // Return 0 if the index is out of range or the block can not be reloaded.
+
+   size = 0;
+   if (index < 0) return 0;
+   TMemBlock *current = const_cast<TMemBlock*>(&fBlockList);
+   for(Int_t i = 0; current && i < index; ++i) {
+      current = current->fNext;
+   }
+   if (!current) return 0;
+   const UChar_t *buffer = const_cast<TMemFile*>(this)->LoadBlock(current);
+   if (buffer) size = current->fSize;
+   return buffer;
+}
+
+//______________________________________________________________________________
+void TMemFile::SetMaxMemory(Long64_t maxbytes, const char *spilldir /* = 0 */)
+{
+   // Limit to 'maxbytes' the memory used to hold the content of the file,
+   // 0 (the default) means no limit.  When the limit is reached, the least
+   // recently used blocks are written to a temporary file created in
+   // 'spilldir' (or in gSystem->TempDirectory() if not specified) and are
+   // reloaded when needed.  At least one block is always kept in memory,
+   // so the limit may be exceeded when it is smaller than the block size.
+   // The directory is ignored if blocks have already been spilled.
+
+   fMaxMemory = maxbytes > 0 ? maxbytes : 0;
+   if (fSpillFD == -1) {
+      fSpillDir = spilldir ? spilldir : "";
+   }
+   MakeRoom(0, fBlockSeek);
+}
+
+//______________________________________________________________________________
+UChar_t *TMemFile::LoadBlock(TMemBlock *block)
+{
+   // Return the memory of the block, reloading it from the spill file if
+   // needed, and mark it as the most recently used block.
+
+   block->fLastUsed = ++fAccessCounter;
+   if (block->fBuffer || !block->IsSpilled()) {
+      return block->fBuffer;
+   }
+
+   MakeRoom(block->fSize, block);
+
+   UChar_t *buffer = new UChar_t[block->fSize];
+   if (TFile::SysSeek(fSpillFD, block->fSpillOffset, SEEK_SET) < 0) {
+      SysError("LoadBlock", "can not seek in the spill file %s", fSpillName.Data());
+      delete [] buffer;
+      return 0;
+   }
+   Long64_t done = 0;
+   while (done < block->fSize) {
+      Long64_t chunk = block->fSize - done;
+      if (chunk > kMaxInt) chunk = kMaxInt;
+      Int_t nread = TFile::SysRead(fSpillFD, buffer + done, (Int_t)chunk);
+      if (nread < 0 && TSystem::GetErrno() == EINTR) {
+         TSystem::ResetErrno();
+         continue;
+      }
+      if (nread <= 0) {
+         SysError("LoadBlock", "can not read back a block from the spill file %s", fSpillName.Data());
+         delete [] buffer;
+         return 0;
+      }
+      done += nread;
+   }
+   block->fBuffer = buffer;
+   block->fDirty = kFALSE;
+   fInMemory += block->fSize;
+   return buffer;
+}
+
+//______________________________________________________________________________
+void TMemFile::MakeRoom(Long64_t size, const TMemBlock *keep)
+{
+   // Spill the least recently used blocks (other than 'keep') until 'size'
+   // more bytes can be held in memory without going over fMaxMemory.
+
+   if (fMaxMemory <= 0) return;
+
+   while (fInMemory + size > fMaxMemory) {
+      TMemBlock *oldest = 0;
+      for(TMemBlock *current = &fBlockList; current; current = current->fNext) {
+         if (current->fBuffer && current != keep
+             && (!oldest || current->fLastUsed < oldest->fLastUsed)) {
+            oldest = current;
+         }
+      }
+      if (!oldest || !SpillBlock(oldest)) {
+         // Nothing left that we can spill.
+         return;
+      }
+   }
+}
+
+//______________________________________________________________________________
+Bool_t TMemFile::SpillBlock(TMemBlock *block)
+{
+   // Write the block to the spill file (unless an up-to-date copy is
+   // already there) and release its memory.
+   // On failure, the block stays in memory and the memory limit is lifted.
+
+   if (fSpillFD == -1) {
+      FILE *spill = gSystem->TempFileName(fSpillName, fSpillDir.Length() ? fSpillDir.Data() : 0);
+      if (spill) {
+         fclose(spill);
+         fSpillFD = TFile::SysOpen(fSpillName, O_RDWR, 0600);
+      }
+      if (fSpillFD == -1) {
+         SysError("SpillBlock", "can not create a spill file for %s, the memory limit of %lld bytes is ignored", GetName(), fMaxMemory);
+         fMaxMemory = 0;
+         return kFALSE;
+      }
+   }
+   if (block->fSpillOffset < 0) {
+      block->fSpillOffset = fSpillSize;
+      fSpillSize += block->fSize;
+      block->fDirty = kTRUE;
+   }
+   if (block->fDirty) {
+      if (TFile::SysSeek(fSpillFD, block->fSpillOffset, SEEK_SET) < 0) {
+         SysError("SpillBlock", "can not seek in the spill file %s, the memory limit of %lld bytes is ignored", fSpillName.Data(), fMaxMemory);
+         fMaxMemory = 0;
+         return kFALSE;
+      }
+      Long64_t done = 0;
+      while (done < block->fSize) {
+         Long64_t chunk = block->fSize - done;
+         if (chunk > kMaxInt) chunk = kMaxInt;
+         Int_t nwrite = TFile::SysWrite(fSpillFD, block->fBuffer + done, (Int_t)chunk);
+         if (nwrite < 0 && TSystem::GetErrno() == EINTR) {
+            TSystem::ResetErrno();
+            continue;
+         }
+         if (nwrite <= 0) {
+            SysError("SpillBlock", "can not write to the spill file %s, the memory limit of %lld bytes is ignored", fSpillName.Data(), fMaxMemory);
+            fMaxMemory = 0;
+            return kFALSE;
+         }
+         done += nwrite;
+      }
+   }
+   delete [] block->fBuffer;
+   block->fBuffer = 0;
+   block->fDirty = kFALSE;
+   fInMemory -= block->fSize;
+   return kTRUE;
+}
+
 //______________________________________________________________________________
 void TMemFile::Print(Option_t *option /* = "" */) const
 {
    Printf("TMemFile: name=%s, title=%s, option=%s", GetName(), GetTitle(), GetOption());
    if (strcmp(option,"blocks")==0) {
+      if (fMaxMemory > 0) {
+         Printf("TMemFile: memory used=%lld limit=%lld spill file=%s", fInMemory, fMaxMemory, fSpillName.Data());
+      }
       const TMemBlock *current = &fBlockList;
       Int_t counter = 0;
       while(current) {
-         Printf("TMemBlock: %d size=%lld addr=%p curr=%p prev=%p next=%p",
+         Printf("TMemBlock: %d size=%lld addr=%p curr=%p prev=%p next=%p spilled=%lld",
                 counter,current->fSize,current->fBuffer,
-                current,current->fPrevious,current->fNext);
+                current,current->fPrevious,current->fNext,
+                current->IsSpilled() ? current->fSpillOffset : -1);
          current = current->fNext;
          ++counter;
       }
@@ -401,7 +602,7 @@ Int_t TMemFile::SysRead(Int_t, void *buf, Int_t len)
 
    TRACE("READ")
 
-   if (fBlockList.fBuffer == 0) {
+   if (fBlockList.fBuffer == 0 && !fBlockList.IsSpilled()) {
       errno = EBADF;
       gSystem->SetErrorStr("The memory file is not open.");
       return 0;
@@ -410,40 +611,35 @@ Int_t TMemFile::SysRead(Int_t, void *buf, Int_t len)
       if (fSysOffset + len > fSize) {
          len = fSize - fSysOffset;
       }
-               
-      if (fBlockOffset+len <= fBlockSeek->fSize) {
-         // 'len' does not go past the end of the current block,
-         // so let's make a simple copy.
-         memcpy(buf,fBlockSeek->fBuffer+fBlockOffset,len);
-         fBlockOffset += len;
-      } else {
-         // We are going to have to copy data from more than one
-         // block.
-         
-         // First copy the end of the first block.
-         Int_t sublen = fBlockSeek->fSize - fBlockOffset;
-         memcpy(buf,fBlockSeek->fBuffer+fBlockOffset,sublen);
-         
-         // Move to the next.
-         buf = (char*)buf + sublen;
-         Int_t len_left = len - sublen;
-         fBlockSeek = fBlockSeek->fNext;
-         
-         // Copy all the full blocks that are covered by the request.
-         while (len_left > fBlockSeek->fSize) {
-            R__ASSERT(fBlockSeek);
-
-            memcpy(buf, fBlockSeek->fBuffer, fBlockSeek->fSize);
-            buf = (char*)buf + fBlockSeek->fSize;
-            len_left -= fBlockSeek->fSize;
+      if (len < 0) {
+         len = 0;
+      }
+
+      // Copy block by block, moving to the next block only when
+      // more data is needed.
+      char *cursor = (char*)buf;
+      Int_t len_left = len;
+      while (len_left > 0) {
+         if (fBlockOffset >= fBlockSeek->fSize) {
+            R__ASSERT(fBlockSeek->fNext);
+            fBlockOffset -= fBlockSeek->fSize;
             fBlockSeek = fBlockSeek->fNext;
          }
-         
-         // Copy the data from the last block.
-         R__ASSERT(fBlockSeek);
-         memcpy(buf,fBlockSeek->fBuffer, len_left);
-         fBlockOffset = len_left;
-
+         UChar_t *buffer = LoadBlock(fBlockSeek);
+         if (!buffer) {
+            // Restore a consistent position.
+            SysSeek(fD, fSysOffset, SEEK_SET);
+            errno = EIO;
+            return -1;
+         }
+         Long64_t sublen = fBlockSeek->fSize - fBlockOffset;
+         if (sublen > len_left) {
+            sublen = len_left;
+         }
+         memcpy(cursor, buffer + fBlockOffset, sublen);
+         cursor += sublen;
+         len_left -= sublen;
+         fBlockOffset += sublen;
       }
       fSysOffset += len;
       return len;
@@ -537,6 +733,7 @@ Int_t TMemFile::SysOpen(const char * /* pathname */, Int_t /* flags */, UInt_t /
       fBlockList.fSize = fgDefaultBlockSize;
       fSize = fgDefaultBlockSize;
    }
+   fInMemory = fBlockList.fSize;
    if (fBlockList.fBuffer) {
       return 0;
    } else {
@@ -558,53 +755,42 @@ Int_t TMemFile::SysWrite(Int_t /* fd */, const void *buf, Int_t len)
    // Write a buffer into the file;
    
    TRACE("WRITE")
-   
-   if (fBlockList.fBuffer == 0) {
+
+   if (fBlockList.fBuffer == 0 && !fBlockList.IsSpilled()) {
       errno = EBADF;
       gSystem->SetErrorStr("The memory file is not open.");
       return 0;
-   } else {      
-      if (fBlockOffset+len <= fBlockSeek->fSize) {
-         // 'len' does not go past the end of the current block,
-         // so let's make a simple copy.
-         memcpy(fBlockSeek->fBuffer+fBlockOffset,buf,len);
-         fBlockOffset += len;
-      } else {
-         // We are going to have to copy data into more than one
-         // block.
-         
-         // First copy to the end of the first block.
-         Int_t sublen = fBlockSeek->fSize - fBlockOffset;
-         memcpy(fBlockSeek->fBuffer+fBlockOffset,buf,sublen);
-
-         // Move to the next.
-         buf = (char*)buf + sublen;
-         Int_t len_left = len - sublen;
-         if (!fBlockSeek->fNext) {
-            fBlockSeek->CreateNext(fgDefaultBlockSize);
-            fSize += fgDefaultBlockSize;
-         }
-         fBlockSeek = fBlockSeek->fNext; 
-         
-         // Copy all the full blocks that are covered by the request.
-         while (len_left > fBlockSeek->fSize) {
-            R__ASSERT(fBlockSeek);
-            
-            memcpy(fBlockSeek->fBuffer, buf, fBlockSeek->fSize);
-            buf = (char*)buf + fBlockSeek->fSize;
-            len_left -= fBlockSeek->fSize;
+   } else {
+      // Copy block by block, adding new blocks as needed.
+      const char *cursor = (const char*)buf;
+      Int_t len_left = len;
+      while (len_left > 0) {
+         if (fBlockOffset >= fBlockSeek->fSize) {
             if (!fBlockSeek->fNext) {
+               MakeRoom(fgDefaultBlockSize, 0);
                fBlockSeek->CreateNext(fgDefaultBlockSize);
                fSize += fgDefaultBlockSize;
+               fInMemory += fgDefaultBlockSize;
             }
-            fBlockSeek = fBlockSeek->fNext; 
+            fBlockOffset -= fBlockSeek->fSize;
+            fBlockSeek = fBlockSeek->fNext;
+         }
+         UChar_t *buffer = LoadBlock(fBlockSeek);
+         if (!buffer) {
+            // Restore a consistent position.
+            SysSeek(fD, fSysOffset, SEEK_SET);
+            errno = EIO;
+            return -1;
+         }
+         Long64_t sublen = fBlockSeek->fSize - fBlockOffset;
+         if (sublen > len_left) {
+            sublen = len_left;
          }
-         
-         // Copy the data from the last block.
-         R__ASSERT(fBlockSeek);
-         memcpy(fBlockSeek->fBuffer, buf, len_left);
-         fBlockOffset = len_left;
-         
+         memcpy(buffer + fBlockOffset, cursor, sublen);
+         fBlockSeek->fDirty = kTRUE;
+         cursor += sublen;
+         len_left -= sublen;
+         fBlockOffset += sublen;
       }
       fSysOffset += len;
       return len;
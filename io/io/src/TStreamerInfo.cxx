@@ -200,6 +200,8 @@ TStreamerInfo::~TStreamerInfo()
    delete fWriteObjectWise;
    delete fWriteMemberWise;
 
+   TStreamerInfoActions::TActionSequence::RemoveSharedActions(this);
+
    if (!fElements) return;
    fElements->Delete();
    delete fElements; fElements=0;
@@ -24,6 +24,8 @@
 #include "TVirtualCollectionIterators.h"
 #include "TProcessID.h"
 
+#include <map>
+
 static const Int_t kRegrouped = TStreamerInfo::kOffsetL;
 
 // More possible optimizations:
@@ -2461,6 +2463,10 @@ void TStreamerInfo::Compile()
 
    fOptimized = isOptimized;
 
+   if (fgGenerateCode) {
+      CompileStreamerCode();
+   }
+
    if (gDebug > 0) {
       ls();
    }
@@ -2936,6 +2942,87 @@ TStreamerInfoActions::TActionSequence *TStreamerInfoActions::TActionSequence::Cr
    return sequence;
 }
 
+namespace {
+   // Key of the process wide cache of member-wise read sequences.  The StreamerInfo
+   // identifies the class, the on file layout (checksum and version) and the
+   // target class of the conversion; the rest describes the loop configuration.
+   struct TSharedSequenceKey {
+      const TVirtualStreamerInfo *fInfo;
+      Int_t                       fCollectionType;
+      Bool_t                      fIsEmulated;
+      Bool_t                      fHasPointers;
+      Long_t                      fIncrement;
+
+      bool operator<(const TSharedSequenceKey &rhs) const {
+         if (fInfo != rhs.fInfo) return fInfo < rhs.fInfo;
+         if (fCollectionType != rhs.fCollectionType) return fCollectionType < rhs.fCollectionType;
+         if (fIsEmulated != rhs.fIsEmulated) return fIsEmulated < rhs.fIsEmulated;
+         if (fHasPointers != rhs.fHasPointers) return fHasPointers < rhs.fHasPointers;
+         return fIncrement < rhs.fIncrement;
+      }
+   };
+   typedef std::map<TSharedSequenceKey, TStreamerInfoActions::TActionSequence*> SharedSequences_t;
+
+   SharedSequences_t &GetSharedSequences()
+   {
+      static SharedSequences_t gSharedSequences;
+      return gSharedSequences;
+   }
+}
+
+//______________________________________________________________________________
+TStreamerInfoActions::TActionSequence *TStreamerInfoActions::TActionSequence::GetSharedReadMemberWiseActions(TVirtualStreamerInfo *info, TVirtualCollectionProxy &proxy)
+{
+   // Return the bundle of the actions necessary for the streaming memberwise of the content
+   // described by 'info' into the collection described by 'proxy'.
+   //
+   // The sequences which do not depend on the proxy itself (i.e. all but the
+   // ones using the generic iterator based loop) are built once per process and
+   // shared by all the proxies (and thus all the branches of all the files of a
+   // TChain and all the threads) reading this layout.  They are owned by the cache
+   // and deleted along with their StreamerInfo; the other sequences are
+   // created by CreateReadMemberWiseActions and owned by the caller.
+
+   if (info == 0 || SelectLooper(proxy) == kGenericLooper
+       || (proxy.GetCollectionType() == TClassEdit::kBitSet && !(proxy.GetProperties() & TVirtualCollectionProxy::kIsEmulated))) {
+      return CreateReadMemberWiseActions(info, proxy);
+   }
+
+   TSharedSequenceKey key;
+   key.fInfo = info;
+   key.fCollectionType = proxy.GetCollectionType();
+   key.fIsEmulated = (proxy.GetProperties() & TVirtualCollectionProxy::kIsEmulated) != 0;
+   key.fHasPointers = proxy.HasPointers();
+   key.fIncrement = proxy.GetIncrement();
+
+   R__LOCKGUARD(gClingMutex);
+   SharedSequences_t::iterator iter = GetSharedSequences().find(key);
+   if (iter != GetSharedSequences().end()) {
+      return iter->second;
+   }
+   TActionSequence *sequence = CreateReadMemberWiseActions(info, proxy);
+   GetSharedSequences()[key] = sequence;
+   return sequence;
+}
+
+//______________________________________________________________________________
+void TStreamerInfoActions::TActionSequence::RemoveSharedActions(const TVirtualStreamerInfo *info)
+{
+   // Delete the shared sequences derived from 'info'.
+
+   R__LOCKGUARD(gClingMutex);
+   SharedSequences_t &shared = GetSharedSequences();
+   SharedSequences_t::iterator iter = shared.begin();
+   while (iter != shared.end()) {
+      if (iter->first.fInfo == info) {
+         delete iter->second;
+         shared.erase(iter++);
+      } else {
+         ++iter;
+      }
+   }
+}
+
 //______________________________________________________________________________
 TStreamerInfoActions::TActionSequence *TStreamerInfoActions::TActionSequence::CreateWriteMemberWiseActions(TVirtualStreamerInfo *info, TVirtualCollectionProxy &proxy)
 {
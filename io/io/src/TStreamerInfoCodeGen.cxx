@@ -0,0 +1,433 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2013, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// Generation of specialized streaming functions from a TStreamerInfo. //
+//                                                                      //
+// The object-wise action sequences of a TStreamerInfo dispatch through //
+// one function pointer per (optimized) data member.  For the common    //
+// members (basic types, fixed size arrays, TString, TObject, TNamed    //
+// and base classes) TStreamerInfo::GenerateStreamerCode can emit the   //
+// C++ source of functions streaming a whole run of consecutive members //
+// with the member offsets inlined.  Such a function has the signature  //
+// of a TStreamerInfoAction_t and replaces the individual actions of    //
+// the run in the sequences.                                            //
+//                                                                      //
+// The code can be                                                      //
+//  - just-in-time compiled by the interpreter via                      //
+//    TStreamerInfo::CompileStreamerCode (or automatically for every     //
+//    compiled TStreamerInfo after                                      //
+//    TStreamerInfo::SetGenerateStreamerCode(kTRUE)), or                //
+//  - written to a source file and compiled into a library.  The        //
+//    generated code registers its functions at load time and           //
+//    CompileStreamerCode will then pick them up instead of invoking     //
+//    the interpreter.                                                  //
+//                                                                      //
+// The function names contain a hash of the generated code so that a    //
+// function is only ever used for the exact memory layout it was       //
+// generated for.                                                       //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "TStreamerInfo.h"
+#include "TStreamerInfoActions.h"
+#include "TStreamerElement.h"
+#include "TClass.h"
+#include "TInterpreter.h"
+#include "TVirtualMutex.h"
+#include "TError.h"
+#include "TROOT.h"
+
+#include <ctype.h>
+#include <map>
+#include <string>
+#include <vector>
+
+Bool_t TStreamerInfo::fgGenerateCode = kFALSE;
+
+namespace {
+
+   typedef std::map<std::string, TStreamerInfoActions::TStreamerInfoAction_t> GeneratedActions_t;
+
+   GeneratedActions_t &GetGeneratedActions()
+   {
+      // Return the process wide registry of generated streaming functions.
+
+      static GeneratedActions_t gGeneratedActions;
+      return gGeneratedActions;
+   }
+
+   const char *GetBasicTypeName(Int_t type)
+   {
+      // Return the name of the C++ type corresponding to the basic
+      // TStreamerInfo type 'type' or 0 if the type can not be streamed
+      // by the generated code.
+
+      switch (type) {
+         case TStreamerInfo::kBool:     return "Bool_t";
+         case TStreamerInfo::kChar:     return "Char_t";
+         case TStreamerInfo::kShort:    return "Short_t";
+         case TStreamerInfo::kInt:      return "Int_t";
+         case TStreamerInfo::kLong:     return "Long_t";
+         case TStreamerInfo::kLong64:   return "Long64_t";
+         case TStreamerInfo::kFloat:    return "Float_t";
+         case TStreamerInfo::kDouble:   return "Double_t";
+         case TStreamerInfo::kUChar:    return "UChar_t";
+         case TStreamerInfo::kUShort:   return "UShort_t";
+         case TStreamerInfo::kUInt:     return "UInt_t";
+         case TStreamerInfo::kULong:    return "ULong_t";
+         case TStreamerInfo::kULong64:  return "ULong64_t";
+         case TStreamerInfo::kFloat16:  return "Float_t";
+         case TStreamerInfo::kDouble32: return "Double_t";
+         default:                       return 0;
+      }
+   }
+
+   Bool_t CanGenerate(const TStreamerInfo *info, Int_t i)
+   {
+      // Return true if the i-th (compiled) element of 'info' can be
+      // streamed by generated code.
+
+      TStreamerElement *element = (TStreamerElement*)info->GetElems()[i];
+      if (!element || element->TestBit(TStreamerElement::kCache)) {
+         return kFALSE;
+      }
+      Int_t type = info->GetTypes()[i];
+      if (type > 0 && type < TStreamerInfo::kOffsetP) {
+         // Basic types, fixed size arrays and regrouped consecutive members.
+         return GetBasicTypeName(type % TStreamerInfo::kOffsetL) != 0;
+      }
+      switch (type) {
+         case TStreamerInfo::kTString:
+         case TStreamerInfo::kTObject:
+         case TStreamerInfo::kTNamed:
+            return kTRUE;
+         case TStreamerInfo::kBase:
+            // Custom streamers of the base class are still handled by the
+            // generic action.
+            return element->GetStreamer() == 0;
+         default:
+            return kFALSE;
+      }
+   }
+
+   void GenerateElementCode(TString &code, const TStreamerInfo *info, Int_t i, Bool_t read)
+   {
+      // Append the statement streaming the i-th element of 'info'.
+
+      TStreamerElement *element = (TStreamerElement*)info->GetElems()[i];
+      Int_t type   = info->GetTypes()[i];
+      Int_t offset = info->GetOffsets()[i];
+      Int_t length = info->GetLengths()[i];
+
+      switch (type) {
+         case TStreamerInfo::kTString:
+            code += TString::Format("   ((TString*)(R__p+%d))->TString::Streamer(R__b);", offset);
+            break;
+         case TStreamerInfo::kTObject:
+            code += TString::Format("   ((TObject*)(R__p+%d))->TObject::Streamer(R__b);", offset);
+            break;
+         case TStreamerInfo::kTNamed:
+            code += TString::Format("   ((TNamed*)(R__p+%d))->TNamed::Streamer(R__b);", offset);
+            break;
+         case TStreamerInfo::kBase:
+            // TStreamerBase applies the offset of the base class itself.
+            code += TString::Format("   ((TStreamerBase*)R__elems[%d])->%s(R__b,R__p);", i, read ? "ReadBuffer" : "WriteBuffer");
+            break;
+         default: {
+            Int_t basic = type % TStreamerInfo::kOffsetL;
+            const char *tname = GetBasicTypeName(basic);
+            Bool_t isArray = type >= TStreamerInfo::kOffsetL;
+            if (basic == TStreamerInfo::kFloat16 || basic == TStreamerInfo::kDouble32) {
+               const char *suffix = basic == TStreamerInfo::kFloat16 ? "Float16" : "Double32";
+               if (isArray) {
+                  code += TString::Format("   R__b.%sFastArray%s((%s*)(R__p+%d),%d,(TStreamerElement*)R__elems[%d]);",
+                                          read ? "Read" : "Write", suffix, tname, offset, length, i);
+               } else {
+                  code += TString::Format("   R__b.%s%s((%s*)(R__p+%d),(TStreamerElement*)R__elems[%d]);",
+                                          read ? "Read" : "Write", suffix, tname, offset, i);
+               }
+            } else if (isArray) {
+               code += TString::Format("   R__b.%sFastArray((%s*)(R__p+%d),%d);",
+                                       read ? "Read" : "Write", tname, offset, length);
+            } else {
+               code += TString::Format("   R__b %s *(%s*)(R__p+%d);", read ? ">>" : "<<", tname, offset);
+            }
+            break;
+         }
+      }
+      code += TString::Format(" // %s\n", element->GetName());
+   }
+
+   void FindRuns(const TStreamerInfo *info, std::vector<std::pair<Int_t,Int_t> > &runs)
+   {
+      // Collect the ranges [first,last] of consecutive elements that can
+      // be streamed by generated code.  A run of a single element would
+      // not save any dispatch and is ignored.
+
+      Int_t ndata = info->GetNdata();
+      Int_t first = -1;
+      for (Int_t i = 0; i <= ndata; ++i) {
+         if (i < ndata && CanGenerate(info, i)) {
+            if (first < 0) first = i;
+            continue;
+         }
+         if (first >= 0 && i - first > 1) {
+            runs.push_back(std::make_pair(first, i - 1));
+         }
+         first = -1;
+      }
+   }
+
+   Bool_t NeedsElements(const TStreamerInfo *info, Int_t first, Int_t last)
+   {
+      // Return true if the code for the run needs to access the
+      // TStreamerElements at run time.
+
+      for (Int_t i = first; i <= last; ++i) {
+         Int_t basic = info->GetTypes()[i] % TStreamerInfo::kOffsetL;
+         if (info->GetTypes()[i] == TStreamerInfo::kBase
+             || basic == TStreamerInfo::kFloat16 || basic == TStreamerInfo::kDouble32) {
+            return kTRUE;
+         }
+      }
+      return kFALSE;
+   }
+
+   void GenerateRunBody(TString &body, const TStreamerInfo *info, Int_t first, Int_t last, Bool_t read)
+   {
+      // Generate the body of the function streaming the elements [first,last].
+
+      body += "{\n";
+      body += "   char *R__p = (char*)R__addr + R__conf->fOffset;\n";
+      if (NeedsElements(info, first, last)) {
+         body += "   ULong_t *R__elems = ((TStreamerInfo*)R__conf->fInfo)->GetElems();\n";
+      }
+      // Text based buffers (XML, JSON) need to be told about each element,
+      // the caller of the action only announces the first one.
+      body += "   const Bool_t R__text = R__b.TestBit(TBufferFile::kTextBasedStreaming);\n";
+      for (Int_t i = first; i <= last; ++i) {
+         if (i != first) {
+            body += TString::Format("   if (R__text) R__b.SetStreamerElementNumber(%d);\n", i);
+         }
+         GenerateElementCode(body, info, i, read);
+      }
+      body += "   return 0;\n}\n";
+   }
+
+   TString GetFunctionPrefix(const TStreamerInfo *info)
+   {
+      // Return the prefix of the generated function names for 'info'.
+
+      TString prefix("R__gen_");
+      const char *name = info->GetName();
+      for (const char *c = name; *c; ++c) {
+         prefix += isalnum(*c) ? *c : '_';
+      }
+      prefix += TString::Format("_v%d_c%x", info->GetClassVersion(), info->GetCheckSum());
+      return prefix;
+   }
+
+   TString GenerateRunsCode(const TStreamerInfo *info, const std::vector<std::pair<Int_t,Int_t> > &runs, TString &code)
+   {
+      // Append to 'code' the read and write functions of each run and the
+      // static initializer registering them.  Returns the prefix of the
+      // function names; the name of the functions of a run is
+      // <prefix>_<first element>_r (or _w).
+
+      // The hash of the bodies (which contain the offsets, the lengths and the
+      // element indices) guarantees the layout of the functions found in the registry.
+      std::vector<TString> readBodies(runs.size());
+      std::vector<TString> writeBodies(runs.size());
+      TString all;
+      for (size_t r = 0; r < runs.size(); ++r) {
+         GenerateRunBody(readBodies[r], info, runs[r].first, runs[r].second, kTRUE);
+         GenerateRunBody(writeBodies[r], info, runs[r].first, runs[r].second, kFALSE);
+         all += readBodies[r];
+         all += writeBodies[r];
+      }
+      TString prefix = GetFunctionPrefix(info);
+      prefix += TString::Format("_h%x", all.Hash());
+
+      code += TString::Format("// Streaming functions generated from the TStreamerInfo of class %s, version %d, checksum 0x%x\n",
+                              info->GetName(), info->GetClassVersion(), info->GetCheckSum());
+      code += "#include \"TBufferFile.h\"\n";
+      code += "#include \"TNamed.h\"\n";
+      code += "#include \"TStreamerElement.h\"\n";
+      code += "#include \"TStreamerInfo.h\"\n";
+      code += "#include \"TStreamerInfoActions.h\"\n\n";
+      TString init;
+      for (size_t r = 0; r < runs.size(); ++r) {
+         TString name = TString::Format("%s_%d", prefix.Data(), runs[r].first);
+         code += TString::Format("Int_t %s_r(TBuffer &R__b, void *R__addr, const TStreamerInfoActions::TConfiguration *R__conf)\n", name.Data());
+         code += readBodies[r];
+         code += "\n";
+         code += TString::Format("Int_t %s_w(TBuffer &R__b, void *R__addr, const TStreamerInfoActions::TConfiguration *R__conf)\n", name.Data());
+         code += writeBodies[r];
+         code += "\n";
+         init += TString::Format("         TStreamerInfoActions::RegisterGeneratedAction(\"%s_r\", %s_r);\n", name.Data(), name.Data());
+         init += TString::Format("         TStreamerInfoActions::RegisterGeneratedAction(\"%s_w\", %s_w);\n", name.Data(), name.Data());
+      }
+      code += "namespace {\n";
+      code += TString::Format("   struct %s_init {\n", prefix.Data());
+      code += TString::Format("      %s_init() {\n", prefix.Data());
+      code += init;
+      code += "      }\n";
+      code += TString::Format("   } %s_instance;\n", prefix.Data());
+      code += "}\n";
+      return prefix;
+   }
+
+   void ReplaceRuns(TStreamerInfoActions::TActionSequence *sequence, const std::vector<std::pair<Int_t,Int_t> > &runs,
+                    const std::vector<TStreamerInfoActions::TStreamerInfoAction_t> &actions)
+   {
+      // Replace the actions of the elements of each run by the single
+      // generated action for the run.
+
+      using namespace TStreamerInfoActions;
+
+      ActionContainer_t replaced;
+      replaced.reserve(sequence->fActions.size());
+      size_t r = 0;
+      for (ActionContainer_t::iterator iter = sequence->fActions.begin(); iter != sequence->fActions.end(); ++iter) {
+         Int_t id = iter->fConfiguration ? (Int_t)iter->fConfiguration->fElemId : -1;
+         while (r < runs.size() && id > runs[r].second) ++r;
+         if (r < runs.size() && id >= runs[r].first) {
+            if (id == runs[r].first) {
+               replaced.push_back(TConfiguredAction(actions[r], new TConfiguration(sequence->fStreamerInfo, id, 0)));
+            }
+            continue;
+         }
+         replaced.push_back(*iter); // This is a move.
+      }
+      sequence->fActions.swap(replaced);
+   }
+}
+
+//______________________________________________________________________________
+void TStreamerInfoActions::RegisterGeneratedAction(const char *name, TStreamerInfoAction_t action)
+{
+   // Register the generated streaming function 'name'.  This is called by the
+   // static initializers of the code produced by TStreamerInfo::GenerateStreamerCode.
+
+   R__LOCKGUARD(gClingMutex);
+   GetGeneratedActions()[name] = action;
+}
+
+//______________________________________________________________________________
+TStreamerInfoActions::TStreamerInfoAction_t TStreamerInfoActions::GetGeneratedAction(const char *name)
+{
+   // Return the generated streaming function 'name' or 0 if it has not been registered.
+
+   R__LOCKGUARD(gClingMutex);
+   GeneratedActions_t::const_iterator iter = GetGeneratedActions().find(name);
+   return iter == GetGeneratedActions().end() ? 0 : iter->second;
+}
+
+//______________________________________________________________________________
+Int_t TStreamerInfo::GenerateStreamerCode(TString &code) const
+{
+   // Append to 'code' the C++ source of the functions streaming the runs of
+   // consecutive data members that do not require the generic streaming
+   // actions, along with the static initializer registering them.
+   // Returns the number of runs for which code was generated (0 if the
+   // streamer info is not compiled or has no suitable members).
+   //
+   // The generated code can be compiled into a library (see the class
+   // description at the top of TStreamerInfoCodeGen.cxx); it is then used by
+   // CompileStreamerCode for the StreamerInfo with the identical layout.
+
+   if (!IsCompiled() || !fNdata) return 0;
+
+   std::vector<std::pair<Int_t,Int_t> > runs;
+   FindRuns(this, runs);
+   if (runs.empty()) return 0;
+
+   GenerateRunsCode(this, runs, code);
+   return (Int_t)runs.size();
+}
+
+//______________________________________________________________________________
+Bool_t TStreamerInfo::CompileStreamerCode()
+{
+   // Replace the object-wise read and write actions of the runs of simple
+   // consecutive data members by generated functions streaming the whole run
+   // with the member offsets inlined.  The functions are taken from the
+   // registry if they were compiled into a library, otherwise the code is
+   // compiled by the interpreter.
+   // The member-wise sequences are not affected.  The replacement is undone
+   // by the next call to Compile.
+   // Returns kTRUE if at least one run of actions was replaced.
+
+   static Bool_t isRunning = kFALSE;
+
+   if (!IsCompiled() || !fReadObjectWise || !fWriteObjectWise) return kFALSE;
+
+   R__LOCKGUARD(gClingMutex);
+   if (isRunning) return kFALSE; // The interpreter might need to compile other StreamerInfos.
+
+   std::vector<std::pair<Int_t,Int_t> > runs;
+   FindRuns(this, runs);
+   if (runs.empty()) return kFALSE;
+
+   TString code;
+   TString prefix = GenerateRunsCode(this, runs, code);
+
+   std::vector<TStreamerInfoActions::TStreamerInfoAction_t> readActions(runs.size());
+   std::vector<TStreamerInfoActions::TStreamerInfoAction_t> writeActions(runs.size());
+   for (Int_t pass = 0; pass < 2; ++pass) {
+      Bool_t complete = kTRUE;
+      for (size_t r = 0; r < runs.size(); ++r) {
+         TString name = TString::Format("%s_%d", prefix.Data(), runs[r].first);
+         readActions[r]  = TStreamerInfoActions::GetGeneratedAction(name + "_r");
+         writeActions[r] = TStreamerInfoActions::GetGeneratedAction(name + "_w");
+         complete = complete && readActions[r] && writeActions[r];
+      }
+      if (complete) break;
+      if (pass || !gInterpreter) {
+         if (gDebug > 0) Info("CompileStreamerCode", "Could not compile the streaming code of %s, version %d", GetName(), fClassVersion);
+         return kFALSE;
+      }
+      isRunning = kTRUE;
+      gInterpreter->LoadText(code);
+      isRunning = kFALSE;
+   }
+
+   ReplaceRuns(fReadObjectWise, runs, readActions);
+   ReplaceRuns(fWriteObjectWise, runs, writeActions);
+   if (gDebug > 0) {
+      Info("CompileStreamerCode", "Using generated streaming code for %d run(s) of members of %s, version %d",
+           (Int_t)runs.size(), GetName(), fClassVersion);
+   }
+   return kTRUE;
+}
+
+//______________________________________________________________________________
+Bool_t TStreamerInfo::GetGenerateStreamerCode()
+{
+   // Return whether the TStreamerInfos will use generated streaming code
+   // (see CompileStreamerCode) as soon as they are compiled.
+
+   return fgGenerateCode;
+}
+
+//______________________________________________________________________________
+Bool_t TStreamerInfo::SetGenerateStreamerCode(Bool_t enable)
+{
+   // Set whether the TStreamerInfos will use generated streaming code
+   // (see CompileStreamerCode) as soon as they are compiled.  The default
+   // is to use the generic streaming actions.
+   // This function returns the previous value of fgGenerateCode.
+
+   Bool_t prev = fgGenerateCode;
+   fgGenerateCode = enable;
+   return prev;
+}
@@ -19,6 +19,7 @@
 #pragma link C++ class TXMLSetup;
 #pragma link C++ class TXMLFile;
 #pragma link C++ class TBufferXML;
+#pragma link C++ class TBufferJSON;
 #pragma link C++ class TKeyXML;
 
 #endif
@@ -0,0 +1,223 @@
+// @(#)root/xml:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TBufferJSON
+#define ROOT_TBufferJSON
+
+#ifndef ROOT_TBufferFile
+#include "TBufferFile.h"
+#endif
+#ifndef ROOT_TString
+#include "TString.h"
+#endif
+#ifndef ROOT_TObjArray
+#include "TObjArray.h"
+#endif
+
+#include <map>
+#include <string>
+#include <utility>
+
+class TCollection;
+class TVirtualStreamerInfo;
+class TStreamerInfo;
+class TStreamerElement;
+class TMemberStreamer;
+class TJSONStackObj;
+
+
+class TBufferJSON : public TBufferFile {
+
+public:
+
+   enum EFormat { kJSON = 0, kBinary = 1 };
+
+   TBufferJSON(EFormat format = kJSON);
+   virtual ~TBufferJSON();
+
+   static TString   ConvertToJSON(const TObject *obj, Int_t compact = 0);
+   static TString   ConvertToJSON(const void *obj, const TClass *cl, Int_t compact = 0);
+   static TString   ConvertToBinary(const TObject *obj);
+   static TString   ConvertToBinary(const void *obj, const TClass *cl);
+
+   EFormat          GetFormat() const { return fFormat; }
+   Int_t            GetCompact() const { return fCompact; }
+   void             SetCompact(Int_t level) { fCompact = level; }
+   const TString   &GetOutput() const { return fOutBuffer; }
+   void             WriteAny(const void *obj, const TClass *cl);
+
+   // suppress class writing
+
+   virtual TClass*  ReadClass(const TClass* cl = 0, UInt_t* objTag = 0);
+   virtual void     WriteClass(const TClass* cl);
+
+   // redefined virtual functions of TBuffer
+
+   virtual Int_t    CheckByteCount(UInt_t startpos, UInt_t bcnt, const TClass *clss);
+   virtual Int_t    CheckByteCount(UInt_t startpos, UInt_t bcnt, const char *classname);
+   virtual void     SetByteCount(UInt_t cntpos, Bool_t packInVersion = kFALSE);
+
+   virtual UInt_t   WriteVersion(const TClass *cl, Bool_t useBcnt = kFALSE);
+
+   virtual void     IncrementLevel(TVirtualStreamerInfo*);
+   virtual void     SetStreamerElementNumber(Int_t);
+   virtual void     DecrementLevel(TVirtualStreamerInfo*);
+
+   virtual void     ClassBegin(const TClass*, Version_t = -1);
+   virtual void     ClassEnd(const TClass*);
+   virtual void     ClassMember(const char* name, const char* typeName = 0, Int_t arrsize1 = -1, Int_t arrsize2 = -1);
+
+   virtual void     WriteObject(const TObject *obj);
+
+   virtual void     WriteFloat16(Float_t *f, TStreamerElement *ele=0);
+   virtual void     WriteDouble32(Double_t *d, TStreamerElement *ele=0);
+
+   virtual void     WriteArray(const Bool_t    *b, Int_t n);
+   virtual void     WriteArray(const Char_t    *c, Int_t n);
+   virtual void     WriteArray(const UChar_t   *c, Int_t n);
+   virtual void     WriteArray(const Short_t   *h, Int_t n);
+   virtual void     WriteArray(const UShort_t  *h, Int_t n);
+   virtual void     WriteArray(const Int_t     *i, Int_t n);
+   virtual void     WriteArray(const UInt_t    *i, Int_t n);
+   virtual void     WriteArray(const Long_t    *l, Int_t n);
+   virtual void     WriteArray(const ULong_t   *l, Int_t n);
+   virtual void     WriteArray(const Long64_t  *l, Int_t n);
+   virtual void     WriteArray(const ULong64_t *l, Int_t n);
+   virtual void     WriteArray(const Float_t   *f, Int_t n);
+   virtual void     WriteArray(const Double_t  *d, Int_t n);
+   virtual void     WriteArrayFloat16(const Float_t  *f, Int_t n, TStreamerElement *ele=0);
+   virtual void     WriteArrayDouble32(const Double_t  *d, Int_t n, TStreamerElement *ele=0);
+
+   virtual void     WriteFastArray(const Bool_t    *b, Int_t n);
+   virtual void     WriteFastArray(const Char_t    *c, Int_t n);
+   virtual void     WriteFastArray(const UChar_t   *c, Int_t n);
+   virtual void     WriteFastArray(const Short_t   *h, Int_t n);
+   virtual void     WriteFastArray(const UShort_t  *h, Int_t n);
+   virtual void     WriteFastArray(const Int_t     *i, Int_t n);
+   virtual void     WriteFastArray(const UInt_t    *i, Int_t n);
+   virtual void     WriteFastArray(const Long_t    *l, Int_t n);
+   virtual void     WriteFastArray(const ULong_t   *l, Int_t n);
+   virtual void     WriteFastArray(const Long64_t  *l, Int_t n);
+   virtual void     WriteFastArray(const ULong64_t *l, Int_t n);
+   virtual void     WriteFastArray(const Float_t   *f, Int_t n);
+   virtual void     WriteFastArray(const Double_t  *d, Int_t n);
+   virtual void     WriteFastArrayFloat16(const Float_t  *d, Int_t n, TStreamerElement *ele=0);
+   virtual void     WriteFastArrayDouble32(const Double_t  *d, Int_t n, TStreamerElement *ele=0);
+   virtual void     WriteFastArray(void  *start,  const TClass *cl, Int_t n=1, TMemberStreamer *s=0);
+   virtual Int_t    WriteFastArray(void **startp, const TClass *cl, Int_t n=1, Bool_t isPreAlloc=kFALSE, TMemberStreamer *s=0);
+
+   virtual void     StreamObject(void *obj, const type_info &typeinfo, const TClass* onFileClass = 0);
+   virtual void     StreamObject(void *obj, const char *className, const TClass* onFileClass = 0);
+   virtual void     StreamObject(void *obj, const TClass *cl, const TClass* onFileClass = 0);
+   virtual void     StreamObject(TObject *obj);
+
+   virtual   void     WriteBool(Bool_t       b);
+   virtual   void     WriteChar(Char_t       c);
+   virtual   void     WriteUChar(UChar_t     c);
+   virtual   void     WriteShort(Short_t     s);
+   virtual   void     WriteUShort(UShort_t   s);
+   virtual   void     WriteInt(Int_t         i);
+   virtual   void     WriteUInt(UInt_t       i);
+   virtual   void     WriteLong(Long_t       l);
+   virtual   void     WriteULong(ULong_t     l);
+   virtual   void     WriteLong64(Long64_t   l);
+   virtual   void     WriteULong64(ULong64_t l);
+   virtual   void     WriteFloat(Float_t     f);
+   virtual   void     WriteDouble(Double_t   d);
+   virtual   void     WriteCharP(const Char_t *c);
+   virtual   void     WriteTString(const TString  &s);
+
+   virtual Int_t ApplySequence(const TStreamerInfoActions::TActionSequence &sequence, void *object);
+   virtual Int_t ApplySequenceVecPtr(const TStreamerInfoActions::TActionSequence &sequence, void *start_collection, void *end_collection);
+   virtual Int_t ApplySequence(const TStreamerInfoActions::TActionSequence &sequence, void *start_collection, void *end_collection);
+
+   // end of redefined virtual functions
+
+   static    void     SetFloatFormat(const char* fmt = "%g");
+   static const char* GetFloatFormat();
+   static    void     SetDoubleFormat(const char* fmt = "%.14g");
+   static const char* GetDoubleFormat();
+
+protected:
+   enum EChunkKind { kScalarChunk, kArrayChunk, kObjectChunk };
+
+   // redefined protected virtual functions
+
+   virtual void     WriteObjectClass(const void *actualObjStart, const TClass *actualClass);
+
+   // end redefined protected virtual functions
+
+   TJSONStackObj*   PushStack(TStreamerInfo *info, Bool_t isObject);
+   void             PopStack();
+   TJSONStackObj*   Stack();
+
+   void             WorkWithClass(TStreamerInfo* info, const TClass* cl = 0);
+   void             WorkWithElement(const char *name, TStreamerElement* elem, Int_t number);
+   void             EndClass();
+   void             EndElement(TJSONStackObj *stack);
+   void             BeginChunk(EChunkKind kind);
+
+   void             JsonWriteObject(const void* obj, const TClass* objClass);
+   void             JsonWriteCollection(const TCollection* coll);
+   void             JsonStartObject(const TClass* cl);
+   void             JsonEndObject();
+   void             JsonWriteMemberName(const char* name);
+   void             JsonWriteNameRef(const char* name);
+   void             JsonWriteString(const char* str, Int_t len = -1);
+   void             JsonWriteVarInt(ULong64_t value);
+
+   void             JsonWriteBasic(Bool_t value);
+   void             JsonWriteBasic(Char_t value);
+   void             JsonWriteBasic(UChar_t value);
+   void             JsonWriteBasic(Short_t value);
+   void             JsonWriteBasic(UShort_t value);
+   void             JsonWriteBasic(Int_t value);
+   void             JsonWriteBasic(UInt_t value);
+   void             JsonWriteBasic(Long_t value);
+   void             JsonWriteBasic(ULong_t value);
+   void             JsonWriteBasic(Long64_t value);
+   void             JsonWriteBasic(ULong64_t value);
+   void             JsonWriteBasic(Float_t value);
+   void             JsonWriteBasic(Double_t value);
+
+   void             JsonWriteArray(const Bool_t    *b, Int_t n);
+   void             JsonWriteArray(const Char_t    *c, Int_t n);
+   void             JsonWriteArray(const UChar_t   *c, Int_t n);
+   void             JsonWriteArray(const Short_t   *h, Int_t n);
+   void             JsonWriteArray(const UShort_t  *h, Int_t n);
+   void             JsonWriteArray(const Int_t     *i, Int_t n);
+   void             JsonWriteArray(const UInt_t    *i, Int_t n);
+   void             JsonWriteArray(const Long_t    *l, Int_t n);
+   void             JsonWriteArray(const ULong_t   *l, Int_t n);
+   void             JsonWriteArray(const Long64_t  *l, Int_t n);
+   void             JsonWriteArray(const ULong64_t *l, Int_t n);
+   void             JsonWriteArray(const Float_t   *f, Int_t n);
+   void             JsonWriteArray(const Double_t  *d, Int_t n);
+
+   TString          fOutBuffer;            //!  JSON text or binary encoding written so far
+   EFormat          fFormat;               //!  output format
+   Int_t            fCompact;              //!  1: zero suppression of the JSON arrays
+   TObjArray        fStack;                //!  stack of TJSONStackObj, one per class level
+   std::map<std::pair<const void*,const TClass*>,Int_t> fObjects; //!  objects written so far -> index in writing order
+   std::map<std::string,UInt_t> fNames;    //!  member and class names already written (binary format)
+   Bool_t           fExpectedChain;        //!  several consecutive basic members are written as one FastArray
+   TClass*          fExpectedBaseClass;    //!  class which should be merged into the current object
+
+   static const char* fgFloatFmt;          //!  printf argument for floats
+   static const char* fgDoubleFmt;         //!  printf argument for doubles
+
+private:
+   TBufferJSON(const TBufferJSON&);            // Not implemented
+   TBufferJSON &operator=(const TBufferJSON&); // Not implemented
+
+ClassDef(TBufferJSON,1) //a specialized TBuffer to convert objects to JSON or to a binary columnar encoding
+};
+
+#endif
@@ -25,6 +25,26 @@ class TXMLInputStream;
 class TXMLOutputStream;
 class TString;
 
+class TXMLSAXHandler {
+   // Receives the content of a xml document parsed with
+   // TXMLEngine::ParseFileSAX() or TXMLEngine::ParseStringSAX(),
+   // without building the node tree.
+   // Element and attribute names are interned by the engine (see
+   // TXMLEngine::Intern()): they can be compared by pointer and stay
+   // valid as long as the engine exists. Attribute values, contents and
+   // comments are only valid during the call.
+   // attrs is a list of name/value pairs terminated by a null name.
+   // Returning kFALSE from any method stops the parsing.
+
+public:
+   virtual ~TXMLSAXHandler() {}
+
+   virtual Bool_t    OnStartElement(const char* name, const char** attrs) = 0;
+   virtual Bool_t    OnEndElement(const char* name) = 0;
+   virtual Bool_t    OnCharacters(const char* /*content*/, Int_t /*len*/) { return kTRUE; }
+   virtual Bool_t    OnComment(const char* /*comment*/) { return kTRUE; }
+};
+
 class TXMLEngine : public TObject {
 
 protected:
@@ -40,8 +60,14 @@ protected:
    XMLNodePointer_t  ReadNode(XMLNodePointer_t xmlparent, TXMLInputStream* inp, Int_t& resvalue);
    void              DisplayError(Int_t error, Int_t linenumber);
    XMLDocPointer_t   ParseStream(TXMLInputStream* input);
+   Bool_t            ParseStreamSAX(TXMLInputStream* input, TXMLSAXHandler* handler);
 
    Bool_t            fSkipComments;    //! if true, do not create comments nodes in document during parsing
+   void*             fNames;           //! table of interned element and attribute names
+
+private:
+   TXMLEngine(const TXMLEngine&);             // Not implemented
+   TXMLEngine& operator=(const TXMLEngine&);  // Not implemented
 
 public:
    TXMLEngine();
@@ -108,6 +134,9 @@ public:
    XMLNodePointer_t  DocGetRootElement(XMLDocPointer_t xmldoc);
    XMLDocPointer_t   ParseFile(const char* filename, Int_t maxbuf = 100000);
    XMLDocPointer_t   ParseString(const char* xmlstring);
+   Bool_t            ParseFileSAX(const char* filename, TXMLSAXHandler* handler, Int_t maxbuf = 100000);
+   Bool_t            ParseStringSAX(const char* xmlstring, TXMLSAXHandler* handler);
+   const char*       Intern(const char* name, Int_t len = -1);
    Bool_t            ValidateVersion(XMLDocPointer_t doc, const char* version = 0);
    Bool_t            ValidateDocument(XMLDocPointer_t, Bool_t = kFALSE) { return kFALSE; } // obsolete
    void              SaveSingleNode(XMLNodePointer_t xmlnode, TString* res, Int_t layout = 1);
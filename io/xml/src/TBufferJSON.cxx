@@ -0,0 +1,1536 @@
+// @(#)root/xml:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+//________________________________________________________________________
+//
+// Class for serializing objects to JSON or to a compact binary encoding.
+// Like TBufferXML it redefines the TBuffer functions used by the
+// streaming mechanism, therefore most of ROOT and user classes can be
+// converted.  Contrary to TBufferXML no intermediate tree of nodes is
+// built: the output is produced while the object is streamed, the only
+// post-processing being done on the text of the data member currently
+// written.  Only writing is supported.
+//
+// In JSON each object is written as
+//    {"_typename":"TH1F","fUniqueID":0,"fBits":50331656,"fName":"h1",...}
+// base classes are merged into the object, TCollection classes are
+// written as {"_typename":"TList","name":"","arr":[...],"opt":[...]}
+// and an object already written is replaced by {"$ref":n}, n being its
+// index in writing order.  With SetCompact(1), arrays with leading or
+// trailing zeros (like most histogram contents) are written as
+//    {"$arr":"Float64","len":n,"p":first,"v":[non-zero range]}
+//
+// The binary encoding has the same structure.  It starts with "RJB1"
+// and uses one tag byte per item:
+//    '{' <name> ... '}'  object of class <name>
+//    ':' <name>          data member name (followed by its value)
+//    '[' ... ']'         list of values
+//    'a' <type> <n> <raw data>  array (column) of n basic values
+//    <type> <raw data>   one basic value
+//    's' <n> <chars>     string,  'n' null pointer,  'r' <n> reference
+// where <type> is one of the characters "ocChHiIlLfd" (bool, char,
+// unsigned char, short, unsigned short, int, unsigned int, 64 bit int,
+// unsigned 64 bit int, float, double), <n> is an unsigned LEB128
+// varint, all numbers are little endian, and <name> is a varint index
+// in the table of names already written, or 0 followed by a new string
+// (without tag) which gets the next index.
+// Arrays of basic types (histogram contents, graph points, ...) are
+// copied in one go in both formats, without per-element function calls.
+//________________________________________________________________________
+
+
+#include "TBufferJSON.h"
+
+#include "TROOT.h"
+#include "TClass.h"
+#include "TList.h"
+#include "TArray.h"
+#include "TStreamerInfo.h"
+#include "TStreamerElement.h"
+#include "TMemberStreamer.h"
+#include "TStreamerInfoActions.h"
+
+#include <float.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef R__VISUAL_CPLUSPLUS
+#define FLong64    "%I64d"
+#define FULong64   "%I64u"
+#else
+#define FLong64    "%lld"
+#define FULong64   "%llu"
+#endif
+
+ClassImp(TBufferJSON);
+
+
+const char* TBufferJSON::fgFloatFmt = "%g";
+const char* TBufferJSON::fgDoubleFmt = "%.14g";
+
+namespace {
+
+   // Description of the basic types: type used in the binary encoding,
+   // type code and name of the JavaScript typed array.
+   template <typename T> struct TJSONBasic;
+
+#define R__JSON_BASIC(type, stored, code, name)                          \
+   template <> struct TJSONBasic<type> {                                 \
+      typedef stored Stored_t;                                           \
+      static char Code() { return code; }                                \
+      static const char *Name() { return name; }                         \
+   };
+
+   R__JSON_BASIC(Bool_t,    UChar_t,   'o', "Uint8")
+   R__JSON_BASIC(Char_t,    Char_t,    'c', "Int8")
+   R__JSON_BASIC(UChar_t,   UChar_t,   'C', "Uint8")
+   R__JSON_BASIC(Short_t,   Short_t,   'h', "Int16")
+   R__JSON_BASIC(UShort_t,  UShort_t,  'H', "Uint16")
+   R__JSON_BASIC(Int_t,     Int_t,     'i', "Int32")
+   R__JSON_BASIC(UInt_t,    UInt_t,    'I', "Uint32")
+   R__JSON_BASIC(Long_t,    Long64_t,  'l', "Int64")
+   R__JSON_BASIC(ULong_t,   ULong64_t, 'L', "Uint64")
+   R__JSON_BASIC(Long64_t,  Long64_t,  'l', "Int64")
+   R__JSON_BASIC(ULong64_t, ULong64_t, 'L', "Uint64")
+   R__JSON_BASIC(Float_t,   Float_t,   'f', "Float32")
+   R__JSON_BASIC(Double_t,  Double_t,  'd', "Float64")
+
+#undef R__JSON_BASIC
+
+   inline void AppendBytes(TString &out, const void *data, size_t len)
+   {
+      // Append 'len' bytes of a number in little endian order.
+
+#ifdef R__BYTESWAP
+      out.Append((const char*)data, len);
+#else
+      const char *c = (const char*)data;
+      for (size_t i = len; i > 0; --i) out.Append(c[i-1]);
+#endif
+   }
+
+   template <typename T>
+   void AppendRaw(TString &out, const T *values, Int_t n)
+   {
+      // Append the binary representation of the n values.
+
+      typedef typename TJSONBasic<T>::Stored_t Stored_t;
+#ifdef R__BYTESWAP
+      if (sizeof(Stored_t) == sizeof(T)) {
+         out.Append((const char*)values, n * sizeof(T));
+         return;
+      }
+#endif
+      for (Int_t i = 0; i < n; ++i) {
+         Stored_t value = (Stored_t)values[i];
+         AppendBytes(out, &value, sizeof(Stored_t));
+      }
+   }
+
+   inline Int_t Clamp(Int_t len, Int_t size, const char *buf)
+   {
+      // Length of the output of snprintf actually stored in buf.
+
+      return (len < 0 || len >= size) ? (Int_t)strlen(buf) : len;
+   }
+
+   inline Int_t FormatValue(char *buf, Int_t size, Bool_t v, const char *)
+   {
+      return Clamp(snprintf(buf, size, "%s", v ? "true" : "false"), size, buf);
+   }
+   inline Int_t FormatValue(char *buf, Int_t size, Char_t v, const char *)
+   {
+      return Clamp(snprintf(buf, size, "%d", (Int_t)v), size, buf);
+   }
+   inline Int_t FormatValue(char *buf, Int_t size, UChar_t v, const char *)
+   {
+      return Clamp(snprintf(buf, size, "%u", (UInt_t)v), size, buf);
+   }
+   inline Int_t FormatValue(char *buf, Int_t size, Short_t v, const char *)
+   {
+      return Clamp(snprintf(buf, size, "%d", (Int_t)v), size, buf);
+   }
+   inline Int_t FormatValue(char *buf, Int_t size, UShort_t v, const char *)
+   {
+      return Clamp(snprintf(buf, size, "%u", (UInt_t)v), size, buf);
+   }
+   inline Int_t FormatValue(char *buf, Int_t size, Int_t v, const char *)
+   {
+      return Clamp(snprintf(buf, size, "%d", v), size, buf);
+   }
+   inline Int_t FormatValue(char *buf, Int_t size, UInt_t v, const char *)
+   {
+      return Clamp(snprintf(buf, size, "%u", v), size, buf);
+   }
+   inline Int_t FormatValue(char *buf, Int_t size, Long_t v, const char *)
+   {
+      return Clamp(snprintf(buf, size, "%ld", v), size, buf);
+   }
+   inline Int_t FormatValue(char *buf, Int_t size, ULong_t v, const char *)
+   {
+      return Clamp(snprintf(buf, size, "%lu", v), size, buf);
+   }
+   inline Int_t FormatValue(char *buf, Int_t size, Long64_t v, const char *)
+   {
+      return Clamp(snprintf(buf, size, FLong64, v), size, buf);
+   }
+   inline Int_t FormatValue(char *buf, Int_t size, ULong64_t v, const char *)
+   {
+      return Clamp(snprintf(buf, size, FULong64, v), size, buf);
+   }
+   inline Int_t FormatValue(char *buf, Int_t size, Double_t v, const char *fmt)
+   {
+      // NaN and infinities can not be represented in JSON.
+      if (v != v || v > DBL_MAX || v < -DBL_MAX) {
+         return Clamp(snprintf(buf, size, "null"), size, buf);
+      }
+      return Clamp(snprintf(buf, size, fmt, v), size, buf);
+   }
+   inline Int_t FormatValue(char *buf, Int_t size, Float_t v, const char *fmt)
+   {
+      return FormatValue(buf, size, (Double_t)v, fmt);
+   }
+
+   template <typename T>
+   void AppendJSONValues(TString &out, const T *values, Int_t first, Int_t last, const char *fmt)
+   {
+      // Append the comma separated values [first,last).
+
+      char buf[64];
+      for (Int_t i = first; i < last; ++i) {
+         if (i > first) out.Append(',');
+         out.Append(buf, FormatValue(buf, sizeof(buf), values[i], fmt));
+      }
+   }
+
+   template <typename T>
+   void AppendArray(TString &out, TBufferJSON::EFormat format, Int_t compact, const T *values, Int_t n, const char *fmt)
+   {
+      // Append an array of basic values as one column of the binary
+      // encoding or as a JSON array, suppressing the leading and trailing
+      // zeros if requested.
+
+      if (n < 0) n = 0;
+      if (format == TBufferJSON::kBinary) {
+         out.Append('a');
+         out.Append(TJSONBasic<T>::Code());
+         ULong64_t len = n;
+         do {
+            UChar_t byte = len & 0x7f;
+            len >>= 7;
+            if (len) byte |= 0x80;
+            out.Append((char)byte);
+         } while (len);
+         AppendRaw(out, values, n);
+         return;
+      }
+      if (compact > 0 && n > 4) {
+         Int_t first = 0;
+         while (first < n && values[first] == 0) ++first;
+         Int_t last = n;
+         while (last > first && values[last-1] == 0) --last;
+         if (n - (last - first) > 4) {
+            out += "{\"$arr\":\"";
+            out += TJSONBasic<T>::Name();
+            out += "\",\"len\":";
+            out += n;
+            if (last > first) {
+               if (first > 0) {
+                  out += ",\"p\":";
+                  out += first;
+               }
+               out += ",\"v\":[";
+               AppendJSONValues(out, values, first, last, fmt);
+               out.Append(']');
+            }
+            out.Append('}');
+            return;
+         }
+      }
+      out.Append('[');
+      AppendJSONValues(out, values, 0, n, fmt);
+      out.Append(']');
+   }
+
+   template <typename T>
+   void AppendBasic(TString &out, TBufferJSON::EFormat format, T value, const char *fmt)
+   {
+      // Append a single basic value.
+
+      if (format == TBufferJSON::kBinary) {
+         out.Append(TJSONBasic<T>::Code());
+         AppendRaw(out, &value, 1);
+      } else {
+         char buf[64];
+         out.Append(buf, FormatValue(buf, sizeof(buf), value, fmt));
+      }
+   }
+}
+
+// TJSONStackObj keeps the state of one class level of the streamed
+// objects: the element currently written and the position of its value
+// in the output, which is post-processed once the element is complete.
+
+class TJSONStackObj : public TObject {
+public:
+   TJSONStackObj(TStreamerInfo *info, Bool_t isObject) :
+      TObject(),
+      fInfo(info),
+      fElem(0),
+      fElemNumber(-1),
+      fIsObject(isObject),
+      fTObjectMember(-1),
+      fValuePos(-1),
+      fLastChunkPos(-1),
+      fNumChunks(0),
+      fFirstIsScalar(kFALSE),
+      fLastIsArray(kFALSE)
+   {}
+
+   TStreamerInfo    *fInfo;          // StreamerInfo of the class, 0 for custom streamers
+   TStreamerElement *fElem;          // element currently written
+   Int_t             fElemNumber;    // index of fElem in the StreamerInfo
+   TString           fName;          // name of the data member currently written
+   Bool_t            fIsObject;      // the level opened an object which is closed with the level
+   Int_t             fTObjectMember; // index of the next TObject data member, -1 if not streaming TObject
+   Int_t             fValuePos;      // position of the value of the current element, -1 if nothing written yet
+   Int_t             fLastChunkPos;  // position of the last item written for the current element
+   Int_t             fNumChunks;     // number of items written for the current element
+   Bool_t            fFirstIsScalar; // the first item is a single basic value
+   Bool_t            fLastIsArray;   // the last item is an array of basic values
+};
+
+//______________________________________________________________________________
+TBufferJSON::TBufferJSON(EFormat format) :
+   TBufferFile(TBuffer::kWrite),
+   fOutBuffer(),
+   fFormat(format),
+   fCompact(0),
+   fStack(),
+   fObjects(),
+   fNames(),
+   fExpectedChain(kFALSE),
+   fExpectedBaseClass(0)
+{
+   // Creates buffer object to serialize data to JSON or, if format is
+   // kBinary, to the binary encoding described in the class documentation.
+
+   fBufSize = 1000000000;
+
+   SetParent(0);
+   SetBit(kCannotHandleMemberWiseStreaming);
+   SetBit(kTextBasedStreaming);
+
+   fStack.SetOwner(kTRUE);
+   if (fFormat == kBinary) fOutBuffer = "RJB1";
+}
+
+//______________________________________________________________________________
+TBufferJSON::~TBufferJSON()
+{
+   // destroy buffer
+
+   fStack.Delete();
+}
+
+//______________________________________________________________________________
+TString TBufferJSON::ConvertToJSON(const TObject *obj, Int_t compact)
+{
+   // Converts object, inherited from TObject class, to JSON string.
+
+   return ConvertToJSON(obj, obj ? obj->IsA() : 0, compact);
+}
+
+//______________________________________________________________________________
+TString TBufferJSON::ConvertToJSON(const void *obj, const TClass *cl, Int_t compact)
+{
+   // Converts any type of object to JSON string.
+   // With compact>0, arrays with leading or trailing zeros are written in
+   // the zero suppressed form (see class documentation).
+
+   TBufferJSON buf(kJSON);
+   buf.SetCompact(compact);
+   buf.WriteAny(obj, cl);
+   return buf.fOutBuffer;
+}
+
+//______________________________________________________________________________
+TString TBufferJSON::ConvertToBinary(const TObject *obj)
+{
+   // Converts object, inherited from TObject class, to the binary encoding.
+
+   return ConvertToBinary(obj, obj ? obj->IsA() : 0);
+}
+
+//______________________________________________________________________________
+TString TBufferJSON::ConvertToBinary(const void *obj, const TClass *cl)
+{
+   // Converts any type of object to the binary encoding described in the
+   // class documentation.  The result contains binary data, its size is
+   // given by TString::Length().
+
+   TBufferJSON buf(kBinary);
+   buf.WriteAny(obj, cl);
+   return buf.fOutBuffer;
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteAny(const void *obj, const TClass *cl)
+{
+   // Append the object to the output (see GetOutput()).
+   // In JSON, successive objects are separated by a new line.
+
+   if (fFormat == kJSON && fOutBuffer.Length() > 0) fOutBuffer.Append('\n');
+   JsonWriteObject(obj, cl);
+}
+
+//______________________________________________________________________________
+TJSONStackObj* TBufferJSON::PushStack(TStreamerInfo *info, Bool_t isObject)
+{
+   // add new level to the stack
+
+   TJSONStackObj* stack = new TJSONStackObj(info, isObject);
+   fStack.Add(stack);
+   return stack;
+}
+
+//______________________________________________________________________________
+void TBufferJSON::PopStack()
+{
+   // remove one level from the stack
+
+   TObject* last = fStack.Last();
+   if (last) {
+      fStack.Remove(last);
+      delete last;
+      fStack.Compress();
+   }
+}
+
+//______________________________________________________________________________
+TJSONStackObj* TBufferJSON::Stack()
+{
+   // return the current level of the stack, 0 if it is empty
+
+   return (TJSONStackObj*) fStack.Last();
+}
+
+//______________________________________________________________________________
+void TBufferJSON::JsonWriteVarInt(ULong64_t value)
+{
+   // Write an unsigned LEB128 number (binary encoding only).
+
+   do {
+      UChar_t byte = value & 0x7f;
+      value >>= 7;
+      if (value) byte |= 0x80;
+      fOutBuffer.Append((char)byte);
+   } while (value);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::JsonWriteString(const char *str, Int_t len)
+{
+   // Write a string value.
+
+   if (len < 0) len = str ? strlen(str) : 0;
+
+   if (fFormat == kBinary) {
+      fOutBuffer.Append('s');
+      JsonWriteVarInt(len);
+      if (len > 0) fOutBuffer.Append(str, len);
+      return;
+   }
+
+   fOutBuffer.Append('"');
+   for (Int_t i = 0; i < len; ++i) {
+      char c = str[i];
+      switch (c) {
+         case '"':  fOutBuffer.Append("\\\""); break;
+         case '\\': fOutBuffer.Append("\\\\"); break;
+         case '\n': fOutBuffer.Append("\\n"); break;
+         case '\r': fOutBuffer.Append("\\r"); break;
+         case '\t': fOutBuffer.Append("\\t"); break;
+         case '\b': fOutBuffer.Append("\\b"); break;
+         case '\f': fOutBuffer.Append("\\f"); break;
+         default:
+            if ((UChar_t)c < 0x20) {
+               char buf[8];
+               snprintf(buf, sizeof(buf), "\\u%04x", (UInt_t)(UChar_t)c);
+               fOutBuffer.Append(buf);
+            } else {
+               fOutBuffer.Append(c);
+            }
+      }
+   }
+   fOutBuffer.Append('"');
+}
+
+//______________________________________________________________________________
+void TBufferJSON::JsonWriteMemberName(const char *name)
+{
+   // Write the name of the next data member of the current object.
+
+   if (fFormat == kBinary) {
+      fOutBuffer.Append(':');
+      JsonWriteNameRef(name);
+      return;
+   }
+
+   Int_t len = fOutBuffer.Length();
+   if (len > 0 && fOutBuffer[len-1] != '{' && fOutBuffer[len-1] != '[') fOutBuffer.Append(',');
+   JsonWriteString(name);
+   fOutBuffer.Append(':');
+}
+
+//______________________________________________________________________________
+void TBufferJSON::JsonWriteNameRef(const char *name)
+{
+   // Write a class or member name in the binary encoding: the index of
+   // the name if it was already written, otherwise 0 followed by the name.
+
+   std::map<std::string,UInt_t>::iterator iter = fNames.find(name);
+   if (iter != fNames.end()) {
+      JsonWriteVarInt(iter->second);
+      return;
+   }
+   UInt_t id = fNames.size() + 1;
+   fNames[name] = id;
+   Int_t len = strlen(name);
+   JsonWriteVarInt(0);
+   JsonWriteVarInt(len);
+   fOutBuffer.Append(name, len);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::JsonStartObject(const TClass *cl)
+{
+   // Open a new object of class cl.
+
+   fOutBuffer.Append('{');
+   if (fFormat == kBinary) {
+      JsonWriteNameRef(cl->GetName());
+      return;
+   }
+   JsonWriteMemberName("_typename");
+   JsonWriteString(cl->GetName());
+}
+
+//______________________________________________________________________________
+void TBufferJSON::JsonEndObject()
+{
+   // Close the current object.
+
+   fOutBuffer.Append('}');
+}
+
+//______________________________________________________________________________
+void TBufferJSON::BeginChunk(EChunkKind kind)
+{
+   // Called before writing any value: write the name of the current data
+   // member before its first value and a separator before the next ones.
+
+   TJSONStackObj* stack = Stack();
+   if (stack == 0) return;
+
+   if (stack->fTObjectMember >= 0) {
+      // TObject::Streamer writes its data members one after the other.
+      static const char* names[] = { "fUniqueID", "fBits", "fPidf" };
+      JsonWriteMemberName(stack->fTObjectMember < 3 ? names[stack->fTObjectMember] : "_data");
+      stack->fTObjectMember++;
+      return;
+   }
+
+   // Data written by a custom streamer without any element information.
+   if (stack->fName.Length() == 0) stack->fName = "_data";
+
+   if (stack->fValuePos < 0) {
+      JsonWriteMemberName(stack->fName);
+      stack->fValuePos = fOutBuffer.Length();
+      stack->fFirstIsScalar = (kind == kScalarChunk);
+   } else if (fFormat == kJSON) {
+      fOutBuffer.Append(',');
+   }
+   stack->fLastChunkPos = fOutBuffer.Length();
+   stack->fLastIsArray = (kind == kArrayChunk);
+   stack->fNumChunks++;
+}
+
+//______________________________________________________________________________
+void TBufferJSON::EndElement(TJSONStackObj *stack)
+{
+   // Complete the value of the current element of the stack level: a data
+   // member written with several calls becomes a list, except for a size
+   // followed by an array (TArray, WriteArray, pointer to array) where only
+   // the array is kept.
+
+   if (stack == 0 || stack->fValuePos < 0) return;
+
+   if (stack->fNumChunks == 2 && stack->fFirstIsScalar && stack->fLastIsArray) {
+      fOutBuffer.Remove(stack->fValuePos, stack->fLastChunkPos - stack->fValuePos);
+   } else if (stack->fNumChunks > 1) {
+      fOutBuffer.Insert(stack->fValuePos, "[");
+      fOutBuffer.Append(']');
+   }
+
+   stack->fValuePos = -1;
+   stack->fLastChunkPos = -1;
+   stack->fNumChunks = 0;
+}
+
+//______________________________________________________________________________
+void TBufferJSON::JsonWriteObject(const void *obj, const TClass *cl)
+{
+   // Write object to the output.
+   // If object was written before, only a reference to it is stored.
+
+   if (obj == 0 || cl == 0) {
+      if (fFormat == kBinary) fOutBuffer.Append('n');
+      else                    fOutBuffer.Append("null");
+      return;
+   }
+
+   std::pair<const void*,const TClass*> key(obj, cl);
+   std::map<std::pair<const void*,const TClass*>,Int_t>::iterator iter = fObjects.find(key);
+   if (iter != fObjects.end()) {
+      if (fFormat == kBinary) {
+         fOutBuffer.Append('r');
+         JsonWriteVarInt(iter->second);
+      } else {
+         fOutBuffer.Append("{\"$ref\":");
+         fOutBuffer += iter->second;
+         fOutBuffer.Append('}');
+      }
+      return;
+   }
+   Int_t index = fObjects.size();
+   fObjects[key] = index;
+
+   JsonStartObject(cl);
+
+   if (cl->InheritsFrom(TCollection::Class())) {
+      const TCollection* coll = (const TCollection*) ((const char*)obj + const_cast<TClass*>(cl)->GetBaseClassOffset(TCollection::Class()));
+      JsonWriteCollection(coll);
+   } else {
+      // The streamer of the class fills this object.
+      PushStack(0, kFALSE);
+      fExpectedBaseClass = const_cast<TClass*>(cl);
+      const_cast<TClass*>(cl)->Streamer((void*)obj, *this);
+      fExpectedBaseClass = 0;
+      EndElement(Stack());
+      PopStack();
+   }
+
+   JsonEndObject();
+
+   if (gDebug>1)
+      Info("JsonWriteObject","Done write for class: %s", cl->GetName());
+}
+
+//______________________________________________________________________________
+void TBufferJSON::JsonWriteCollection(const TCollection *coll)
+{
+   // Write the content of a collection as list of objects, followed for
+   // TList by the list of the options of the objects.
+
+   JsonWriteMemberName("name");
+   JsonWriteString(coll->GetName());
+
+   JsonWriteMemberName("arr");
+   fOutBuffer.Append('[');
+   TIter iter(coll);
+   TObject* obj = 0;
+   Bool_t first = kTRUE;
+   while ((obj = iter())) {
+      if (!first && fFormat == kJSON) fOutBuffer.Append(',');
+      first = kFALSE;
+      JsonWriteObject(obj, obj->IsA());
+   }
+   fOutBuffer.Append(']');
+
+   if (coll->InheritsFrom(TList::Class())) {
+      JsonWriteMemberName("opt");
+      fOutBuffer.Append('[');
+      TIter optiter(coll);
+      first = kTRUE;
+      while (optiter()) {
+         if (!first && fFormat == kJSON) fOutBuffer.Append(',');
+         first = kFALSE;
+         JsonWriteString(optiter.GetOption());
+      }
+      fOutBuffer.Append(']');
+   }
+}
+
+//______________________________________________________________________________
+void TBufferJSON::IncrementLevel(TVirtualStreamerInfo* info)
+{
+   // Function is called from TStreamerInfo WriteBuffer functions.
+   // This call indicates, that TStreamerInfo functions starts streaming
+   // object data of correspondent class
+
+   WorkWithClass((TStreamerInfo*)info);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WorkWithClass(TStreamerInfo* sinfo, const TClass* cl)
+{
+   // Prepares buffer to stream data of specified class: data of a base
+   // class is merged into the current object, otherwise a new object is
+   // started as value of the current data member.
+
+   fExpectedChain = kFALSE;
+
+   if (sinfo!=0) cl = sinfo->GetClass();
+
+   Bool_t merge = (cl!=0) && (fExpectedBaseClass==cl) && (Stack()!=0);
+   fExpectedBaseClass = 0;
+
+   if (gDebug>2) Info("IncrementLevel","Class: %s", cl ? cl->GetName() : "custom");
+
+   if (!merge && (cl!=0)) {
+      BeginChunk(kObjectChunk);
+      JsonStartObject(cl);
+   }
+
+   PushStack(sinfo, !merge && (cl!=0));
+}
+
+//______________________________________________________________________________
+void TBufferJSON::DecrementLevel(TVirtualStreamerInfo* info)
+{
+   // Function is called from TStreamerInfo WriteBuffer functions
+   // and closes the level opened by IncrementLevel.
+
+   if (gDebug>2)
+      Info("DecrementLevel","Class: %s", (info ? info->GetClass()->GetName() : "custom"));
+
+   EndClass();
+}
+
+//______________________________________________________________________________
+void TBufferJSON::EndClass()
+{
+   // Close the current class level (and its object if it opened one).
+
+   fExpectedChain = kFALSE;
+   fExpectedBaseClass = 0;
+
+   TJSONStackObj* stack = Stack();
+   if (stack==0) {
+      Error("DecrementLevel", "stack is empty");
+      return;
+   }
+
+   EndElement(stack);
+   Bool_t isObject = stack->fIsObject;
+   PopStack();
+   if (isObject) JsonEndObject();
+}
+
+//______________________________________________________________________________
+void TBufferJSON::SetStreamerElementNumber(Int_t number)
+{
+   // Function is called from TStreamerInfo WriteBuffer functions
+   // and announces the next data member.
+
+   TJSONStackObj* stack = Stack();
+   if ((stack==0) || (stack->fInfo==0)) {
+      Error("SetStreamerElementNumber", "Problem in Inc/Dec level");
+      return;
+   }
+
+   TStreamerElement* elem = stack->fInfo->GetStreamerElementReal(number, 0);
+   if (elem==0) {
+      Error("SetStreamerElementNumber", "streamer info returns elem = 0");
+      return;
+   }
+
+   WorkWithElement(elem->GetName(), elem, number);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WorkWithElement(const char *name, TStreamerElement* elem, Int_t number)
+{
+   // Complete the previous data member of the current level and prepare
+   // for the next one.
+
+   fExpectedChain = kFALSE;
+   fExpectedBaseClass = 0;
+
+   TJSONStackObj* stack = Stack();
+   if (stack==0) {
+      Error("SetStreamerElementNumber", "stack is empty");
+      return;
+   }
+
+   EndElement(stack);
+
+   stack->fElem = elem;
+   stack->fElemNumber = number;
+   stack->fName = name;
+   stack->fTObjectMember = -1;
+
+   if (elem==0) return;
+
+   if (gDebug>4) Info("SetStreamerElementNumber", "    Next element %s", elem->GetName());
+
+   Int_t type = elem->GetType();
+   Bool_t isBasicType = (type>0) && (type<20);
+
+   if (isBasicType && (number>=0) && stack->fInfo) {
+      Int_t comp_type = stack->fInfo->GetTypes()[number];
+      fExpectedChain = (comp_type - type == TStreamerInfo::kOffsetL);
+   }
+
+   if ((type==TStreamerInfo::kBase) ||
+       ((type==TStreamerInfo::kTNamed) && !strcmp(elem->GetName(), TNamed::Class()->GetName()))) {
+      fExpectedBaseClass = elem->GetClassPointer();
+      // The TArray classes have custom streamers writing the size and the content.
+      if (fExpectedBaseClass && fExpectedBaseClass->InheritsFrom(TArray::Class()))
+         stack->fName = "fArray";
+   }
+
+   if ((type==TStreamerInfo::kTObject) && !strcmp(elem->GetName(), TObject::Class()->GetName()))
+      stack->fTObjectMember = 0;
+}
+
+//______________________________________________________________________________
+void TBufferJSON::ClassBegin(const TClass* cl, Version_t)
+{
+   // Should be called in the beginning of custom class streamer.
+
+   WorkWithClass(0, cl);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::ClassEnd(const TClass*)
+{
+   // Should be called at the end of custom streamer.
+
+   EndClass();
+}
+
+//______________________________________________________________________________
+void TBufferJSON::ClassMember(const char* name, const char* typeName, Int_t, Int_t)
+{
+   // Announces the next data member written by a custom streamer.
+   // When name and typeName are the name of a class, the data of this base
+   // class is merged into the current object.
+
+   if ((name==0) || (strlen(name)==0)) {
+      Error("ClassMember","Invalid member name");
+      return;
+   }
+
+   WorkWithElement(name, 0, -1);
+
+   if ((typeName!=0) && !strcmp(name, typeName)) {
+      TClass* cl = TClass::GetClass(typeName);
+      if (cl) fExpectedBaseClass = cl;
+   }
+}
+
+//______________________________________________________________________________
+TClass* TBufferJSON::ReadClass(const TClass*, UInt_t*)
+{
+   // suppressed function of TBuffer
+
+   return 0;
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteClass(const TClass*)
+{
+   // suppressed function of TBuffer
+
+}
+
+//______________________________________________________________________________
+Int_t TBufferJSON::CheckByteCount(UInt_t /*r_s */, UInt_t /*r_c*/, const TClass* /*cl*/)
+{
+   // suppressed function of TBuffer
+
+   return 0;
+}
+
+//______________________________________________________________________________
+Int_t  TBufferJSON::CheckByteCount(UInt_t, UInt_t, const char*)
+{
+   // suppressed function of TBuffer
+
+   return 0;
+}
+
+//______________________________________________________________________________
+void TBufferJSON::SetByteCount(UInt_t, Bool_t)
+{
+   // suppressed function of TBuffer
+
+}
+
+//______________________________________________________________________________
+UInt_t TBufferJSON::WriteVersion(const TClass *cl, Bool_t /* useBcnt */)
+{
+   // The class version is not written.
+
+   if (fExpectedBaseClass!=cl)
+      fExpectedBaseClass = 0;
+
+   return 0;
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteObject(const TObject *obj)
+{
+   // Convert object into JSON.
+   // Redefined here to avoid gcc 3.x warning
+
+   TBufferFile::WriteObject(obj);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteObjectClass(const void *actualObjStart, const TClass *actualClass)
+{
+   // Write object to buffer. Only used from TBuffer
+
+   if (gDebug>2)
+      Info("WriteObject","Class %s", (actualClass ? actualClass->GetName() : " null"));
+   BeginChunk(kObjectChunk);
+   JsonWriteObject(actualObjStart, actualClass);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::JsonWriteBasic(Bool_t value)    { AppendBasic(fOutBuffer, fFormat, value, 0); }
+void TBufferJSON::JsonWriteBasic(Char_t value)    { AppendBasic(fOutBuffer, fFormat, value, 0); }
+void TBufferJSON::JsonWriteBasic(UChar_t value)   { AppendBasic(fOutBuffer, fFormat, value, 0); }
+void TBufferJSON::JsonWriteBasic(Short_t value)   { AppendBasic(fOutBuffer, fFormat, value, 0); }
+void TBufferJSON::JsonWriteBasic(UShort_t value)  { AppendBasic(fOutBuffer, fFormat, value, 0); }
+void TBufferJSON::JsonWriteBasic(Int_t value)     { AppendBasic(fOutBuffer, fFormat, value, 0); }
+void TBufferJSON::JsonWriteBasic(UInt_t value)    { AppendBasic(fOutBuffer, fFormat, value, 0); }
+void TBufferJSON::JsonWriteBasic(Long_t value)    { AppendBasic(fOutBuffer, fFormat, value, 0); }
+void TBufferJSON::JsonWriteBasic(ULong_t value)   { AppendBasic(fOutBuffer, fFormat, value, 0); }
+void TBufferJSON::JsonWriteBasic(Long64_t value)  { AppendBasic(fOutBuffer, fFormat, value, 0); }
+void TBufferJSON::JsonWriteBasic(ULong64_t value) { AppendBasic(fOutBuffer, fFormat, value, 0); }
+void TBufferJSON::JsonWriteBasic(Float_t value)   { AppendBasic(fOutBuffer, fFormat, value, fgFloatFmt); }
+void TBufferJSON::JsonWriteBasic(Double_t value)  { AppendBasic(fOutBuffer, fFormat, value, fgDoubleFmt); }
+
+//______________________________________________________________________________
+void TBufferJSON::JsonWriteArray(const Bool_t    *b, Int_t n) { AppendArray(fOutBuffer, fFormat, fCompact, b, n, 0); }
+void TBufferJSON::JsonWriteArray(const UChar_t   *c, Int_t n) { AppendArray(fOutBuffer, fFormat, fCompact, c, n, 0); }
+void TBufferJSON::JsonWriteArray(const Short_t   *h, Int_t n) { AppendArray(fOutBuffer, fFormat, fCompact, h, n, 0); }
+void TBufferJSON::JsonWriteArray(const UShort_t  *h, Int_t n) { AppendArray(fOutBuffer, fFormat, fCompact, h, n, 0); }
+void TBufferJSON::JsonWriteArray(const Int_t     *i, Int_t n) { AppendArray(fOutBuffer, fFormat, fCompact, i, n, 0); }
+void TBufferJSON::JsonWriteArray(const UInt_t    *i, Int_t n) { AppendArray(fOutBuffer, fFormat, fCompact, i, n, 0); }
+void TBufferJSON::JsonWriteArray(const Long_t    *l, Int_t n) { AppendArray(fOutBuffer, fFormat, fCompact, l, n, 0); }
+void TBufferJSON::JsonWriteArray(const ULong_t   *l, Int_t n) { AppendArray(fOutBuffer, fFormat, fCompact, l, n, 0); }
+void TBufferJSON::JsonWriteArray(const Long64_t  *l, Int_t n) { AppendArray(fOutBuffer, fFormat, fCompact, l, n, 0); }
+void TBufferJSON::JsonWriteArray(const ULong64_t *l, Int_t n) { AppendArray(fOutBuffer, fFormat, fCompact, l, n, 0); }
+void TBufferJSON::JsonWriteArray(const Float_t   *f, Int_t n) { AppendArray(fOutBuffer, fFormat, fCompact, f, n, fgFloatFmt); }
+void TBufferJSON::JsonWriteArray(const Double_t  *d, Int_t n) { AppendArray(fOutBuffer, fFormat, fCompact, d, n, fgDoubleFmt); }
+
+//______________________________________________________________________________
+void TBufferJSON::JsonWriteArray(const Char_t *c, Int_t n)
+{
+   // Array of Char_t is written as string if it contains only text
+   // (possibly followed by zeros), otherwise as array of numbers.
+
+   Int_t len = 0;
+   while ((len<n) && (c[len]!=0)) len++;
+   Bool_t isText = kTRUE;
+   for (Int_t i=0; isText && (i<n); i++)
+      if ((i<len) ? ((UChar_t)c[i]<27) : (c[i]!=0)) isText = kFALSE;
+
+   if (isText) JsonWriteString(c, len);
+   else        AppendArray(fOutBuffer, fFormat, fCompact, c, n, 0);
+}
+
+// macro for the WriteArray functions, the size is part of the array
+#define TBufferJSON_WriteArray(vname) \
+{                                     \
+   BeginChunk(kArrayChunk);           \
+   JsonWriteArray(vname, n);          \
+}
+
+// macro for the WriteFastArray functions
+// macro also treat situation, when instead of one single array
+// chain of several elements should be produced
+#define TBufferJSON_WriteFastArray(vname)                                 \
+{                                                                         \
+   TJSONStackObj* stack = Stack();                                        \
+   TStreamerElement* elem = stack ? stack->fElem : 0;                     \
+   if ((elem!=0) && (elem->GetType()>TStreamerInfo::kOffsetL) &&          \
+       (elem->GetType()<TStreamerInfo::kOffsetP) &&                       \
+       (elem->GetArrayLength()!=n)) fExpectedChain = kTRUE;               \
+   if (fExpectedChain && (stack!=0) && (stack->fInfo!=0) && (n>0)) {      \
+      TStreamerInfo* info = stack->fInfo;                                 \
+      Int_t startnumber = stack->fElemNumber;                             \
+      fExpectedChain = kFALSE;                                            \
+      Int_t number = 0;                                                   \
+      Int_t index = 0;                                                    \
+      while (index<n) {                                                   \
+        elem = info->GetStreamerElementReal(startnumber, number++);       \
+        if (elem==0) break;                                               \
+        if (number>1) WorkWithElement(elem->GetName(), elem, -1);         \
+        if (elem->GetType()<TStreamerInfo::kOffsetL) {                    \
+          BeginChunk(kScalarChunk);                                       \
+          JsonWriteBasic(vname[index]);                                   \
+          index++;                                                        \
+        } else {                                                          \
+          Int_t elemlen = elem->GetArrayLength();                         \
+          if (elemlen<=0) break;                                          \
+          if (elemlen>n-index) elemlen = n-index;                         \
+          BeginChunk(kArrayChunk);                                        \
+          JsonWriteArray(vname+index, elemlen);                           \
+          index+=elemlen;                                                 \
+        }                                                                 \
+      }                                                                   \
+   } else {                                                               \
+      BeginChunk(kArrayChunk);                                            \
+      JsonWriteArray(vname, n);                                           \
+   }                                                                      \
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteFloat16 (Float_t *f, TStreamerElement * /*ele*/)
+{
+   // write a Float16_t to the buffer
+
+   WriteFloat(*f);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteDouble32 (Double_t *d, TStreamerElement * /*ele*/)
+{
+   // write a Double32_t to the buffer
+
+   WriteDouble(*d);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteArray(const Bool_t    *b, Int_t n)
+{
+   // Write array of Bool_t to buffer
+
+   TBufferJSON_WriteArray(b);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteArray(const Char_t    *c, Int_t n)
+{
+   // Write array of Char_t to buffer
+
+   TBufferJSON_WriteArray(c);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteArray(const UChar_t   *c, Int_t n)
+{
+   // Write array of UChar_t to buffer
+
+   TBufferJSON_WriteArray(c);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteArray(const Short_t   *h, Int_t n)
+{
+   // Write array of Short_t to buffer
+
+   TBufferJSON_WriteArray(h);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteArray(const UShort_t  *h, Int_t n)
+{
+   // Write array of UShort_t to buffer
+
+   TBufferJSON_WriteArray(h);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteArray(const Int_t     *i, Int_t n)
+{
+   // Write array of Int_ to buffer
+
+   TBufferJSON_WriteArray(i);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteArray(const UInt_t    *i, Int_t n)
+{
+   // Write array of UInt_t to buffer
+
+   TBufferJSON_WriteArray(i);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteArray(const Long_t    *l, Int_t n)
+{
+   // Write array of Long_t to buffer
+
+   TBufferJSON_WriteArray(l);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteArray(const ULong_t   *l, Int_t n)
+{
+   // Write array of ULong_t to buffer
+
+   TBufferJSON_WriteArray(l);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteArray(const Long64_t  *l, Int_t n)
+{
+   // Write array of Long64_t to buffer
+
+   TBufferJSON_WriteArray(l);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteArray(const ULong64_t *l, Int_t n)
+{
+   // Write array of ULong64_t to buffer
+
+   TBufferJSON_WriteArray(l);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteArray(const Float_t   *f, Int_t n)
+{
+   // Write array of Float_t to buffer
+
+   TBufferJSON_WriteArray(f);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteArray(const Double_t  *d, Int_t n)
+{
+   // Write array of Double_t to buffer
+
+   TBufferJSON_WriteArray(d);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteArrayFloat16(const Float_t  *f, Int_t n, TStreamerElement * /*ele*/)
+{
+   // Write array of Float16_t to buffer
+
+   TBufferJSON_WriteArray(f);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteArrayDouble32(const Double_t  *d, Int_t n, TStreamerElement * /*ele*/)
+{
+   // Write array of Double32_t to buffer
+
+   TBufferJSON_WriteArray(d);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteFastArray(const Bool_t    *b, Int_t n)
+{
+   // Write array of Bool_t to buffer
+
+   TBufferJSON_WriteFastArray(b);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteFastArray(const Char_t    *c, Int_t n)
+{
+   // Write array of Char_t to buffer
+
+   TBufferJSON_WriteFastArray(c);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteFastArray(const UChar_t   *c, Int_t n)
+{
+   // Write array of UChar_t to buffer
+
+   TBufferJSON_WriteFastArray(c);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteFastArray(const Short_t   *h, Int_t n)
+{
+   // Write array of Short_t to buffer
+
+   TBufferJSON_WriteFastArray(h);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteFastArray(const UShort_t  *h, Int_t n)
+{
+   // Write array of UShort_t to buffer
+
+   TBufferJSON_WriteFastArray(h);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteFastArray(const Int_t     *i, Int_t n)
+{
+   // Write array of Int_t to buffer
+
+   TBufferJSON_WriteFastArray(i);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteFastArray(const UInt_t    *i, Int_t n)
+{
+   // Write array of UInt_t to buffer
+
+   TBufferJSON_WriteFastArray(i);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteFastArray(const Long_t    *l, Int_t n)
+{
+   // Write array of Long_t to buffer
+
+   TBufferJSON_WriteFastArray(l);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteFastArray(const ULong_t   *l, Int_t n)
+{
+   // Write array of ULong_t to buffer
+
+   TBufferJSON_WriteFastArray(l);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteFastArray(const Long64_t  *l, Int_t n)
+{
+   // Write array of Long64_t to buffer
+
+   TBufferJSON_WriteFastArray(l);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteFastArray(const ULong64_t *l, Int_t n)
+{
+   // Write array of ULong64_t to buffer
+
+   TBufferJSON_WriteFastArray(l);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteFastArray(const Float_t   *f, Int_t n)
+{
+   // Write array of Float_t to buffer
+
+   TBufferJSON_WriteFastArray(f);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteFastArray(const Double_t  *d, Int_t n)
+{
+   // Write array of Double_t to buffer
+
+   TBufferJSON_WriteFastArray(d);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteFastArrayFloat16(const Float_t  *f, Int_t n, TStreamerElement * /*ele*/)
+{
+   // Write array of Float16_t to buffer
+
+   TBufferJSON_WriteFastArray(f);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteFastArrayDouble32(const Double_t  *d, Int_t n, TStreamerElement * /*ele*/)
+{
+   // Write array of Double32_t to buffer
+
+   TBufferJSON_WriteFastArray(d);
+}
+
+//______________________________________________________________________________
+void  TBufferJSON::WriteFastArray(void  *start,  const TClass *cl, Int_t n, TMemberStreamer *s)
+{
+   // Recall TBuffer function to avoid gcc warning message
+
+   TBufferFile::WriteFastArray(start, cl, n, s);
+}
+
+//______________________________________________________________________________
+Int_t TBufferJSON::WriteFastArray(void **startp, const TClass *cl, Int_t n, Bool_t isPreAlloc, TMemberStreamer *s)
+{
+   // Recall TBuffer function to avoid gcc warning message
+
+   return TBufferFile::WriteFastArray(startp, cl, n, isPreAlloc, s);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::StreamObject(void *obj, const type_info &typeinfo, const TClass* /* onFileClass */ )
+{
+   // stream object to buffer
+
+   StreamObject(obj, TClass::GetClass(typeinfo));
+}
+
+//______________________________________________________________________________
+void TBufferJSON::StreamObject(void *obj, const char *className, const TClass* /* onFileClass */ )
+{
+   // stream object to buffer
+
+   StreamObject(obj, TClass::GetClass(className));
+}
+
+//______________________________________________________________________________
+void TBufferJSON::StreamObject(TObject *obj)
+{
+   // stream object to buffer
+
+   StreamObject(obj, obj ? obj->IsA() : TObject::Class());
+}
+
+//______________________________________________________________________________
+void TBufferJSON::StreamObject(void *obj, const TClass *cl, const TClass* /* onfileClass */ )
+{
+   // stream object to buffer
+
+   if (gDebug>1)
+      Info("StreamObject","Class: %s", (cl ? cl->GetName() : "none"));
+   BeginChunk(kObjectChunk);
+   JsonWriteObject(obj, cl);
+}
+
+// macro for left shift operator for basic types
+#define TBufferJSON_operatorout(vname) \
+{                                      \
+   BeginChunk(kScalarChunk);           \
+   JsonWriteBasic(vname);              \
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteBool(Bool_t    b)
+{
+   // Writes Bool_t value to buffer
+
+   TBufferJSON_operatorout(b);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteChar(Char_t    c)
+{
+   // Writes Char_t value to buffer
+
+   TBufferJSON_operatorout(c);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteUChar(UChar_t   c)
+{
+   // Writes UChar_t value to buffer
+
+   TBufferJSON_operatorout(c);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteShort(Short_t   h)
+{
+   // Writes Short_t value to buffer
+
+   TBufferJSON_operatorout(h);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteUShort(UShort_t  h)
+{
+   // Writes UShort_t value to buffer
+
+   TBufferJSON_operatorout(h);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteInt(Int_t     i)
+{
+   // Writes Int_t value to buffer
+
+   TBufferJSON_operatorout(i);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteUInt(UInt_t    i)
+{
+   // Writes UInt_t value to buffer
+
+   TBufferJSON_operatorout(i);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteLong(Long_t    l)
+{
+   // Writes Long_t value to buffer
+
+   TBufferJSON_operatorout(l);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteULong(ULong_t   l)
+{
+   // Writes ULong_t value to buffer
+
+   TBufferJSON_operatorout(l);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteLong64(Long64_t  l)
+{
+   // Writes Long64_t value to buffer
+
+   TBufferJSON_operatorout(l);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteULong64(ULong64_t l)
+{
+   // Writes ULong64_t value to buffer
+
+   TBufferJSON_operatorout(l);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteFloat(Float_t   f)
+{
+   // Writes Float_t value to buffer
+
+   TBufferJSON_operatorout(f);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteDouble(Double_t  d)
+{
+   // Writes Double_t value to buffer
+
+   TBufferJSON_operatorout(d);
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteCharP(const Char_t *c)
+{
+   // Writes array of characters to buffer
+
+   BeginChunk(kScalarChunk);
+   if (c==0) {
+      if (fFormat == kBinary) fOutBuffer.Append('n');
+      else                    fOutBuffer.Append("null");
+   } else {
+      JsonWriteString(c);
+   }
+}
+
+//______________________________________________________________________________
+void TBufferJSON::WriteTString(const TString &s)
+{
+   // Writes a TString
+
+   BeginChunk(kScalarChunk);
+   JsonWriteString(s.Data(), s.Length());
+}
+
+//______________________________________________________________________________
+void TBufferJSON::SetFloatFormat(const char* fmt)
+{
+   // set printf format for float members, default "%g"
+
+   if (fmt==0) fmt = "%g";
+   fgFloatFmt = fmt;
+}
+
+//______________________________________________________________________________
+const char* TBufferJSON::GetFloatFormat()
+{
+   // return current printf format for float members, default "%g"
+
+   return fgFloatFmt;
+}
+
+//______________________________________________________________________________
+void TBufferJSON::SetDoubleFormat(const char* fmt)
+{
+   // set printf format for double members, default "%.14g"
+
+   if (fmt==0) fmt = "%.14g";
+   fgDoubleFmt = fmt;
+}
+
+//______________________________________________________________________________
+const char* TBufferJSON::GetDoubleFormat()
+{
+   // return current printf format for double members, default "%.14g"
+
+   return fgDoubleFmt;
+}
+
+//______________________________________________________________________________
+Int_t TBufferJSON::ApplySequence(const TStreamerInfoActions::TActionSequence &sequence, void *obj)
+{
+   // Write one object using the StreamerInfoAction, announcing each data member.
+
+   TVirtualStreamerInfo *info = sequence.fStreamerInfo;
+   IncrementLevel(info);
+
+   TStreamerInfoActions::ActionContainer_t::const_iterator end = sequence.fActions.end();
+   for(TStreamerInfoActions::ActionContainer_t::const_iterator iter = sequence.fActions.begin();
+       iter != end;
+       ++iter) {
+      SetStreamerElementNumber((*iter).fConfiguration->fElemId);
+      (*iter)(*this,obj);
+   }
+
+   DecrementLevel(info);
+   return 0;
+}
+
+//______________________________________________________________________________
+Int_t TBufferJSON::ApplySequenceVecPtr(const TStreamerInfoActions::TActionSequence &sequence, void *start_collection, void *end_collection)
+{
+   // Write one collection of objects using the StreamerInfoLoopAction.
+   // The collection needs to be a split TClonesArray or a split vector of pointers.
+
+   TVirtualStreamerInfo *info = sequence.fStreamerInfo;
+   IncrementLevel(info);
+
+   TStreamerInfoActions::ActionContainer_t::const_iterator end = sequence.fActions.end();
+   for(TStreamerInfoActions::ActionContainer_t::const_iterator iter = sequence.fActions.begin();
+       iter != end;
+       ++iter) {
+      SetStreamerElementNumber((*iter).fConfiguration->fElemId);
+      (*iter)(*this,start_collection,end_collection);
+   }
+
+   DecrementLevel(info);
+   return 0;
+}
+
+//______________________________________________________________________________
+Int_t TBufferJSON::ApplySequence(const TStreamerInfoActions::TActionSequence &sequence, void *start_collection, void *end_collection)
+{
+   // Write one collection of objects using the StreamerInfoLoopAction.
+
+   TVirtualStreamerInfo *info = sequence.fStreamerInfo;
+   IncrementLevel(info);
+
+   TStreamerInfoActions::TLoopConfiguration *loopconfig = sequence.fLoopConfig;
+   TStreamerInfoActions::ActionContainer_t::const_iterator end = sequence.fActions.end();
+   for(TStreamerInfoActions::ActionContainer_t::const_iterator iter = sequence.fActions.begin();
+       iter != end;
+       ++iter) {
+      SetStreamerElementNumber((*iter).fConfiguration->fElemId);
+      (*iter)(*this,start_collection,end_collection,loopconfig);
+   }
+
+   DecrementLevel(info);
+   return 0;
+}
@@ -61,6 +61,114 @@ struct SXmlDoc_t {
    char        *fDtdRoot;
 };
 
+struct SXmlNameTable_t {
+   char**       fSlots;     // open addressing table of interned names, 0 for empty slots
+   Int_t        fCapacity;  // number of slots, power of 2
+   Int_t        fCount;     // number of interned names
+
+   static UInt_t Hash(const char* str, Int_t len)
+   {
+      // FNV-1a hash of len characters
+      UInt_t hash = 2166136261U;
+      for (Int_t n=0;n<len;n++) {
+         hash ^= (UChar_t) str[n];
+         hash *= 16777619U;
+      }
+      return hash;
+   }
+};
+
+struct SXmlSAXBuffers_t {
+   // Buffers reused for all elements during SAX parsing
+
+   char*        fValues;     // unpacked attribute values, contents and comments
+   Int_t        fValuesSize;
+   Int_t        fValuesLen;
+   Int_t*       fOffsets;    // start of each attribute value in fValues
+   const char** fAttrs;      // name/value pairs given to the handler
+   Int_t        fAttrsSize;  // maximal number of attributes
+   Int_t        fNumAttrs;
+   const char** fStack;      // names of the open elements
+   Int_t        fStackSize;
+   Int_t        fDepth;
+
+   SXmlSAXBuffers_t() :
+      fValues(0), fValuesSize(0), fValuesLen(0),
+      fOffsets(0), fAttrs(0), fAttrsSize(0), fNumAttrs(0),
+      fStack(0), fStackSize(0), fDepth(0) {}
+
+   ~SXmlSAXBuffers_t()
+   {
+      free(fValues);
+      free(fOffsets);
+      free(fAttrs);
+      free(fStack);
+   }
+
+   char* ReserveValue(Int_t len)
+   {
+      // returns place for len symbols plus terminating 0 after the current values
+      if (fValuesLen+len+1>fValuesSize) {
+         Int_t newsize = 2*fValuesSize;
+         if (newsize<fValuesLen+len+1) newsize = fValuesLen+len+1;
+         if (newsize<1024) newsize = 1024;
+         char* newvalues = (char*) realloc(fValues, newsize);
+         if (newvalues==0) return 0;
+         fValues = newvalues;
+         fValuesSize = newsize;
+      }
+      return fValues + fValuesLen;
+   }
+
+   Bool_t ReserveAttrs(Int_t num)
+   {
+      // place for num attributes and the terminating null name
+      if (num<fAttrsSize) return kTRUE;
+      Int_t newsize = fAttrsSize<8 ? 8 : 2*fAttrsSize;
+      if (newsize<=num) newsize = num+1;
+      Int_t* newoffsets = (Int_t*) realloc(fOffsets, newsize*sizeof(Int_t));
+      if (newoffsets==0) return kFALSE;
+      fOffsets = newoffsets;
+      const char** newattrs = (const char**) realloc(fAttrs, (2*newsize+1)*sizeof(const char*));
+      if (newattrs==0) return kFALSE;
+      fAttrs = newattrs;
+      fAttrsSize = newsize;
+      return kTRUE;
+   }
+
+   Bool_t AddAttr(const char* name, Int_t valueoffset)
+   {
+      if (!ReserveAttrs(fNumAttrs+1)) return kFALSE;
+      fAttrs[2*fNumAttrs] = name;
+      fOffsets[fNumAttrs] = valueoffset;
+      fNumAttrs++;
+      return kTRUE;
+   }
+
+   const char** Attrs()
+   {
+      // values are assigned now, while fValues can be reallocated while reading the element
+      if (!ReserveAttrs(fNumAttrs)) return 0;
+      for (Int_t n=0;n<fNumAttrs;n++)
+         fAttrs[2*n+1] = fValues + fOffsets[n];
+      fAttrs[2*fNumAttrs] = 0;
+      return fAttrs;
+   }
+
+   Bool_t Push(const char* name)
+   {
+      if (fDepth>=fStackSize) {
+         Int_t newsize = fStackSize<16 ? 16 : 2*fStackSize;
+         const char** newstack = (const char**) realloc(fStack, newsize*sizeof(const char*));
+         if (newstack==0) return kFALSE;
+         fStack = newstack;
+         fStackSize = newsize;
+      }
+      fStack[fDepth++] = name;
+      return kTRUE;
+   }
+};
+
 class TXMLOutputStream {
 protected:
 
@@ -307,8 +415,12 @@ public:
 
       do {
          curr++;
-         while (curr+len>fMaxAddr)
+         while (curr+len>fMaxAddr) {
+            // buffer can be moved by ExpandStream
+            Int_t shift = curr - fCurrent;
             if (!ExpandStream()) return -1;
+            curr = fCurrent + shift;
+         }
          char* chk0 = curr;
          const char* chk = str;
          Bool_t find = kTRUE;
@@ -332,8 +444,11 @@ public:
 
       do {
          curr++;
-         if (curr>=fMaxAddr)
+         if (curr>=fMaxAddr) {
+            Int_t shift = curr - fCurrent;
             if (!ExpandStream()) return 0;
+            curr = fCurrent + shift;
+         }
          symb = *curr;
          ok = ((symb>='a') && (symb<='z')) ||
                ((symb>='A') && (symb<='Z')) ||
@@ -351,28 +466,33 @@ public:
          char symb = *curr;
          if (symb=='<') return curr - fCurrent;
          curr++;
-         if (curr>=fMaxAddr)
+         if (curr>=fMaxAddr) {
+            Int_t shift = curr - fCurrent;
             if (!ExpandStream()) return -1;
+            curr = fCurrent + shift;
+         }
       }
       return -1;
    }
 
    Int_t LocateAttributeValue(char* start)
    {
-      char* curr = start;
-      if (curr>=fMaxAddr)
+      // offsets are used, while ExpandStream can move the buffer
+      Int_t startpos = start - fCurrent;
+      Int_t pos = startpos;
+      if (fCurrent+pos>=fMaxAddr)
          if (!ExpandStream()) return 0;
-      if (*curr!='=') return 0;
-      curr++;
-      if (curr>=fMaxAddr)
+      if (fCurrent[pos]!='=') return 0;
+      pos++;
+      if (fCurrent+pos>=fMaxAddr)
          if (!ExpandStream()) return 0;
-      if (*curr!='"') return 0;
+      if (fCurrent[pos]!='"') return 0;
       do {
-         curr++;
-         if (curr>=fMaxAddr)
+         pos++;
+         if (fCurrent+pos>=fMaxAddr)
             if (!ExpandStream()) return 0;
-         if (*curr=='"') return curr-start+1;
-      } while (curr<fMaxAddr);
+         if (fCurrent[pos]=='"') return pos-startpos+1;
+      } while (fCurrent+pos<fMaxAddr);
       return 0;
    }
 };
@@ -382,6 +502,7 @@ TXMLEngine::TXMLEngine()
 {
    // default (normal) constructor of TXMLEngine class
    fSkipComments = kFALSE;
+   fNames = 0;
 }
 
 
@@ -390,6 +511,67 @@ TXMLEngine::~TXMLEngine()
 {
    // destructor for TXMLEngine object
 
+   SXmlNameTable_t* table = (SXmlNameTable_t*) fNames;
+   if (table!=0) {
+      for (Int_t n=0;n<table->fCapacity;n++)
+         free(table->fSlots[n]);
+      free(table->fSlots);
+      delete table;
+   }
+}
+
+//______________________________________________________________________________
+const char* TXMLEngine::Intern(const char* name, Int_t len)
+{
+   // Returns the unique copy of the first len characters of name (all
+   // characters if len<0) kept by the engine. The same pointer is returned
+   // for equal strings, therefore interned names can be compared by pointer.
+   // Names of elements and attributes given to TXMLSAXHandler are interned.
+
+   if (name==0) return 0;
+   if (len<0) len = strlen(name);
+
+   SXmlNameTable_t* table = (SXmlNameTable_t*) fNames;
+   if (table==0) {
+      table = new SXmlNameTable_t;
+      table->fCapacity = 256;
+      table->fCount = 0;
+      table->fSlots = (char**) calloc(table->fCapacity, sizeof(char*));
+      fNames = table;
+   }
+
+   UInt_t hash = SXmlNameTable_t::Hash(name, len);
+   UInt_t mask = table->fCapacity - 1;
+   UInt_t pos = hash & mask;
+   while (table->fSlots[pos]!=0) {
+      const char* slot = table->fSlots[pos];
+      if ((strncmp(slot, name, len)==0) && (slot[len]==0)) return slot;
+      pos = (pos + 1) & mask;
+   }
+
+   char* copy = (char*) malloc(len+1);
+   memcpy(copy, name, len);
+   copy[len] = 0;
+   table->fSlots[pos] = copy;
+   table->fCount++;
+
+   // keep the table at most half full
+   if (2*table->fCount > table->fCapacity) {
+      Int_t oldcapacity = table->fCapacity;
+      char** oldslots = table->fSlots;
+      table->fCapacity *= 2;
+      table->fSlots = (char**) calloc(table->fCapacity, sizeof(char*));
+      mask = table->fCapacity - 1;
+      for (Int_t n=0;n<oldcapacity;n++) {
+         if (oldslots[n]==0) continue;
+         pos = SXmlNameTable_t::Hash(oldslots[n], strlen(oldslots[n])) & mask;
+         while (table->fSlots[pos]!=0) pos = (pos + 1) & mask;
+         table->fSlots[pos] = oldslots[n];
+      }
+      free(oldslots);
+   }
+
+   return copy;
 }
 
 //______________________________________________________________________________
@@ -1132,6 +1314,180 @@ XMLDocPointer_t TXMLEngine::ParseStream(TXMLInputStream* inp)
    return xmldoc;
 }
 
+//______________________________________________________________________________
+Bool_t TXMLEngine::ParseFileSAX(const char* filename, TXMLSAXHandler* handler, Int_t maxbuf)
+{
+   // Parses content of file and reports elements, contents and comments
+   // to the handler as they are read, without building the node tree.
+   // Only a buffer of maxbuf bytes (at least 100000) of the file is kept
+   // in memory, enlarged only for tokens longer than the buffer.
+   // Returns kTRUE if the whole file was parsed.
+
+   if ((filename==0) || (strlen(filename)==0)) return kFALSE;
+   if (maxbuf < 100000) maxbuf = 100000;
+   TXMLInputStream inp(true, filename, maxbuf);
+   return ParseStreamSAX(&inp, handler);
+}
+
+//______________________________________________________________________________
+Bool_t TXMLEngine::ParseStringSAX(const char* xmlstring, TXMLSAXHandler* handler)
+{
+   // parses content of string and reports it to the handler, see ParseFileSAX()
+
+   if ((xmlstring==0) || (strlen(xmlstring)==0)) return kFALSE;
+   TXMLInputStream inp(false, xmlstring, 2*strlen(xmlstring) );
+   return ParseStreamSAX(&inp, handler);
+}
+
+//______________________________________________________________________________
+Bool_t TXMLEngine::ParseStreamSAX(TXMLInputStream* inp, TXMLSAXHandler* handler)
+{
+   // Parses content of the stream and calls the handler for each start and
+   // end of element, content and (if comments are not skipped) comment.
+   // Syntax is the same as accepted by ParseStream(); processing
+   // instructions like <?xml ... ?> are checked but not reported.
+   // Element names are reported with their namespace prefix.
+
+   if ((inp == 0) || (handler == 0)) return kFALSE;
+
+   SXmlSAXBuffers_t buf;
+   Int_t resvalue = 0;
+   Bool_t success = kFALSE;
+   Bool_t stopped = kFALSE;
+   Bool_t hasnodes = kFALSE;
+
+   while (!stopped) {
+
+      if (inp->EndOfStream() || !inp->SkipSpaces()) {
+         if (buf.fDepth>0) resvalue = -1; else
+         if (!hasnodes) resvalue = -1; else success = kTRUE;
+         break;
+      }
+
+      buf.fValuesLen = 0;
+      buf.fNumAttrs = 0;
+
+      if (inp->CheckFor("<!--")) {
+         Int_t commentlen = inp->SearchFor("-->");
+         if (commentlen<=0) { resvalue = -10; break; }
+         if (!fSkipComments) {
+            char* comment = buf.ReserveValue(commentlen);
+            if (comment==0) break;
+            strncpy(comment, inp->fCurrent, commentlen);
+            comment[commentlen] = 0;
+            if (!handler->OnComment(comment)) stopped = kTRUE;
+         }
+         if (!inp->ShiftCurrent(commentlen+3)) { resvalue = -1; break; }
+         continue;
+      }
+
+      if (*inp->fCurrent!='<') {
+         // content of the current element
+         if (buf.fDepth==0) { resvalue = -2; break; }
+         Int_t contlen = inp->LocateContent();
+         if (contlen<0) { resvalue = -1; break; }
+         char* content = buf.ReserveValue(contlen);
+         if (content==0) break;
+         UnpackSpecialCharacters(content, inp->fCurrent, contlen);
+         if (!handler->OnCharacters(content, strlen(content))) stopped = kTRUE;
+         if (!inp->ShiftCurrent(contlen)) { resvalue = -1; break; }
+         continue;
+      }
+
+      // skip "<" symbol
+      if (!inp->ShiftCurrent()) { resvalue = -1; break; }
+
+      if (*inp->fCurrent=='/') {
+         // this is a closing node
+         if (!inp->ShiftCurrent()) break;
+         if (!inp->SkipSpaces()) break;
+         Int_t len = inp->LocateIdentifier();
+         if (len<=0) { resvalue = -3; break; }
+         if (buf.fDepth==0) { resvalue = -4; break; }
+         const char* name = buf.fStack[buf.fDepth-1];
+         if ((strncmp(name, inp->fCurrent, len)!=0) || (name[len]!=0)) { resvalue = -5; break; }
+         if (!inp->ShiftCurrent(len)) break;
+         if (!inp->SkipSpaces()) break;
+         if (*inp->fCurrent!='>') break;
+         if (!inp->ShiftCurrent()) break;
+         buf.fDepth--;
+         if (!handler->OnEndElement(name)) stopped = kTRUE;
+         continue;
+      }
+
+      Bool_t ispinode = kFALSE;
+      char endsymbol = '/';
+
+      // this is case of processing instructions node
+      if (*inp->fCurrent=='?') {
+         if (!inp->ShiftCurrent()) break;
+         ispinode = kTRUE;
+         endsymbol = '?';
+      }
+
+      if (!inp->SkipSpaces()) break;
+      Int_t len = inp->LocateIdentifier();
+      if (len<=0) break;
+      const char* name = Intern(inp->fCurrent, len);
+      if (!inp->ShiftCurrent(len)) break;
+
+      Bool_t closed = kFALSE;  // element is completely read
+      Bool_t single = kFALSE;  // element closed with "/>"
+
+      do {
+         if (!inp->SkipSpaces()) break;
+
+         char nextsymb = *inp->fCurrent;
+
+         if (nextsymb==endsymbol) {  // this is end of short node like <node ... />
+            if (!inp->ShiftCurrent()) break;
+            if (*inp->fCurrent!='>') break;
+            if (!inp->ShiftCurrent()) break;
+            closed = single = kTRUE;
+         } else
+         if (nextsymb=='>') {
+            if (ispinode) { resvalue = -11; break; }
+            if (!inp->ShiftCurrent()) break;
+            closed = kTRUE;
+         } else {
+            Int_t attrlen = inp->LocateIdentifier();
+            if (attrlen<=0) { resvalue = -6; break; }
+
+            Int_t valuelen = inp->LocateAttributeValue(inp->fCurrent+attrlen);
+            if (valuelen<3) { resvalue = -7; break; }
+
+            const char* attrname = Intern(inp->fCurrent, attrlen);
+            char* value = buf.ReserveValue(valuelen-3);
+            if ((value==0) || !buf.AddAttr(attrname, buf.fValuesLen)) break;
+            UnpackSpecialCharacters(value, inp->fCurrent+attrlen+2, valuelen-3);
+            buf.fValuesLen += strlen(value) + 1;
+
+            if (!inp->ShiftCurrent(attrlen+valuelen)) break;
+         }
+      } while (!closed);
+
+      if (!closed) break;
+
+      hasnodes = kTRUE;
+      if (ispinode) continue;
+
+      const char** attrs = buf.Attrs();
+      if (attrs==0) break;
+
+      if (!handler->OnStartElement(name, attrs)) { stopped = kTRUE; continue; }
+
+      if (single) {
+         if (!handler->OnEndElement(name)) stopped = kTRUE;
+      } else
+      if (!buf.Push(name)) break;
+   }
+
+   if (!success && !stopped)
+      DisplayError(resvalue, inp->CurrentLine());
+
+   return success;
+}
+
 //______________________________________________________________________________
 Bool_t TXMLEngine::ValidateVersion(XMLDocPointer_t xmldoc, const char* version)
 {
@@ -0,0 +1,575 @@
+// @(#)root/mathcore:$Id$
+
+ /**********************************************************************
+  *                                                                    *
+  * Copyright (c) 2014 , LCG ROOT MathLib Team                         *
+  *                                                                    *
+  *                                                                    *
+  **********************************************************************/
+
+// Header file for the collections of vectors in structure of arrays layout:
+// classes Vector3DView, Vector3DArray, LorentzVectorView, LorentzVectorArray
+// and the VectorUtil functions working on them
+//
+#ifndef ROOT_Math_GenVector_VectorArray
+#define ROOT_Math_GenVector_VectorArray  1
+
+#ifndef ROOT_Math_GenVector_DisplacementVector3D
+#include "Math/GenVector/DisplacementVector3D.h"
+#endif
+
+#ifndef ROOT_Math_GenVector_Cartesian3D
+#include "Math/GenVector/Cartesian3D.h"
+#endif
+
+#ifndef ROOT_Math_GenVector_LorentzVector
+#include "Math/GenVector/LorentzVector.h"
+#endif
+
+#ifndef ROOT_Math_GenVector_PxPyPzE4D
+#include "Math/GenVector/PxPyPzE4D.h"
+#endif
+
+#ifndef ROOT_Math_GenVector_Boost
+#include "Math/GenVector/Boost.h"
+#endif
+
+#ifndef ROOT_Math_GenVector_eta
+#include "Math/GenVector/eta.h"
+#endif
+
+#include <vector>
+#include <cmath>
+
+namespace ROOT {
+
+   namespace Math {
+
+//__________________________________________________________________________________________
+/**
+    Vector3DView: view, without copy, of a collection of N 3D vectors whose Cartesian
+    components are stored in three separate arrays X[N], Y[N] and Z[N]
+    (structure of arrays layout). The arrays are not owned: they can be for example
+    the buffers of the array branches of a TTree (see LorentzVectorView).
+
+    The kinematic quantities (Rho, Eta, Phi, R) are computed for all the vectors at once
+    by a loop over contiguous memory, which the compiler can vectorize. The results are
+    the same as the ones of the corresponding member functions of
+    DisplacementVector3D< Cartesian3D<T> >.
+
+    @ingroup GenVector
+*/
+template <class T = double>
+class Vector3DView {
+
+public:
+
+   typedef T Scalar;
+   typedef DisplacementVector3D< Cartesian3D<T>, DefaultCoordinateSystemTag > Vector;
+
+   /**
+      Default constructor: empty view
+   */
+   Vector3DView() : fSize(0), fX(0), fY(0), fZ(0) {}
+
+   /**
+      Construct from the arrays of the n x, y and z components
+   */
+   Vector3DView(unsigned int n, const T * x, const T * y, const T * z) :
+      fSize(n), fX(x), fY(y), fZ(z) {}
+
+   /// number of vectors
+   unsigned int Size() const { return fSize; }
+
+   /// components of the vector i
+   T X(unsigned int i) const { return fX[i]; }
+   T Y(unsigned int i) const { return fY[i]; }
+   T Z(unsigned int i) const { return fZ[i]; }
+
+   /// arrays of the components
+   const T * X() const { return fX; }
+   const T * Y() const { return fY; }
+   const T * Z() const { return fZ; }
+
+   /// vector i
+   Vector operator[] (unsigned int i) const { return Vector(fX[i], fY[i], fZ[i]); }
+
+   /**
+      compute the transverse components (rho) of all the vectors in the array rho[Size()]
+   */
+   void Rho(T * rho) const {
+      for (unsigned int i = 0; i < fSize; ++i)
+         rho[i] = fX[i]*fX[i] + fY[i]*fY[i];
+      for (unsigned int i = 0; i < fSize; ++i)
+         rho[i] = std::sqrt(rho[i]);
+   }
+
+   /**
+      compute the magnitudes of all the vectors in the array r[Size()]
+   */
+   void R(T * r) const {
+      for (unsigned int i = 0; i < fSize; ++i)
+         r[i] = fX[i]*fX[i] + fY[i]*fY[i] + fZ[i]*fZ[i];
+      for (unsigned int i = 0; i < fSize; ++i)
+         r[i] = std::sqrt(r[i]);
+   }
+
+   /**
+      compute the pseudorapidities of all the vectors in the array eta[Size()]
+   */
+   void Eta(T * eta) const {
+      Rho(eta);
+      for (unsigned int i = 0; i < fSize; ++i)
+         eta[i] = Impl::Eta_FromRhoZ(eta[i], fZ[i]);
+   }
+
+   /**
+      compute the azimuthal angles of all the vectors in the array phi[Size()]
+   */
+   void Phi(T * phi) const {
+      for (unsigned int i = 0; i < fSize; ++i)
+         phi[i] = (fX[i] == 0.0 && fY[i] == 0.0) ? 0 : std::atan2(fY[i], fX[i]);
+   }
+
+protected:
+
+   unsigned int fSize;   // number of vectors
+   const T * fX;         // x components
+   const T * fY;         // y components
+   const T * fZ;         // z components
+
+};
+
+
+//__________________________________________________________________________________________
+/**
+    Vector3DArray: collection of 3D vectors owning its components, stored in
+    structure of arrays layout. It is a Vector3DView of its own data, which is
+    valid until the array is resized.
+
+    @ingroup GenVector
+*/
+template <class T = double>
+class Vector3DArray : public Vector3DView<T> {
+
+public:
+
+   typedef typename Vector3DView<T>::Vector Vector;
+
+   /**
+      Construct an array of n vectors with zero components
+   */
+   explicit Vector3DArray(unsigned int n = 0) :
+      fXData(n), fYData(n), fZData(n) { Update(); }
+
+   /**
+      Copy a view (or another array)
+   */
+   Vector3DArray(const Vector3DView<T> & v) :
+      fXData(v.X(), v.X() + v.Size()), fYData(v.Y(), v.Y() + v.Size()),
+      fZData(v.Z(), v.Z() + v.Size()) { Update(); }
+
+   Vector3DArray(const Vector3DArray & rhs) :
+      Vector3DView<T>(),
+      fXData(rhs.fXData), fYData(rhs.fYData), fZData(rhs.fZData) { Update(); }
+
+   Vector3DArray & operator= (const Vector3DArray & rhs) {
+      if (this != &rhs) {
+         fXData = rhs.fXData; fYData = rhs.fYData; fZData = rhs.fZData;
+         Update();
+      }
+      return *this;
+   }
+
+   /// change the number of vectors
+   void Resize(unsigned int n) {
+      fXData.resize(n); fYData.resize(n); fZData.resize(n);
+      Update();
+   }
+
+   /// reserve the memory for n vectors
+   void Reserve(unsigned int n) {
+      fXData.reserve(n); fYData.reserve(n); fZData.reserve(n);
+      Update();
+   }
+
+   /// remove all the vectors
+   void Clear() { Resize(0); }
+
+   /// add a vector, given in any coordinate system
+   template <class CoordSystem, class Tag>
+   void PushBack(const DisplacementVector3D<CoordSystem,Tag> & v) {
+      PushBack(v.X(), v.Y(), v.Z());
+   }
+
+   /// add a vector given its Cartesian components
+   void PushBack(T x, T y, T z) {
+      fXData.push_back(x); fYData.push_back(y); fZData.push_back(z);
+      Update();
+   }
+
+   /// set the vector i
+   template <class CoordSystem, class Tag>
+   void Set(unsigned int i, const DisplacementVector3D<CoordSystem,Tag> & v) {
+      SetXYZ(i, v.X(), v.Y(), v.Z());
+   }
+
+   /// set the components of the vector i
+   void SetXYZ(unsigned int i, T x, T y, T z) {
+      fXData[i] = x; fYData[i] = y; fZData[i] = z;
+   }
+
+   /// modifiable arrays of the components
+   T * X() { return fXData.empty() ? 0 : &fXData[0]; }
+   T * Y() { return fYData.empty() ? 0 : &fYData[0]; }
+   T * Z() { return fZData.empty() ? 0 : &fZData[0]; }
+
+   using Vector3DView<T>::X;
+   using Vector3DView<T>::Y;
+   using Vector3DView<T>::Z;
+
+private:
+
+   // point the view to the current data
+   void Update() {
+      this->fSize = fXData.size();
+      this->fX = X(); this->fY = Y(); this->fZ = Z();
+   }
+
+   std::vector<T> fXData;   // x components
+   std::vector<T> fYData;   // y components
+   std::vector<T> fZData;   // z components
+
+};
+
+
+//__________________________________________________________________________________________
+/**
+    LorentzVectorView: view, without copy, of a collection of N Lorentz vectors whose
+    components are stored in four separate arrays Px[N], Py[N], Pz[N] and E[N]
+    (structure of arrays layout). The arrays are not owned: they can be for example
+    the buffers of the array branches of a TTree, read without any copy:
+
+    \code
+    Int_t njet;
+    Float_t px[kMaxJet], py[kMaxJet], pz[kMaxJet], e[kMaxJet];
+    tree->SetBranchAddress("njet",&njet);
+    tree->SetBranchAddress("jet_px",px);
+    ....
+    std::vector<Float_t> mjj(kMaxJet*kMaxJet);
+    for (Long64_t ievt = 0; ievt < tree->GetEntries(); ++ievt) {
+       tree->GetEntry(ievt);
+       ROOT::Math::LorentzVectorView<Float_t> jets(njet, px, py, pz, e);
+       ROOT::Math::VectorUtil::InvariantMass(jets, jets, &mjj[0]);
+       ....
+    }
+    \endcode
+
+    The kinematic quantities (M, Pt, Eta, Phi) are computed for all the vectors at once
+    by a loop over contiguous memory, which the compiler can vectorize. The results are
+    the same as the ones of the corresponding member functions of
+    LorentzVector< PxPyPzE4D<T> >, except that no exception is thrown for
+    the tachyonic vectors (for which the mass is negative).
+    See also the VectorUtil functions DeltaR, InvariantMass and boost for collections.
+
+    @ingroup GenVector
+*/
+template <class T = double>
+class LorentzVectorView {
+
+public:
+
+   typedef T Scalar;
+   typedef LorentzVector< PxPyPzE4D<T> > Vector;
+
+   /**
+      Default constructor: empty view
+   */
+   LorentzVectorView() : fSize(0), fPx(0), fPy(0), fPz(0), fE(0) {}
+
+   /**
+      Construct from the arrays of the n px, py, pz and E components
+   */
+   LorentzVectorView(unsigned int n, const T * px, const T * py, const T * pz, const T * e) :
+      fSize(n), fPx(px), fPy(py), fPz(pz), fE(e) {}
+
+   /// number of vectors
+   unsigned int Size() const { return fSize; }
+
+   /// components of the vector i
+   T Px(unsigned int i) const { return fPx[i]; }
+   T Py(unsigned int i) const { return fPy[i]; }
+   T Pz(unsigned int i) const { return fPz[i]; }
+   T E (unsigned int i) const { return fE[i]; }
+
+   /// arrays of the components
+   const T * Px() const { return fPx; }
+   const T * Py() const { return fPy; }
+   const T * Pz() const { return fPz; }
+   const T * E () const { return fE; }
+
+   /// vector i
+   Vector operator[] (unsigned int i) const { return Vector(fPx[i], fPy[i], fPz[i], fE[i]); }
+
+   /// view of the spatial components
+   Vector3DView<T> Vect() const { return Vector3DView<T>(fSize, fPx, fPy, fPz); }
+
+   /**
+      compute the invariant masses of all the vectors in the array m[Size()]
+   */
+   void M(T * m) const {
+      for (unsigned int i = 0; i < fSize; ++i)
+         m[i] = fE[i]*fE[i] - fPx[i]*fPx[i] - fPy[i]*fPy[i] - fPz[i]*fPz[i];
+      for (unsigned int i = 0; i < fSize; ++i)
+         m[i] = (m[i] < 0) ? -std::sqrt(-m[i]) : std::sqrt(m[i]);
+   }
+
+   /**
+      compute the transverse momenta of all the vectors in the array pt[Size()]
+   */
+   void Pt(T * pt) const { Vect().Rho(pt); }
+
+   /**
+      compute the pseudorapidities of all the vectors in the array eta[Size()]
+   */
+   void Eta(T * eta) const { Vect().Eta(eta); }
+
+   /**
+      compute the azimuthal angles of all the vectors in the array phi[Size()]
+   */
+   void Phi(T * phi) const { Vect().Phi(phi); }
+
+protected:
+
+   unsigned int fSize;   // number of vectors
+   const T * fPx;        // x components
+   const T * fPy;        // y components
+   const T * fPz;        // z components
+   const T * fE;         // time components
+
+};
+
+
+//__________________________________________________________________________________________
+/**
+    LorentzVectorArray: collection of Lorentz vectors owning its components, stored in
+    structure of arrays layout. It is a LorentzVectorView of its own data, which is
+    valid until the array is resized.
+
+    @ingroup GenVector
+*/
+template <class T = double>
+class LorentzVectorArray : public LorentzVectorView<T> {
+
+public:
+
+   typedef typename LorentzVectorView<T>::Vector Vector;
+
+   /**
+      Construct an array of n vectors with zero components
+   */
+   explicit LorentzVectorArray(unsigned int n = 0) :
+      fPxData(n), fPyData(n), fPzData(n), fEData(n) { Update(); }
+
+   /**
+      Copy a view (or another array)
+   */
+   LorentzVectorArray(const LorentzVectorView<T> & v) :
+      fPxData(v.Px(), v.Px() + v.Size()), fPyData(v.Py(), v.Py() + v.Size()),
+      fPzData(v.Pz(), v.Pz() + v.Size()), fEData(v.E(), v.E() + v.Size()) { Update(); }
+
+   LorentzVectorArray(const LorentzVectorArray & rhs) :
+      LorentzVectorView<T>(),
+      fPxData(rhs.fPxData), fPyData(rhs.fPyData), fPzData(rhs.fPzData), fEData(rhs.fEData) { Update(); }
+
+   LorentzVectorArray & operator= (const LorentzVectorArray & rhs) {
+      if (this != &rhs) {
+         fPxData = rhs.fPxData; fPyData = rhs.fPyData; fPzData = rhs.fPzData; fEData = rhs.fEData;
+         Update();
+      }
+      return *this;
+   }
+
+   /// change the number of vectors
+   void Resize(unsigned int n) {
+      fPxData.resize(n); fPyData.resize(n); fPzData.resize(n); fEData.resize(n);
+      Update();
+   }
+
+   /// reserve the memory for n vectors
+   void Reserve(unsigned int n) {
+      fPxData.reserve(n); fPyData.reserve(n); fPzData.reserve(n); fEData.reserve(n);
+      Update();
+   }
+
+   /// remove all the vectors
+   void Clear() { Resize(0); }
+
+   /// add a vector, given in any coordinate system
+   template <class CoordSystem>
+   void PushBack(const LorentzVector<CoordSystem> & v) {
+      PushBack(v.Px(), v.Py(), v.Pz(), v.E());
+   }
+
+   /// add a vector given its px, py, pz and E components
+   void PushBack(T px, T py, T pz, T e) {
+      fPxData.push_back(px); fPyData.push_back(py); fPzData.push_back(pz); fEData.push_back(e);
+      Update();
+   }
+
+   /// set the vector i
+   template <class CoordSystem>
+   void Set(unsigned int i, const LorentzVector<CoordSystem> & v) {
+      SetPxPyPzE(i, v.Px(), v.Py(), v.Pz(), v.E());
+   }
+
+   /// set the components of the vector i
+   void SetPxPyPzE(unsigned int i, T px, T py, T pz, T e) {
+      fPxData[i] = px; fPyData[i] = py; fPzData[i] = pz; fEData[i] = e;
+   }
+
+   /// modifiable arrays of the components
+   T * Px() { return fPxData.empty() ? 0 : &fPxData[0]; }
+   T * Py() { return fPyData.empty() ? 0 : &fPyData[0]; }
+   T * Pz() { return fPzData.empty() ? 0 : &fPzData[0]; }
+   T * E () { return fEData.empty()  ? 0 : &fEData[0]; }
+
+   using LorentzVectorView<T>::Px;
+   using LorentzVectorView<T>::Py;
+   using LorentzVectorView<T>::Pz;
+   using LorentzVectorView<T>::E;
+
+private:
+
+   // point the view to the current data
+   void Update() {
+      this->fSize = fPxData.size();
+      this->fPx = Px(); this->fPy = Py(); this->fPz = Pz(); this->fE = E();
+   }
+
+   std::vector<T> fPxData;   // x components
+   std::vector<T> fPyData;   // y components
+   std::vector<T> fPzData;   // z components
+   std::vector<T> fEData;    // time components
+
+};
+
+
+   namespace VectorUtil {
+
+      /**
+         Compute the DeltaR distances between all the pairs of vectors of the collections
+         v1 and v2 (Vector3DView, LorentzVectorView or the corresponding arrays).
+         The distance between v1[i] and v2[j] is stored in dr[i*v2.Size() + j], the
+         array dr must have v1.Size()*v2.Size() elements.
+         The pseudorapidities and the azimuthal angles are computed only once for each
+         vector, then the distances are computed by vectorizable loops. The results are the
+         same as DeltaR(v1[i], v2[j]) for double precision vectors.
+      */
+      template <class View1, class View2>
+      void DeltaR(const View1 & v1, const View2 & v2, typename View1::Scalar * dr) {
+         typedef typename View1::Scalar T;
+         unsigned int n1 = v1.Size();
+         unsigned int n2 = v2.Size();
+         if (n1 == 0 || n2 == 0) return;
+         std::vector<T> eta1(n1), phi1(n1), eta2(n2), phi2(n2);
+         v1.Eta(&eta1[0]); v1.Phi(&phi1[0]);
+         v2.Eta(&eta2[0]); v2.Phi(&phi2[0]);
+         const T * peta2 = &eta2[0];
+         const T * pphi2 = &phi2[0];
+         for (unsigned int i = 0; i < n1; ++i) {
+            T * row = dr + i * n2;
+            const T eta = eta1[i];
+            const T phi = phi1[i];
+            for (unsigned int j = 0; j < n2; ++j) {
+               T dphi = pphi2[j] - phi;
+               if ( dphi > M_PI ) {
+                  dphi -= 2.0*M_PI;
+               } else if ( dphi <= -M_PI ) {
+                  dphi += 2.0*M_PI;
+               }
+               T deta = peta2[j] - eta;
+               row[j] = dphi*dphi + deta*deta;
+            }
+            for (unsigned int j = 0; j < n2; ++j)
+               row[j] = std::sqrt(row[j]);
+         }
+      }
+
+      /**
+         Compute the invariant masses of all the pairs of vectors of the collections
+         v1 and v2 (which can be the same collection). The mass of v1[i] + v2[j] is stored
+         in m[i*v2.Size() + j], the array m must have v1.Size()*v2.Size() elements.
+         The results are the same as InvariantMass(v1[i], v2[j]) for double precision
+         vectors.
+      */
+      template <class T>
+      void InvariantMass(const LorentzVectorView<T> & v1, const LorentzVectorView<T> & v2, T * m) {
+         unsigned int n1 = v1.Size();
+         unsigned int n2 = v2.Size();
+         const T * px2 = v2.Px();
+         const T * py2 = v2.Py();
+         const T * pz2 = v2.Pz();
+         const T * e2  = v2.E();
+         for (unsigned int i = 0; i < n1; ++i) {
+            T * row = m + i * n2;
+            const T px = v1.Px(i);
+            const T py = v1.Py(i);
+            const T pz = v1.Pz(i);
+            const T e  = v1.E(i);
+            for (unsigned int j = 0; j < n2; ++j) {
+               T ee = e  + e2[j];
+               T xx = px + px2[j];
+               T yy = py + py2[j];
+               T zz = pz + pz2[j];
+               T mm2 = ee*ee - xx*xx - yy*yy - zz*zz;
+               row[j] = mm2 < 0.0 ? -std::sqrt(-mm2) : std::sqrt(mm2);
+            }
+         }
+      }
+
+      /**
+         Apply the Lorentz boost b to all the vectors of the collection v, storing the
+         result in out (which is resized if needed and can be the same array as v).
+         The boost matrix is computed once; the results are the same as b(v[i]) for
+         double precision vectors.
+      */
+      template <class T>
+      void boost(const LorentzVectorView<T> & v, const Boost & b, LorentzVectorArray<T> & out) {
+         unsigned int n = v.Size();
+         if (out.Size() != n) out.Resize(n);
+         if (n == 0) return;
+         double r[16];
+         b.GetLorentzRotation(r);
+         const T rxx = r[Boost::kLXX], rxy = r[Boost::kLXY], rxz = r[Boost::kLXZ], rxt = r[Boost::kLXT];
+         const T ryy = r[Boost::kLYY], ryz = r[Boost::kLYZ], ryt = r[Boost::kLYT];
+         const T rzz = r[Boost::kLZZ], rzt = r[Boost::kLZT];
+         const T rtt = r[Boost::kLTT];
+         const T * px = v.Px();
+         const T * py = v.Py();
+         const T * pz = v.Pz();
+         const T * e  = v.E();
+         T * opx = out.Px();
+         T * opy = out.Py();
+         T * opz = out.Pz();
+         T * oe  = out.E();
+         for (unsigned int i = 0; i < n; ++i) {
+            T x = px[i];
+            T y = py[i];
+            T z = pz[i];
+            T t = e[i];
+            opx[i] = rxx*x + rxy*y + rxz*z + rxt*t;
+            opy[i] = rxy*x + ryy*y + ryz*z + ryt*t;
+            opz[i] = rxz*x + ryz*y + rzz*z + rzt*t;
+            oe[i]  = rxt*x + ryt*y + rzt*z + rtt*t;
+         }
+      }
+
+   }  // end namespace VectorUtil
+
+   }  // end namespace Math
+
+}  // end namespace ROOT
+
+
+#endif /* ROOT_Math_GenVector_VectorArray  */
@@ -0,0 +1,12 @@
+// @(#)root/mathcore:$Id$
+
+#ifndef ROOT_Math_VectorArray
+#define ROOT_Math_VectorArray
+
+// collections of 3D and Lorentz vectors in structure of arrays layout
+// and VectorUtil functions for them
+
+#include "Math/GenVector/VectorArray.h"
+
+
+#endif
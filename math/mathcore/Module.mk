@@ -27,6 +27,8 @@ MATHCOREDH2  := $(MODDIRI)/TRandom.h \
                 $(MODDIRI)/TRandom2.h \
 		$(MODDIRI)/TRandom3.h \
                 $(MODDIRI)/TStatistic.h \
+                $(MODDIRI)/TStatisticDecay.h \
+                $(MODDIRI)/TStatisticHistogram.h \
                 $(MODDIRI)/TVirtualFitter.h \
                 $(MODDIRI)/TKDTree.h \
                 $(MODDIRI)/TKDTreeBinning.h \
@@ -0,0 +1,173 @@
+// @(#)root/mathcore:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2014  LCG ROOT Math Team, CERN/PH-SFT                *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Header file for class BatchFitter
+
+#ifndef ROOT_Fit_BatchFitter
+#define ROOT_Fit_BatchFitter
+
+#ifndef ROOT_Fit_DataVectorfwd
+#include "Fit/DataVectorfwd.h"
+#endif
+
+#ifndef ROOT_Fit_FitConfig
+#include "Fit/FitConfig.h"
+#endif
+
+#ifndef ROOT_Fit_FitResult
+#include "Fit/FitResult.h"
+#endif
+
+#ifndef ROOT_Math_IParamFunctionfwd
+#include "Math/IParamFunctionfwd.h"
+#endif
+
+#include <vector>
+
+
+namespace ROOT {
+
+   namespace Fit {
+
+//___________________________________________________________________________________
+/**
+   BatchFitter class, performing many independent fits (for example the same model
+   fitted to many data sets, or the same data set fitted from different initial
+   parameter values) in parallel using ROOT::Math::ThreadPool.
+
+   The fits are added with AddFit (least square fit) or AddLikelihoodFit and are
+   all performed by calling Fit(). Each fit has its own FitConfig, copied at AddFit
+   from the common configuration Config() with the parameter settings created from
+   the model function; it can be modified afterwards with Config(ifit).
+   The data sets are not copied and must be kept alive until the fits are done.
+   The model functions are cloned and must be thread safe when evaluated with the
+   parameters passed as argument (this is not the case for interpreted TF1's).
+
+   The fits are split in chunks, each performed by a single ROOT::Fit::Fitter
+   re-using the same minimizer. The minimizers are all created before starting the
+   threads, since the plug-in manager is not thread safe. Minimizers which can
+   not be used concurrently (Minuit, Fumili and Linear) are run sequentially.
+   The results do not depend on the number of threads.
+
+   @ingroup FitMain
+*/
+class BatchFitter {
+
+public:
+
+   typedef ROOT::Math::IParamMultiFunction IModelFunction;
+
+   /**
+      Constructor, giving the number of threads (0 for the default number of
+      threads of ROOT::Math::ThreadPool)
+   */
+   BatchFitter (unsigned int nthreads = 0);
+
+   /**
+      Destructor
+   */
+   ~BatchFitter ();
+
+private:
+
+   // usually copying is non trivial, so we make this unaccessible
+   BatchFitter(const BatchFitter &);
+   BatchFitter & operator = (const BatchFitter & rhs);
+
+public:
+
+   /**
+      add a least square fit of the binned data with the model function func.
+      Return the index of the fit
+   */
+   unsigned int AddFit(const BinData & data, const IModelFunction & func, bool useGradient = false);
+
+   /**
+      add a binned likelihood fit of the data with the model function func.
+      Return the index of the fit
+   */
+   unsigned int AddLikelihoodFit(const BinData & data, const IModelFunction & func, bool extended = true, bool useGradient = false);
+
+   /**
+      add an unbinned likelihood fit of the data with the model function func.
+      Return the index of the fit
+   */
+   unsigned int AddLikelihoodFit(const UnBinData & data, const IModelFunction & func, bool extended = false, bool useGradient = false);
+
+   /**
+      perform all the added fits.
+      Return false if one of the fits failed
+   */
+   bool Fit();
+
+   /**
+      remove all the fits and their results
+   */
+   void Clear();
+
+   /**
+      number of added fits
+   */
+   unsigned int NFits() const { return fFits.size(); }
+
+   /**
+      return the index of the valid fit with the smallest minimum value of the
+      objective function (e.g. for a multi-start fit), or -1 if no fit is valid
+   */
+   int BestFit() const;
+
+   /**
+      access to the result of the fit ifit (after calling Fit())
+   */
+   const FitResult & Result(unsigned int ifit) const;
+
+   /**
+      access to the common configuration, copied in the fits when they are added
+   */
+   FitConfig & Config() { return fConfig; }
+   const FitConfig & Config() const { return fConfig; }
+
+   /**
+      access to the configuration of the fit ifit
+   */
+   FitConfig & Config(unsigned int ifit);
+   const FitConfig & Config(unsigned int ifit) const;
+
+   /**
+      set the number of threads (0 for the default number of ROOT::Math::ThreadPool)
+   */
+   void SetNThreads(unsigned int nthreads) { fNThreads = nthreads; }
+
+   /**
+      return the number of threads
+   */
+   unsigned int NThreads() const { return fNThreads; }
+
+   /// description of a fit (for internal use, defined in BatchFitter.cxx)
+   struct FitJob;
+
+private:
+
+   unsigned int DoAddFit(int type, const BinData * bdata, const UnBinData * udata,
+                         const IModelFunction & func, bool extended, bool useGradient);
+
+   unsigned int fNThreads;           // number of threads (0 for the ThreadPool default)
+
+   FitConfig fConfig;                // common configuration of the fits
+
+   std::vector<FitJob *> fFits;      //! added fits
+
+};
+
+   } // end namespace Fit
+
+} // end namespace ROOT
+
+
+#endif /* ROOT_Fit_BatchFitter */
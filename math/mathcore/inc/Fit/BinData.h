@@ -230,6 +230,14 @@ public :
       return fDataWrapper->Coords(ipoint);
    }
 
+   /**
+      return a pointer to the coordinates icoord of all the points, stored contiguously 
+      (structure of arrays) as needed for evaluating the model function on many points. 
+      The arrays of external data are returned directly; the copied-in data are stored 
+      point by point and their coordinates are copied in a cache at the first call
+    */
+   const double * CoordData(unsigned int icoord) const; 
+
    /**
       return the value for the given fit point
     */
@@ -529,6 +537,8 @@ private:
 
    std::vector<double> fBinEdge;  // vector containing the bin upper edge (coordinate will contain low edge) 
 
+   mutable std::vector<double> fCoordData;  //! cache of the coordinates stored by coordinate (see CoordData)
+
 
 #ifdef USE_BINPOINT_CLASS
    mutable BinPoint fPoint; 
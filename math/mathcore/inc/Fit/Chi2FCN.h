@@ -31,14 +31,6 @@
 #include "Fit/FitUtil.h"
 #endif
 
-//#define ROOT_FIT_PARALLEL
-
-#ifdef ROOT_FIT_PARALLEL
-#ifndef ROOT_Fit_FitUtilParallel
-#include "Fit/FitUtilParallel.h"
-#endif
-#endif
-
 /** 
 @defgroup FitMethodFunc Fit Method Classes 
 
@@ -75,12 +67,14 @@ public:
    typedef typename BaseObjFunction::Type_t Type_t;
 
    /** 
-      Constructor from data set (binned ) and model function 
+      Constructor from data set (binned ) and model function. 
+      The execution policy defines how the sum over the data points is evaluated
    */ 
-   Chi2FCN (const BinData & data, const IModelFunction & func) : 
+   Chi2FCN (const BinData & data, const IModelFunction & func, ExecutionPolicy executionPolicy = kSerial) : 
       BaseObjFunction(func.NPar(), data.Size() ),
       fData(data), 
       fFunc(func), 
+      fExecutionPolicy(executionPolicy),
       fNEffPoints(0),
       fGrad ( std::vector<double> ( func.NPar() ) )
    { }
@@ -110,7 +104,7 @@ public:
 
    virtual BaseFunction * Clone() const { 
       // clone the function
-      Chi2FCN * fcn =  new Chi2FCN(fData,fFunc); 
+      Chi2FCN * fcn =  new Chi2FCN(fData,fFunc,fExecutionPolicy); 
       return fcn; 
    }
  
@@ -132,7 +126,7 @@ public:
    // need to be virtual to be instantiated
    virtual void Gradient(const double *x, double *g) const { 
       // evaluate the chi2 gradient
-      FitUtil::EvaluateChi2Gradient(fFunc, fData, x, g, fNEffPoints);
+      FitUtil::EvaluateChi2Gradient(fFunc, fData, x, g, fNEffPoints, fExecutionPolicy);
    }
 
    /// get type of fit method function
@@ -144,6 +138,9 @@ public:
    /// access to const reference to the model function
    virtual const IModelFunction & ModelFunction() const { return fFunc; }
 
+   /// execution policy used for evaluating the function and its gradient
+   ExecutionPolicy GetExecutionPolicy() const { return fExecutionPolicy; }
+
 
 
 protected: 
@@ -159,14 +156,10 @@ private:
     */
    virtual double DoEval (const double * x) const { 
       this->UpdateNCalls();
-#ifdef ROOT_FIT_PARALLEL
-      return FitUtilParallel::EvaluateChi2(fFunc, fData, x, fNEffPoints); 
-#else 
       if (!fData.HaveCoordErrors() ) 
-         return FitUtil::EvaluateChi2(fFunc, fData, x, fNEffPoints); 
+         return FitUtil::EvaluateChi2(fFunc, fData, x, fNEffPoints, fExecutionPolicy); 
       else 
-         return FitUtil::EvaluateChi2Effective(fFunc, fData, x, fNEffPoints); 
-#endif
+         return FitUtil::EvaluateChi2Effective(fFunc, fData, x, fNEffPoints, fExecutionPolicy); 
    } 
 
    // for derivatives 
@@ -178,6 +171,8 @@ private:
    const BinData & fData; 
    const IModelFunction & fFunc; 
 
+   ExecutionPolicy fExecutionPolicy;  // policy for the evaluation over the data points
+
    mutable unsigned int fNEffPoints;  // number of effective points used in the fit 
 
    mutable std::vector<double> fGrad; // for derivatives
@@ -332,6 +332,11 @@ public:
          return  x[ipoint]; 
    }
 
+   /// return the wrapped array with the coordinates icoord of all the points
+   const double * CoordData(unsigned int icoord) const { 
+      return fCoords[icoord]; 
+   }
+
 
    const double * CoordErrors(unsigned int ipoint) const { 
       for (unsigned int i = 0; i < fDim; ++i) { 
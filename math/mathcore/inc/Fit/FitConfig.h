@@ -22,6 +22,10 @@
 #include "Math/MinimizerOptions.h"
 #endif
 
+#ifndef ROOT_Fit_FitExecutionPolicy
+#include "Fit/FitExecutionPolicy.h"
+#endif
+
 #ifndef ROOT_Math_IParamFunctionfwd
 #include "Math/IParamFunctionfwd.h"
 #endif
@@ -130,6 +134,12 @@ public:
    */
    ROOT::Math::Minimizer * CreateMinimizer(); 
 
+   /**
+      set the control parameters (tolerance, strategy, max function calls, ...) 
+      of an existing minimizer according to the chosen configuration
+   */
+   void ConfigureMinimizer(ROOT::Math::Minimizer & min); 
+
 
 
    /**
@@ -182,6 +192,9 @@ public:
    ///Apply Weight correction for error matrix computation
    bool UseWeightCorrection() const { return fWeightCorr; }
 
+   ///execution policy for evaluating the objective function over the data points
+   ROOT::Fit::ExecutionPolicy GetExecutionPolicy() const { return fExecutionPolicy; }
+
 
    /// return vector of parameter indeces for which the Minos Error will be computed
    const std::vector<unsigned int> & MinosParams() const { return fMinosParams; }
@@ -211,6 +224,14 @@ public:
    ///Update configuration after a fit using the FitResult
    void SetUpdateAfterFit(bool on = true) { fUpdateAfterFit = on; } 
 
+   /**
+      set the execution policy for evaluating the chi2 or likelihood and their gradient.
+      With ROOT::Fit::kMultithread the data points are evaluated in parallel, using the
+      number of threads set in ROOT::Math::ThreadPool::SetDefaultNThreads or, if not set,
+      all the cores. The model function must be thread safe.
+   */
+   void SetExecutionPolicy(ROOT::Fit::ExecutionPolicy policy) { fExecutionPolicy = policy; }
+
 
    /**
       static function to control default minimizer type and algorithm
@@ -230,6 +251,7 @@ private:
    bool fMinosErrors;      // do full error analysis using Minos
    bool fUpdateAfterFit;   // update the configuration after a fit using the result
    bool fWeightCorr;       // apply correction to errors for weights fits 
+   ROOT::Fit::ExecutionPolicy fExecutionPolicy;  // policy for evaluating the objective function
 
    std::vector<ROOT::Fit::ParameterSettings> fSettings;  // vector with the parameter settings
    std::vector<unsigned int> fMinosParams;               // vector with the parameter indeces for running Minos
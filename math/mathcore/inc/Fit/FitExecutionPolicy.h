@@ -0,0 +1,43 @@
+// @(#)root/mathcore:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2014  LCG ROOT Math Team, CERN/PH-SFT                *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Header file defining the execution policy of the fit method functions
+
+#ifndef ROOT_Fit_FitExecutionPolicy
+#define ROOT_Fit_FitExecutionPolicy
+
+
+namespace ROOT {
+
+   namespace Fit {
+
+/**
+   Policy for evaluating the fit method functions (chi2, likelihoods) and their
+   gradients over the data points.
+
+   With kMultithread the data points are split in chunks of fixed size, evaluated
+   in parallel by ROOT::Math::ThreadPool; the results of the chunks are summed in
+   order, so that the result does not depend on the number of threads.
+   The model function must then be thread safe when evaluated with the parameters
+   passed as argument (this is not the case for interpreted TF1's). For the
+   gradients each chunk uses its own clone of the model function.
+
+   @ingroup FitMain
+*/
+enum ExecutionPolicy {
+   kSerial,        // evaluate the data points sequentially (default)
+   kMultithread    // evaluate chunks of data points in parallel
+};
+
+   } // end namespace Fit
+
+} // end namespace ROOT
+
+
+#endif /* ROOT_Fit_FitExecutionPolicy */
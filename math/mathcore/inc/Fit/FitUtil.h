@@ -21,6 +21,10 @@
 #include "Fit/DataVectorfwd.h"
 #endif
 
+#ifndef ROOT_Fit_FitExecutionPolicy
+#include "Fit/FitExecutionPolicy.h"
+#endif
+
 
 namespace ROOT { 
 
@@ -42,49 +46,56 @@ namespace FitUtil {
 
    /** Chi2 Functions */
 
+   /*
+       The functions evaluating a sum over the data points take an execution policy:
+       with kMultithread the points are evaluated in chunks in parallel
+       (see ROOT::Fit::ExecutionPolicy). The gradients are evaluated with a clone 
+       of the model function for each chunk
+   */
+
    /** 
        evaluate the Chi2 given a model function and the data at the point x. 
        return also nPoints as the effective number of used points in the Chi2 evaluation
    */ 
-   double EvaluateChi2(const IModelFunction & func, const BinData & data, const double * x, unsigned int & nPoints);  
+   double EvaluateChi2(const IModelFunction & func, const BinData & data, const double * x, unsigned int & nPoints, ExecutionPolicy executionPolicy = kSerial);  
 
    /** 
        evaluate the effective Chi2 given a model function and the data at the point x. 
        The effective chi2 uses the errors on the coordinates : W = 1/(sigma_y**2 + ( sigma_x_i * df/dx_i )**2 )
        return also nPoints as the effective number of used points in the Chi2 evaluation
    */ 
-   double EvaluateChi2Effective(const IModelFunction & func, const BinData & data, const double * x, unsigned int & nPoints);  
+   double EvaluateChi2Effective(const IModelFunction & func, const BinData & data, const double * x, unsigned int & nPoints, ExecutionPolicy executionPolicy = kSerial);  
 
    /** 
        evaluate the Chi2 gradient given a model function and the data at the point x. 
        return also nPoints as the effective number of used points in the Chi2 evaluation
    */ 
-   void EvaluateChi2Gradient(const IModelFunction & func, const BinData & data, const double * x, double * grad, unsigned int & nPoints);  
+   void EvaluateChi2Gradient(const IModelFunction & func, const BinData & data, const double * x, double * grad, unsigned int & nPoints, ExecutionPolicy executionPolicy = kSerial);  
 
    /** 
        evaluate the LogL given a model function and the data at the point x. 
        return also nPoints as the effective number of used points in the LogL evaluation
    */ 
-   double EvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints);  
+   double EvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints, ExecutionPolicy executionPolicy = kSerial);  
 
    /** 
        evaluate the LogL gradient given a model function and the data at the point x. 
        return also nPoints as the effective number of used points in the LogL evaluation
    */ 
-   void EvaluateLogLGradient(const IModelFunction & func, const UnBinData & data, const double * x, double * grad, unsigned int & nPoints);  
+   void EvaluateLogLGradient(const IModelFunction & func, const UnBinData & data, const double * x, double * grad, unsigned int & nPoints, ExecutionPolicy executionPolicy = kSerial);  
 
    /** 
        evaluate the Poisson LogL given a model function and the data at the point x. 
        return also nPoints as the effective number of used points in the LogL evaluation
        By default is extended, pass extedend to false if want to be not extended (MultiNomial)
    */ 
-   double EvaluatePoissonLogL(const IModelFunction & func, const BinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints);  
+   double EvaluatePoissonLogL(const IModelFunction & func, const BinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints, ExecutionPolicy executionPolicy = kSerial);  
 
    /** 
        evaluate the Poisson LogL given a model function and the data at the point x. 
        return also nPoints as the effective number of used points in the LogL evaluation
    */ 
-   void EvaluatePoissonLogLGradient(const IModelFunction & func, const BinData & data, const double * x, double * grad);  
+   void EvaluatePoissonLogLGradient(const IModelFunction & func, const BinData & data, const double * x, double * grad, ExecutionPolicy executionPolicy = kSerial);  
 
 //    /** 
 //        Parallel evaluate the Chi2 given a model function and the data at the point x. 
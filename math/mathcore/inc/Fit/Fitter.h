@@ -367,6 +367,16 @@ public:
     */
    ROOT::Math::Minimizer * GetMinimizer() const { return fMinimizer.get(); } 
 
+   /**
+      set the minimizer to be used in the following fits, instead of creating a new one 
+      with the plug-in manager at each fit. The Fitter takes ownership of the minimizer. 
+      At each fit it is reset with ROOT::Math::Minimizer::Clear and configured 
+      according to FitConfig, so it must support consecutive minimizations (e.g. Minuit2). 
+      The minimizer type in FitConfig is not used in this case. 
+      Passing a null pointer restores the creation of a new minimizer at each fit. 
+   */
+   void SetMinimizer(ROOT::Math::Minimizer * min); 
+
    /**
       return pointer to last used objective function 
       (is NULL in case fit is not yet done)
@@ -430,6 +440,8 @@ private:
 
    int fDataSize;  // size of data sets (need for Fumili or LM fitters)
 
+   bool fKeepMinimizer;     // flag to reuse the minimizer given with SetMinimizer in the following fits
+
    IModelFunction * fFunc;  // copy of the fitted  function containing on output the fit result (managed by FitResult)
 
    FitConfig fConfig;       // fitter configuration (options and parameter settings)
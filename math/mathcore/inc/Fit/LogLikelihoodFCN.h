@@ -29,12 +29,6 @@
 #include "Fit/FitUtil.h"
 #endif
 
-#ifdef ROOT_FIT_PARALLEL
-#ifndef ROOT_Fit_FitUtilParallel
-#include "Fit/FitUtilParallel.h"
-#endif
-#endif
-
 namespace ROOT { 
 
    namespace Fit { 
@@ -63,14 +57,17 @@ public:
 
 
    /** 
-      Constructor from unbin data set and model function (pdf)
+      Constructor from unbin data set and model function (pdf). 
+      The execution policy defines how the sum over the data points is evaluated
    */ 
-   LogLikelihoodFCN (const UnBinData & data, const IModelFunction & func, int weight = 0, bool extended = false) : 
+   LogLikelihoodFCN (const UnBinData & data, const IModelFunction & func, int weight = 0, bool extended = false, 
+                     ExecutionPolicy executionPolicy = kSerial) : 
       BaseObjFunction(func.NPar(), data.Size() ),
       fIsExtended(extended),
       fWeight(weight),
       fData(data), 
       fFunc(func), 
+      fExecutionPolicy(executionPolicy),
       fNEffPoints(0),
       fGrad ( std::vector<double> ( func.NPar() ) )
    {}
@@ -97,7 +94,7 @@ private:
 public: 
 
    /// clone the function (need to return Base for Windows)
-   virtual BaseFunction * Clone() const { return  new LogLikelihoodFCN(fData,fFunc,fWeight,fIsExtended); }
+   virtual BaseFunction * Clone() const { return  new LogLikelihoodFCN(fData,fFunc,fWeight,fIsExtended,fExecutionPolicy); }
 
 
    //using BaseObjFunction::operator();
@@ -115,7 +112,7 @@ public:
    // need to be virtual to be instantited
    virtual void Gradient(const double *x, double *g) const { 
       // evaluate the chi2 gradient
-      FitUtil::EvaluateLogLGradient(fFunc, fData, x, g, fNEffPoints);
+      FitUtil::EvaluateLogLGradient(fFunc, fData, x, g, fNEffPoints, fExecutionPolicy);
    }
 
    /// get type of fit method function
@@ -127,6 +124,9 @@ public:
    /// access to const reference to the model function
    virtual const IModelFunction & ModelFunction() const { return fFunc; }
 
+   /// execution policy used for evaluating the function and its gradient
+   ExecutionPolicy GetExecutionPolicy() const { return fExecutionPolicy; }
+
    // Use sum of the weight squared in evaluating the likelihood 
    // (this is needed for calculating the errors)
    void UseSumOfWeightSquare(bool on = true) { 
@@ -147,12 +147,7 @@ private:
     */
    virtual double DoEval (const double * x) const { 
       this->UpdateNCalls();
-
-#ifdef ROOT_FIT_PARALLEL
-      return FitUtilParallel::EvaluateLogL(fFunc, fData, x, fNEffPoints); 
-#else 
-      return FitUtil::EvaluateLogL(fFunc, fData, x, fWeight, fIsExtended, fNEffPoints); 
-#endif
+      return FitUtil::EvaluateLogL(fFunc, fData, x, fWeight, fIsExtended, fNEffPoints, fExecutionPolicy); 
    } 
 
    // for derivatives 
@@ -169,6 +164,8 @@ private:
    const UnBinData & fData; 
    const IModelFunction & fFunc; 
 
+   ExecutionPolicy fExecutionPolicy;  // policy for the evaluation over the data points
+
    mutable unsigned int fNEffPoints;  // number of effective points used in the fit 
 
    mutable std::vector<double> fGrad; // for derivatives
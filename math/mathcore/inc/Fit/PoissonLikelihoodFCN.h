@@ -29,13 +29,6 @@
 #include "Fit/FitUtil.h"
 #endif
 
-//#define PARALLEL
-// #ifdef PARALLEL
-// #ifndef ROOT_Fit_FitUtilParallel
-// #include "Fit/FitUtilParallel.h"
-// #endif
-// #endif
-
 namespace ROOT {
 
    namespace Fit {
@@ -62,14 +55,17 @@ public:
 
 
    /**
-      Constructor from unbin data set and model function (pdf)
+      Constructor from unbin data set and model function (pdf).
+      The execution policy defines how the sum over the data points is evaluated
    */
-   PoissonLikelihoodFCN (const BinData & data, const IModelFunction & func, int weight = 0, bool extended = true ) :
+   PoissonLikelihoodFCN (const BinData & data, const IModelFunction & func, int weight = 0, bool extended = true,
+                         ExecutionPolicy executionPolicy = kSerial ) :
       BaseObjFunction(func.NPar(), data.Size() ),
       fIsExtended(extended),
       fWeight(weight),
       fData(data),
       fFunc(func),
+      fExecutionPolicy(executionPolicy),
       fNEffPoints(0),
       fGrad ( std::vector<double> ( func.NPar() ) )
    { }
@@ -96,7 +92,7 @@ private:
 public:
 
    /// clone the function (need to return Base for Windows)
-   virtual BaseFunction * Clone() const { return new  PoissonLikelihoodFCN(fData,fFunc,fWeight,fIsExtended); }
+   virtual BaseFunction * Clone() const { return new  PoissonLikelihoodFCN(fData,fFunc,fWeight,fIsExtended,fExecutionPolicy); }
 
    // effective points used in the fit
    virtual unsigned int NFitPoints() const { return fNEffPoints; }
@@ -110,7 +106,7 @@ public:
    /// evaluate gradient
    virtual void Gradient(const double *x, double *g) const {
       // evaluate the chi2 gradient
-      FitUtil::EvaluatePoissonLogLGradient(fFunc, fData, x, g );
+      FitUtil::EvaluatePoissonLogLGradient(fFunc, fData, x, g, fExecutionPolicy );
    }
 
    /// get type of fit method function
@@ -122,6 +118,9 @@ public:
    /// access to const reference to the model function
    virtual const IModelFunction & ModelFunction() const { return fFunc; }
 
+   /// execution policy used for evaluating the function and its gradient
+   ExecutionPolicy GetExecutionPolicy() const { return fExecutionPolicy; }
+
    bool IsWeighted() const { return (fWeight != 0); }
 
    // Use the weights in evaluating the likelihood 
@@ -149,7 +148,7 @@ private:
     */
    virtual double DoEval (const double * x) const {
       this->UpdateNCalls();
-      return FitUtil::EvaluatePoissonLogL(fFunc, fData, x, fWeight, fIsExtended, fNEffPoints);
+      return FitUtil::EvaluatePoissonLogL(fFunc, fData, x, fWeight, fIsExtended, fNEffPoints, fExecutionPolicy);
    }
 
    // for derivatives
@@ -167,6 +166,8 @@ private:
    const BinData & fData;
    const IModelFunction & fFunc;
 
+   ExecutionPolicy fExecutionPolicy;  // policy for the evaluation over the data points
+
    mutable unsigned int fNEffPoints;  // number of effective points used in the fit
 
 
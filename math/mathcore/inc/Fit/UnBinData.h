@@ -286,6 +286,14 @@ public:
          return fDataWrapper->Coords(ipoint); 
    }
 
+   /**
+      return a pointer to the coordinates icoord of all the points, stored contiguously 
+      (structure of arrays) as needed for evaluating the model function on many points. 
+      The arrays of external data are returned directly; the copied-in data are stored 
+      point by point and their coordinates are copied in a cache at the first call
+    */
+   const double * CoordData(unsigned int icoord) const; 
+
    bool IsWeighted() const { 
       return (fPointSize == fDim+1); 
    }
@@ -349,6 +357,8 @@ private:
    DataVector * fDataVector;     // pointer to internal data vector (null for external data)
    DataWrapper * fDataWrapper;   // pointer to structure wrapping external data (null when data are copied in)
 
+   mutable std::vector<double> fCoordData;  //! cache of the coordinates stored by coordinate (see CoordData)
+
 }; 
 
   
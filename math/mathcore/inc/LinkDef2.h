@@ -41,6 +41,8 @@
 #pragma link C++ class TRandom3-;
 
 #pragma link C++ class TStatistic+;
+#pragma link C++ class TStatisticDecay+;
+#pragma link C++ class TStatisticHistogram+;
 
 #pragma link C++ class TVirtualFitter+;
 
@@ -27,6 +27,7 @@
 
 
 #include <cassert> 
+#include <vector> 
 
 /**
    @defgroup ParamFunc Interfaces for parametric functions 
@@ -125,6 +126,17 @@ public:
       return DoEvalPar(x, p); 
    }
 
+   /**
+      Evaluate the function for the given parameters p on n points, whose coordinates are 
+      passed by coordinate: x[icoord][ipoint] (structure of arrays, as returned by 
+      BinData::CoordData). The n function values are written in y. 
+      Use the virtual function DoEvalParVec, which can be re-implemented by derived classes 
+      with a loop on the points which can be vectorized by the compiler.  
+   */
+   void EvalParVec(unsigned int n, const double * const * x, const double * p, double * y) const { 
+      DoEvalParVec(n, x, p, y); 
+   }
+
    using BaseFunc::operator();
 
 
@@ -136,6 +148,19 @@ private:
    */
    virtual double DoEvalPar(const double * x, const double * p) const = 0; 
 
+   /**
+      Implementation of the evaluation on many points. 
+      The default implementation calls DoEvalPar for each point
+   */
+   virtual void DoEvalParVec(unsigned int n, const double * const * x, const double * p, double * y) const { 
+      const unsigned int ndim = NDim(); 
+      std::vector<double> point(ndim); 
+      for (unsigned int i = 0; i < n; ++i) { 
+         for (unsigned int j = 0; j < ndim; ++j) point[j] = x[j][i]; 
+         y[i] = DoEvalPar(&point.front(), p); 
+      }
+   }
+
    /**
       Implement the ROOT::Math::IBaseFunctionMultiDim interface DoEval(x) using the cached parameter values
    */
@@ -0,0 +1,69 @@
+// @(#)root/mathcore:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2014  LCG ROOT Math Team, CERN/PH-SFT                *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+#ifndef ROOT_Math_ThreadPool
+#define ROOT_Math_ThreadPool
+
+namespace ROOT {
+
+namespace Math {
+
+//_______________________________________________________________________________
+/**
+   Pool of worker threads executing a set of independent tasks.
+
+   The work to be done is described by an implementation of ThreadPool::ITask;
+   ThreadPool::Run executes the tasks 0 ... ntasks-1 and returns when all of
+   them are done. The calling thread takes part in the execution. Which thread
+   executes which task is not specified: to obtain reproducible results the
+   tasks should write their results in per-task storage, which the caller
+   combines in task order after Run.
+
+   The number of threads used by default is 1, i.e. the tasks are executed
+   sequentially by the calling thread; parallel execution is enabled with
+   ThreadPool::SetDefaultNThreads. The worker threads are created at the
+   first parallel Run and kept for the following ones. A Run called from a
+   task, or while another thread is in Run, is executed sequentially.
+
+   @ingroup MathCore
+*/
+class ThreadPool {
+
+public:
+
+   /**
+      Interface for the work executed by ThreadPool::Run
+   */
+   class ITask {
+   public:
+      virtual ~ITask() {}
+
+      /// execute task number itask; called concurrently for different itask
+      virtual void Execute(unsigned int itask) = 0;
+   };
+
+   /// execute the tasks 0 ... ntasks-1 of task using nthreads threads (0: default number)
+   static void Run(ITask & task, unsigned int ntasks, unsigned int nthreads = 0);
+
+   /// set the default number of threads; 0 means the number of available cores
+   static void SetDefaultNThreads(unsigned int nthreads);
+
+   /// default number of threads used by Run (initially 1, i.e. no parallelism)
+   static unsigned int DefaultNThreads();
+
+   /// number of cores available on the machine
+   static unsigned int NCores();
+
+};
+
+} // end namespace Math
+
+} // end namespace ROOT
+
+#endif /* ROOT_Math_ThreadPool */
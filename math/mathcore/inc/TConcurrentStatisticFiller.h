@@ -0,0 +1,110 @@
+// @(#)root/mathcore:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TConcurrentStatisticFiller
+#define ROOT_TConcurrentStatisticFiller
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TConcurrentStatisticFiller                                           //
+//                                                                      //
+// Fill one TStatistic, TStatisticDecay or TStatisticHistogram from     //
+// several threads. Each call locks a mutex owned by the filler.        //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_Rtypes
+#include "Rtypes.h"
+#endif
+
+#ifndef ROOT_TVirtualMutex
+#include "TVirtualMutex.h"
+#endif
+
+//______________________________________________________________________________
+//
+// Filling the same statistic from two threads corrupts its sums. Wrap it
+// in a TConcurrentStatisticFiller and call the Fill methods of the filler
+// from any thread:
+//
+//    TStatistic st("st");
+//    TConcurrentStatisticFiller<TStatistic> filler(&st);
+//    ... in each thread:
+//    filler.Fill(x, w);
+//    ... when all the threads are done:
+//    st.Print();
+//
+// The filler does not own the statistic. The Fill, FillN and Add methods
+// are those of the wrapped class (Fill(val,t,w) for TStatisticDecay) and
+// are serialized by a mutex, so the result is that of a serial fill in the
+// order in which the threads obtained the lock. The statistic must only
+// be read directly when no thread fills anymore; use the filler's methods
+// otherwise. Threads filling large arrays should prefer FillN, which holds
+// the lock once for the whole array.
+//
+// As for any use of ROOT from several threads, TThread::Initialize()
+// must have been called before the filler is created; otherwise the
+// calls are not locked.
+
+template <class S>
+class TConcurrentStatisticFiller {
+
+private:
+   S              *fStat;   // statistic being filled (not owned)
+   TVirtualMutex  *fMutex;  // serializes the calls
+
+   TConcurrentStatisticFiller(const TConcurrentStatisticFiller&);            // Not implemented
+   TConcurrentStatisticFiller &operator=(const TConcurrentStatisticFiller&); // Not implemented
+
+public:
+   TConcurrentStatisticFiller(S *stat)
+      : fStat(stat), fMutex(gGlobalMutex ? gGlobalMutex->Factory(kFALSE) : 0) { }
+   ~TConcurrentStatisticFiller() { delete fMutex; }
+
+   void Fill(Double_t val)
+   {
+      TLockGuard guard(fMutex);
+      fStat->Fill(val);
+   }
+   void Fill(Double_t val, Double_t w)
+   {
+      TLockGuard guard(fMutex);
+      fStat->Fill(val, w);
+   }
+   void Fill(Double_t val, Double_t t, Double_t w)
+   {
+      TLockGuard guard(fMutex);
+      fStat->Fill(val, t, w);
+   }
+   void FillN(Int_t n, const Double_t *val, const Double_t *w = 0)
+   {
+      TLockGuard guard(fMutex);
+      fStat->FillN(n, val, w);
+   }
+   void FillN(Int_t n, const Double_t *val, const Double_t *t, const Double_t *w)
+   {
+      TLockGuard guard(fMutex);
+      fStat->FillN(n, val, t, w);
+   }
+   void Add(const S &s)
+   {
+      TLockGuard guard(fMutex);
+      fStat->Add(s);
+   }
+
+   // Copy of the statistic, consistent even while other threads fill
+   S    GetStatistic() const
+   {
+      TLockGuard guard(fMutex);
+      return *fStat;
+   }
+};
+
+#endif
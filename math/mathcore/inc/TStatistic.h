@@ -20,6 +20,9 @@
 // Statistical variable, defined by its mean, RMS and related errors.   //
 // Named, streamable, storable and mergeable.                           //
 //                                                                      //
+// See also TStatisticDecay (exponentially decaying mean and RMS) and   //
+// TStatisticHistogram (streaming histogram and quantiles).             //
+//                                                                      //
 //////////////////////////////////////////////////////////////////////////
 
 #ifndef ROOT_TObject
@@ -75,6 +78,7 @@ public:
    inline const Double_t &GetW2() const { return fW2; }
 
    // Merging
+   void  Add(const TStatistic &s);
    Int_t Merge(TCollection *in);
 
    // Fill
@@ -89,6 +93,7 @@ public:
       fW = tW;
       fW2 += w*w;
    }
+   void FillN(Int_t n, const Double_t *val, const Double_t *w = 0);
 
    // Print
    void ls(Option_t *opt = "") const { Print(opt); }
@@ -102,6 +107,23 @@ public:
    ClassDef(TStatistic,1)  //Named statistical variable
 };
 
+// Implementation of Add
+inline void TStatistic::Add(const TStatistic &s) {
+   // Add the values filled in s, as if they had been filled in this object.
+   fN += s.fN;
+   fW2 += s.fW2;
+   Double_t tW = fW + s.fW;
+   if (tW == 0.) {
+      fW = tW;
+      return;
+   }
+   Double_t dt = s.fMean - fMean;
+   Double_t rr = dt * s.fW / tW;
+   fMean += rr;
+   fM2 += s.fM2 + fW * dt * rr;
+   fW = tW;
+}
+
 // Implementation of Merge
 inline Int_t TStatistic::Merge(TCollection *in) {
    // Merge objects in the list.
@@ -111,11 +133,7 @@ inline Int_t TStatistic::Merge(TCollection *in) {
    while (TObject *o = nxo()) {
       TStatistic *c = dynamic_cast<TStatistic *>(o);
       if (c) {
-         fMean += c->GetMean();
-         fW += c->GetW();
-         fW2 += c->GetW2();
-         fM2 += c->GetM2();
-         fN += c->GetN();
+         Add(*c);
          n++;
       }
    }
@@ -0,0 +1,94 @@
+// @(#)root/mathcore:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TStatisticDecay
+#define ROOT_TStatisticDecay
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TStatisticDecay                                                      //
+//                                                                      //
+// Statistical variable with exponentially decaying weights: mean, RMS  //
+// and related errors of values weighted by exp(-(t-ti)/tau), where ti  //
+// is the time of the value and t the latest time seen.                 //
+// Named, streamable, storable and mergeable.                           //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_TObject
+#include "TObject.h"
+#endif
+
+#ifndef ROOT_TCollection
+#include "TCollection.h"
+#endif
+
+#ifndef ROOT_TMath
+#include "TMath.h"
+#endif
+
+#ifndef ROOT_TString
+#include "TString.h"
+#endif
+
+class TStatisticDecay : public TObject {
+
+private:
+   TString     fName;
+   Double_t    fTau;     // Decay time constant
+   Double_t    fTime;    // Time of the latest fill, the weights are decayed to this time
+   Long64_t    fN;       // Number of fills
+   Double_t    fW;       // Sum of decayed weights
+   Double_t    fW2;      // Sum of decayed weights**2
+   Double_t    fMean;    // Mean
+   Double_t    fM2;      // Second order momentum
+
+   void        DecayTo(Double_t t);
+
+public:
+   TStatisticDecay(const char *name = "", Double_t tau = 1.) :
+      fName(name), fTau(tau), fTime(0.), fN(0), fW(0.), fW2(0.), fMean(0.), fM2(0.) { }
+   ~TStatisticDecay() { }
+
+   // Getters
+   const char    *GetName() const { return fName; }
+   ULong_t        Hash() const { return fName.Hash(); }
+
+   Double_t       GetTau() const { return fTau; }
+   Double_t       GetTime() const { return fTime; }
+   Long64_t       GetN() const { return fN; }
+   Double_t       GetM2() const { return fM2; }
+   Double_t       GetMean() const { return fMean; }
+   Double_t       GetMeanErr() const { if (fW > 0.) return TMath::Sqrt(fM2 / fW2 / fW);
+                                       return 0.; }
+   Double_t       GetRMS() const { if (fW > 0.) { return TMath::Sqrt(fM2 / fW); } return -1; }
+   Double_t       GetVarN() const { if (fW > 0.) { return fM2 / fW; } return -1.; }
+   Double_t       GetW() const { return fW; }
+   Double_t       GetW2() const { return fW2; }
+   Double_t       GetW(Double_t t) const;
+
+   // Merging
+   void  Add(const TStatisticDecay &s);
+   Int_t Merge(TCollection *in);
+
+   // Fill
+   void  Fill(Double_t val, Double_t t, Double_t w = 1.);
+   void  FillN(Int_t n, const Double_t *val, const Double_t *t, const Double_t *w = 0);
+   void  Reset();
+
+   // Print
+   void ls(Option_t *opt = "") const { Print(opt); }
+   void Print(Option_t * = "") const;
+
+   ClassDef(TStatisticDecay,1)  //Named statistical variable with exponentially decaying weights
+};
+
+#endif
@@ -0,0 +1,95 @@
+// @(#)root/mathcore:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TStatisticHistogram
+#define ROOT_TStatisticHistogram
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TStatisticHistogram                                                  //
+//                                                                      //
+// Streaming histogram of a statistical variable: a bounded number of   //
+// bins of variable position and width adapting to the range of the     //
+// values, giving approximate quantiles and cumulative sums.            //
+// Named, streamable, storable and mergeable.                           //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_TObject
+#include "TObject.h"
+#endif
+
+#ifndef ROOT_TCollection
+#include "TCollection.h"
+#endif
+
+#ifndef ROOT_TString
+#include "TString.h"
+#endif
+
+#include <vector>
+
+class TStatisticHistogram : public TObject {
+
+private:
+   TString               fName;
+   Int_t                 fMaxBins;  // Maximum number of bins
+   Long64_t              fN;        // Number of fills
+   Double_t              fW;        // Sum of weights
+   Double_t              fMin;      // Minimum value
+   Double_t              fMax;      // Maximum value
+   std::vector<Double_t> fCenter;   // Bin centers, in increasing order
+   std::vector<Double_t> fWeight;   // Bin weights
+   std::vector<Double_t> fBuffer;   // Values not yet added to the bins
+   std::vector<Double_t> fBufferW;  // Weights of the values in fBuffer
+
+   void        Compress();
+   const TStatisticHistogram *Compressed(TStatisticHistogram &copy) const;
+
+public:
+   TStatisticHistogram(const char *name = "", Int_t maxbins = 100);
+   ~TStatisticHistogram() { }
+
+   // Getters
+   const char    *GetName() const { return fName; }
+   ULong_t        Hash() const { return fName.Hash(); }
+
+   Int_t          GetMaxBins() const { return fMaxBins; }
+   Long64_t       GetN() const { return fN; }
+   Double_t       GetW() const { return fW; }
+   Double_t       GetMin() const { return fMin; }
+   Double_t       GetMax() const { return fMax; }
+   Double_t       GetMean() const;
+   Int_t          GetNbins() const;
+   Double_t       GetBinCenter(Int_t i) const;
+   Double_t       GetBinContent(Int_t i) const;
+   Double_t       GetQuantile(Double_t prob) const;
+   void           GetQuantiles(Int_t n, const Double_t *prob, Double_t *q) const;
+   Double_t       GetSum(Double_t x) const;
+
+   // Merging
+   void  Add(const TStatisticHistogram &s);
+   Int_t Merge(TCollection *in);
+
+   // Fill
+   void  Fill(Double_t val, Double_t w = 1.);
+   void  FillN(Int_t n, const Double_t *val, const Double_t *w = 0);
+   void  Flush();
+   void  Reset();
+
+   // Print
+   void ls(Option_t *opt = "") const { Print(opt); }
+   void Print(Option_t * = "") const;
+
+   ClassDef(TStatisticHistogram,1)  //Named streaming histogram and quantiles of a variable
+};
+
+#endif
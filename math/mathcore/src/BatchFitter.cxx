@@ -0,0 +1,269 @@
+// @(#)root/mathcore:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2014  LCG ROOT Math Team, CERN/PH-SFT                *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Implementation file for class BatchFitter
+
+#include "Fit/BatchFitter.h"
+#include "Fit/Fitter.h"
+#include "Fit/BinData.h"
+#include "Fit/UnBinData.h"
+#include "Math/IParamFunction.h"
+#include "Math/Minimizer.h"
+#include "Math/ThreadPool.h"
+#include "Math/Error.h"
+
+#include <string>
+#include <cassert>
+
+namespace ROOT {
+
+   namespace Fit {
+
+struct BatchFitter::FitJob {
+   int fType;                        // type of fit (0 least square, 1 binned likelihood, 2 unbinned likelihood)
+   bool fExtended;                   // flag for extended likelihood fits
+   bool fUseGradient;                // flag for using the gradient of the model function
+   bool fStatus;                     // status of the fit
+   bool fReuseMinimizer;             // flag to reuse the minimizer of the previous fit of the chunk
+   const BinData * fBinData;         // binned data (not owned)
+   const UnBinData * fUnBinData;     // unbinned data (not owned)
+   IModelFunction * fFunc;           // copy of the model function
+   ROOT::Math::Minimizer * fMinimizer; // minimizer created before the fit (given to the Fitter)
+   FitConfig fConfig;                // configuration of the fit
+   FitResult fResult;                // result of the fit
+};
+
+namespace {
+
+   // minimizers which can be re-used for consecutive fits (they implement Clear)
+   bool IsReusableMinimizer(const std::string & type) {
+      return type == "Minuit2" || type == "Fumili2";
+   }
+
+   // minimizers which can not be used by different threads at the same time
+   // (they use global objects) or which are chosen by the Fitter itself
+   bool IsSerialMinimizer(const std::string & type) {
+      return type == "Minuit" || type == "TMinuit" || type == "Fumili" || type == "TFumili" || type == "Linear";
+   }
+
+   //______________________________________________________________________________
+   // Perform one fit with the given fitter
+   bool DoBatchFit(Fitter & fitter, BatchFitter::FitJob & job) {
+      if (job.fMinimizer) {
+         fitter.SetMinimizer(job.fMinimizer);
+         job.fMinimizer = 0;
+      }
+      else if (!job.fReuseMinimizer)
+         fitter.SetMinimizer(0);
+
+      fitter.Config() = job.fConfig;
+      // SetFunction re-creates the parameter settings from the function values
+      fitter.SetFunction(*job.fFunc, job.fUseGradient);
+      fitter.Config().SetParamsSettings(job.fConfig.ParamsSettings());
+
+      bool ret = false;
+      if (job.fType == 0)
+         ret = fitter.Fit(*job.fBinData);
+      else if (job.fType == 1)
+         ret = fitter.LikelihoodFit(*job.fBinData, job.fExtended);
+      else
+         ret = fitter.LikelihoodFit(*job.fUnBinData, job.fExtended);
+
+      job.fResult = fitter.Result();
+      return ret;
+   }
+
+   //______________________________________________________________________________
+   // Perform a chunk of consecutive fits of BatchFitter::Fit with a single Fitter
+   class BatchFitTask : public ROOT::Math::ThreadPool::ITask {
+   public:
+      BatchFitTask(std::vector<BatchFitter::FitJob *> & fits, unsigned int nchunks)
+         : fFits(fits), fNChunks(nchunks) {}
+      void Execute(unsigned int ichunk) {
+         unsigned int nfits = fFits.size();
+         unsigned int first = (ichunk * nfits) / fNChunks;
+         unsigned int last = ((ichunk + 1) * nfits) / fNChunks;
+         Fitter fitter;
+         for (unsigned int i = first; i < last; ++i)
+            fFits[i]->fStatus = DoBatchFit(fitter, *fFits[i]);
+      }
+   private:
+      std::vector<BatchFitter::FitJob *> & fFits;
+      unsigned int fNChunks;
+   };
+
+}
+
+
+BatchFitter::BatchFitter(unsigned int nthreads) :
+   fNThreads(nthreads)
+{
+   // Constructor
+}
+
+BatchFitter::~BatchFitter()
+{
+   // Destructor: delete the fits
+   Clear();
+}
+
+void BatchFitter::Clear()
+{
+   // remove all the fits
+   for (unsigned int i = 0; i < fFits.size(); ++i) {
+      delete fFits[i]->fFunc;
+      delete fFits[i]->fMinimizer;
+      delete fFits[i];
+   }
+   fFits.clear();
+}
+
+unsigned int BatchFitter::AddFit(const BinData & data, const IModelFunction & func, bool useGradient)
+{
+   // add a least square fit
+   return DoAddFit(0, &data, 0, func, false, useGradient);
+}
+
+unsigned int BatchFitter::AddLikelihoodFit(const BinData & data, const IModelFunction & func, bool extended, bool useGradient)
+{
+   // add a binned likelihood fit
+   return DoAddFit(1, &data, 0, func, extended, useGradient);
+}
+
+unsigned int BatchFitter::AddLikelihoodFit(const UnBinData & data, const IModelFunction & func, bool extended, bool useGradient)
+{
+   // add an unbinned likelihood fit
+   return DoAddFit(2, 0, &data, func, extended, useGradient);
+}
+
+unsigned int BatchFitter::DoAddFit(int type, const BinData * bdata, const UnBinData * udata,
+                                   const IModelFunction & func, bool extended, bool useGradient)
+{
+   // add a fit, copying the common configuration and cloning the function
+   FitJob * job = new FitJob();
+   job->fType = type;
+   job->fExtended = extended;
+   job->fUseGradient = useGradient;
+   job->fStatus = false;
+   job->fReuseMinimizer = false;
+   job->fBinData = bdata;
+   job->fUnBinData = udata;
+   job->fFunc = dynamic_cast<IModelFunction *>(func.Clone());
+   assert(job->fFunc != 0);
+   job->fMinimizer = 0;
+   job->fConfig = fConfig;
+   job->fConfig.CreateParamsSettings(*job->fFunc);
+   fFits.push_back(job);
+   return fFits.size() - 1;
+}
+
+FitConfig & BatchFitter::Config(unsigned int ifit)
+{
+   // configuration of the fit ifit
+   return fFits[ifit]->fConfig;
+}
+
+const FitConfig & BatchFitter::Config(unsigned int ifit) const
+{
+   // configuration of the fit ifit
+   return fFits[ifit]->fConfig;
+}
+
+const FitResult & BatchFitter::Result(unsigned int ifit) const
+{
+   // result of the fit ifit
+   return fFits[ifit]->fResult;
+}
+
+bool BatchFitter::Fit()
+{
+   // perform all the fits.
+   // The fits are split in chunks of consecutive fits, executed in parallel.
+   // All the minimizers are created here, since the plug-in manager is not
+   // thread safe; the Minuit2 ones are created once per chunk and re-used.
+
+   unsigned int nfits = fFits.size();
+   if (nfits == 0) return true;
+
+   unsigned int nthreads = (fNThreads > 0) ? fNThreads : ROOT::Math::ThreadPool::DefaultNThreads();
+   unsigned int nchunks = 4 * nthreads;
+   if (nchunks > nfits) nchunks = nfits;
+
+   bool serial = false;
+   for (unsigned int ichunk = 0; ichunk < nchunks; ++ichunk) {
+      unsigned int first = (ichunk * nfits) / nchunks;
+      unsigned int last = ((ichunk + 1) * nfits) / nchunks;
+      std::string prevType;
+      for (unsigned int i = first; i < last; ++i) {
+         FitJob & job = *fFits[i];
+         delete job.fMinimizer;
+         job.fMinimizer = 0;
+         job.fReuseMinimizer = false;
+         job.fStatus = false;
+         job.fResult = FitResult();
+
+         // compute also here the coordinate caches of the data, used by the
+         // fit method functions, in case the same data are used by several fits
+         if (job.fBinData && job.fBinData->Size() > 0) job.fBinData->CoordData(0);
+         if (job.fUnBinData && job.fUnBinData->Size() > 0) job.fUnBinData->CoordData(0);
+
+         const std::string & type = job.fConfig.MinimizerType();
+         if (IsSerialMinimizer(type)) {
+            // the Fitter creates the minimizer
+            serial = true;
+            prevType.clear();
+            continue;
+         }
+         // a minimizer is reused only for the same type and algorithm
+         // (e.g. Migrad and Simplex are different Minuit2 minimizers)
+         std::string typeAlgo = type + "/" + job.fConfig.MinimizerAlgoType();
+         if (IsReusableMinimizer(type) && typeAlgo == prevType) {
+            job.fReuseMinimizer = true;
+            continue;
+         }
+         job.fMinimizer = job.fConfig.CreateMinimizer();
+         if (job.fMinimizer == 0) {
+            std::string msg = "Could not create the minimizer " + type;
+            MATH_ERROR_MSG("BatchFitter::Fit",msg.c_str());
+            return false;
+         }
+         // in case the creation fell back to another minimizer
+         if (IsSerialMinimizer(job.fConfig.MinimizerType())) serial = true;
+         prevType = job.fConfig.MinimizerType() + "/" + job.fConfig.MinimizerAlgoType();
+      }
+   }
+
+   if (serial && nthreads > 1)
+      MATH_WARN_MSG("BatchFitter::Fit","The minimizer can not be used by several threads - perform the fits sequentially");
+
+   BatchFitTask task(fFits, nchunks);
+   ROOT::Math::ThreadPool::Run(task, nchunks, serial ? 1 : nthreads);
+
+   bool ret = true;
+   for (unsigned int i = 0; i < nfits; ++i)
+      ret &= fFits[i]->fStatus;
+   return ret;
+}
+
+int BatchFitter::BestFit() const
+{
+   // index of the valid fit with the smallest minimum of the objective function
+   int ibest = -1;
+   for (unsigned int i = 0; i < fFits.size(); ++i) {
+      const FitResult & result = fFits[i]->fResult;
+      if (!result.IsValid()) continue;
+      if (ibest < 0 || result.MinFcnValue() < fFits[ibest]->fResult.MinFcnValue())
+         ibest = i;
+   }
+   return ibest;
+}
+
+   } // end namespace Fit
+
+} // end namespace ROOT
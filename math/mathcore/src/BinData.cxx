@@ -189,6 +189,7 @@ BinData & BinData::operator= (const BinData & rhs) {
    fSumError2 = rhs.fSumError2;
    fBinEdge = rhs.fBinEdge;
    fRefVolume = rhs.fRefVolume;
+   fCoordData.clear(); 
    // delete previous pointers 
    if (fDataVector) delete fDataVector; 
    if (fDataWrapper) delete fDataWrapper; 
@@ -217,6 +218,7 @@ void BinData::Initialize(unsigned int maxpoints, unsigned int dim , ErrorType er
 //       need to be initialized with the  right dimension before
    if (fDataWrapper) delete fDataWrapper;
    fDataWrapper = 0; 
+   fCoordData.clear(); 
    unsigned int pointSize = GetPointSize(err,dim);  
    if ( pointSize != fPointSize && fDataVector) { 
 //       MATH_INFO_MSGVAL("BinData::Initialize"," Reset amd re-initialize with a new fit point size of ",
@@ -255,6 +257,7 @@ void BinData::Resize(unsigned int npoints) {
       // delete extra points
       if (!fDataVector) return; 
       (fDataVector->Data()).resize( npoints * fPointSize);
+      fCoordData.clear(); 
    } 
    else 
       Initialize(nextraPoints, fDim, GetErrorType() ); 
@@ -448,6 +451,23 @@ void BinData::Add(const double *x, double val, const double * ex, double  elval,
    fSumError2  += (elval+ehval)*(elval+ehval)/4;  
 }
 
+const double * BinData::CoordData(unsigned int icoord) const { 
+   // return the coordinates icoord of all the points as a contiguous array
+   assert(icoord < fDim); 
+   if (fDataWrapper) return fDataWrapper->CoordData(icoord); 
+   if (fNPoints == 0) return 0; 
+   // points can only be appended, and the cache is cleared when they are removed: 
+   // it is then valid as long as its size corresponds to the number of points  
+   if (fCoordData.size() != fDim * fNPoints) { 
+      fCoordData.resize(fDim * fNPoints); 
+      const double * v = &((fDataVector->Data()).front()); 
+      for (unsigned int i = 0; i < fNPoints; ++i) 
+         for (unsigned int j = 0; j < fDim; ++j) 
+            fCoordData[j * fNPoints + i] = v[i * fPointSize + j]; 
+   }
+   return &fCoordData[icoord * fNPoints]; 
+}
+
 void BinData::AddBinUpEdge(const double *xup ) { 
 //      add multi dim bin upper edge data (coord2)
 
@@ -44,6 +44,7 @@ FitConfig::FitConfig(unsigned int npar) :
    fMinosErrors(false),    // do full Minos error analysis for all parameters
    fUpdateAfterFit(true),    // update after fit
    fWeightCorr(false),
+   fExecutionPolicy(kSerial),
    fSettings(std::vector<ParameterSettings>(npar) )  
 {
    // constructor implementation
@@ -69,6 +70,7 @@ FitConfig & FitConfig::operator = (const FitConfig &rhs) {
    fMinosErrors = rhs.fMinosErrors; 
    fUpdateAfterFit = rhs.fUpdateAfterFit;
    fWeightCorr     = rhs.fWeightCorr;
+   fExecutionPolicy = rhs.fExecutionPolicy;
 
    fSettings = rhs.fSettings; 
    fMinosParams = rhs.fMinosParams; 
@@ -234,6 +236,14 @@ ROOT::Math::Minimizer * FitConfig::CreateMinimizer() {
       }
    } 
 
+   ConfigureMinimizer(*min); 
+
+   return min; 
+} 
+
+void FitConfig::ConfigureMinimizer(ROOT::Math::Minimizer & min) { 
+   // set the control parameters of the minimizer according to the chosen configuration
+
    // set default max of function calls according to the number of parameters
    // formula from Minuit2 (adapted)
    if (fMinimizerOpts.MaxFunctionCalls() == 0) {  
@@ -244,17 +254,14 @@ ROOT::Math::Minimizer * FitConfig::CreateMinimizer() {
 
 
    // set default minimizer control parameters 
-   min->SetPrintLevel( fMinimizerOpts.PrintLevel() ); 
-   min->SetMaxFunctionCalls( fMinimizerOpts.MaxFunctionCalls() ); 
-   min->SetMaxIterations( fMinimizerOpts.MaxIterations() ); 
-   min->SetTolerance( fMinimizerOpts.Tolerance() ); 
-   min->SetPrecision( fMinimizerOpts.Precision() ); 
-   min->SetValidError( fParabErrors );
-   min->SetStrategy( fMinimizerOpts.Strategy() );
-   min->SetErrorDef( fMinimizerOpts.ErrorDef() );
-
-
-   return min; 
+   min.SetPrintLevel( fMinimizerOpts.PrintLevel() ); 
+   min.SetMaxFunctionCalls( fMinimizerOpts.MaxFunctionCalls() ); 
+   min.SetMaxIterations( fMinimizerOpts.MaxIterations() ); 
+   min.SetTolerance( fMinimizerOpts.Tolerance() ); 
+   min.SetPrecision( fMinimizerOpts.Precision() ); 
+   min.SetValidError( fParabErrors );
+   min.SetStrategy( fMinimizerOpts.Strategy() );
+   min.SetErrorDef( fMinimizerOpts.ErrorDef() );
 } 
 
 void FitConfig::SetDefaultMinimizer(const char * type, const char *algo ) { 
@@ -25,10 +25,12 @@
 
 #include "Math/Error.h"
 #include "Math/Util.h"  // for safe log(x)
+#include "Math/ThreadPool.h"
 
 #include <limits>
 #include <cmath>
 #include <cassert> 
+#include <algorithm>
 //#include <memory>
 
 //#define DEBUG
@@ -323,6 +325,278 @@ namespace ROOT {
 
 
 
+
+         // evaluation of the sums over a range [begin, end) of the data points, 
+         // used by the corresponding functions evaluating the sums over all the points
+
+         double DoEvaluateChi2(const IModelFunction & func, const BinData & data, const double * p, 
+                               unsigned int begin, unsigned int end, unsigned int & nPoints);
+         double DoEvaluateChi2Effective(const IModelFunction & func, const BinData & data, const double * p, 
+                                        unsigned int begin, unsigned int end, unsigned int & nPoints);
+         void DoEvaluateChi2Gradient(const IModelFunction & func, const BinData & data, const double * p, 
+                                     unsigned int begin, unsigned int end, double * grad, unsigned int & nPoints);
+         double DoEvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * p, int iWeight, bool extended, 
+                               double norm, unsigned int begin, unsigned int end, double & sumW, double & sumW2);
+         void DoEvaluateLogLGradient(const IModelFunction & func, const UnBinData & data, const double * p, 
+                                     unsigned int begin, unsigned int end, double * grad);
+         double DoEvaluatePoissonLogL(const IModelFunction & func, const BinData & data, const double * p, int iWeight, bool extended, 
+                                      unsigned int begin, unsigned int end, unsigned int & nPoints);
+         void DoEvaluatePoissonLogLGradient(const IModelFunction & func, const BinData & data, const double * p, 
+                                            unsigned int begin, unsigned int end, double * grad);
+
+
+         // number of data points evaluated by a task in the multi-thread evaluation. 
+         // It is fixed so that the partial sums, and then the result, do not depend 
+         // on the number of threads 
+         const unsigned int kChunkSize = 1024; 
+
+         // return true if the sums must be evaluated by chunks. 
+         // The external data (not copied in) are evaluated sequentially, since their 
+         // coordinates are returned by DataWrapper::Coords in a buffer shared by the threads. 
+         // The cache of the coordinates read by the BatchEvaluator is filled here, 
+         // before starting the threads
+         template <class Data> 
+         bool UseChunks(ExecutionPolicy executionPolicy, const Data & data) { 
+            if (executionPolicy != kMultithread || data.Size() <= kChunkSize || data.DataSize() == 0) 
+               return false; 
+            data.CoordData(0); 
+            return true; 
+         }
+
+         // number of points on which the model function is evaluated by a single call 
+         // to IModelFunction::EvalParVec 
+         const unsigned int kBatchSize = 256; 
+
+         // class evaluating the model function on blocks of consecutive points, 
+         // reading the coordinates stored by coordinate in the data (Data::CoordData). 
+         // The points should be requested in increasing order
+         template <class Data> 
+         class BatchEvaluator { 
+
+         public: 
+
+            BatchEvaluator(const IModelFunction & func, const Data & data, const double * p, unsigned int end) : 
+               fFunc(func), fData(data), fP(p), fEnd(end), fBegin(0), fLast(0) 
+            {}
+
+            // return the function value for the point i 
+            double operator() (unsigned int i) { 
+               if (i < fBegin || i >= fLast) Evaluate(i); 
+               return fValues[i - fBegin]; 
+            }
+
+         private: 
+
+            // evaluate the function on the block of points starting at i
+            void Evaluate(unsigned int i) { 
+               unsigned int ndim = fData.NDim(); 
+               if (fX.empty() ) { 
+                  fX.resize(ndim); 
+                  fValues.resize(kBatchSize); 
+               }
+               fBegin = i; 
+               fLast = std::min(i + kBatchSize, fEnd); 
+               for (unsigned int j = 0; j < ndim; ++j) 
+                  fX[j] = fData.CoordData(j) + i; 
+               fFunc.EvalParVec(fLast - fBegin, &fX.front(), fP, &fValues.front() ); 
+            }
+
+            const IModelFunction & fFunc; 
+            const Data & fData; 
+            const double * fP; 
+            unsigned int fEnd;                 // end of the evaluated range
+            unsigned int fBegin;               // first point of the current block
+            unsigned int fLast;                // end of the current block
+            std::vector<const double *> fX;    // coordinates of the current block
+            std::vector<double> fValues;       // function values of the current block
+         };
+
+         // class evaluating the sums over the data points by chunks, using the ThreadPool. 
+         // RangeEval is a functor computing the nvalues sums over a range of points 
+         // and returning the number of used points: 
+         //    unsigned int operator() (unsigned int begin, unsigned int end, double * sums) const 
+         template <class RangeEval> 
+         class ChunkEvaluator : public ROOT::Math::ThreadPool::ITask { 
+
+         public: 
+
+            ChunkEvaluator(const RangeEval & eval, unsigned int n, unsigned int nvalues) : 
+               fEval(eval), 
+               fN(n), 
+               fNValues(nvalues), 
+               fNChunks( (n + kChunkSize - 1) / kChunkSize ), 
+               fSums(std::vector<double>(fNChunks * nvalues) ), 
+               fNPoints(std::vector<unsigned int>(fNChunks) )
+            {}
+
+            void Execute(unsigned int ichunk) { 
+               unsigned int begin = ichunk * kChunkSize; 
+               unsigned int end = std::min(begin + kChunkSize, fN); 
+               fNPoints[ichunk] = fEval(begin, end, &fSums[ichunk * fNValues]); 
+            }
+
+            // evaluate all the chunks and sum their results in the chunk order 
+            // using the Kahan summation; return the total number of used points. 
+            // Use the default number of threads of the ThreadPool if it has been set, 
+            // otherwise all the cores
+            unsigned int Run(double * sums) { 
+               unsigned int nthreads = ROOT::Math::ThreadPool::DefaultNThreads(); 
+               if (nthreads == 1) nthreads = ROOT::Math::ThreadPool::NCores(); 
+               ROOT::Math::ThreadPool::Run(*this, fNChunks, nthreads); 
+               for (unsigned int k = 0; k < fNValues; ++k) { 
+                  double sum = 0; 
+                  double c = 0;  // running compensation of the lost low-order bits
+                  for (unsigned int ichunk = 0; ichunk < fNChunks; ++ichunk) { 
+                     double y = fSums[ichunk * fNValues + k] - c; 
+                     double t = sum + y; 
+                     c = (t - sum) - y; 
+                     sum = t; 
+                  }
+                  sums[k] = sum; 
+               }
+               unsigned int nPoints = 0; 
+               for (unsigned int ichunk = 0; ichunk < fNChunks; ++ichunk) 
+                  nPoints += fNPoints[ichunk]; 
+               return nPoints; 
+            }
+
+         private: 
+
+            RangeEval fEval; 
+            unsigned int fN;                    // number of data points
+            unsigned int fNValues;              // number of sums
+            unsigned int fNChunks;              // number of chunks
+            std::vector<double> fSums;          // sums of each chunk
+            std::vector<unsigned int> fNPoints; // used points of each chunk
+         }; 
+
+         // range functors for the ChunkEvaluator
+
+         // chi2 (standard or effective)
+         struct Chi2Range { 
+            typedef double (* DoEvalFunc)(const IModelFunction &, const BinData &, const double *, 
+                                          unsigned int, unsigned int, unsigned int &);
+            Chi2Range(DoEvalFunc doEval, const IModelFunction & func, const BinData & data, const double * p) : 
+               fDoEval(doEval), fFunc(func), fData(data), fP(p) {}
+            unsigned int operator() (unsigned int begin, unsigned int end, double * sums) const { 
+               unsigned int nPoints = 0; 
+               sums[0] = fDoEval(fFunc, fData, fP, begin, end, nPoints); 
+               return nPoints; 
+            }
+            DoEvalFunc fDoEval; 
+            const IModelFunction & fFunc; 
+            const BinData & fData; 
+            const double * fP; 
+         };
+
+         // model functions of the chunks of a gradient evaluation: the parameter gradient 
+         // may modify the model function (e.g. its cached parameters), so each chunk uses 
+         // its own clone. The clones are created before starting the threads
+         class ChunkFunctions { 
+
+         public: 
+
+            ChunkFunctions(const IModelFunction & func, unsigned int n) : 
+               fFuncs( (n + kChunkSize - 1) / kChunkSize ) 
+            { 
+               for (unsigned int i = 0; i < fFuncs.size(); ++i) { 
+                  fFuncs[i] = dynamic_cast<IModelFunction *>( func.Clone() ); 
+                  assert(fFuncs[i] != 0); 
+               }
+            }
+
+            ~ChunkFunctions() { 
+               for (unsigned int i = 0; i < fFuncs.size(); ++i) 
+                  delete fFuncs[i]; 
+            }
+
+            // return the function of the chunk starting at the point begin
+            const IModelFunction & operator() (unsigned int begin) const { 
+               return *fFuncs[begin / kChunkSize]; 
+            }
+
+         private: 
+
+            ChunkFunctions(const ChunkFunctions &); 
+            ChunkFunctions & operator= (const ChunkFunctions &); 
+
+            std::vector<IModelFunction *> fFuncs; 
+         };
+
+         // chi2 gradient
+         struct Chi2GradientRange { 
+            Chi2GradientRange(const ChunkFunctions & funcs, const BinData & data, const double * p) : 
+               fFuncs(funcs), fData(data), fP(p) {}
+            unsigned int operator() (unsigned int begin, unsigned int end, double * sums) const { 
+               unsigned int nPoints = 0; 
+               DoEvaluateChi2Gradient(fFuncs(begin), fData, fP, begin, end, sums, nPoints); 
+               return nPoints; 
+            }
+            const ChunkFunctions & fFuncs; 
+            const BinData & fData; 
+            const double * fP; 
+         };
+
+         // log likelihood: sums of the log(pdf), of the weights and of the weights square
+         struct LogLRange { 
+            LogLRange(const IModelFunction & func, const UnBinData & data, const double * p, int iWeight, bool extended, double norm) : 
+               fFunc(func), fData(data), fP(p), fWeight(iWeight), fExtended(extended), fNorm(norm) {}
+            unsigned int operator() (unsigned int begin, unsigned int end, double * sums) const { 
+               sums[1] = 0; 
+               sums[2] = 0; 
+               sums[0] = DoEvaluateLogL(fFunc, fData, fP, fWeight, fExtended, fNorm, begin, end, sums[1], sums[2]); 
+               return end - begin; 
+            }
+            const IModelFunction & fFunc; 
+            const UnBinData & fData; 
+            const double * fP; 
+            int fWeight; 
+            bool fExtended; 
+            double fNorm; 
+         };
+
+         // log likelihood gradient
+         struct LogLGradientRange { 
+            LogLGradientRange(const ChunkFunctions & funcs, const UnBinData & data, const double * p) : 
+               fFuncs(funcs), fData(data), fP(p) {}
+            unsigned int operator() (unsigned int begin, unsigned int end, double * sums) const { 
+               DoEvaluateLogLGradient(fFuncs(begin), fData, fP, begin, end, sums); 
+               return end - begin; 
+            }
+            const ChunkFunctions & fFuncs; 
+            const UnBinData & fData; 
+            const double * fP; 
+         };
+
+         // Poisson log likelihood
+         struct PoissonLogLRange { 
+            PoissonLogLRange(const IModelFunction & func, const BinData & data, const double * p, int iWeight, bool extended) : 
+               fFunc(func), fData(data), fP(p), fWeight(iWeight), fExtended(extended) {}
+            unsigned int operator() (unsigned int begin, unsigned int end, double * sums) const { 
+               unsigned int nPoints = 0; 
+               sums[0] = DoEvaluatePoissonLogL(fFunc, fData, fP, fWeight, fExtended, begin, end, nPoints); 
+               return nPoints; 
+            }
+            const IModelFunction & fFunc; 
+            const BinData & fData; 
+            const double * fP; 
+            int fWeight; 
+            bool fExtended; 
+         };
+
+         // Poisson log likelihood gradient
+         struct PoissonLogLGradientRange { 
+            PoissonLogLGradientRange(const ChunkFunctions & funcs, const BinData & data, const double * p) : 
+               fFuncs(funcs), fData(data), fP(p) {}
+            unsigned int operator() (unsigned int begin, unsigned int end, double * sums) const { 
+               DoEvaluatePoissonLogLGradient(fFuncs(begin), fData, fP, begin, end, sums); 
+               return end - begin; 
+            }
+            const ChunkFunctions & fFuncs; 
+            const BinData & fData; 
+            const double * fP; 
+         };
+
       } // end namespace  FitUtil      
 
 
@@ -331,11 +605,25 @@ namespace ROOT {
 // for chi2 functions
 //___________________________________________________________________________________________________________________________
 
-double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data, const double * p, unsigned int & nPoints) {  
+double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data, const double * p, unsigned int & nPoints, ExecutionPolicy executionPolicy) {  
    // evaluate the chi2 given a  function reference  , the data and returns the value and also in nPoints 
    // the actual number of used points
    // normal chi2 using only error on values (from fitting histogram)
    // optionally the integral of function in the bin is used 
+
+   unsigned int n = data.Size();
+   if (!UseChunks(executionPolicy, data) ) 
+      return DoEvaluateChi2(func, data, p, 0, n, nPoints); 
+
+   double chi2 = 0; 
+   ChunkEvaluator<Chi2Range> eval(Chi2Range(&DoEvaluateChi2, func, data, p), n, 1); 
+   nPoints = eval.Run(&chi2); 
+   return chi2; 
+}
+
+double FitUtil::DoEvaluateChi2(const IModelFunction & func, const BinData & data, const double * p, 
+                               unsigned int begin, unsigned int end, unsigned int & nPoints) {  
+   // evaluate the chi2 contribution of the points in [begin, end)
    
    unsigned int n = data.Size();
 
@@ -362,6 +650,8 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
 
 
    IntegralEvaluator<> igEval( func, p, useBinIntegral); 
+   // evaluate the function on blocks of points when they are used directly
+   BatchEvaluator<BinData> batchEval( func, data, p, end); 
 
    double maxResValue = std::numeric_limits<double>::max() /n;
    double wrefVolume = 1.0; 
@@ -371,7 +661,7 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
       xc.resize(data.NDim() );
    }
 
-   for (unsigned int i = 0; i < n; ++ i) { 
+   for (unsigned int i = begin; i < end; ++ i) { 
 
 
       double y, invError; 
@@ -395,7 +685,7 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
       const double * x = (useBinVolume) ? &xc.front() : x1;
 
       if (!useBinIntegral) {
-         fval = func ( x, p );
+         fval = (useBinVolume) ? func ( x, p ) : batchEval(i);
       }
       else {
          // calculate integral normalized by bin volume
@@ -444,7 +734,7 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
 
       
    }
-   nPoints=n;
+   nPoints = end - begin;
 
 #ifdef DEBUG
    std::cout << "chi2 = " << chi2 << " n = " << nPoints  /*<< " rejected = " << nRejected */ << std::endl;
@@ -457,11 +747,25 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
 
 //___________________________________________________________________________________________________________________________
 
-double FitUtil::EvaluateChi2Effective(const IModelFunction & func, const BinData & data, const double * p, unsigned int & nPoints) {  
+double FitUtil::EvaluateChi2Effective(const IModelFunction & func, const BinData & data, const double * p, unsigned int & nPoints, ExecutionPolicy executionPolicy) {  
    // evaluate the chi2 given a  function reference  , the data and returns the value and also in nPoints 
    // the actual number of used points
    // method using the error in the coordinates
    // integral of bin does not make sense in this case
+
+   unsigned int n = data.Size();
+   if (!UseChunks(executionPolicy, data) ) 
+      return DoEvaluateChi2Effective(func, data, p, 0, n, nPoints); 
+
+   double chi2 = 0; 
+   ChunkEvaluator<Chi2Range> eval(Chi2Range(&DoEvaluateChi2Effective, func, data, p), n, 1); 
+   nPoints = eval.Run(&chi2); 
+   return chi2; 
+}
+
+double FitUtil::DoEvaluateChi2Effective(const IModelFunction & func, const BinData & data, const double * p, 
+                                        unsigned int begin, unsigned int end, unsigned int & nPoints) {  
+   // evaluate the effective chi2 contribution of the points in [begin, end)
    
    unsigned int n = data.Size();
 
@@ -487,7 +791,7 @@ double FitUtil::EvaluateChi2Effective(const IModelFunction & func, const BinData
 
 
 
-   for (unsigned int i = 0; i < n; ++ i) { 
+   for (unsigned int i = begin; i < end; ++ i) { 
 
 
       double y = 0;
@@ -559,7 +863,7 @@ double FitUtil::EvaluateChi2Effective(const IModelFunction & func, const BinData
    }
    
    // reset the number of fitting data points
-   nPoints = n;  // no points are rejected 
+   nPoints = end - begin;  // no points are rejected 
    //if (nRejected != 0)  nPoints = n - nRejected;   
 
 #ifdef DEBUG
@@ -683,7 +987,7 @@ double FitUtil::EvaluateChi2Residual(const IModelFunction & func, const BinData
 
 }
 
-void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & data, const double * p, double * grad, unsigned int & nPoints) { 
+void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & data, const double * p, double * grad, unsigned int & nPoints, ExecutionPolicy executionPolicy) { 
    // evaluate the gradient of the chi2 function
    // this function is used when the model function knows how to calculate the derivative and we can  
    // avoid that the minimizer re-computes them 
@@ -694,17 +998,35 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
       MATH_ERROR_MSG("FitUtil::EvaluateChi2Residual","Error on the coordinates are not used in calculating Chi2 gradient");            return; // it will assert otherwise later in GetPoint
    }
 
+   unsigned int n = data.Size();
+   if (!UseChunks(executionPolicy, data) ) 
+      DoEvaluateChi2Gradient(f, data, p, 0, n, grad, nPoints); 
+   else { 
+      ChunkFunctions funcs(f, n); 
+      ChunkEvaluator<Chi2GradientRange> eval(Chi2GradientRange(funcs, data, p), n, f.NPar() ); 
+      nPoints = eval.Run(grad); 
+   }
+
+   // check the number of points
+   if (nPoints < n && nPoints < f.NPar() )  
+      MATH_ERROR_MSG("FitUtil::EvaluateChi2Gradient","Error - too many points rejected for overflow in gradient calculation");
+}
+
+void FitUtil::DoEvaluateChi2Gradient(const IModelFunction & f, const BinData & data, const double * p, 
+                                     unsigned int begin, unsigned int end, double * grad, unsigned int & nPoints) { 
+   // evaluate the chi2 gradient contribution of the points in [begin, end)
+   // and return in nPoints the number of points not rejected
+
    unsigned int nRejected = 0; 
 
    const IGradModelFunction * fg = dynamic_cast<const IGradModelFunction *>( &f); 
    assert (fg != 0); // must be called by a gradient function
 
    const IGradModelFunction & func = *fg; 
-   unsigned int n = data.Size();
 
 
 #ifdef DEBUG
-   std::cout << "\n\nFit data size = " << n << std::endl;
+   std::cout << "\n\nFit data size = " << end - begin << std::endl;
    std::cout << "evaluate chi2 using function gradient " << &func << "  " << p << std::endl; 
 #endif
 
@@ -730,7 +1052,7 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
    // set all vector values to zero
    std::vector<double> g( npar); 
 
-   for (unsigned int i = 0; i < n; ++ i) { 
+   for (unsigned int i = begin; i < end; ++ i) { 
 
 
       double y, invError = 0; 
@@ -807,12 +1129,8 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
    } 
 
    // correct the number of points
-   nPoints = n; 
-   if (nRejected != 0)  {
-      assert(nRejected <= n);
-      nPoints = n - nRejected;
-      if (nPoints < npar)  MATH_ERROR_MSG("FitUtil::EvaluateChi2Gradient","Error - too many points rejected for overflow in gradient calculation");
-   } 
+   assert(nRejected <= end - begin);
+   nPoints = end - begin - nRejected;
 
    // copy result 
    std::copy(g.begin(), g.end(), grad);
@@ -876,7 +1194,7 @@ double FitUtil::EvaluatePdf(const IModelFunction & func, const UnBinData & data,
 }
 
 double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * p,
-                                   int iWeight,  bool extended, unsigned int &nPoints) {  
+                                   int iWeight,  bool extended, unsigned int &nPoints, ExecutionPolicy executionPolicy) {  
    // evaluate the LogLikelihood 
 
    unsigned int n = data.Size();
@@ -905,35 +1223,15 @@ double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data
    double sumW = 0;
    double sumW2 = 0;
 
-   for (unsigned int i = 0; i < n; ++ i) { 
-      const double * x = data.Coords(i);
-      double fval = func ( x, p ); 
-      if (normalizeFunc) fval = fval / norm;
-
-#ifdef DEBUG      
-      std::cout << "x [ " << data.NDim() << " ] = "; 
-      for (unsigned int j = 0; j < data.NDim(); ++j)
-         std::cout << x[j] << "\t"; 
-      std::cout << "\tpar = [ " << func.NPar() << " ] =  "; 
-      for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar) 
-         std::cout << p[ipar] << "\t";
-      std::cout << "\tfval = " << fval << std::endl; 
-#endif
-      // function EvalLog protects against negative or too small values of fval
-      double logval =  ROOT::Math::Util::EvalLog( fval);       
-      if (iWeight > 0) { 
-         double weight = data.Weight(i); 
-         logval *= weight; 
-         if (iWeight ==2) { 
-            logval *= weight; // use square of weights in likelihood
-            if (extended) { 
-               // needed sum of weights and sum of weight square if likelkihood is extended
-               sumW += weight; 
-               sumW2 += weight*weight; 
-            }
-         }
-      }
-      logl += logval;
+   if (!UseChunks(executionPolicy, data) ) 
+      logl = DoEvaluateLogL(func, data, p, iWeight, extended, norm, 0, n, sumW, sumW2); 
+   else { 
+      double sums[3]; 
+      ChunkEvaluator<LogLRange> eval(LogLRange(func, data, p, iWeight, extended, norm), n, 3); 
+      eval.Run(sums); 
+      logl  = sums[0]; 
+      sumW  = sums[1]; 
+      sumW2 = sums[2]; 
    }
 
    if (extended) { 
@@ -991,9 +1289,63 @@ double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data
    return -logl;
 }
 
-void FitUtil::EvaluateLogLGradient(const IModelFunction & f, const UnBinData & data, const double * p, double * grad, unsigned int & ) { 
+double FitUtil::DoEvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * p, int iWeight, bool extended, 
+                               double norm, unsigned int begin, unsigned int end, double & sumW, double & sumW2) { 
+   // evaluate the sum of the log(pdf) of the points in [begin, end), with the pdf divided by norm
+   // and add in sumW and sumW2 the sums of weights needed in weighted extended fits
+
+   double logl = 0;
+   BatchEvaluator<UnBinData> batchEval( func, data, p, end); 
+   for (unsigned int i = begin; i < end; ++ i) { 
+      double fval = batchEval(i); 
+      if (norm != 1.0) fval = fval / norm;
+
+#ifdef DEBUG      
+      const double * x = data.Coords(i);
+      std::cout << "x [ " << data.NDim() << " ] = "; 
+      for (unsigned int j = 0; j < data.NDim(); ++j)
+         std::cout << x[j] << "\t"; 
+      std::cout << "\tpar = [ " << func.NPar() << " ] =  "; 
+      for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar) 
+         std::cout << p[ipar] << "\t";
+      std::cout << "\tfval = " << fval << std::endl; 
+#endif
+      // function EvalLog protects against negative or too small values of fval
+      double logval =  ROOT::Math::Util::EvalLog( fval);       
+      if (iWeight > 0) { 
+         double weight = data.Weight(i); 
+         logval *= weight; 
+         if (iWeight ==2) { 
+            logval *= weight; // use square of weights in likelihood
+            if (extended) { 
+               // needed sum of weights and sum of weight square if likelkihood is extended
+               sumW += weight; 
+               sumW2 += weight*weight; 
+            }
+         }
+      }
+      logl += logval;
+   }
+   return logl;
+}
+
+void FitUtil::EvaluateLogLGradient(const IModelFunction & f, const UnBinData & data, const double * p, double * grad, unsigned int & , ExecutionPolicy executionPolicy) { 
    // evaluate the gradient of the log likelihood function
 
+   unsigned int n = data.Size();
+   if (!UseChunks(executionPolicy, data) ) 
+      DoEvaluateLogLGradient(f, data, p, 0, n, grad); 
+   else { 
+      ChunkFunctions funcs(f, n); 
+      ChunkEvaluator<LogLGradientRange> eval(LogLGradientRange(funcs, data, p), n, f.NPar() ); 
+      eval.Run(grad); 
+   }
+}
+
+void FitUtil::DoEvaluateLogLGradient(const IModelFunction & f, const UnBinData & data, const double * p, 
+                                     unsigned int begin, unsigned int end, double * grad) { 
+   // evaluate the log likelihood gradient contribution of the points in [begin, end)
+
    const IGradModelFunction * fg = dynamic_cast<const IGradModelFunction *>( &f); 
    assert (fg != 0); // must be called by a grad function
    const IGradModelFunction & func = *fg; 
@@ -1005,7 +1357,7 @@ void FitUtil::EvaluateLogLGradient(const IModelFunction & f, const UnBinData & d
    std::vector<double> gradFunc( npar ); 
    std::vector<double> g( npar); 
 
-   for (unsigned int i = 0; i < n; ++ i) { 
+   for (unsigned int i = begin; i < end; ++ i) { 
       const double * x = data.Coords(i);
       double fval = func ( x , p); 
       func.ParameterGradient( x, p, &gradFunc[0] );
@@ -1022,10 +1374,10 @@ void FitUtil::EvaluateLogLGradient(const IModelFunction & f, const UnBinData & d
          }
          // if func derivative is zero term is also zero so do not add in g[kpar]
       }
+   }
             
-    // copy result 
+   // copy result 
    std::copy(g.begin(), g.end(), grad);
-   }
 }
 //_________________________________________________________________________________________________
 // for binned log likelihood functions      
@@ -1137,7 +1489,7 @@ double FitUtil::EvaluatePoissonBinPdf(const IModelFunction & func, const BinData
 }
 
 double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData & data, 
-                                    const double * p, int iWeight, bool extended,  unsigned int &   nPoints ) {  
+                                    const double * p, int iWeight, bool extended,  unsigned int &   nPoints, ExecutionPolicy executionPolicy ) {  
    // evaluate the Poisson Log Likelihood
    // for binned likelihood fits
    // this is Sum ( f(x_i)  -  y_i * log( f (x_i) ) )
@@ -1153,13 +1505,25 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
    // iWeight = 2 ==> logL = Sum( w*w * f(x_i) )
    //
    // nPoints returns the points where bin content is not zero
-         
 
    unsigned int n = data.Size();
+   if (!UseChunks(executionPolicy, data) ) 
+      return DoEvaluatePoissonLogL(func, data, p, iWeight, extended, 0, n, nPoints); 
+
+   double nloglike = 0; 
+   ChunkEvaluator<PoissonLogLRange> eval(PoissonLogLRange(func, data, p, iWeight, extended), n, 1); 
+   nPoints = eval.Run(&nloglike); 
+   return nloglike; 
+}
+
+double FitUtil::DoEvaluatePoissonLogL(const IModelFunction & func, const BinData & data, const double * p, int iWeight, bool extended, 
+                                      unsigned int begin, unsigned int end, unsigned int & nPoints) {  
+   // evaluate the Poisson log likelihood contribution of the points in [begin, end)
+
 #ifdef DEBUG
    std::cout << "Evaluate PoissonLogL for params = [ "; 
    for (unsigned int j=0; j < func.NPar(); ++j) std::cout << p[j] << " , ";
-   std::cout << "]  - data size = " << n << std::endl;
+   std::cout << "]  - data size = " << end - begin << std::endl;
 #endif
    
    double nloglike = 0;  // negative loglikelihood 
@@ -1180,13 +1544,15 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
    }
 
    IntegralEvaluator<> igEval( func, p, fitOpt.fIntegral); 
+   // evaluate the function on blocks of points when they are used directly
+   BatchEvaluator<BinData> batchEval( func, data, p, end); 
 
    // double nuTot = 0; // total number of expected events (needed for non-extended fits) 
    // double wTot = 0; // sum of all weights  
    // double w2Tot = 0; // sum of weight squared  (these are needed for useW2)
 
 
-   for (unsigned int i = 0; i < n; ++ i) { 
+   for (unsigned int i = begin; i < end; ++ i) { 
       const double * x1 = data.Coords(i);
       double y = data.Value(i);
       
@@ -1207,7 +1573,7 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
       const double * x = (useBinVolume) ? &xc.front() : x1;
 
       if (!useBinIntegral) {
-         fval = func ( x, p );
+         fval = (useBinVolume) ? func ( x, p ) : batchEval(i);
       }
       else {
          // calculate integral (normalized by bin volume) 
@@ -1303,9 +1669,23 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
    return nloglike;  
 }
 
-void FitUtil::EvaluatePoissonLogLGradient(const IModelFunction & f, const BinData & data, const double * p, double * grad ) { 
+void FitUtil::EvaluatePoissonLogLGradient(const IModelFunction & f, const BinData & data, const double * p, double * grad, ExecutionPolicy executionPolicy ) { 
    // evaluate the gradient of the Poisson log likelihood function
 
+   unsigned int n = data.Size();
+   if (!UseChunks(executionPolicy, data) ) 
+      DoEvaluatePoissonLogLGradient(f, data, p, 0, n, grad); 
+   else { 
+      ChunkFunctions funcs(f, n); 
+      ChunkEvaluator<PoissonLogLGradientRange> eval(PoissonLogLGradientRange(funcs, data, p), n, f.NPar() ); 
+      eval.Run(grad); 
+   }
+}
+
+void FitUtil::DoEvaluatePoissonLogLGradient(const IModelFunction & f, const BinData & data, const double * p, 
+                                            unsigned int begin, unsigned int end, double * grad) { 
+   // evaluate the Poisson log likelihood gradient contribution of the points in [begin, end)
+
    const IGradModelFunction * fg = dynamic_cast<const IGradModelFunction *>( &f); 
    assert (fg != 0); // must be called by a grad function
    const IGradModelFunction & func = *fg; 
@@ -1329,7 +1709,7 @@ void FitUtil::EvaluatePoissonLogLGradient(const IModelFunction & f, const BinDat
    std::vector<double> gradFunc( npar ); 
    std::vector<double> g( npar); 
 
-   for (unsigned int i = 0; i < n; ++ i) { 
+   for (unsigned int i = begin; i < end; ++ i) { 
       const double * x1 = data.Coords(i);
       double y = data.Value(i);
       double fval = 0; 
@@ -1380,10 +1760,10 @@ void FitUtil::EvaluatePoissonLogLGradient(const IModelFunction & f, const BinDat
             g[kpar] -= gg;
          }
       }            
-
-      // copy result 
-      std::copy(g.begin(), g.end(), grad);
    }
+
+   // copy result 
+   std::copy(g.begin(), g.end(), grad);
 }
    
 }
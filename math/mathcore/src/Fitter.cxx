@@ -49,6 +49,7 @@ Fitter::Fitter() :
    fBinFit(false),
    fFitType(0),
    fDataSize(0),
+   fKeepMinimizer(false),
    fFunc(0)
 {
    // Default constructor implementation.
@@ -331,7 +332,7 @@ bool Fitter::DoLeastSquareFit(const BinData & data) {
    // check if fFunc provides gradient
    if (!fUseGradient) { 
       // do minimzation without using the gradient
-      Chi2FCN<BaseFunc> chi2(data,*fFunc); 
+      Chi2FCN<BaseFunc> chi2(data,*fFunc,fConfig.GetExecutionPolicy()); 
       fFitType = chi2.Type();
       return DoMinimization (chi2); 
    } 
@@ -341,7 +342,7 @@ bool Fitter::DoLeastSquareFit(const BinData & data) {
          MATH_INFO_MSG("Fitter::DoLeastSquareFit","use gradient from model function");        
       IGradModelFunction * gradFun = dynamic_cast<IGradModelFunction *>(fFunc); 
       if (gradFun != 0) { 
-         Chi2FCN<BaseGradFunc> chi2(data,*gradFun); 
+         Chi2FCN<BaseGradFunc> chi2(data,*gradFun,fConfig.GetExecutionPolicy()); 
          fFitType = chi2.Type();
          return DoMinimization (chi2); 
       }
@@ -377,11 +378,11 @@ bool Fitter::DoLikelihoodFit(const BinData & data, bool extended) {
    fDataSize = data.Size();
 
    // create a chi2 function to be used for the equivalent chi-square
-   Chi2FCN<BaseFunc> chi2(data,*fFunc); 
+   Chi2FCN<BaseFunc> chi2(data,*fFunc,fConfig.GetExecutionPolicy()); 
 
    if (!fUseGradient) { 
       // do minimization without using the gradient
-      PoissonLikelihoodFCN<BaseFunc> logl(data,*fFunc, useWeight, extended); 
+      PoissonLikelihoodFCN<BaseFunc> logl(data,*fFunc, useWeight, extended, fConfig.GetExecutionPolicy()); 
       fFitType = logl.Type();
       // do minimization
       if (!DoMinimization (logl, &chi2) ) return false; 
@@ -404,7 +405,7 @@ bool Fitter::DoLikelihoodFit(const BinData & data, bool extended) {
       if (!extended) {  
          MATH_WARN_MSG("Fitter::DoLikelihoodFit","Not-extended binned fit with gradient not yet supported - do an extended fit");        
       }
-      PoissonLikelihoodFCN<BaseGradFunc> logl(data,*gradFun, useWeight, true); 
+      PoissonLikelihoodFCN<BaseGradFunc> logl(data,*gradFun, useWeight, true, fConfig.GetExecutionPolicy()); 
       fFitType = logl.Type();
       // do minimization
       if (!DoMinimization (logl, &chi2) ) return false;
@@ -448,7 +449,7 @@ bool Fitter::DoLikelihoodFit(const UnBinData & data, bool extended) {
 
    if (!fUseGradient) { 
       // do minimization without using the gradient
-      LogLikelihoodFCN<BaseFunc> logl(data,*fFunc, useWeight, extended); 
+      LogLikelihoodFCN<BaseFunc> logl(data,*fFunc, useWeight, extended, fConfig.GetExecutionPolicy()); 
       fFitType = logl.Type();
       if (!DoMinimization (logl) ) return false;
       if (useWeight) { 
@@ -466,7 +467,7 @@ bool Fitter::DoLikelihoodFit(const UnBinData & data, bool extended) {
          if (extended) {  
             MATH_WARN_MSG("Fitter::DoLikelihoodFit","Extended unbinned fit with gradient not yet supported - do a not-extended fit");        
          }
-         LogLikelihoodFCN<BaseGradFunc> logl(data,*gradFun,useWeight, extended); 
+         LogLikelihoodFCN<BaseGradFunc> logl(data,*gradFun,useWeight, extended, fConfig.GetExecutionPolicy()); 
          fFitType = logl.Type();
          if (!DoMinimization (logl) ) return false;
          if (useWeight) { 
@@ -643,12 +644,19 @@ bool Fitter::DoInitMinimizer() {
       return false;
    }
 
-   // create first Minimizer  
-   // using an auto_Ptr will delete the previous existing one
-   fMinimizer = std::auto_ptr<ROOT::Math::Minimizer> ( fConfig.CreateMinimizer() );
-   if (fMinimizer.get() == 0) {
-      MATH_ERROR_MSG("Fitter::FitFCN","Minimizer cannot be created");
-      return false; 
+   if (fKeepMinimizer && fMinimizer.get() ) { 
+      // reuse the minimizer given with SetMinimizer, resetting the previous minimization 
+      fMinimizer->Clear(); 
+      fConfig.ConfigureMinimizer(*fMinimizer); 
+   }
+   else { 
+      // create first Minimizer  
+      // using an auto_Ptr will delete the previous existing one
+      fMinimizer = std::auto_ptr<ROOT::Math::Minimizer> ( fConfig.CreateMinimizer() );
+      if (fMinimizer.get() == 0) {
+         MATH_ERROR_MSG("Fitter::FitFCN","Minimizer cannot be created");
+         return false; 
+      }
    }
 
    // in case of gradient function one needs to downcast the pointer
@@ -674,6 +682,13 @@ bool Fitter::DoInitMinimizer() {
 }
 
 
+void Fitter::SetMinimizer(ROOT::Math::Minimizer * min) { 
+   // set the minimizer to be reused in the following fits (the Fitter takes ownership)
+   fMinimizer = std::auto_ptr<ROOT::Math::Minimizer>(min); 
+   fKeepMinimizer = (min != 0); 
+}
+
+
 bool Fitter::DoMinimization(const ROOT::Math::IMultiGenFunction * chi2func) { 
    // perform the minimization (assume we have already initialized the minimizer)
 
@@ -20,23 +20,42 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "TStatistic.h"
+#include "TStatisticHelper.h"
 
 
 templateClassImp(TStatistic)
 
+namespace {
+
+   // Fill value i of TStatistic::FillN
+   class TStatisticFill {
+   public:
+      TStatisticFill(const Double_t *val, const Double_t *w) : fVal(val), fW(w) {}
+      void operator()(TStatistic &st, Int_t i) const {
+         if (fW) st.Fill(fVal[i], fW[i]);
+         else    st.Fill(fVal[i]);
+      }
+   private:
+      const Double_t *fVal;
+      const Double_t *fW;
+   };
+
+}
+
 //______________________________________________________________________________
 TStatistic::TStatistic(const char *name, Int_t n, const Double_t *val, const Double_t *w)
          : fName(name), fN(0), fW(0.), fW2(0.), fMean(0.), fM2(0.)
 {
    // Constructor from a vector of values
    
-   if (n > 0) {
-      for (Int_t i = 0; i < n; i++) {
-         if (w) {
-            Fill(val[i], w[i]);
-         } else {
-            Fill(val[i]);
-         }
-      }
-   }   
+   FillN(n, val, w);
+}
+
+//______________________________________________________________________________
+void TStatistic::FillN(Int_t n, const Double_t *val, const Double_t *w)
+{
+   // Fill the n values val with weights w (1 if w is null); large arrays
+   // are filled in parallel, see TStatisticHelper::FillN.
+
+   TStatisticHelper::FillN(this, n, TStatisticFill(val, w), TStatistic());
 }
@@ -0,0 +1,175 @@
+// @(#)root/mathcore:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TStatisticDecay                                                      //
+//                                                                      //
+// Statistical variable with exponentially decaying weights, e.g. for   //
+// monitoring the recent values of a quantity. Each value is filled     //
+// with a time ti (any increasing quantity, e.g. seconds or an event    //
+// counter); at the time t of the latest fill its weight is             //
+// w*exp(-(t-ti)/tau). The mean, RMS and errors are computed as in      //
+// TStatistic with these weights. Values may be filled out of time      //
+// order.                                                               //
+//                                                                      //
+// Objects filled separately, e.g. by different threads or jobs, are    //
+// combined with Add or Merge (hadd) as if all the values had been      //
+// filled in a single object; they must have the same decay time.       //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "TStatisticDecay.h"
+#include "TROOT.h"
+#include "TStatisticHelper.h"
+
+
+ClassImp(TStatisticDecay)
+
+namespace {
+
+   // Fill value i of TStatisticDecay::FillN
+   class TStatisticDecayFill {
+   public:
+      TStatisticDecayFill(const Double_t *val, const Double_t *t, const Double_t *w)
+         : fVal(val), fT(t), fW(w) {}
+      void operator()(TStatisticDecay &st, Int_t i) const {
+         st.Fill(fVal[i], fT[i], fW ? fW[i] : 1.);
+      }
+   private:
+      const Double_t *fVal;
+      const Double_t *fT;
+      const Double_t *fW;
+   };
+
+}
+
+//______________________________________________________________________________
+void TStatisticDecay::DecayTo(Double_t t)
+{
+   // Decay the accumulated weights to the time t, if later than the time of
+   // the latest fill.
+
+   if (t <= fTime) return;
+   if (fN > 0) {
+      Double_t f = TMath::Exp(-(t - fTime) / fTau);
+      fW *= f;
+      fW2 *= f * f;
+      fM2 *= f;
+   }
+   fTime = t;
+}
+
+//______________________________________________________________________________
+Double_t TStatisticDecay::GetW(Double_t t) const
+{
+   // Sum of the weights decayed to the time t (no decay for t before the
+   // time of the latest fill).
+
+   if (t <= fTime) return fW;
+   return fW * TMath::Exp(-(t - fTime) / fTau);
+}
+
+//______________________________________________________________________________
+void TStatisticDecay::Fill(Double_t val, Double_t t, Double_t w)
+{
+   // Fill the value val at time t with weight w.
+
+   if (fN == 0) fTime = t;
+   else if (t > fTime) DecayTo(t);
+   else if (t < fTime) w *= TMath::Exp(-(fTime - t) / fTau);
+   fN++;
+   // Incremental quantities
+   Double_t tW = w + fW;
+   if (tW == 0.) return;
+   Double_t dt = val - fMean;
+   Double_t rr = dt * w / tW;
+   fMean += rr;
+   fM2 += fW * dt * rr;
+   fW = tW;
+   fW2 += w * w;
+}
+
+//______________________________________________________________________________
+void TStatisticDecay::FillN(Int_t n, const Double_t *val, const Double_t *t, const Double_t *w)
+{
+   // Fill the n values val at times t with weights w (1 if w is null);
+   // large arrays are filled in parallel, see TStatisticHelper::FillN.
+
+   TStatisticHelper::FillN(this, n, TStatisticDecayFill(val, t, w), TStatisticDecay("", fTau));
+}
+
+//______________________________________________________________________________
+void TStatisticDecay::Add(const TStatisticDecay &s)
+{
+   // Add the values filled in s, as if they had been filled in this object.
+
+   if (s.fN == 0) return;
+   if (s.fTau != fTau)
+      Warning("Add", "adding %s with decay time %g to %s with decay time %g",
+              s.GetName(), s.fTau, GetName(), fTau);
+   if (fN == 0) {
+      fTime = s.fTime;
+   }
+   // bring both to the latest time
+   TStatisticDecay c(s);
+   c.fTau = fTau;
+   c.DecayTo(fTime);
+   DecayTo(c.fTime);
+
+   fN += c.fN;
+   fW2 += c.fW2;
+   Double_t tW = fW + c.fW;
+   if (tW == 0.) return;
+   Double_t dt = c.fMean - fMean;
+   Double_t rr = dt * c.fW / tW;
+   fMean += rr;
+   fM2 += c.fM2 + fW * dt * rr;
+   fW = tW;
+}
+
+//______________________________________________________________________________
+Int_t TStatisticDecay::Merge(TCollection *in)
+{
+   // Merge objects in the list.
+   // Returns the number of objects that were in the list.
+
+   TIter nxo(in);
+   Int_t n = 0;
+   while (TObject *o = nxo()) {
+      TStatisticDecay *c = dynamic_cast<TStatisticDecay *>(o);
+      if (c) {
+         Add(*c);
+         n++;
+      }
+   }
+   return n;
+}
+
+//______________________________________________________________________________
+void TStatisticDecay::Reset()
+{
+   // Remove all the values, keeping the name and the decay time.
+
+   fTime = 0.;
+   fN = 0;
+   fW = fW2 = fMean = fM2 = 0.;
+}
+
+//______________________________________________________________________________
+void TStatisticDecay::Print(Option_t *) const
+{
+   // Print this parameter content
+
+   TROOT::IndentLevel();
+   Printf(" OBJ: TStatisticDecay\t %s = %.3g +- %.3g \t RMS = %.3g \t W = %.3g \t tau = %.3g \t t = %.3g",
+          fName.Data(), fMean, GetMeanErr(), GetRMS(), fW, fTau, fTime);
+}
@@ -0,0 +1,78 @@
+// @(#)root/mathcore:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TStatisticHelper
+#define ROOT_TStatisticHelper
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TStatisticHelper                                                     //
+//                                                                      //
+// Helper for the FillN methods of TStatistic, TStatisticDecay and      //
+// TStatisticHistogram.                                                 //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "TMath.h"
+#include "Math/ThreadPool.h"
+
+#include <vector>
+
+class TStatisticHelper {
+
+public:
+   // number of values filled by a task of FillN
+   enum { kFillChunk = 8192 };
+
+   template <typename T, typename F>
+   static void FillN(T *st, Int_t n, const F &fill, const T &empty);
+
+private:
+   template <typename T, typename F>
+   class TFillTask : public ROOT::Math::ThreadPool::ITask {
+   public:
+      TFillTask(Int_t n, const F &fill, std::vector<T> &part) : fN(n), fFill(fill), fPart(part) {}
+      void Execute(unsigned int itask) {
+         Int_t first = itask * kFillChunk;
+         Int_t last = TMath::Min(first + Int_t(kFillChunk), fN);
+         T &st = fPart[itask];
+         for (Int_t i = first; i < last; i++) fFill(st, i);
+      }
+   private:
+      Int_t           fN;
+      const F        &fFill;
+      std::vector<T> &fPart;
+   };
+};
+
+//______________________________________________________________________________
+template <typename T, typename F>
+void TStatisticHelper::FillN(T *st, Int_t n, const F &fill, const T &empty)
+{
+   // Fill the n values 0 <= i < n into st, value i with fill(*st, i).
+   // Large arrays are split in chunks of fixed size, each filled into a copy
+   // of empty, in parallel when ROOT::Math::ThreadPool::SetDefaultNThreads
+   // has been called; the chunks are combined in order with Add, so that the
+   // result does not depend on the number of threads.
+
+   if (n <= 0) return;
+   if (n <= kFillChunk) {
+      for (Int_t i = 0; i < n; i++) fill(*st, i);
+      return;
+   }
+   Int_t nchunks = (n + kFillChunk - 1) / kFillChunk;
+   std::vector<T> part(nchunks, empty);
+   TFillTask<T, F> task(n, fill, part);
+   ROOT::Math::ThreadPool::Run(task, nchunks);
+   for (Int_t i = 0; i < nchunks; i++) st->Add(part[i]);
+}
+
+#endif
@@ -0,0 +1,408 @@
+// @(#)root/mathcore:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TStatisticHistogram                                                  //
+//                                                                      //
+// Streaming histogram of a statistical variable, following the         //
+// algorithm of Y. Ben-Haim and E. Tom-Tov (J. Mach. Learn. Res. 11,    //
+// 2010). At most fMaxBins bins are kept, each defined by its center    //
+// and weight; when there are more, the two closest bins are replaced   //
+// by one bin at their weighted mean. The bins therefore follow the     //
+// range of the values, which does not need to be known in advance.     //
+// The filled values are buffered and added to the bins in groups.      //
+//                                                                      //
+// GetQuantile(s) and GetSum (the weight of the values below x)         //
+// interpolate linearly the cumulative distribution between the bin     //
+// centers, assuming half of the weight of a bin on each side of its    //
+// center. The mean is exact.                                           //
+//                                                                      //
+// Objects filled separately, e.g. by different threads or jobs, are    //
+// combined with Add or Merge (hadd): the bins of the other object are  //
+// added as weighted values.                                            //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "TStatisticHistogram.h"
+#include "TROOT.h"
+#include "TMath.h"
+#include "TStatisticHelper.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+
+ClassImp(TStatisticHistogram)
+
+namespace {
+
+   // the buffer is added to the bins when it has kBufferFactor*fMaxBins values
+   const Int_t kBufferFactor = 4;
+
+   //______________________________________________________________________________
+   // Distance between two adjacent bins i < j, with the version of the bins
+   // at the time it was computed
+   struct TBinGap {
+      Double_t fGap;
+      Int_t    fI;
+      Int_t    fJ;
+      Int_t    fVi;
+      Int_t    fVj;
+      TBinGap(Double_t gap, Int_t i, Int_t j, Int_t vi, Int_t vj) :
+         fGap(gap), fI(i), fJ(j), fVi(vi), fVj(vj) {}
+      bool operator>(const TBinGap &g) const {
+         return fGap > g.fGap || (fGap == g.fGap && fI > g.fI);
+      }
+   };
+
+   //______________________________________________________________________________
+   // Fill value i of TStatisticHistogram::FillN
+   class TStatisticHistogramFill {
+   public:
+      TStatisticHistogramFill(const Double_t *val, const Double_t *w) : fVal(val), fW(w) {}
+      void operator()(TStatisticHistogram &st, Int_t i) const {
+         st.Fill(fVal[i], fW ? fW[i] : 1.);
+      }
+   private:
+      const Double_t *fVal;
+      const Double_t *fW;
+   };
+
+}
+
+//______________________________________________________________________________
+TStatisticHistogram::TStatisticHistogram(const char *name, Int_t maxbins)
+   : fName(name), fMaxBins(maxbins), fN(0), fW(0.), fMin(0.), fMax(0.)
+{
+   // Constructor. maxbins is the maximum number of bins (at least 2);
+   // the precision of the quantiles increases with it.
+
+   if (fMaxBins < 2) fMaxBins = 2;
+}
+
+//______________________________________________________________________________
+void TStatisticHistogram::Fill(Double_t val, Double_t w)
+{
+   // Fill the value val with weight w. Values with w <= 0 are ignored.
+
+   if (!(w > 0.)) return;
+   if (fN == 0) {
+      fMin = fMax = val;
+   } else {
+      if (val < fMin) fMin = val;
+      if (val > fMax) fMax = val;
+   }
+   fN++;
+   fW += w;
+   fBuffer.push_back(val);
+   fBufferW.push_back(w);
+   if ((Int_t)fBuffer.size() >= kBufferFactor * fMaxBins) Compress();
+}
+
+//______________________________________________________________________________
+void TStatisticHistogram::FillN(Int_t n, const Double_t *val, const Double_t *w)
+{
+   // Fill the n values val with weights w (1 if w is null); large arrays
+   // are filled in parallel, see TStatisticHelper::FillN.
+
+   TStatisticHelper::FillN(this, n, TStatisticHistogramFill(val, w), TStatisticHistogram("", fMaxBins));
+}
+
+//______________________________________________________________________________
+void TStatisticHistogram::Compress()
+{
+   // Add the buffered values to the bins, then merge the closest bins until
+   // there are at most fMaxBins of them.
+
+   if (fBuffer.empty()) return;
+
+   // merge the sorted buffer with the bins, adding the weights of equal values
+   Int_t nb = fBuffer.size();
+   Int_t nc = fCenter.size();
+   std::vector<Int_t> index(nb);
+   TMath::Sort(nb, &fBuffer[0], &index[0], kFALSE);
+   std::vector<Double_t> x;
+   std::vector<Double_t> w;
+   x.reserve(nb + nc);
+   w.reserve(nb + nc);
+   Int_t i = 0, j = 0;
+   while (i < nc || j < nb) {
+      Double_t xi, wi;
+      if (j == nb || (i < nc && fCenter[i] <= fBuffer[index[j]])) {
+         xi = fCenter[i];
+         wi = fWeight[i];
+         ++i;
+      } else {
+         xi = fBuffer[index[j]];
+         wi = fBufferW[index[j]];
+         ++j;
+      }
+      if (!x.empty() && x.back() == xi) w.back() += wi;
+      else {
+         x.push_back(xi);
+         w.push_back(wi);
+      }
+   }
+   fBuffer.clear();
+   fBufferW.clear();
+
+   Int_t m = x.size();
+   if (m > fMaxBins) {
+      // merge the two closest bins until fMaxBins are left; the bins are a
+      // linked list and the gaps a heap, where the gaps of merged bins are
+      // recognized by the version of the bins
+      std::vector<Int_t> prev(m), next(m), version(m, 0);
+      std::priority_queue<TBinGap, std::vector<TBinGap>, std::greater<TBinGap> > gaps;
+      for (i = 0; i < m; i++) {
+         prev[i] = i - 1;
+         next[i] = (i + 1 < m) ? i + 1 : -1;
+         if (i + 1 < m) gaps.push(TBinGap(x[i+1] - x[i], i, i + 1, 0, 0));
+      }
+      Int_t nbins = m;
+      while (nbins > fMaxBins) {
+         TBinGap g = gaps.top();
+         gaps.pop();
+         i = g.fI;
+         j = g.fJ;
+         if (next[i] != j || version[i] != g.fVi || version[j] != g.fVj) continue;
+         Double_t ws = w[i] + w[j];
+         x[i] = (x[i] * w[i] + x[j] * w[j]) / ws;
+         w[i] = ws;
+         ++version[i];
+         version[j] = -1;
+         next[i] = next[j];
+         if (next[j] >= 0) prev[next[j]] = i;
+         --nbins;
+         if (prev[i] >= 0) gaps.push(TBinGap(x[i] - x[prev[i]], prev[i], i, version[prev[i]], version[i]));
+         if (next[i] >= 0) gaps.push(TBinGap(x[next[i]] - x[i], i, next[i], version[i], version[next[i]]));
+      }
+      fCenter.resize(nbins);
+      fWeight.resize(nbins);
+      for (i = 0, j = 0; i >= 0; i = next[i], ++j) {
+         fCenter[j] = x[i];
+         fWeight[j] = w[i];
+      }
+   } else {
+      fCenter.swap(x);
+      fWeight.swap(w);
+   }
+}
+
+//______________________________________________________________________________
+void TStatisticHistogram::Flush()
+{
+   // Add the buffered values to the bins; the content of the histogram does
+   // not change. The getters do not modify the object, so that they can be
+   // called concurrently: while values are buffered they work on a
+   // compressed copy. Call Flush after filling to avoid these copies.
+
+   Compress();
+}
+
+//______________________________________________________________________________
+const TStatisticHistogram *TStatisticHistogram::Compressed(TStatisticHistogram &copy) const
+{
+   // Return this histogram if no value is buffered, otherwise copy it to
+   // copy, add the buffered values to its bins and return it.
+
+   if (fBuffer.empty()) return this;
+   copy = *this;
+   copy.Compress();
+   return &copy;
+}
+
+//______________________________________________________________________________
+Int_t TStatisticHistogram::GetNbins() const
+{
+   // Return the current number of bins.
+
+   TStatisticHistogram copy;
+   return Compressed(copy)->fCenter.size();
+}
+
+//______________________________________________________________________________
+Double_t TStatisticHistogram::GetBinCenter(Int_t i) const
+{
+   // Return the center of bin i (0 <= i < GetNbins()), i.e. the mean of its
+   // values. The bins are in increasing order.
+
+   TStatisticHistogram copy;
+   const TStatisticHistogram *h = Compressed(copy);
+   if (i < 0 || i >= (Int_t)h->fCenter.size()) return 0.;
+   return h->fCenter[i];
+}
+
+//______________________________________________________________________________
+Double_t TStatisticHistogram::GetBinContent(Int_t i) const
+{
+   // Return the sum of the weights of bin i (0 <= i < GetNbins()).
+
+   TStatisticHistogram copy;
+   const TStatisticHistogram *h = Compressed(copy);
+   if (i < 0 || i >= (Int_t)h->fWeight.size()) return 0.;
+   return h->fWeight[i];
+}
+
+//______________________________________________________________________________
+Double_t TStatisticHistogram::GetMean() const
+{
+   // Return the weighted mean of the values.
+
+   if (!(fW > 0.)) return 0.;
+   Double_t sum = 0.;
+   for (UInt_t i = 0; i < fCenter.size(); i++) sum += fCenter[i] * fWeight[i];
+   for (UInt_t i = 0; i < fBuffer.size(); i++) sum += fBuffer[i] * fBufferW[i];
+   return sum / fW;
+}
+
+//______________________________________________________________________________
+void TStatisticHistogram::GetQuantiles(Int_t n, const Double_t *prob, Double_t *q) const
+{
+   // Compute the n quantiles q[i] of probability prob[i].
+
+   TStatisticHistogram copy;
+   const TStatisticHistogram *h = Compressed(copy);
+   const std::vector<Double_t> &center = h->fCenter;
+   const std::vector<Double_t> &weight = h->fWeight;
+   Int_t nb = center.size();
+   if (nb == 0) {
+      for (Int_t i = 0; i < n; i++) q[i] = 0.;
+      return;
+   }
+   // cumulative weight at the minimum, the bin centers and the maximum
+   std::vector<Double_t> px(nb + 2), pc(nb + 2);
+   px[0] = fMin;
+   pc[0] = 0.;
+   Double_t cum = 0.;
+   for (Int_t k = 0; k < nb; k++) {
+      px[k+1] = center[k];
+      pc[k+1] = cum + 0.5 * weight[k];
+      cum += weight[k];
+   }
+   px[nb+1] = fMax;
+   pc[nb+1] = cum;
+
+   for (Int_t i = 0; i < n; i++) {
+      Double_t target = TMath::Min(TMath::Max(prob[i], 0.), 1.) * cum;
+      Int_t k = std::lower_bound(pc.begin(), pc.end(), target) - pc.begin();
+      if (k > nb + 1) k = nb + 1;
+      if (k == 0 || pc[k] == pc[k-1]) q[i] = px[k];
+      else q[i] = px[k-1] + (px[k] - px[k-1]) * (target - pc[k-1]) / (pc[k] - pc[k-1]);
+   }
+}
+
+//______________________________________________________________________________
+Double_t TStatisticHistogram::GetQuantile(Double_t prob) const
+{
+   // Return the quantile of probability prob, e.g. the median for prob = 0.5.
+
+   Double_t q;
+   GetQuantiles(1, &prob, &q);
+   return q;
+}
+
+//______________________________________________________________________________
+Double_t TStatisticHistogram::GetSum(Double_t x) const
+{
+   // Return the estimated sum of the weights of the values below x.
+
+   TStatisticHistogram copy;
+   const TStatisticHistogram *h = Compressed(copy);
+   const std::vector<Double_t> &center = h->fCenter;
+   const std::vector<Double_t> &weight = h->fWeight;
+   Int_t nb = center.size();
+   if (nb == 0 || x < fMin) return 0.;
+   if (x >= fMax) return fW;
+   Double_t cum = 0.;
+   Double_t x0 = fMin, c0 = 0.;
+   for (Int_t k = 0; k <= nb; k++) {
+      Double_t x1 = (k < nb) ? center[k] : fMax;
+      Double_t c1 = (k < nb) ? cum + 0.5 * weight[k] : cum;
+      if (x < x1) {
+         if (x1 == x0) return c0;
+         return c0 + (c1 - c0) * (x - x0) / (x1 - x0);
+      }
+      if (k < nb) cum += weight[k];
+      x0 = x1;
+      c0 = c1;
+   }
+   return cum;
+}
+
+//______________________________________________________________________________
+void TStatisticHistogram::Add(const TStatisticHistogram &s)
+{
+   // Add the values filled in s. The bins of s are added as weighted values.
+
+   if (&s == this) {
+      TStatisticHistogram c(*this);
+      Add(c);
+      return;
+   }
+   if (s.fN == 0) return;
+   TStatisticHistogram copy;
+   const TStatisticHistogram *c = s.Compressed(copy);
+   if (fN == 0) {
+      fMin = s.fMin;
+      fMax = s.fMax;
+   } else {
+      if (s.fMin < fMin) fMin = s.fMin;
+      if (s.fMax > fMax) fMax = s.fMax;
+   }
+   fN += s.fN;
+   fW += s.fW;
+   fBuffer.insert(fBuffer.end(), c->fCenter.begin(), c->fCenter.end());
+   fBufferW.insert(fBufferW.end(), c->fWeight.begin(), c->fWeight.end());
+   Compress();
+}
+
+//______________________________________________________________________________
+Int_t TStatisticHistogram::Merge(TCollection *in)
+{
+   // Merge objects in the list.
+   // Returns the number of objects that were in the list.
+
+   TIter nxo(in);
+   Int_t n = 0;
+   while (TObject *o = nxo()) {
+      TStatisticHistogram *c = dynamic_cast<TStatisticHistogram *>(o);
+      if (c) {
+         Add(*c);
+         n++;
+      }
+   }
+   return n;
+}
+
+//______________________________________________________________________________
+void TStatisticHistogram::Reset()
+{
+   // Remove all the values, keeping the name and the maximum number of bins.
+
+   fN = 0;
+   fW = fMin = fMax = 0.;
+   fCenter.clear();
+   fWeight.clear();
+   fBuffer.clear();
+   fBufferW.clear();
+}
+
+//______________________________________________________________________________
+void TStatisticHistogram::Print(Option_t *) const
+{
+   // Print this parameter content
+
+   TROOT::IndentLevel();
+   Printf(" OBJ: TStatisticHistogram\t %s median = %.3g \t min = %.3g \t max = %.3g \t N = %lld \t bins = %d",
+          fName.Data(), GetQuantile(0.5), fMin, fMax, fN, GetNbins());
+}
@@ -0,0 +1,206 @@
+// @(#)root/mathcore:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2014  LCG ROOT Math Team, CERN/PH-SFT                *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Implementation file for class ThreadPool
+
+#include "Math/ThreadPool.h"
+
+#ifndef _WIN32
+#define MATH_THREADPOOL_PTHREAD
+#include <pthread.h>
+#include <unistd.h>
+#include <vector>
+#endif
+
+namespace ROOT {
+
+namespace Math {
+
+   namespace TPool {
+      static unsigned int gDefaultNThreads = 1;
+   }
+
+#ifdef MATH_THREADPOOL_PTHREAD
+
+namespace TPool {
+
+//_______________________________________________________________________________
+/**
+   The worker threads of ThreadPool. A job (task and number of tasks) is
+   posted by Run; the workers and the calling thread take the next task
+   number under the lock until none is left.
+*/
+class Workers {
+
+public:
+
+   Workers() :
+      fTask(0), fNTasks(0), fNextTask(0), fNPending(0), fNActive(0), fJob(0), fBusy(false)
+   {
+      pthread_mutex_init(&fMutex, 0);
+      pthread_cond_init(&fStart, 0);
+      pthread_cond_init(&fDone, 0);
+   }
+
+   // return false if another Run is in progress
+   bool Run(ThreadPool::ITask & task, unsigned int ntasks, unsigned int nthreads);
+
+private:
+
+   struct WorkerArg {
+      Workers *     fWorkers;
+      unsigned int  fIndex;
+   };
+
+   static void * WorkerMain(void * arg);
+
+   // execute tasks of the current job until none is left; called with the lock held
+   void ExecuteTasks();
+
+   pthread_mutex_t      fMutex;     // protects all data members
+   pthread_cond_t       fStart;     // signalled when a job is posted
+   pthread_cond_t       fDone;      // signalled when the last task of a job is done
+   std::vector<pthread_t> fThreads; // worker threads
+   ThreadPool::ITask *  fTask;      // task of the current job
+   unsigned int         fNTasks;    // number of tasks of the current job
+   unsigned int         fNextTask;  // next task to be executed
+   unsigned int         fNPending;  // number of tasks not yet finished
+   unsigned int         fNActive;   // number of workers taking part in the current job
+   unsigned long        fJob;       // job counter
+   bool                 fBusy;      // a Run is in progress
+};
+
+void Workers::ExecuteTasks()
+{
+   while (fNextTask < fNTasks) {
+      unsigned int itask = fNextTask++;
+      ThreadPool::ITask * task = fTask;
+      pthread_mutex_unlock(&fMutex);
+      task->Execute(itask);
+      pthread_mutex_lock(&fMutex);
+      if (--fNPending == 0) pthread_cond_signal(&fDone);
+   }
+}
+
+void * Workers::WorkerMain(void * arg)
+{
+   WorkerArg * warg = (WorkerArg *) arg;
+   Workers * w = warg->fWorkers;
+   unsigned int index = warg->fIndex;
+   delete warg;
+
+   unsigned long seen = 0;
+   pthread_mutex_lock(&w->fMutex);
+   for (;;) {
+      while (w->fJob == seen)
+         pthread_cond_wait(&w->fStart, &w->fMutex);
+      seen = w->fJob;
+      if (index < w->fNActive) w->ExecuteTasks();
+   }
+   return 0;
+}
+
+bool Workers::Run(ThreadPool::ITask & task, unsigned int ntasks, unsigned int nthreads)
+{
+   pthread_mutex_lock(&fMutex);
+   if (fBusy) {
+      pthread_mutex_unlock(&fMutex);
+      return false;
+   }
+   fBusy = true;
+
+   // the calling thread is one of the nthreads
+   unsigned int nworkers = nthreads - 1;
+   while (fThreads.size() < nworkers) {
+      WorkerArg * arg = new WorkerArg;
+      arg->fWorkers = this;
+      arg->fIndex = fThreads.size();
+      pthread_t thread;
+      pthread_attr_t attr;
+      pthread_attr_init(&attr);
+      pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+      int ret = pthread_create(&thread, &attr, WorkerMain, arg);
+      pthread_attr_destroy(&attr);
+      if (ret) {
+         delete arg;
+         break;
+      }
+      fThreads.push_back(thread);
+   }
+
+   fTask = &task;
+   fNTasks = ntasks;
+   fNextTask = 0;
+   fNPending = ntasks;
+   fNActive = nworkers;
+   ++fJob;
+   pthread_cond_broadcast(&fStart);
+
+   ExecuteTasks();
+   while (fNPending)
+      pthread_cond_wait(&fDone, &fMutex);
+
+   fTask = 0;
+   fNTasks = 0;
+   fNextTask = 0;
+   fBusy = false;
+   pthread_mutex_unlock(&fMutex);
+   return true;
+}
+
+static Workers & GetWorkers()
+{
+   // never deleted: the detached workers may still wait on its condition at exit
+   static Workers * workers = new Workers();
+   return *workers;
+}
+
+} // end namespace TPool
+
+#endif
+
+void ThreadPool::Run(ITask & task, unsigned int ntasks, unsigned int nthreads)
+{
+   // Execute the tasks 0 ... ntasks-1 of task, using up to nthreads threads
+   // including the calling one. nthreads = 0 means DefaultNThreads().
+   if (nthreads == 0) nthreads = DefaultNThreads();
+   if (nthreads > ntasks) nthreads = ntasks;
+
+#ifdef MATH_THREADPOOL_PTHREAD
+   if (nthreads > 1 && TPool::GetWorkers().Run(task, ntasks, nthreads)) return;
+#endif
+
+   for (unsigned int itask = 0; itask < ntasks; ++itask)
+      task.Execute(itask);
+}
+
+void ThreadPool::SetDefaultNThreads(unsigned int nthreads)
+{
+   // Set the default number of threads; 0 means NCores()
+   TPool::gDefaultNThreads = (nthreads == 0) ? NCores() : nthreads;
+}
+
+unsigned int ThreadPool::DefaultNThreads()
+{
+   return TPool::gDefaultNThreads;
+}
+
+unsigned int ThreadPool::NCores()
+{
+#ifdef MATH_THREADPOOL_PTHREAD
+   long n = sysconf(_SC_NPROCESSORS_ONLN);
+   return (n > 0) ? (unsigned int) n : 1;
+#else
+   return 1;
+#endif
+}
+
+} // end namespace Math
+
+} // end namespace ROOT
@@ -185,6 +185,7 @@ void UnBinData::Initialize(unsigned int maxpoints, unsigned int dim, bool isWeig
    }
    fDim = dim;
    fPointSize = pointSize;
+   fCoordData.clear(); 
    unsigned int n = fPointSize*maxpoints; 
    if ( n > MaxSize() ) { 
       MATH_ERROR_MSGVAL("UnBinData::Initialize","Invalid data size", n );
@@ -196,6 +197,23 @@ void UnBinData::Initialize(unsigned int maxpoints, unsigned int dim, bool isWeig
       fDataVector = new DataVector( n);
 }
 
+const double * UnBinData::CoordData(unsigned int icoord) const { 
+   // return the coordinates icoord of all the points as a contiguous array
+   assert(icoord < fDim); 
+   if (fDataWrapper) return fDataWrapper->CoordData(icoord); 
+   if (fNPoints == 0) return 0; 
+   // points can only be appended, and the cache is cleared when they are removed: 
+   // it is then valid as long as its size corresponds to the number of points  
+   if (fCoordData.size() != fDim * fNPoints) { 
+      fCoordData.resize(fDim * fNPoints); 
+      const double * v = &((fDataVector->Data()).front()); 
+      for (unsigned int i = 0; i < fNPoints; ++i) 
+         for (unsigned int j = 0; j < fDim; ++j) 
+            fCoordData[j * fNPoints + i] = v[i * fPointSize + j]; 
+   }
+   return &fCoordData[icoord * fNPoints]; 
+}
+
 void UnBinData::Resize(unsigned int npoints) { 
    // resize vector to new points 
    if (fDim == 0) return; 
@@ -208,6 +226,7 @@ void UnBinData::Resize(unsigned int npoints) {
       if  (nextraPoints < 0) {
          // delete extra points
          (fDataVector->Data()).resize( npoints * fPointSize);
+         fCoordData.clear(); 
       }
       else if (nextraPoints > 0) { 
          // add extra points 
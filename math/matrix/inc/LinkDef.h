@@ -165,6 +165,7 @@
 #pragma link C++ class TDecompQRH+;
 #pragma link C++ class TDecompSVD+;
 #pragma link C++ class TDecompSparse+;
+#pragma link C++ class TDecompSparseIter+;
 
 //TVectorT<float>
 #pragma link C++ function operator==          (const TVectorF       &,const TVectorF &);
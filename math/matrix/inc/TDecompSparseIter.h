@@ -0,0 +1,95 @@
+// @(#)root/matrix:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TDecompSparseIter
+#define ROOT_TDecompSparseIter
+
+///////////////////////////////////////////////////////////////////////////
+//                                                                       //
+// Iterative solver for sparse linear systems                            //
+//                                                                       //
+///////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_TDecompBase
+#include "TDecompBase.h"
+#endif
+#ifndef ROOT_TMatrixDSparse
+#include "TMatrixDSparse.h"
+#endif
+
+class TDecompSparseIter : public TDecompBase
+{
+public :
+
+   enum EMethod         { kConjugateGradient, kBiCGStab };
+   enum EPreconditioner { kNoPreconditioner, kJacobi };
+
+protected :
+
+   Int_t          fMethod;         // iterative method (EMethod)
+   Int_t          fPreconditioner; // preconditioner (EPreconditioner)
+   Int_t          fMaxIter;        // maximum number of iterations
+   Double_t       fPrecision;      // demanded relative residual |b-Ax|/|b|
+   Int_t          fNIter;          // number of iterations of the last solve
+   Double_t       fResidual;       // relative residual of the last solve
+
+   TMatrixDSparse fA;              // matrix of the linear system
+   TVectorD       fInvDiag;        // inverse of the diagonal of fA (Jacobi preconditioner)
+
+   Bool_t         SolveCG      (const TMatrixDSparse &a,TVectorD &b);
+   Bool_t         SolveBiCGStab(const TMatrixDSparse &a,TVectorD &b);
+   Bool_t         DoSolve      (const TMatrixDSparse &a,TVectorD &b,const char *where);
+   void           Precondition (const TVectorD &r,TVectorD &z) const;
+
+   virtual const TMatrixDBase &GetDecompMatrix() const { return fA; }
+
+public :
+
+   TDecompSparseIter();
+   TDecompSparseIter(const TMatrixDSparse &a,Int_t method=kConjugateGradient);
+   TDecompSparseIter(const TDecompSparseIter &another);
+   virtual ~TDecompSparseIter() {}
+
+   virtual Int_t    GetNrows        () const { return fA.GetNrows(); }
+   virtual Int_t    GetNcols        () const { return fA.GetNcols(); }
+
+   virtual void     SetMatrix       (const TMatrixDSparse &a);
+
+           Int_t    GetMethod       () const { return fMethod; }
+           Int_t    GetPreconditioner() const { return fPreconditioner; }
+           Int_t    GetMaxIter      () const { return fMaxIter; }
+           Double_t GetPrecision    () const { return fPrecision; }
+           Int_t    GetNIter        () const { return fNIter; }
+           Double_t GetResidual     () const { return fResidual; }
+
+           void     SetMethod       (Int_t method) { fMethod = method; }
+           void     SetPreconditioner(Int_t precond) { fPreconditioner = precond; }
+           void     SetMaxIter      (Int_t maxIter) { fMaxIter = maxIter; }
+           void     SetPrecision    (Double_t precision) { fPrecision = precision; }
+
+   virtual Bool_t   Decompose       ();
+   virtual Bool_t   Solve           (      TVectorD &b);
+   virtual TVectorD Solve           (const TVectorD& b,Bool_t &ok) { TVectorD x = b; ok = Solve(x); return x; }
+   virtual Bool_t   Solve           (      TMatrixDColumn &b);
+   virtual Bool_t   TransSolve      (      TVectorD &b);
+   virtual TVectorD TransSolve      (const TVectorD& b,Bool_t &ok) { TVectorD x = b; ok = TransSolve(x); return x; }
+   virtual Bool_t   TransSolve      (      TMatrixDColumn &b);
+
+   virtual void     Det             (Double_t &/*d1*/,Double_t &/*d2*/)
+                                     { MayNotUse("Det(Double_t&,Double_t&)"); }
+
+   void Print(Option_t *opt ="") const; // *MENU*
+
+   TDecompSparseIter &operator= (const TDecompSparseIter &source);
+
+   ClassDef(TDecompSparseIter,1) // Iterative solver of sparse linear systems
+};
+
+#endif
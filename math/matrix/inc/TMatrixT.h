@@ -27,11 +27,6 @@
 #include "TMatrixTUtils.h"
 #endif
 
-#ifdef CBLAS
-#include <vecLib/vBLAS.h>
-//#include <cblas.h>
-#endif
-
 template<class Element> class TMatrixTSym;
 template<class Element> class TMatrixTSparse;
 template<class Element> class TMatrixTLazy;
@@ -94,6 +89,7 @@ public:
    void Mult (const TMatrixT   <Element> &a,const TMatrixTSym<Element> &b);
    void Mult (const TMatrixTSym<Element> &a,const TMatrixT   <Element> &b);
    void Mult (const TMatrixTSym<Element> &a,const TMatrixTSym<Element> &b);
+   void Mult (const TMatrixTSparse<Element> &a,const TMatrixT<Element> &b);
 
    void TMult(const TMatrixT   <Element> &a,const TMatrixT   <Element> &b);
    void TMult(const TMatrixT   <Element> &a,const TMatrixTSym<Element> &b);
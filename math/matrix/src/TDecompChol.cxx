@@ -26,9 +26,53 @@
 
 #include "TDecompChol.h"
 #include "TMath.h"
+#include "Math/ThreadPool.h"
+
+#include <vector>
 
 ClassImp(TDecompChol)
 
+namespace {
+
+   // number of columns of a row of U computed by a task of Decompose
+   const Int_t    kCholColChunk    = 256;
+   // number of multiply-adds of a row of U below which a single thread is used
+   const Double_t kCholParallelMin = 65536.;
+
+   //______________________________________________________________________________
+   // Compute a chunk of columns of the row icol of U in TDecompChol::Decompose,
+   // and subtract their squares from the remaining diagonal elements
+   class TDecompCholRowTask : public ROOT::Math::ThreadPool::ITask {
+   public:
+      TDecompCholRowTask(Double_t *pU,Double_t *diag,Int_t n,Int_t icol)
+         : fU(pU), fDiag(diag), fN(n), fIcol(icol) {}
+      void Execute(unsigned int itask) {
+         const Int_t first = fIcol+1+itask*kCholColChunk;
+         const Int_t last  = TMath::Min(first+kCholColChunk,fN);
+         Double_t *rowp = fU+fIcol*fN;
+         // the rows above are subtracted one after the other, which accesses the
+         // memory contiguously and keeps the order of the sums of every element
+         for (Int_t i = 0; i < fIcol; i++) {
+            const Double_t *rowip = fU+i*fN;
+            const Double_t  uic   = rowip[fIcol];
+            for (Int_t j = first; j < last; j++)
+               rowp[j] -= rowip[j]*uic;
+         }
+         const Double_t ujj = rowp[fIcol];
+         for (Int_t j = first; j < last; j++) {
+            rowp[j] /= ujj;
+            fDiag[j] -= rowp[j]*rowp[j];
+         }
+      }
+   private:
+      Double_t *fU;
+      Double_t *fDiag;
+      Int_t     fN;
+      Int_t     fIcol;
+   };
+
+}
+
 //______________________________________________________________________________
 TDecompChol::TDecompChol(Int_t nrows)
 {
@@ -112,18 +156,23 @@ Bool_t TDecompChol::Decompose()
       return kFALSE;
    }
 
-   Int_t i,j,icol,irow;
+   Int_t icol,irow;
    const Int_t     n  = fU.GetNrows();
          Double_t *pU = fU.GetMatrixArray();
+
+   // diagonal elements minus the squares of the elements of U above them,
+   // updated when each row of U is computed
+   std::vector<Double_t> diag(n);
+   for (icol = 0; icol < n; icol++)
+      diag[icol] = pU[icol*n+icol];
+
+   // The rows of U are computed by chunks of columns, in parallel for large
+   // matrices when ROOT::Math::ThreadPool::SetDefaultNThreads has been called
    for (icol = 0; icol < n; icol++) {
       const Int_t rowOff = icol*n;
 
       //Compute fU(j,j) and test for non-positive-definiteness.
-      Double_t ujj = pU[rowOff+icol];
-      for (irow = 0; irow < icol; irow++) {
-         const Int_t pos_ij = irow*n+icol;
-         ujj -= pU[pos_ij]*pU[pos_ij];
-      }
+      Double_t ujj = diag[icol];
       if (ujj <= 0) {
          Error("Decompose()","matrix not positive definite");
          return kFALSE;
@@ -132,14 +181,10 @@ Bool_t TDecompChol::Decompose()
       pU[rowOff+icol] = ujj;
 
       if (icol < n-1) {
-         for (j = icol+1; j < n; j++) {
-            for (i = 0; i < icol; i++) {
-               const Int_t rowOff2 = i*n;
-               pU[rowOff+j] -= pU[rowOff2+j]*pU[rowOff2+icol];
-            }
-         }
-         for (j = icol+1; j < n; j++)
-            pU[rowOff+j] /= ujj;
+         TDecompCholRowTask task(pU,&diag[0],n,icol);
+         const unsigned int ntasks = (n-icol-1+kCholColChunk-1)/kCholColChunk;
+         const Double_t nmult = Double_t(icol)*(n-icol-1);
+         ROOT::Math::ThreadPool::Run(task,ntasks,(nmult < kCholParallelMin) ? 1 : 0);
       }
    }
 
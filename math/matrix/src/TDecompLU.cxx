@@ -11,9 +11,46 @@
 
 #include "TDecompLU.h"
 #include "TMath.h"
+#include "Math/ThreadPool.h"
+
+#include <vector>
 
 ClassImp(TDecompLU)
 
+namespace {
+
+   // number of rows computed by a task of DecomposeLUCrout
+   const Int_t    kLURowChunk    = 64;
+   // number of multiply-adds of a column below which a single thread is used
+   const Double_t kLUParallelMin = 65536.;
+
+   //______________________________________________________________________________
+   // Compute a chunk of the elements on and below the diagonal of the column j
+   // in TDecompLU::DecomposeLUCrout. The column is stored contiguously in col.
+   class TDecompLUColTask : public ROOT::Math::ThreadPool::ITask {
+   public:
+      TDecompLUColTask(const Double_t *pLU,Int_t n,Int_t j,Double_t *col)
+         : fLU(pLU), fN(n), fJ(j), fCol(col) {}
+      void Execute(unsigned int itask) {
+         const Int_t first = fJ+itask*kLURowChunk;
+         const Int_t last  = TMath::Min(first+kLURowChunk,fN);
+         for (Int_t i = first; i < last; i++) {
+            const Double_t *rowp = fLU+i*fN;
+            Double_t r = fCol[i];
+            for (Int_t k = 0; k < fJ; k++)
+               r -= rowp[k]*fCol[k];
+            fCol[i] = r;
+         }
+      }
+   private:
+      const Double_t *fLU;
+      Int_t           fN;
+      Int_t           fJ;
+      Double_t       *fCol;
+   };
+
+}
+
 ///////////////////////////////////////////////////////////////////////////
 //                                                                       //
 // LU Decomposition class                                                //
@@ -622,17 +659,24 @@ Bool_t TDecompLU::DecomposeLUCrout(TMatrixD &lu,Int_t *index,Double_t &sign,
       scale[i] = (max == 0.0 ? 0.0 : 1.0/max);
    }
 
+   // The jth column is copied in col, so that the sums over k below run over
+   // contiguous memory, and copied back once computed. The elements on and
+   // below the diagonal are computed in parallel for large matrices when
+   // ROOT::Math::ThreadPool::SetDefaultNThreads has been called.
+   std::vector<Double_t> col(n);
+
    for (Int_t j = 0; j < n; j++) {
       const Int_t off_j = j*n;
+      for (Int_t i = 0; i < n; i++)
+         col[i] = pLU[i*n+j];
+
       // Run down jth column from top to diag, to form the elements of U.
       for (Int_t i = 0; i < j; i++) {
          const Int_t off_i = i*n;
-         Double_t r = pLU[off_i+j];
-         for (Int_t k = 0; k < i; k++) {
-            const Int_t off_k = k*n;
-            r -= pLU[off_i+k]*pLU[off_k+j];
-         }
-         pLU[off_i+j] = r;
+         Double_t r = col[i];
+         for (Int_t k = 0; k < i; k++)
+            r -= pLU[off_i+k]*col[k];
+         col[i] = r;
       }
 
       // Run down jth subdiag to form the residuals after the elimination of
@@ -640,17 +684,17 @@ Bool_t TDecompLU::DecomposeLUCrout(TMatrixD &lu,Int_t *index,Double_t &sign,
       // diagonal term will become the multipliers in the elimination of the jth.
       // subdiag. Find fIndex of largest scaled term in imax.
 
+      TDecompLUColTask task(pLU,n,j,&col[0]);
+      const unsigned int ntasks = (n-j+kLURowChunk-1)/kLURowChunk;
+      const Double_t nmult = Double_t(n-j)*j;
+      ROOT::Math::ThreadPool::Run(task,ntasks,(nmult < kLUParallelMin) ? 1 : 0);
+
       Double_t max = 0.0;
       Int_t imax = 0;
+      for (Int_t i = 0; i < n; i++)
+         pLU[i*n+j] = col[i];
       for (Int_t i = j; i < n; i++) {
-         const Int_t off_i = i*n;
-         Double_t r = pLU[off_i+j];
-         for (Int_t k = 0; k < j; k++) {
-            const Int_t off_k = k*n;
-            r -= pLU[off_i+k]*pLU[off_k+j];
-         }
-         pLU[off_i+j] = r;
-         const Double_t tmp = scale[i]*TMath::Abs(r);
+         const Double_t tmp = scale[i]*TMath::Abs(col[i]);
          if (tmp >= max) {
             max = tmp;
             imax = i;
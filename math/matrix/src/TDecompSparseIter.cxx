@@ -0,0 +1,370 @@
+// @(#)root/matrix:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "TDecompSparseIter.h"
+#include "TMath.h"
+
+ClassImp(TDecompSparseIter)
+
+///////////////////////////////////////////////////////////////////////////
+//                                                                       //
+// Iterative solver of sparse linear systems                             //
+//                                                                       //
+// Solve A x = b for a large sparse square matrix A without factorizing  //
+// it, with one of the Krylov methods:                                   //
+//   kConjugateGradient : A symmetric positive definite (default)        //
+//   kBiCGStab          : A general (bi-conjugate gradient stabilized)   //
+// The iterations start from x = 0 and stop when the relative residual   //
+// |b-Ax|/|b| is below the precision (SetPrecision, default 1e-10) or    //
+// after SetMaxIter iterations (default: the number of rows of A).       //
+// The convergence is accelerated by the Jacobi (diagonal)               //
+// preconditioner, used by default. GetNIter and GetResidual return the  //
+// number of iterations and the relative residual of the last solve.     //
+//                                                                       //
+// Only the matrix is stored, by reference as in TDecompSparse, so the   //
+// memory used grows with the number of non-zero elements; "Decompose"   //
+// only prepares the preconditioner. The sparse matrix - vector products //
+// run in parallel with ROOT::Math::ThreadPool for large matrices.       //
+//                                                                       //
+// Example:                                                              //
+//   TDecompSparseIter cg(a);                                            //
+//   Bool_t ok = cg.Solve(b);  // the solution is returned in b          //
+//                                                                       //
+///////////////////////////////////////////////////////////////////////////
+
+//______________________________________________________________________________
+TDecompSparseIter::TDecompSparseIter()
+{
+// Default constructor
+
+   fMethod         = kConjugateGradient;
+   fPreconditioner = kJacobi;
+   fMaxIter        = 0;
+   fPrecision      = 1.0e-10;
+   fNIter          = 0;
+   fResidual       = 0.0;
+}
+
+//______________________________________________________________________________
+TDecompSparseIter::TDecompSparseIter(const TMatrixDSparse &a,Int_t method)
+{
+// Constructor for matrix A, solved with the iterative method "method"
+
+   fMethod         = method;
+   fPreconditioner = kJacobi;
+   fMaxIter        = 0;
+   fPrecision      = 1.0e-10;
+   fNIter          = 0;
+   fResidual       = 0.0;
+
+   SetMatrix(a);
+}
+
+//______________________________________________________________________________
+TDecompSparseIter::TDecompSparseIter(const TDecompSparseIter &another) : TDecompBase(another)
+{
+// Copy constructor
+
+   *this = another;
+}
+
+//______________________________________________________________________________
+void TDecompSparseIter::SetMatrix(const TMatrixDSparse &a)
+{
+// Set the matrix of the linear system. The matrix is not copied.
+
+   ResetStatus();
+
+   if (a.GetNrows() != a.GetNcols() || a.GetRowLwb() != a.GetColLwb()) {
+      Error("SetMatrix(const TMatrixDSparse &","matrix should be square");
+      return;
+   }
+
+   fA.Use(*const_cast<TMatrixDSparse *>(&a));
+   fRowLwb = fA.GetRowLwb();
+   fColLwb = fA.GetColLwb();
+
+   SetBit(kMatrixSet);
+}
+
+//______________________________________________________________________________
+Bool_t TDecompSparseIter::Decompose()
+{
+// Prepare the preconditioner: compute the inverse of the diagonal of A.
+// Zero diagonal elements are not scaled.
+// If it succeeds, bit kDecomposed is set .
+
+   if (TestBit(kDecomposed)) return kTRUE;
+
+   if ( !TestBit(kMatrixSet) ) {
+      Error("Decompose()","Matrix has not been set");
+      return kFALSE;
+   }
+
+   const Int_t n = fA.GetNrows();
+   const Int_t    * const pRowIndex = fA.GetRowIndexArray();
+   const Int_t    * const pColIndex = fA.GetColIndexArray();
+   const Double_t * const pData     = fA.GetMatrixArray();
+
+   fInvDiag.ResizeTo(fRowLwb,fRowLwb+n-1);
+   Double_t *pD = fInvDiag.GetMatrixArray();
+   for (Int_t irow = 0; irow < n; irow++) {
+      pD[irow] = 1.0;
+      for (Int_t index = pRowIndex[irow]; index < pRowIndex[irow+1]; index++) {
+         if (pColIndex[index] == irow) {
+            if (pData[index] != 0.0) pD[irow] = 1.0/pData[index];
+            break;
+         }
+      }
+   }
+
+   SetBit(kDecomposed);
+   return kTRUE;
+}
+
+//______________________________________________________________________________
+void TDecompSparseIter::Precondition(const TVectorD &r,TVectorD &z) const
+{
+// Apply the preconditioner: z = M^-1 r
+
+   z = r;
+   if (fPreconditioner == kJacobi)
+      ElementMult(z,fInvDiag);
+}
+
+//______________________________________________________________________________
+Bool_t TDecompSparseIter::SolveCG(const TMatrixDSparse &a,TVectorD &b)
+{
+// Preconditioned conjugate gradient for a symmetric positive definite matrix.
+// Solution returned in b.
+
+   const Int_t n = a.GetNrows();
+   const Int_t maxIter = (fMaxIter > 0) ? fMaxIter : n;
+   const Double_t bnorm = TMath::Sqrt(b.Norm2Sqr());
+
+   TVectorD r = b;
+   TVectorD z(fRowLwb,fRowLwb+n-1);
+   TVectorD q(fRowLwb,fRowLwb+n-1);
+   b.Zero();
+   if (bnorm == 0.0) return kTRUE;
+
+   Precondition(r,z);
+   TVectorD p = z;
+   Double_t rz = Dot(r,z);
+
+   for (fNIter = 1; fNIter <= maxIter; fNIter++) {
+      Add(q,0.0,a,p);
+      const Double_t pq = Dot(p,q);
+      if (pq <= 0.0) {
+         Error("Solve()","matrix is not positive definite, p.Ap = %.4e",pq);
+         return kFALSE;
+      }
+      const Double_t alpha = rz/pq;
+      Add(b,alpha,p);
+      Add(r,-alpha,q);
+      fResidual = TMath::Sqrt(r.Norm2Sqr())/bnorm;
+      if (fResidual <= fPrecision) return kTRUE;
+
+      Precondition(r,z);
+      const Double_t rzNew = Dot(r,z);
+      const Double_t beta  = rzNew/rz;
+      rz = rzNew;
+      // p = z + beta p
+      p *= beta;
+      p += z;
+   }
+
+   fNIter = maxIter;
+   return kFALSE;
+}
+
+//______________________________________________________________________________
+Bool_t TDecompSparseIter::SolveBiCGStab(const TMatrixDSparse &a,TVectorD &b)
+{
+// Preconditioned bi-conjugate gradient stabilized method (van der Vorst) for a
+// general matrix. Solution returned in b.
+
+   const Int_t n = a.GetNrows();
+   const Int_t maxIter = (fMaxIter > 0) ? fMaxIter : n;
+   const Double_t bnorm = TMath::Sqrt(b.Norm2Sqr());
+
+   TVectorD r = b;
+   TVectorD r0 = b;
+   TVectorD p(fRowLwb,fRowLwb+n-1);
+   TVectorD v(fRowLwb,fRowLwb+n-1);
+   TVectorD y(fRowLwb,fRowLwb+n-1);
+   TVectorD z(fRowLwb,fRowLwb+n-1);
+   TVectorD t(fRowLwb,fRowLwb+n-1);
+   b.Zero();
+   if (bnorm == 0.0) return kTRUE;
+
+   Double_t rho   = 1.0;
+   Double_t alpha = 1.0;
+   Double_t omega = 1.0;
+
+   for (fNIter = 1; fNIter <= maxIter; fNIter++) {
+      const Double_t rhoNew = Dot(r0,r);
+      if (rhoNew == 0.0) {
+         Error("Solve()","breakdown of BiCGStab, r0.r = 0");
+         return kFALSE;
+      }
+      // p = r + beta (p - omega v)
+      const Double_t beta = (rhoNew/rho)*(alpha/omega);
+      rho = rhoNew;
+      Add(p,-omega,v);
+      p *= beta;
+      p += r;
+
+      Precondition(p,y);
+      Add(v,0.0,a,y);
+      const Double_t r0v = Dot(r0,v);
+      if (r0v == 0.0) {
+         Error("Solve()","breakdown of BiCGStab, r0.Av = 0");
+         return kFALSE;
+      }
+      alpha = rho/r0v;
+      // s = r - alpha v, stored in r
+      Add(r,-alpha,v);
+      Add(b,alpha,y);
+      fResidual = TMath::Sqrt(r.Norm2Sqr())/bnorm;
+      if (fResidual <= fPrecision) return kTRUE;
+
+      Precondition(r,z);
+      Add(t,0.0,a,z);
+      const Double_t tt = t.Norm2Sqr();
+      omega = (tt > 0.0) ? Dot(t,r)/tt : 0.0;
+      if (omega == 0.0) {
+         Error("Solve()","breakdown of BiCGStab, omega = 0");
+         return kFALSE;
+      }
+      Add(b,omega,z);
+      Add(r,-omega,t);
+      fResidual = TMath::Sqrt(r.Norm2Sqr())/bnorm;
+      if (fResidual <= fPrecision) return kTRUE;
+   }
+
+   fNIter = maxIter;
+   return kFALSE;
+}
+
+//______________________________________________________________________________
+Bool_t TDecompSparseIter::DoSolve(const TMatrixDSparse &a,TVectorD &b,const char *where)
+{
+// Solve a x = b with the chosen method. Solution returned in b.
+
+   R__ASSERT(b.IsValid());
+   if ( !TestBit(kDecomposed) ) {
+      if (!Decompose()) {
+         Error(where,"Decomposition failed");
+         return kFALSE;
+      }
+   }
+
+   if (a.GetNrows() != b.GetNrows() || a.GetRowLwb() != b.GetLwb())
+   {
+      Error(where,"vector and matrix incompatible");
+      return kFALSE;
+   }
+
+   fNIter    = 0;
+   fResidual = 0.0;
+
+   Bool_t ok;
+   if (fMethod == kBiCGStab)
+      ok = SolveBiCGStab(a,b);
+   else
+      ok = SolveCG(a,b);
+
+   if (!ok && fNIter >= ((fMaxIter > 0) ? fMaxIter : a.GetNrows()))
+      Warning(where,"no convergence after %d iterations, relative residual = %.4e",fNIter,fResidual);
+   return ok;
+}
+
+//______________________________________________________________________________
+Bool_t TDecompSparseIter::Solve(TVectorD &b)
+{
+// Solve Ax=b . Solution returned in b.
+
+   return DoSolve(fA,b,"Solve(TVectorD &)");
+}
+
+//______________________________________________________________________________
+Bool_t TDecompSparseIter::Solve(TMatrixDColumn &cb)
+{
+// Solve Ax=b . Solution returned in the matrix column b.
+
+   const TMatrixDBase *b = cb.GetMatrix();
+   TVectorD x(b->GetRowLwb(),b->GetRowUpb());
+   x = cb;
+   const Bool_t ok = DoSolve(fA,x,"Solve(TMatrixDColumn &)");
+   if (ok) cb = x;
+   return ok;
+}
+
+//______________________________________________________________________________
+Bool_t TDecompSparseIter::TransSolve(TVectorD &b)
+{
+// Solve A^T x=b . Solution returned in b. With the conjugate gradient method A
+// is symmetric, otherwise the transposed matrix is created.
+
+   if (fMethod == kConjugateGradient)
+      return DoSolve(fA,b,"TransSolve(TVectorD &)");
+   const TMatrixDSparse at(TMatrixDSparse::kTransposed,fA);
+   return DoSolve(at,b,"TransSolve(TVectorD &)");
+}
+
+//______________________________________________________________________________
+Bool_t TDecompSparseIter::TransSolve(TMatrixDColumn &cb)
+{
+// Solve A^T x=b . Solution returned in the matrix column b.
+
+   const TMatrixDBase *b = cb.GetMatrix();
+   TVectorD x(b->GetRowLwb(),b->GetRowUpb());
+   x = cb;
+   const Bool_t ok = TransSolve(x);
+   if (ok) cb = x;
+   return ok;
+}
+
+//______________________________________________________________________________
+void TDecompSparseIter::Print(Option_t *opt) const
+{
+// Print class members
+
+   TDecompBase::Print(opt);
+
+   printf("fMethod         = %d\n",fMethod);
+   printf("fPreconditioner = %d\n",fPreconditioner);
+   printf("fMaxIter        = %d\n",fMaxIter);
+   printf("fPrecision      = %.4e\n",fPrecision);
+   printf("fNIter          = %d\n",fNIter);
+   printf("fResidual       = %.4e\n",fResidual);
+}
+
+//______________________________________________________________________________
+TDecompSparseIter &TDecompSparseIter::operator=(const TDecompSparseIter &source)
+{
+// Assignment operator
+
+   if (this != &source) {
+      TDecompBase::operator=(source);
+      fMethod         = source.fMethod;
+      fPreconditioner = source.fPreconditioner;
+      fMaxIter        = source.fMaxIter;
+      fPrecision      = source.fPrecision;
+      fNIter          = source.fNIter;
+      fResidual       = source.fResidual;
+      if (source.fA.IsValid())
+         fA.Use(*const_cast<TMatrixDSparse *>(&(source.fA)));
+      fInvDiag.ResizeTo(source.fInvDiag);
+      fInvDiag        = source.fInvDiag;
+   }
+   return *this;
+}
@@ -25,9 +25,133 @@
 
 #include "TMatrixDSymEigen.h"
 #include "TMath.h"
+#include "Math/ThreadPool.h"
+
+#include <vector>
 
 ClassImp(TMatrixDSymEigen)
 
+namespace {
+
+   // number of rows or columns processed by a task
+   const Int_t    kEigenChunk       = 64;
+   // number of rows to which the rotations of a QL sweep are applied together
+   const Int_t    kEigenRotRows     = 16;
+   // number of multiply-adds below which a single thread is used
+   const Double_t kEigenParallelMin = 65536.;
+
+   // steps of MakeTridiagonal and MakeEigenVectors performed by TMatrixDSymEigenTask
+   enum EEigenStep {
+      kSymMult,     // g = A * d, with A the leading (i x i) part of V (columns of g)
+      kSymUpdate,   // A -= d * e^T + e * d^T (rows of A)
+      kColDot,      // g = V^T * u, u the column i+1 of V (columns of g)
+      kColUpdate,   // V -= d * g^T (rows of V)
+      kRotate       // apply the rotations of a QL sweep to V (rows of V)
+   };
+
+   //______________________________________________________________________________
+   // Perform a chunk of kEigenChunk rows or columns of a step of the
+   // tridiagonalization or of the QL algorithm. The steps access the matrix
+   // row by row; every element is computed with the operations of the original
+   // EISPACK ordering, so the result does not depend on the number of threads.
+   class TMatrixDSymEigenTask : public ROOT::Math::ThreadPool::ITask {
+   public:
+      TMatrixDSymEigenTask(EEigenStep step,Double_t *pV,Int_t n,Int_t size,
+                           const Double_t *pD,const Double_t *pE,Double_t *work)
+         : fStep(step), fV(pV), fN(n), fSize(size), fD(pD), fE(pE), fWork(work),
+           fCos(0), fSin(0), fFirst(0), fLast(0) {}
+      void SetRotations(const Double_t *c,const Double_t *s,Int_t first,Int_t last) {
+         fCos = c; fSin = s; fFirst = first; fLast = last;
+      }
+      unsigned int NTasks() const { return (fSize+kEigenChunk-1)/kEigenChunk; }
+      void Execute(unsigned int itask) {
+         const Int_t first = itask*kEigenChunk;
+         const Int_t last  = TMath::Min(first+kEigenChunk,fSize);
+         Int_t j,k;
+         switch (fStep) {
+         case kSymMult:
+            // fWork[j] = sum_k A(k,j) * d[k], using the lower triangle of A
+            for (k = first; k < fSize; k++) {
+               const Double_t *vk = fV+k*fN;
+               const Double_t  dk = fD[k];
+               if (k < last) {
+                  Double_t e = 0.0;
+                  for (j = 0; j < k; j++)
+                     e += vk[j]*fD[j];
+                  fWork[k] = e+vk[k]*dk;
+               }
+               const Int_t jlast = TMath::Min(last,k);
+               for (j = first; j < jlast; j++)
+                  fWork[j] += vk[j]*dk;
+            }
+            break;
+         case kSymUpdate:
+            for (k = first; k < last; k++) {
+               Double_t *vk = fV+k*fN;
+               for (j = 0; j <= k; j++)
+                  vk[j] -= (fD[j]*fE[k]+fE[j]*fD[k]);
+            }
+            break;
+         case kColDot:
+            // fWork[j] = sum_k V(k,size) * V(k,j)
+            for (j = first; j < last; j++)
+               fWork[j] = 0.0;
+            for (k = 0; k < fSize; k++) {
+               const Double_t *vk = fV+k*fN;
+               const Double_t  u  = vk[fSize];
+               for (j = first; j < last; j++)
+                  fWork[j] += u*vk[j];
+            }
+            break;
+         case kColUpdate:
+            for (k = first; k < last; k++) {
+               Double_t *vk = fV+k*fN;
+               const Double_t dk = fD[k];
+               for (j = 0; j < fSize; j++)
+                  vk[j] -= fWork[j]*dk;
+            }
+            break;
+         case kRotate:
+            // by groups of kEigenRotRows rows, for independent operations
+            for (Int_t k0 = first; k0 < last; k0 += kEigenRotRows) {
+               const Int_t k1 = TMath::Min(k0+kEigenRotRows,last);
+               for (Int_t i = fLast; i >= fFirst; i--) {
+                  const Double_t c = fCos[i];
+                  const Double_t s = fSin[i];
+                  for (k = k0; k < k1; k++) {
+                     Double_t *vk = fV+k*fN;
+                     const Double_t h = vk[i+1];
+                     vk[i+1] = s*vk[i]+c*h;
+                     vk[i]   = c*vk[i]-s*h;
+                  }
+               }
+            }
+            break;
+         }
+      }
+   private:
+      EEigenStep      fStep;
+      Double_t       *fV;
+      Int_t           fN;
+      Int_t           fSize;   // number of rows or columns of the step
+      const Double_t *fD;
+      const Double_t *fE;
+      Double_t       *fWork;
+      const Double_t *fCos;    // rotations of a QL sweep, applied from fLast down to fFirst
+      const Double_t *fSin;
+      Int_t           fFirst;
+      Int_t           fLast;
+   };
+
+   //______________________________________________________________________________
+   // Run a step, in parallel if the number of multiply-adds nmult is large
+   void RunEigenStep(TMatrixDSymEigenTask &task,Double_t nmult)
+   {
+      ROOT::Math::ThreadPool::Run(task,task.NTasks(),(nmult < kEigenParallelMin) ? 1 : 0);
+   }
+
+}
+
 //______________________________________________________________________________
 TMatrixDSymEigen::TMatrixDSymEigen(const TMatrixDSym &a)
 {
@@ -69,12 +193,15 @@ void TMatrixDSymEigen::MakeTridiagonal(TMatrixD &v,TVectorD &d,TVectorD &e)
 // This is derived from the Algol procedures tred2 by Bowdler, Martin, Reinsch, and
 // Wilkinson, Handbook for Auto. Comp., Vol.ii-Linear Algebra, and the corresponding
 // Fortran subroutine in EISPACK.
+// The O(n^3) loops access the matrix by rows and are executed in parallel for large
+// matrices when ROOT::Math::ThreadPool::SetDefaultNThreads has been called.
 
    Double_t *pV = v.GetMatrixArray();
    Double_t *pD = d.GetMatrixArray();
    Double_t *pE = e.GetMatrixArray();
 
    const Int_t n = v.GetNrows();
+   std::vector<Double_t> work(n+1);
 
    Int_t i,j,k;
    Int_t off_n1 = (n-1)*n;
@@ -121,17 +248,11 @@ void TMatrixDSymEigen::MakeTridiagonal(TMatrixD &v,TVectorD &d,TVectorD &e)
 
          // Apply similarity transformation to remaining columns.
 
+         TMatrixDSymEigenTask mult(kSymMult,pV,n,i,pD,pE,&work[0]);
+         RunEigenStep(mult,0.5*i*i);
          for (j = 0; j < i; j++) {
-            const Int_t off_j = j*n;
-            f = pD[j];
-            pV[off_j+i] = f;
-            g = pE[j]+pV[off_j+j]*f;
-            for (k = j+1; k <= i-1; k++) {
-               const Int_t off_k = k*n;
-               g += pV[off_k+j]*pD[k];
-               pE[k] += pV[off_k+j]*f;
-            }
-            pE[j] = g;
+            pV[j*n+i] = pD[j];
+            pE[j] = work[j];
          }
          f = 0.0;
          for (j = 0; j < i; j++) {
@@ -141,13 +262,9 @@ void TMatrixDSymEigen::MakeTridiagonal(TMatrixD &v,TVectorD &d,TVectorD &e)
          Double_t hh = f/(h+h);
          for (j = 0; j < i; j++)
             pE[j] -= hh*pD[j];
+         TMatrixDSymEigenTask update(kSymUpdate,pV,n,i,pD,pE,0);
+         RunEigenStep(update,0.5*i*i);
          for (j = 0; j < i; j++) {
-            f = pD[j];
-            g = pE[j];
-            for (k = j; k <= i-1; k++) {
-               const Int_t off_k = k*n;
-               pV[off_k+j] -= (f*pE[k]+g*pD[k]);
-            }
             pD[j] = pV[off_i1+j];
             pV[off_i+j] = 0.0;
          }
@@ -167,17 +284,11 @@ void TMatrixDSymEigen::MakeTridiagonal(TMatrixD &v,TVectorD &d,TVectorD &e)
             const Int_t off_k = k*n;
             pD[k] = pV[off_k+i+1]/h;
          }
-         for (j = 0; j <= i; j++) {
-            Double_t g = 0.0;
-            for (k = 0; k <= i; k++) {
-               const Int_t off_k = k*n;
-               g += pV[off_k+i+1]*pV[off_k+j];
-            }
-            for (k = 0; k <= i; k++) {
-               const Int_t off_k = k*n;
-               pV[off_k+j] -= g*pD[k];
-            }
-         }
+         // g[j] = sum_k V(k,i+1)*V(k,j) for all the columns, then V(k,j) -= g[j]*d[k]
+         TMatrixDSymEigenTask dot(kColDot,pV,n,i+1,pD,0,&work[0]);
+         RunEigenStep(dot,Double_t(i+1)*(i+1));
+         TMatrixDSymEigenTask update(kColUpdate,pV,n,i+1,pD,0,&work[0]);
+         RunEigenStep(update,Double_t(i+1)*(i+1));
       }
       for (k = 0; k <= i; k++) {
          const Int_t off_k = k*n;
@@ -199,12 +310,16 @@ void TMatrixDSymEigen::MakeEigenVectors(TMatrixD &v,TVectorD &d,TVectorD &e)
 // This is derived from the Algol procedures tql2, by Bowdler, Martin, Reinsch, and
 // Wilkinson, Handbook for Auto. Comp., Vol.ii-Linear Algebra, and the corresponding
 // Fortran subroutine in EISPACK.
+// The rotations of each QL sweep are accumulated in the eigenvectors row by row
+// after the sweep, in parallel for large matrices (see MakeTridiagonal).
 
    Double_t *pV = v.GetMatrixArray();
    Double_t *pD = d.GetMatrixArray();
    Double_t *pE = e.GetMatrixArray();
 
    const Int_t n = v.GetNrows();
+   std::vector<Double_t> rotCos(n);
+   std::vector<Double_t> rotSin(n);
 
    Int_t i,j,k,l;
    for (i = 1; i < n; i++)
@@ -277,15 +392,14 @@ void TMatrixDSymEigen::MakeEigenVectors(TMatrixD &v,TVectorD &d,TVectorD &e)
                p = c*pD[i]-s*g;
                pD[i+1] = h+s*(c*g+s*pD[i]);
 
-               // Accumulate transformation.
- 
-               for (k = 0; k < n; k++) {
-                  const Int_t off_k = k*n;
-                  h = pV[off_k+i+1];
-                  pV[off_k+i+1] = s*pV[off_k+i]+c*h;
-                  pV[off_k+i]   = c*pV[off_k+i]-s*h;
-               }
+               // Store the transformation, accumulated after the sweep.
+
+               rotCos[i] = c;
+               rotSin[i] = s;
             }
+            TMatrixDSymEigenTask rotate(kRotate,pV,n,n,0,0,0);
+            rotate.SetRotations(&rotCos[0],&rotSin[0],l,m-1);
+            RunEigenStep(rotate,Double_t(n)*(m-l));
             p = -s*s2*c3*el1*pE[l]/dl1;
             pE[l] = s*p;
             pD[l] = c*p;
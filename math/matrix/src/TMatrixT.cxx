@@ -28,9 +28,219 @@
 #include "TMatrixDEigen.h"
 #include "TClass.h"
 #include "TMath.h"
+#include "Math/ThreadPool.h"
+
+#ifdef CBLAS
+#include <cblas.h>
+#endif
 
 templateClassImp(TMatrixT)
 
+namespace {
+
+#ifdef CBLAS
+   //______________________________________________________________________________
+   // C = op(A) * op(B) with the CBLAS library
+   inline void CblasGemm(CBLAS_TRANSPOSE ta,CBLAS_TRANSPOSE tb,Int_t m,Int_t n,Int_t k,
+                         const Double_t *ap,Int_t lda,const Double_t *bp,Int_t ldb,Double_t *cp,Int_t ldc)
+   {
+      cblas_dgemm(CblasRowMajor,ta,tb,m,n,k,1.0,ap,lda,bp,ldb,0.0,cp,ldc);
+   }
+   inline void CblasGemm(CBLAS_TRANSPOSE ta,CBLAS_TRANSPOSE tb,Int_t m,Int_t n,Int_t k,
+                         const Float_t *ap,Int_t lda,const Float_t *bp,Int_t ldb,Float_t *cp,Int_t ldc)
+   {
+      cblas_sgemm(CblasRowMajor,ta,tb,m,n,k,1.0,ap,lda,bp,ldb,0.0,cp,ldc);
+   }
+
+   //______________________________________________________________________________
+   // C = A * B (side = CblasLeft) or C = B * A (side = CblasRight), A symmetric,
+   // with the CBLAS library
+   inline void CblasSymm(CBLAS_SIDE side,Int_t m,Int_t n,
+                         const Double_t *ap,Int_t lda,const Double_t *bp,Int_t ldb,Double_t *cp,Int_t ldc)
+   {
+      cblas_dsymm(CblasRowMajor,side,CblasUpper,m,n,1.0,ap,lda,bp,ldb,0.0,cp,ldc);
+   }
+   inline void CblasSymm(CBLAS_SIDE side,Int_t m,Int_t n,
+                         const Float_t *ap,Int_t lda,const Float_t *bp,Int_t ldb,Float_t *cp,Int_t ldc)
+   {
+      cblas_ssymm(CblasRowMajor,side,CblasUpper,m,n,1.0,ap,lda,bp,ldb,0.0,cp,ldc);
+   }
+#endif
+
+   // Blocking of the matrix multiplication C = A*B, A^T*B or A*B^T of large
+   // matrices: the rows of C are computed by blocks of kMultRowBlock rows,
+   // looping over panels of kMultColBlock columns of C and kMultInnerBlock
+   // inner indices so that the used part of B stays in the cache.
+   const Int_t    kMultRowBlock   = 32;
+   const Int_t    kMultColBlock   = 256;
+   const Int_t    kMultInnerBlock = 128;
+   // number of multiply-adds below which the elementary loops are used
+   const Double_t kMultBlockMin    = 32768.;
+   // number of multiply-adds below which a single thread is used
+   const Double_t kMultParallelMin = 4.e6;
+
+   enum EMultType { kMultAB, kMultAtB, kMultABt };
+
+   //______________________________________________________________________________
+   // Compute the rows first ... last-1 of C = A*B (kMultAB), A^T*B (kMultAtB) or
+   // A*B^T (kMultABt), with ncolsc columns and ninner inner indices.
+   // Every element of C is summed over the inner index in increasing order, as
+   // in the elementary routines, so the result does not depend on the blocking.
+   template<class Element>
+   void MultBlockRows(EMultType type,const Element *ap,Int_t ncolsa,const Element *bp,Int_t ncolsb,
+                      Element *cp,Int_t ncolsc,Int_t ninner,Int_t first,Int_t last)
+   {
+      if (type == kMultABt) {
+         // dot products of the rows of A and B, four columns of C at a time
+         for (Int_t j0 = 0; j0 < ncolsc; j0 += kMultRowBlock) {
+            const Int_t j1 = TMath::Min(j0+kMultRowBlock,ncolsc);
+            for (Int_t i = first; i < last; i++) {
+               const Element *arp = ap+i*ncolsa;
+                     Element *crp = cp+i*ncolsc;
+               Int_t j = j0;
+               for ( ; j+3 < j1; j += 4) {
+                  const Element *b0 = bp+j*ncolsb;
+                  const Element *b1 = b0+ncolsb;
+                  const Element *b2 = b1+ncolsb;
+                  const Element *b3 = b2+ncolsb;
+                  Element c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+                  for (Int_t k = 0; k < ninner; k++) {
+                     const Element aik = arp[k];
+                     c0 += aik*b0[k];
+                     c1 += aik*b1[k];
+                     c2 += aik*b2[k];
+                     c3 += aik*b3[k];
+                  }
+                  crp[j] = c0; crp[j+1] = c1; crp[j+2] = c2; crp[j+3] = c3;
+               }
+               for ( ; j < j1; j++) {
+                  const Element *brp = bp+j*ncolsb;
+                  Element cij = 0;
+                  for (Int_t k = 0; k < ninner; k++)
+                     cij += arp[k]*brp[k];
+                  crp[j] = cij;
+               }
+            }
+         }
+         return;
+      }
+
+      // C[i,:] += A[i,k] * B[k,:] (or A[k,i] for A^T), over panels of C and B
+      for (Int_t i = first; i < last; i++) {
+         Element *crp = cp+i*ncolsc;
+         for (Int_t j = 0; j < ncolsc; j++)
+            crp[j] = 0;
+      }
+      for (Int_t j0 = 0; j0 < ncolsc; j0 += kMultColBlock) {
+         const Int_t j1 = TMath::Min(j0+kMultColBlock,ncolsc);
+         for (Int_t k0 = 0; k0 < ninner; k0 += kMultInnerBlock) {
+            const Int_t k1 = TMath::Min(k0+kMultInnerBlock,ninner);
+            for (Int_t i = first; i < last; i++) {
+               Element *crp = cp+i*ncolsc;
+               // four inner indices at a time, still added in increasing order
+               Int_t k = k0;
+               for ( ; k+3 < k1; k += 4) {
+                  Element a0,a1,a2,a3;
+                  if (type == kMultAB) {
+                     const Element *arp = ap+i*ncolsa+k;
+                     a0 = arp[0]; a1 = arp[1]; a2 = arp[2]; a3 = arp[3];
+                  } else {
+                     const Element *acp = ap+k*ncolsa+i;
+                     a0 = acp[0]; a1 = acp[ncolsa]; a2 = acp[2*ncolsa]; a3 = acp[3*ncolsa];
+                  }
+                  const Element *b0 = bp+k*ncolsb;
+                  const Element *b1 = b0+ncolsb;
+                  const Element *b2 = b1+ncolsb;
+                  const Element *b3 = b2+ncolsb;
+                  for (Int_t j = j0; j < j1; j++)
+                     crp[j] = (((crp[j]+a0*b0[j])+a1*b1[j])+a2*b2[j])+a3*b3[j];
+               }
+               for ( ; k < k1; k++) {
+                  const Element  aik = (type == kMultAB) ? ap[i*ncolsa+k] : ap[k*ncolsa+i];
+                  const Element *brp = bp+k*ncolsb;
+                  for (Int_t j = j0; j < j1; j++)
+                     crp[j] += aik*brp[j];
+               }
+            }
+         }
+      }
+   }
+
+   //______________________________________________________________________________
+   // Compute a block of kMultRowBlock rows of a matrix product
+   template<class Element>
+   class TMatrixTMultTask : public ROOT::Math::ThreadPool::ITask {
+   public:
+      TMatrixTMultTask(EMultType type,const Element *ap,Int_t ncolsa,const Element *bp,Int_t ncolsb,
+                       Element *cp,Int_t nrowsc,Int_t ncolsc,Int_t ninner)
+         : fType(type), fAp(ap), fNcolsa(ncolsa), fBp(bp), fNcolsb(ncolsb), fCp(cp),
+           fNrowsc(nrowsc), fNcolsc(ncolsc), fNinner(ninner) {}
+      void Execute(unsigned int itask) {
+         const Int_t first = itask*kMultRowBlock;
+         const Int_t last  = TMath::Min(first+kMultRowBlock,fNrowsc);
+         MultBlockRows(fType,fAp,fNcolsa,fBp,fNcolsb,fCp,fNcolsc,fNinner,first,last);
+      }
+   private:
+      EMultType      fType;
+      const Element *fAp;
+      Int_t          fNcolsa;
+      const Element *fBp;
+      Int_t          fNcolsb;
+      Element       *fCp;
+      Int_t          fNrowsc;
+      Int_t          fNcolsc;
+      Int_t          fNinner;
+   };
+
+   //______________________________________________________________________________
+   // Compute the matrix product with the blocked kernel, in parallel with
+   // ROOT::Math::ThreadPool for large matrices
+   template<class Element>
+   void MultBlocked(EMultType type,const Element *ap,Int_t ncolsa,const Element *bp,Int_t ncolsb,
+                    Element *cp,Int_t nrowsc,Int_t ncolsc,Int_t ninner)
+   {
+      TMatrixTMultTask<Element> task(type,ap,ncolsa,bp,ncolsb,cp,nrowsc,ncolsc,ninner);
+      const Double_t nmult = Double_t(nrowsc)*ncolsc*ninner;
+      const unsigned int ntasks = (nrowsc+kMultRowBlock-1)/kMultRowBlock;
+      ROOT::Math::ThreadPool::Run(task,ntasks,(nmult < kMultParallelMin) ? 1 : 0);
+   }
+
+   //______________________________________________________________________________
+   // Compute a block of kMultRowBlock rows of the product C = A * B of a sparse
+   // matrix A and a dense matrix B: each row of C is a sum of rows of B.
+   template<class Element>
+   class TMatrixTSparseMultTask : public ROOT::Math::ThreadPool::ITask {
+   public:
+      TMatrixTSparseMultTask(const TMatrixTSparse<Element> &a,const Element *bp,Int_t ncolsb,Element *cp)
+         : fRowIndexa(a.GetRowIndexArray()), fColIndexa(a.GetColIndexArray()), fAp(a.GetMatrixArray()),
+           fNrowsa(a.GetNrows()), fBp(bp), fNcolsb(ncolsb), fCp(cp) {}
+      void Execute(unsigned int itask) {
+         const Int_t first = itask*kMultRowBlock;
+         const Int_t last  = TMath::Min(first+kMultRowBlock,fNrowsa);
+         for (Int_t irow = first; irow < last; irow++) {
+            Element *crp = fCp+irow*fNcolsb;
+            for (Int_t j = 0; j < fNcolsb; j++)
+               crp[j] = 0;
+            for (Int_t index = fRowIndexa[irow]; index < fRowIndexa[irow+1]; index++) {
+               const Element  aik = fAp[index];
+               const Element *brp = fBp+fColIndexa[index]*fNcolsb;
+               for (Int_t j = 0; j < fNcolsb; j++)
+                  crp[j] += aik*brp[j];
+            }
+         }
+      }
+   private:
+      const Int_t   *fRowIndexa;
+      const Int_t   *fColIndexa;
+      const Element *fAp;
+      Int_t          fNrowsa;
+      const Element *fBp;
+      Int_t          fNcolsb;
+      Element       *fCp;
+   };
+
+}
+
 //______________________________________________________________________________
 template<class Element>
 TMatrixT<Element>::TMatrixT(Int_t nrows,Int_t ncols)
@@ -656,17 +866,8 @@ void TMatrixT<Element>::Mult(const TMatrixT<Element> &a,const TMatrixT<Element>
    }
 
 #ifdef CBLAS
-   const Element *ap = a.GetMatrixArray();
-   const Element *bp = b.GetMatrixArray();
-         Element *cp = this->GetMatrixArray();
-   if (typeid(Element) == typeid(Double_t))
-      cblas_dgemm (CblasRowMajor,CblasNoTrans,CblasNoTrans,fNrows,fNcols,a.GetNcols(),
-                   1.0,ap,a.GetNcols(),bp,b.GetNcols(),1.0,cp,fNcols);
-   else if (typeid(Element) != typeid(Float_t))
-      cblas_sgemm (CblasRowMajor,CblasNoTrans,CblasNoTrans,fNrows,fNcols,a.GetNcols(),
-                   1.0,ap,a.GetNcols(),bp,b.GetNcols(),1.0,cp,fNcols);
-   else
-      Error("Mult","type %s not implemented in BLAS library",typeid(Element));
+   CblasGemm(CblasNoTrans,CblasNoTrans,this->fNrows,this->fNcols,a.GetNcols(),
+             a.GetMatrixArray(),a.GetNcols(),b.GetMatrixArray(),b.GetNcols(),this->GetMatrixArray(),this->fNcols);
 #else
    const Int_t na     = a.GetNoElements();
    const Int_t nb     = b.GetNoElements();
@@ -707,17 +908,8 @@ void TMatrixT<Element>::Mult(const TMatrixTSym<Element> &a,const TMatrixT<Elemen
    }
 
 #ifdef CBLAS
-   const Element *ap = a.GetMatrixArray();
-   const Element *bp = b.GetMatrixArray();
-         Element *cp = this->GetMatrixArray();
-   if (typeid(Element) == typeid(Double_t))
-      cblas_dsymm (CblasRowMajor,CblasLeft,CblasUpper,fNrows,fNcols,1.0,
-                   ap,a.GetNcols(),bp,b.GetNcols(),0.0,cp,fNcols);
-   else if (typeid(Element) != typeid(Float_t))
-      cblas_ssymm (CblasRowMajor,CblasLeft,CblasUpper,fNrows,fNcols,1.0,
-                   ap,a.GetNcols(),bp,b.GetNcols(),0.0,cp,fNcols);
-   else
-      Error("Mult","type %s not implemented in BLAS library",typeid(Element));
+   CblasSymm(CblasLeft,this->fNrows,this->fNcols,
+             a.GetMatrixArray(),a.GetNcols(),b.GetMatrixArray(),b.GetNcols(),this->GetMatrixArray(),this->fNcols);
 #else
    const Int_t na     = a.GetNoElements();
    const Int_t nb     = b.GetNoElements();
@@ -759,17 +951,8 @@ void TMatrixT<Element>::Mult(const TMatrixT<Element> &a,const TMatrixTSym<Elemen
    }
 
 #ifdef CBLAS
-   const Element *ap = a.GetMatrixArray();
-   const Element *bp = b.GetMatrixArray();
-         Element *cp = this->GetMatrixArray();
-   if (typeid(Element) == typeid(Double_t))
-      cblas_dsymm (CblasRowMajor,CblasRight,CblasUpper,fNrows,fNcols,1.0,
-                   bp,b.GetNcols(),ap,a.GetNcols(),0.0,cp,fNcols);
-   else if (typeid(Element) != typeid(Float_t))
-      cblas_ssymm (CblasRowMajor,CblasRight,CblasUpper,fNrows,fNcols,1.0,
-                   bp,b.GetNcols(),ap,a.GetNcols(),0.0,cp,fNcols);
-   else
-      Error("Mult","type %s not implemented in BLAS library",typeid(Element));
+   CblasSymm(CblasRight,this->fNrows,this->fNcols,
+             b.GetMatrixArray(),b.GetNcols(),a.GetMatrixArray(),a.GetNcols(),this->GetMatrixArray(),this->fNcols);
 #else
    const Int_t na     = a.GetNoElements();
    const Int_t nb     = b.GetNoElements();
@@ -811,17 +994,8 @@ void TMatrixT<Element>::Mult(const TMatrixTSym<Element> &a,const TMatrixTSym<Ele
    }
 
 #ifdef CBLAS
-   const Element *ap = a.GetMatrixArray();
-   const Element *bp = b.GetMatrixArray();
-         Element *cp = this->GetMatrixArray();
-   if (typeid(Element) == typeid(Double_t))
-      cblas_dsymm (CblasRowMajor,CblasLeft,CblasUpper,fNrows,fNcols,1.0,
-                   ap,a.GetNcols(),bp,b.GetNcols(),0.0,cp,fNcols);
-   else if (typeid(Element) != typeid(Float_t))
-      cblas_ssymm (CblasRowMajor,CblasLeft,CblasUpper,fNrows,fNcols,1.0,
-                   ap,a.GetNcols(),bp,b.GetNcols(),0.0,cp,fNcols);
-   else
-      Error("Mult","type %s not implemented in BLAS library",typeid(Element));
+   CblasSymm(CblasLeft,this->fNrows,this->fNcols,
+             a.GetMatrixArray(),a.GetNcols(),b.GetMatrixArray(),b.GetNcols(),this->GetMatrixArray(),this->fNcols);
 #else
    const Int_t na     = a.GetNoElements();
    const Int_t nb     = b.GetNoElements();
@@ -835,6 +1009,41 @@ void TMatrixT<Element>::Mult(const TMatrixTSym<Element> &a,const TMatrixTSym<Ele
 #endif
 }
 
+//______________________________________________________________________________
+template<class Element>
+void TMatrixT<Element>::Mult(const TMatrixTSparse<Element> &a,const TMatrixT<Element> &b)
+{
+// Matrix multiplication, with A sparse and B general.
+// Create a matrix C such that C = A * B. Each row of C is accumulated from the
+// rows of B selected by the non-zero elements of the corresponding row of A;
+// for large matrices the rows are computed in parallel with ROOT::Math::ThreadPool.
+
+   if (gMatrixCheck) {
+      R__ASSERT(a.IsValid());
+      R__ASSERT(b.IsValid());
+      if (a.GetNcols() != b.GetNrows() || a.GetColLwb() != b.GetRowLwb()) {
+         Error("Mult","A rows and B columns incompatible");
+         return;
+      }
+
+      if (this->fNrows != a.GetNrows() || this->fNcols != b.GetNcols()) {
+         Error("Mult","C and A * B incompatible");
+         return;
+      }
+
+      if (this->GetMatrixArray() == b.GetMatrixArray()) {
+         Error("Mult","this->GetMatrixArray() == b.GetMatrixArray()");
+         return;
+      }
+   }
+
+   const Int_t ncolsb = b.GetNcols();
+   TMatrixTSparseMultTask<Element> task(a,b.GetMatrixArray(),ncolsb,this->GetMatrixArray());
+   const Double_t nmult = Double_t(a.GetRowIndexArray()[a.GetNrows()])*ncolsb;
+   const unsigned int ntasks = (a.GetNrows()+kMultRowBlock-1)/kMultRowBlock;
+   ROOT::Math::ThreadPool::Run(task,ntasks,(nmult < kMultParallelMin) ? 1 : 0);
+}
+
 //______________________________________________________________________________
 template<class Element>
 void TMatrixT<Element>::TMult(const TMatrixT<Element> &a,const TMatrixT<Element> &b)
@@ -862,17 +1071,8 @@ void TMatrixT<Element>::TMult(const TMatrixT<Element> &a,const TMatrixT<Element>
    }
 
 #ifdef CBLAS
-   const Element *ap = a.GetMatrixArray();
-   const Element *bp = b.GetMatrixArray();
-         Element *cp = this->GetMatrixArray();
-   if (typeid(Element) == typeid(Double_t))
-      cblas_dgemm (CblasRowMajor,CblasTrans,CblasNoTrans,this->fNrows,this->fNcols,a.GetNrows(),
-                   1.0,ap,a.GetNcols(),bp,b.GetNcols(),1.0,cp,this->fNcols);
-   else if (typeid(Element) != typeid(Float_t))
-      cblas_sgemm (CblasRowMajor,CblasTrans,CblasNoTrans,fNrows,fNcols,a.GetNrows(),
-                   1.0,ap,a.GetNcols(),bp,b.GetNcols(),1.0,cp,fNcols);
-   else
-      Error("TMult","type %s not implemented in BLAS library",typeid(Element));
+   CblasGemm(CblasTrans,CblasNoTrans,this->fNrows,this->fNcols,a.GetNrows(),
+             a.GetMatrixArray(),a.GetNcols(),b.GetMatrixArray(),b.GetNcols(),this->GetMatrixArray(),this->fNcols);
 #else
    const Int_t nb     = b.GetNoElements();
    const Int_t ncolsa = a.GetNcols();
@@ -912,17 +1112,8 @@ void TMatrixT<Element>::TMult(const TMatrixT<Element> &a,const TMatrixTSym<Eleme
    }
 
 #ifdef CBLAS
-   const Element *ap = a.GetMatrixArray();
-   const Element *bp = b.GetMatrixArray();
-         Element *cp = this->GetMatrixArray();
-   if (typeid(Element) == typeid(Double_t))
-      cblas_dgemm (CblasRowMajor,CblasTrans,CblasNoTrans,fNrows,fNcols,a.GetNrows(),
-                   1.0,ap,a.GetNcols(),bp,b.GetNcols(),1.0,cp,fNcols);
-   else if (typeid(Element) != typeid(Float_t))
-      cblas_sgemm (CblasRowMajor,CblasTrans,CblasNoTrans,fNrows,fNcols,a.GetNrows(),
-                   1.0,ap,a.GetNcols(),bp,b.GetNcols(),1.0,cp,fNcols);
-   else
-      Error("TMult","type %s not implemented in BLAS library",typeid(Element));
+   CblasGemm(CblasTrans,CblasNoTrans,this->fNrows,this->fNcols,a.GetNrows(),
+             a.GetMatrixArray(),a.GetNcols(),b.GetMatrixArray(),b.GetNcols(),this->GetMatrixArray(),this->fNcols);
 #else
    const Int_t nb     = b.GetNoElements();
    const Int_t ncolsa = a.GetNcols();
@@ -962,17 +1153,8 @@ void TMatrixT<Element>::MultT(const TMatrixT<Element> &a,const TMatrixT<Element>
    }
 
 #ifdef CBLAS
-   const Element *ap = a.GetMatrixArray();
-   const Element *bp = b.GetMatrixArray();
-         Element *cp = this->GetMatrixArray();
-   if (typeid(Element) == typeid(Double_t))
-      cblas_dgemm (CblasRowMajor,CblasNoTrans,CblasTrans,fNrows,fNcols,a.GetNcols(),
-                   1.0,ap,a.GetNcols(),bp,b.GetNcols(),1.0,cp,fNcols);
-   else if (typeid(Element) != typeid(Float_t))
-      cblas_sgemm (CblasRowMajor,CblasNoTrans,CblasTrans,fNrows,fNcols,a.GetNcols(),
-                   1.0,ap,a.GetNcols(),bp,b.GetNcols(),1.0,cp,fNcols);
-   else
-      Error("MultT","type %s not implemented in BLAS library",typeid(Element));
+   CblasGemm(CblasNoTrans,CblasTrans,this->fNrows,this->fNcols,a.GetNcols(),
+             a.GetMatrixArray(),a.GetNcols(),b.GetMatrixArray(),b.GetNcols(),this->GetMatrixArray(),this->fNcols);
 #else
    const Int_t na     = a.GetNoElements();
    const Int_t nb     = b.GetNoElements();
@@ -1013,17 +1195,8 @@ void TMatrixT<Element>::MultT(const TMatrixTSym<Element> &a,const TMatrixT<Eleme
    }
 
 #ifdef CBLAS
-   const Element *ap = a.GetMatrixArray();
-   const Element *bp = b.GetMatrixArray();
-         Element *cp = this->GetMatrixArray();
-   if (typeid(Element) == typeid(Double_t))
-      cblas_dgemm (CblasRowMajor,CblasNoTrans,CblasTrans,this->fNrows,this->fNcols,a.GetNcols(),
-                   1.0,ap,a.GetNcols(),bp,b.GetNcols(),1.0,cp,this->fNcols);
-   else if (typeid(Element) != typeid(Float_t))
-      cblas_sgemm (CblasRowMajor,CblasNoTrans,CblasTrans,fNrows,fNcols,a.GetNcols(),
-                   1.0,ap,a.GetNcols(),bp,b.GetNcols(),1.0,cp,fNcols);
-   else
-      Error("MultT","type %s not implemented in BLAS library",typeid(Element));
+   CblasGemm(CblasNoTrans,CblasTrans,this->fNrows,this->fNcols,a.GetNcols(),
+             a.GetMatrixArray(),a.GetNcols(),b.GetMatrixArray(),b.GetNcols(),this->GetMatrixArray(),this->fNcols);
 #else
    const Int_t na     = a.GetNoElements();
    const Int_t nb     = b.GetNoElements();
@@ -3066,6 +3239,15 @@ void AMultB(const Element * const ap,Int_t na,Int_t ncolsa,
             const Element * const bp,Int_t nb,Int_t ncolsb,Element *cp)
 {
 // Elementary routine to calculate matrix multiplication A*B
+// Large matrices are multiplied by blocks fitting in the cache, in parallel when
+// ROOT::Math::ThreadPool::SetDefaultNThreads has been called. The elements are
+// summed in the same order in all cases, so the result does not depend on it.
+
+   const Int_t nrowsa = (ncolsa > 0) ? na/ncolsa : 0;
+   if (Double_t(nrowsa)*ncolsb*ncolsa >= kMultBlockMin) {
+      MultBlocked(kMultAB,ap,ncolsa,bp,ncolsb,cp,nrowsa,ncolsb,ncolsa);
+      return;
+   }
 
    const Element *arp0 = ap;                     // Pointer to  A[i,0];
    while (arp0 < ap+na) {
@@ -3089,6 +3271,13 @@ void AtMultB(const Element * const ap,Int_t ncolsa,
              const Element * const bp,Int_t nb,Int_t ncolsb,Element *cp)
 {
 // Elementary routine to calculate matrix multiplication A^T*B
+// Large matrices are multiplied by blocks, see AMultB.
+
+   const Int_t nrowsb = (ncolsb > 0) ? nb/ncolsb : 0;
+   if (Double_t(ncolsa)*ncolsb*nrowsb >= kMultBlockMin) {
+      MultBlocked(kMultAtB,ap,ncolsa,bp,ncolsb,cp,ncolsa,ncolsb,nrowsb);
+      return;
+   }
 
    const Element *acp0 = ap;           // Pointer to  A[i,0];
    while (acp0 < ap+ncolsa) {
@@ -3113,6 +3302,14 @@ void AMultBt(const Element * const ap,Int_t na,Int_t ncolsa,
              const Element * const bp,Int_t nb,Int_t ncolsb,Element *cp)
 {
 // Elementary routine to calculate matrix multiplication A*B^T
+// Large matrices are multiplied by blocks, see AMultB.
+
+   const Int_t nrowsa = (ncolsa > 0) ? na/ncolsa : 0;
+   const Int_t nrowsb = (ncolsb > 0) ? nb/ncolsb : 0;
+   if (Double_t(nrowsa)*nrowsb*ncolsa >= kMultBlockMin) {
+      MultBlocked(kMultABt,ap,ncolsa,bp,ncolsb,cp,nrowsa,nrowsb,ncolsa);
+      return;
+   }
 
    const Element *arp0 = ap;                    // Pointer to  A[i,0];
    while (arp0 < ap+na) {
@@ -372,18 +372,6 @@ void TMatrixTSym<Element>::TMult(const TMatrixT<Element> &a)
 
    R__ASSERT(a.IsValid());
 
-#ifdef CBLAS
-   const Element *ap = a.GetMatrixArray();
-         Element *cp = this->GetMatrixArray();
-   if (typeid(Element) == typeid(Double_t))
-      cblas_dgemm (CblasRowMajor,CblasTrans,CblasNoTrans,this->fNrows,this->fNcols,a.GetNrows(),
-                   1.0,ap,a.GetNcols(),ap,a.GetNcols(),1.0,cp,this->fNcols);
-   else if (typeid(Element) != typeid(Float_t))
-      cblas_sgemm (CblasRowMajor,CblasTrans,CblasNoTrans,fNrows,fNcols,a.GetNrows(),
-                   1.0,ap,a.GetNcols(),ap,a.GetNcols(),1.0,cp,fNcols);
-  else
-      Error("TMult","type %s not implemented in BLAS library",typeid(Element));
-#else
    const Int_t nb     = a.GetNoElements();
    const Int_t ncolsa = a.GetNcols();
    const Int_t ncolsb = ncolsa;
@@ -391,24 +379,7 @@ void TMatrixTSym<Element>::TMult(const TMatrixT<Element> &a)
    const Element * const bp = ap;
          Element *       cp = this->GetMatrixArray();
 
-   const Element *acp0 = ap;           // Pointer to  A[i,0];
-   while (acp0 < ap+a.GetNcols()) {
-      for (const Element *bcp = bp; bcp < bp+ncolsb; ) { // Pointer to the j-th column of A, Start bcp = A[0,0]
-         const Element *acp = acp0;                       // Pointer to the i-th column of A, reset to A[0,i]
-         Element cij = 0;
-         while (bcp < bp+nb) {           // Scan the i-th column of A and
-            cij += *acp * *bcp;           // the j-th col of A
-            acp += ncolsa;
-            bcp += ncolsb;
-         }
-         *cp++ = cij;
-         bcp -= nb-1;                    // Set bcp to the (j+1)-th col
-      }
-      acp0++;                           // Set acp0 to the (i+1)-th col
-   }
-
-   R__ASSERT(cp == this->GetMatrixArray()+this->fNelems && acp0 == ap+ncolsa);
-#endif
+   AtMultB(ap,ncolsa,bp,nb,ncolsb,cp);
 }
 
 //______________________________________________________________________________
@@ -420,18 +391,6 @@ void TMatrixTSym<Element>::TMult(const TMatrixTSym<Element> &a)
 
    R__ASSERT(a.IsValid());
 
-#ifdef CBLAS
-   const Element *ap = a.GetMatrixArray();
-         Element *cp = this->GetMatrixArray();
-   if (typeid(Element) == typeid(Double_t))
-      cblas_dsymm (CblasRowMajor,CblasLeft,CblasUpper,this->fNrows,this->fNcols,1.0,
-                   ap,a.GetNcols(),ap,a.GetNcols(),0.0,cp,this->fNcols);
-   else if (typeid(Element) != typeid(Float_t))
-      cblas_ssymm (CblasRowMajor,CblasLeft,CblasUpper,fNrows,fNcols,1.0,
-                   ap1,a.GetNcols(),ap,a.GetNcols(),0.0,cp,fNcols);
-   else
-      Error("TMult","type %s not implemented in BLAS library",typeid(Element));
-#else
    const Int_t nb     = a.GetNoElements();
    const Int_t ncolsa = a.GetNcols();
    const Int_t ncolsb = ncolsa;
@@ -439,24 +398,7 @@ void TMatrixTSym<Element>::TMult(const TMatrixTSym<Element> &a)
    const Element * const bp = ap;
          Element *       cp = this->GetMatrixArray();
 
-   const Element *acp0 = ap;           // Pointer to  A[i,0];
-   while (acp0 < ap+a.GetNcols()) {
-      for (const Element *bcp = bp; bcp < bp+ncolsb; ) { // Pointer to the j-th column of A, Start bcp = A[0,0]
-         const Element *acp = acp0;                       // Pointer to the i-th column of A, reset to A[0,i]
-         Element cij = 0;
-         while (bcp < bp+nb) {           // Scan the i-th column of A and
-            cij += *acp * *bcp;           // the j-th col of A
-            acp += ncolsa;
-            bcp += ncolsb;
-         }
-         *cp++ = cij;
-         bcp -= nb-1;                    // Set bcp to the (j+1)-th col
-      }
-      acp0++;                           // Set acp0 to the (i+1)-th col
-   }
-
-   R__ASSERT(cp == this->GetMatrixArray()+this->fNelems && acp0 == ap+ncolsa);
-#endif
+   AtMultB(ap,ncolsa,bp,nb,ncolsb,cp);
 }
 
 //______________________________________________________________________________
@@ -1112,17 +1054,6 @@ TMatrixTSym<Element> &TMatrixTSym<Element>::Similarity(const TMatrixT<Element> &
    if (nrowsb != this->fNrows)
       this->ResizeTo(nrowsb,nrowsb);
 
-#ifdef CBLAS
-         Element *cp = this->GetMatrixArray();
-   if (typeid(Element) == typeid(Double_t))
-      cblas_dgemm (CblasRowMajor,CblasNoTrans,CblasTrans,this->fNrows,this->fNcols,ba.GetNcols(),
-                   1.0,bap,ba.GetNcols(),bp,b.GetNcols(),1.0,cp,this->fNcols);
-   else if (typeid(Element) != typeid(Float_t))
-      cblas_sgemm (CblasRowMajor,CblasNoTrans,CblasTrans,this->fNrows,this->fNcols,ba.GetNcols(),
-                   1.0,bap,ba.GetNcols(),bp,b.GetNcols(),1.0,cp,this->fNcols);
-   else
-      Error("Similarity","type %s not implemented in BLAS library",typeid(Element));
-#else
    const Int_t nba     = nrowsb*ncolsa;
    const Int_t ncolsba = ncolsa;
    const Element *       bi1p = bp;
@@ -1157,7 +1088,6 @@ TMatrixTSym<Element> &TMatrixTSym<Element>::Similarity(const TMatrixT<Element> &
          cp[rowOff1+icol] = cp[rowOff2+irow];
       }
    }
-#endif
 
    if (isAllocated)
       delete [] bap;
@@ -1183,34 +1113,6 @@ TMatrixTSym<Element> &TMatrixTSym<Element>::Similarity(const TMatrixTSym<Element
       }
    }
 
-#ifdef CBLAS
-   const Int_t nrowsb = b.GetNrows();
-   const Int_t ncolsa = this->GetNcols();
-
-   Element work[kWorkMax];
-   Bool_t isAllocated = kFALSE;
-   Element *abtp = work;
-   if (this->fNcols > kWorkMax) {
-      isAllocated = kTRUE;
-      abtp = new Element[this->fNcols];
-   }
-
-   const TMatrixT<Element> abt(*this,TMatrixT<Element>::kMultTranspose,b);
-
-   const Element *bp = b.GetMatrixArray();
-         Element *cp = this->GetMatrixArray();
-   if (typeid(Element) == typeid(Double_t))
-      cblas_dsymm (CblasRowMajor,CblasLeft,CblasUpper,this->fNrows,this->fNcols,1.0,
-                   bp,b.GetNcols(),abtp,abt.GetNcols(),0.0,cp,this->fNcols);
-   else if (typeid(Element) != typeid(Float_t))
-      cblas_ssymm (CblasRowMajor,CblasLeft,CblasUpper,this->fNrows,this->fNcols,1.0,
-                   bp,b.GetNcols(),abtp,abt.GetNcols(),0.0,cp,this->fNcols);
-   else
-      Error("Similarity","type %s not implemented in BLAS library",typeid(Element));
-
-   if (isAllocated)
-      delete [] abtp;
-#else
    const Int_t ncolsa = this->GetNcols();
    const Int_t nb     = b.GetNoElements();
    const Int_t nrowsb = b.GetNrows();
@@ -1265,7 +1167,6 @@ TMatrixTSym<Element> &TMatrixTSym<Element>::Similarity(const TMatrixTSym<Element
 
    if (isAllocated)
       delete [] bap;
-#endif
 
    return *this;
 }
@@ -1337,18 +1238,6 @@ TMatrixTSym<Element> &TMatrixTSym<Element>::SimilarityT(const TMatrixT<Element>
    if (ncolsb != this->fNcols)
       this->ResizeTo(ncolsb,ncolsb);
 
-#ifdef CBLAS
-   const Element *bp = b.GetMatrixArray();
-         Element *cp = this->GetMatrixArray();
-   if (typeid(Element) == typeid(Double_t))
-      cblas_dgemm (CblasRowMajor,CblasNoTrans,CblasNoTrans,this->fNrows,this->fNcols,bta.GetNcols(),
-                   1.0,btap,bta.GetNcols(),bp,b.GetNcols(),1.0,cp,this->fNcols);
-   else if (typeid(Element) != typeid(Float_t))
-      cblas_sgemm (CblasRowMajor,CblasNoTrans,CblasNoTrans,this->fNrows,this->fNcols,bta.GetNcols(),
-                   1.0,btap,bta.GetNcols(),bp,b.GetNcols(),1.0,cp,this->fNcols);
-   else
-      Error("similarityT","type %s not implemented in BLAS library",typeid(Element));
-#else
    const Int_t nbta     = bta.GetNoElements();
    const Int_t nb       = b.GetNoElements();
    const Int_t ncolsbta = bta.GetNcols();
@@ -1385,7 +1274,6 @@ TMatrixTSym<Element> &TMatrixTSym<Element>::SimilarityT(const TMatrixT<Element>
          cp[rowOff1+icol] = cp[rowOff2+irow];
       }
    }
-#endif
 
    if (isAllocated)
       delete [] btap;
@@ -39,6 +39,118 @@
 #include "TMath.h"
 #include "TROOT.h"
 #include "Varargs.h"
+#include "Math/ThreadPool.h"
+
+#include <algorithm>
+
+#ifdef CBLAS
+#include <cblas.h>
+#endif
+
+namespace {
+
+#ifdef CBLAS
+   //______________________________________________________________________________
+   // y = alpha * A * x + beta * y with the CBLAS library
+   inline void CblasGemv(Int_t m,Int_t n,Double_t alpha,const Double_t *ap,const Double_t *xp,
+                         Double_t beta,Double_t *yp)
+   {
+      cblas_dgemv(CblasRowMajor,CblasNoTrans,m,n,alpha,ap,n,xp,1,beta,yp,1);
+   }
+   inline void CblasGemv(Int_t m,Int_t n,Float_t alpha,const Float_t *ap,const Float_t *xp,
+                         Float_t beta,Float_t *yp)
+   {
+      cblas_sgemv(CblasRowMajor,CblasNoTrans,m,n,alpha,ap,n,xp,1,beta,yp,1);
+   }
+
+   //______________________________________________________________________________
+   // y = alpha * A * x + beta * y, A symmetric, with the CBLAS library
+   inline void CblasSymv(Int_t n,Double_t alpha,const Double_t *ap,const Double_t *xp,
+                         Double_t beta,Double_t *yp)
+   {
+      cblas_dsymv(CblasRowMajor,CblasUpper,n,alpha,ap,n,xp,1,beta,yp,1);
+   }
+   inline void CblasSymv(Int_t n,Float_t alpha,const Float_t *ap,const Float_t *xp,
+                         Float_t beta,Float_t *yp)
+   {
+      cblas_ssymv(CblasRowMajor,CblasUpper,n,alpha,ap,n,xp,1,beta,yp,1);
+   }
+#endif
+
+   const Int_t kSparseChunk       = 16384;  // number of non-zero elements per task
+   const Int_t kSparseParallelMin = 131072; // number of non-zero elements above which threads are used
+
+   //______________________________________________________________________________
+   // Sparse matrix - vector product for the rows [first,last):
+   // target = A * source for scalar = 0, target += scalar * A * source otherwise
+   template<class Element>
+   void SparseMultRows(const Int_t *pRowIndex,const Int_t *pColIndex,const Element *mp,
+                       const Element *sp,Element *tp,Element scalar,Int_t first,Int_t last)
+   {
+      for (Int_t irow = first; irow < last; irow++) {
+         const Int_t sIndex = pRowIndex[irow];
+         const Int_t eIndex = pRowIndex[irow+1];
+         Element sum = 0.0;
+         for (Int_t index = sIndex; index < eIndex; index++)
+            sum += mp[index]*sp[pColIndex[index]];
+         if      (scalar ==  0.0) tp[irow]  = sum;
+         else if (scalar ==  1.0) tp[irow] += sum;
+         else if (scalar == -1.0) tp[irow] -= sum;
+         else                     tp[irow] += scalar*sum;
+      }
+   }
+
+   //______________________________________________________________________________
+   // Compute the rows of a sparse matrix - vector product holding a chunk of
+   // kSparseChunk non-zero elements
+   template<class Element>
+   class TSparseMultTask : public ROOT::Math::ThreadPool::ITask {
+   public:
+      TSparseMultTask(const Int_t *pRowIndex,const Int_t *pColIndex,const Element *mp,
+                      const Element *sp,Element *tp,Element scalar,Int_t nrows,unsigned int ntasks)
+         : fRowIndex(pRowIndex), fColIndex(pColIndex), fMp(mp), fSp(sp), fTp(tp),
+           fScalar(scalar), fNrows(nrows), fNtasks(ntasks) {}
+      Int_t FirstRow(unsigned int itask) const {
+         // first row with an element at or after the start of the chunk
+         if (itask == 0) return 0;
+         return std::lower_bound(fRowIndex+1,fRowIndex+fNrows+1,Int_t(itask*kSparseChunk))-fRowIndex;
+      }
+      void Execute(unsigned int itask) {
+         // the last task also computes the empty rows at the end of the matrix
+         const Int_t last = (itask+1 == fNtasks) ? fNrows : TMath::Min(FirstRow(itask+1),fNrows);
+         SparseMultRows(fRowIndex,fColIndex,fMp,fSp,fTp,fScalar,TMath::Min(FirstRow(itask),fNrows),last);
+      }
+   private:
+      const Int_t   *fRowIndex;
+      const Int_t   *fColIndex;
+      const Element *fMp;
+      const Element *fSp;
+      Element       *fTp;
+      Element        fScalar;
+      Int_t          fNrows;
+      unsigned int   fNtasks;
+   };
+
+   //______________________________________________________________________________
+   // Sparse matrix - vector product, in parallel with ROOT::Math::ThreadPool for
+   // large matrices. Each row is computed in the same way, so the result does
+   // not depend on the number of threads.
+   template<class Element>
+   void SparseMult(const TMatrixTSparse<Element> &a,const Element *sp,Element *tp,Element scalar)
+   {
+      const Int_t nrows    = a.GetNrows();
+      const Int_t nonzeros = a.GetRowIndexArray()[nrows];
+      if (nonzeros < kSparseParallelMin) {
+         SparseMultRows(a.GetRowIndexArray(),a.GetColIndexArray(),a.GetMatrixArray(),sp,tp,scalar,0,nrows);
+         return;
+      }
+      const unsigned int ntasks = (nonzeros+kSparseChunk-1)/kSparseChunk;
+      TSparseMultTask<Element> task(a.GetRowIndexArray(),a.GetColIndexArray(),a.GetMatrixArray(),
+                                    sp,tp,scalar,nrows,ntasks);
+      ROOT::Math::ThreadPool::Run(task,ntasks);
+   }
+
+}
 
 templateClassImp(TVectorT)
 
@@ -983,14 +1095,7 @@ TVectorT<Element> &TVectorT<Element>::operator*=(const TMatrixT<Element> &a)
    const Element *mp = a.GetMatrixArray();     // Matrix row ptr
          Element *tp = this->GetMatrixArray(); // Target vector ptr
 #ifdef CBLAS
-   if (typeid(Element) == typeid(Double_t))
-      cblas_dgemv(CblasRowMajor,CblasNoTrans,a.GetNrows(),a.GetNcols(),1.0,mp,
-                  a.GetNcols(),elements_old,1,0.0,tp,1);
-   else if (typeid(Element) != typeid(Float_t))
-      cblas_sgemv(CblasRowMajor,CblasNoTrans,a.GetNrows(),a.GetNcols(),1.0,mp,
-                  a.GetNcols(),elements_old,1,0.0,tp,1);
-   else
-      Error("operator*=","type %s not implemented in BLAS library",typeid(Element));
+   CblasGemv(a.GetNrows(),a.GetNcols(),Element(1),mp,elements_old,Element(0),tp);
 #else
    const Element * const tp_last = tp+fNrows;
    while (tp < tp_last) {
@@ -1047,23 +1152,7 @@ TVectorT<Element> &TVectorT<Element>::operator*=(const TMatrixTSparse<Element> &
    }
    memset(fElements,0,fNrows*sizeof(Element));
 
-   const Int_t   * const pRowIndex = a.GetRowIndexArray();
-   const Int_t   * const pColIndex = a.GetColIndexArray();
-   const Element * const mp        = a.GetMatrixArray();     // Matrix row ptr
-
-   const Element * const sp = elements_old;
-         Element *       tp = this->GetMatrixArray(); // Target vector ptr
-
-   for (Int_t irow = 0; irow < fNrows; irow++) {
-      const Int_t sIndex = pRowIndex[irow];
-      const Int_t eIndex = pRowIndex[irow+1];
-      Element sum = 0.0;
-      for (Int_t index = sIndex; index < eIndex; index++) {
-         const Int_t icol = pColIndex[index];
-         sum += mp[index]*sp[icol];
-      }
-      tp[irow] = sum;
-   }
+   SparseMult(a,elements_old,this->GetMatrixArray(),Element(0.0));
 
    if (isAllocated)
       delete [] elements_old;
@@ -1101,14 +1190,7 @@ TVectorT<Element> &TVectorT<Element>::operator*=(const TMatrixTSym<Element> &a)
    const Element *mp = a.GetMatrixArray();     // Matrix row ptr
          Element *tp = this->GetMatrixArray(); // Target vector ptr
 #ifdef CBLAS
-   if (typeid(Element) == typeid(Double_t))
-      cblas_dsymv(CblasRowMajor,CblasUpper,fNrows,1.0,mp,
-                  fNrows,elements_old,1,0.0,tp,1);
-   else if (typeid(Element) != typeid(Float_t))
-      cblas_ssymv(CblasRowMajor,CblasUpper,fNrows,1.0,mp,
-                  fNrows,elements_old,1,0.0,tp,1);
-   else
-      Error("operator*=","type %s not implemented in BLAS library",typeid(Element));
+   CblasSymv(fNrows,Element(1),mp,elements_old,Element(0),tp);
 #else
    const Element * const tp_last = tp+fNrows;
    while (tp < tp_last) {
@@ -1632,14 +1714,10 @@ TVectorT<Element> &Add(TVectorT<Element> &target,Element scalar,
    const Element *       mp = a.GetMatrixArray();       // Matrix row ptr
          Element *       tp = target.GetMatrixArray();  // Target vector ptr
 #ifdef CBLAS
-   if (typeid(Element) == typeid(Double_t))
-      cblas_dsymv(CblasRowMajor,CblasUpper,fNrows,scalar,mp,
-                  fNrows,sp,1,0.0,tp,1);
-   else if (typeid(Element) != typeid(Float_t))
-      cblas_ssymv(CblasRowMajor,CblasUpper,fNrows,scalar,mp,
-                  fNrows,sp,1,0.0,tp,1);
+   if (scalar == 0.0)
+      CblasGemv(a.GetNrows(),a.GetNcols(),Element(1),mp,sp,Element(0),tp);
    else
-      Error("operator*=","type %s not implemented in BLAS library",typeid(Element));
+      CblasGemv(a.GetNrows(),a.GetNcols(),scalar,mp,sp,Element(1),tp);
 #else
    const Element * const sp_last = sp+source.GetNrows();
    const Element * const tp_last = tp+target.GetNrows();
@@ -1705,14 +1783,10 @@ TVectorT<Element> &Add(TVectorT<Element> &target,Element scalar,
    const Element *       mp = a.GetMatrixArray();       // Matrix row ptr
          Element *       tp = target.GetMatrixArray();  // Target vector ptr
 #ifdef CBLAS
-   if (typeid(Element) == typeid(Double_t))
-      cblas_dsymv(CblasRowMajor,CblasUpper,fNrows,1.0,mp,
-                  fNrows,sp,1,0.0,tp,1);
-   else if (typeid(Element) != typeid(Float_t))
-      cblas_ssymv(CblasRowMajor,CblasUpper,fNrows,1.0,mp,
-                  fNrows,sp,1,0.0,tp,1);
+   if (scalar == 0.0)
+      CblasSymv(a.GetNrows(),Element(1),mp,sp,Element(0),tp);
    else
-      Error("operator*=","type %s not implemented in BLAS library",typeid(Element));
+      CblasSymv(a.GetNrows(),scalar,mp,sp,Element(1),tp);
 #else
    const Element * const sp_last = sp+source.GetNrows();
    const Element * const tp_last = tp+target.GetNrows();
@@ -1778,58 +1852,7 @@ TVectorT<Element> &Add(TVectorT<Element> &target,Element scalar,
       }
    }
 
-   const Int_t   * const pRowIndex = a.GetRowIndexArray();
-   const Int_t   * const pColIndex = a.GetColIndexArray();
-   const Element * const mp        = a.GetMatrixArray();     // Matrix row ptr
-
-   const Element * const sp = source.GetMatrixArray(); // Source vector ptr
-         Element *       tp = target.GetMatrixArray(); // Target vector ptr
-
-   if (scalar == 1.0) {
-      for (Int_t irow = 0; irow < a.GetNrows(); irow++) {
-         const Int_t sIndex = pRowIndex[irow];
-         const Int_t eIndex = pRowIndex[irow+1];
-         Element sum = 0.0;
-         for (Int_t index = sIndex; index < eIndex; index++) {
-            const Int_t icol = pColIndex[index];
-            sum += mp[index]*sp[icol];
-         }
-         tp[irow] += sum;
-      }
-   } else if (scalar == 0.0) {
-      for (Int_t irow = 0; irow < a.GetNrows(); irow++) {
-         const Int_t sIndex = pRowIndex[irow];
-         const Int_t eIndex = pRowIndex[irow+1];
-         Element sum = 0.0;
-         for (Int_t index = sIndex; index < eIndex; index++) {
-            const Int_t icol = pColIndex[index];
-            sum += mp[index]*sp[icol];
-         }
-         tp[irow]  = sum;
-      }
-   } else if (scalar == -1.0) {
-     for (Int_t irow = 0; irow < a.GetNrows(); irow++) {
-        const Int_t sIndex = pRowIndex[irow];
-        const Int_t eIndex = pRowIndex[irow+1];
-        Element sum = 0.0;
-        for (Int_t index = sIndex; index < eIndex; index++) {
-           const Int_t icol = pColIndex[index];
-           sum += mp[index]*sp[icol];
-        }
-        tp[irow] -= sum;
-      }
-   } else {
-      for (Int_t irow = 0; irow < a.GetNrows(); irow++) {
-        const Int_t sIndex = pRowIndex[irow];
-        const Int_t eIndex = pRowIndex[irow+1];
-        Element sum = 0.0;
-        for (Int_t index = sIndex; index < eIndex; index++) {
-           const Int_t icol = pColIndex[index];
-           sum += mp[index]*sp[icol];
-        }
-        tp[irow] += scalar * sum;
-      }
-   }
+   SparseMult(a,source.GetMatrixArray(),target.GetMatrixArray(),scalar);
 
    return target;
 }
@@ -121,19 +121,12 @@ endif
 distclean::     distclean-$(MODNAME)
 
 ##### extra rules ######
-$(MINUIT2O): CXXFLAGS += -DWARNINGMSG -DUSE_ROOT_ERROR
+$(MINUIT2O): CXXFLAGS += -DWARNINGMSG -DUSE_ROOT_ERROR -DMINUIT2_THREADPOOL
 $(MINUIT2DO): CXXFLAGS += -DWARNINGMSG -DUSE_ROOT_ERROR
 #for thread -safet
 #$(MINUIT2O): CXXFLAGS += -DMINUIT2_THREAD_SAFE
-# for openMP 
+# for MPI
 ifneq ($(USE_PARALLEL_MINUIT2),)
-ifneq ($(USE_OPENMP),)
-#$(MINUIT2O): CXXFLAGS += -DMINUIT2_THREAD_SAFE -DMINUIT2_PARALLEL_OPENMP
-#math/minuit2/src/Numerical2PGradientCalculator.o: 
-$(MINUIT2O):CXXFLAGS +=  -D_GLIBCXX_PARALLEL -fopenmp 
-$(MINUIT2DO):CXXFLAGS +=  -D_GLIBCXX_PARALLEL -fopenmp 
-$(MINUIT2LIB):LDFLAGS += -fopenmp
-endif
 ifneq ($(USE_MPI),)
 $(MINUIT2O): CXX=mpic++ -DMPIPROC
 $(MINUIT2DO): CXX=mpic++ 
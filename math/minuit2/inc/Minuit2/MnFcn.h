@@ -42,6 +42,13 @@ public:
   virtual double operator()(const MnAlgebraicVector&) const;
   unsigned int NumOfCalls() const {return fNumCall;}
 
+  /// evaluate the function without counting the call. It can be called concurrently 
+  /// by several threads (for a thread safe FCN); the calls are then counted with AddCalls
+  virtual double Eval(const MnAlgebraicVector&) const;
+
+  /// add ncalls function calls to the counter 
+  void AddCalls(unsigned int ncalls) const { fNumCall += ncalls; }
+
   //
   //forward interface
   //
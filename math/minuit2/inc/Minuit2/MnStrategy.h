@@ -48,6 +48,8 @@ public:
    unsigned int HessianGradientNCycles() const {return fHessGradNCyc;}
 
    int StorageLevel() const { return fStoreLevel; }
+
+   unsigned int NThreads() const { return fNThreads; }
  
    bool IsLow() const {return fStrategy == 0;}
    bool IsMedium() const {return fStrategy == 1;}
@@ -69,6 +71,12 @@ public:
    // set storage level of iteration quantities 
    // 0 = store only last iterations 1 = full storage (default)
    void SetStorageLevel(unsigned int level) { fStoreLevel = level; }
+
+   // set number of threads used for computing the numerical derivatives 
+   // (gradient components and Hessian elements) with respect to the different parameters: 
+   // 1 = sequential computation (default), 0 = use all the cores. 
+   // The FCN must be thread safe when using more than one thread (see MnTaskRunner)
+   void SetNThreads(unsigned int nthreads) { fNThreads = nthreads; }
 private:
 
    unsigned int fStrategy;
@@ -81,6 +89,7 @@ private:
    double fHessTlrG2;
    unsigned int fHessGradNCyc;
    int fStoreLevel; 
+   unsigned int fNThreads; 
 };
 
   }  // namespace Minuit2
@@ -0,0 +1,61 @@
+// @(#)root/minuit2:$Id$
+// Authors: M. Winkler, F. James, L. Moneta, A. Zsenei   2003-2005  
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2005 LCG ROOT Math team,  CERN/PH-SFT                *
+ *                                                                    *
+ **********************************************************************/
+
+#ifndef ROOT_Minuit2_MnTaskRunner
+#define ROOT_Minuit2_MnTaskRunner
+
+namespace ROOT {
+
+   namespace Minuit2 {
+
+//_________________________________________________________________________
+/** 
+    Execution of independent tasks, like the derivatives with respect to the 
+    different parameters, by several threads. 
+    The threads are the ones of ROOT::Math::ThreadPool, available when Minuit2 
+    is built within ROOT; otherwise (or with MN_USE_STACK_ALLOC, which is not 
+    thread safe) the tasks are always executed sequentially. 
+    The number of threads is the one of MnStrategy::NThreads(): with 1 (the default) 
+    the tasks are executed in order by the calling thread. 
+    With several threads the FCN is called concurrently and must be thread safe. 
+ */
+
+class MnTaskRunner {
+
+public:
+
+   /// interface for the tasks executed by Run
+   class Task { 
+   public:
+      virtual ~Task() {}
+      /// execute the task itask; called concurrently for different itask
+      virtual void Execute(unsigned int itask) = 0; 
+   };
+
+   /// nthreads = number of threads (0 = all the cores)
+   explicit MnTaskRunner(unsigned int nthreads) : fNThreads(nthreads) {}
+
+   ~MnTaskRunner() {}
+
+   /// return true if the tasks can be executed by several threads
+   bool IsParallel() const;
+
+   /// execute the tasks 0 ... ntasks-1 and return when all of them are done
+   void Run(Task & task, unsigned int ntasks) const;
+
+private:
+
+   unsigned int fNThreads;
+};
+
+  }  // namespace Minuit2
+
+}  // namespace ROOT
+
+#endif  // ROOT_Minuit2_MnTaskRunner
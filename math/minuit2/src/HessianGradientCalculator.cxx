@@ -15,8 +15,10 @@
 #include "Minuit2/MinimumParameters.h"
 #include "Minuit2/FunctionGradient.h"
 #include "Minuit2/MnStrategy.h"
+#include "Minuit2/MnTaskRunner.h"
 
 #include <math.h>
+#include <vector>
 
 //#define DEBUG
 
@@ -31,6 +33,95 @@ namespace ROOT {
    namespace Minuit2 {
 
 
+/**
+   task computing the refined derivative with respect to one parameter (parameter = offset + task number). 
+   Each task uses its own copy of the parameter vector and counts its function calls, so that 
+   the tasks can be executed concurrently
+ */
+class HessianGradientTask : public MnTaskRunner::Task { 
+
+public: 
+
+   HessianGradientTask(const HessianGradientCalculator & calc, const MnAlgebraicVector & x, const MnAlgebraicVector & g2, 
+                       double dfmin, unsigned int offset, 
+                       MnAlgebraicVector & grd, MnAlgebraicVector & gstep, MnAlgebraicVector & dgrd, 
+                       std::vector<unsigned int> & ncalls) : 
+      fCalc(calc), fX(x), fG2(g2), fDfmin(dfmin), fOffset(offset), 
+      fGrd(grd), fGstep(gstep), fDgrd(dgrd), fNCalls(ncalls) 
+   {}
+
+   void Execute(unsigned int itask); 
+
+private: 
+
+   const HessianGradientCalculator & fCalc; 
+   const MnAlgebraicVector & fX; 
+   const MnAlgebraicVector & fG2; 
+   double fDfmin; 
+   unsigned int fOffset; 
+   MnAlgebraicVector & fGrd; 
+   MnAlgebraicVector & fGstep; 
+   MnAlgebraicVector & fDgrd; 
+   std::vector<unsigned int> & fNCalls; 
+};
+
+void HessianGradientTask::Execute(unsigned int itask) { 
+   // compute the derivative with respect to the parameter i 
+   unsigned int i = fOffset + itask; 
+   const MnMachinePrecision & prec = fCalc.Precision(); 
+   const MnFcn & fcn = fCalc.Fcn(); 
+
+   MnAlgebraicVector x = fX; 
+
+   double xtf = x(i);
+   double dmin = 4.*prec.Eps2()*(xtf + prec.Eps2());
+   double epspri = prec.Eps2() + fabs(fGrd(i)*prec.Eps2());
+   double optstp = sqrt(fDfmin/(fabs(fG2(i))+epspri));
+   double d = 0.2*fabs(fGstep(i));
+   if(d > optstp) d = optstp;
+   if(d < dmin) d = dmin;
+   double chgold = 10000.;
+   double dgmin = 0.;
+   double grdold = 0.;
+   double grdnew = 0.;
+   unsigned int ncalls = 0; 
+   for(unsigned int j = 0; j < fCalc.Ncycle(); j++)  {
+      x(i) = xtf + d;
+      double fs1 = fcn.Eval(x);
+      x(i) = xtf - d;
+      double fs2 = fcn.Eval(x);
+      x(i) = xtf;
+      ncalls += 2; 
+      //       double sag = 0.5*(fs1+fs2-2.*fcnmin);
+      //LM: should I calculate also here second derivatives ???
+
+      grdold = fGrd(i);
+      grdnew = (fs1-fs2)/(2.*d);
+      dgmin = prec.Eps()*(fabs(fs1) + fabs(fs2))/d;
+      //if(fabs(grdnew) < Precision().Eps()) break;
+      if (grdnew == 0) break; 
+      double change = fabs((grdold-grdnew)/grdnew);
+      if(change > chgold && j > 1) break;
+      chgold = change;
+      fGrd(i) = grdnew;
+      //LM : update also the step sizes
+      fGstep(i) = d; 
+
+      if(change < 0.05) break;
+      if(fabs(grdold-grdnew) < dgmin) break;
+      if(d < dmin) break;
+      d *= 0.2;
+   }  
+   fNCalls[itask] = ncalls; 
+
+   fDgrd(i) = std::max(dgmin, fabs(grdold-grdnew));
+
+#ifdef DEBUG
+   std::cout << "HGC Param : " << i << "\t new g1 = " << fGrd(i) << " gstep = " << d << " dgrd = " << fDgrd(i) << std::endl;
+#endif
+}
+
+
 FunctionGradient HessianGradientCalculator::operator()(const MinimumParameters& par) const {
    // use initial gradient as starting point
    InitialGradientCalculator gc(fFcn, fTransformation, fStrategy);
@@ -89,53 +180,15 @@ std::pair<FunctionGradient, MnAlgebraicVector> HessianGradientCalculator::DeltaG
    // initial starting values
    unsigned int startElementIndex = mpiproc.StartElementIndex();
    unsigned int endElementIndex = mpiproc.EndElementIndex();
-
-   for(unsigned int i = startElementIndex; i < endElementIndex; i++) {
-      double xtf = x(i);
-      double dmin = 4.*Precision().Eps2()*(xtf + Precision().Eps2());
-      double epspri = Precision().Eps2() + fabs(grd(i)*Precision().Eps2());
-      double optstp = sqrt(dfmin/(fabs(g2(i))+epspri));
-      double d = 0.2*fabs(gstep(i));
-      if(d > optstp) d = optstp;
-      if(d < dmin) d = dmin;
-      double chgold = 10000.;
-      double dgmin = 0.;
-      double grdold = 0.;
-      double grdnew = 0.;
-      for(unsigned int j = 0; j < Ncycle(); j++)  {
-         x(i) = xtf + d;
-         double fs1 = Fcn()(x);
-         x(i) = xtf - d;
-         double fs2 = Fcn()(x);
-         x(i) = xtf;
-         //       double sag = 0.5*(fs1+fs2-2.*fcnmin);
-         //LM: should I calculate also here second derivatives ???
-
-         grdold = grd(i);
-         grdnew = (fs1-fs2)/(2.*d);
-         dgmin = Precision().Eps()*(fabs(fs1) + fabs(fs2))/d;
-         //if(fabs(grdnew) < Precision().Eps()) break;
-         if (grdnew == 0) break; 
-         double change = fabs((grdold-grdnew)/grdnew);
-         if(change > chgold && j > 1) break;
-         chgold = change;
-         grd(i) = grdnew;
-         //LM : update also the step sizes
-         gstep(i) = d; 
-
-         if(change < 0.05) break;
-         if(fabs(grdold-grdnew) < dgmin) break;
-         if(d < dmin) break;
-         d *= 0.2;
-      }  
-
-      dgrd(i) = std::max(dgmin, fabs(grdold-grdnew));
-
-#ifdef DEBUG
-      std::cout << "HGC Param : " << i << "\t new g1 = " << grd(i) << " gstep = " << d << " dgrd = " << dgrd(i) << std::endl;
-#endif
-
-   }
+   unsigned int nelem = endElementIndex - startElementIndex; 
+
+   // compute the derivatives with respect to the different parameters, in parallel 
+   // when the strategy requires several threads 
+   std::vector<unsigned int> ncalls(nelem); 
+   HessianGradientTask task(*this, x, g2, dfmin, startElementIndex, grd, gstep, dgrd, ncalls); 
+   MnTaskRunner(Strategy().NThreads()).Run(task, nelem); 
+   for (unsigned int i = 0; i < nelem; ++i) 
+      Fcn().AddCalls(ncalls[i]); 
    
    mpiproc.SyncVector(grd);
    mpiproc.SyncVector(gstep);
@@ -75,6 +75,16 @@ int ControlPrintLevel( ) { return -1;}
 void RestoreGlobalPrintLevel(int ) {} 
 #endif      
 
+   // set in the strategy the number of threads used for the numerical derivatives 
+   // from the extra option "NThreads" of Minuit2 (see MnStrategy::SetNThreads)
+void SetStrategyNThreads(ROOT::Minuit2::MnStrategy & strategy) { 
+   ROOT::Math::IOptions * minuit2Opt = ROOT::Math::MinimizerOptions::FindDefault("Minuit2");
+   if (!minuit2Opt) return; 
+   int nthreads = strategy.NThreads(); 
+   if (minuit2Opt->GetValue("NThreads",nthreads) && nthreads >= 0) 
+      strategy.SetNThreads(nthreads); 
+}
+
       
 
 
@@ -459,6 +469,8 @@ bool Minuit2Minimizer::Minimize() {
       int storageLevel = 1; 
       bool ret = minuit2Opt->GetValue("StorageLevel",storageLevel);
       if (ret) SetStorageLevel(storageLevel);
+
+      SetStrategyNThreads(strategy);
       
    }
 
@@ -795,7 +807,9 @@ bool Minuit2Minimizer::GetMinosError(unsigned int i, double & errLow, double & e
    if (Precision() > 0) fState.SetPrecision(Precision());
 
 
-   ROOT::Minuit2::MnMinos minos( *fMinuitFCN, *fMinimum);
+   ROOT::Minuit2::MnStrategy minosStrategy(1);
+   SetStrategyNThreads(minosStrategy);
+   ROOT::Minuit2::MnMinos minos( *fMinuitFCN, *fMinimum, minosStrategy);
 
    // run MnCross 
    MnCross low;
@@ -978,7 +992,9 @@ bool Minuit2Minimizer::Contour(unsigned int ipar, unsigned int jpar, unsigned in
    if (Precision() > 0) fState.SetPrecision(Precision());
 
    // eventually one should specify tolerance in contours 
-   MnContours contour(*fMinuitFCN, *fMinimum, Strategy() ); 
+   ROOT::Minuit2::MnStrategy strategy(Strategy());
+   SetStrategyNThreads(strategy);
+   MnContours contour(*fMinuitFCN, *fMinimum, strategy ); 
    
    if (prev_level > -2) RestoreGlobalPrintLevel(prev_level);
 
@@ -1020,7 +1036,9 @@ bool Minuit2Minimizer::Hesse( ) {
    // set the precision if needed
    if (Precision() > 0) fState.SetPrecision(Precision());
 
-   ROOT::Minuit2::MnHesse hesse( strategy );
+   ROOT::Minuit2::MnStrategy hesseStrategy(strategy);
+   SetStrategyNThreads(hesseStrategy);
+   ROOT::Minuit2::MnHesse hesse( hesseStrategy );
 
    // case when function minimum exists
    if (fMinimum  ) { 
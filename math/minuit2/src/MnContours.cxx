@@ -73,7 +73,10 @@ ContoursError MnContours::Contour(unsigned int px, unsigned int py, unsigned int
    }
    std::pair<double,double> ey = mey();
    
-   MnMigrad migrad(fFCN, fMinimum.UserState(), MnStrategy(std::max(0, int(fStrategy.Strategy()-1))));
+   // use a lower strategy, keeping the number of threads
+   MnStrategy migradStrategy(std::max(0, int(fStrategy.Strategy()-1)));
+   migradStrategy.SetNThreads(fStrategy.NThreads());
+   MnMigrad migrad(fFCN, fMinimum.UserState(), migradStrategy);
    
    migrad.Fix(px);
    migrad.SetValue(px, valx + ex.second);
@@ -93,7 +96,7 @@ ContoursError MnContours::Contour(unsigned int px, unsigned int py, unsigned int
    }
    
    
-   MnMigrad migrad1(fFCN, fMinimum.UserState(), MnStrategy(std::max(0, int(fStrategy.Strategy()-1))));
+   MnMigrad migrad1(fFCN, fMinimum.UserState(), migradStrategy);
    migrad1.Fix(py);
    migrad1.SetValue(py, valy + ey.second);
    FunctionMinimum eyx_up = migrad1();
@@ -23,6 +23,11 @@ MnFcn::~MnFcn() {
 double MnFcn::operator()(const MnAlgebraicVector& v) const {
    // evaluate FCN converting from from MnAlgebraicVector to std::vector
    fNumCall++;
+   return Eval(v);
+}
+
+double MnFcn::Eval(const MnAlgebraicVector& v) const {
+   // evaluate FCN converting from from MnAlgebraicVector to std::vector, without counting the call
    return fFCN(MnVectorTransform()(v));
 }
 
@@ -18,6 +18,9 @@
 #include "Minuit2/MinimumState.h"
 #include "Minuit2/VariableMetricEDMEstimator.h"
 #include "Minuit2/FunctionMinimum.h"
+#include "Minuit2/MnTaskRunner.h"
+
+#include <vector>
 
 //#define DEBUG
 
@@ -32,6 +35,179 @@ namespace ROOT {
    namespace Minuit2 {
 
 
+/**
+   task computing the second derivative (diagonal element of the Hessian) with respect to 
+   one parameter (parameter = task number), with the function values and steps used for the 
+   off-diagonal elements. It uses its own copy of the parameter vector and counts its function calls, 
+   so that the tasks can be executed concurrently. 
+   Failed is set when the second derivative is zero.
+ */
+class MnHesseDiagonalTask : public MnTaskRunner::Task { 
+
+public: 
+
+   MnHesseDiagonalTask(const MnHesse & hesse, const MnFcn & mfcn, const MnUserTransformation & trafo, 
+                       const MnAlgebraicVector & x, double amin, double aimsag, 
+                       MnAlgebraicVector & g2, MnAlgebraicVector & gst, MnAlgebraicVector & grd, 
+                       MnAlgebraicVector & dirin, MnAlgebraicVector & yy, 
+                       std::vector<unsigned int> & ncalls, std::vector<int> & failed) : 
+      fHesse(hesse), fFcn(mfcn), fTrafo(trafo), fX(x), fAmin(amin), fAimsag(aimsag), 
+      fG2(g2), fGst(gst), fGrd(grd), fDirin(dirin), fYy(yy), fNCalls(ncalls), fFailed(failed) 
+   {}
+
+   void Execute(unsigned int i); 
+
+private: 
+
+   const MnHesse & fHesse; 
+   const MnFcn & fFcn; 
+   const MnUserTransformation & fTrafo; 
+   const MnAlgebraicVector & fX; 
+   double fAmin; 
+   double fAimsag; 
+   MnAlgebraicVector & fG2; 
+   MnAlgebraicVector & fGst; 
+   MnAlgebraicVector & fGrd; 
+   MnAlgebraicVector & fDirin; 
+   MnAlgebraicVector & fYy; 
+   std::vector<unsigned int> & fNCalls; 
+   std::vector<int> & fFailed; 
+};
+
+void MnHesseDiagonalTask::Execute(unsigned int i) { 
+   // compute the second derivative with respect to the parameter i 
+
+   const MnMachinePrecision& prec = fTrafo.Precision();
+   MnAlgebraicVector x = fX; 
+
+   double xtf = x(i);
+   double dmin = 8.*prec.Eps2()*(fabs(xtf) + prec.Eps2());
+   double d = fabs(fGst(i));
+   if(d < dmin) d = dmin;
+
+#ifdef DEBUG
+   std::cout << "\nDerivative parameter  " << i << " d = " << d << " dmin = " << dmin << std::endl;
+#endif
+
+   unsigned int ncalls = 0; 
+   for(unsigned int icyc = 0; icyc < fHesse.Ncycles(); icyc++) {
+      double sag = 0.;
+      double fs1 = 0.;
+      double fs2 = 0.;
+      for(unsigned int multpy = 0; multpy < 5; multpy++) {
+         x(i) = xtf + d;
+         fs1 = fFcn.Eval(x);
+         x(i) = xtf - d;
+         fs2 = fFcn.Eval(x);
+         x(i) = xtf;
+         ncalls += 2; 
+         sag = 0.5*(fs1+fs2-2.*fAmin);
+
+#ifdef DEBUG
+         std::cout << "cycle " << icyc << " mul " << multpy << "\t sag = " << sag << " d = " << d << std::endl; 
+#endif
+         //  Now as F77 Minuit - check taht sag is not zero
+         if (sag != 0) break; 
+         if(fTrafo.Parameter(i).HasLimits()) {
+            if(d > 0.5) break;
+            d *= 10.;
+            if(d > 0.5) d = 0.51;
+            continue;
+         }
+         d *= 10.;
+      }
+      if (sag == 0) { 
+         // 2nd derivative is zero 
+         fNCalls[i] = ncalls; 
+         fFailed[i] = 1; 
+         return; 
+      }
+         
+      double g2bfor = fG2(i);
+      fG2(i) = 2.*sag/(d*d);
+      fGrd(i) = (fs1-fs2)/(2.*d);
+      fGst(i) = d;
+      fDirin(i) = d;
+      fYy(i) = fs1;
+      double dlast = d;
+      d = sqrt(2.*fAimsag/fabs(fG2(i)));
+      if(fTrafo.Parameter(i).HasLimits()) d = std::min(0.5, d);
+      if(d < dmin) d = dmin;
+
+#ifdef DEBUG
+      std::cout << "\t g1 = " << fGrd(i) << " g2 = " << fG2(i) << " step = " << fGst(i) << " d = " << d 
+                << " diffd = " <<  fabs(d-dlast)/d << " diffg2 = " << fabs(fG2(i)-g2bfor)/fG2(i) << std::endl;
+#endif
+
+         
+      // see if converged
+      if(fabs((d-dlast)/d) < fHesse.Tolerstp()) break;
+      if(fabs((fG2(i)-g2bfor)/fG2(i)) < fHesse.TolerG2()) break; 
+      d = std::min(d, 10.*dlast);
+      d = std::max(d, 0.1*dlast);   
+   }
+   fNCalls[i] = ncalls; 
+   fFailed[i] = 0; 
+}
+
+/**
+   task computing the off-diagonal elements of the Hessian of one row (row = task number), 
+   restricted to the elements of index (in the row-major order of the upper triangle) in [begin, end). 
+   It uses its own copy of the parameter vector and counts its function calls, so that 
+   the tasks can be executed concurrently
+ */
+class MnHesseOffDiagonalTask : public MnTaskRunner::Task { 
+
+public: 
+
+   MnHesseOffDiagonalTask(const MnFcn & mfcn, const MnAlgebraicVector & x, double amin, 
+                          const MnAlgebraicVector & dirin, const MnAlgebraicVector & yy, 
+                          unsigned int begin, unsigned int end, 
+                          MnAlgebraicSymMatrix & vhmat, std::vector<unsigned int> & ncalls) : 
+      fFcn(mfcn), fX(x), fAmin(amin), fDirin(dirin), fYy(yy), fBegin(begin), fEnd(end), 
+      fVhmat(vhmat), fNCalls(ncalls) 
+   {}
+
+   void Execute(unsigned int i); 
+
+private: 
+
+   const MnFcn & fFcn; 
+   const MnAlgebraicVector & fX; 
+   double fAmin; 
+   const MnAlgebraicVector & fDirin; 
+   const MnAlgebraicVector & fYy; 
+   unsigned int fBegin; 
+   unsigned int fEnd; 
+   MnAlgebraicSymMatrix & fVhmat; 
+   std::vector<unsigned int> & fNCalls; 
+};
+
+void MnHesseOffDiagonalTask::Execute(unsigned int i) { 
+   // compute the elements (i,j) with j > i
+   unsigned int n = fX.size(); 
+   // index of element (i,i+1)
+   unsigned int first = i*(n-1) - (i*(i-1))/2; 
+   unsigned int ncalls = 0; 
+   MnAlgebraicVector x = fX; 
+   x(i) += fDirin(i);
+   for (unsigned int j = i+1; j < n; j++) { 
+      unsigned int in = first + j - i - 1; 
+      if (in < fBegin || in >= fEnd) continue; 
+
+      x(j) += fDirin(j);
+      
+      double fs1 = fFcn.Eval(x);
+      ncalls++; 
+      double elem = (fs1 + fAmin - fYy(i) - fYy(j))/(fDirin(i)*fDirin(j));
+      fVhmat(i,j) = elem;
+      
+      x(j) -= fDirin(j);
+   }
+   fNCalls[i] = ncalls; 
+}
+
+
 MnUserParameterState MnHesse::operator()(const FCNBase& fcn, const std::vector<double>& par, const std::vector<double>& err, unsigned int maxcalls) const { 
    // interface from vector of params and errors
    return (*this)(fcn, MnUserParameterState(par, err), maxcalls);
@@ -126,46 +302,22 @@ MinimumState MnHesse::operator()(const MnFcn& mfcn, const MinimumState& st, cons
    std::cout << " Gradient is analytical  " << st.Gradient().IsAnalytical() << std::endl;
 #endif
 
+
+   // the second derivatives with respect to the different parameters are computed in parallel 
+   // when the strategy requires several threads, otherwise sequentially stopping at the 
+   // first failure or when the maximum number of calls is exceeded 
+   MnTaskRunner runner(fStrategy.NThreads()); 
+   std::vector<unsigned int> ncalls(n); 
+   std::vector<int> failed(n); 
+   MnHesseDiagonalTask diagTask(*this, mfcn, trafo, x, amin, aimsag, g2, gst, grd, dirin, yy, ncalls, failed); 
+   if (runner.IsParallel() ) runner.Run(diagTask, n); 
    
    for(unsigned int i = 0; i < n; i++) {
-      
-      double xtf = x(i);
-      double dmin = 8.*prec.Eps2()*(fabs(xtf) + prec.Eps2());
-      double d = fabs(gst(i));
-      if(d < dmin) d = dmin;
-
-#ifdef DEBUG
-      std::cout << "\nDerivative parameter  " << i << " d = " << d << " dmin = " << dmin << std::endl;
-#endif
 
-      
-      for(unsigned int icyc = 0; icyc < Ncycles(); icyc++) {
-         double sag = 0.;
-         double fs1 = 0.;
-         double fs2 = 0.;
-         for(unsigned int multpy = 0; multpy < 5; multpy++) {
-            x(i) = xtf + d;
-            fs1 = mfcn(x);
-            x(i) = xtf - d;
-            fs2 = mfcn(x);
-            x(i) = xtf;
-            sag = 0.5*(fs1+fs2-2.*amin);
+      if (!runner.IsParallel() ) diagTask.Execute(i); 
+      mfcn.AddCalls(ncalls[i]); 
 
-#ifdef DEBUG
-            std::cout << "cycle " << icyc << " mul " << multpy << "\t sag = " << sag << " d = " << d << std::endl; 
-#endif
-            //  Now as F77 Minuit - check taht sag is not zero
-            if (sag != 0) goto L30; // break
-            if(trafo.Parameter(i).HasLimits()) {
-               if(d > 0.5) goto L26;
-               d *= 10.;
-               if(d > 0.5) d = 0.51;
-               continue;
-            }
-            d *= 10.;
-         }
-         
-L26:  
+      if (failed[i]) { 
 #ifdef WARNINGMSG
 
          // get parameter name for i
@@ -183,31 +335,8 @@ L26:
          }
          
          return MinimumState(st.Parameters(), MinimumError(vhmat, MinimumError::MnHesseFailed()), st.Gradient(), st.Edm(), mfcn.NumOfCalls());
-         
-L30:      
-            double g2bfor = g2(i);
-         g2(i) = 2.*sag/(d*d);
-         grd(i) = (fs1-fs2)/(2.*d);
-         gst(i) = d;
-         dirin(i) = d;
-         yy(i) = fs1;
-         double dlast = d;
-         d = sqrt(2.*aimsag/fabs(g2(i)));
-         if(trafo.Parameter(i).HasLimits()) d = std::min(0.5, d);
-         if(d < dmin) d = dmin;
-
-#ifdef DEBUG
-         std::cout << "\t g1 = " << grd(i) << " g2 = " << g2(i) << " step = " << gst(i) << " d = " << d 
-                   << " diffd = " <<  fabs(d-dlast)/d << " diffg2 = " << fabs(g2(i)-g2bfor)/g2(i) << std::endl;
-#endif
-
-         
-         // see if converged
-         if(fabs((d-dlast)/d) < Tolerstp()) break;
-         if(fabs((g2(i)-g2bfor)/g2(i)) < TolerG2()) break; 
-         d = std::min(d, 10.*dlast);
-         d = std::max(d, 0.1*dlast);   
       }
+
       vhmat(i,i) = g2(i);
       if(mfcn.NumOfCalls()  > maxcalls) {
          
@@ -246,31 +375,14 @@ L30:
    unsigned int startParIndexOffDiagonal = mpiprocOffDiagonal.StartElementIndex();
    unsigned int endParIndexOffDiagonal = mpiprocOffDiagonal.EndElementIndex();
 
-   unsigned int offsetVect = 0;
-   for (unsigned int in = 0; in<startParIndexOffDiagonal; in++)
-      if ((in+offsetVect)%(n-1)==0) offsetVect += (in+offsetVect)/(n-1);
-
-   for (unsigned int in = startParIndexOffDiagonal;
-        in<endParIndexOffDiagonal; in++) {
-
-      int i = (in+offsetVect)/(n-1);
-      if ((in+offsetVect)%(n-1)==0) offsetVect += i;
-      int j = (in+offsetVect)%(n-1)+1;
-
-      if ((i+1)==j || in==startParIndexOffDiagonal)
-         x(i) += dirin(i);
-      
-      x(j) += dirin(j);
-      
-      double fs1 = mfcn(x);
-      double elem = (fs1 + amin - yy(i) - yy(j))/(dirin(i)*dirin(j));
-      vhmat(i,j) = elem;
-      
-      x(j) -= dirin(j);
-      
-      if (j%(n-1)==0 || in==endParIndexOffDiagonal-1)
-         x(i) -= dirin(i);
-      
+   // one task per row, in parallel when the strategy requires several threads
+   if (n > 1) { 
+      std::vector<unsigned int> ncallsOffDiagonal(n-1); 
+      MnHesseOffDiagonalTask offDiagTask(mfcn, x, amin, dirin, yy, startParIndexOffDiagonal, endParIndexOffDiagonal, 
+                                         vhmat, ncallsOffDiagonal); 
+      runner.Run(offDiagTask, n-1); 
+      for (unsigned int i = 0; i < n-1; i++) 
+         mfcn.AddCalls(ncallsOffDiagonal[i]); 
    }
    
    mpiprocOffDiagonal.SyncSymMatrixOffDiagonal(vhmat);
@@ -0,0 +1,64 @@
+// @(#)root/minuit2:$Id$
+// Authors: M. Winkler, F. James, L. Moneta, A. Zsenei   2003-2005  
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2005 LCG ROOT Math team,  CERN/PH-SFT                *
+ *                                                                    *
+ **********************************************************************/
+
+#include "Minuit2/MnTaskRunner.h"
+
+#if defined(MINUIT2_THREADPOOL) && !defined(MN_USE_STACK_ALLOC)
+#define MN_USE_THREADPOOL
+#include "Math/ThreadPool.h"
+#endif
+
+namespace ROOT {
+
+   namespace Minuit2 {
+
+#ifdef MN_USE_THREADPOOL
+
+// adapter of a MnTaskRunner::Task to the ThreadPool interface
+class MnThreadPoolTask : public ROOT::Math::ThreadPool::ITask { 
+public:
+   MnThreadPoolTask(MnTaskRunner::Task & task) : fTask(task) {}
+   void Execute(unsigned int itask) { fTask.Execute(itask); }
+private:
+   MnTaskRunner::Task & fTask; 
+};
+
+bool MnTaskRunner::IsParallel() const { 
+   // parallel execution when more than one thread is requested
+   return fNThreads != 1; 
+}
+
+void MnTaskRunner::Run(Task & task, unsigned int ntasks) const { 
+   // execute the tasks using the threads of the ROOT::Math::ThreadPool
+   if (!IsParallel() || ntasks < 2) { 
+      for (unsigned int i = 0; i < ntasks; ++i) task.Execute(i); 
+      return; 
+   }
+   unsigned int nthreads = (fNThreads == 0) ? ROOT::Math::ThreadPool::NCores() : fNThreads; 
+   MnThreadPoolTask poolTask(task); 
+   ROOT::Math::ThreadPool::Run(poolTask, ntasks, nthreads); 
+}
+
+#else
+
+bool MnTaskRunner::IsParallel() const { 
+   // no threads available 
+   return false; 
+}
+
+void MnTaskRunner::Run(Task & task, unsigned int ntasks) const { 
+   // execute the tasks sequentially
+   for (unsigned int i = 0; i < ntasks; ++i) task.Execute(i); 
+}
+
+#endif
+
+   }  // namespace Minuit2
+
+}  // namespace ROOT
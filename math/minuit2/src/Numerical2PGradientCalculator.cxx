@@ -15,21 +15,16 @@
 #include "Minuit2/MinimumParameters.h"
 #include "Minuit2/FunctionGradient.h"
 #include "Minuit2/MnStrategy.h"
+#include "Minuit2/MnTaskRunner.h"
 
 
 //#define DEBUG
 #if defined(DEBUG) || defined(WARNINGMSG)
 #include "Minuit2/MnPrint.h" 
-#ifdef _OPENMP
-#include <omp.h>
-#include <iomanip>
-#ifdef DEBUG
-#define DEBUG_MP
-#endif
-#endif
 #endif
 
 #include <math.h>
+#include <vector>
 
 #include "Minuit2/MPIProcess.h"
 
@@ -38,6 +33,113 @@ namespace ROOT {
    namespace Minuit2 {
 
 
+/**
+   task computing the derivative with respect to one parameter (parameter = offset + task number). 
+   Each task uses its own copy of the parameter vector and counts its function calls, so that 
+   the tasks can be executed concurrently
+ */
+class Numerical2PGradientTask : public MnTaskRunner::Task { 
+
+public: 
+
+   Numerical2PGradientTask(const Numerical2PGradientCalculator & calc, const MinimumParameters & par, 
+                           double dfmin, double vrysml, unsigned int offset, 
+                           MnAlgebraicVector & grd, MnAlgebraicVector & g2, MnAlgebraicVector & gstep, 
+                           std::vector<unsigned int> & ncalls) : 
+      fCalc(calc), fPar(par), fDfmin(dfmin), fVrysml(vrysml), fOffset(offset), 
+      fGrd(grd), fG2(g2), fGstep(gstep), fNCalls(ncalls) 
+   {}
+
+   void Execute(unsigned int itask); 
+
+private: 
+
+   const Numerical2PGradientCalculator & fCalc; 
+   const MinimumParameters & fPar; 
+   double fDfmin; 
+   double fVrysml; 
+   unsigned int fOffset; 
+   MnAlgebraicVector & fGrd; 
+   MnAlgebraicVector & fG2; 
+   MnAlgebraicVector & fGstep; 
+   std::vector<unsigned int> & fNCalls; 
+};
+
+void Numerical2PGradientTask::Execute(unsigned int itask) { 
+   // compute the derivative with respect to the parameter i 
+   unsigned int i = fOffset + itask; 
+   
+   double fcnmin = fPar.Fval();
+   double eps2 = fCalc.Precision().Eps2(); 
+   const MnFcn & fcn = fCalc.Fcn(); 
+   const MnUserTransformation & trafo = fCalc.Trafo(); 
+
+   MnAlgebraicVector x = fPar.Vec();
+
+   double xtf = x(i);
+   double epspri = eps2 + fabs(fGrd(i)*eps2);
+   double stepb4 = 0.;
+   unsigned int ncalls = 0; 
+   for(unsigned int j = 0; j < fCalc.Ncycle(); j++)  {
+      double optstp = sqrt(fDfmin/(fabs(fG2(i))+epspri));
+      double step = std::max(optstp, fabs(0.1*fGstep(i)));
+      //       std::cout<<"step: "<<step;
+      if(trafo.Parameter(trafo.ExtOfInt(i)).HasLimits()) {
+         if(step > 0.5) step = 0.5;
+      }
+      double stpmax = 10.*fabs(fGstep(i));
+      if(step > stpmax) step = stpmax;
+      //       std::cout<<" "<<step;
+      double stpmin = std::max(fVrysml, 8.*fabs(eps2*x(i)));
+      if(step < stpmin) step = stpmin;
+      //       std::cout<<" "<<step<<std::endl;
+      //       std::cout<<"step: "<<step<<std::endl;
+      if(fabs((step-stepb4)/step) < fCalc.StepTolerance()) {
+         //  	std::cout<<"(step-stepb4)/step"<<std::endl;
+         //  	std::cout<<"j= "<<j<<std::endl;
+         //  	std::cout<<"step= "<<step<<std::endl;
+         break;
+      }
+      fGstep(i) = step;
+      stepb4 = step;
+      
+      x(i) = xtf + step;
+      double fs1 = fcn.Eval(x);
+      x(i) = xtf - step;
+      double fs2 = fcn.Eval(x);
+      x(i) = xtf;
+      ncalls += 2; 
+      
+      double grdb4 = fGrd(i);
+      fGrd(i) = 0.5*(fs1 - fs2)/step;
+      fG2(i) = (fs1 + fs2 - 2.*fcnmin)/step/step;
+
+#ifdef DEBUG
+      int pr = std::cout.precision(13);
+      std::cout << "cycle " << j << " x " << x(i) << " step " << step << " f1 " << fs1 << " f2 " << fs2 
+                << " grd " << fGrd(i) << " g2 " << fG2(i) << std::endl; 
+      std::cout.precision(pr);
+#endif
+      
+      if(fabs(grdb4-fGrd(i))/(fabs(fGrd(i))+fDfmin/step) < fCalc.GradTolerance())  {
+         //  	std::cout<<"j= "<<j<<std::endl;
+         //  	std::cout<<"step= "<<step<<std::endl;
+         //  	std::cout<<"fs1, fs2: "<<fs1<<" "<<fs2<<std::endl;
+         //  	std::cout<<"fs1-fs2: "<<fs1-fs2<<std::endl;
+         break;
+      }
+   }
+   fNCalls[itask] = ncalls; 
+
+#ifdef DEBUG
+   int pr = std::cout.precision(13);
+   int iext = trafo.ExtOfInt(i);
+   std::cout << "Parameter " << trafo.Name(iext) << " Gradient =   " << fGrd(i) << " g2 = " << fG2(i) << " step " << fGstep(i) << std::endl;
+   std::cout.precision(pr);
+#endif
+}
+
+
 FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParameters& par) const {
    // calculate gradient using Initial gradient calculator and from MinimumParameters object
 
@@ -72,6 +174,8 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const std::vector<dou
 FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParameters& par, const FunctionGradient& Gradient) const {
    // calculate numerical gradient from MinimumParameters object
    // the algorithm takes correctly care when the gradient is approximatly zero
+   // The derivatives with respect to the different parameters are computed in parallel 
+   // when the strategy requires several threads (see MnStrategy::SetNThreads)
    
    //    std::cout<<"########### Numerical2PDerivative"<<std::endl;
    //    std::cout<<"initial grd: "<<Gradient.Grad()<<std::endl;
@@ -94,15 +198,12 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
    //    std::cout << " ncycle " << Ncycle() << std::endl;
    
    unsigned int n = (par.Vec()).size();
-   unsigned int ncycle = Ncycle();
    //   MnAlgebraicVector vgrd(n), vgrd2(n), vgstp(n);
    MnAlgebraicVector grd = Gradient.Grad();
    MnAlgebraicVector g2 = Gradient.G2();
    MnAlgebraicVector gstep = Gradient.Gstep();
 
-#ifndef _OPENMP
    MPIProcess mpiproc(n,0);
-#endif
 
 #ifdef DEBUG
    std::cout << "Calculating Gradient at x =   " << par.Vec() << std::endl;
@@ -111,119 +212,19 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
    std::cout.precision(pr);
 #endif
 
-#ifndef _OPENMP
-   // for serial execution this can be outside the loop
-   MnAlgebraicVector x = par.Vec();
-
    unsigned int startElementIndex = mpiproc.StartElementIndex();
    unsigned int endElementIndex = mpiproc.EndElementIndex();
+   unsigned int nelem = endElementIndex - startElementIndex; 
 
-   for(unsigned int i = startElementIndex; i < endElementIndex; i++) {
-
-#else
+   std::vector<unsigned int> ncalls(nelem); 
+   Numerical2PGradientTask task(*this, par, dfmin, vrysml, startElementIndex, grd, g2, gstep, ncalls); 
+   MnTaskRunner(Strategy().NThreads()).Run(task, nelem); 
+   for (unsigned int i = 0; i < nelem; ++i) 
+      Fcn().AddCalls(ncalls[i]); 
 
- // parallelize this loop using OpenMP
-//#define N_PARALLEL_PAR 5
-#pragma omp parallel
-#pragma omp for 
-//#pragma omp for schedule (static, N_PARALLEL_PAR)
-
-   for(int i = 0; i < int(n); i++) {
-
-#endif
-
-#ifdef DEBUG_MP
-      int ith = omp_get_thread_num();
-      //std::cout << "Thread number " << ith << "  " << i << std::endl;
-#endif
-
-#ifdef _OPENMP
-       // create in loop since each thread will use its own copy
-      MnAlgebraicVector x = par.Vec();
-#endif
-
-      double xtf = x(i);
-      double epspri = eps2 + fabs(grd(i)*eps2);
-      double stepb4 = 0.;
-      for(unsigned int j = 0; j < ncycle; j++)  {
-         double optstp = sqrt(dfmin/(fabs(g2(i))+epspri));
-         double step = std::max(optstp, fabs(0.1*gstep(i)));
-         //       std::cout<<"step: "<<step;
-         if(Trafo().Parameter(Trafo().ExtOfInt(i)).HasLimits()) {
-            if(step > 0.5) step = 0.5;
-         }
-         double stpmax = 10.*fabs(gstep(i));
-         if(step > stpmax) step = stpmax;
-         //       std::cout<<" "<<step;
-         double stpmin = std::max(vrysml, 8.*fabs(eps2*x(i)));
-         if(step < stpmin) step = stpmin;
-         //       std::cout<<" "<<step<<std::endl;
-         //       std::cout<<"step: "<<step<<std::endl;
-         if(fabs((step-stepb4)/step) < StepTolerance()) {
-            //  	std::cout<<"(step-stepb4)/step"<<std::endl;
-            //  	std::cout<<"j= "<<j<<std::endl;
-            //  	std::cout<<"step= "<<step<<std::endl;
-            break;
-         }
-         gstep(i) = step;
-         stepb4 = step;
-         //       MnAlgebraicVector pstep(n);
-         //       pstep(i) = step;
-         //       double fs1 = Fcn()(pstate + pstep);
-         //       double fs2 = Fcn()(pstate - pstep);
-         
-         x(i) = xtf + step;
-         double fs1 = Fcn()(x);
-         x(i) = xtf - step;
-         double fs2 = Fcn()(x);
-         x(i) = xtf;
-         
-         double grdb4 = grd(i);
-         grd(i) = 0.5*(fs1 - fs2)/step;
-         g2(i) = (fs1 + fs2 - 2.*fcnmin)/step/step;
-
-#ifdef DEBUG
-         pr = std::cout.precision(13);
-         std::cout << "cycle " << j << " x " << x(i) << " step " << step << " f1 " << fs1 << " f2 " << fs2 
-                   << " grd " << grd(i) << " g2 " << g2(i) << std::endl; 
-         std::cout.precision(pr);
-#endif
-         
-         if(fabs(grdb4-grd(i))/(fabs(grd(i))+dfmin/step) < GradTolerance())  {
-            //  	std::cout<<"j= "<<j<<std::endl;
-            //  	std::cout<<"step= "<<step<<std::endl;
-            //  	std::cout<<"fs1, fs2: "<<fs1<<" "<<fs2<<std::endl;
-            //  	std::cout<<"fs1-fs2: "<<fs1-fs2<<std::endl;
-            break;
-         }
-      }
-      
-
-#ifdef DEBUG_MP
-#pragma omp critical
-      {
-         std::cout << "Gradient for thread " << ith << "  " << i << "  " << std::setprecision(15)  << grd(i) << "  " << g2(i) << std::endl;
-      }
-#endif
-
-      //     vgrd(i) = grd;
-      //     vgrd2(i) = g2;
-      //     vgstp(i) = gstep;
-
-
-#ifdef DEBUG
-      pr = std::cout.precision(13);
-      int iext = Trafo().ExtOfInt(i);
-      std::cout << "Parameter " << Trafo().Name(iext) << " Gradient =   " << grd(i) << " g2 = " << g2(i) << " step " << gstep(i) << std::endl;
-      std::cout.precision(pr);
-#endif
-   }
-
-#ifndef _OPENMP
    mpiproc.SyncVector(grd);
    mpiproc.SyncVector(g2);
    mpiproc.SyncVector(gstep);
-#endif
 
    return FunctionGradient(grd, g2, gstep);
 }
@@ -53,6 +53,8 @@ namespace ROOT {
 
   namespace Math { 
 
+template <class T, unsigned int N> class SBatch;
+template <class B, unsigned int idim, unsigned int n> class BatchInverter;
 
 
 /** 
@@ -107,6 +109,16 @@ public:
   }
 
 
+  /// inversion of a batch of matrices (see Math/SBatch.h)
+  template <class T, unsigned int N>
+  static bool Dinv(MatRepStd<SBatch<T,N>,idim,n> & rhs) {
+     return BatchInverter<SBatch<T,N>,idim,n>::Dinv(rhs,false);
+  }
+  template <class T, unsigned int N>
+  static bool Dinv(MatRepSym<SBatch<T,N>,idim> & rhs) {
+     return BatchInverter<SBatch<T,N>,idim,n>::Dinv(rhs,false);
+  }
+
   /**
      LU Factorization method for inversion of general square matrices
      (see implementation in Math/MatrixInversion.icc)
@@ -197,6 +209,15 @@ public:
     rhs[0] = 1. / rhs[0];
     return true;
   }
+  /// inversion of a batch of matrices (see Math/SBatch.h)
+  template <class T, unsigned int N>
+  static bool Dinv(MatRepStd<SBatch<T,N>,1,1> & rhs) {
+     return BatchInverter<SBatch<T,N>,1,1>::Dinv(rhs,false);
+  }
+  template <class T, unsigned int N>
+  static bool Dinv(MatRepSym<SBatch<T,N>,1> & rhs) {
+     return BatchInverter<SBatch<T,N>,1,1>::Dinv(rhs,false);
+  }
 };
 
 
@@ -255,6 +276,16 @@ public:
     return true;
   }
 
+  /// inversion of a batch of matrices (see Math/SBatch.h)
+  template <class T, unsigned int N>
+  static bool Dinv(MatRepStd<SBatch<T,N>,2,2> & rhs) {
+     return BatchInverter<SBatch<T,N>,2,2>::Dinv(rhs,false);
+  }
+  template <class T, unsigned int N>
+  static bool Dinv(MatRepSym<SBatch<T,N>,2> & rhs) {
+     return BatchInverter<SBatch<T,N>,2,2>::Dinv(rhs,false);
+  }
+
 };
 
 
@@ -277,6 +308,16 @@ public:
   template <class T>
   static bool Dinv(MatRepSym<T,3> & rhs);
 
+  /// inversion of a batch of matrices (see Math/SBatch.h)
+  template <class T, unsigned int N>
+  static bool Dinv(MatRepStd<SBatch<T,N>,3,3> & rhs) {
+     return BatchInverter<SBatch<T,N>,3,3>::Dinv(rhs,true);
+  }
+  template <class T, unsigned int N>
+  static bool Dinv(MatRepSym<SBatch<T,N>,3> & rhs) {
+     return BatchInverter<SBatch<T,N>,3,3>::Dinv(rhs,true);
+  }
+
 };
 
 /** 
@@ -292,6 +333,16 @@ public:
   template <class T>
   static bool Dinv(MatRepSym<T,4> & rhs);
 
+  /// inversion of a batch of matrices (see Math/SBatch.h)
+  template <class T, unsigned int N>
+  static bool Dinv(MatRepStd<SBatch<T,N>,4,4> & rhs) {
+     return BatchInverter<SBatch<T,N>,4,4>::Dinv(rhs,true);
+  }
+  template <class T, unsigned int N>
+  static bool Dinv(MatRepSym<SBatch<T,N>,4> & rhs) {
+     return BatchInverter<SBatch<T,N>,4,4>::Dinv(rhs,true);
+  }
+
 };
 
 /** 
@@ -307,6 +358,16 @@ public:
   template <class T>
   static bool Dinv(MatRepSym<T,5> & rhs);
 
+  /// inversion of a batch of matrices (see Math/SBatch.h)
+  template <class T, unsigned int N>
+  static bool Dinv(MatRepStd<SBatch<T,N>,5,5> & rhs) {
+     return BatchInverter<SBatch<T,N>,5,5>::Dinv(rhs,true);
+  }
+  template <class T, unsigned int N>
+  static bool Dinv(MatRepSym<SBatch<T,N>,5> & rhs) {
+     return BatchInverter<SBatch<T,N>,5,5>::Dinv(rhs,true);
+  }
+
 };
 
 // inverter for Cholesky
@@ -0,0 +1,409 @@
+// @(#)root/smatrix:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2014 , LCG ROOT MathLib Team                         *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+#ifndef ROOT_Math_SBatch
+#define ROOT_Math_SBatch
+
+#ifndef ROOT_Math_SMatrix
+#include "Math/SMatrix.h"
+#endif
+
+#include <cmath>
+#include <assert.h>
+#include <iostream>
+
+namespace ROOT {
+
+   namespace Math {
+
+//==============================================================================
+// meta_lane: element-wise operations on the lanes of a batch, unrolled at
+// compile time so that the compiler can keep the lanes in SIMD registers
+//==============================================================================
+struct LaneAdd { template <class T> static inline T f(const T& a, const T& b) { return a + b; } };
+struct LaneSub { template <class T> static inline T f(const T& a, const T& b) { return a - b; } };
+struct LaneMul { template <class T> static inline T f(const T& a, const T& b) { return a * b; } };
+struct LaneDiv { template <class T> static inline T f(const T& a, const T& b) { return a / b; } };
+
+template <unsigned int I>
+struct meta_lane {
+   template <class Op, class T>
+   static inline void f(T * ret, const T * lhs, const T * rhs) {
+      meta_lane<I-1>::template f<Op>(ret, lhs, rhs);
+      ret[I-1] = Op::f(lhs[I-1], rhs[I-1]);
+   }
+};
+
+template <>
+struct meta_lane<0> {
+   template <class Op, class T>
+   static inline void f(T * /* ret */, const T * /* lhs */, const T * /* rhs */) {}
+};
+
+//_______________________________________________________________________________
+/**
+    SBatch: a set of N values of type T (the "lanes"), with element-wise
+    arithmetic operations.
+
+    It is used as element type of the SMatrix and SVector classes for operating
+    on a batch of N matrices (or vectors) of the same shape at the same time,
+    for example in a Kalman filter fitting many tracks:
+
+    \code
+    typedef ROOT::Math::SBatch<double,4> B;
+    typedef ROOT::Math::SMatrix<B,5,5,ROOT::Math::MatRepSym<B,5> > BSymMatrix5;
+    BSymMatrix5 cov;
+    ROOT::Math::SMatrix<B,5,5> jac;
+    for (unsigned int itrk = 0; itrk < 4; ++itrk) {
+       ROOT::Math::SetLane(cov, itrk, covariance[itrk]);
+       ROOT::Math::SetLane(jac, itrk, jacobian[itrk]);
+    }
+    BSymMatrix5 cov2 = ROOT::Math::Similarity(jac, cov);
+    bool ok = cov2.InvertFast();
+    \endcode
+
+    The N values of each matrix element are contiguous in memory: a batched
+    matrix stores the N matrices interleaved element by element, and each
+    operation of the SMatrix expression templates is a loop over the N lanes,
+    which the compiler can vectorize with the SIMD instructions. The lane
+    operations are unrolled at compile time (see meta_lane); a number of lanes
+    of two to four times the SIMD register width gives in general the best
+    performances.
+
+    All the expression template operations (+, -, *, /, products, Transpose,
+    Similarity, SimilarityT, Dot, TensorProd...) are supported. Invert,
+    InvertFast and InvertChol and the CholeskyDecomp class work lane by lane:
+    the symmetric matrices are inverted with a vectorized Cholesky
+    decomposition, falling back to the scalar algorithm for the lanes where
+    it fails (not positive definite matrices); the general matrices are
+    inverted lane by lane with the scalar algorithms. They return true only
+    if the inversion succeeded for all the lanes.
+    The comparison operators == and != are true if they hold for all the lanes.
+
+    @ingroup SMatrixGroup
+*/
+template <class T, unsigned int N>
+class SBatch {
+
+public:
+
+   typedef T value_type;
+
+   enum { kSize = N };
+
+   /// default constructor: the values are not initialized
+   SBatch() {}
+
+   /// construct with all the lanes equal to value
+   SBatch(const T & value) {
+      for (unsigned int i = 0; i < N; ++i) fData[i] = value;
+   }
+
+   /// construct from the N values in the range [begin, end)
+   SBatch(const T * begin, const T * end) {
+      assert(begin + N == end);
+      for (unsigned int i = 0; i < N; ++i) fData[i] = begin[i];
+   }
+
+   /// access to the value of the lane i
+   T & operator[](unsigned int i) { return fData[i]; }
+   const T & operator[](unsigned int i) const { return fData[i]; }
+
+   /// access to the array of the values
+   T * Array() { return fData; }
+   const T * Array() const { return fData; }
+
+   /// number of lanes
+   static unsigned int Size() { return N; }
+
+   SBatch & operator+= (const SBatch & rhs) {
+      SBatch ret;
+      meta_lane<N>::template f<LaneAdd>(ret.fData, fData, rhs.fData);
+      return *this = ret;
+   }
+   SBatch & operator-= (const SBatch & rhs) {
+      SBatch ret;
+      meta_lane<N>::template f<LaneSub>(ret.fData, fData, rhs.fData);
+      return *this = ret;
+   }
+   SBatch & operator*= (const SBatch & rhs) {
+      SBatch ret;
+      meta_lane<N>::template f<LaneMul>(ret.fData, fData, rhs.fData);
+      return *this = ret;
+   }
+   SBatch & operator/= (const SBatch & rhs) {
+      SBatch ret;
+      meta_lane<N>::template f<LaneDiv>(ret.fData, fData, rhs.fData);
+      return *this = ret;
+   }
+
+   SBatch operator- () const {
+      SBatch ret;
+      for (unsigned int i = 0; i < N; ++i) ret.fData[i] = -fData[i];
+      return ret;
+   }
+
+private:
+
+   T fData[N];
+
+};
+
+//==============================================================================
+// element-wise operations
+//==============================================================================
+
+template <class T, unsigned int N>
+inline SBatch<T,N> operator+ (const SBatch<T,N> & lhs, const SBatch<T,N> & rhs) {
+   SBatch<T,N> ret;
+   meta_lane<N>::template f<LaneAdd>(ret.Array(), lhs.Array(), rhs.Array());
+   return ret;
+}
+template <class T, unsigned int N>
+inline SBatch<T,N> operator- (const SBatch<T,N> & lhs, const SBatch<T,N> & rhs) {
+   SBatch<T,N> ret;
+   meta_lane<N>::template f<LaneSub>(ret.Array(), lhs.Array(), rhs.Array());
+   return ret;
+}
+template <class T, unsigned int N>
+inline SBatch<T,N> operator* (const SBatch<T,N> & lhs, const SBatch<T,N> & rhs) {
+   SBatch<T,N> ret;
+   meta_lane<N>::template f<LaneMul>(ret.Array(), lhs.Array(), rhs.Array());
+   return ret;
+}
+template <class T, unsigned int N>
+inline SBatch<T,N> operator/ (const SBatch<T,N> & lhs, const SBatch<T,N> & rhs) {
+   SBatch<T,N> ret;
+   meta_lane<N>::template f<LaneDiv>(ret.Array(), lhs.Array(), rhs.Array());
+   return ret;
+}
+
+template <class T, unsigned int N>
+inline bool operator== (const SBatch<T,N> & lhs, const SBatch<T,N> & rhs) {
+   for (unsigned int i = 0; i < N; ++i)
+      if (lhs[i] != rhs[i]) return false;
+   return true;
+}
+template <class T, unsigned int N>
+inline bool operator!= (const SBatch<T,N> & lhs, const SBatch<T,N> & rhs) {
+   return !(lhs == rhs);
+}
+
+/// square root of each lane
+template <class T, unsigned int N>
+inline SBatch<T,N> sqrt(const SBatch<T,N> & x) {
+   SBatch<T,N> ret;
+   for (unsigned int i = 0; i < N; ++i) ret[i] = std::sqrt(x[i]);
+   return ret;
+}
+
+/// absolute value of each lane
+template <class T, unsigned int N>
+inline SBatch<T,N> fabs(const SBatch<T,N> & x) {
+   SBatch<T,N> ret;
+   for (unsigned int i = 0; i < N; ++i) ret[i] = std::abs(x[i]);
+   return ret;
+}
+
+template <class T, unsigned int N>
+inline std::ostream & operator<< (std::ostream & os, const SBatch<T,N> & x) {
+   os << "(";
+   for (unsigned int i = 0; i < N; ++i) {
+      if (i > 0) os << ",";
+      os << x[i];
+   }
+   return os << ")";
+}
+
+//==============================================================================
+// access to the lanes of a batch of matrices or vectors
+//==============================================================================
+
+/// set the lane "lane" of the batched matrix mb to the matrix m
+template <class T, unsigned int N, unsigned int D1, unsigned int D2, class R1, class R2>
+inline void SetLane(SMatrix<SBatch<T,N>,D1,D2,R1> & mb, unsigned int lane, const SMatrix<T,D1,D2,R2> & m) {
+   for (unsigned int i = 0; i < D1; ++i)
+      for (unsigned int j = 0; j < D2; ++j)
+         mb(i,j)[lane] = m(i,j);
+}
+
+/// copy the lane "lane" of the batched matrix mb to the matrix m
+template <class T, unsigned int N, unsigned int D1, unsigned int D2, class R1, class R2>
+inline void GetLane(const SMatrix<SBatch<T,N>,D1,D2,R1> & mb, unsigned int lane, SMatrix<T,D1,D2,R2> & m) {
+   for (unsigned int i = 0; i < D1; ++i)
+      for (unsigned int j = 0; j < D2; ++j)
+         m(i,j) = mb(i,j)[lane];
+}
+
+/// set the lane "lane" of the batched vector vb to the vector v
+template <class T, unsigned int N, unsigned int D>
+inline void SetLane(SVector<SBatch<T,N>,D> & vb, unsigned int lane, const SVector<T,D> & v) {
+   for (unsigned int i = 0; i < D; ++i) vb[i][lane] = v[i];
+}
+
+/// copy the lane "lane" of the batched vector vb to the vector v
+template <class T, unsigned int N, unsigned int D>
+inline void GetLane(const SVector<SBatch<T,N>,D> & vb, unsigned int lane, SVector<T,D> & v) {
+   for (unsigned int i = 0; i < D; ++i) v[i] = vb[i][lane];
+}
+
+//==============================================================================
+// Cholesky decomposition of a batch of matrices
+//==============================================================================
+
+/**
+   Cholesky decomposition of a batch of symmetric positive definite matrices,
+   vectorized over the lanes. Same interface as CholeskyDecomp; in addition
+   ok(lane) tells if the decomposition succeeded for a given lane, while ok()
+   is true if it succeeded for all of them. Solve and Invert are done for all
+   the lanes; the lanes for which the decomposition failed contain meaningless
+   (finite) values.
+*/
+template <class T, unsigned int L, unsigned int N>
+class CholeskyDecomp<SBatch<T,L>, N>
+{
+private:
+   typedef SBatch<T,L> F;
+   /// lower triangular matrix L, packed storage, with diagonal elements pre-inverted
+   F fL[N * (N + 1) / 2];
+   /// flags indicating a successful decomposition for each lane
+   bool fLaneOk[L];
+   /// flag indicating a successful decomposition for all the lanes
+   bool fOk;
+
+   template<class M> void Decompose(const M & src)
+   {
+      for (unsigned int l = 0; l < L; ++l) fLaneOk[l] = true;
+      F *base1 = &fL[0];
+      for (unsigned i = 0; i < N; base1 += ++i) {
+         F tmpdiag = F(0);
+         F *base2 = &fL[0];
+         for (unsigned j = 0; j < i; base2 += ++j) {
+            F tmp = src(i, j);
+            for (unsigned k = j; k--; )
+               tmp -= base1[k] * base2[k];
+            base1[j] = tmp *= base2[j];
+            tmpdiag += tmp * tmp;
+         }
+         tmpdiag = src(i, i) - tmpdiag;
+         // check if positive definite, lane by lane; the failed lanes continue
+         // with a unit pivot
+         for (unsigned int l = 0; l < L; ++l) {
+            bool posdef = tmpdiag[l] > T(0);
+            fLaneOk[l] = fLaneOk[l] && posdef;
+            tmpdiag[l] = posdef ? T(1) / tmpdiag[l] : T(1);
+         }
+         base1[i] = sqrt(tmpdiag);
+      }
+      fOk = true;
+      for (unsigned int l = 0; l < L; ++l) fOk &= fLaneOk[l];
+   }
+
+public:
+   /// perform a Cholesky decomposition of a batch of matrices (e.g. SMatrix)
+   template<class M> CholeskyDecomp(const M & m) : fOk(false)
+   {
+      Decompose(m);
+   }
+
+   /// perform a Cholesky decomposition of a batch of matrices in packed
+   /// representation (see CholeskyDecomp)
+   template<typename G> CholeskyDecomp(G * m) : fOk(false)
+   {
+      using CholeskyDecompHelpers::PackedArrayAdapter;
+      Decompose(PackedArrayAdapter<G>(m));
+   }
+
+   /// returns true if decomposition was successful for all the lanes
+   bool ok() const { return fOk; }
+   /// returns true if decomposition was successful for the lane l
+   bool ok(unsigned int l) const { return fLaneOk[l]; }
+   /// returns true if decomposition was successful for all the lanes
+   operator bool() const { return fOk; }
+
+   /// solves the linear systems for the given right hand sides
+   template<class V> bool Solve(V & rhs) const
+   {
+      using CholeskyDecompHelpers::_solver;
+      _solver<F,N,V>()(rhs, fL);
+      return fOk;
+   }
+
+   /// place the inverse into m
+   template<class M> bool Invert(M & m) const
+   {
+      using CholeskyDecompHelpers::_inverter;
+      _inverter<F,N,M>()(m, fL);
+      return fOk;
+   }
+
+   /// place the inverse into m, given in packed representation
+   template<typename G> bool Invert(G * m) const
+   {
+      using CholeskyDecompHelpers::_inverter;
+      using CholeskyDecompHelpers::PackedArrayAdapter;
+      PackedArrayAdapter<G> adapted(m);
+      _inverter<F,N,PackedArrayAdapter<G> >()(adapted, fL);
+      return fOk;
+   }
+};
+
+//==============================================================================
+// inversion of a batch of matrices
+//==============================================================================
+
+/**
+   Inversion of a batch of matrices, called by the Inverter and FastInverter
+   classes for SBatch elements. With fast = true the scalar fall back uses
+   FastInverter, otherwise Inverter.
+*/
+template <class B, unsigned int idim, unsigned int n>
+class BatchInverter {
+public:
+
+   typedef typename B::value_type T;
+
+   /// symmetric matrices: vectorized Cholesky inversion, with the scalar
+   /// algorithm for the lanes which are not positive definite
+   static bool Dinv(MatRepSym<B,idim> & rhs, bool fast) {
+      MatRepSym<B,idim> orig;
+      orig = rhs;
+      CholeskyDecomp<B,idim> decomp(rhs);
+      decomp.Invert(rhs);
+      if (decomp.ok()) return true;
+      bool ok = true;
+      for (unsigned int l = 0; l < B::kSize; ++l) {
+         if (decomp.ok(l)) continue;
+         MatRepSym<T,idim> m;
+         for (unsigned int i = 0; i < MatRepSym<T,idim>::kSize; ++i) m.Array()[i] = orig.Array()[i][l];
+         ok &= fast ? FastInverter<idim,n>::Dinv(m) : Inverter<idim,n>::Dinv(m);
+         for (unsigned int i = 0; i < MatRepSym<T,idim>::kSize; ++i) rhs.Array()[i][l] = m.Array()[i];
+      }
+      return ok;
+   }
+
+   /// general matrices: scalar inversion lane by lane
+   static bool Dinv(MatRepStd<B,idim,n> & rhs, bool fast) {
+      bool ok = true;
+      for (unsigned int l = 0; l < B::kSize; ++l) {
+         MatRepStd<T,idim,n> m;
+         for (unsigned int i = 0; i < MatRepStd<T,idim,n>::kSize; ++i) m.Array()[i] = rhs.Array()[i][l];
+         ok &= fast ? FastInverter<idim,n>::Dinv(m) : Inverter<idim,n>::Dinv(m);
+         for (unsigned int i = 0; i < MatRepStd<T,idim,n>::kSize; ++i) rhs.Array()[i][l] = m.Array()[i];
+      }
+      return ok;
+   }
+};
+
+   }  // namespace Math
+
+}  // namespace ROOT
+
+
+#endif /* ROOT_Math_SBatch */
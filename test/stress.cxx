@@ -27,7 +27,7 @@
 // The test with 30 events only require around  20 Mbytes
 // NB: The test must be run with more than 10 events
 //
-// The tests runs sequentially 16 tests. Each test will produce
+// The tests runs sequentially 21 tests. Each test will produce
 // one line (Test OK or Test failed) with some result parameters.
 // At the end of the test a table is printed showing the global results
 // with the amount of I/O, Real Time and Cpu Time.
@@ -56,6 +56,11 @@
 // Test 14 : Check correct rebuilt of Event.root in test 13........ OK
 // Test 15 : Divert Tree branches to separate files................ OK
 // Test 16 : CINT test (3 nested loops) with LHCb trigger.......... OK
+// Test 17 : Generated streaming code of TStreamerInfo............. OK
+// Test 18 : Shared member-wise read actions of collections........ OK
+// Test 19 : TMemFile with bounded memory and spilled blocks........ OK
+// Test 20 : JSON and binary output of TBufferJSON................. OK
+// Test 21 : Streaming (SAX) parsing of XML files.................. OK
 // ******************************************************************
 //*  Linux pcbrun.cern.ch 2.4.20 #1 Thu Jan 9 12:21:02 MET 2003
 //******************************************************************
@@ -75,6 +80,7 @@
 #include <TH1.h>
 #include <TH2.h>
 #include <TFile.h>
+#include <TMemFile.h>
 #include <TMath.h>
 #include <TF1.h>
 #include <TF2.h>
@@ -94,6 +100,13 @@
 #include <TSystem.h>
 #include <TApplication.h>
 #include <TClassTable.h>
+#include <TBufferFile.h>
+#include <TStreamerInfo.h>
+#include <TStreamerInfoActions.h>
+#include <TVirtualCollectionProxy.h>
+#include <TBufferJSON.h>
+#include <TXMLEngine.h>
+#include <TAttLine.h>
 #include <Compression.h>
 #include "Event.h"
 
@@ -115,6 +128,11 @@ void stress13();
 void stress14();
 void stress15();
 void stress16();
+void stress17();
+void stress18();
+void stress19();
+void stress20();
+void stress21();
 void cleanup();
 
 
@@ -128,7 +146,7 @@ int main(int argc, char **argv)
    if (argc > 2) style  = atoi(argv[2]);
    Int_t printSubBench = kFALSE;
    if (argc > 3) printSubBench = atoi(argv[3]);
-   Int_t portion = 65535;
+   Int_t portion = 2097151;
    if (argc > 4) portion  = atoi(argv[4]);
    stress(nevent, style, printSubBench, portion);
    return 0;
@@ -146,7 +164,7 @@ int gPrintSubBench = 0;
 Double_t ntotin=0, ntotout=0;
 
 void stress(Int_t nevent, Int_t style = 1, 
-            Int_t printSubBenchmark = kFALSE, UInt_t portion = 65535)
+            Int_t printSubBenchmark = kFALSE, UInt_t portion = 2097151)
 {
    //Main control function invoking all test programs
    
@@ -181,6 +199,11 @@ void stress(Int_t nevent, Int_t style = 1,
    if (portion&8192) stress14();
    if (portion&16384) stress15();
    if (portion&32768) stress16();
+   if (portion&65536) stress17();
+   if (portion&131072) stress18();
+   if (portion&262144) stress19();
+   if (portion&524288) stress20();
+   if (portion&1048576) stress21();
    gBenchmark->Stop("stress");
 
    cleanup();
@@ -1557,6 +1580,333 @@ void stress16()
    if (gPrintSubBench) { printf("Test 16 : "); gBenchmark->Show("stress");gBenchmark->Start("stress"); }
 }
 
+//_______________________________________________________________
+void stress17()
+{
+   //Stream a histogram and a profile with the functions generated from the
+   //StreamerInfos of their classes (TStreamerInfo::CompileStreamerCode).
+   //The buffers must be identical to the ones written by the generic
+   //streaming actions and the objects read back must be equal.
+
+   Bprint(17,"Generated streaming code of TStreamerInfo");
+
+   gRandom->SetSeed(65539);
+   TH1F h("h17","generated streaming code",100,-4,4);
+   h.FillRandom("gaus",10000);
+   h.SetLineColor(4);
+   h.SetMarkerStyle(21);
+   h.GetXaxis()->SetTitle("x");
+   TProfile p("p17","generated streaming code",50,-4,4,-10,10);
+   for (Int_t i=0;i<10000;i++) {
+      Double_t x = gRandom->Gaus();
+      p.Fill(x,x*x+gRandom->Rndm());
+   }
+
+   TBufferFile bref(TBuffer::kWrite);
+   bref.WriteObject(&h);
+   bref.WriteObject(&p);
+
+   const char *classes[] = {"TH1","TH1F","TProfile","TAxis","TAttAxis",
+                            "TAttLine","TAttFill","TAttMarker"};
+   const Int_t nclasses = sizeof(classes)/sizeof(classes[0]);
+   Int_t nruns = 0, ncompiled = 0;
+   for (Int_t i=0;i<nclasses;i++) {
+      TStreamerInfo *info = (TStreamerInfo*)TClass::GetClass(classes[i])->GetStreamerInfo();
+      TString code;
+      nruns += info->GenerateStreamerCode(code);
+      if (info->CompileStreamerCode()) ncompiled++;
+   }
+
+   TBufferFile bgen(TBuffer::kWrite);
+   bgen.WriteObject(&h);
+   bgen.WriteObject(&p);
+
+   Bool_t OK = kTRUE;
+   if (nruns == 0 || ncompiled == 0) OK = kFALSE;
+   if (bgen.Length() != bref.Length() || memcmp(bgen.Buffer(),bref.Buffer(),bref.Length())) OK = kFALSE;
+
+   TH1::AddDirectory(kFALSE);
+   TBufferFile bread(TBuffer::kRead, bgen.Length(), bgen.Buffer(), kFALSE);
+   TH1F *hr = (TH1F*)bread.ReadObject(TH1F::Class());
+   TProfile *pr = (TProfile*)bread.ReadObject(TProfile::Class());
+   TH1::AddDirectory(kTRUE);
+   if (!hr || !pr) OK = kFALSE;
+   else {
+      if (hr->GetEntries() != h.GetEntries() || hr->GetSumOfWeights() != h.GetSumOfWeights()) OK = kFALSE;
+      if (hr->GetMean() != h.GetMean() || hr->GetRMS() != h.GetRMS()) OK = kFALSE;
+      if (hr->GetLineColor() != 4 || hr->GetMarkerStyle() != 21) OK = kFALSE;
+      if (strcmp(hr->GetXaxis()->GetTitle(),"x")) OK = kFALSE;
+      for (Int_t bin=0;bin<=h.GetNbinsX()+1;bin++) {
+         if (hr->GetBinContent(bin) != h.GetBinContent(bin)) OK = kFALSE;
+      }
+      for (Int_t bin=0;bin<=p.GetNbinsX()+1;bin++) {
+         if (pr->GetBinContent(bin) != p.GetBinContent(bin) ||
+             pr->GetBinError(bin) != p.GetBinError(bin) ||
+             pr->GetBinEntries(bin) != p.GetBinEntries(bin)) OK = kFALSE;
+      }
+   }
+   delete hr;
+   delete pr;
+
+   if (OK) printf("OK\n");
+   else    {
+      printf("failed\n");
+      printf("%-8s runs=%d, compiled=%d, length=%d (expected %d)\n"," ",nruns,ncompiled,bgen.Length(),bref.Length());
+   }
+   if (gPrintSubBench) { printf("Test 17 : "); gBenchmark->Show("stress");gBenchmark->Start("stress"); }
+}
+
+//_______________________________________________________________
+void stress18()
+{
+   //The member-wise read actions of a collection of objects must be built
+   //once per StreamerInfo and shared by all the copies of the collection
+   //proxy (one per branch and per file of a TChain).
+
+   Bprint(18,"Shared member-wise read actions of collections");
+
+   Bool_t OK = kTRUE;
+   TClass *cl = TClass::GetClass("vector<TAttLine>");
+   TVirtualCollectionProxy *proxy = cl ? cl->GetCollectionProxy() : 0;
+   TVirtualStreamerInfo *info = TAttLine::Class()->GetStreamerInfo();
+   TStreamerInfoActions::TActionSequence *seq1 = 0, *seq2 = 0, *seq3 = 0;
+   if (!proxy || !info) OK = kFALSE;
+   else {
+      TVirtualCollectionProxy *copy1 = proxy->Generate();
+      TVirtualCollectionProxy *copy2 = proxy->Generate();
+      seq1 = TStreamerInfoActions::TActionSequence::GetSharedReadMemberWiseActions(info,*copy1);
+      seq2 = TStreamerInfoActions::TActionSequence::GetSharedReadMemberWiseActions(info,*copy2);
+      seq3 = copy2->GetReadMemberWiseActions(info->GetClassVersion());
+      if (!seq1 || seq1 != seq2 || seq1 != seq3) OK = kFALSE;
+      delete copy1;
+      delete copy2;
+   }
+
+   if (OK) printf("OK\n");
+   else    {
+      printf("failed\n");
+      printf("%-8s proxy=%p, sequences=%p %p %p\n"," ",(void*)proxy,(void*)seq1,(void*)seq2,(void*)seq3);
+   }
+   if (gPrintSubBench) { printf("Test 18 : "); gBenchmark->Show("stress");gBenchmark->Start("stress"); }
+}
+
+//_______________________________________________________________
+void stress19()
+{
+   //Write uncompressed histograms to a TMemFile whose memory is limited to
+   //two blocks, so that the other blocks are spilled to a temporary file.
+   //Read them back from the TMemFile and from a copy of its content.
+
+   Bprint(19,"TMemFile with bounded memory and spilled blocks");
+
+   const Int_t nhist = 10;
+   const Int_t nbins = 100000;
+   TH1::AddDirectory(kFALSE);
+   TMemFile f("stress_spill.root","RECREATE","",0);
+   const Long64_t maxmem = 4*1024*1024;
+   f.SetMaxMemory(maxmem);
+   Long64_t maxusage = 0;
+   for (Int_t i=0;i<nhist;i++) {
+      TH1D h(Form("h%d",i),"spilled histogram",nbins,0,1);
+      for (Int_t bin=1;bin<=nbins;bin++) h.SetBinContent(bin,bin*0.5+i);
+      h.Write();
+      if (f.GetMemoryUsage() > maxusage) maxusage = f.GetMemoryUsage();
+   }
+   f.Write();
+
+   Bool_t OK = kTRUE;
+   if (maxusage > maxmem || f.GetSize() < nhist*nbins*8) OK = kFALSE;
+   Long64_t total = 0;
+   for (Int_t i=0;i<f.GetNBlocks();i++) {
+      Long64_t size;
+      if (!f.GetBlock(i,size)) OK = kFALSE;
+      total += size;
+   }
+   if (total != f.GetSize()) OK = kFALSE;
+
+   TBufferFile copy(TBuffer::kWrite);
+   f.CopyTo(copy);
+   if (copy.Length() != f.GetSize()) OK = kFALSE;
+   TMemFile g("stress_spill_copy.root",copy.Buffer(),copy.Length(),"READ");
+
+   Int_t nbad = 0;
+   for (Int_t pass=0;pass<2;pass++) {
+      TFile &file = pass ? (TFile&)g : (TFile&)f;
+      for (Int_t i=nhist-1;i>=0;i--) {
+         TH1D *h = (TH1D*)file.Get(Form("h%d",i));
+         if (!h || h->GetNbinsX() != nbins) { nbad++; delete h; continue; }
+         for (Int_t bin=1;bin<=nbins;bin++) {
+            if (h->GetBinContent(bin) != bin*0.5+i) { nbad++; break; }
+         }
+         delete h;
+      }
+   }
+   if (nbad || f.GetMemoryUsage() > maxmem) OK = kFALSE;
+   TH1::AddDirectory(kTRUE);
+
+   if (OK) printf("OK\n");
+   else    {
+      printf("failed\n");
+      printf("%-8s memory=%lld, size=%lld, blocks=%lld, bad histograms=%d\n"," ",maxusage,f.GetSize(),total,nbad);
+   }
+   if (gPrintSubBench) { printf("Test 19 : "); gBenchmark->Show("stress");gBenchmark->Start("stress"); }
+}
+
+//_______________________________________________________________
+void stress20()
+{
+   //Convert a histogram and a graph with TBufferJSON and check the data
+   //members and the arrays in the JSON (plain and zero suppressed) and in
+   //the binary encoding.
+
+   Bprint(20,"JSON and binary output of TBufferJSON");
+
+   TH1::AddDirectory(kFALSE);
+   TH1F h("h20","json",20,0,20);
+   h.SetBinContent(10,1);
+   h.SetBinContent(11,2.5);
+   TH1::AddDirectory(kTRUE);
+   Double_t x[3] = {1,2.5,3};
+   Double_t y[3] = {-1,0,1e-3};
+   TGraph g(3,x,y);
+
+   Int_t nbad = 0;
+   TString json = TBufferJSON::ConvertToJSON(&h);
+   if (!json.BeginsWith("{\"_typename\":\"TH1F\"")) nbad++;
+   if (!json.Contains("\"fName\":\"h20\"")) nbad++;
+   if (!json.Contains("\"fXaxis\":{\"_typename\":\"TAxis\"")) nbad++;
+   if (!json.Contains("\"fNcells\":22")) nbad++;
+   if (!json.Contains("\"fArray\":[0,0,0,0,0,0,0,0,0,0,1,2.5,0,0,0,0,0,0,0,0,0,0]")) nbad++;
+   if (!json.EndsWith("}")) nbad++;
+
+   TString compact = TBufferJSON::ConvertToJSON(&h,1);
+   if (!compact.Contains("\"fArray\":{\"$arr\":\"Float32\",\"len\":22,\"p\":10,\"v\":[1,2.5]}")) nbad++;
+   if (compact.Length() >= json.Length()) nbad++;
+
+   TString gjson = TBufferJSON::ConvertToJSON(&g);
+   if (!gjson.Contains("\"fNpoints\":3")) nbad++;
+   if (!gjson.Contains("\"fX\":[1,2.5,3]")) nbad++;
+   if (!gjson.Contains("\"fY\":[-1,0,0.001]")) nbad++;
+
+   //the histogram contents must be stored as one little endian column
+   TString binary = TBufferJSON::ConvertToBinary(&h);
+   TString column;
+   column.Append('a');
+   column.Append('f');
+   column.Append((char)h.GetSize());
+   for (Int_t i=0;i<h.GetSize();i++) {
+      Float_t value = h.GetArray()[i];
+      UInt_t bits;
+      memcpy(&bits,&value,sizeof(bits));
+      for (Int_t b=0;b<4;b++) column.Append((char)((bits >> (8*b)) & 0xff));
+   }
+   if (!binary.BeginsWith("RJB1")) nbad++;
+   if (binary.Index(column) == kNPOS) nbad++;
+   if (binary.Length() >= json.Length()) nbad++;
+
+   Bool_t OK = (nbad == 0);
+   if (OK) printf("OK\n");
+   else    {
+      printf("failed\n");
+      printf("%-8s %d checks failed\n"," ",nbad);
+   }
+   if (gPrintSubBench) { printf("Test 20 : "); gBenchmark->Show("stress");gBenchmark->Start("stress"); }
+}
+
+//_______________________________________________________________
+class TStressSAXHandler : public TXMLSAXHandler {
+   // Writes the elements reported by TXMLEngine::ParseFileSAX in the
+   // same form as XMLSignature for the document tree.
+public:
+   TString     fOut;
+   const char *fBoxName;
+   Int_t       fNBoxes;
+   TStressSAXHandler(const char *boxname) : fBoxName(boxname), fNBoxes(0) {}
+   Bool_t OnStartElement(const char *name, const char **attrs) {
+      if (name == fBoxName) fNBoxes++;
+      fOut += "<"; fOut += name;
+      for (Int_t i=0;attrs[i];i+=2) { fOut += " "; fOut += attrs[i]; fOut += "="; fOut += attrs[i+1]; }
+      fOut += ">";
+      return kTRUE;
+   }
+   Bool_t OnEndElement(const char *name) {
+      fOut += "</"; fOut += name; fOut += ">";
+      return kTRUE;
+   }
+   Bool_t OnCharacters(const char *content, Int_t len) {
+      fOut.Append(content,len);
+      return kTRUE;
+   }
+};
+
+//_______________________________________________________________
+void XMLSignature(TXMLEngine &xml, XMLNodePointer_t node, TString &out)
+{
+   // Write the element node, its attributes, content and children
+
+   out += "<"; out += xml.GetNodeName(node);
+   for (XMLAttrPointer_t attr = xml.GetFirstAttr(node); attr; attr = xml.GetNextAttr(attr)) {
+      out += " "; out += xml.GetAttrName(attr); out += "="; out += xml.GetAttrValue(attr);
+   }
+   out += ">";
+   if (xml.GetNodeContent(node)) out += xml.GetNodeContent(node);
+   XMLNodePointer_t child = xml.GetChild(node);
+   xml.SkipEmpty(child);
+   while (child) {
+      XMLSignature(xml,child,out);
+      xml.ShiftToNext(child);
+   }
+   out += "</"; out += xml.GetNodeName(node); out += ">";
+}
+
+//_______________________________________________________________
+void stress21()
+{
+   //Parse a GDML like file with the streaming interface of TXMLEngine and
+   //compare the reported elements with the document tree.  The file is much
+   //larger than the input window, which is thus moved many times.
+
+   Bprint(21,"Streaming (SAX) parsing of XML files");
+
+   const Int_t nboxes = 20000;
+   FILE *fp = fopen("stress_sax.xml","w");
+   fprintf(fp,"<?xml version=\"1.0\"?>\n<gdml>\n <define>\n");
+   for (Int_t i=0;i<nboxes/10;i++) {
+      fprintf(fp,"  <constant name=\"c%d\" value=\"%d*2.5+%s\"/>\n",i,i,i%2 ? "0" : "1");
+   }
+   fprintf(fp," </define>\n <!-- solids of the test -->\n <solids>\n");
+   for (Int_t i=0;i<nboxes;i++) {
+      fprintf(fp,"  <box name=\"box_with_a_long_name_%d\" x=\"%.12g\" y=\"%d\" z=\"c%d\" lunit=\"mm\"/>\n",i,i*0.1,i,i%(nboxes/10));
+      if (i%100 == 0) fprintf(fp,"  <auxiliary auxtype=\"note\">box &lt;%d&gt; &amp; more</auxiliary>\n",i);
+   }
+   fprintf(fp," </solids>\n</gdml>\n");
+   fclose(fp);
+
+   TXMLEngine dom;
+   dom.SetSkipComments(kTRUE);
+   XMLDocPointer_t doc = dom.ParseFile("stress_sax.xml");
+   TString expected;
+   if (doc) XMLSignature(dom,dom.DocGetRootElement(doc),expected);
+   dom.FreeDoc(doc);
+
+   TXMLEngine sax;
+   sax.SetSkipComments(kTRUE);
+   TStressSAXHandler handler(sax.Intern("box"));
+   Bool_t parsed = sax.ParseFileSAX("stress_sax.xml",&handler);
+
+   Bool_t OK = kTRUE;
+   if (!doc || !parsed || expected.Length() == 0) OK = kFALSE;
+   if (handler.fNBoxes != nboxes || handler.fOut != expected) OK = kFALSE;
+   if (!expected.Contains("<auxiliary auxtype=note>box <100> & more</auxiliary>")) OK = kFALSE;
+
+   if (OK) printf("OK\n");
+   else    {
+      printf("failed\n");
+      printf("%-8s parsed=%d, boxes=%d, lengths=%d/%d\n"," ",parsed,handler.fNBoxes,handler.fOut.Length(),expected.Length());
+   }
+   if (gPrintSubBench) { printf("Test 21 : "); gBenchmark->Show("stress");gBenchmark->Start("stress"); }
+}
+
 void cleanup()
 {
    gSystem->Unlink("Event.root");
@@ -1578,4 +1928,5 @@ void cleanup()
    gSystem->Unlink("stress_small.root");
    gSystem->Unlink("stress_test9.root");
    gSystem->Unlink("stress_test11.root");
+   gSystem->Unlink("stress_sax.xml");
 }
@@ -49,6 +49,9 @@
 // Test  5 : GoldStein1............................................ OK       //
 // Test  6 : GoldStein2............................................ OK       //
 // Test  7 : TrigoFletcher......................................... OK       //
+// Test  8 : FitUtil serial and multithread........................ OK       //
+// Test  9 : Minuit2 threaded derivatives.......................... OK       //
+// Test 10 : BatchFitter........................................... OK       //
 // *******************************************************************       //
 //                                                                           //
 //*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*_*//
@@ -63,6 +66,20 @@
 #include "Riostream.h"
 #include "TVectorD.h"
 #include "TMatrixD.h"
+#include "Fit/BinData.h"
+#include "Fit/UnBinData.h"
+#include "Fit/FitUtil.h"
+#include "Fit/Fitter.h"
+#include "Fit/BatchFitter.h"
+#include "Math/IParamFunction.h"
+#include "Math/ThreadPool.h"
+#include "Math/Functor.h"
+#include "Math/Factory.h"
+#include "Math/Minimizer.h"
+#include "Math/MinimizerOptions.h"
+#include "Math/IOptions.h"
+#include <vector>
+#include <algorithm>
 
 Int_t stressFit(const char *theFitter="Minuit", Int_t N=2000);
 Int_t    gVerbose      = -1;
@@ -598,6 +615,281 @@ Bool_t RunTrigoFletcher()
   return ok;
 }
 
+//______________________________________________________________________________
+class GausModel : public ROOT::Math::IParamMultiGradFunction {
+  // Gaussian model function. Its parameter gradient stores the parameters in
+  // the function, so the multithreaded gradients must use a clone per chunk
+public:
+  GausModel() { fParams[0] = 1.; fParams[1] = 0.; fParams[2] = 1.; }
+  ROOT::Math::IMultiGenFunction *Clone() const { return new GausModel(*this); }
+  unsigned int NDim() const { return 1; }
+  unsigned int NPar() const { return 3; }
+  const Double_t *Parameters() const { return fParams; }
+  void SetParameters(const Double_t *p) { std::copy(p, p + 3, fParams); }
+  void ParameterGradient(const Double_t *x, const Double_t *p, Double_t *grad) const {
+    std::copy(p, p + 3, fParams);
+    for (UInt_t ipar = 0; ipar < 3; ipar++) grad[ipar] = DoParameterDerivative(x, fParams, ipar);
+  }
+private:
+  Double_t DoEvalPar(const Double_t *x, const Double_t *p) const {
+    Double_t t = (x[0] - p[1]) / p[2];
+    return p[0] * TMath::Exp(-0.5 * t * t);
+  }
+  Double_t DoParameterDerivative(const Double_t *x, const Double_t *p, UInt_t ipar) const {
+    Double_t t = (x[0] - p[1]) / p[2];
+    Double_t f = TMath::Exp(-0.5 * t * t);
+    if (ipar == 0) return f;
+    if (ipar == 1) return p[0] * f * t / p[2];
+    return p[0] * f * t * t / p[2];
+  }
+  mutable Double_t fParams[3];
+};
+
+//______________________________________________________________________________
+Bool_t EqualFit(Double_t a, Double_t b, Double_t eps)
+{
+  return TMath::Abs(a - b) <= eps * TMath::Max(TMath::Abs(a), TMath::Abs(b));
+}
+
+//______________________________________________________________________________
+Bool_t EqualGradient(Double_t a, Double_t b)
+{
+  // the components of a gradient may be sums of terms cancelling each other:
+  // compare them relative to 1 when they are small
+  return TMath::Abs(a - b) <= 1E-10 * (TMath::Abs(a) + 1.);
+}
+
+//______________________________________________________________________________
+Bool_t RunFitUtil()
+{
+  // Evaluate the chi2, the Poisson and the unbinned likelihoods and their
+  // gradients with the serial and the multithreaded execution policies, for
+  // data sizes below, at and above the chunk size (1024 points). The values
+  // and the gradients agree up to the summation order, and the multithreaded
+  // ones do not depend on the number of threads; the chi2 gradient is checked
+  // numerically.
+
+  using namespace ROOT::Fit;
+  Bool_t ok = kTRUE;
+  UInt_t nthreads = ROOT::Math::ThreadPool::DefaultNThreads();
+  ROOT::Math::ThreadPool::SetDefaultNThreads(4);
+
+  GausModel func;
+  const Double_t p[3] = { 100., 0.3, 1.2 };
+  const UInt_t sizes[] = { 500, 1024, 1025, 4096, 10000 };
+  for (UInt_t k = 0; k < sizeof(sizes) / sizeof(UInt_t); k++) {
+    const UInt_t n = sizes[k];
+    BinData bd(n, 1);
+    UnBinData ud(n, 1);
+    for (UInt_t i = 0; i < n; i++) {
+      Double_t x = -5. + 10. * (i + 0.5) / n;
+      Double_t y = TMath::Nint(func(&x, p) * (1. + 0.2 * TMath::Sin(37. * x)));
+      bd.Add(x, y, TMath::Sqrt(y + 1.));
+      ud.Add(x);
+    }
+
+    UInt_t n1 = 0, n2 = 0;
+    Double_t g1[3], g2[3], g3[3];
+    Double_t c1 = FitUtil::EvaluateChi2(func, bd, p, n1, kSerial);
+    Double_t c2 = FitUtil::EvaluateChi2(func, bd, p, n2, kMultithread);
+    ok = ok && n1 == n && n2 == n && EqualFit(c1, c2, 1E-12);
+    FitUtil::EvaluateChi2Gradient(func, bd, p, g1, n1, kSerial);
+    FitUtil::EvaluateChi2Gradient(func, bd, p, g2, n2, kMultithread);
+    ok = ok && n1 == n2;
+    ROOT::Math::ThreadPool::SetDefaultNThreads(2);
+    FitUtil::EvaluateChi2Gradient(func, bd, p, g3, n2, kMultithread);
+    ROOT::Math::ThreadPool::SetDefaultNThreads(4);
+    for (UInt_t ipar = 0; ipar < 3; ipar++) {
+      ok = ok && EqualGradient(g1[ipar], g2[ipar]) && g2[ipar] == g3[ipar];
+      Double_t pp[3] = { p[0], p[1], p[2] };
+      Double_t h = 1E-6 * TMath::Abs(p[ipar]);
+      pp[ipar] = p[ipar] + h;
+      Double_t cup = FitUtil::EvaluateChi2(func, bd, pp, n1);
+      pp[ipar] = p[ipar] - h;
+      Double_t clow = FitUtil::EvaluateChi2(func, bd, pp, n1);
+      ok = ok && TMath::Abs((cup - clow) / (2. * h) - g1[ipar]) <= 1E-4 * (TMath::Abs(g1[ipar]) + 1.);
+    }
+
+    c1 = FitUtil::EvaluatePoissonLogL(func, bd, p, 0, kTRUE, n1, kSerial);
+    c2 = FitUtil::EvaluatePoissonLogL(func, bd, p, 0, kTRUE, n2, kMultithread);
+    ok = ok && EqualFit(c1, c2, 1E-12);
+    FitUtil::EvaluatePoissonLogLGradient(func, bd, p, g1, kSerial);
+    FitUtil::EvaluatePoissonLogLGradient(func, bd, p, g2, kMultithread);
+    ROOT::Math::ThreadPool::SetDefaultNThreads(2);
+    FitUtil::EvaluatePoissonLogLGradient(func, bd, p, g3, kMultithread);
+    ROOT::Math::ThreadPool::SetDefaultNThreads(4);
+    for (UInt_t ipar = 0; ipar < 3; ipar++)
+      ok = ok && EqualGradient(g1[ipar], g2[ipar]) && g2[ipar] == g3[ipar];
+
+    c1 = FitUtil::EvaluateLogL(func, ud, p, 0, kFALSE, n1, kSerial);
+    c2 = FitUtil::EvaluateLogL(func, ud, p, 0, kFALSE, n2, kMultithread);
+    ok = ok && EqualFit(c1, c2, 1E-12);
+    FitUtil::EvaluateLogLGradient(func, ud, p, g1, n1, kSerial);
+    FitUtil::EvaluateLogLGradient(func, ud, p, g2, n2, kMultithread);
+    ROOT::Math::ThreadPool::SetDefaultNThreads(2);
+    FitUtil::EvaluateLogLGradient(func, ud, p, g3, n2, kMultithread);
+    ROOT::Math::ThreadPool::SetDefaultNThreads(4);
+    for (UInt_t ipar = 0; ipar < 3; ipar++)
+      ok = ok && EqualGradient(g1[ipar], g2[ipar]) && g2[ipar] == g3[ipar];
+
+    if (!ok && gVerbose > 0) printf("FitUtil: evaluations differ for %d points\n", n);
+  }
+
+  ROOT::Math::ThreadPool::SetDefaultNThreads(nthreads);
+  return ok;
+}
+
+//______________________________________________________________________________
+Double_t Wood4Functor(const Double_t *par)
+{
+  Int_t npar = 4;
+  Double_t f = 0;
+  Wood4(npar, 0, f, const_cast<Double_t *>(par), 0);
+  return f;
+}
+
+//______________________________________________________________________________
+Bool_t RunMinuit2Threads()
+{
+  // Minimize the Wood function with Minuit2 computing the numerical
+  // derivatives with 1, 3 and 8 threads (more threads than parameters), with
+  // all the parameters free and with one fixed. The minimum, the Hesse and
+  // Minos errors and the number of calls do not depend on the number of
+  // threads.
+
+  ROOT::Math::Functor fcn(&Wood4Functor, 4);
+  ROOT::Math::IOptions &opt = ROOT::Math::MinimizerOptions::Default("Minuit2");
+  Int_t nthreads0 = 1;
+  opt.GetValue("NThreads", nthreads0);
+
+  Bool_t ok = kTRUE;
+  const Int_t nthreads[] = { 1, 3, 8 };
+  for (Int_t ifix = 0; ifix < 2; ifix++) {
+    std::vector<Double_t> xref, err0, cov0;
+    Double_t elow0 = 0, eup0 = 0;
+    UInt_t ncalls0 = 0;
+    for (Int_t k = 0; k < 3; k++) {
+      opt.SetValue("NThreads", nthreads[k]);
+      ROOT::Math::Minimizer *min = ROOT::Math::Factory::CreateMinimizer("Minuit2", "Migrad");
+      if (!min) {
+        if (gVerbose > 0) printf("Minuit2 is not available\n");
+        opt.SetValue("NThreads", nthreads0);
+        return kTRUE;
+      }
+      min->SetPrintLevel(0);
+      min->SetFunction(fcn);
+      min->SetVariable(0, "w", -3.0, 0.01);
+      min->SetVariable(1, "x", -1.0, 0.01);
+      if (ifix) min->SetFixedVariable(2, "y", 1.0);
+      else      min->SetVariable(2, "y", -3.0, 0.01);
+      min->SetVariable(3, "z", -1.0, 0.01);
+      ok = ok && min->Minimize() && min->Hesse();
+      Double_t elow = 0, eup = 0;
+      ok = ok && min->GetMinosError(0, elow, eup);
+
+      std::vector<Double_t> x(min->X(), min->X() + 4);
+      std::vector<Double_t> err(min->Errors(), min->Errors() + 4);
+      std::vector<Double_t> cov(16);
+      min->GetCovMatrix(&cov[0]);
+      if (k == 0) {
+        xref = x;
+        err0 = err;
+        cov0 = cov;
+        elow0 = elow;
+        eup0 = eup;
+        ncalls0 = min->NCalls();
+        ok = ok && TMath::Abs(x[0] - 1.) < gAbsTolerance && TMath::Abs(x[3] - 1.) < gAbsTolerance;
+      } else {
+        ok = ok && x == xref && err == err0 && cov == cov0 && elow == elow0 && eup == eup0 &&
+             min->NCalls() == ncalls0;
+      }
+      if (!ok && gVerbose > 0) printf("Minuit2: results differ with %d threads\n", nthreads[k]);
+      delete min;
+    }
+  }
+
+  opt.SetValue("NThreads", nthreads0);
+  return ok;
+}
+
+//______________________________________________________________________________
+Bool_t RunBatchFitter()
+{
+  // Fit 7 data sets with a BatchFitter using 1 and 4 threads (a number of
+  // fits which is not a multiple of the number of chunks), alternating the
+  // Migrad and Simplex algorithms of Minuit2 so that the minimizers can not
+  // be re-used between consecutive fits. The results are the same as those
+  // of a Fitter performing each fit on its own. Check also the empty batch
+  // and the batch of a single fit.
+
+  using namespace ROOT::Fit;
+  ROOT::Math::Minimizer *min = ROOT::Math::Factory::CreateMinimizer("Minuit2", "Migrad");
+  if (!min) {
+    if (gVerbose > 0) printf("Minuit2 is not available\n");
+    return kTRUE;
+  }
+  delete min;
+
+  Bool_t ok = kTRUE;
+  GausModel func;
+  const UInt_t nfits = 7, n = 200;
+  std::vector<BinData *> data(nfits);
+  for (UInt_t ifit = 0; ifit < nfits; ifit++) {
+    const Double_t p[3] = { 50. + 10. * ifit, 0.1 * ifit - 0.3, 1. + 0.1 * ifit };
+    data[ifit] = new BinData(n, 1);
+    for (UInt_t i = 0; i < n; i++) {
+      Double_t x = -5. + 10. * (i + 0.5) / n;
+      Double_t y = TMath::Nint(func(&x, p) * (1. + 0.2 * TMath::Sin(37. * x + ifit)));
+      data[ifit]->Add(x, y, TMath::Sqrt(y + 1.));
+    }
+  }
+  const Double_t pstart[3] = { 40., 0., 1.5 };
+  func.SetParameters(pstart);
+
+  // the reference fits
+  std::vector<FitResult> ref(nfits);
+  for (UInt_t ifit = 0; ifit < nfits; ifit++) {
+    Fitter fitter;
+    fitter.Config().SetMinimizer("Minuit2", (ifit % 2) ? "Simplex" : "Migrad");
+    fitter.SetFunction(func, false);
+    ok = ok && fitter.Fit(*data[ifit]);
+    ref[ifit] = fitter.Result();
+  }
+
+  const UInt_t nthreads[] = { 1, 4 };
+  for (UInt_t k = 0; k < 2; k++) {
+    BatchFitter batch(nthreads[k]);
+    ok = ok && batch.Fit() && batch.BestFit() == -1;
+    batch.Config().SetMinimizer("Minuit2", "Migrad");
+    for (UInt_t ifit = 0; ifit < nfits; ifit++) {
+      batch.AddFit(*data[ifit], func, false);
+      if (ifit % 2) batch.Config(ifit).SetMinimizer("Minuit2", "Simplex");
+    }
+    ok = ok && batch.NFits() == nfits && batch.Fit();
+    Int_t best = -1;
+    for (UInt_t ifit = 0; ifit < nfits; ifit++) {
+      const FitResult &res = batch.Result(ifit);
+      ok = ok && res.IsValid() == ref[ifit].IsValid() && res.NCalls() == ref[ifit].NCalls() &&
+           EqualFit(res.MinFcnValue(), ref[ifit].MinFcnValue(), 1E-10);
+      for (UInt_t ipar = 0; ipar < 3; ipar++)
+        ok = ok && EqualFit(res.Parameter(ipar), ref[ifit].Parameter(ipar), 1E-10) &&
+             EqualFit(res.Error(ipar), ref[ifit].Error(ipar), 1E-10);
+      if (ref[ifit].IsValid() && (best < 0 || ref[ifit].MinFcnValue() < ref[best].MinFcnValue())) best = ifit;
+    }
+    ok = ok && batch.BestFit() == best;
+    if (!ok && gVerbose > 0) printf("BatchFitter: results differ with %d threads\n", nthreads[k]);
+
+    batch.Clear();
+    batch.AddFit(*data[1], func, false);
+    batch.Config(0).SetMinimizer("Minuit2", "Simplex");
+    ok = ok && batch.Fit() && batch.Result(0).NCalls() == ref[1].NCalls() &&
+         EqualFit(batch.Result(0).Parameter(1), ref[1].Parameter(1), 1E-10);
+  }
+
+  for (UInt_t ifit = 0; ifit < nfits; ifit++) delete data[ifit];
+  return ok;
+}
+
 //______________________________________________________________________________
 Int_t stressFit(const char *theFitter, Int_t N)
 {
@@ -638,6 +930,12 @@ Int_t stressFit(const char *theFitter, Int_t N)
   StatusPrint(6,"GoldStein2",okGoldStein2);
   okTrigoFletcher = RunTrigoFletcher();
   StatusPrint(7,"TrigoFletcher",okTrigoFletcher);
+  Bool_t okFitUtil = RunFitUtil();
+  StatusPrint(8,"FitUtil serial and multithread",okFitUtil);
+  Bool_t okMinuit2Threads = RunMinuit2Threads();
+  StatusPrint(9,"Minuit2 threaded derivatives",okMinuit2Threads);
+  Bool_t okBatchFitter = RunBatchFitter();
+  StatusPrint(10,"BatchFitter",okBatchFitter);
 
   gBenchmark->Stop("stressFit");
 
@@ -47,7 +47,19 @@
 // Test 14: Integral tests for Histograms....................................OK  //
 // Test 15: TH1-THn[Sparse] Conversion tests.................................OK  //
 // Test 16: Filldata tests for Histograms and THn[Sparse]....................OK  //
-// Test 17: Reference File Read for Histograms and Profiles..................OK  //
+// Test 17: FillN tests for 1D, 2D and 3D Histograms.........................OK  //
+// Test 18: Concurrent filling tests for Histograms..........................OK  //
+// Test 19: THnSparse bin index and THn FillN tests..........................OK  //
+// Test 20: Parallel THn projection, rebinning and Add tests.................OK  //
+// Test 21: TH2Poly bin search and FillN tests...............................OK  //
+// Test 22: TGraphDelaunay triangulation and interpolation tests.............OK  //
+// Test 23: TKDE evaluation modes tests......................................OK  //
+// Test 24: TGraph batch Eval and WrapData tests.............................OK  //
+// Test 25: TSpline3 evaluation and I/O tests................................OK  //
+// Test 26: Batch evaluation of fit model functions tests....................OK  //
+// Test 27: Analytic parameter derivatives tests.............................OK  //
+// Test 28: Native compilation of formulas tests.............................OK  //
+// Test 29: Reference File Read for Histograms and Profiles..................OK  //
 // ****************************************************************************  //
 // stressHistogram: Real Time =  64.01 seconds Cpu Time =  63.89 seconds         //
 //  ROOTMARKS = 430.74 ROOT version: 5.25/01 branches/dev/mathDev@29787       //
@@ -58,25 +70,41 @@
 
 #include <sstream>
 #include <cmath>
+#include <vector>
+#include <map>
+#include <string>
+#include <cstring>
 
 #include "TH2.h"
 #include "TH3.h"
 #include "TH2.h"
 #include "THn.h"
 #include "THnSparse.h"
+#include "TH2Poly.h"
+#include "TGraphErrors.h"
+#include "TGraph2D.h"
+#include "TGraphDelaunay.h"
+#include "TKDE.h"
+#include "TSpline.h"
 
 #include "TProfile.h"
 #include "TProfile2D.h"
 #include "TProfile3D.h"
+#include "TConcurrentHistFiller.h"
 
 #include "TF1.h"
 #include "TF2.h"
 #include "TF3.h"
 
 #include "Fit/SparseData.h"
+#include "Fit/UnBinData.h"
+#include "Fit/FitUtil.h"
+#include "Math/WrappedMultiTF1.h"
+#include "Math/WrappedTF1.h"
 #include "HFitInterface.h"
 
 #include "Math/IntegratorOptions.h"
+#include "Math/ThreadPool.h"
 
 #include "TApplication.h"
 #include "TBenchmark.h"
@@ -84,7 +112,9 @@
 #include "TMath.h"
 #include "TRandom2.h"
 #include "TFile.h"
+#include "TBufferFile.h"
 #include "TClass.h"
+#include "TThread.h"
 
 #include "TROOT.h"
 #include <algorithm>
@@ -8376,6 +8406,1744 @@ bool testTH3toTH2()
 }
 
 
+bool testFillN1D()
+{
+   // Tests that FillN fills a 1D histogram as Fill does, with weights
+   // and with entries in the underflow and overflow bins
+
+   const Int_t n = 2*nEvents + 7; // several batches and a partial one
+   std::vector<Double_t> x(n), w(n);
+   for ( Int_t e = 0; e < n; ++e ) {
+      x[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      w[e] = r.Uniform(0.5, 1.5);
+   }
+
+   TH1D* h1 = new TH1D("tFN1D-h1", "h1-Title", numberOfBins, minRange, maxRange);
+   TH1D* h2 = new TH1D("tFN1D-h2", "h2-Title", numberOfBins, minRange, maxRange);
+
+   for ( Int_t e = 0; e < n; ++e )
+      h1->Fill(x[e], w[e]);
+   h2->FillN(n, &x[0], &w[0]);
+
+   bool ret = equals("FillN1D", h1, h2, cmpOptStats, 1E-13);
+   delete h1;
+   return ret;
+}
+
+bool testFillNVar1D()
+{
+   // Tests FillN on a 1D histogram with variable bins, without weights
+   // and with a stride
+
+   const Int_t n = 2*nEvents + 7;
+   const Int_t stride = 2;
+   std::vector<Double_t> x(n*stride);
+   for ( Int_t e = 0; e < n*stride; ++e )
+      x[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+
+   Double_t v[numberOfBins+1];
+   FillVariableRange(v);
+
+   TH1D* h1 = new TH1D("tFNVar1D-h1", "h1-Title", numberOfBins, v);
+   TH1D* h2 = new TH1D("tFNVar1D-h2", "h2-Title", numberOfBins, v);
+
+   for ( Int_t e = 0; e < n; ++e )
+      h1->Fill(x[e*stride]);
+   h2->FillN(n, &x[0], 0, stride);
+
+   bool ret = equals("FillNVar1D", h1, h2, cmpOptStats, 1E-13);
+   delete h1;
+   return ret;
+}
+
+bool testFillN2D()
+{
+   // Tests that FillN fills a 2D histogram (fixed x bins and variable y
+   // bins) as Fill does, with weights
+
+   const Int_t n = 2*nEvents + 7;
+   std::vector<Double_t> x(n), y(n), w(n);
+   for ( Int_t e = 0; e < n; ++e ) {
+      x[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      y[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      w[e] = r.Uniform(0.5, 1.5);
+   }
+
+   Double_t v[numberOfBins+1];
+   FillVariableRange(v);
+
+   TH2D* h1 = new TH2D("tFN2D-h1", "h1-Title", numberOfBins, minRange, maxRange, numberOfBins, v);
+   TH2D* h2 = new TH2D("tFN2D-h2", "h2-Title", numberOfBins, minRange, maxRange, numberOfBins, v);
+
+   for ( Int_t e = 0; e < n; ++e )
+      h1->Fill(x[e], y[e], w[e]);
+   h2->FillN(n, &x[0], &y[0], &w[0]);
+
+   bool ret = equals("FillN2D", h1, h2, cmpOptStats, 1E-13);
+   delete h1;
+   return ret;
+}
+
+bool testFillN3D()
+{
+   // Tests that FillN fills a 3D histogram as Fill does, with weights and
+   // with a stride
+
+   const Int_t n = 2*nEvents + 7;
+   const Int_t stride = 3;
+   std::vector<Double_t> x(n*stride), y(n*stride), z(n*stride), w(n*stride);
+   for ( Int_t e = 0; e < n*stride; ++e ) {
+      x[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      y[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      z[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      w[e] = r.Uniform(0.5, 1.5);
+   }
+
+   TH3D* h1 = new TH3D("tFN3D-h1", "h1-Title",
+                       numberOfBins, minRange, maxRange,
+                       numberOfBins + 1, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+   TH3D* h2 = new TH3D("tFN3D-h2", "h2-Title",
+                       numberOfBins, minRange, maxRange,
+                       numberOfBins + 1, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+
+   for ( Int_t e = 0; e < n; ++e )
+      h1->Fill(x[e*stride], y[e*stride], z[e*stride], w[e*stride]);
+   h2->FillN(n, &x[0], &y[0], &z[0], &w[0], stride);
+
+   bool ret = equals("FillN3D", h1, h2, cmpOptStats, 1E-13);
+   delete h1;
+   return ret;
+}
+
+bool testFillNExtend1D()
+{
+   // Tests FillN on a histogram whose axis can be extended, which is filled
+   // entry by entry
+
+   const Int_t n = nEvents;
+   std::vector<Double_t> x(n);
+   for ( Int_t e = 0; e < n; ++e )
+      x[e] = r.Uniform(0.5 * minRange, 2 * maxRange);
+
+   TH1D* h1 = new TH1D("tFNExt1D-h1", "h1-Title", numberOfBins, minRange, maxRange);
+   TH1D* h2 = new TH1D("tFNExt1D-h2", "h2-Title", numberOfBins, minRange, maxRange);
+   h1->SetCanExtend(TH1::kAllAxes);
+   h2->SetCanExtend(TH1::kAllAxes);
+
+   for ( Int_t e = 0; e < n; ++e )
+      h1->Fill(x[e]);
+   h2->FillN(n, &x[0], 0);
+
+   bool ret = equals("FillNExtend1D", h1, h2, cmpOptStats, 1E-13);
+   delete h1;
+   return ret;
+}
+
+class ConcurrentFillTask : public ROOT::Math::ThreadPool::ITask {
+   // Fills the entries of one chunk per task through a TConcurrentHistFiller
+public:
+   ConcurrentFillTask(TConcurrentHistFiller &filler, const std::vector<Double_t> &x,
+                      const std::vector<Double_t> &y, const std::vector<Double_t> &w,
+                      Int_t dim, Int_t chunk) :
+      fFiller(filler), fX(x), fY(y), fW(w), fDim(dim), fChunk(chunk) {}
+   void Execute(unsigned int itask) {
+      Int_t last = std::min((Int_t)fX.size(), Int_t(itask+1)*fChunk);
+      for ( Int_t e = itask*fChunk; e < last; ++e ) {
+         if ( fDim == 1 ) {
+            fFiller.Fill(fX[e], fW[e]);
+         } else {
+            Double_t v[3] = { fX[e], fY[e], fW[e] };
+            fFiller.Fill(v, fW[e]);
+         }
+      }
+   }
+private:
+   TConcurrentHistFiller &fFiller;
+   const std::vector<Double_t> &fX, &fY, &fW;
+   Int_t fDim, fChunk;
+};
+
+bool testConcurrentFill1D()
+{
+   // Tests that a histogram filled from several threads through a
+   // TConcurrentHistFiller equals the one filled serially
+
+   TThread::Initialize();
+   const Int_t n = 20*nEvents;
+   std::vector<Double_t> x(n), w(n);
+   for ( Int_t e = 0; e < n; ++e ) {
+      x[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      w[e] = r.Uniform(0.5, 1.5);
+   }
+
+   TH1D* h1 = new TH1D("tCF1D-h1", "h1-Title", numberOfBins, minRange, maxRange);
+   TH1D* h2 = new TH1D("tCF1D-h2", "h2-Title", numberOfBins, minRange, maxRange);
+   for ( Int_t e = 0; e < n; ++e )
+      h1->Fill(x[e], w[e]);
+
+   int status = 0;
+   {
+      TConcurrentHistFiller filler(h2);
+      ConcurrentFillTask task(filler, x, x, w, 1, nEvents);
+      ROOT::Math::ThreadPool::Run(task, n / nEvents, 4);
+      // merging twice must not count the entries twice
+      filler.Merge();
+      if ( filler.GetNShards() < 1 || filler.GetNShards() > 5 ) status = 1;
+   }
+
+   status += equals("ConcurrentFill1D", h1, h2, cmpOptStats, 1E-13);
+   delete h1;
+   return status;
+}
+
+bool testConcurrentFillSparse()
+{
+   // Tests the concurrent filling of a THnSparse
+
+   TThread::Initialize();
+   const Int_t n = 20*nEvents;
+   std::vector<Double_t> x(n), y(n), w(n);
+   for ( Int_t e = 0; e < n; ++e ) {
+      x[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      y[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      w[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+   }
+
+   Int_t bsize[] = { numberOfBins, numberOfBins, numberOfBins };
+   Double_t xmin[] = { minRange, minRange, minRange };
+   Double_t xmax[] = { maxRange, maxRange, maxRange };
+   THnSparseD* s1 = new THnSparseD("tCFS-s1", "s1-Title", 3, bsize, xmin, xmax);
+   THnSparseD* s2 = new THnSparseD("tCFS-s2", "s2-Title", 3, bsize, xmin, xmax);
+   s1->Sumw2();
+   s2->Sumw2();
+   for ( Int_t e = 0; e < n; ++e ) {
+      Double_t v[3] = { x[e], y[e], w[e] };
+      s1->Fill(v, w[e]);
+   }
+
+   {
+      TConcurrentHistFiller filler(s2);
+      ConcurrentFillTask task(filler, x, y, w, 3, nEvents);
+      ROOT::Math::ThreadPool::Run(task, n / nEvents, 4);
+   }
+
+   int status = equals("ConcurrentFillSparse", s1, s2, cmpOptNone, 1E-13);
+   delete s1;
+   return status;
+}
+
+struct ConcurrentFillThreadArgs {
+   TConcurrentHistFiller *fFiller;
+   Double_t               fX;
+};
+
+void ConcurrentFillThread(void *arg)
+{
+   ConcurrentFillThreadArgs *args = (ConcurrentFillThreadArgs*) arg;
+   args->fFiller->Fill(args->fX);
+}
+
+bool testConcurrentFillThreadExit()
+{
+   // Tests that the shards of the threads which exited are reused by the
+   // next threads: more threads than the size of the shard table fill one
+   // after the other, none of them must fill the histogram directly
+
+   TThread::Initialize();
+   const Int_t n = 5000;
+
+   TH1D* h1 = new TH1D("tCFTE-h1", "h1-Title", numberOfBins, minRange, maxRange);
+   TH1D* h2 = new TH1D("tCFTE-h2", "h2-Title", numberOfBins, minRange, maxRange);
+
+   int status = 0;
+   {
+      TConcurrentHistFiller filler(h2);
+      ConcurrentFillThreadArgs args;
+      args.fFiller = &filler;
+      for ( Int_t e = 0; e < n; ++e ) {
+         args.fX = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+         h1->Fill(args.fX);
+         TThread thread(ConcurrentFillThread, &args);
+         thread.Run();
+         thread.Join();
+      }
+      if ( filler.GetNShards() > 8 ) status = 1;
+   }
+
+   status += equals("ConcurrentFillThreadExit", h1, h2, cmpOptStats, 1E-13);
+   delete h1;
+   return status;
+}
+
+bool testSparseIndex3D()
+{
+   // Tests the bin lookup of a THnSparse against a THn filled with the same
+   // entries, including after cloning (the bin index is not streamed)
+
+   Int_t bsize[] = { numberOfBins, numberOfBins + 1, numberOfBins + 2 };
+   Double_t xmin[] = { minRange, minRange, minRange };
+   Double_t xmax[] = { maxRange, maxRange, maxRange };
+   THnSparseD* s1 = new THnSparseD("tSI3D-s1", "s1-Title", 3, bsize, xmin, xmax, 64);
+   THnD* n1 = new THnD("tSI3D-n1", "n1-Title", 3, bsize, xmin, xmax);
+   s1->Sumw2();
+   n1->Sumw2();
+
+   for ( Int_t e = 0; e < 10*nEvents; ++e ) {
+      Double_t x[3];
+      for ( Int_t d = 0; d < 3; ++d )
+         x[d] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      Double_t w = r.Uniform(0.5, 1.5);
+      s1->Fill(x, w);
+      n1->Fill(x, w);
+   }
+
+   int status = 0;
+   Long64_t nfilled = 0;
+   for ( Long64_t i = 0; i < n1->GetNbins(); ++i )
+      if ( n1->GetBinContent(i) != 0 ) ++nfilled;
+   if ( s1->GetNbins() != nfilled ) status = 1;
+
+   THnSparseD* s2 = (THnSparseD*) s1->Clone("tSI3D-s2");
+   status += equals("SparseIndex3D-THn", s1, n1, cmpOptNone, 1E-13);
+   status += equals("SparseIndex3D-Clone", s2, s1, cmpOptNone, 1E-13);
+   delete s2;
+   return status;
+}
+
+bool testSparseIndexLarge()
+{
+   // Tests the bin lookup of a THnSparse whose compact coordinates are
+   // longer than 8 bytes, against a map of the filled bins
+
+   const Int_t ndim = 12;
+   const Int_t npoints = 2000;
+   Int_t bsize[ndim];
+   Double_t xmin[ndim];
+   Double_t xmax[ndim];
+   for ( Int_t d = 0; d < ndim; ++d ) {
+      bsize[d] = 1000;
+      xmin[d] = 0;
+      xmax[d] = 1000;
+   }
+   THnSparseD* s1 = new THnSparseD("tSIL-s1", "s1-Title", ndim, bsize, xmin, xmax);
+
+   std::map<std::vector<Int_t>, Double_t> expected;
+   std::vector<std::vector<Int_t> > points(npoints, std::vector<Int_t>(ndim));
+   for ( Int_t p = 0; p < npoints; ++p ) {
+      for ( Int_t d = 0; d < ndim; ++d )
+         // few values on the last axes: many points share their hash prefix
+         points[p][d] = d < 3 ? 1 + (Int_t) r.Uniform(0, 1000) : 1 + p % 3;
+   }
+   for ( Int_t e = 0; e < 3*npoints; ++e ) {
+      const std::vector<Int_t>& idx = points[(Int_t) r.Uniform(0, npoints)];
+      Double_t w = r.Uniform(0.5, 1.5);
+      s1->AddBinContent(&idx[0], w);
+      expected[idx] += w;
+   }
+
+   int status = 0;
+   if ( s1->GetNbins() != (Long64_t) expected.size() ) status = 1;
+   for ( std::map<std::vector<Int_t>, Double_t>::const_iterator i = expected.begin();
+         i != expected.end(); ++i ) {
+      if ( equals(s1->GetBinContent(&i->first[0]), i->second, 1E-13) ) ++status;
+   }
+   // unknown bins are not found and not allocated
+   Int_t missing[ndim];
+   for ( Int_t d = 0; d < ndim; ++d ) missing[d] = 1000;
+   const THnSparseD* cs1 = s1;
+   if ( cs1->GetBin(missing) >= 0 || s1->GetBinContent(missing) != 0 ) ++status;
+   if ( s1->GetNbins() != (Long64_t) expected.size() ) ++status;
+
+   delete s1;
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testSparseIndexLarge: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+template <typename HIST>
+bool testHnFillN()
+{
+   // Tests that THnBase::FillN fills as Fill does, with and without weights
+
+   Int_t bsize[] = { numberOfBins, numberOfBins + 1, numberOfBins + 2 };
+   Double_t xmin[] = { minRange, minRange, minRange };
+   Double_t xmax[] = { maxRange, maxRange, maxRange };
+   HIST* s1 = new HIST("tFNHn-s1", "s1-Title", 3, bsize, xmin, xmax);
+   HIST* s2 = new HIST("tFNHn-s2", "s2-Title", 3, bsize, xmin, xmax);
+   HIST* s3 = new HIST("tFNHn-s3", "s3-Title", 3, bsize, xmin, xmax);
+   HIST* s4 = new HIST("tFNHn-s4", "s4-Title", 3, bsize, xmin, xmax);
+   s1->Sumw2();
+   s2->Sumw2();
+   s3->Sumw2();
+   s4->Sumw2();
+
+   const Int_t n = 2*nEvents + 7;
+   std::vector<Double_t> x(3*n), w(n);
+   for ( Int_t e = 0; e < n; ++e ) {
+      for ( Int_t d = 0; d < 3; ++d )
+         x[3*e + d] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      w[e] = r.Uniform(0.5, 1.5);
+      s1->Fill(&x[3*e], w[e]);
+      s3->Fill(&x[3*e]);
+   }
+   s2->FillN(n, &x[0], &w[0]);
+   s4->FillN(n, &x[0]);
+
+   int status = 0;
+   if ( s1->GetNbins() != s2->GetNbins() || s1->GetEntries() != s2->GetEntries() ) status = 1;
+   if ( s1->GetSumw() != s2->GetSumw() || s1->GetSumw2() != s2->GetSumw2() ) status = 1;
+   status += equals("HnFillN", s1, s2, cmpOptNone, 1E-13);
+   status += equals("HnFillN-NoWeights", s3, s4, cmpOptNone, 1E-13);
+   delete s1;
+   delete s3;
+   return status;
+}
+
+int equalsHnBins(const char* msg, THnBase* h1, THnBase* h2, double ERRORLIMIT)
+{
+   // Compares the bins of two THnBase of any dimension by their coordinates,
+   // and deletes h2 like equals() does
+
+   int differents = 0;
+   if ( h1->GetNdimensions() != h2->GetNdimensions() ) differents = 1;
+   if ( h1->GetNbins() != h2->GetNbins() ) ++differents;
+
+   std::vector<Int_t> coord(h1->GetNdimensions());
+   const THnBase* ch2 = h2;
+   for ( Long64_t i = 0; !differents && i < h1->GetNbins(); ++i ) {
+      Double_t c1 = h1->GetBinContent(i, &coord[0]);
+      Long64_t bin2 = ch2->GetBin(&coord[0]);
+      Double_t c2 = bin2 < 0 ? 0. : h2->GetBinContent(bin2);
+      Double_t e2 = bin2 < 0 ? 0. : h2->GetBinError2(bin2);
+      differents += equals(c1, c2, ERRORLIMIT);
+      differents += equals(h1->GetBinError2(i), e2, ERRORLIMIT);
+   }
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << msg << ": \t" << (differents?"FAILED":"OK") << std::endl;
+   delete h2;
+   return differents;
+}
+
+template <typename HIST>
+HIST* createParallelHn(const char* name)
+{
+   // Creates a 4D histogram with more than 64k filled bins, enough for the
+   // parallel projection, rebinning and addition to be used
+
+   Int_t bsize[] = { 20, 20, 20, 20 };
+   Double_t xmin[] = { minRange, minRange, minRange, minRange };
+   Double_t xmax[] = { maxRange, maxRange, maxRange, maxRange };
+   HIST* h = new HIST(name, "Title", 4, bsize, xmin, xmax);
+   h->Sumw2();
+   for ( Int_t e = 0; e < 200000; ++e ) {
+      Double_t x[4];
+      for ( Int_t d = 0; d < 4; ++d )
+         x[d] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      h->Fill(x, r.Uniform(0.5, 1.5));
+   }
+   return h;
+}
+
+template <typename HIST>
+bool testHnParallelProjection()
+{
+   // Tests that the projections of a large THnBase read in parallel are
+   // equal to the sequential ones, with and without an axis range
+
+   HIST* s1 = createParallelHn<HIST>("tHnPP-s1");
+   Int_t dim[] = { 0, 1, 3 };
+   int status = 0;
+   for ( int withRange = 0; withRange < 2; ++withRange ) {
+      if ( withRange )
+         s1->GetAxis(2)->SetRange(3, 15);
+      ROOT::Math::ThreadPool::SetDefaultNThreads(1);
+      TH2D* h1 = s1->Projection(1, 0, "E");
+      TH1D* p1 = s1->Projection(3);
+      THnBase* n1 = s1->ProjectionND(3, dim, "E");
+      ROOT::Math::ThreadPool::SetDefaultNThreads(4);
+      TH2D* h2 = s1->Projection(1, 0, "E");
+      TH1D* p2 = s1->Projection(3);
+      THnBase* n2 = s1->ProjectionND(3, dim, "E");
+      ROOT::Math::ThreadPool::SetDefaultNThreads(1);
+
+      status += equals("HnParallelProjection2D", h1, h2, cmpOptStats, 1E-12);
+      status += equals("HnParallelProjection1D", p1, p2, cmpOptStats, 1E-12);
+      status += equals("HnParallelProjectionND", n1, n2, cmpOptNone, 1E-12);
+      delete h1;
+      delete p1;
+      delete n1;
+   }
+   delete s1;
+   return status;
+}
+
+template <typename HIST>
+bool testHnParallelRebin()
+{
+   // Tests that the rebinning of a large THnBase in parallel is equal to the
+   // sequential one
+
+   HIST* s1 = createParallelHn<HIST>("tHnPR-s1");
+   ROOT::Math::ThreadPool::SetDefaultNThreads(1);
+   THnBase* s2 = s1->Rebin(2);
+   ROOT::Math::ThreadPool::SetDefaultNThreads(4);
+   THnBase* s3 = s1->Rebin(2);
+   ROOT::Math::ThreadPool::SetDefaultNThreads(1);
+
+   int status = equalsHnBins("HnParallelRebin", s2, s3, 1E-12);
+   delete s1;
+   delete s2;
+   return status;
+}
+
+template <typename HIST>
+bool testHnParallelAdd()
+{
+   // Tests that the addition of a large THnBase into a THn in parallel is
+   // equal to the sequential one, and to the scaled source
+
+   HIST* s1 = createParallelHn<HIST>("tHnPA-s1");
+   Int_t bsize[] = { 20, 20, 20, 20 };
+   Double_t xmin[] = { minRange, minRange, minRange, minRange };
+   Double_t xmax[] = { maxRange, maxRange, maxRange, maxRange };
+   THnD* n1 = new THnD("tHnPA-n1", "n1-Title", 4, bsize, xmin, xmax);
+   THnD* n2 = new THnD("tHnPA-n2", "n2-Title", 4, bsize, xmin, xmax);
+   n1->Sumw2();
+   n2->Sumw2();
+
+   ROOT::Math::ThreadPool::SetDefaultNThreads(1);
+   n1->Add(s1, 0.5);
+   n1->Add(s1, 1.5);
+   ROOT::Math::ThreadPool::SetDefaultNThreads(4);
+   n2->Add(s1, 0.5);
+   n2->Add(s1, 1.5);
+   ROOT::Math::ThreadPool::SetDefaultNThreads(1);
+
+   int status = equalsHnBins("HnParallelAdd", n1, n2, 1E-12);
+   s1->Scale(2.);
+   // all bins of n1 are allocated, only the filled ones of s1 are compared
+   std::vector<Int_t> coord(4);
+   for ( Long64_t i = 0; i < s1->GetNbins(); ++i ) {
+      Double_t c = s1->GetBinContent(i, &coord[0]);
+      status += equals(c, n1->GetBinContent(&coord[0]), 1E-12);
+   }
+   delete s1;
+   delete n1;
+   return status;
+}
+
+template <typename HIST>
+bool testHnGetBinContents()
+{
+   // Tests that THnBase::GetBinContents returns the same contents, errors
+   // and coordinates as the per-bin getters, also for a partial last chunk
+
+   HIST* s1 = createParallelHn<HIST>("tHnGBC-s1");
+   const Int_t n = 1000;
+   std::vector<Double_t> content(n), err2(n);
+   std::vector<Int_t> coord(4*n), coordBin(4);
+   int status = 0;
+   for ( Long64_t first = 0; first < s1->GetNbins(); first += n ) {
+      Int_t nread = (Int_t) std::min<Long64_t>(n, s1->GetNbins() - first);
+      s1->GetBinContents(first, nread, &content[0], &err2[0], &coord[0]);
+      for ( Int_t i = 0; i < nread; ++i ) {
+         status += equals(content[i], s1->GetBinContent(first + i, &coordBin[0]), 0);
+         status += equals(err2[i], s1->GetBinError2(first + i), 0);
+         for ( Int_t d = 0; d < 4; ++d )
+            if ( coord[4*i + d] != coordBin[d] ) ++status;
+      }
+   }
+   delete s1;
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testHnGetBinContents: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+TH2Poly* createPolyHist(const char* name)
+{
+   // Creates a TH2Poly on [0,10]x[0,10] with rectangular bins, triangles with
+   // horizontal edges, overlapping bins and unbinned cells (the sea)
+
+   TH2Poly* h = new TH2Poly(name, "Title", 0., 10., 0., 10.);
+   for ( Int_t i = 0; i < 20; ++i )
+      for ( Int_t j = 0; j < 20; ++j ) {
+         Double_t x0 = 0.5 * i, y0 = 0.5 * j;
+         if ( (i + j) % 3 == 0 ) {
+            h->AddBin(x0, y0, x0 + 0.5, y0 + 0.5);
+         } else if ( (i + j) % 3 == 1 ) {
+            Double_t x[] = { x0, x0 + 0.5, x0 };
+            Double_t y[] = { y0, y0, y0 + 0.5 };
+            h->AddBin(3, x, y);
+         }
+      }
+   // bins overlapping the previous ones: only the first matching bin is used
+   h->AddBin(2.25, 2.25, 4.75, 4.75);
+   Double_t x[] = { 5., 9., 9., 7., 7., 5. };
+   Double_t y[] = { 5., 5., 6., 6., 8., 8. };
+   h->AddBin(6, x, y);
+   return h;
+}
+
+Int_t findPolyBinScan(TH2Poly* h, Double_t x, Double_t y)
+{
+   // Finds the bin of (x,y) by scanning all bins, as TH2Poly did before the
+   // partition and the spatial index
+
+   TIter next(h->GetBins());
+   TH2PolyBin* bin;
+   while ( (bin = (TH2PolyBin*) next()) )
+      if ( bin->IsInside(x, y) ) return bin->GetBinNumber();
+   return -5;
+}
+
+bool testTH2PolyFindBin()
+{
+   // Tests that TH2Poly::FindBin finds the same bins with the spatial index,
+   // with the partition cells and with a scan of all bins, also for points
+   // on the horizontal and vertical edges of the bins
+
+   TH2Poly* h1 = createPolyHist("tTH2PFB-h1");
+   std::vector<Double_t> x, y;
+   for ( Int_t e = 0; e < 10*nEvents; ++e ) {
+      x.push_back(r.Uniform(0.01, 9.99));
+      y.push_back(r.Uniform(0.01, 9.99));
+   }
+   for ( Int_t k = 1; k < 20; ++k )
+      for ( Int_t l = 1; l < 20; ++l ) {
+         // on the horizontal edges, on the vertical edges and on the vertices
+         x.push_back(0.5 * k + 0.25);
+         y.push_back(0.5 * l);
+         x.push_back(0.5 * k);
+         y.push_back(0.5 * l + 0.25);
+         x.push_back(0.5 * k);
+         y.push_back(0.5 * l);
+      }
+
+   int status = 0;
+   std::vector<Int_t> bins(x.size());
+   h1->SetSpatialIndex();
+   for ( size_t i = 0; i < x.size(); ++i )
+      bins[i] = h1->FindBin(x[i], y[i]);
+   h1->SetSpatialIndex(kFALSE);
+   for ( size_t i = 0; i < x.size(); ++i ) {
+      Int_t scan = findPolyBinScan(h1, x[i], y[i]);
+      if ( bins[i] != scan ) ++status;
+      if ( h1->FindBin(x[i], y[i]) != scan ) ++status;
+   }
+
+   delete h1;
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testTH2PolyFindBin: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+bool testTH2PolyFillN()
+{
+   // Tests that TH2Poly::FillN with the spatial index fills as Fill does,
+   // with a stride, including the overflow and sea bins
+
+   TH2Poly* h1 = createPolyHist("tTH2PFN-h1");
+   TH2Poly* h2 = createPolyHist("tTH2PFN-h2");
+   h1->Sumw2();
+   h2->Sumw2();
+
+   const Int_t n = 2*nEvents + 1;
+   std::vector<Double_t> x(n), y(n), w(n);
+   for ( Int_t e = 0; e < n; ++e ) {
+      x[e] = r.Uniform(-1., 11.);
+      y[e] = r.Uniform(-1., 11.);
+      w[e] = r.Uniform(0.5, 1.5);
+      if ( e % 2 == 0 ) h1->Fill(x[e], y[e], w[e]);
+   }
+   h2->FillN(n, &x[0], &y[0], &w[0], 2);
+
+   int status = 0;
+   for ( Int_t i = -9; i <= h1->GetNumberOfBins(); ++i ) {
+      if ( i == 0 ) continue;
+      status += equals(h1->GetBinContent(i), h2->GetBinContent(i), 1E-13);
+      if ( i > 0 ) status += equals(h1->GetBinError(i), h2->GetBinError(i), 1E-13);
+   }
+   status += equals(h1->GetEntries(), h2->GetEntries(), 1E-13);
+
+   delete h1;
+   delete h2;
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testTH2PolyFillN: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+bool checkDelaunay(TGraphDelaunay& dt, Int_t npoints)
+{
+   // Checks that no point is inside the circumcircle of a triangle, and that
+   // the triangles cover the convex hull (2n - 2 - h triangles for h hull
+   // edges)
+
+   dt.FindAllTriangles();
+   const Int_t ndt = dt.GetNdt();
+   const Int_t* p = dt.GetPTried();
+   const Int_t* n = dt.GetNTried();
+   const Int_t* m = dt.GetMTried();
+   const Double_t* x = dt.GetXN();
+   const Double_t* y = dt.GetYN();
+
+   int status = 0;
+   std::map<std::pair<Int_t, Int_t>, Int_t> edges;
+   for ( Int_t t = 0; t < ndt; ++t ) {
+      Int_t v[3] = { p[t], n[t], m[t] };
+      for ( Int_t i = 0; i < 3; ++i )
+         ++edges[std::make_pair(std::min(v[i], v[(i+1)%3]), std::max(v[i], v[(i+1)%3]))];
+
+      // orient the triangle counterclockwise for the in-circle determinant
+      Double_t area = (x[v[1]]-x[v[0]])*(y[v[2]]-y[v[0]]) - (x[v[2]]-x[v[0]])*(y[v[1]]-y[v[0]]);
+      if ( area == 0 ) { ++status; continue; }
+      if ( area < 0 ) std::swap(v[1], v[2]);
+      for ( Int_t k = 1; k <= npoints; ++k ) {
+         if ( k == v[0] || k == v[1] || k == v[2] ) continue;
+         Double_t a[3][3];
+         for ( Int_t i = 0; i < 3; ++i ) {
+            a[i][0] = x[v[i]] - x[k];
+            a[i][1] = y[v[i]] - y[k];
+            a[i][2] = a[i][0]*a[i][0] + a[i][1]*a[i][1];
+         }
+         Double_t det = a[0][0]*(a[1][1]*a[2][2] - a[1][2]*a[2][1])
+                      - a[0][1]*(a[1][0]*a[2][2] - a[1][2]*a[2][0])
+                      + a[0][2]*(a[1][0]*a[2][1] - a[1][1]*a[2][0]);
+         if ( det > 1E-10 ) ++status;
+      }
+   }
+   Int_t nhull = 0;
+   for ( std::map<std::pair<Int_t, Int_t>, Int_t>::const_iterator i = edges.begin(); i != edges.end(); ++i ) {
+      if ( i->second == 1 ) ++nhull;
+      else if ( i->second != 2 ) ++status;
+   }
+   if ( ndt != 2*npoints - 2 - nhull ) ++status;
+   return status;
+}
+
+bool testDelaunayRandom()
+{
+   // Tests the triangulation of random points, and that the interpolation
+   // of a plane is exact inside the hull and gives the margin content outside
+
+   const Int_t np = 500;
+   TGraph2D* g = new TGraph2D(np);
+   g->SetName("tDR-g");
+   g->SetDirectory(0);
+   for ( Int_t i = 0; i < np; ++i ) {
+      Double_t x = r.Uniform(-1., 1.);
+      Double_t y = r.Uniform(-1., 1.);
+      // points inside the unit circle only
+      if ( x*x + y*y > 1 ) { --i; continue; }
+      g->SetPoint(i, x, y, 1. + 2.*x - 3.*y);
+   }
+
+   TGraphDelaunay dt(g);
+   dt.SetMarginBinsContent(-100.);
+   int status = checkDelaunay(dt, np);
+   for ( Int_t e = 0; e < nEvents; ++e ) {
+      Double_t x = r.Uniform(-0.6, 0.6);
+      Double_t y = r.Uniform(-0.6, 0.6);
+      status += equals(dt.ComputeZ(x, y), 1. + 2.*x - 3.*y, 1E-10);
+   }
+   status += equals(dt.ComputeZ(1.5, 0.), -100., 0);
+   status += equals(dt.ComputeZ(-0.8, -0.8), -100., 0);
+
+   delete g;
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testDelaunayRandom: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+bool testDelaunayGrid()
+{
+   // Tests the triangulation of a regular grid, where four points lie on the
+   // same circle, and the interpolation of a plane on it
+
+   const Int_t nx = 20, ny = 15;
+   TGraph2D* g = new TGraph2D(nx*ny);
+   g->SetName("tDG-g");
+   g->SetDirectory(0);
+   for ( Int_t i = 0; i < nx; ++i )
+      for ( Int_t j = 0; j < ny; ++j )
+         g->SetPoint(i*ny + j, i, j, 5. - 0.5*i + 0.25*j);
+
+   TGraphDelaunay dt(g);
+   int status = checkDelaunay(dt, nx*ny);
+   if ( dt.GetNdt() != 2*(nx-1)*(ny-1) ) ++status;
+   for ( Int_t e = 0; e < nEvents; ++e ) {
+      Double_t x = r.Uniform(0.1, nx - 1.1);
+      Double_t y = r.Uniform(0.1, ny - 1.1);
+      status += equals(dt.ComputeZ(x, y), 5. - 0.5*x + 0.25*y, 1E-10);
+   }
+
+   delete g;
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testDelaunayGrid: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+int compareKDE(const char* msg, const char* options, const char* evaluation,
+               const std::vector<Double_t>& data, double limit)
+{
+   // Compares the estimate evaluated as given by evaluation with the direct
+   // sum, at points spread over the range of the data; the limit is
+   // relative to the maximum of the estimate
+
+   std::string opt1 = std::string(options) + ";Evaluation:Direct";
+   std::string opt2 = std::string(options) + ";Evaluation:" + evaluation;
+   TKDE kde1(data.size(), &data[0], 0., 10., opt1.c_str());
+   TKDE kde2(data.size(), &data[0], 0., 10., opt2.c_str());
+
+   const Int_t n = 500;
+   std::vector<Double_t> v1(n), v2(n);
+   Double_t vmax = 0;
+   for ( Int_t i = 0; i < n; ++i ) {
+      Double_t x = 10. * (i + 0.5) / n;
+      v1[i] = kde1(x);
+      v2[i] = kde2(x);
+      vmax = std::max(vmax, v1[i]);
+   }
+   int differents = 0;
+   for ( Int_t i = 0; i < n; ++i )
+      if ( fabs(v1[i] - v2[i]) > limit * vmax ) ++differents;
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << msg << " " << options << ": \t" << (differents?"FAILED":"OK") << std::endl;
+   return differents;
+}
+
+std::vector<Double_t> createKDEData(Int_t n)
+{
+   // Data on [0,10] from two gaussians, one close to the lower edge
+
+   std::vector<Double_t> data;
+   while ( (Int_t) data.size() < n ) {
+      Double_t x = data.size() % 3 ? r.Gaus(6., 1.5) : r.Gaus(1., 0.7);
+      if ( x > 0. && x < 10. ) data.push_back(x);
+   }
+   return data;
+}
+
+bool testKDEFastSum()
+{
+   // Tests that the fast summation gives the direct sum for the built-in
+   // kernels, with fixed and adaptive bandwidths and the mirror options
+
+   std::vector<Double_t> data = createKDEData(2000);
+   const char* kernels[] = { "Gaussian", "Epanechnikov", "Biweight", "CosineArch" };
+   const char* iterations[] = { "Fixed", "Adaptive" };
+   const char* mirrors[] = { "NoMirror", "MirrorBoth", "MirrorAsymLeftRight" };
+   int status = 0;
+   for ( Int_t k = 0; k < 4; ++k )
+      for ( Int_t i = 0; i < 2; ++i )
+         for ( Int_t m = 0; m < 3; ++m ) {
+            std::string opt = std::string("KernelType:") + kernels[k] + ";Iteration:" + iterations[i]
+               + ";Mirror:" + mirrors[m] + ";Binning:Unbinned";
+            status += compareKDE("KDEFastSum", opt.c_str(), "FastSum", data, 1E-10);
+         }
+   // binned data
+   status += compareKDE("KDEFastSum", "KernelType:Gaussian;Iteration:Adaptive;Mirror:NoMirror;Binning:ForcedBinning",
+                        "FastSum", data, 1E-10);
+   return status;
+}
+
+bool testKDEFFT()
+{
+   // Tests the FFT evaluation against the direct sum, within the accuracy
+   // given in the class description for the default grid
+
+   std::vector<Double_t> data = createKDEData(2000);
+   int status = 0;
+   status += compareKDE("KDEFFT", "KernelType:Gaussian;Iteration:Fixed;Mirror:NoMirror;Binning:Unbinned",
+                        "FFT", data, 1E-3);
+   status += compareKDE("KDEFFT", "KernelType:Gaussian;Iteration:Fixed;Mirror:MirrorBoth;Binning:Unbinned",
+                        "FFT", data, 1E-3);
+   status += compareKDE("KDEFFT", "KernelType:Epanechnikov;Iteration:Fixed;Mirror:NoMirror;Binning:Unbinned",
+                        "FFT", data, 1E-2);
+   // the FFT gives the pilot estimate of the adaptive bandwidths
+   status += compareKDE("KDEFFT", "KernelType:Gaussian;Iteration:Adaptive;Mirror:NoMirror;Binning:Unbinned",
+                        "FFT", data, 1E-2);
+   return status;
+}
+
+bool testKDEGetValues()
+{
+   // Tests that TKDE::GetValues run with several threads gives the values
+   // of the estimate evaluated point by point
+
+   std::vector<Double_t> data = createKDEData(2000);
+   const char* evaluations[] = { "Direct", "FastSum", "FFT" };
+   int status = 0;
+   for ( Int_t e = 0; e < 3; ++e ) {
+      std::string opt = std::string("KernelType:Gaussian;Iteration:Adaptive;Mirror:NoMirror;Binning:Unbinned;Evaluation:")
+         + evaluations[e];
+      TKDE kde(data.size(), &data[0], 0., 10., opt.c_str());
+      const Int_t n = 1001;
+      std::vector<Double_t> x(n), v(n);
+      for ( Int_t i = 0; i < n; ++i )
+         x[i] = r.Uniform(0., 10.);
+      ROOT::Math::ThreadPool::SetDefaultNThreads(4);
+      kde.GetValues(n, &x[0], &v[0]);
+      ROOT::Math::ThreadPool::SetDefaultNThreads(1);
+      for ( Int_t i = 0; i < n; ++i )
+         status += equals(v[i], kde(x[i]), 0);
+   }
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testKDEGetValues: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+int compareGraphEval(const char* msg, TGraph* g, Double_t xmin, Double_t xmax,
+                     Option_t* option, double limit)
+{
+   // Compares the batch TGraph::Eval with the scalar one at random abscissas
+   // in [xmin,xmax] and at the abscissas of the points inside it
+
+   std::vector<Double_t> x;
+   for ( Int_t e = 0; e < nEvents; ++e )
+      x.push_back(r.Uniform(xmin, xmax));
+   for ( Int_t i = 0; i < g->GetN(); ++i )
+      if ( g->GetX()[i] >= xmin && g->GetX()[i] <= xmax ) x.push_back(g->GetX()[i]);
+   std::vector<Double_t> y(x.size());
+   g->Eval(x.size(), &x[0], &y[0], 0, option);
+
+   int differents = 0;
+   for ( size_t i = 0; i < x.size(); ++i )
+      differents += equals(y[i], g->Eval(x[i], 0, option), limit);
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << msg << ": \t" << (differents?"FAILED":"OK") << std::endl;
+   return differents;
+}
+
+bool testGraphEvalSorted()
+{
+   // Tests the batch Eval of a graph sorted along x, including the
+   // extrapolation outside the graph range and points of equal x
+
+   const Int_t n = 200;
+   TGraph* g = new TGraph(n);
+   Double_t x = minRange;
+   for ( Int_t i = 0; i < n; ++i ) {
+      x += r.Uniform(0.01, 0.2);
+      g->SetPoint(i, x, r.Uniform(-1., 1.));
+   }
+   int status = 0;
+   status += compareGraphEval("GraphEvalSorted", g, minRange - 5., x + 5., "", 0);
+   status += compareGraphEval("GraphEvalSorted-Spline", g, minRange, x, "S", 1E-12);
+
+   // a few points share the x of the previous one
+   for ( Int_t i = 5; i < n - 1; i += 17 )
+      g->SetPoint(i, g->GetX()[i-1], r.Uniform(-1., 1.));
+   status += compareGraphEval("GraphEvalSortedEqualX", g, minRange - 5., x + 5., "", 0);
+   delete g;
+   return status;
+}
+
+bool testGraphEvalUnsorted()
+{
+   // Tests the batch Eval of a graph whose points are not sorted, or are
+   // no more sorted after being edited through SetPoint and GetX
+
+   const Int_t n = 200;
+   TGraph* g = new TGraph(n);
+   for ( Int_t i = 0; i < n; ++i )
+      g->SetPoint(i, r.Uniform(minRange, maxRange), r.Uniform(-1., 1.));
+   int status = 0;
+   // outside the range the two lowest (highest) points are used by the batch
+   // Eval only, so the comparison is done inside the range
+   status += compareGraphEval("GraphEvalUnsorted", g, minRange + 1., maxRange - 1., "", 1E-13);
+
+   g->Sort();
+   status += compareGraphEval("GraphEvalSort", g, minRange - 1., maxRange + 1., "", 0);
+   // edit the sorted graph
+   g->SetPoint(10, 0.5 * (minRange + maxRange), 2.);
+   status += compareGraphEval("GraphEvalSetPoint", g, minRange + 1., maxRange - 1., "", 1E-13);
+   g->Sort();
+   g->GetX()[20] = g->GetX()[150];
+   g->GetX()[150] = minRange + 0.5;
+   status += compareGraphEval("GraphEvalGetX", g, minRange + 1., maxRange - 1., "", 1E-13);
+   status += compareGraphEval("GraphEvalGetX-Spline", g, minRange + 1., maxRange - 1., "S", 1E-12);
+   delete g;
+   return status;
+}
+
+bool testGraphWrapData()
+{
+   // Tests that ROOT::Fit::WrapData gives the fit data of FillData, and that
+   // it refuses the graphs whose points FillData would change
+
+   const Int_t n = 100;
+   TGraphErrors* g = new TGraphErrors(n);
+   for ( Int_t i = 0; i < n; ++i ) {
+      g->SetPoint(i, r.Uniform(minRange, maxRange), r.Uniform(1., 2.));
+      g->SetPointError(i, 0., r.Uniform(0.1, 0.2));
+   }
+   ROOT::Fit::DataOptions opt;
+   ROOT::Fit::BinData d1(opt);
+   ROOT::Fit::BinData d2(opt);
+   ROOT::Fit::FillData(d1, g);
+   int status = 0;
+   if ( !ROOT::Fit::WrapData(d2, g) ) ++status;
+   if ( d1.Size() != d2.Size() ) ++status;
+   for ( unsigned int i = 0; !status && i < d1.Size(); ++i ) {
+      status += equals(d1.Coords(i)[0], d2.Coords(i)[0], 0);
+      status += equals(d1.Value(i), d2.Value(i), 0);
+      status += equals(d1.Error(i), d2.Error(i), 1E-15);
+   }
+
+   // a point with zero error is skipped by FillData
+   g->SetPointError(10, 0., 0.);
+   ROOT::Fit::BinData d3(opt);
+   if ( ROOT::Fit::WrapData(d3, g) || d3.Size() != 0 ) ++status;
+   // points outside the range are skipped by FillData
+   g->SetPointError(10, 0., 0.1);
+   ROOT::Fit::BinData d4(opt, ROOT::Fit::DataRange(minRange + 1., maxRange - 1.));
+   if ( ROOT::Fit::WrapData(d4, g) || d4.Size() != 0 ) ++status;
+
+   delete g;
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testGraphWrapData: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+Double_t splineCubic(Double_t x) { return 1. + 2.*x - 0.5*x*x + 0.1*x*x*x; }
+Double_t splineCubicDerivative(Double_t x) { return 2. - x + 0.3*x*x; }
+
+int compareSplineEval(const char* msg, TSpline3* s, Double_t xmin, Double_t xmax)
+{
+   // Compares the batch TSpline3::Eval with the scalar one for sorted, reverse
+   // sorted and random abscissas, including the extrapolation and the knots
+
+   std::vector<Double_t> x;
+   const Int_t n = 1000;
+   for ( Int_t i = 0; i <= n; ++i )
+      x.push_back(xmin - 1. + (xmax - xmin + 2.) * i / n);
+   for ( Int_t i = n; i >= 0; --i ) {
+      Double_t xi = x[i];
+      x.push_back(xi);
+   }
+   for ( Int_t i = 0; i < nEvents; ++i )
+      x.push_back(r.Uniform(xmin - 1., xmax + 1.));
+   for ( Int_t i = 0; i < s->GetNp(); ++i ) {
+      Double_t xk, yk;
+      s->GetKnot(i, xk, yk);
+      x.push_back(xk);
+   }
+   std::vector<Double_t> y(x.size());
+   s->Eval(x.size(), &x[0], &y[0]);
+
+   int differents = 0;
+   for ( size_t i = 0; i < x.size(); ++i )
+      if ( fabs(y[i] - s->Eval(x[i])) > 1E-12 * (1. + fabs(y[i])) ) ++differents;
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << msg << ": \t" << (differents?"FAILED":"OK") << std::endl;
+   return differents;
+}
+
+bool testSplineCubic()
+{
+   // Tests that a spline with the first derivatives of a cubic at its ends
+   // reproduces the cubic, for equidistant and non equidistant knots
+
+   const Int_t n = 50;
+   Double_t x[n], y[n];
+   for ( Int_t i = 0; i < n; ++i ) {
+      x[i] = i == 0 ? 0. : x[i-1] + r.Uniform(0.05, 0.15);
+      y[i] = splineCubic(x[i]);
+   }
+   Double_t ye[n];
+   for ( Int_t i = 0; i < n; ++i )
+      ye[i] = splineCubic(5. * i / (n - 1));
+   TSpline3 s1("s1", x, y, n, "b1e1", splineCubicDerivative(x[0]), splineCubicDerivative(x[n-1]));
+   TSpline3 s2("s2", 0., 5., ye, n, "b1e1", splineCubicDerivative(0.), splineCubicDerivative(5.));
+
+   int status = 0;
+   for ( Int_t e = 0; e < nEvents; ++e ) {
+      Double_t x1 = r.Uniform(x[0], x[n-1]);
+      Double_t x2 = r.Uniform(0., 5.);
+      if ( fabs(s1.Eval(x1) - splineCubic(x1)) > 1E-10 ) ++status;
+      if ( fabs(s2.Eval(x2) - splineCubic(x2)) > 1E-10 ) ++status;
+      if ( fabs(s2.Derivative(x2) - splineCubicDerivative(x2)) > 1E-9 ) ++status;
+   }
+   status += compareSplineEval("SplineEval", &s1, x[0], x[n-1]);
+   status += compareSplineEval("SplineEvalEquidistant", &s2, 0., 5.);
+
+   // equidistant knots given by their abscissas
+   for ( Int_t i = 0; i < n; ++i )
+      x[i] = 5. * i / (n - 1);
+   TSpline3 s3("s3", x, ye, n, "b1e1", splineCubicDerivative(0.), splineCubicDerivative(5.));
+   for ( Int_t i = 0; i <= 1000; ++i ) {
+      Double_t xx = 5. * i / 1000;
+      if ( fabs(s3.Eval(xx) - s2.Eval(xx)) > 1E-12 ) ++status;
+   }
+   status += compareSplineEval("SplineEvalEquidistantKnots", &s3, 0., 5.);
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testSplineCubic: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+bool testSplineSetPoint()
+{
+   // Tests that the interval search follows the knots moved with SetPoint,
+   // also for a spline built from equidistant knots
+
+   const Int_t n = 20;
+   Double_t y[n];
+   for ( Int_t i = 0; i < n; ++i )
+      y[i] = r.Uniform(-1., 1.);
+   TSpline3 s("s", 0., 1., y, n);
+   // move the knots towards the lower edge, keeping the ends
+   for ( Int_t i = 1; i < n - 1; ++i ) {
+      Double_t xk, yk;
+      s.GetKnot(i, xk, yk);
+      s.SetPoint(i, xk * xk, yk);
+   }
+
+   int status = 0;
+   for ( Int_t e = 0; e < nEvents; ++e ) {
+      Double_t x = r.Uniform(0., 1.);
+      Int_t k = 0;
+      Double_t xk, yk;
+      for ( Int_t i = 0; i < n - 1; ++i ) {
+         s.GetKnot(i, xk, yk);
+         if ( xk <= x ) k = i;
+      }
+      if ( s.FindX(x) != k ) ++status;
+   }
+   status += compareSplineEval("SplineEvalSetPoint", &s, 0., 1.);
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testSplineSetPoint: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+bool testSplineStreamer()
+{
+   // Tests that a TSpline3 written and read back has the same knots and
+   // coefficients, and that writing it twice gives the same buffer
+
+   const Int_t n = 30;
+   Double_t x[n], y[n];
+   for ( Int_t i = 0; i < n; ++i ) {
+      x[i] = i == 0 ? 0. : x[i-1] + r.Uniform(0.05, 0.15);
+      y[i] = r.Uniform(-1., 1.);
+   }
+   TSpline3* s1 = new TSpline3("s1", x, y, n, "b2e2", 0.5, -0.5);
+
+   TBufferFile b1(TBuffer::kWrite);
+   TBufferFile b2(TBuffer::kWrite);
+   b1.WriteObject(s1);
+   b2.WriteObject(s1);
+   int status = 0;
+   if ( b1.Length() != b2.Length() || memcmp(b1.Buffer(), b2.Buffer(), b1.Length()) ) ++status;
+
+   b1.SetReadMode();
+   b1.SetBufferOffset(0);
+   TSpline3* s2 = (TSpline3*) b1.ReadObject(TSpline3::Class());
+   if ( !s2 || s2->GetNp() != n ) {
+      ++status;
+   } else {
+      for ( Int_t i = 0; i < n; ++i ) {
+         Double_t c1[5], c2[5];
+         s1->GetCoeff(i, c1[0], c1[1], c1[2], c1[3], c1[4]);
+         s2->GetCoeff(i, c2[0], c2[1], c2[2], c2[3], c2[4]);
+         for ( Int_t k = 0; k < 5; ++k )
+            status += equals(c1[k], c2[k], 0);
+      }
+      for ( Int_t e = 0; e < nEvents; ++e ) {
+         Double_t xx = r.Uniform(x[0] - 1., x[n-1] + 1.);
+         status += equals(s1->Eval(xx), s2->Eval(xx), 0);
+      }
+   }
+   // the written spline can still be evaluated and written again
+   TBufferFile b3(TBuffer::kWrite);
+   b3.WriteObject(s1);
+   if ( b3.Length() != b2.Length() || memcmp(b3.Buffer(), b2.Buffer(), b2.Length()) ) ++status;
+
+   delete s1;
+   delete s2;
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testSplineStreamer: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+int compareEvalParVec(const char* msg, TF1* f, const Double_t* p, Double_t limit)
+{
+   // Compares TF1::EvalParVec with EvalPar point by point, with the given
+   // parameters and with the internal ones
+
+   const Int_t n = 1000;
+   std::vector<Double_t> x(n), y1(n), y2(n + 1, -1.);
+   for ( Int_t i = 0; i < n; ++i )
+      x[i] = r.Uniform(-5., 5.);
+   x[0] = 0.;
+   int status = 0;
+   for ( Int_t k = 0; k < 2; ++k ) {
+      const Double_t* par = k ? 0 : p;
+      if ( k ) f->SetParameters(p);
+      for ( Int_t i = 0; i < n; ++i )
+         y1[i] = f->EvalPar(&x[i], par);
+      f->EvalParVec(n, &x[0], par, &y2[0]);
+      for ( Int_t i = 0; i < n; ++i )
+         status += equals(y1[i], y2[i], limit);
+      // the values after the n points are not written
+      status += (y2[n] != -1.);
+   }
+   f->EvalParVec(0, &x[0], p, &y2[0]);
+   status += equals(y1[0], y2[0], limit);
+   if ( status && defaultEqualOptions & cmpOptDebug )
+      std::cout << msg << ": EvalParVec differs from EvalPar" << std::endl;
+   return status;
+}
+
+bool testTF1EvalParVec()
+{
+   // Tests that TF1::EvalParVec gives the values of EvalPar for the
+   // formulas evaluated in a loop (gaus, expo, polN, landau) and the others
+
+   const Double_t pgaus[] = { 2., 0.5, 1.3 };
+   const Double_t ppol[] = { 1., -0.5, 0.25, 0.1, -0.01 };
+   const Double_t pother[] = { 1., 2., 0.7 };
+   int status = 0;
+
+   TF1* f = new TF1("tEPV-gaus", "gaus", -5, 5);
+   status += compareEvalParVec("gaus", f, pgaus, 1E-14);
+   // zero sigma
+   const Double_t pgaus0[] = { 2., 0.5, 0. };
+   status += compareEvalParVec("gaus0", f, pgaus0, 1E-14);
+   delete f;
+   f = new TF1("tEPV-gausn", "gausn", -5, 5);
+   status += compareEvalParVec("gausn", f, pgaus, 1E-14);
+   delete f;
+   f = new TF1("tEPV-expo", "expo", -5, 5);
+   status += compareEvalParVec("expo", f, ppol, 1E-14);
+   delete f;
+   f = new TF1("tEPV-pol0", "pol0", -5, 5);
+   status += compareEvalParVec("pol0", f, ppol, 1E-14);
+   delete f;
+   f = new TF1("tEPV-pol4", "pol4", -5, 5);
+   status += compareEvalParVec("pol4", f, ppol, 1E-14);
+   delete f;
+   f = new TF1("tEPV-landau", "landau", -5, 5);
+   status += compareEvalParVec("landau", f, pgaus, 1E-14);
+   delete f;
+   f = new TF1("tEPV-other", "[0]+[1]*sin([2]*x)", -5, 5);
+   status += compareEvalParVec("other", f, pother, 1E-14);
+   delete f;
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testTF1EvalParVec: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+bool testWrappedTF1EvalParVec()
+{
+   // Tests WrappedMultiTF1::EvalParVec, taking the points coordinate by
+   // coordinate, for a one and a two dimensional function
+
+   const Int_t n = 500;
+   std::vector<Double_t> x(n), y(n), v(n);
+   for ( Int_t i = 0; i < n; ++i ) {
+      x[i] = r.Uniform(-3., 3.);
+      y[i] = r.Uniform(-3., 3.);
+   }
+   const Double_t* xy[2] = { &x[0], &y[0] };
+   int status = 0;
+
+   TF1* f1 = new TF1("tWEPV-f1", "gaus", -3, 3);
+   const Double_t p1[] = { 3., 0.2, 0.8 };
+   ROOT::Math::WrappedMultiTF1 w1(*f1);
+   w1.EvalParVec(n, xy, p1, &v[0]);
+   for ( Int_t i = 0; i < n; ++i )
+      status += equals(w1(&x[i], p1), v[i], 1E-14);
+
+   TF2* f2 = new TF2("tWEPV-f2", "xygaus", -3, 3, -3, 3);
+   const Double_t p2[] = { 3., 0.2, 0.8, -0.1, 1.1 };
+   ROOT::Math::WrappedMultiTF1 w2(*f2, 2);
+   w2.EvalParVec(n, xy, p2, &v[0]);
+   for ( Int_t i = 0; i < n; ++i ) {
+      Double_t point[2] = { x[i], y[i] };
+      status += equals(w2(point, p2), v[i], 1E-14);
+   }
+
+   delete f1;
+   delete f2;
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testWrappedTF1EvalParVec: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+bool testFitDataCoordData()
+{
+   // Tests that CoordData of BinData and UnBinData returns the coordinates of
+   // Coords, stored by coordinate, also after adding points, and the arrays
+   // themselves for external data
+
+   int status = 0;
+   const Int_t n = 300;
+   ROOT::Fit::BinData bd(n, 2);
+   ROOT::Fit::UnBinData ud(n, 2);
+   for ( Int_t i = 0; i < n / 2; ++i ) {
+      Double_t x[2] = { r.Uniform(-1., 1.), r.Uniform(-1., 1.) };
+      bd.Add(x, r.Uniform(1., 2.), 0.1);
+      ud.Add(x);
+   }
+   for ( Int_t k = 0; k < 2; ++k ) {
+      for ( unsigned int j = 0; j < 2; ++j ) {
+         const Double_t* cb = bd.CoordData(j);
+         const Double_t* cu = ud.CoordData(j);
+         for ( unsigned int i = 0; i < bd.Size(); ++i )
+            status += (cb[i] != bd.Coords(i)[j]);
+         for ( unsigned int i = 0; i < ud.Size(); ++i )
+            status += (cu[i] != ud.Coords(i)[j]);
+      }
+      // the cache follows the added points
+      for ( Int_t i = n / 2; i < n; ++i ) {
+         Double_t x[2] = { r.Uniform(-1., 1.), r.Uniform(-1., 1.) };
+         bd.Add(x, r.Uniform(1., 2.), 0.1);
+         ud.Add(x);
+      }
+   }
+   if ( bd.Size() != (unsigned int) n || ud.Size() != (unsigned int) n ) ++status;
+
+   std::vector<Double_t> x(n), y(n), v(n), e(n, 1.);
+   for ( Int_t i = 0; i < n; ++i ) {
+      x[i] = i;
+      y[i] = -i;
+      v[i] = 1.;
+   }
+   ROOT::Fit::BinData be(n, &x[0], &y[0], &v[0], 0, 0, &e[0]);
+   ROOT::Fit::UnBinData ue(n, &x[0], &y[0]);
+   if ( be.CoordData(0) != &x[0] || be.CoordData(1) != &y[0] ) ++status;
+   if ( ue.CoordData(0) != &x[0] || ue.CoordData(1) != &y[0] ) ++status;
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testFitDataCoordData: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+class TF1ScalarModel : public ROOT::Math::IParamMultiFunction {
+   // Model function evaluating a TF1 point by point, with the default
+   // DoEvalParVec: the fit method functions are evaluated as before the
+   // batch evaluation
+public:
+   TF1ScalarModel(TF1* f) : fFunc(f) {}
+   ROOT::Math::IMultiGenFunction* Clone() const { return new TF1ScalarModel(fFunc); }
+   unsigned int NDim() const { return 1; }
+   unsigned int NPar() const { return fFunc->GetNpar(); }
+   const Double_t* Parameters() const { return fFunc->GetParameters(); }
+   void SetParameters(const Double_t* p) { fFunc->SetParameters(p); }
+private:
+   Double_t DoEvalPar(const Double_t* x, const Double_t* p) const { return fFunc->EvalPar(x, p); }
+   TF1* fFunc;
+};
+
+bool testFitBatchEval()
+{
+   // Tests that the chi2 and the likelihoods evaluated on blocks of points
+   // with EvalParVec equal those evaluated point by point, for numbers of
+   // points below, at and above multiples of the block size (256)
+
+   int status = 0;
+   TF1* f = new TF1("tFBE-f", "gaus", -5, 5);
+   const Double_t p[] = { 300., 0.2, 1.1 };
+   ROOT::Math::WrappedMultiTF1 batch(*f);
+   TF1ScalarModel scalar(f);
+   const Int_t sizes[] = { 100, 256, 512, 1000 };
+   for ( UInt_t k = 0; k < sizeof(sizes) / sizeof(Int_t); ++k ) {
+      TH1D* h = new TH1D("tFBE-h", "h-Title", sizes[k], -5, 5);
+      ROOT::Fit::UnBinData ud(nEvents);
+      for ( Int_t e = 0; e < nEvents; ++e ) {
+         Double_t x = r.Gaus(0., 1.);
+         h->Fill(x);
+         if ( x > -5 && x < 5 ) ud.Add(x);
+      }
+      ROOT::Fit::DataOptions opt;
+      ROOT::Fit::BinData bd(opt);
+      ROOT::Fit::FillData(bd, h);
+
+      unsigned int n1 = 0, n2 = 0;
+      Double_t v1 = ROOT::Fit::FitUtil::EvaluateChi2(scalar, bd, p, n1);
+      Double_t v2 = ROOT::Fit::FitUtil::EvaluateChi2(batch, bd, p, n2);
+      status += equals(v1, v2, 1E-13) + (n1 != n2);
+      // the chi2 computed by hand
+      Double_t chi2 = 0;
+      for ( unsigned int i = 0; i < bd.Size(); ++i ) {
+         Double_t y, invError;
+         const Double_t* x = bd.GetPoint(i, y, invError);
+         Double_t d = (y - f->EvalPar(x, p)) * invError;
+         chi2 += d * d;
+      }
+      status += equals(chi2, v2, 1E-12);
+      v1 = ROOT::Fit::FitUtil::EvaluatePoissonLogL(scalar, bd, p, 0, true, n1);
+      v2 = ROOT::Fit::FitUtil::EvaluatePoissonLogL(batch, bd, p, 0, true, n2);
+      status += equals(v1, v2, 1E-13);
+      v1 = ROOT::Fit::FitUtil::EvaluateLogL(scalar, ud, p, 0, false, n1);
+      v2 = ROOT::Fit::FitUtil::EvaluateLogL(batch, ud, p, 0, false, n2);
+      status += equals(v1, v2, 1E-13);
+      delete h;
+   }
+   delete f;
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testFitBatchEval: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+int compareParGradient(const char* msg, TF1* f, const Double_t* p, Double_t xmin, Double_t xmax)
+{
+   // Compares TFormula::EvalParGradient with central finite differences of
+   // EvalPar at random points
+
+   const Int_t npar = f->GetNpar();
+   std::vector<Double_t> grad(npar), pp(p, p + npar);
+   int status = 0;
+   if ( !f->HasParGradient() ) ++status;
+   for ( Int_t i = 0; i < 20; ++i ) {
+      Double_t x[2] = { r.Uniform(xmin, xmax), r.Uniform(xmin, xmax) };
+      if ( !f->EvalParGradient(x, p, &grad[0]) ) {
+         ++status;
+         break;
+      }
+      Double_t fval = f->EvalPar(x, p);
+      for ( Int_t ipar = 0; ipar < npar; ++ipar ) {
+         Double_t h = 1E-5 * std::max(1., fabs(p[ipar]));
+         pp[ipar] = p[ipar] + h;
+         Double_t fup = f->EvalPar(x, &pp[0]);
+         pp[ipar] = p[ipar] - h;
+         Double_t flow = f->EvalPar(x, &pp[0]);
+         pp[ipar] = p[ipar];
+         Double_t num = (fup - flow) / (2. * h);
+         if ( fabs(num - grad[ipar]) > 1E-6 * (fabs(grad[ipar]) + fabs(fval)) + 1E-12 ) {
+            ++status;
+            if ( defaultEqualOptions & cmpOptDebug )
+               std::cout << msg << ": derivative " << ipar << " at " << x[0] << " is " << grad[ipar]
+                         << " instead of " << num << std::endl;
+         }
+      }
+   }
+   return status;
+}
+
+bool testTFormulaParGradient()
+{
+   // Tests the analytic parameter derivatives of the formulas against finite
+   // differences, and that the formulas which cannot be differentiated are
+   // reported
+
+   int status = 0;
+   const Double_t pgaus[] = { 2., 0.5, 1.3 };
+   TF1* f = new TF1("tTFPG-gaus", "gaus", -5, 5);
+   status += compareParGradient("gaus", f, pgaus, -5., 5.);
+   delete f;
+   f = new TF1("tTFPG-gausn", "gausn", -5, 5);
+   status += compareParGradient("gausn", f, pgaus, -5., 5.);
+   delete f;
+   const Double_t pexpo[] = { 0.3, -0.4 };
+   f = new TF1("tTFPG-expo", "expo", -5, 5);
+   status += compareParGradient("expo", f, pexpo, -5., 5.);
+   delete f;
+   const Double_t ppol[] = { 1., -0.5, 0.25, 0.1 };
+   f = new TF1("tTFPG-pol3", "pol3", -5, 5);
+   status += compareParGradient("pol3", f, ppol, -5., 5.);
+   delete f;
+   const Double_t psin[] = { 2., 0.3, 1.5, 2. };
+   f = new TF1("tTFPG-sin", "[0]*exp(-[1]*x)+[2]*sin([3]*x)", -5, 5);
+   status += compareParGradient("expsin", f, psin, -5., 5.);
+   delete f;
+   const Double_t ppow[] = { 1.5, 0.7, 2. };
+   f = new TF1("tTFPG-pow", "[0]*x^[1]+sqrt([2]*[2]+x*x)", 0.5, 5);
+   status += compareParGradient("pow", f, ppow, 0.5, 5.);
+   delete f;
+   const Double_t pdiv[] = { 3., 0.5, 1. };
+   f = new TF1("tTFPG-div", "[0]/(1+[1]*x*x)+log([2]+x*x)", -5, 5);
+   status += compareParGradient("div", f, pdiv, -5., 5.);
+   delete f;
+   const Double_t pxy[] = { 2., 0.5, 1.3, -0.2, 0.8 };
+   TF2* f2 = new TF2("tTFPG-xygaus", "xygaus", -3, 3, -3, 3);
+   status += compareParGradient("xygaus", f2, pxy, -3., 3.);
+   delete f2;
+
+   // no analytic derivatives: grad is left unchanged
+   Double_t x[1] = { 0.5 };
+   Double_t grad[3] = { -1., -1., -1. };
+   f = new TF1("tTFPG-landau", "landau", -5, 5);
+   if ( f->HasParGradient() || f->EvalParGradient(x, pgaus, grad) || grad[0] != -1. ) ++status;
+   delete f;
+   f = new TF1("tTFPG-call", "[0]*TMath::BreitWigner(x,[1],[2])", -5, 5);
+   if ( f->HasParGradient() || f->EvalParGradient(x, pgaus, grad) || grad[0] != -1. ) ++status;
+   delete f;
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testTFormulaParGradient: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+bool testWrappedTF1ParGradient()
+{
+   // Tests that the TF1 wrappers return the analytic derivatives when they
+   // exist, consistent with the numerical TF1::GradientPar, and the numerical
+   // ones otherwise
+
+   int status = 0;
+   const Double_t p[] = { 2., 0.5, 1.3 };
+   std::vector<Double_t> g1(3), g2(3), g3(3);
+   TF1* f = new TF1("tWTPG-gaus", "gaus", -5, 5);
+   ROOT::Math::WrappedMultiTF1 wm(*f);
+   ROOT::Math::WrappedTF1 w1(*f);
+   for ( Int_t i = 0; i < 20; ++i ) {
+      Double_t x = r.Uniform(-5., 5.);
+      f->EvalParGradient(&x, p, &g1[0]);
+      wm.ParameterGradient(&x, p, &g2[0]);
+      for ( UInt_t ipar = 0; ipar < 3; ++ipar ) {
+         status += (g1[ipar] != g2[ipar]);
+         status += (g1[ipar] != wm.ParameterDerivative(&x, p, ipar));
+         status += (g1[ipar] != w1.ParameterDerivative(x, p, ipar));
+      }
+      f->SetParameters(p);
+      f->GradientPar(&x, &g3[0]);
+      for ( UInt_t ipar = 0; ipar < 3; ++ipar )
+         status += fabs(g1[ipar] - g3[ipar]) > 1E-6 * (fabs(g1[ipar]) + 1.);
+   }
+   delete f;
+
+   // the numerical derivatives of the wrapper do not modify the parameters of the TF1
+   f = new TF1("tWTPG-landau", "landau", -5, 5);
+   ROOT::Math::WrappedMultiTF1 wl(*f);
+   const Double_t pf[] = { 1., 0., 1. };
+   for ( Int_t i = 0; i < 20; ++i ) {
+      Double_t x = r.Uniform(-5., 5.);
+      f->SetParameters(pf);
+      wl.ParameterGradient(&x, p, &g2[0]);
+      for ( UInt_t ipar = 0; ipar < 3; ++ipar )
+         status += (f->GetParameter(ipar) != pf[ipar]);
+      f->SetParameters(p);
+      f->GradientPar(&x, &g3[0], 0.001);
+      for ( UInt_t ipar = 0; ipar < 3; ++ipar )
+         status += fabs(g2[ipar] - g3[ipar]) > 1E-10 * (fabs(g3[ipar]) + 1.);
+   }
+   delete f;
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testWrappedTF1ParGradient: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+bool testFitParGradient()
+{
+   // Tests that a chi2 and a likelihood fit with the gradient of the model
+   // function (option G) give the result of the fits without it
+
+   int status = 0;
+   TH1D* h = new TH1D("tFPG-h", "h-Title", 100, -5, 5);
+   for ( Int_t e = 0; e < 10 * nEvents; ++e )
+      h->Fill(r.Gaus(0.3, 1.2));
+   const char* options[] = { "Q0", "LQ0" };
+   for ( Int_t k = 0; k < 2; ++k ) {
+      TF1* f1 = new TF1("tFPG-f1", "gaus", -5, 5);
+      TF1* f2 = new TF1("tFPG-f2", "gaus", -5, 5);
+      f1->SetParameters(h->GetMaximum(), 0., 1.);
+      f2->SetParameters(h->GetMaximum(), 0., 1.);
+      h->Fit(f1, options[k]);
+      h->Fit(f2, TString(options[k]) + "G");
+      for ( Int_t ipar = 0; ipar < 3; ++ipar ) {
+         status += equals(f1->GetParameter(ipar), f2->GetParameter(ipar), 1E-4);
+         status += equals(f1->GetParError(ipar), f2->GetParError(ipar), 1E-2);
+      }
+      delete f1;
+      delete f2;
+   }
+   delete h;
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testFitParGradient: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+bool testFitGradientMultithread()
+{
+   // Tests that the gradients of the chi2 and of the likelihoods evaluated in
+   // chunks with the multithread policy equal the serial ones, for a TF1 with
+   // analytic (gaus) and numerical (landau) parameter derivatives, and do not
+   // depend on the number of threads
+
+   int status = 0;
+   const char* formulas[] = { "gaus", "landau" };
+   const Double_t p[] = { 300., 0.2, 1.1 };
+   for ( Int_t k = 0; k < 2; ++k ) {
+      TF1* f = new TF1("tFGM-f", formulas[k], -5, 5);
+      f->SetParameters(1., 0., 1.);
+      ROOT::Math::WrappedMultiTF1 func(*f);
+      // more points than the chunk size (1024) of the multithread evaluation
+      const Int_t nbins = 5000;
+      TH1D* h = new TH1D("tFGM-h", "h-Title", nbins, -5, 5);
+      ROOT::Fit::UnBinData ud(5 * nEvents);
+      for ( Int_t e = 0; e < 5 * nEvents; ++e ) {
+         Double_t x = (k == 0) ? r.Gaus(0.2, 1.1) : r.Landau(0.2, 1.1);
+         h->Fill(x);
+         if ( x > -5 && x < 5 ) ud.Add(x);
+      }
+      ROOT::Fit::BinData bd(nbins, 1);
+      for ( Int_t i = 1; i <= nbins; ++i )
+         bd.Add(h->GetBinCenter(i), h->GetBinContent(i), sqrt(h->GetBinContent(i) + 1.));
+
+      unsigned int n1 = 0, n2 = 0;
+      std::vector<Double_t> g1(3), g2(3), g3(3);
+      for ( Int_t method = 0; method < 3; ++method ) {
+         for ( Int_t ipass = 0; ipass < 3; ++ipass ) {
+            ROOT::Fit::ExecutionPolicy policy = (ipass == 0) ? ROOT::Fit::kSerial : ROOT::Fit::kMultithread;
+            ROOT::Math::ThreadPool::SetDefaultNThreads(ipass == 2 ? 2 : 4);
+            Double_t* g = (ipass == 0) ? &g1[0] : (ipass == 1) ? &g2[0] : &g3[0];
+            unsigned int& np = (ipass == 0) ? n1 : n2;
+            if ( method == 0 )
+               ROOT::Fit::FitUtil::EvaluateChi2Gradient(func, bd, p, g, np, policy);
+            else if ( method == 1 )
+               ROOT::Fit::FitUtil::EvaluatePoissonLogLGradient(func, bd, p, g, policy);
+            else
+               ROOT::Fit::FitUtil::EvaluateLogLGradient(func, ud, p, g, np, policy);
+         }
+         for ( UInt_t ipar = 0; ipar < 3; ++ipar ) {
+            status += fabs(g1[ipar] - g2[ipar]) > 1E-9 * (fabs(g1[ipar]) + 1.);
+            status += (g2[ipar] != g3[ipar]);
+         }
+         status += (n1 != n2);
+      }
+      ROOT::Math::ThreadPool::SetDefaultNThreads(1);
+      // the TF1 is not modified by the evaluation of the gradients
+      status += (f->GetParameter(0) != 1. || f->GetParameter(1) != 0. || f->GetParameter(2) != 1.);
+      delete h;
+      delete f;
+   }
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testFitGradientMultithread: 	" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+class TFormulaNativeCode : public TFormula {
+   // Gives access to the native code of a formula compiled with
+   // TFormula::CompileNative
+public:
+   TFormulaNativeCode(const char* name, const char* expr) : TFormula(name, expr) {}
+   TFuncCompiled GetCompiled() const { return fCompiled; }
+};
+
+int compareCompiled(const char* msg, TFormula* f, const Double_t* p)
+{
+   // Compares the native code of the formula with the interpreted
+   // EvalParOld, at the edges of the domains of the operators and at random
+   // points
+
+   const Double_t xs[] = { -2., -1., -0.5, 0., 0.5, 1., 2., 700., -800. };
+   const Int_t nx = sizeof(xs) / sizeof(xs[0]);
+   int status = 0;
+   if ( !f->IsCompiledNative() ) ++status; // compiled when created or read
+   for ( Int_t i = 0; i < nx + 20; ++i ) {
+      Double_t x[2] = { 0., 0.3 };
+      x[0] = ( i < nx ) ? xs[i] : r.Uniform(-3., 3.);
+      Double_t fnat = f->EvalPar(x, p);
+      Double_t fold = f->EvalParOld(x, p);
+      if ( equals(fold, fnat, 1E-13) ) {
+         ++status;
+         if ( defaultEqualOptions & cmpOptDebug )
+            std::cout << msg << ": compiled " << fnat << " instead of " << fold << " at " << x[0] << std::endl;
+      }
+   }
+   return status;
+}
+
+class FormulaEvalTask : public ROOT::Math::ThreadPool::ITask {
+   // Evaluates a formula on one chunk of points per task
+public:
+   FormulaEvalTask(TFormula* f, const Double_t* p, const std::vector<Double_t>& x,
+                   std::vector<Double_t>& y, Int_t chunk) :
+      fFormula(f), fP(p), fX(x), fY(y), fChunk(chunk) {}
+   void Execute(unsigned int itask) {
+      Int_t last = std::min((Int_t)fX.size(), Int_t(itask+1)*fChunk);
+      for ( Int_t i = itask*fChunk; i < last; ++i )
+         fY[i] = fFormula->EvalPar(&fX[i], fP);
+   }
+private:
+   TFormula* fFormula;
+   const Double_t* fP;
+   const std::vector<Double_t>& fX;
+   std::vector<Double_t>& fY;
+   Int_t fChunk;
+};
+
+bool testTFormulaCompileDefault()
+{
+   // Tests that the formulas are not compiled to native code by default, and
+   // that SetCompileNative only affects the formulas optimized afterwards
+
+   int status = 0;
+   const Double_t p[] = { 1.5, -0.3 };
+   Double_t x[1] = { 0.7 };
+   TFormula* f = new TFormula("tTFCD-def", "[0]*sin(x)+[1]*x*x");
+   f->EvalPar(x, p);
+   if ( f->IsCompiledNative() ) ++status;
+   TFormula::SetCompileNative();
+   f->EvalPar(x, p);
+   if ( f->IsCompiledNative() ) ++status;
+   TFormula* g = new TFormula("tTFCD-on", "[0]*sin(x)+[1]*x*x");
+   TFormula::SetCompileNative(kFALSE);
+   status += compareCompiled("on", g, p);
+   delete g;
+   delete f;
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testTFormulaCompileDefault: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+bool testTFormulaCompileNative()
+{
+   // Tests the native code of the formulas against the interpreted
+   // evaluation, including the operators whose result is defined by
+   // TFormula outside of their domain (division by 0, log of negative
+   // numbers, ...)
+
+   const char* exprs[] = {
+      "[0]*x/(x-1)+[1]/x",
+      "log(x)+log10(x-0.5)+[0]",
+      "sqrt(x)+tan(x*[0])",
+      "acos(x)+asin(x)+atanh(x)+acosh(x)+tanh([1]*x)",
+      "exp([0]*x)-exp(-x)",
+      "(x>0.5&&x<2)+(x<0||x==1)+!(x>=1)+(x!=0)*(x<=0.5)",
+      "fmod(x,0.7)+sign(x)+abs(x)+int(3*x)",
+      "pi*x^2+min(x,1)+max(x,[0])+atan2(x,[1])",
+      "pol2(0)*gaus(3)",
+      "expo(0)+landau(2)+[5]*x*y",
+      "xygaus(0)"
+   };
+   const Int_t nexpr = sizeof(exprs) / sizeof(exprs[0]);
+   const Double_t p[] = { 1.5, -0.3, 0.2, 2., 0.4, 1.1 };
+
+   int status = 0;
+   TFormula::SetCompileNative();
+   for ( Int_t i = 0; i < nexpr; ++i ) {
+      TFormula* f = new TFormula(TString::Format("tTFCN-%d", i), exprs[i]);
+      status += compareCompiled(exprs[i], f, p);
+      delete f;
+   }
+
+   // the formulas read by the streamer are compiled when read
+   TFormula* f = new TFormula("tTFCN-clone", "[0]*sin(x)+2.5*x");
+   TFormula* c = static_cast<TFormula*>(f->Clone("tTFCN-clone2"));
+   status += compareCompiled("clone", c, p);
+   delete c;
+   delete f;
+
+   // the formulas with the same operators share the native code, whatever
+   // their constants
+   TFormulaNativeCode* f1 = new TFormulaNativeCode("tTFCN-c1", "2.5*x*x+[0]+1e300*(x>2)");
+   TFormulaNativeCode* f2 = new TFormulaNativeCode("tTFCN-c2", "3.5*x*x+[0]+1e-300*(x>2)");
+   status += compareCompiled("c1", f1, p);
+   status += compareCompiled("c2", f2, p);
+   if ( f1->GetCompiled() != f2->GetCompiled() ) ++status;
+   delete f2;
+   delete f1;
+
+   // a compiled formula evaluated from several threads gives the serial values
+   TThread::Initialize();
+   TFormula* ft = new TFormula("tTFCN-threads", "[0]*sin(x)+exp([1]*x)/(1+x*x)");
+   const Int_t n = 20 * nEvents;
+   std::vector<Double_t> x(n), y(n);
+   for ( Int_t i = 0; i < n; ++i )
+      x[i] = r.Uniform(-3., 3.);
+   FormulaEvalTask task(ft, p, x, y, nEvents);
+   ROOT::Math::ThreadPool::Run(task, n / nEvents, 4);
+   if ( !ft->IsCompiledNative() ) ++status;
+   for ( Int_t i = 0; i < n; ++i )
+      status += (y[i] != ft->EvalPar(&x[i], p));
+   delete ft;
+   TFormula::SetCompileNative(kFALSE);
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testTFormulaCompileNative: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
 // In case of deviation, the profiles' content will not work anymore
 // try only for testing the statistics
 static const double centre_deviation = 0.3;
@@ -9432,8 +11200,159 @@ int stressHistogram()
                                            fillDataTestPointer };
 
 
+   // Test 17
+   // FillN tests for 1D, 2D and 3D Histograms
+   const unsigned int numberOfFillN = 5;
+   pointer2Test fillNTestPointer[numberOfFillN] = { testFillN1D,
+                                                    testFillNVar1D,
+                                                    testFillN2D,
+                                                    testFillN3D,
+                                                    testFillNExtend1D
+   };
+   struct TTestSuite fillNTestSuite = { numberOfFillN, 
+                                        "FillN tests for 1D, 2D and 3D Histograms.........................",
+                                        fillNTestPointer };
+
+
+   // Test 18
+   // Concurrent filling tests for Histograms
+   const unsigned int numberOfConcurrentFill = 3;
+   pointer2Test concurrentFillTestPointer[numberOfConcurrentFill] = { testConcurrentFill1D,
+                                                                      testConcurrentFillSparse,
+                                                                      testConcurrentFillThreadExit
+   };
+   struct TTestSuite concurrentFillTestSuite = { numberOfConcurrentFill, 
+                                                 "Concurrent filling tests for Histograms..........................",
+                                                 concurrentFillTestPointer };
+
+
+   // Test 19
+   // THnSparse bin index and THn FillN tests
+   const unsigned int numberOfSparseIndex = 4;
+   pointer2Test sparseIndexTestPointer[numberOfSparseIndex] = { testSparseIndex3D,
+                                                                testSparseIndexLarge,
+                                                                testHnFillN<THnD>,
+                                                                testHnFillN<THnSparseD>
+   };
+   struct TTestSuite sparseIndexTestSuite = { numberOfSparseIndex, 
+                                              "THnSparse bin index and THn FillN tests..........................",
+                                              sparseIndexTestPointer };
+
+
+   // Test 20
+   // Parallel THn projection, rebinning and Add tests
+   const unsigned int numberOfHnParallel = 8;
+   pointer2Test hnParallelTestPointer[numberOfHnParallel] = { testHnParallelProjection<THnD>,
+                                                              testHnParallelProjection<THnSparseD>,
+                                                              testHnParallelRebin<THnD>,
+                                                              testHnParallelRebin<THnSparseD>,
+                                                              testHnParallelAdd<THnD>,
+                                                              testHnParallelAdd<THnSparseD>,
+                                                              testHnGetBinContents<THnD>,
+                                                              testHnGetBinContents<THnSparseD>
+   };
+   struct TTestSuite hnParallelTestSuite = { numberOfHnParallel, 
+                                             "Parallel THn projection, rebinning and Add tests.................",
+                                             hnParallelTestPointer };
+
+
+   // Test 21
+   // TH2Poly bin search and FillN tests
+   const unsigned int numberOfTh2Poly = 2;
+   pointer2Test th2PolyTestPointer[numberOfTh2Poly] = { testTH2PolyFindBin,
+                                                        testTH2PolyFillN
+   };
+   struct TTestSuite th2PolyTestSuite = { numberOfTh2Poly, 
+                                          "TH2Poly bin search and FillN tests...............................",
+                                          th2PolyTestPointer };
+
+
+   // Test 22
+   // TGraphDelaunay triangulation and interpolation tests
+   const unsigned int numberOfDelaunay = 2;
+   pointer2Test delaunayTestPointer[numberOfDelaunay] = { testDelaunayRandom,
+                                                          testDelaunayGrid
+   };
+   struct TTestSuite delaunayTestSuite = { numberOfDelaunay, 
+                                           "TGraphDelaunay triangulation and interpolation tests.............",
+                                           delaunayTestPointer };
+
+
+   // Test 23
+   // TKDE evaluation modes tests
+   const unsigned int numberOfKde = 3;
+   pointer2Test kdeTestPointer[numberOfKde] = { testKDEFastSum,
+                                                testKDEFFT,
+                                                testKDEGetValues
+   };
+   struct TTestSuite kdeTestSuite = { numberOfKde, 
+                                      "TKDE evaluation modes tests......................................",
+                                      kdeTestPointer };
+
+
+   // Test 24
+   // TGraph batch Eval and WrapData tests
+   const unsigned int numberOfGraphEval = 3;
+   pointer2Test graphEvalTestPointer[numberOfGraphEval] = { testGraphEvalSorted,
+                                                            testGraphEvalUnsorted,
+                                                            testGraphWrapData
+   };
+   struct TTestSuite graphEvalTestSuite = { numberOfGraphEval, 
+                                            "TGraph batch Eval and WrapData tests.............................",
+                                            graphEvalTestPointer };
+
+
+   // Test 25
+   // TSpline3 evaluation and I/O tests
+   const unsigned int numberOfSpline = 3;
+   pointer2Test splineTestPointer[numberOfSpline] = { testSplineCubic,
+                                                      testSplineSetPoint,
+                                                      testSplineStreamer
+   };
+   struct TTestSuite splineTestSuite = { numberOfSpline, 
+                                         "TSpline3 evaluation and I/O tests................................",
+                                         splineTestPointer };
+
+
+   // Test 26
+   // Batch evaluation of fit model functions tests
+   const unsigned int numberOfFitBatchEval = 4;
+   pointer2Test fitBatchEvalTestPointer[numberOfFitBatchEval] = { testTF1EvalParVec,
+                                                                  testWrappedTF1EvalParVec,
+                                                                  testFitDataCoordData,
+                                                                  testFitBatchEval
+   };
+   struct TTestSuite fitBatchEvalTestSuite = { numberOfFitBatchEval, 
+                                               "Batch evaluation of fit model functions tests....................",
+                                               fitBatchEvalTestPointer };
+
+
+   // Test 27
+   // Analytic parameter derivatives tests
+   const unsigned int numberOfParGradient = 4;
+   pointer2Test parGradientTestPointer[numberOfParGradient] = { testTFormulaParGradient,
+                                                                testWrappedTF1ParGradient,
+                                                                testFitParGradient,
+                                                                testFitGradientMultithread
+   };
+   struct TTestSuite parGradientTestSuite = { numberOfParGradient, 
+                                              "Analytic parameter derivatives tests.............................",
+                                              parGradientTestPointer };
+
+
+   // Test 28
+   // Native compilation of formulas tests
+   const unsigned int numberOfTformulaCompile = 2;
+   pointer2Test tformulaCompileTestPointer[numberOfTformulaCompile] = { testTFormulaCompileDefault,
+                                                                        testTFormulaCompileNative
+   };
+   struct TTestSuite tformulaCompileTestSuite = { numberOfTformulaCompile, 
+                                                  "Native compilation of formulas tests.............................",
+                                                  tformulaCompileTestPointer };
+
+
    // Combination of tests
-   const unsigned int numberOfSuits = 14;
+   const unsigned int numberOfSuits = 26;
    struct TTestSuite* testSuite[numberOfSuits];
    testSuite[ 0] = &rangeTestSuite;
    testSuite[ 1] = &rebinTestSuite;
@@ -9449,6 +11368,18 @@ int stressHistogram()
    testSuite[11] = &integralTestSuite;
    testSuite[12] = &conversionsTestSuite;
    testSuite[13] = &fillDataTestSuite;
+   testSuite[14] = &fillNTestSuite;
+   testSuite[15] = &concurrentFillTestSuite;
+   testSuite[16] = &sparseIndexTestSuite;
+   testSuite[17] = &hnParallelTestSuite;
+   testSuite[18] = &th2PolyTestSuite;
+   testSuite[19] = &delaunayTestSuite;
+   testSuite[20] = &kdeTestSuite;
+   testSuite[21] = &graphEvalTestSuite;
+   testSuite[22] = &splineTestSuite;
+   testSuite[23] = &fitBatchEvalTestSuite;
+   testSuite[24] = &parGradientTestSuite;
+   testSuite[25] = &tformulaCompileTestSuite;
 
    status = 0;
    for ( unsigned int i = 0; i < numberOfSuits; ++i ) {
@@ -9463,7 +11394,7 @@ int stressHistogram()
    }
    GlobalStatus += status;
 
-   // Test 17
+   // Test 29
    // Reference Tests
    const unsigned int numberOfRefRead = 7;
    pointer2Test refReadTestPointer[numberOfRefRead] = { testRefRead1D,  testRefReadProf1D,
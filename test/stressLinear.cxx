@@ -54,6 +54,7 @@
 // Test 12 : Matrix Vector Multiplications..........................OK  //
 // Test 13 : Matrix Inversion.......................................OK  //
 // Test 14 : Matrix Persistence.....................................OK  //
+// Test 15 : Blocked and Multithreaded Kernels......................OK  //
 // ******************************************************************   //
 // *  Starting  Sparse Matrix - S T R E S S                         *   //
 // ******************************************************************   //
@@ -67,6 +68,7 @@
 // Test  8 : Matrix Vector Multiplications..........................OK  //
 // Test  9 : Matrix Slices to Vectors...............................OK  //
 // Test 10 : Matrix Persistence.....................................OK  //
+// Test 11 : Multithreaded Products, Iterative Solver...............OK  //
 // *******************************************************************  //
 // *  Starting  Vector - S T R E S S                                 *  //
 // *******************************************************************  //
@@ -89,6 +91,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include <stdlib.h>
+#include <vector>
 #include <Riostream.h>
 #include <TSystem.h>
 #include <TFile.h>
@@ -117,9 +120,13 @@
 #include "TDecompQRH.h"
 #include "TDecompSVD.h"
 #include "TDecompBK.h"
+#include "TDecompSparse.h"
+#include "TDecompSparseIter.h"
 #include "TMatrixDEigen.h"
 #include "TMatrixDSymEigen.h"
 
+#include "Math/ThreadPool.h"
+
 void stressLinear                  (Int_t maxSizeReq=100,Int_t verbose=0);
 void StatusPrint                   (Int_t id,const TString &title,Bool_t status);
 
@@ -138,6 +145,7 @@ void mstress_sym_mm_multiplications(Int_t msize);
 void mstress_vm_multiplications    ();
 void mstress_inversion             ();
 void mstress_matrix_io             ();
+void mstress_blocked_kernels       ();
 
 void spstress_allocation           (Int_t msize);
 void spstress_matrix_fill          (Int_t rsize,Int_t csize);
@@ -149,6 +157,7 @@ void spstress_mm_multiplications   ();
 void spstress_vm_multiplications   ();
 void spstress_matrix_slices        (Int_t vsize);
 void spstress_matrix_io            ();
+void spstress_multithreaded        ();
 
 void vstress_allocation            (Int_t msize);
 void vstress_element_op            (Int_t vsize);
@@ -234,6 +243,9 @@ void stressLinear(Int_t maxSizeReq,Int_t verbose)
     mstress_inversion();
 
     mstress_matrix_io();
+#ifndef __CINT__
+    mstress_blocked_kernels();
+#endif
     std::cout << "******************************************************************" <<std::endl;
   }
 
@@ -251,6 +263,9 @@ void stressLinear(Int_t maxSizeReq,Int_t verbose)
     spstress_vm_multiplications();
     spstress_matrix_slices(maxSize);
     spstress_matrix_io();
+#ifndef __CINT__
+    spstress_multithreaded();
+#endif
     std::cout << "******************************************************************" <<std::endl;
   }
 
@@ -2156,6 +2171,167 @@ void mstress_matrix_io()
   StatusPrint(14,"Matrix Persistence",ok);
 }
 
+//------------------------------------------------------------------------
+//          Test the blocked and multithreaded kernels
+//
+#ifndef __CINT__
+template<class Element>
+TMatrixT<Element> RefMult(const TMatrixT<Element> &a,Bool_t ta,const TMatrixT<Element> &b,Bool_t tb)
+{
+  // Elementary product op(a)*op(b), summing over the inner index in
+  // increasing order like the kernels of TMatrixT
+
+  const Int_t nrows  = ta ? a.GetNcols() : a.GetNrows();
+  const Int_t ninner = ta ? a.GetNrows() : a.GetNcols();
+  const Int_t ncols  = tb ? b.GetNrows() : b.GetNcols();
+  TMatrixT<Element> c(nrows,ncols);
+  for (Int_t i = 0; i < nrows; i++) {
+    for (Int_t j = 0; j < ncols; j++) {
+      Element cij = 0;
+      for (Int_t k = 0; k < ninner; k++)
+        cij += (ta ? a(k,i) : a(i,k))*(tb ? b(j,k) : b(k,j));
+      c(i,j) = cij;
+    }
+  }
+  return c;
+}
+
+TMatrixD RefCholesky(const TMatrixDSym &a)
+{
+  // Upper triangular Cholesky factor computed with the elementary algorithm
+
+  const Int_t n = a.GetNrows();
+  TMatrixD u(n,n);
+  Int_t i,j,icol;
+  for (i = 0; i < n; i++)
+    for (j = i; j < n; j++)
+      u(i,j) = a(i,j);
+  for (icol = 0; icol < n; icol++) {
+    Double_t ujj = u(icol,icol);
+    for (i = 0; i < icol; i++)
+      ujj -= u(i,icol)*u(i,icol);
+    ujj = TMath::Sqrt(ujj);
+    u(icol,icol) = ujj;
+    for (j = icol+1; j < n; j++) {
+      for (i = 0; i < icol; i++)
+        u(icol,j) -= u(i,j)*u(i,icol);
+      u(icol,j) /= ujj;
+    }
+  }
+  return u;
+}
+
+void mstress_blocked_kernels()
+{
+  // The products and decompositions of matrices above the blocking and
+  // threading thresholds agree with the elementary algorithms, and do not
+  // depend on the number of threads
+
+  Bool_t ok = kTRUE;
+  const UInt_t nthreads0 = ROOT::Math::ThreadPool::DefaultNThreads();
+  Double_t seed = 17.;
+
+  // sizes (rows of C, inner index, columns of C): below the blocking
+  // threshold, blocked on one thread, and multithreaded with and without
+  // partial row, inner and column panels
+  const Int_t sizes[][3] = { {20,30,40}, {33,40,35}, {160,160,160}, {130,131,257} };
+  for (Int_t k = 0; k < 4; k++) {
+    const Int_t nr = sizes[k][0];
+    const Int_t ni = sizes[k][1];
+    const Int_t nc = sizes[k][2];
+    if (gVerbose)
+      std::cout << "\nTest the products of " << nr << "x" << ni << " and " << ni << "x" << nc << " matrices" << std::endl;
+    TMatrixD a(nr,ni),at(ni,nr),b(ni,nc),bt(nc,ni);
+    a.Randomize(-1.,1.,seed); at.Randomize(-1.,1.,seed);
+    b.Randomize(-1.,1.,seed); bt.Randomize(-1.,1.,seed);
+    TMatrixF af(nr,ni),bf(ni,nc);
+    af.Randomize(-1.,1.,seed); bf.Randomize(-1.,1.,seed);
+
+    ROOT::Math::ThreadPool::SetDefaultNThreads(1);
+    const TMatrixD ab1(a,TMatrixD::kMult,b);
+    const TMatrixD atb1(at,TMatrixD::kTransposeMult,b);
+    const TMatrixD abt1(a,TMatrixD::kMultTranspose,bt);
+    const TMatrixF abf1(af,TMatrixF::kMult,bf);
+    ROOT::Math::ThreadPool::SetDefaultNThreads(4);
+    const TMatrixD ab4(a,TMatrixD::kMult,b);
+    const TMatrixD atb4(at,TMatrixD::kTransposeMult,b);
+    const TMatrixD abt4(a,TMatrixD::kMultTranspose,bt);
+    const TMatrixF abf4(af,TMatrixF::kMult,bf);
+
+    ok &= VerifyMatrixIdentity(ab1,RefMult(a,kFALSE,b,kFALSE),gVerbose,1e-12);
+    ok &= VerifyMatrixIdentity(atb1,RefMult(at,kTRUE,b,kFALSE),gVerbose,1e-12);
+    ok &= VerifyMatrixIdentity(abt1,RefMult(a,kFALSE,bt,kTRUE),gVerbose,1e-12);
+    ok &= VerifyMatrixIdentity(abf1,RefMult(af,kFALSE,bf,kFALSE),gVerbose,Float_t(1e-4));
+    ok &= (ab1 == ab4 && atb1 == atb4 && abt1 == abt4 && abf1 == abf4);
+  }
+
+  // decompositions of a matrix large enough to be computed in parallel
+  {
+    const Int_t n = 520;
+    if (gVerbose)
+      std::cout << "\nTest the Cholesky and LU decompositions of a " << n << "x" << n << " matrix" << std::endl;
+    // well conditioned positive definite matrix M^T*M+n*I
+    TMatrixD m(n,n);
+    m.Randomize(-1.,1.,seed);
+    TMatrixDSym a(TMatrixDSym::kAtA,m);
+    for (Int_t i = 0; i < n; i++)
+      a(i,i) += n;
+    TVectorD rhs(n);
+    rhs.Randomize(-1.,1.,seed);
+
+    ROOT::Math::ThreadPool::SetDefaultNThreads(1);
+    TDecompChol chol1(a);
+    ok &= chol1.Decompose();
+    TDecompLU lu1(a);
+    ok &= lu1.Decompose();
+    ROOT::Math::ThreadPool::SetDefaultNThreads(4);
+    TDecompChol chol4(a);
+    ok &= chol4.Decompose();
+    TDecompLU lu4(a);
+    ok &= lu4.Decompose();
+
+    const TMatrixD u = RefCholesky(a);
+    const Double_t scale = TMath::Sqrt(a.Max());
+    ok &= VerifyMatrixIdentity(chol1.GetU(),u,gVerbose,1e-12*scale);
+    ok &= (chol1.GetU() == chol4.GetU() && lu1.GetLU() == lu4.GetLU());
+
+    Bool_t okSolve;
+    TVectorD x = rhs;
+    x = lu4.Solve(x,okSolve);
+    ok &= okSolve;
+    const TVectorD ax = TMatrixD(a)*x;
+    ok &= VerifyVectorIdentity(ax,rhs,gVerbose,1e-8);
+  }
+
+  // symmetric eigen decomposition
+  {
+    const Int_t n = 300;
+    if (gVerbose)
+      std::cout << "\nTest the eigen decomposition of a " << n << "x" << n << " symmetric matrix" << std::endl;
+    TMatrixDSym a(n);
+    a.Randomize(-1.,1.,seed);
+    ROOT::Math::ThreadPool::SetDefaultNThreads(1);
+    const TMatrixDSymEigen eigen1(a);
+    ROOT::Math::ThreadPool::SetDefaultNThreads(4);
+    const TMatrixDSymEigen eigen4(a);
+    ok &= (eigen1.GetEigenValues() == eigen4.GetEigenValues() &&
+           eigen1.GetEigenVectors() == eigen4.GetEigenVectors());
+
+    const TMatrixD ax = a*eigen4.GetEigenVectors();
+    TMatrixD lam_x = eigen4.GetEigenVectors();
+    lam_x.NormByRow(eigen4.GetEigenValues(),"");
+    ok &= VerifyMatrixIdentity(ax,lam_x,gVerbose,1e-10);
+  }
+
+  ROOT::Math::ThreadPool::SetDefaultNThreads(nthreads0);
+
+  if (gVerbose)
+    std::cout << "\nDone\n" << std::endl;
+
+  StatusPrint(15,"Blocked and Multithreaded Kernels",ok);
+}
+#endif
+
 //------------------------------------------------------------------------
 //          Test allocation functions and compatibility check
 //
@@ -3173,6 +3349,184 @@ void spstress_matrix_io()
   StatusPrint(10,"Matrix Persistence",ok);
 }
 
+//------------------------------------------------------------------------
+//          Test the multithreaded sparse products and the iterative solver
+//
+#ifndef __CINT__
+TMatrixDSparse SparseBand(Int_t n,Int_t nperrow,Int_t nempty,Int_t emptyEvery)
+{
+  // n x n matrix with nperrow consecutive elements per row starting at the
+  // diagonal; the last nempty rows are empty, and every emptyEvery'th row
+  // if emptyEvery > 0
+
+  std::vector<Int_t>    irow,icol;
+  std::vector<Double_t> data;
+  for (Int_t i = 0; i < n-nempty; i++) {
+    if (emptyEvery > 0 && i%emptyEvery == emptyEvery-1)
+      continue;
+    for (Int_t k = 0; k < nperrow; k++) {
+      irow.push_back(i);
+      icol.push_back((i+k)%n);
+      data.push_back(1.+TMath::Sin(i+0.1*k));
+    }
+  }
+  TMatrixDSparse a(0,n-1,0,n-1);
+  a.SetMatrixArray(irow.size(),&irow[0],&icol[0],&data[0]);
+  return a;
+}
+
+TMatrixDSparse SparseTridiag(Int_t n,Double_t lower,Double_t diag,Double_t upper)
+{
+  // n x n tridiagonal matrix
+
+  std::vector<Int_t>    irow,icol;
+  std::vector<Double_t> data;
+  for (Int_t i = 0; i < n; i++) {
+    for (Int_t j = TMath::Max(i-1,0); j <= TMath::Min(i+1,n-1); j++) {
+      irow.push_back(i);
+      icol.push_back(j);
+      data.push_back((j < i) ? lower : ((j == i) ? diag : upper));
+    }
+  }
+  TMatrixDSparse a(0,n-1,0,n-1);
+  a.SetMatrixArray(irow.size(),&irow[0],&icol[0],&data[0]);
+  return a;
+}
+
+TVectorD RefSparseMult(const TMatrixDSparse &a,const TVectorD &source,const TVectorD &target,Double_t scalar)
+{
+  // Elementary sparse matrix - vector product: A * source for scalar = 0,
+  // target + scalar * A * source otherwise
+
+  const Int_t    * const pRowIndex = a.GetRowIndexArray();
+  const Int_t    * const pColIndex = a.GetColIndexArray();
+  const Double_t * const mp        = a.GetMatrixArray();
+  TVectorD t = target;
+  for (Int_t irow = 0; irow < a.GetNrows(); irow++) {
+    Double_t sum = 0.0;
+    for (Int_t index = pRowIndex[irow]; index < pRowIndex[irow+1]; index++)
+      sum += mp[index]*source(pColIndex[index]);
+    t(irow) = (scalar == 0.0) ? sum : t(irow)+scalar*sum;
+  }
+  return t;
+}
+
+void spstress_multithreaded()
+{
+  // The sparse matrix - vector and sparse - dense products agree with the
+  // elementary algorithms and do not depend on the number of threads, also
+  // for matrices with empty rows at the end and a number of non-zero
+  // elements multiple of the chunk size. The iterative solver agrees with
+  // the direct one.
+
+  Bool_t ok = kTRUE;
+  const UInt_t nthreads0 = ROOT::Math::ThreadPool::DefaultNThreads();
+  Double_t seed = 13.;
+
+  // sparse matrix - vector products: 163840 = 10*16384 non-zero elements,
+  // and a number which is not a multiple of the chunk size
+  const Int_t bands[][4] = { {20580,8,100,0}, {40000,5,37,7}, {1000,5,10,3} };
+  for (Int_t k = 0; k < 3; k++) {
+    const TMatrixDSparse a = SparseBand(bands[k][0],bands[k][1],bands[k][2],bands[k][3]);
+    if (gVerbose)
+      std::cout << "\nTest the products with a sparse matrix of " << a.GetNrows() << " rows and "
+                << a.GetNoElements() << " non-zero elements" << std::endl;
+    TVectorD s(a.GetNcols()),t0(a.GetNrows());
+    s.Randomize(-1.,1.,seed);
+    t0.Randomize(-1.,1.,seed);
+
+    TVectorD res[2][5];
+    for (Int_t ith = 0; ith < 2; ith++) {
+      ROOT::Math::ThreadPool::SetDefaultNThreads(ith ? 4 : 1);
+      res[ith][0].ResizeTo(t0); res[ith][0] = a*s;
+      res[ith][1].ResizeTo(t0); res[ith][1] = s; res[ith][1] *= a;
+      res[ith][2].ResizeTo(t0); res[ith][2] = t0; Add(res[ith][2],0.,a,s);
+      res[ith][3].ResizeTo(t0); res[ith][3] = t0; Add(res[ith][3],-1.,a,s);
+      res[ith][4].ResizeTo(t0); res[ith][4] = t0; Add(res[ith][4],2.5,a,s);
+    }
+    const TVectorD zero(a.GetNrows());
+    ok &= VerifyVectorIdentity(res[0][0],RefSparseMult(a,s,zero,0.),gVerbose,1e-12);
+    ok &= VerifyVectorIdentity(res[0][1],RefSparseMult(a,s,zero,0.),gVerbose,1e-12);
+    ok &= VerifyVectorIdentity(res[0][2],RefSparseMult(a,s,t0,0.),gVerbose,1e-12);
+    ok &= VerifyVectorIdentity(res[0][3],RefSparseMult(a,s,t0,-1.),gVerbose,1e-12);
+    ok &= VerifyVectorIdentity(res[0][4],RefSparseMult(a,s,t0,2.5),gVerbose,1e-12);
+    for (Int_t i = 0; i < 5; i++)
+      ok &= (res[0][i] == res[1][i]);
+  }
+
+  // sparse - dense product, parallel over row blocks
+  {
+    const TMatrixDSparse a = SparseBand(1000,8,3,5);
+    TMatrixD b(1000,700);
+    b.Randomize(-1.,1.,seed);
+    if (gVerbose)
+      std::cout << "\nTest the product of a sparse and a dense matrix" << std::endl;
+    TMatrixD c1(1000,700),c4(1000,700);
+    ROOT::Math::ThreadPool::SetDefaultNThreads(1);
+    c1.Mult(a,b);
+    ROOT::Math::ThreadPool::SetDefaultNThreads(4);
+    c4.Mult(a,b);
+    const TMatrixD ad(a);
+    ok &= VerifyMatrixIdentity(c1,ad*b,gVerbose,1e-12);
+    ok &= (c1 == c4);
+  }
+
+  // iterative solver: conjugate gradient against the direct solver for a
+  // symmetric positive definite matrix, BiCGStab for a general one
+  {
+    const Int_t n = 60000;
+    if (gVerbose)
+      std::cout << "\nTest the iterative solver for " << n << " x " << n << " tridiagonal matrices" << std::endl;
+    TVectorD b(n);
+    b.Randomize(-1.,1.,seed);
+
+    const TMatrixDSparse spd = SparseTridiag(n,-1.,4.,-1.);
+    TDecompSparse direct(spd,0);
+    TVectorD xd = b;
+    ok &= direct.Solve(xd);
+
+    const TMatrixDSparse gen = SparseTridiag(n,-1.,4.,-2.);
+    TVectorD xcg[2],xbi[2],xbit[2];
+    Int_t niter[2];
+    for (Int_t ith = 0; ith < 2; ith++) {
+      ROOT::Math::ThreadPool::SetDefaultNThreads(ith ? 4 : 1);
+      TDecompSparseIter cg(spd);
+      xcg[ith].ResizeTo(b); xcg[ith] = b;
+      ok &= cg.Solve(xcg[ith]) && cg.GetResidual() <= cg.GetPrecision();
+      niter[ith] = cg.GetNIter();
+
+      TDecompSparseIter bicg(gen,TDecompSparseIter::kBiCGStab);
+      xbi[ith].ResizeTo(b); xbi[ith] = b;
+      ok &= bicg.Solve(xbi[ith]);
+      xbit[ith].ResizeTo(b); xbit[ith] = b;
+      ok &= bicg.TransSolve(xbit[ith]);
+    }
+    ok &= VerifyVectorIdentity(xcg[0],xd,gVerbose,1e-8);
+    ok &= (niter[0] == niter[1] && xcg[0] == xcg[1] && xbi[0] == xbi[1] && xbit[0] == xbit[1]);
+
+    TVectorD r = b;
+    Add(r,-1.,gen,xbi[0]);
+    ok &= TMath::Sqrt(r.Norm2Sqr()) <= 1e-8*TMath::Sqrt(b.Norm2Sqr());
+    TMatrixDSparse gent(TMatrixDSparse::kTransposed,gen);
+    r = b;
+    Add(r,-1.,gent,xbit[0]);
+    ok &= TMath::Sqrt(r.Norm2Sqr()) <= 1e-8*TMath::Sqrt(b.Norm2Sqr());
+
+    // a zero right-hand side gives a zero solution
+    TDecompSparseIter cg(spd);
+    TVectorD x0(n);
+    ok &= cg.Solve(x0) && x0 == TVectorD(n);
+  }
+
+  ROOT::Math::ThreadPool::SetDefaultNThreads(nthreads0);
+
+  if (gVerbose)
+    std::cout << "\nDone\n" << std::endl;
+
+  StatusPrint(11,"Multithreaded Products, Iterative Solver",ok);
+}
+#endif
+
 //------------------------------------------------------------------------
 //          Test allocation functions and compatibility check
 //
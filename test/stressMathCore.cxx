@@ -9,7 +9,7 @@
 //     - mathematical functions in particular the statistical functions by estimating 
 //         pdf, cdf and quantiles. cdf are estimated directly and compared with calculated integral from pdf
 //     - physics vectors (2D, 3D and 4D) including I/O for every type and for both double and Double32_t
-//     - SMatrix and SVectors including I/O for double and Double32_t types
+//     - SMatrix and SVectors including I/O for double and Double32_t types, and batches of SMatrix (SBatch)
 //     - I/O of complex objects which dictionary has been generated using CINT (default) or Reflex 
 //           TrackD and TrackD32 which contain  physics vectors of double and Double32_t  
 //           TrackErrD and TrackErrD32 which contain physics vectors and an SMatrix of double and Double32_t
@@ -77,14 +77,26 @@
 #include "TFile.h"
 #include "TF1.h"
 #include "TMath.h"
+#include "TList.h"
+#include "TThread.h"
+#include "TStatistic.h"
+#include "TStatisticDecay.h"
+#include "TStatisticHistogram.h"
+#include "TConcurrentStatisticFiller.h"
+#include "Math/ThreadPool.h"
+#include <vector>
+#include <algorithm>
 
 #include "Math/Vector2D.h"
 #include "Math/Vector3D.h"
 #include "Math/Vector4D.h"
 #include "Math/VectorUtil.h"
+#include "Math/VectorArray.h"
+#include "Math/Boost.h"
 
 #include "Math/SVector.h"
 #include "Math/SMatrix.h"
+#include "Math/SBatch.h"
 
 #include "TrackMathCore.h"
 
@@ -1371,6 +1383,201 @@ int testSMatrix(int ngen, bool testio=false) {
 
 
 
+//--------------------------------------------------------------------------------------
+// test of SBatch: operations on batches of SMatrix compared with the scalar ones
+//--------------------------------------------------------------------------------------
+
+template<unsigned int N, unsigned int D1, unsigned int D2, class R1, class R2>
+int compareLanes(const std::string & name, const SMatrix<SBatch<double,N>,D1,D2,R1> & mb,
+                 const SMatrix<double,D1,D2,R2> * m, double tol) {
+   // compare the lanes of the batched matrix mb with the matrices m, relative
+   // to their largest element
+   int iret = 0;
+   for (unsigned int l = 0; l < N; ++l) {
+      double maxval = 0, maxdiff = 0;
+      for (unsigned int i = 0; i < D1; ++i) {
+         for (unsigned int j = 0; j < D2; ++j) {
+            maxval = std::max(maxval, std::abs(m[l](i,j)));
+            maxdiff = std::max(maxdiff, std::abs(mb(i,j)[l] - m[l](i,j)));
+         }
+      }
+      if (maxdiff > tol * maxval) {
+         iret = 1;
+         if (debug) std::cout << "\nDiscrepancy in " << name << " lane " << l << " : " << maxdiff << std::endl;
+      }
+   }
+   return iret;
+}
+
+template<unsigned int N, unsigned int D>
+int compareLanes(const std::string & name, const SVector<SBatch<double,N>,D> & vb,
+                 const SVector<double,D> * v, double tol) {
+   // compare the lanes of the batched vector vb with the vectors v
+   int iret = 0;
+   for (unsigned int l = 0; l < N; ++l) {
+      double maxval = 0, maxdiff = 0;
+      for (unsigned int i = 0; i < D; ++i) {
+         maxval = std::max(maxval, std::abs(v[l][i]));
+         maxdiff = std::max(maxdiff, std::abs(vb[i][l] - v[l][i]));
+      }
+      if (maxdiff > tol * maxval) {
+         iret = 1;
+         if (debug) std::cout << "\nDiscrepancy in " << name << " lane " << l << " : " << maxdiff << std::endl;
+      }
+   }
+   return iret;
+}
+
+double MaxRelDiff(const SMatrix<double,5,5,MatRepSym<double,5> > & m1,
+                  const SMatrix<double,5,5,MatRepSym<double,5> > & m2) {
+   // largest difference of the elements relative to the largest element
+   double maxval = 0, maxdiff = 0;
+   for (unsigned int i = 0; i < 5; ++i) {
+      for (unsigned int j = 0; j < 5; ++j) {
+         maxval = std::max(maxval, std::abs(m2(i,j)));
+         maxdiff = std::max(maxdiff, std::abs(m1(i,j) - m2(i,j)));
+      }
+   }
+   return (maxval > 0) ? maxdiff / maxval : maxdiff;
+}
+
+template<unsigned int N>
+int testSBatch(int ntest) {
+   // batched products, similarities and inversions of 5x5 matrices, compared
+   // lane by lane with the scalar SMatrix operations, including lanes which
+   // are not positive definite or singular
+
+   typedef SBatch<double,N> B;
+   typedef SMatrix<double,5,5,MatRepSym<double,5> > Sym5;
+   typedef SMatrix<double,5,5> Mat5;
+   typedef SMatrix<double,5,3> Mat53;
+   typedef SVector<double,5> Vec5;
+   typedef SMatrix<B,5,5,MatRepSym<B,5> > BSym5;
+   typedef SMatrix<B,5,5> BMat5;
+   typedef SMatrix<B,5,3> BMat53;
+   typedef SVector<B,5> BVec5;
+
+   int iret = 0;
+   std::string name = "SBatch<double," + Util::ToString(N) + ">";
+   TRandom3 r(4357);
+   const Sym5 id = SMatrixIdentity();
+
+   PrintTest(name + " operations");
+   int ir = 0;
+   for (int itest = 0; itest < ntest; ++itest) {
+      Sym5 cov[N], sim[N], simt[N], inv[N], invf[N], invc[N];
+      Mat5 jac[N], sum[N], tens[N], jinv[N];
+      Mat53 m53[N], prod[N];
+      Vec5 v[N], jv[N];
+      double dot[N];
+      BSym5 bcov;
+      BMat5 bjac;
+      BMat53 bm53;
+      BVec5 bv;
+      for (unsigned int l = 0; l < N; ++l) {
+         for (unsigned int i = 0; i < 5; ++i) {
+            v[l][i] = r.Uniform(-1, 1);
+            for (unsigned int j = 0; j < 5; ++j) jac[l](i,j) = r.Uniform(-1, 1);
+            for (unsigned int j = 0; j < 3; ++j) m53[l](i,j) = r.Uniform(-1, 1);
+         }
+         // positive definite covariance matrix
+         cov[l] = Similarity(jac[l], id) + id;
+         SetLane(bcov, l, cov[l]);
+         SetLane(bjac, l, jac[l]);
+         SetLane(bm53, l, m53[l]);
+         SetLane(bv, l, v[l]);
+
+         sim[l] = Similarity(jac[l], cov[l]);
+         simt[l] = SimilarityT(jac[l], cov[l]);
+         prod[l] = jac[l] * m53[l];
+         sum[l] = jac[l] + Transpose(jac[l]);
+         jv[l] = jac[l] * v[l];
+         dot[l] = Dot(v[l], v[l]);
+         tens[l] = TensorProd(v[l], v[l]);
+         inv[l] = cov[l];   ir |= !inv[l].Invert();
+         invf[l] = cov[l];  ir |= !invf[l].InvertFast();
+         invc[l] = cov[l];  ir |= !invc[l].InvertChol();
+         jinv[l] = jac[l];  ir |= !jinv[l].Invert();
+      }
+
+      const double tol = 100 * std::numeric_limits<double>::epsilon();
+      ir |= compareLanes(name + " Similarity", BSym5(Similarity(bjac, bcov)), sim, tol);
+      ir |= compareLanes(name + " SimilarityT", BSym5(SimilarityT(bjac, bcov)), simt, tol);
+      ir |= compareLanes(name + " product", BMat53(bjac * bm53), prod, tol);
+      ir |= compareLanes(name + " sum", BMat5(bjac + Transpose(bjac)), sum, tol);
+      ir |= compareLanes(name + " matrix vector product", BVec5(bjac * bv), jv, tol);
+      ir |= compareLanes(name + " TensorProd", BMat5(TensorProd(bv, bv)), tens, tol);
+      B bdot = Dot(bv, bv);
+      for (unsigned int l = 0; l < N; ++l) ir |= compare(name + " Dot", bdot[l], dot[l], 100);
+
+      // the positive definite matrices are inverted with the Cholesky
+      // decomposition (as InvertChol), the general ones lane by lane
+      BSym5 binv = bcov, binvf = bcov, binvc = bcov;
+      BMat5 bjinv = bjac;
+      ir |= !binv.Invert() || !binvf.InvertFast() || !binvc.InvertChol() || !bjinv.Invert();
+      ir |= compareLanes(name + " Invert", binv, inv, 1.E-9);
+      ir |= compareLanes(name + " InvertFast", binvf, invf, 1.E-9);
+      ir |= compareLanes(name + " InvertChol", binvc, invc, tol);
+      ir |= compareLanes(name + " general Invert", bjinv, jinv, 0.);
+
+      CholeskyDecomp<B,5> decomp(bcov);
+      BVec5 bx = bv;
+      ir |= !decomp.ok() || !decomp.Solve(bx);
+      Vec5 x[N];
+      for (unsigned int l = 0; l < N; ++l) {
+         x[l] = v[l];
+         CholeskyDecomp<double,5> d(cov[l]);
+         d.Solve(x[l]);
+      }
+      ir |= compareLanes(name + " Cholesky Solve", bx, x, tol);
+   }
+   iret |= ir;
+   PrintStatus(ir);
+
+   PrintTest(name + " not positive definite");
+   ir = 0;
+   {
+      // lane 0 positive definite, lane 1 indefinite and invertible, lane 2
+      // singular: the batch inversions fail, the lanes 0 and 1 are inverted
+      // as with the scalar algorithm
+      Sym5 cov[N], inv[N], invc[N];
+      BSym5 bcov;
+      for (unsigned int l = 0; l < N; ++l) {
+         Mat5 a;
+         for (unsigned int i = 0; i < 5; ++i)
+            for (unsigned int j = 0; j < 5; ++j) a(i,j) = r.Uniform(-1, 1);
+         cov[l] = Similarity(a, id) + id;
+      }
+      cov[1] -= 10 * id;
+      cov[2] = Sym5();
+      for (unsigned int l = 0; l < N; ++l) {
+         SetLane(bcov, l, cov[l]);
+         inv[l] = cov[l];
+         bool ok = inv[l].Invert();
+         ir |= (ok == (l == 2));
+         invc[l] = cov[l];
+         invc[l].InvertChol();
+      }
+
+      CholeskyDecomp<B,5> decomp(bcov);
+      ir |= decomp.ok() || !decomp.ok(0) || decomp.ok(1) || decomp.ok(2);
+      BSym5 binv = bcov, binvc = bcov;
+      ir |= binv.Invert() || binvc.InvertChol();
+      Sym5 m;
+      GetLane(binv, 0, m);
+      ir |= (MaxRelDiff(m, inv[0]) > 1.E-9);
+      // lane 1 uses the scalar algorithm
+      GetLane(binv, 1, m);
+      ir |= (MaxRelDiff(m, inv[1]) != 0);
+      GetLane(binvc, 0, m);
+      ir |= (MaxRelDiff(m, invc[0]) > 100 * std::numeric_limits<double>::epsilon());
+   }
+   iret |= ir;
+   PrintStatus(ir);
+
+   return iret;
+}
+
 //--------------------------------------------------------------------------------------
 // test of a track an object containing vector and matrices
 //--------------------------------------------------------------------------------------
@@ -1430,6 +1637,158 @@ int testTrack(int ngen) {
 
 
 
+//--------------------------------------------------------------------------------------
+// test of the structure of arrays vector collections compared with the scalar vectors
+//--------------------------------------------------------------------------------------
+
+template<class T>
+int compareArray(const T * a, const std::vector<double> & ref, double tol) {
+   // compare the elements of a with ref, relative to their magnitude (or to 1)
+   int iret = 0;
+   for (unsigned int i = 0; i < ref.size(); ++i) {
+      double d = std::abs(double(a[i]) - ref[i]);
+      if (d > tol * std::max(std::abs(ref[i]), 1.)) {
+         if (debug) std::cout << "\n element " << i << " : " << a[i] << " != " << ref[i];
+         iret = 1;
+      }
+   }
+   return iret;
+}
+
+int testVectorArray(int ngen) {
+   // kinematic quantities, DeltaR, pair masses and boosts of LorentzVectorArray and
+   // Vector3DArray compared with the scalar GenVector results, including null,
+   // spacelike and phi = +/-pi vectors, empty collections and float collections
+
+   int iret = 0;
+   const double eps = std::numeric_limits<double>::epsilon();
+   unsigned int n = std::max(ngen / 100, 10);
+   TRandom3 r(4357);
+
+   std::vector<XYZTVector> vec;
+   for (unsigned int i = 0; i < n; ++i) {
+      double px = r.Gaus(0, 10), py = r.Gaus(0, 10), pz = r.Gaus(0, 50);
+      vec.push_back(XYZTVector(px, py, pz, std::sqrt(px*px + py*py + pz*pz + r.Uniform(0, 100))));
+   }
+   // null transverse momentum, spacelike, at phi = pi and just below -pi
+   vec.push_back(XYZTVector(0, 0, 5, 10));
+   vec.push_back(XYZTVector(0, 0, 0, 0));
+   vec.push_back(XYZTVector(3, 4, 12, 10));
+   vec.push_back(XYZTVector(-5, 0, 1, 8));
+   vec.push_back(XYZTVector(-5, -1.E-12, -1, 8));
+   n = vec.size();
+
+   LorentzVectorArray<double> lv;
+   for (unsigned int i = 0; i < n; ++i) lv.PushBack(vec[i]);
+
+   PrintTest("LorentzVectorArray kinematics");
+   int ir = (lv.Size() != n);
+   std::vector<double> m(n), pt(n), eta(n), phi(n), rho(n), mag(n);
+   std::vector<double> refm(n), refpt(n), refeta(n), refphi(n), refrho(n), refmag(n);
+   for (unsigned int i = 0; i < n; ++i) {
+      refm[i] = vec[i].M();
+      refpt[i] = vec[i].Pt();
+      refeta[i] = vec[i].Eta();
+      refphi[i] = vec[i].Phi();
+      refrho[i] = vec[i].Vect().Rho();
+      refmag[i] = vec[i].Vect().R();
+      ir |= (lv[i] != vec[i]);
+   }
+   lv.M(&m[0]); lv.Pt(&pt[0]); lv.Eta(&eta[0]); lv.Phi(&phi[0]);
+   lv.Vect().Rho(&rho[0]); lv.Vect().R(&mag[0]);
+   ir |= compareArray(&m[0], refm, 100 * eps);
+   ir |= compareArray(&pt[0], refpt, 10 * eps);
+   ir |= compareArray(&eta[0], refeta, 10 * eps);
+   ir |= compareArray(&phi[0], refphi, 10 * eps);
+   ir |= compareArray(&rho[0], refrho, 10 * eps);
+   ir |= compareArray(&mag[0], refmag, 10 * eps);
+   ir |= (m[n-3] >= 0 || phi[n-5] != 0 || phi[n-4] != 0 || phi[n-2] != refphi[n-2]);
+   iret |= ir;
+   PrintStatus(ir);
+
+   PrintTest("Vector3DArray from a view");
+   ir = 0;
+   Vector3DArray<double> v3(lv.Vect());
+   Vector3DView<double> view(n, lv.Px(), lv.Py(), lv.Pz());
+   ir |= (v3.Size() != n || view.Size() != n);
+   for (unsigned int i = 0; i < n; ++i) ir |= (v3[i] != vec[i].Vect() || view[i] != vec[i].Vect());
+   std::fill(eta.begin(), eta.end(), 0.);
+   view.Eta(&eta[0]);
+   ir |= compareArray(&eta[0], refeta, 10 * eps);
+   iret |= ir;
+   PrintStatus(ir);
+
+   PrintTest("DeltaR and InvariantMass of the pairs");
+   ir = 0;
+   LorentzVectorArray<double> lv2;
+   for (unsigned int i = 0; i < n; i += 3) lv2.PushBack(vec[i]);
+   unsigned int n2 = lv2.Size();
+   std::vector<double> dr(n * n2), mm(n * n2), refdr(n * n2), refmm(n * n2);
+   for (unsigned int i = 0; i < n; ++i) {
+      for (unsigned int j = 0; j < n2; ++j) {
+         refdr[i*n2 + j] = VectorUtil::DeltaR(vec[i], lv2[j]);
+         refmm[i*n2 + j] = VectorUtil::InvariantMass(vec[i], lv2[j]);
+      }
+   }
+   VectorUtil::DeltaR(lv, lv2, &dr[0]);
+   VectorUtil::InvariantMass<double>(lv, lv2, &mm[0]);
+   ir |= compareArray(&dr[0], refdr, 100 * eps);
+   ir |= compareArray(&mm[0], refmm, 100 * eps);
+   // mixed Vector3D and Lorentz vector collections
+   std::fill(dr.begin(), dr.end(), -1.);
+   VectorUtil::DeltaR(v3, lv2, &dr[0]);
+   ir |= compareArray(&dr[0], refdr, 100 * eps);
+   // empty collections leave the output untouched
+   LorentzVectorArray<double> empty;
+   std::fill(dr.begin(), dr.end(), -1.);
+   VectorUtil::DeltaR(lv, empty, &dr[0]);
+   VectorUtil::DeltaR(empty, lv, &dr[0]);
+   VectorUtil::InvariantMass<double>(empty, lv, &dr[0]);
+   ir |= (dr[0] != -1. || dr[n*n2 - 1] != -1.);
+   iret |= ir;
+   PrintStatus(ir);
+
+   PrintTest("Boost of LorentzVectorArray");
+   ir = 0;
+   Boost b(0.3, -0.2, 0.6);
+   LorentzVectorArray<double> out;
+   VectorUtil::boost<double>(lv, b, out);
+   ir |= (out.Size() != n);
+   std::vector<double> bx(n), by(n), bz(n), be(n), refbx(n), refby(n), refbz(n), refbe(n);
+   for (unsigned int i = 0; i < n; ++i) {
+      XYZTVector q = b(vec[i]);
+      refbx[i] = q.Px(); refby[i] = q.Py(); refbz[i] = q.Pz(); refbe[i] = q.E();
+   }
+   ir |= compareArray(out.Px(), refbx, 100 * eps);
+   ir |= compareArray(out.Py(), refby, 100 * eps);
+   ir |= compareArray(out.Pz(), refbz, 100 * eps);
+   ir |= compareArray(out.E(), refbe, 100 * eps);
+   // in place, identical to the out of place result
+   LorentzVectorArray<double> inplace(lv);
+   VectorUtil::boost<double>(inplace, b, inplace);
+   for (unsigned int i = 0; i < n; ++i) ir |= (inplace[i] != out[i]);
+   // empty collection resizes the output
+   VectorUtil::boost<double>(empty, b, out);
+   ir |= (out.Size() != 0);
+   iret |= ir;
+   PrintStatus(ir);
+
+   PrintTest("LorentzVectorArray<float>");
+   ir = 0;
+   LorentzVectorArray<float> lvf(n);
+   for (unsigned int i = 0; i < n; ++i)
+      lvf.SetPxPyPzE(i, vec[i].Px(), vec[i].Py(), vec[i].Pz(), vec[i].E());
+   std::vector<float> ptf(n), phif(n);
+   lvf.Pt(&ptf[0]); lvf.Phi(&phif[0]);
+   const double epsf = std::numeric_limits<float>::epsilon();
+   ir |= compareArray(&ptf[0], refpt, 10 * epsf);
+   ir |= compareArray(&phif[0], refphi, 10 * epsf);
+   iret |= ir;
+   PrintStatus(ir);
+
+   return iret;
+}
+
 int testGenVectors(int ngen,bool io) { 
 
    int iret = 0; 
@@ -1443,6 +1802,7 @@ int testGenVectors(int ngen,bool io) {
    iret |= testVector<XYZTVector, PtEtaPhiEVector, 4>(ngen,io); 
    iret |= testVector<XYZTVector, PtEtaPhiMVector, 4>(ngen,io); 
    iret |= testVector<XYZTVector, PxPyPzMVector, 4>(ngen,io); 
+   iret |= testVectorArray(ngen);
 
    return iret; 
 }
@@ -1470,6 +1830,11 @@ int testSMatrix(int ngen,bool io) {
    // sym matrix
    iret |= testSMatrix<5,5,RepSym<5> >(ngen,io); 
 
+   // batches of matrices, with a number of lanes multiple of the SIMD width
+   // or not
+   iret |= testSBatch<4>(std::max(ngen/100,1));
+   iret |= testSBatch<3>(std::max(ngen/100,1));
+
    return iret; 
 }
 
@@ -1533,6 +1898,294 @@ int testCompositeObj(int ngen) {
 }
 
 
+template <class S>
+int compareStatistic(std::string name, const S &s1, const S &s2, double scale = 2.0) {
+   // compare the sums of two TStatistic or TStatisticDecay
+
+   int iret = 0;
+   if (s1.GetN() != s2.GetN()) {
+      if (debug) std::cout << "\nDiscrepancy in " << name.c_str() << "_N() :\n  " << s1.GetN() << " != " << s2.GetN() << "\n\n";
+      iret = 1;
+   }
+   iret |= compare(name + "_W", s1.GetW(), s2.GetW(), scale);
+   iret |= compare(name + "_W2", s1.GetW2(), s2.GetW2(), scale);
+   iret |= compare(name + "_Mean", s1.GetMean(), s2.GetMean(), scale);
+   iret |= compare(name + "_M2", s1.GetM2(), s2.GetM2(), scale);
+   return iret;
+}
+
+int compareStatisticHistogram(std::string name, const TStatisticHistogram &h1, const TStatisticHistogram &h2) {
+   // compare the bins of two TStatisticHistogram, which must be equal
+
+   int iret = 0;
+   if (h1.GetN() != h2.GetN() || h1.GetNbins() != h2.GetNbins()) {
+      if (debug) std::cout << "\nDiscrepancy in " << name.c_str() << "_N() :\n  " << h1.GetN() << " != " << h2.GetN()
+                           << " or " << h1.GetNbins() << " != " << h2.GetNbins() << " bins\n\n";
+      return 1;
+   }
+   iret |= compare(name + "_W", h1.GetW(), h2.GetW(), 1);
+   iret |= compare(name + "_Min", h1.GetMin(), h2.GetMin(), 1);
+   iret |= compare(name + "_Max", h1.GetMax(), h2.GetMax(), 1);
+   for (int i = 0; i < h1.GetNbins(); ++i) {
+      iret |= compare(name + "_BinCenter", h1.GetBinCenter(i), h2.GetBinCenter(i), 1);
+      iret |= compare(name + "_BinContent", h1.GetBinContent(i), h2.GetBinContent(i), 1);
+   }
+   return iret;
+}
+
+int checkQuantiles(std::string name, const TStatisticHistogram &h, double tol) {
+   // the data are uniform in [0,1]: the quantile of probability p is p
+
+   int iret = 0;
+   for (int i = 1; i < 10; ++i) {
+      double p = 0.1 * i;
+      double q = h.GetQuantile(p);
+      if (std::abs(q - p) > tol) {
+         if (debug) std::cout << "\nDiscrepancy in " << name.c_str() << "_Quantile(" << p << ") = " << q << "\n\n";
+         iret = 1;
+      }
+      double sum = h.GetSum(p);
+      if (std::abs(sum / h.GetW() - p) > tol) {
+         if (debug) std::cout << "\nDiscrepancy in " << name.c_str() << "_Sum(" << p << ") = " << sum / h.GetW() << "\n\n";
+         iret = 1;
+      }
+   }
+   return iret;
+}
+
+template <class S>
+class StatisticFillTask : public ROOT::Math::ThreadPool::ITask {
+   // fills one chunk per task through a TConcurrentStatisticFiller, with Fill
+   // for the even tasks and FillN for the odd ones
+public:
+   StatisticFillTask(TConcurrentStatisticFiller<S> &filler, const std::vector<double> &x,
+                     const std::vector<double> &w, int chunk) :
+      fFiller(filler), fX(x), fW(w), fChunk(chunk) {}
+   void Execute(unsigned int itask) {
+      int first = itask * fChunk;
+      int last = std::min((int)fX.size(), first + fChunk);
+      if (itask % 2) {
+         fFiller.FillN(last - first, &fX[first], &fW[first]);
+         return;
+      }
+      for (int i = first; i < last; ++i) fFiller.Fill(fX[i], fW[i]);
+   }
+private:
+   TConcurrentStatisticFiller<S> &fFiller;
+   const std::vector<double> &fX, &fW;
+   int fChunk;
+};
+
+int testStatistic(int ngen) {
+   // compare the FillN of TStatistic, TStatisticDecay and TStatisticHistogram
+   // with one and several threads and with a loop of Fill, and their merging
+
+   int iret = 0;
+
+   std::cout <<"******************************************************************************\n";
+   std::cout << "\tTest of TStatistic, TStatisticDecay and TStatisticHistogram\n";
+   std::cout <<"******************************************************************************\n";
+
+   TRandom3 r(4357);
+   int n = 10 * ngen;
+   std::vector<double> x(n), t(n), w(n);
+   for (int i = 0; i < n; ++i) {
+      x[i] = r.Rndm();
+      t[i] = i;
+      w[i] = r.Uniform(0.5, 1.5);
+   }
+   unsigned int nthreads = ROOT::Math::ThreadPool::DefaultNThreads();
+
+   {
+      PrintTest("TStatistic FillN");
+      int ir = 0;
+      // the sizes around the chunk size and the large arrays
+      int sizes[] = { 0, 1, 8192, 8193, 3 * 8192, n };
+      for (unsigned int k = 0; k < sizeof(sizes) / sizeof(int); ++k) {
+         int m = std::min(sizes[k], n);
+         TStatistic s0, s0w;
+         for (int i = 0; i < m; ++i) {
+            s0.Fill(x[i]);
+            s0w.Fill(x[i], w[i]);
+         }
+         TStatistic s1, s1w, s4, s4w;
+         ROOT::Math::ThreadPool::SetDefaultNThreads(1);
+         s1.FillN(m, &x[0]);
+         s1w.FillN(m, &x[0], &w[0]);
+         ROOT::Math::ThreadPool::SetDefaultNThreads(4);
+         s4.FillN(m, &x[0]);
+         s4w.FillN(m, &x[0], &w[0]);
+         // the result does not depend on the number of threads
+         ir |= compareStatistic("TStatistic_FillN_threads", s1, s4, 1);
+         ir |= compareStatistic("TStatistic_FillN_threads_w", s1w, s4w, 1);
+         // and is the serial one up to the rounding
+         ir |= compareStatistic("TStatistic_FillN_serial", s0, s1, 1.E6);
+         ir |= compareStatistic("TStatistic_FillN_serial_w", s0w, s1w, 1.E6);
+      }
+      ROOT::Math::ThreadPool::SetDefaultNThreads(nthreads);
+      iret |= ir;
+      PrintStatus(ir);
+   }
+
+   {
+      PrintTest("TStatistic Add and Merge");
+      int ir = 0;
+      TStatistic s0;
+      s0.FillN(n, &x[0], &w[0]);
+      int n1 = n / 3, n2 = n / 2;
+      TStatistic s1, s2, s3, empty;
+      s1.FillN(n1, &x[0], &w[0]);
+      s2.FillN(n2 - n1, &x[n1], &w[n1]);
+      s3.FillN(n - n2, &x[n2], &w[n2]);
+      TStatistic sa(s1);
+      sa.Add(empty);
+      sa.Add(s2);
+      sa.Add(s3);
+      ir |= compareStatistic("TStatistic_Add", s0, sa, 1.E6);
+      TStatistic sm;
+      TList l;
+      l.Add(&s1);
+      l.Add(&s2);
+      l.Add(&s3);
+      if (sm.Merge(&l) != 3) ir = 1;
+      l.Clear("nodelete");
+      ir |= compareStatistic("TStatistic_Merge", s0, sm, 1.E6);
+      iret |= ir;
+      PrintStatus(ir);
+   }
+
+   {
+      PrintTest("TStatisticDecay FillN and Add");
+      int ir = 0;
+      double tau = n / 10.;
+      TStatisticDecay s0("s0", tau);
+      for (int i = 0; i < n; ++i) s0.Fill(x[i], t[i], w[i]);
+      TStatisticDecay s1("s1", tau), s4("s4", tau);
+      ROOT::Math::ThreadPool::SetDefaultNThreads(1);
+      s1.FillN(n, &x[0], &t[0], &w[0]);
+      ROOT::Math::ThreadPool::SetDefaultNThreads(4);
+      s4.FillN(n, &x[0], &t[0], &w[0]);
+      ROOT::Math::ThreadPool::SetDefaultNThreads(nthreads);
+      ir |= compareStatistic("TStatisticDecay_FillN_threads", s1, s4, 1);
+      ir |= compareStatistic("TStatisticDecay_FillN_serial", s0, s1, 1.E8);
+      // the weighted mean with the weights decayed to the last time
+      double sw = 0, swx = 0;
+      for (int i = 0; i < n; ++i) {
+         double wi = w[i] * std::exp(-(t[n-1] - t[i]) / tau);
+         sw += wi;
+         swx += wi * x[i];
+      }
+      ir |= compare("TStatisticDecay_W", sw, s1.GetW(), 1.E8);
+      ir |= compare("TStatisticDecay_Mean", swx / sw, s1.GetMean(), 1.E8);
+      ir |= compare("TStatisticDecay_Time", t[n-1], s1.GetTime(), 1);
+      // filled in two parts, the later one first
+      TStatisticDecay sa("sa", tau), sb("sb", tau);
+      sa.FillN(n - n / 3, &x[n / 3], &t[n / 3], &w[n / 3]);
+      sb.FillN(n / 3, &x[0], &t[0], &w[0]);
+      sa.Add(sb);
+      ir |= compareStatistic("TStatisticDecay_Add", s0, sa, 1.E8);
+      iret |= ir;
+      PrintStatus(ir);
+   }
+
+   {
+      PrintTest("TStatisticHistogram FillN");
+      int ir = 0;
+      TStatisticHistogram h0("h0", 100);
+      for (int i = 0; i < n; ++i) h0.Fill(x[i], w[i]);
+      TStatisticHistogram h1("h1", 100), h4("h4", 100);
+      ROOT::Math::ThreadPool::SetDefaultNThreads(1);
+      h1.FillN(n, &x[0], &w[0]);
+      ROOT::Math::ThreadPool::SetDefaultNThreads(4);
+      h4.FillN(n, &x[0], &w[0]);
+      ROOT::Math::ThreadPool::SetDefaultNThreads(nthreads);
+      ir |= compareStatisticHistogram("TStatisticHistogram_FillN_threads", h1, h4);
+      // the bins depend on the order of the merges, not the totals
+      if (h0.GetN() != h1.GetN() || h0.GetMin() != h1.GetMin() || h0.GetMax() != h1.GetMax()) ir = 1;
+      ir |= compare("TStatisticHistogram_FillN_W", h0.GetW(), h1.GetW(), 1.E6);
+      ir |= compare("TStatisticHistogram_FillN_Mean", h0.GetMean(), h1.GetMean(), 1.E6);
+      if (h1.GetNbins() > 100) ir = 1;
+      ir |= checkQuantiles("TStatisticHistogram_Fill", h0, 0.02);
+      ir |= checkQuantiles("TStatisticHistogram_FillN", h1, 0.02);
+      // a single value
+      TStatisticHistogram hs("hs", 100);
+      hs.FillN(1, &x[0]);
+      if (hs.GetNbins() != 1 || hs.GetQuantile(0.5) != x[0] || hs.GetSum(x[0] + 1) != 1.) ir = 1;
+      iret |= ir;
+      PrintStatus(ir);
+   }
+
+   {
+      PrintTest("TStatisticHistogram const getters");
+      int ir = 0;
+      // 1000 values with 100 bins: 200 values are still buffered
+      TStatisticHistogram h("h", 100);
+      h.FillN(1000, &x[0], &w[0]);
+      const TStatisticHistogram &ch = h;
+      TStatisticHistogram hc(h);
+      int nb = ch.GetNbins();
+      double q = ch.GetQuantile(0.3);
+      double sum = ch.GetSum(0.3);
+      // the getters leave the buffer unchanged, calling them again or on
+      // a copy gives the same result
+      ir |= compareStatisticHistogram("TStatisticHistogram_Getters", ch, hc);
+      TStatisticHistogram hf(h);
+      hf.Flush();
+      ir |= compareStatisticHistogram("TStatisticHistogram_Flush", ch, hf);
+      if (nb != hf.GetNbins()) ir = 1;
+      ir |= compare("TStatisticHistogram_Quantile", q, hf.GetQuantile(0.3), 1);
+      ir |= compare("TStatisticHistogram_Sum", sum, hf.GetSum(0.3), 1);
+      ir |= compare("TStatisticHistogram_Mean", ch.GetMean(), hf.GetMean(), 1.E6);
+      // adding a histogram with buffered values or its flushed copy
+      TStatisticHistogram ha("ha", 100), hb("hb", 100);
+      ha.FillN(500, &x[1000], &w[1000]);
+      hb.FillN(500, &x[1000], &w[1000]);
+      ha.Add(h);
+      hb.Add(hf);
+      ir |= compareStatisticHistogram("TStatisticHistogram_Add", ha, hb);
+      iret |= ir;
+      PrintStatus(ir);
+   }
+
+   {
+      PrintTest("TConcurrentStatisticFiller");
+      int ir = 0;
+      TThread::Initialize();
+      int chunk = std::max(n / 40, 1);
+      int ntasks = (n + chunk - 1) / chunk;
+      TStatistic s0;
+      for (int i = 0; i < n; ++i) s0.Fill(x[i], w[i]);
+      TStatistic s;
+      {
+         TConcurrentStatisticFiller<TStatistic> filler(&s);
+         StatisticFillTask<TStatistic> task(filler, x, w, chunk);
+         ROOT::Math::ThreadPool::Run(task, ntasks, 4);
+         TStatistic copy = filler.GetStatistic();
+         ir |= compareStatistic("TConcurrentStatisticFiller_Copy", s, copy, 1);
+      }
+      // the order of the chunks is random
+      ir |= compareStatistic("TConcurrentStatisticFiller", s0, s, 1.E8);
+
+      TStatisticHistogram h0("h0", 100);
+      for (int i = 0; i < n; ++i) h0.Fill(x[i], w[i]);
+      TStatisticHistogram h("h", 100);
+      {
+         TConcurrentStatisticFiller<TStatisticHistogram> filler(&h);
+         StatisticFillTask<TStatisticHistogram> task(filler, x, w, chunk);
+         ROOT::Math::ThreadPool::Run(task, ntasks, 4);
+      }
+      if (h0.GetN() != h.GetN() || h0.GetMin() != h.GetMin() || h0.GetMax() != h.GetMax()) ir = 1;
+      ir |= compare("TConcurrentStatisticFiller_W", h0.GetW(), h.GetW(), 1.E6);
+      ir |= compare("TConcurrentStatisticFiller_Mean", h0.GetMean(), h.GetMean(), 1.E6);
+      ir |= checkQuantiles("TConcurrentStatisticFiller", h, 0.02);
+      iret |= ir;
+      PrintStatus(ir);
+   }
+
+   return iret;
+}
+
+
 #endif // endif ifndef __CINT__
 
 
@@ -1546,6 +2199,7 @@ int stressMathCore(double nscale = 1) {
 
    gSystem->Load("libMathCore");
    gSystem->Load("libTree");
+   gSystem->Load("libThread");
    gROOT->ProcessLine(".L stressMathCore.cxx++");
    return stressMathCore();
 #endif
@@ -1563,6 +2217,8 @@ int stressMathCore(double nscale = 1) {
   
    iret |= testStatFunctions(n/10);
 
+   iret |= testStatistic(n);
+
    bool io = true; 
 
    iret |= gSystem->Load("libSmatrix");
@@ -1910,7 +1910,7 @@ void TBranchElement::InitInfo()
 
             TStreamerInfo* info;
             if( targetClass != cl )
-               info = (TStreamerInfo*)targetClass->GetConversionStreamerInfo( cl, fCheckSum );
+               info = (TStreamerInfo*)targetClass->FindConversionStreamerInfo( cl, fCheckSum );
             else {
                info = (TStreamerInfo*)cl->FindStreamerInfo( fCheckSum );
                if (info) {